@@ -1,6 +1,8 @@
 #version 330 core
 out vec4 FragColor;
-uniform vec3 u_Color;
+layout (std140) uniform MaterialData {
+    vec3 u_Color;
+};
 void main()
 {
     FragColor = vec4(u_Color, 1.0);
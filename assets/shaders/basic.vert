@@ -1,9 +1,19 @@
 #version 330 core
 layout (location = 0) in vec3 aPos;
+layout (std140) uniform FrameData {
+    mat4 u_View;
+    mat4 u_Proj;
+    mat4 u_ViewProj;
+    vec4 u_CameraPos;     // xyz = camera position
+    vec4 u_LightDir;      // xyz = normalized direction towards the light
+    vec4 u_LightColor;    // rgb = color * intensity
+    vec4 u_AmbientColor;  // rgb = color * intensity
+    vec4 u_Time;          // x = seconds since startup
+};
 uniform mat4 u_Model;
-uniform mat4 u_View;
-uniform mat4 u_Proj;
+invariant gl_Position;   // Matches the depth prepass, see mesh.vert
 void main()
 {
-    gl_Position = u_Proj * u_View * u_Model * vec4(aPos, 1.0);
+    vec4 worldPos = u_Model * vec4(aPos, 1.0);
+    gl_Position = u_Proj * u_View * worldPos;
 }
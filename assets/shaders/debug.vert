@@ -1,11 +1,23 @@
 #version 330 core
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aColor;
-uniform mat4 u_View;
-uniform mat4 u_Proj;
+layout (location = 2) in vec3 aInstanceCenter;  // DebugRenderer::RenderShapes: aPos is a unit shape
+layout (location = 3) in vec3 aInstanceScale;
+layout (std140) uniform FrameData {
+    mat4 u_View;
+    mat4 u_Proj;
+    mat4 u_ViewProj;
+    vec4 u_CameraPos;     // xyz = camera position
+    vec4 u_LightDir;      // xyz = normalized direction towards the light
+    vec4 u_LightColor;    // rgb = color * intensity
+    vec4 u_AmbientColor;  // rgb = color * intensity
+    vec4 u_Time;          // x = seconds since startup
+};
+uniform int u_Instanced;
 out vec3 v_Color;
 void main()
 {
+    vec3 position = u_Instanced != 0 ? aInstanceCenter + aPos * aInstanceScale : aPos;
     v_Color = aColor;
-    gl_Position = u_Proj * u_View * vec4(aPos, 1.0);
+    gl_Position = u_Proj * u_View * vec4(position, 1.0);
 }
@@ -1,7 +1,15 @@
 #version 330 core
 layout (location = 0) in vec3 aPos;
-uniform mat4 u_View;
-uniform mat4 u_Proj;
+layout (std140) uniform FrameData {
+    mat4 u_View;
+    mat4 u_Proj;
+    mat4 u_ViewProj;
+    vec4 u_CameraPos;     // xyz = camera position
+    vec4 u_LightDir;      // xyz = normalized direction towards the light
+    vec4 u_LightColor;    // rgb = color * intensity
+    vec4 u_AmbientColor;  // rgb = color * intensity
+    vec4 u_Time;          // x = seconds since startup
+};
 uniform float u_GridSize;
 out vec3 v_WorldPos;
 void main()
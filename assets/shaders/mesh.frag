@@ -1,30 +1,203 @@
 #version 330 core
+#ifdef BINDLESS_TEXTURES
+#extension GL_ARB_bindless_texture : require
+#endif
 
 in vec3 v_WorldPos;
 in vec3 v_Normal;
 in vec2 v_TexCoord;
+in vec3 v_Lightmap;
 
 out vec4 FragColor;
 
-uniform vec3 u_Color;
-uniform vec3 u_LightDir;
-uniform vec3 u_LightColor;
-uniform vec3 u_AmbientColor;
+// Per-frame data (UniformBinding::Frame), see renderer/shader/UniformBuffer.h
+layout (std140) uniform FrameData {
+    mat4 u_View;
+    mat4 u_Proj;
+    mat4 u_ViewProj;
+    vec4 u_CameraPos;     // xyz = camera position
+    vec4 u_LightDir;      // xyz = normalized direction towards the light
+    vec4 u_LightColor;    // rgb = color * intensity
+    vec4 u_AmbientColor;  // rgb = color * intensity
+    vec4 u_Time;          // x = seconds since startup
+};
 
+// Sun shadows (UniformBinding::Shadow), see renderer/world/CascadedShadows.h
+#define MAX_SHADOW_CASCADES 4       // CascadedShadowMap::MAX_CASCADES
+
+layout (std140) uniform ShadowData {
+    mat4 u_ShadowMatrices[MAX_SHADOW_CASCADES];  // World -> shadow map uv and depth
+    vec4 u_CascadeSplits;   // View depth each cascade ends at
+    vec4 u_CascadeTexel;    // World size of one texel per cascade
+    vec4 u_ShadowParams;    // x = cascade count (0 = off), y = 1 / resolution, z = normal offset in texels
+};
+
+uniform sampler2DArrayShadow u_ShadowMap;   // TextureUnit::ShadowMap
+uniform int u_ReceiveShadows;
+
+// Lit fraction of a surface point: the first cascade whose slice holds
+// it, 2x2 taps of the hardware's bilinear compare, fading out over the
+// last tenth of the shadow distance
+float SampleShadow(vec3 worldPos, vec3 normal, float NdotL)
+{
+    int count = int(u_ShadowParams.x);
+    if (count == 0 || u_ReceiveShadows == 0) return 1.0;
+
+    float depth = -(u_View * vec4(worldPos, 1.0)).z;
+    float shadowFar = u_CascadeSplits[count - 1];
+    if (depth >= shadowFar) return 1.0;
+
+    int cascade = 0;
+    while (cascade < count - 1 && depth > u_CascadeSplits[cascade]) cascade++;
+
+    // Push grazing surfaces off their own texels
+    float offset = u_CascadeTexel[cascade] * u_ShadowParams.z * (1.0 - NdotL);
+    vec3 coord = (u_ShadowMatrices[cascade] * vec4(worldPos + normal * offset, 1.0)).xyz;
+
+    float texel = u_ShadowParams.y;
+    float lit = 0.0;
+    for (int y = 0; y < 2; y++) {
+        for (int x = 0; x < 2; x++) {
+            vec2 uv = coord.xy + (vec2(x, y) - 0.5) * texel;
+            lit += texture(u_ShadowMap, vec4(uv, float(cascade), coord.z));
+        }
+    }
+    lit *= 0.25;
+
+    float fadeStart = shadowFar * 0.9;
+    return mix(lit, 1.0, clamp((depth - fadeStart) / (shadowFar - fadeStart), 0.0, 1.0));
+}
+
+// Baked lighting of static brushes, see map/Lightmap.h: rgb = indirect
+// light (sky with occlusion, one bounce), a = sun visibility
+uniform sampler2DArray u_Lightmap;          // TextureUnit::Lightmap
+
+// Point and spot lights (UniformBinding::Lights), binned per cluster on
+// the CPU, see renderer/world/ClusteredLighting.h
+#define CLUSTER_TILES_X 16          // ClusteredLighting::TILES_X
+#define CLUSTER_TILES_Y 9           // ClusteredLighting::TILES_Y
+#define CLUSTER_SLICES 24           // ClusteredLighting::SLICES
+
+layout (std140) uniform LightData {
+    vec4 u_ClusterParams;   // slice = log(view depth) * x + y; z = light count (0 = off)
+};
+
+uniform usamplerBuffer u_LightGrid;     // TextureUnit::LightGrid: (first index, count) per cluster
+uniform usamplerBuffer u_LightIndices;  // TextureUnit::LightIndices
+uniform samplerBuffer u_Lights;         // TextureUnit::Lights: (position, range), (color, spot scale), (direction, spot offset)
+
+// Diffuse light of the lights in this fragment's cluster: inverse square,
+// windowed to reach zero at the range, times the spot cone
+vec3 ShadeLocalLights(vec3 worldPos, vec3 normal)
+{
+    if (u_ClusterParams.z == 0.0) return vec3(0.0);
+
+    // Clip w is the view depth
+    vec4 clip = u_ViewProj * vec4(worldPos, 1.0);
+    vec2 tile = clamp((clip.xy / clip.w * 0.5 + 0.5) * vec2(CLUSTER_TILES_X, CLUSTER_TILES_Y),
+                      vec2(0.0), vec2(CLUSTER_TILES_X - 1, CLUSTER_TILES_Y - 1));
+    float slice = clamp(floor(log(max(clip.w, 1e-4)) * u_ClusterParams.x + u_ClusterParams.y),
+                        0.0, float(CLUSTER_SLICES - 1));
+    int cluster = (int(slice) * CLUSTER_TILES_Y + int(tile.y)) * CLUSTER_TILES_X + int(tile.x);
+    uvec2 range = texelFetch(u_LightGrid, cluster).xy;
+
+    vec3 result = vec3(0.0);
+    for (uint i = 0u; i < range.y; i++) {
+        int light = int(texelFetch(u_LightIndices, int(range.x + i)).x) * 3;
+        vec4 positionRange = texelFetch(u_Lights, light);
+        vec3 toLight = positionRange.xyz - worldPos;
+        float dist2 = dot(toLight, toLight);
+        float range2 = positionRange.w * positionRange.w;
+        if (dist2 >= range2) continue;
+
+        vec4 colorSpot = texelFetch(u_Lights, light + 1);
+        vec4 directionSpot = texelFetch(u_Lights, light + 2);
+        vec3 L = toLight * inversesqrt(max(dist2, 1e-8));
+        float NdotL = max(dot(normal, L), 0.0);
+
+        float window = clamp(1.0 - (dist2 * dist2) / (range2 * range2), 0.0, 1.0);
+        float falloff = window * window / (dist2 + 1.0);
+        float cone = clamp(dot(-L, directionSpot.xyz) * colorSpot.w + directionSpot.w, 0.0, 1.0);
+        result += colorSpot.rgb * (NdotL * falloff * cone * cone);
+    }
+    return result;
+}
+
+// Per-material data (UniformBinding::Material), packed by Material. The
+// MATERIAL_TABLE variant holds every material of a MaterialTable and reads
+// the entry of the vertex's slot; MAT() picks a member either way.
+#ifdef MATERIAL_TABLE
+#define MATERIAL_TABLE_SIZE 256     // MaterialTable::MAX_MATERIALS
+
+struct MaterialEntry {
+    vec3 u_Color;
+#if defined(DIFFUSE_MAP) && defined(BINDLESS_TEXTURES)
+    uvec2 u_DiffuseMap_Handle;
+#elif defined(DIFFUSE_MAP)
+    float u_DiffuseMap_Layer;
+#endif
+};
+
+layout (std140) uniform MaterialData {
+    MaterialEntry u_Materials[MATERIAL_TABLE_SIZE];
+};
+
+flat in uint v_MaterialSlot;
+#define MAT(name) u_Materials[v_MaterialSlot].name
+#else
+layout (std140) uniform MaterialData {
+    vec3 u_Color;
+};
+#define MAT(name) name
+#endif
+
+// Diffuse texture, wherever the material's reference to it lives
+#if defined(DIFFUSE_MAP) && defined(MATERIAL_TABLE) && defined(BINDLESS_TEXTURES)
+#define SAMPLE_DIFFUSE(uv) texture(sampler2D(MAT(u_DiffuseMap_Handle)), uv)
+#elif defined(DIFFUSE_MAP) && defined(MATERIAL_TABLE)
+uniform sampler2DArray u_DiffuseMap_Array;
+#define SAMPLE_DIFFUSE(uv) texture(u_DiffuseMap_Array, vec3(uv, MAT(u_DiffuseMap_Layer)))
+#elif defined(DIFFUSE_MAP)
+uniform sampler2D u_DiffuseMap;
+#define SAMPLE_DIFFUSE(uv) texture(u_DiffuseMap, uv)
+#endif
+
+// Keywords (Material::SetKeyword):
+//   UNLIT       - flat u_Color, no lighting
+//   DIFFUSE_MAP - u_Color tinted by the u_DiffuseMap texture
+// Set by MaterialTable: MATERIAL_TABLE, BINDLESS_TEXTURES
 void main()
 {
+    vec3 color = MAT(u_Color);
+#ifdef DIFFUSE_MAP
+    color *= SAMPLE_DIFFUSE(v_TexCoord).rgb;
+#endif
+
+#ifdef UNLIT
+    FragColor = vec4(color, 1.0);
+#else
     // Normalize inputs
     vec3 normal = normalize(v_Normal);
-    vec3 lightDir = normalize(u_LightDir);
+    vec3 lightDir = normalize(u_LightDir.xyz);
 
-    // Lambertian diffuse
+    // Lambertian diffuse, shadowed by the lightmap where the surface has
+    // one, else by the cascades
     float diff = max(dot(normal, lightDir), 0.0);
+    vec3 indirect = u_AmbientColor.rgb;
+    if (v_Lightmap.z > 0.5) {
+        vec4 baked = texture(u_Lightmap, vec3(v_Lightmap.xy, v_Lightmap.z - 1.0));
+        indirect = baked.rgb;
+        diff *= baked.a;
+    } else if (diff > 0.0) {
+        diff *= SampleShadow(v_WorldPos, normal, diff);
+    }
 
-    // Combine ambient and diffuse
-    vec3 ambient = u_AmbientColor * u_Color;
-    vec3 diffuse = u_LightColor * diff * u_Color;
+    // Combine ambient, the sun and the local lights
+    vec3 ambient = indirect * color;
+    vec3 diffuse = (u_LightColor.rgb * diff + ShadeLocalLights(v_WorldPos, normal)) * color;
 
     vec3 result = ambient + diffuse;
     FragColor = vec4(result, 1.0);
+#endif
 }
 
@@ -3,21 +3,50 @@
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aNormal;
 layout (location = 2) in vec2 aTexCoord;
+layout (location = 8) in mat4 aInstanceModel;  // Per-instance (StaticWorldRenderer batches)
+#ifdef MATERIAL_TABLE
+layout (location = 12) in uint aMaterialSlot;   // Mesh::SetMaterialSlots
+#endif
+layout (location = 13) in vec3 aLightmapUV;     // Mesh::SetLightmapUVs (z = layer + 1, 0 = none)
+
+// Per-frame data (UniformBinding::Frame), see renderer/shader/UniformBuffer.h
+layout (std140) uniform FrameData {
+    mat4 u_View;
+    mat4 u_Proj;
+    mat4 u_ViewProj;
+    vec4 u_CameraPos;     // xyz = camera position
+    vec4 u_LightDir;      // xyz = normalized direction towards the light
+    vec4 u_LightColor;    // rgb = color * intensity
+    vec4 u_AmbientColor;  // rgb = color * intensity
+    vec4 u_Time;          // x = seconds since startup
+};
 
 uniform mat4 u_Model;
-uniform mat4 u_View;
-uniform mat4 u_Proj;
+uniform int u_Instanced;
 
 out vec3 v_WorldPos;
 out vec3 v_Normal;
 out vec2 v_TexCoord;
+out vec3 v_Lightmap;
+#ifdef MATERIAL_TABLE
+flat out uint v_MaterialSlot;
+#endif
+
+// Bit-identical to the depth prepass (DepthPrepass), which shades with GL_EQUAL
+invariant gl_Position;
 
 void main()
 {
-    vec4 worldPos = u_Model * vec4(aPos, 1.0);
+    mat4 model = u_Instanced != 0 ? aInstanceModel : u_Model;
+
+    vec4 worldPos = model * vec4(aPos, 1.0);
     v_WorldPos = worldPos.xyz;
-    v_Normal = mat3(transpose(inverse(u_Model))) * aNormal;
+    v_Normal = mat3(transpose(inverse(model))) * aNormal;
     v_TexCoord = aTexCoord;
+    v_Lightmap = aLightmapUV;
+#ifdef MATERIAL_TABLE
+    v_MaterialSlot = aMaterialSlot;
+#endif
 
     gl_Position = u_Proj * u_View * worldPos;
 }
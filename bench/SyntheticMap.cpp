@@ -0,0 +1,116 @@
+#include "SyntheticMap.h"
+#include "physics/PhysicsWorld.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <sstream>
+
+namespace Genesis {
+namespace Bench {
+
+namespace {
+    // About one box per 16 square units
+    constexpr float AREA_PER_BRUSH = 16.0f;
+    constexpr float FLOOR_THICKNESS = 1.0f;
+}
+
+float GetSyntheticExtent(size_t brushCount) {
+    return std::sqrt(static_cast<float>(std::max<size_t>(brushCount, 1)) * AREA_PER_BRUSH) * 0.5f;
+}
+
+std::vector<SyntheticBox> GenerateSyntheticBoxes(size_t brushCount, uint32_t seed) {
+    std::vector<SyntheticBox> boxes;
+    if (brushCount == 0) return boxes;
+    boxes.reserve(brushCount);
+
+    float extent = GetSyntheticExtent(brushCount);
+
+    SyntheticBox floor;
+    floor.center = Vec3(0.0f, -FLOOR_THICKNESS * 0.5f, 0.0f);
+    floor.size = Vec3(extent * 2.0f, FLOOR_THICKNESS, extent * 2.0f);
+    boxes.push_back(floor);
+
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> position(-extent, extent);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    while (boxes.size() < brushCount) {
+        float x = position(rng);
+        float z = position(rng);
+        float kind = unit(rng);
+
+        if (kind < 0.1f) {
+            // Stair run: up to 4 steps of 0.25
+            int steps = std::min<int>(4, static_cast<int>(brushCount - boxes.size()));
+            for (int i = 0; i < steps; i++) {
+                SyntheticBox step;
+                step.size = Vec3(1.0f, 0.25f * (i + 1), 2.0f);
+                step.center = Vec3(x + static_cast<float>(i), step.size.y * 0.5f, z);
+                step.stair = true;
+                boxes.push_back(step);
+            }
+            continue;
+        }
+
+        SyntheticBox box;
+        if (kind < 0.35f) {
+            // Wall
+            bool alongX = unit(rng) < 0.5f;
+            float length = 2.0f + unit(rng) * 8.0f;
+            box.size = alongX ? Vec3(length, 3.0f, 0.5f) : Vec3(0.5f, 3.0f, length);
+        } else if (kind < 0.5f) {
+            // Raised platform
+            box.size = Vec3(2.0f + unit(rng) * 4.0f, 0.5f + unit(rng), 2.0f + unit(rng) * 4.0f);
+        } else {
+            // Crate
+            float s = 0.5f + unit(rng) * 1.5f;
+            box.size = Vec3(s);
+            box.yaw = unit(rng) < 0.3f ? unit(rng) * 90.0f : 0.0f;
+        }
+        box.center = Vec3(x, box.size.y * 0.5f, z);
+        boxes.push_back(box);
+    }
+    return boxes;
+}
+
+std::string GenerateSyntheticMapJson(size_t brushCount, uint32_t seed) {
+    static const char* MATERIALS[] = { "floor", "wall", "concrete", "brick", "metal", "wood" };
+
+    std::ostringstream json;
+    json << "{\n  \"name\": \"Synthetic " << brushCount << "\",\n"
+         << "  \"spawn_position\": [0, 1.5, 0],\n"
+         << "  \"brushes\": [\n";
+
+    auto boxes = GenerateSyntheticBoxes(brushCount, seed);
+    for (size_t i = 0; i < boxes.size(); i++) {
+        const SyntheticBox& box = boxes[i];
+        json << "    {\"name\": \"b" << i << "\", \"shape\": \"cube\""
+             << ", \"position\": [" << box.center.x << ", " << box.center.y << ", " << box.center.z << "]"
+             << ", \"size\": [" << box.size.x << ", " << box.size.y << ", " << box.size.z << "]";
+        if (box.yaw != 0.0f) {
+            json << ", \"rotation\": [0, " << box.yaw << ", 0]";
+        }
+        json << ", \"material\": \"" << MATERIALS[i % 6] << "\"";
+        if (box.stair) {
+            json << ", \"stair\": true";
+        }
+        json << (i + 1 < boxes.size() ? "},\n" : "}\n");
+    }
+
+    json << "  ]\n}\n";
+    return json.str();
+}
+
+void FillPhysicsWorld(PhysicsWorld& world, size_t brushCount, uint32_t seed) {
+    world.Clear();
+    for (const SyntheticBox& box : GenerateSyntheticBoxes(brushCount, seed)) {
+        if (box.stair) {
+            world.AddStair(box.center.x, box.center.y, box.center.z, box.size.x, box.size.y, box.size.z);
+        } else {
+            world.AddBox(box.center, box.size * 0.5f);
+        }
+    }
+}
+
+} // namespace Bench
+} // namespace Genesis
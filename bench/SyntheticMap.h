@@ -0,0 +1,44 @@
+#pragma once
+
+// ============================================================================
+// Synthetic Maps - Deterministic test worlds for benchmarks
+//
+// A floor plus 'brushCount - 1' boxes (walls, crates, platforms and stair
+// runs) scattered over a square whose area grows with the count, so brush
+// density - and with it the broadphase load per query - stays roughly the
+// same from 1k to 100k brushes. The same count and seed always produce the
+// same world.
+// ============================================================================
+
+#include "math/Math.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Genesis {
+
+class PhysicsWorld;
+
+namespace Bench {
+
+struct SyntheticBox {
+    Vec3 center = Vec3(0.0f);
+    Vec3 size = Vec3(1.0f);
+    float yaw = 0.0f;          // Degrees; only used for map brushes
+    bool stair = false;
+};
+
+// Half-width of the square the boxes are scattered over
+float GetSyntheticExtent(size_t brushCount);
+
+std::vector<SyntheticBox> GenerateSyntheticBoxes(size_t brushCount, uint32_t seed = 1);
+
+// Map JSON in the MapLoader format
+std::string GenerateSyntheticMapJson(size_t brushCount, uint32_t seed = 1);
+
+// Clear 'world' and fill it with the same boxes (axis-aligned)
+void FillPhysicsWorld(PhysicsWorld& world, size_t brushCount, uint32_t seed = 1);
+
+} // namespace Bench
+} // namespace Genesis
@@ -0,0 +1,402 @@
+// ============================================================================
+// Genesis Engine - Benchmark Entry Point (genesis_bench)
+//
+// Loads a map through MapLoader, replays a camera path through
+// StaticWorldRenderer::Render with vsync off and writes frame-time
+// percentiles, draw calls and triangles per frame as JSON.
+//
+// Usage:
+//   genesis_bench [--map testmap.json] [--path flythrough.txt] [--frames 600]
+//                 [--warmup 60] [--width 1280] [--height 720] [--headless]
+//                 [--assets ../assets/] [--out results.json] [--synthetic 10000]
+//
+// --synthetic N replaces --map with a generated N-brush map (SyntheticMap).
+// Without --path the camera orbits the map bounds. Record a path in game
+// with "camera_record <file>" / "camera_record stop". --headless renders
+// into an offscreen framebuffer, using GLFW's null platform with OSMesa
+// when available (no display needed) and a hidden window otherwise.
+// ============================================================================
+
+#include "core/Logger.h"
+#include "core/JobSystem.h"
+#include "camera/Camera.h"
+#include "camera/CameraPath.h"
+#include "renderer/GLState.h"
+#include "renderer/shader/Shader.h"
+#include "renderer/shader/UniformBuffer.h"
+#include "renderer/world/StaticWorldRenderer.h"
+#include "map/MapLoader.h"
+#include "map/MapRenderer.h"
+#include "SyntheticMap.h"
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace Genesis;
+
+// ============================================================================
+// Options
+// ============================================================================
+struct BenchOptions {
+    std::string map = "testmap.json";
+    std::string cameraPath;          // Empty: orbit the map
+    std::string assets;              // Empty: same paths as the game
+    std::string out;                 // Empty: stdout
+    int synthetic = 0;               // > 0: generated map with this many brushes
+    int frames = 600;
+    int warmup = 60;
+    int width = 1280;
+    int height = 720;
+    bool headless = false;
+};
+
+static bool ParseOptions(int argc, char** argv, BenchOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "--headless") {
+            options.headless = true;
+        } else if (arg == "--map" && hasValue) {
+            options.map = argv[++i];
+        } else if (arg == "--path" && hasValue) {
+            options.cameraPath = argv[++i];
+        } else if (arg == "--assets" && hasValue) {
+            options.assets = argv[++i];
+        } else if (arg == "--out" && hasValue) {
+            options.out = argv[++i];
+        } else if (arg == "--synthetic" && hasValue) {
+            options.synthetic = std::atoi(argv[++i]);
+        } else if (arg == "--frames" && hasValue) {
+            options.frames = std::atoi(argv[++i]);
+        } else if (arg == "--warmup" && hasValue) {
+            options.warmup = std::atoi(argv[++i]);
+        } else if (arg == "--width" && hasValue) {
+            options.width = std::atoi(argv[++i]);
+        } else if (arg == "--height" && hasValue) {
+            options.height = std::atoi(argv[++i]);
+        } else {
+            std::fprintf(stderr, "Unknown or incomplete option: %s\n", arg.c_str());
+            return false;
+        }
+    }
+
+    if (options.frames <= 0 || options.warmup < 0 || options.width <= 0 || options.height <= 0) {
+        std::fprintf(stderr, "Frame counts and sizes must be positive\n");
+        return false;
+    }
+    return true;
+}
+
+// ============================================================================
+// Context
+// ============================================================================
+
+// Offscreen target for --headless (the default framebuffer of a hidden or
+// null-platform window isn't guaranteed to be rendered at all)
+struct OffscreenTarget {
+    GLuint fbo = 0;
+    GLuint color = 0;
+    GLuint depth = 0;
+
+    bool Create(int width, int height) {
+        glGenRenderbuffers(1, &color);
+        glBindRenderbuffer(GL_RENDERBUFFER, color);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+
+        glGenRenderbuffers(1, &depth);
+        glBindRenderbuffer(GL_RENDERBUFFER, depth);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+
+        glGenFramebuffers(1, &fbo);
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, color);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depth);
+        return glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    }
+
+    void Release() {
+        if (fbo) glDeleteFramebuffers(1, &fbo);
+        if (color) glDeleteRenderbuffers(1, &color);
+        if (depth) glDeleteRenderbuffers(1, &depth);
+        fbo = color = depth = 0;
+    }
+};
+
+static void SetContextHints(bool visible) {
+    glfwDefaultWindowHints();
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+#ifdef __APPLE__
+    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+#endif
+    glfwWindowHint(GLFW_VISIBLE, visible ? GLFW_TRUE : GLFW_FALSE);
+}
+
+static GLFWwindow* CreateContext(const BenchOptions& options) {
+#if defined(GLFW_PLATFORM_NULL)
+    // No display at all: null platform + OSMesa software context
+    if (options.headless && glfwPlatformSupported(GLFW_PLATFORM_NULL)) {
+        glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+        if (glfwInit()) {
+            SetContextHints(false);
+            glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_OSMESA_CONTEXT_API);
+            if (GLFWwindow* window = glfwCreateWindow(options.width, options.height, "genesis_bench", nullptr, nullptr)) {
+                LOG_INFO("Bench", "Using null platform with OSMesa context");
+                return window;
+            }
+            glfwTerminate();
+        }
+        LOG_WARNING("Bench", "OSMesa context unavailable, falling back to a hidden window");
+        glfwInitHint(GLFW_PLATFORM, GLFW_ANY_PLATFORM);
+    }
+#endif
+
+    if (!glfwInit()) {
+        LOG_FATAL("Bench", "Failed to initialize GLFW");
+        return nullptr;
+    }
+
+    SetContextHints(!options.headless);
+    GLFWwindow* window = glfwCreateWindow(options.width, options.height, "genesis_bench", nullptr, nullptr);
+    if (!window) {
+        LOG_FATAL("Bench", "Failed to create GL context");
+        glfwTerminate();
+    }
+    return window;
+}
+
+// ============================================================================
+// Statistics
+// ============================================================================
+struct FrameSample {
+    double milliseconds = 0.0;
+    uint32_t drawCalls = 0;
+    uint32_t triangles = 0;
+};
+
+// Nearest-rank percentile of a sorted array
+static double Percentile(const std::vector<double>& sorted, double p) {
+    if (sorted.empty()) return 0.0;
+    size_t rank = static_cast<size_t>(std::ceil(p / 100.0 * static_cast<double>(sorted.size())));
+    rank = std::clamp<size_t>(rank, 1, sorted.size());
+    return sorted[rank - 1];
+}
+
+template<typename T>
+static void Summarize(const std::vector<T>& values, double& mean, T& maxValue) {
+    mean = 0.0;
+    maxValue = T(0);
+    for (T value : values) {
+        mean += static_cast<double>(value);
+        maxValue = std::max(maxValue, value);
+    }
+    if (!values.empty()) mean /= static_cast<double>(values.size());
+}
+
+static void WriteResults(std::FILE* file, const BenchOptions& options, const std::vector<FrameSample>& samples,
+                         double totalSeconds) {
+    std::vector<double> frameTimes;
+    std::vector<uint32_t> drawCalls, triangles;
+    for (const FrameSample& sample : samples) {
+        frameTimes.push_back(sample.milliseconds);
+        drawCalls.push_back(sample.drawCalls);
+        triangles.push_back(sample.triangles);
+    }
+
+    double meanMs = 0.0, meanDraws = 0.0, meanTris = 0.0;
+    double maxMs = 0.0;
+    uint32_t maxDraws = 0, maxTris = 0;
+    Summarize(frameTimes, meanMs, maxMs);
+    Summarize(drawCalls, meanDraws, maxDraws);
+    Summarize(triangles, meanTris, maxTris);
+    std::sort(frameTimes.begin(), frameTimes.end());
+
+    const char* renderer = reinterpret_cast<const char*>(glGetString(GL_RENDERER));
+
+    std::fprintf(file, "{\n");
+    std::fprintf(file, "  \"map\": \"%s\",\n", options.map.c_str());
+    std::fprintf(file, "  \"camera_path\": \"%s\",\n", options.cameraPath.empty() ? "orbit" : options.cameraPath.c_str());
+    std::fprintf(file, "  \"renderer\": \"%s\",\n", renderer ? renderer : "unknown");
+    std::fprintf(file, "  \"resolution\": [%d, %d],\n", options.width, options.height);
+    std::fprintf(file, "  \"headless\": %s,\n", options.headless ? "true" : "false");
+    std::fprintf(file, "  \"frames\": %zu,\n", samples.size());
+    std::fprintf(file, "  \"total_seconds\": %.4f,\n", totalSeconds);
+    std::fprintf(file, "  \"frame_ms\": {\"min\": %.4f, \"mean\": %.4f, \"p50\": %.4f, \"p95\": %.4f, \"p99\": %.4f, \"max\": %.4f},\n",
+                 frameTimes.empty() ? 0.0 : frameTimes.front(), meanMs,
+                 Percentile(frameTimes, 50.0), Percentile(frameTimes, 95.0), Percentile(frameTimes, 99.0), maxMs);
+    std::fprintf(file, "  \"draw_calls\": {\"mean\": %.2f, \"max\": %u},\n", meanDraws, maxDraws);
+    std::fprintf(file, "  \"triangles\": {\"mean\": %.1f, \"max\": %u}\n", meanTris, maxTris);
+    std::fprintf(file, "}\n");
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+int main(int argc, char** argv) {
+    BenchOptions options;
+    if (!ParseOptions(argc, argv, options)) {
+        return 2;
+    }
+
+    // Results go to stdout by default: keep the log to problems only
+    if (options.out.empty()) {
+        Logger::Instance().SetMinLevel(LogLevel::Warning);
+    }
+
+    GLFWwindow* window = CreateContext(options);
+    if (!window) return 1;
+
+    glfwMakeContextCurrent(window);
+    glfwSwapInterval(0);
+
+    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
+        LOG_FATAL("Bench", "Failed to initialize GLAD");
+        return 1;
+    }
+
+    OffscreenTarget offscreen;
+    if (options.headless && !offscreen.Create(options.width, options.height)) {
+        LOG_FATAL("Bench", "Failed to create offscreen framebuffer");
+        return 1;
+    }
+
+    // Same defaults as Engine::InitializeGraphics
+    auto& gl = GLStateCache::Instance();
+    gl.Invalidate();
+    gl.ApplyDefaults();
+    gl.SetDepthFunc(GL_LESS);
+    glViewport(0, 0, options.width, options.height);
+
+    JobSystem::Instance().Initialize();
+
+    auto& shaderLib = ShaderLibrary::Instance();
+    shaderLib.SetShaderBasePath(options.assets.empty() ? "../assets/shaders/" : options.assets + "shaders/");
+    if (!options.assets.empty()) {
+        MapLoader::Instance().SetBasePath(options.assets + "maps/");
+    }
+    if (!shaderLib.Load("mesh", "mesh.vert", "mesh.frag")) {
+        LOG_FATAL("Bench", "Failed to load mesh shader");
+        return 1;
+    }
+
+    // MapRenderer builds the StaticWorldRenderer objects from MapLoader's map
+    auto& mapRenderer = MapRenderer::Instance();
+    mapRenderer.GetStreamingConfig().enabled = false;   // The orbit views the whole map
+    if (options.synthetic > 0) {
+        options.map = "synthetic:" + std::to_string(options.synthetic);
+        MapPtr map = MapLoader::Instance().LoadFromString(Bench::GenerateSyntheticMapJson(options.synthetic));
+        if (!map) {
+            LOG_FATAL("Bench", "Failed to build synthetic map");
+            return 1;
+        }
+        mapRenderer.SetActiveMap(map);
+    } else if (!mapRenderer.LoadMap(options.map)) {
+        LOG_FATAL("Bench", "Failed to load map: " + options.map);
+        return 1;
+    }
+
+    auto& world = StaticWorldRenderer::Instance();
+    const auto& meta = mapRenderer.GetActiveMap()->GetMetadata();
+    world.SetDirectionalLight(meta.sunDirection, meta.sunColor, meta.sunIntensity);
+    world.SetAmbientLight(meta.ambientColor, 1.0f);
+
+    // Camera path: recorded, or one lap around the map
+    CameraPath path;
+    if (!options.cameraPath.empty()) {
+        if (!path.Load(options.cameraPath)) return 1;
+    } else {
+        AABB bounds(Vec3(0.0f), Vec3(0.0f));
+        bool first = true;
+        for (const auto& brush : mapRenderer.GetActiveMap()->GetBrushes()) {
+            bounds.min = first ? brush.worldBounds.min : glm::min(bounds.min, brush.worldBounds.min);
+            bounds.max = first ? brush.worldBounds.max : glm::max(bounds.max, brush.worldBounds.max);
+            first = false;
+        }
+        Vec3 extents = bounds.GetExtents();
+        float radius = std::max(std::max(extents.x, extents.z) * 1.25f, 5.0f);
+        path = CameraPath::CreateOrbit(bounds.GetCenter(), radius, std::max(extents.y, 2.0f), 10.0f);
+    }
+
+    FPSCamera camera;
+    camera.SetFOV(70.0f);
+    camera.SetAspectRatio(static_cast<float>(options.width) / static_cast<float>(options.height));
+    camera.SetPitchConstraints(-89.0f, 89.0f);
+
+    // Warmup frames replay the start of the path, measured frames span it
+    std::vector<FrameSample> samples;
+    samples.reserve(options.frames);
+    float duration = path.GetDuration();
+
+    using Clock = std::chrono::steady_clock;
+    auto benchStart = Clock::now();
+
+    for (int frame = 0; frame < options.warmup + options.frames; frame++) {
+        bool measured = frame >= options.warmup;
+        int index = measured ? frame - options.warmup : 0;
+        float time = options.frames > 1 ? duration * static_cast<float>(index) / static_cast<float>(options.frames - 1) : 0.0f;
+        path.Apply(time, camera);
+
+        if (measured && frame == options.warmup) {
+            benchStart = Clock::now();
+        }
+        auto frameStart = Clock::now();
+
+        gl.ResetStats();
+        gl.ApplyDefaults();
+        glClearColor(0.1f, 0.1f, 0.15f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        world.Render(camera);
+
+        if (!options.headless) {
+            glfwSwapBuffers(window);
+            glfwPollEvents();
+        }
+        // Frame time includes the GPU: nothing may stay queued
+        glFinish();
+
+        if (measured) {
+            FrameSample sample;
+            sample.milliseconds = std::chrono::duration<double, std::milli>(Clock::now() - frameStart).count();
+            sample.drawCalls = world.GetDrawCalls();
+            sample.triangles = world.GetTrianglesRendered();
+            samples.push_back(sample);
+        }
+    }
+    double totalSeconds = std::chrono::duration<double>(Clock::now() - benchStart).count();
+
+    bool written = false;
+    std::FILE* file = options.out.empty() ? stdout : std::fopen(options.out.c_str(), "w");
+    if (!file) {
+        LOG_ERROR("Bench", "Failed to open output file: " + options.out);
+    } else {
+        written = true;
+        WriteResults(file, options, samples, totalSeconds);
+        if (file != stdout) {
+            std::fclose(file);
+            LOG_INFO("Bench", "Results written to " + options.out);
+        }
+    }
+
+    // Release GL objects while the context is still alive
+    mapRenderer.UnloadMap();
+    world.Clear();
+    shaderLib.Clear();
+    FrameUniforms::Instance().Shutdown();
+    offscreen.Release();
+    JobSystem::Instance().Shutdown();
+
+    glfwDestroyWindow(window);
+    glfwTerminate();
+    return written ? 0 : 1;
+}
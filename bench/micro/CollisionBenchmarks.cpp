@@ -0,0 +1,345 @@
+// ============================================================================
+// PhysicsWorld / PlayerController benchmarks
+//
+// Argument: box count. Queries cycle through a fixed set of points spread
+// over the synthetic world, so every run touches the same grid cells.
+// ============================================================================
+
+#include "SyntheticMap.h"
+#include "physics/PhysicsWorld.h"
+#include "player/PlayerController.h"
+#include "player/PlayerControllerSystem.h"
+#include "core/RollbackBuffer.h"
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <random>
+
+using namespace Genesis;
+
+namespace {
+
+constexpr size_t QUERY_COUNT = 4096;
+const Vec3 PLAYER_HALF_EXTENTS(0.3f, 0.9f, 0.3f);
+
+std::vector<Vec3> MakeQueries(size_t boxCount, float height) {
+    float extent = Bench::GetSyntheticExtent(boxCount);
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> position(-extent, extent);
+
+    std::vector<Vec3> queries(QUERY_COUNT);
+    for (auto& query : queries) {
+        query = Vec3(position(rng), height, position(rng));
+    }
+    return queries;
+}
+
+// Rebuilding the world is expensive; only do it when the count changes
+PhysicsWorld& PrepareWorld(size_t boxCount) {
+    static size_t s_boxCount = 0;
+    auto& world = PhysicsWorld::Instance();
+    if (s_boxCount != boxCount) {
+        Bench::FillPhysicsWorld(world, boxCount);
+        s_boxCount = boxCount;
+    }
+    return world;
+}
+
+void BM_WorldCollision_CheckCollision(benchmark::State& state) {
+    size_t boxCount = static_cast<size_t>(state.range(0));
+    auto& world = PrepareWorld(boxCount);
+    auto queries = MakeQueries(boxCount, 1.0f);
+
+    size_t i = 0;
+    for (auto _ : state) {
+        const Vec3& position = queries[i++ & (QUERY_COUNT - 1)];
+        AABB bounds(position - PLAYER_HALF_EXTENTS, position + PLAYER_HALF_EXTENTS);
+        benchmark::DoNotOptimize(world.CheckCollision(position, bounds, 0.5f));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Exact capsule narrowphase on the same queries (player-sized capsule)
+void BM_PhysicsWorld_CheckCollisionCapsule(benchmark::State& state) {
+    size_t boxCount = static_cast<size_t>(state.range(0));
+    auto& world = PrepareWorld(boxCount);
+    auto queries = MakeQueries(boxCount, 1.0f);
+
+    size_t i = 0;
+    for (auto _ : state) {
+        const Vec3& position = queries[i++ & (QUERY_COUNT - 1)];
+        Capsule capsule(position - Vec3(0.0f, PLAYER_HALF_EXTENTS.y, 0.0f), PLAYER_HALF_EXTENTS.x,
+                        PLAYER_HALF_EXTENTS.y * 2.0f);
+        benchmark::DoNotOptimize(world.CheckCollision(capsule, 0.5f));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void BM_WorldCollision_GetPenetration(benchmark::State& state) {
+    size_t boxCount = static_cast<size_t>(state.range(0));
+    auto& world = PrepareWorld(boxCount);
+    auto queries = MakeQueries(boxCount, 1.0f);
+
+    size_t i = 0;
+    for (auto _ : state) {
+        const Vec3& position = queries[i++ & (QUERY_COUNT - 1)];
+        AABB bounds(position - PLAYER_HALF_EXTENTS, position + PLAYER_HALF_EXTENTS);
+        Vec3 pushOut(0.0f);
+        benchmark::DoNotOptimize(world.GetPenetration(bounds, pushOut, 0.5f));
+        benchmark::DoNotOptimize(pushOut);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// One 60 Hz tick at bhop speed (15 m/s) in a random horizontal direction
+void BM_WorldCollision_SweepAABB(benchmark::State& state) {
+    size_t boxCount = static_cast<size_t>(state.range(0));
+    auto& world = PrepareWorld(boxCount);
+    auto queries = MakeQueries(boxCount, 1.0f);
+
+    size_t i = 0;
+    for (auto _ : state) {
+        const Vec3& position = queries[i & (QUERY_COUNT - 1)];
+        float angle = static_cast<float>(i++ * 37 % 360) * 0.0174533f;
+        Vec3 delta(std::cos(angle) * 0.25f, 0.0f, std::sin(angle) * 0.25f);
+        AABB bounds(position - PLAYER_HALF_EXTENTS, position + PLAYER_HALF_EXTENTS);
+        SweepHit hit;
+        benchmark::DoNotOptimize(world.SweepAABB(bounds, delta, hit, 0.5f));
+        benchmark::DoNotOptimize(hit);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void BM_WorldCollision_RaycastDown(benchmark::State& state) {
+    size_t boxCount = static_cast<size_t>(state.range(0));
+    auto& world = PrepareWorld(boxCount);
+    auto queries = MakeQueries(boxCount, 10.0f);
+
+    size_t i = 0;
+    for (auto _ : state) {
+        float hitY = 0.0f;
+        benchmark::DoNotOptimize(world.RaycastDown(queries[i++ & (QUERY_COUNT - 1)], 20.0f, hitY));
+        benchmark::DoNotOptimize(hitY);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Hitscan / visibility load: RAY_BATCH rays per iteration, from the query
+// points in random directions (slightly downward so most rays end on boxes)
+constexpr size_t RAY_BATCH = 256;
+
+std::vector<RaycastQuery> MakeRays(size_t boxCount) {
+    auto origins = MakeQueries(boxCount, 1.5f);
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> angle(0.0f, 6.2831853f);
+    std::uniform_real_distribution<float> pitch(-0.3f, 0.05f);
+
+    std::vector<RaycastQuery> rays(QUERY_COUNT);
+    for (size_t i = 0; i < QUERY_COUNT; i++) {
+        float a = angle(rng);
+        rays[i].origin = origins[i];
+        rays[i].direction = Math::Normalize(Vec3(std::cos(a), pitch(rng), std::sin(a)));
+        rays[i].maxDistance = 50.0f;
+    }
+    return rays;
+}
+
+void BM_PhysicsWorld_RaycastBatch(benchmark::State& state) {
+    size_t boxCount = static_cast<size_t>(state.range(0));
+    auto& world = PrepareWorld(boxCount);
+    auto rays = MakeRays(boxCount);
+    std::vector<RaycastHit> hits(RAY_BATCH);
+
+    size_t i = 0;
+    for (auto _ : state) {
+        std::span<const RaycastQuery> batch(&rays[i], RAY_BATCH);
+        i = (i + RAY_BATCH) & (QUERY_COUNT - 1);
+        world.RaycastBatch(batch, hits);
+        benchmark::DoNotOptimize(hits.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * RAY_BATCH);
+}
+
+// Same load as a box cast (player-sized hull)
+void BM_PhysicsWorld_BoxCastBatch(benchmark::State& state) {
+    size_t boxCount = static_cast<size_t>(state.range(0));
+    auto& world = PrepareWorld(boxCount);
+    auto rays = MakeRays(boxCount);
+    for (auto& ray : rays) {
+        ray.halfExtents = PLAYER_HALF_EXTENTS;
+    }
+    std::vector<RaycastHit> hits(RAY_BATCH);
+
+    size_t i = 0;
+    for (auto _ : state) {
+        std::span<const RaycastQuery> batch(&rays[i], RAY_BATCH);
+        i = (i + RAY_BATCH) & (QUERY_COUNT - 1);
+        world.RaycastBatch(batch, hits);
+        benchmark::DoNotOptimize(hits.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * RAY_BATCH);
+}
+
+// One 60 Hz tick of a player running through the world, wired to
+// PhysicsWorld the same way game/main.cpp does it
+void BM_PlayerController_Update(benchmark::State& state) {
+    size_t boxCount = static_cast<size_t>(state.range(0));
+    auto& world = PrepareWorld(boxCount);
+    auto starts = MakeQueries(boxCount, 5.0f);
+
+    PlayerController controller;
+    PlayerControllerConfig config;
+    controller.Initialize(config);
+
+    float stairHeight = config.autoClimbStairHeight;
+    controller.SetGroundHeightCallback([&world](float x, float z, float playerY) {
+        return world.GetGroundHeight(x, z, 0.3f, playerY);
+    });
+    controller.SetCollisionCallback([&world, stairHeight](const Vec3& position, const AABB& bounds) {
+        return world.CheckCollision(position, bounds, stairHeight);
+    });
+    controller.SetSweepCallback([&world, stairHeight](const AABB& bounds, const Vec3& delta, SweepHit& hit) {
+        return world.SweepAABB(bounds, delta, hit, stairHeight);
+    });
+    controller.SetDepenetrationCallback([&world, stairHeight](const AABB& bounds, Vec3& pushOut) {
+        return world.GetPenetration(bounds, pushOut, stairHeight);
+    });
+    controller.SetStairClimbCallback([&world](float x, float z, float playerY, float radius, float maxHeight, const Vec3& moveDir) {
+        return world.GetStairClimbHeight(x, z, playerY, radius, maxHeight, moveDir);
+    });
+
+    // Re-spawn every 2 simulated seconds so the player keeps covering new ground
+    constexpr int TICKS_PER_RUN = 120;
+    size_t run = 0;
+    int tick = 0;
+    controller.Teleport(starts[0]);
+    controller.SetMoveInput(Vec3(0.0f, 0.0f, 1.0f));
+
+    for (auto _ : state) {
+        if (++tick == TICKS_PER_RUN) {
+            tick = 0;
+            run++;
+            controller.Teleport(starts[run & (QUERY_COUNT - 1)]);
+            controller.SetLookDirection(static_cast<float>(run * 37 % 360), 0.0f);
+        }
+        controller.Update(1.0f / 60.0f);
+        benchmark::DoNotOptimize(controller.GetPosition());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Same run as BM_PlayerController_Update, querying PhysicsWorld through
+// the PlayerCollisionWorld template instead of std::function callbacks
+void BM_PlayerController_UpdateDirect(benchmark::State& state) {
+    size_t boxCount = static_cast<size_t>(state.range(0));
+    auto& world = PrepareWorld(boxCount);
+    auto starts = MakeQueries(boxCount, 5.0f);
+
+    PlayerController controller;
+    controller.Initialize(PlayerControllerConfig());
+
+    constexpr int TICKS_PER_RUN = 120;
+    size_t run = 0;
+    int tick = 0;
+    controller.Teleport(starts[0], world);
+    controller.SetMoveInput(Vec3(0.0f, 0.0f, 1.0f));
+
+    for (auto _ : state) {
+        if (++tick == TICKS_PER_RUN) {
+            tick = 0;
+            run++;
+            controller.Teleport(starts[run & (QUERY_COUNT - 1)], world);
+            controller.SetLookDirection(static_cast<float>(run * 37 % 360), 0.0f);
+        }
+        controller.Update(1.0f / 60.0f, world);
+        benchmark::DoNotOptimize(controller.GetPosition());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Rollback re-simulation, the loop Engine::Rollback runs: restore the
+// oldest snapshot, then per tick restore its input, save and update.
+// Argument: ticks re-simulated per iteration (the rollback window), on a
+// 10k-box world. ticks_per_ms sizes windows against a frame budget.
+void BM_PlayerController_Resimulate(benchmark::State& state) {
+    uint32_t window = static_cast<uint32_t>(state.range(0));
+    auto& world = PrepareWorld(10000);
+    auto starts = MakeQueries(10000, 5.0f);
+
+    PlayerController controller;
+    controller.Initialize(PlayerControllerConfig());
+    controller.Teleport(starts[0], world);
+
+    // Record the window once, with some turning and jumping in it
+    RollbackBuffer history;
+    history.Initialize(window, sizeof(PlayerControllerSnapshot));
+    for (uint32_t tick = 0; tick < window; tick++) {
+        controller.SetMoveInput(Vec3(0.0f, 0.0f, 1.0f));
+        controller.SetLookDirection(static_cast<float>(tick * 7 % 360), 0.0f);
+        if (tick % 40 == 0) controller.Jump();
+        controller.SaveSnapshot(*static_cast<PlayerControllerSnapshot*>(history.Write(tick)));
+        controller.Update(1.0f / 60.0f, world);
+    }
+
+    for (auto _ : state) {
+        controller.RestoreSnapshot(*static_cast<const PlayerControllerSnapshot*>(history.Read(0)));
+        for (uint32_t tick = 0; tick < window; tick++) {
+            controller.RestoreInput(*static_cast<const PlayerControllerSnapshot*>(history.Read(tick)));
+            controller.SaveSnapshot(*static_cast<PlayerControllerSnapshot*>(history.Write(tick)));
+            controller.Update(1.0f / 60.0f, world);
+        }
+        benchmark::DoNotOptimize(controller.GetPosition());
+    }
+    state.SetItemsProcessed(state.iterations() * window);
+    state.counters["ticks_per_ms"] = benchmark::Counter(
+        static_cast<double>(state.iterations()) * window / 1000.0, benchmark::Counter::kIsRate);
+}
+
+// One tick of 64 agents; items are agent updates, comparable to
+// BM_PlayerController_Update
+void BM_PlayerControllerSystem_Update(benchmark::State& state) {
+    constexpr uint32_t AGENT_COUNT = 64;
+    size_t boxCount = static_cast<size_t>(state.range(0));
+    auto& world = PrepareWorld(boxCount);
+    auto starts = MakeQueries(boxCount, 5.0f);
+
+    PlayerControllerSystem system(world);
+    system.Reserve(AGENT_COUNT);
+    for (uint32_t i = 0; i < AGENT_COUNT; i++) {
+        PlayerAgentHandle agent = system.Add(starts[i]);
+        system.SetYaw(agent, static_cast<float>(i * 37 % 360));
+        system.SetMoveInput(agent, Vec3(0.0f, 0.0f, 1.0f));
+    }
+
+    constexpr int TICKS_PER_RUN = 120;
+    size_t run = 0;
+    int tick = 0;
+
+    for (auto _ : state) {
+        if (++tick == TICKS_PER_RUN) {
+            tick = 0;
+            run++;
+            for (uint32_t i = 0; i < AGENT_COUNT; i++) {
+                system.Teleport(system.GetHandle(i), starts[(run * AGENT_COUNT + i) & (QUERY_COUNT - 1)]);
+            }
+        }
+        system.Update(1.0f / 60.0f);
+        benchmark::DoNotOptimize(system.GetPositions().data());
+    }
+    state.SetItemsProcessed(state.iterations() * AGENT_COUNT);
+}
+
+} // namespace
+
+BENCHMARK(BM_WorldCollision_CheckCollision)->RangeMultiplier(10)->Range(1000, 100000);
+BENCHMARK(BM_PhysicsWorld_CheckCollisionCapsule)->RangeMultiplier(10)->Range(1000, 100000);
+BENCHMARK(BM_WorldCollision_GetPenetration)->RangeMultiplier(10)->Range(1000, 100000);
+BENCHMARK(BM_WorldCollision_SweepAABB)->RangeMultiplier(10)->Range(1000, 100000);
+BENCHMARK(BM_WorldCollision_RaycastDown)->RangeMultiplier(10)->Range(1000, 100000);
+BENCHMARK(BM_PhysicsWorld_RaycastBatch)->RangeMultiplier(10)->Range(1000, 100000);
+BENCHMARK(BM_PhysicsWorld_BoxCastBatch)->RangeMultiplier(10)->Range(1000, 100000);
+BENCHMARK(BM_PlayerController_Update)->RangeMultiplier(10)->Range(1000, 100000);
+BENCHMARK(BM_PlayerController_UpdateDirect)->RangeMultiplier(10)->Range(1000, 100000);
+BENCHMARK(BM_PlayerController_Resimulate)->RangeMultiplier(4)->Range(8, 128);
+BENCHMARK(BM_PlayerControllerSystem_Update)->RangeMultiplier(10)->Range(1000, 100000);
@@ -0,0 +1,36 @@
+// ============================================================================
+// MapLoader benchmarks
+//
+// Argument: brush count. Loads are deferred (LoadFromStringDeferred), which
+// runs the full parse and CPU build - transforms, bounds, colliders, BVH -
+// but leaves mesh/material resolution to a GL context.
+// ============================================================================
+
+#include "SyntheticMap.h"
+#include "map/MapLoader.h"
+#include <benchmark/benchmark.h>
+
+using namespace Genesis;
+
+namespace {
+
+void BM_MapLoader_LoadFromString(benchmark::State& state) {
+    size_t brushCount = static_cast<size_t>(state.range(0));
+    std::string json = Bench::GenerateSyntheticMapJson(brushCount);
+    auto& loader = MapLoader::Instance();
+
+    for (auto _ : state) {
+        MapPtr map = loader.LoadFromStringDeferred(json);
+        if (!map) {
+            state.SkipWithError("synthetic map failed to parse");
+            break;
+        }
+        benchmark::DoNotOptimize(map.get());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(brushCount));
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(json.size()));
+}
+
+} // namespace
+
+BENCHMARK(BM_MapLoader_LoadFromString)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMillisecond);
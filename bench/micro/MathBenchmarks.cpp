@@ -0,0 +1,74 @@
+// ============================================================================
+// Bounds benchmarks - StaticObject::UpdateWorldBounds, BoxCollider::GetWorldAABB
+//
+// Argument: object count. Transforms mix translation, yaw and scale like
+// map brushes; the mesh only carries bounds (never uploaded, no GL needed).
+// ============================================================================
+
+#include "renderer/world/StaticWorldRenderer.h"
+#include "physics/Collider.h"
+#include <benchmark/benchmark.h>
+#include <random>
+
+using namespace Genesis;
+
+namespace {
+
+std::vector<Mat4> MakeTransforms(size_t count) {
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> position(-500.0f, 500.0f);
+    std::uniform_real_distribution<float> angle(0.0f, 360.0f);
+    std::uniform_real_distribution<float> scale(0.5f, 4.0f);
+
+    std::vector<Mat4> transforms(count);
+    for (auto& transform : transforms) {
+        transform = glm::translate(Mat4(1.0f), Vec3(position(rng), position(rng) * 0.01f, position(rng)));
+        transform = glm::rotate(transform, Math::Radians(angle(rng)), Vec3(0.0f, 1.0f, 0.0f));
+        transform = glm::scale(transform, Vec3(scale(rng), scale(rng), scale(rng)));
+    }
+    return transforms;
+}
+
+void BM_StaticObject_UpdateWorldBounds(benchmark::State& state) {
+    size_t count = static_cast<size_t>(state.range(0));
+
+    auto mesh = std::make_shared<Mesh>();
+    mesh->SetBoundingBox(Vec3(-0.5f), Vec3(0.5f));
+
+    std::vector<StaticObject> objects(count);
+    auto transforms = MakeTransforms(count);
+    for (size_t i = 0; i < count; i++) {
+        objects[i].mesh = mesh;
+        objects[i].transform = transforms[i];
+    }
+
+    for (auto _ : state) {
+        for (auto& object : objects) {
+            object.UpdateWorldBounds();
+        }
+        benchmark::DoNotOptimize(objects.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(count));
+}
+
+void BM_BoxCollider_GetWorldAABB(benchmark::State& state) {
+    size_t count = static_cast<size_t>(state.range(0));
+    auto transforms = MakeTransforms(count);
+    BoxCollider collider(0.5f, 0.5f, 0.5f);
+    std::vector<AABB> bounds(count);
+
+    for (auto _ : state) {
+        for (size_t i = 0; i < count; i++) {
+            bounds[i] = collider.GetWorldAABB(transforms[i]);
+        }
+        benchmark::DoNotOptimize(bounds.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(count));
+}
+
+} // namespace
+
+BENCHMARK(BM_StaticObject_UpdateWorldBounds)->RangeMultiplier(10)->Range(1000, 100000);
+BENCHMARK(BM_BoxCollider_GetWorldAABB)->RangeMultiplier(10)->Range(1000, 100000);
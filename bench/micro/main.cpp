@@ -0,0 +1,27 @@
+// ============================================================================
+// Genesis Engine - Microbenchmarks (genesis_microbench)
+//
+// Google Benchmark suite for collision, map parsing and math hot paths.
+// Run with --benchmark_filter=<regex>, --benchmark_repetitions=N and
+// --benchmark_out=<file> --benchmark_out_format=json to compare builds.
+// ============================================================================
+
+#include "core/JobSystem.h"
+#include "core/Logger.h"
+#include <benchmark/benchmark.h>
+
+int main(int argc, char** argv) {
+    // Loaders log every map; keep the report readable
+    Genesis::Logger::Instance().SetMinLevel(Genesis::LogLevel::Warning);
+
+    // Same scheduler the engine runs MapLoader's ParallelFor on
+    Genesis::JobSystem::Instance().Initialize();
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+
+    Genesis::JobSystem::Instance().Shutdown();
+    return 0;
+}
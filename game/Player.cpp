@@ -1,5 +1,7 @@
 #include "Player.h"
 #include "input/InputManager.h"
+#include "physics/PhysicsWorld.h"
+#include "gui/Console.h"
 #include <cmath>
 
 namespace Game {
@@ -8,8 +10,11 @@ void Player::Initialize(const PlayerConfig& config) {
     m_config = config;
     m_mouseSensitivity = config.mouseSensitivity;
 
+    // Tuned convar values carry over into the new config
+    RegisterConVars();
+
     // Initialize the controller with configuration
-    m_controller.Initialize(config.controllerConfig);
+    m_controller.Initialize(m_config.controllerConfig);
 
     // Set spawn position
     m_controller.SetPosition(config.spawnPosition);
@@ -22,15 +27,45 @@ void Player::Initialize(const PlayerConfig& config) {
     SyncCamera();
 }
 
+void Player::RegisterConVars() {
+    auto& console = Genesis::GUI::Console::Instance();
+    auto& movement = m_config.controllerConfig;
+
+    Genesis::GUI::ConVar* cvars[] = {
+        console.BindConVar("cl_walkspeed", &movement.walkSpeed, "Walk speed (units/s)"),
+        console.BindConVar("cl_sprintspeed", &movement.sprintSpeed, "Sprint speed (units/s)"),
+        console.BindConVar("sv_accelerate", &movement.groundAccelerate, "Ground acceleration"),
+        console.BindConVar("sv_airaccelerate", &movement.airAccelerate, "Air acceleration"),
+        console.BindConVar("sv_friction", &movement.groundFriction, "Ground friction"),
+        console.BindConVar("sv_stopspeed", &movement.stopSpeed, "Speed below which friction stops the player fully"),
+        console.BindConVar("sv_gravity", &movement.gravity, "Gravity (units/s^2)"),
+        console.BindConVar("sv_jumpforce", &movement.jumpForce, "Jump velocity (units/s)"),
+        console.BindConVar("sv_maxairjumps", &movement.maxAirJumps, "Extra jumps allowed in the air"),
+    };
+
+    // Bindings are rewritten above on every Initialize; the callbacks
+    // only need adding once
+    if (m_convarsRegistered) return;
+    m_convarsRegistered = true;
+    for (auto* cvar : cvars) {
+        cvar->AddChangeCallback([this](const Genesis::GUI::ConVar&) {
+            m_controller.SetConfig(m_config.controllerConfig);
+        });
+    }
+}
+
 void Player::Update(double deltaTime) {
-    // Process player input
-    ProcessInput();
+    // Input was applied per frame (ProcessInput from OnInput), so the
+    // controller state saved for rollback before this tick includes it
 
-    // Update controller physics
-    m_controller.Update(static_cast<float>(deltaTime));
+    // Update controller physics (queries the world directly, no callbacks)
+    m_controller.Update(static_cast<float>(deltaTime), Genesis::PhysicsWorld::Instance());
 
-    // Sync camera to follow player
-    SyncCamera();
+    // Sync camera to follow player (pipelined: via the frame snapshot,
+    // the render thread owns the camera)
+    if (!Genesis::Engine::Instance().IsPipelined()) {
+        SyncCamera();
+    }
 }
 
 void Player::ProcessInput() {
@@ -63,24 +98,43 @@ void Player::ProcessInput() {
     // Note: Jump is handled in OnInput (per-frame) to properly detect key press
 }
 
-void Player::ProcessMouseLook(float deltaX, float deltaY) {
+void Player::ComputeLook(float deltaX, float deltaY, float& yaw, float& pitch) const {
     // Apply mouse sensitivity
-    float newYaw = m_controller.GetYaw() + deltaX * m_mouseSensitivity;
-    float newPitch = m_controller.GetPitch() - deltaY * m_mouseSensitivity;
+    yaw = m_controller.GetYaw() + deltaX * m_mouseSensitivity;
+    pitch = m_controller.GetPitch() - deltaY * m_mouseSensitivity;
 
     // Keep yaw in reasonable range
-    if (newYaw > 360.0f) newYaw -= 360.0f;
-    if (newYaw < -360.0f) newYaw += 360.0f;
+    if (yaw > 360.0f) yaw -= 360.0f;
+    if (yaw < -360.0f) yaw += 360.0f;
 
     // Clamp pitch
-    newPitch = glm::clamp(newPitch, -89.0f, 89.0f);
+    pitch = glm::clamp(pitch, -89.0f, 89.0f);
+}
+
+void Player::ProcessMouseLook(float deltaX, float deltaY) {
+    // Motion already shown by last frame's late latch comes first
+    float newYaw, newPitch;
+    ComputeLook(deltaX + m_lateLookX, deltaY + m_lateLookY, newYaw, newPitch);
+    m_lateLookX = m_lateLookY = 0.0f;
 
     m_controller.SetLookDirection(newYaw, newPitch);
 }
 
-void Player::Render(Genesis::DebugRenderer* debugRenderer) {
-    if (debugRenderer) {
-        DrawDebugInfo(debugRenderer);
+void Player::ProcessLateMouseLook(float deltaX, float deltaY) {
+    m_lateLookX += deltaX;
+    m_lateLookY += deltaY;
+
+    float yaw, pitch;
+    ComputeLook(m_lateLookX, m_lateLookY, yaw, pitch);
+
+    auto& camera = Genesis::Engine::Instance().GetCamera();
+    camera.SetYaw(yaw);
+    camera.SetPitch(pitch);
+}
+
+void Player::Render(Genesis::DebugDrawList* debugDraw) {
+    if (debugDraw) {
+        DrawDebugInfo(debugDraw);
     }
 }
 
@@ -94,7 +148,7 @@ void Player::SetPosition(const Genesis::Vec3& pos) {
 }
 
 void Player::Teleport(const Genesis::Vec3& pos) {
-    m_controller.Teleport(pos);
+    m_controller.Teleport(pos, Genesis::PhysicsWorld::Instance());
     SyncCamera();
 }
 
@@ -115,7 +169,16 @@ void Player::SyncCamera() {
     camera.SetPitch(m_controller.GetPitch());
 }
 
-void Player::DrawDebugInfo(Genesis::DebugRenderer* renderer) const {
+void Player::WriteFrameState(Genesis::FrameState& state) const {
+    state.cameraPosition = m_controller.GetEyePosition();
+    state.cameraYaw = m_controller.GetYaw();
+    state.cameraPitch = m_controller.GetPitch();
+
+    state.debugDraw.Clear();
+    DrawDebugInfo(&state.debugDraw);
+}
+
+void Player::DrawDebugInfo(Genesis::DebugDrawList* renderer) const {
     if (!renderer) return;
 
     const auto& config = m_controller.GetConfig();
@@ -33,7 +33,7 @@ public:
     // ========================================================================
     void Initialize(const PlayerConfig& config = PlayerConfig());
     void Update(double deltaTime);
-    void Render(Genesis::DebugRenderer* debugRenderer = nullptr);
+    void Render(Genesis::DebugDrawList* debugDraw = nullptr);
 
     // ========================================================================
     // Input Processing
@@ -41,6 +41,11 @@ public:
     void ProcessInput();
     void ProcessMouseLook(float deltaX, float deltaY);
 
+    // Motion latched just before rendering: turns the engine camera now and
+    // reaches the controller with the next ProcessMouseLook (the simulation
+    // may be running meanwhile)
+    void ProcessLateMouseLook(float deltaX, float deltaY);
+
     // ========================================================================
     // Position and State
     // ========================================================================
@@ -71,15 +76,27 @@ public:
     // Updates the engine camera to follow the player
     void SyncCamera();
 
+    // Same view for a pipelined frame snapshot
+    void WriteFrameState(Genesis::FrameState& state) const;
+
     // ========================================================================
     // Debug
     // ========================================================================
-    void DrawDebugInfo(Genesis::DebugRenderer* renderer) const;
+    void DrawDebugInfo(Genesis::DebugDrawList* renderer) const;
 
 private:
+    // Movement tuning convars (sv_accelerate...), bound to
+    // m_config.controllerConfig and pushed to the controller on change
+    void RegisterConVars();
+
+    // Controller look turned by a mouse delta
+    void ComputeLook(float deltaX, float deltaY, float& yaw, float& pitch) const;
+
     Genesis::PlayerController m_controller;
     PlayerConfig m_config;
     float m_mouseSensitivity = 0.1f;
+    float m_lateLookX = 0.0f, m_lateLookY = 0.0f;   // Not yet in the controller
+    bool m_convarsRegistered = false;
 };
 
 } // namespace Game
@@ -11,7 +11,8 @@
 #include "renderer/world/StaticWorldRenderer.h"
 #include "gui/Console.h"
 #include "gui/DebugOverlay.h"
-#include "world/WorldCollision.h"
+#include "physics/PhysicsWorld.h"
+#include "physics/TriggerSystem.h"
 #include "map/MapRenderer.h"
 #include "map/Brush.h"
 #include "Player.h"
@@ -27,6 +28,7 @@ static DebugRenderer g_debugRenderer;
 static std::shared_ptr<Shader> g_debugShader;
 static std::shared_ptr<Shader> g_basicShader;
 static Game::Player g_player;
+static TriggerBodyHandle g_playerTrigger;
 static bool g_showCollisionDebug = false;
 
 // Debug visualization meshes (grid, axes)
@@ -34,34 +36,78 @@ static MeshPtr g_gridMesh;
 static MeshPtr g_axesMesh;
 static MaterialPtr g_matDebug;
 
+// Startup map load still staging in the background (see OnInput)
+static MapLoadHandlePtr g_mapLoad;
+
 // ============================================================================
 // Setup World Collision Geometry - Now handled by MapRenderer
 // ============================================================================
 // The world collision is now set up automatically when loading a map via MapRenderer.
 // This function is kept as a fallback for when no map is loaded.
-void SetupWorldCollision() {
-    auto& world = WorldCollision::Instance();
+void SetupPhysicsWorld() {
+    auto& world = PhysicsWorld::Instance();
     world.Clear();
     world.SetFloorHeight(0.0f);
     LOG_INFO("Game", "World collision cleared - map will provide geometry");
 }
 
+// testmap.json wasn't loaded: the .map version, or a simple floor
+void LoadFallbackWorld() {
+    LOG_WARNING("Game", "Failed to load testmap.json, trying testmap.map...");
+    if (!MapRenderer::Instance().LoadMap("testmap.map")) {
+        LOG_ERROR("Game", "Failed to load any map file!");
+        // Fall back to a simple floor
+        auto& staticWorld = StaticWorldRenderer::Instance();
+        staticWorld.Clear();
+        auto groundPlane = MeshPrimitives::CreatePlane(60.0f, 60.0f, 30, 30, "GroundPlane");
+        auto matFloor = MaterialLibrary::Instance().CreateSolidColor("Floor", Vec3(0.15f, 0.15f, 0.18f));
+        staticWorld.AddFloor(groundPlane, matFloor, glm::translate(Mat4(1.0f), Vec3(0.0f, 0.0f, 0.0f)));
+        staticWorld.SetDirectionalLight(Vec3(0.5f, 1.0f, 0.3f), Vec3(1.0f, 0.98f, 0.95f), 1.0f);
+        staticWorld.SetAmbientLight(Vec3(0.15f, 0.15f, 0.2f), 1.0f);
+        staticWorld.RebuildBatches();
+        SetupPhysicsWorld();
+    }
+}
+
+// Lighting from map metadata, and the spawn position from the map (or the
+// defaults without one)
+Vec3 ApplyMapSettings() {
+    auto& mapRenderer = MapRenderer::Instance();
+    LOG_INFO("Game", "Map loaded with " + std::to_string(mapRenderer.GetBrushCount()) + " brushes");
+    if (!mapRenderer.HasMap()) {
+        return Vec3(0.0f, 1.0f, 5.0f);
+    }
+
+    auto& staticWorld = StaticWorldRenderer::Instance();
+    auto& meta = mapRenderer.GetActiveMap()->GetMetadata();
+    staticWorld.SetDirectionalLight(meta.sunDirection, meta.sunColor, meta.sunIntensity);
+    staticWorld.SetAmbientLight(meta.ambientColor, 1.0f);
+
+    Vec3 spawn = mapRenderer.GetSpawnPosition();
+    LOG_INFO("Game", "Player spawn from map: " +
+        std::to_string(spawn.x) + ", " +
+        std::to_string(spawn.y) + ", " +
+        std::to_string(spawn.z));
+    return spawn;
+}
+
 // ============================================================================
 // Game Initialization
 // ============================================================================
 bool OnInit() {
     LOG_INFO("Game", "Initializing game...");
 
-    // Load shaders
+    // Load shaders (compiled in the background; they draw with the
+    // fallback shader until ready)
     auto& shaderLib = ShaderLibrary::Instance();
 
-    g_debugShader = shaderLib.Load("debug", "debug.vert", "debug.frag");
+    g_debugShader = shaderLib.LoadAsync("debug", "debug.vert", "debug.frag");
     if (!g_debugShader) {
         LOG_ERROR("Game", "Failed to load debug shader");
         return false;
     }
 
-    g_basicShader = shaderLib.Load("mesh", "mesh.vert", "mesh.frag");
+    g_basicShader = shaderLib.LoadAsync("mesh", "mesh.vert", "mesh.frag");
     if (!g_basicShader) {
         LOG_ERROR("Game", "Failed to load mesh shader");
         return false;
@@ -109,47 +155,22 @@ bool OnInit() {
 
     auto& mapRenderer = MapRenderer::Instance();
 
-    // Load the test map (you can switch to .json or .map format)
-    if (!mapRenderer.LoadMap("testmap.json")) {
-        LOG_WARNING("Game", "Failed to load testmap.json, trying testmap.map...");
-        if (!mapRenderer.LoadMap("testmap.map")) {
-            LOG_ERROR("Game", "Failed to load any map file!");
-            // Fall back to a simple floor
-            auto& staticWorld = StaticWorldRenderer::Instance();
-            staticWorld.Clear();
-            auto groundPlane = MeshPrimitives::CreatePlane(60.0f, 60.0f, 30, 30, "GroundPlane");
-            auto matFloor = MaterialLibrary::Instance().CreateSolidColor("Floor", Vec3(0.15f, 0.15f, 0.18f));
-            staticWorld.AddFloor(groundPlane, matFloor, glm::translate(Mat4(1.0f), Vec3(0.0f, 0.0f, 0.0f)));
-            staticWorld.SetDirectionalLight(Vec3(0.5f, 1.0f, 0.3f), Vec3(1.0f, 0.98f, 0.95f), 1.0f);
-            staticWorld.SetAmbientLight(Vec3(0.15f, 0.15f, 0.2f), 1.0f);
-            staticWorld.RebuildBatches();
-            SetupWorldCollision();
-        }
-    }
-
-    LOG_INFO("Game", "Map loaded with " + std::to_string(mapRenderer.GetBrushCount()) + " brushes");
-
-    // Setup lighting from map metadata (or use defaults)
-    auto& staticWorld = StaticWorldRenderer::Instance();
-    if (mapRenderer.HasMap()) {
-        auto& meta = mapRenderer.GetActiveMap()->GetMetadata();
-        staticWorld.SetDirectionalLight(meta.sunDirection, meta.sunColor, meta.sunIntensity);
-        staticWorld.SetAmbientLight(meta.ambientColor, 1.0f);
+    // The map preloaded at startup stages over the first frames and is
+    // applied by OnInput once done; otherwise load it now. (You can
+    // switch to .json or .map format.)
+    g_mapLoad = mapRenderer.GetPendingLoad();
+    if (g_mapLoad) {
+        LOG_INFO("Game", "Map loading in the background: " + g_mapLoad->GetFilepath());
+        SetupPhysicsWorld();    // A floor to stand on until it is in
+    } else if (!mapRenderer.LoadMap("testmap.json")) {
+        LoadFallbackWorld();
     }
 
     // Configure and initialize player
     Game::PlayerConfig playerConfig;
 
-    // Get spawn position from map, or use default
-    if (mapRenderer.HasMap()) {
-        playerConfig.spawnPosition = mapRenderer.GetSpawnPosition();
-        LOG_INFO("Game", "Player spawn from map: " +
-            std::to_string(playerConfig.spawnPosition.x) + ", " +
-            std::to_string(playerConfig.spawnPosition.y) + ", " +
-            std::to_string(playerConfig.spawnPosition.z));
-    } else {
-        playerConfig.spawnPosition = Vec3(0.0f, 1.0f, 5.0f);
-    }
+    // Spawn position and lighting from the map, or defaults
+    playerConfig.spawnPosition = g_mapLoad ? Vec3(0.0f, 1.0f, 5.0f) : ApplyMapSettings();
     playerConfig.mouseSensitivity = 0.1f;
 
     // Controller settings - Source-style movement
@@ -183,29 +204,20 @@ bool OnInit() {
 
     g_player.Initialize(playerConfig);
 
-    // Connect player to world collision system
-    auto& controller = g_player.GetController();
-
-    // Set ground height callback
-    controller.SetGroundHeightCallback([](float x, float z, float playerY) -> float {
-        return WorldCollision::Instance().GetGroundHeight(x, z, 0.3f, playerY);
+    // Trigger volumes (trigger_* entities) see the player as one body
+    auto& triggers = TriggerSystem::Instance();
+    g_playerTrigger = triggers.AddBody(g_player.GetController().GetAABB());
+    triggers.Subscribe("", [](const TriggerEvent& event) {
+        if (event.type == TriggerEventType::Stay) return;
+        const TriggerVolume& volume = *event.volume;
+        LOG_INFO("Trigger", std::string(event.type == TriggerEventType::Enter ? "Enter " : "Exit ") +
+                 (volume.classname.empty() ? "trigger" : volume.classname) +
+                 (volume.name.empty() ? "" : " '" + volume.name + "'"));
     });
 
-    // Set collision callback (pass stair climb height to allow walking into climbable stairs)
-    float stairClimbHeight = playerConfig.controllerConfig.autoClimbStairHeight;
-    controller.SetCollisionCallback([stairClimbHeight](const Vec3& position, const AABB& bounds) -> bool {
-        return WorldCollision::Instance().CheckCollision(position, bounds, stairClimbHeight);
-    });
-
-    // Set depenetration callback (pass stair climb height to not push out of climbable stairs)
-    controller.SetDepenetrationCallback([stairClimbHeight](const AABB& bounds, Vec3& pushOut) -> bool {
-        return WorldCollision::Instance().GetPenetration(bounds, pushOut, stairClimbHeight);
-    });
-
-    // Set stair climb callback for auto-climbing tagged stairs
-    controller.SetStairClimbCallback([](float x, float z, float playerY, float radius, float maxHeight, const Vec3& moveDir) -> float {
-        return WorldCollision::Instance().GetStairClimbHeight(x, z, playerY, radius, maxHeight, moveDir);
-    });
+    // Player::Update queries PhysicsWorld directly through
+    // PlayerController::Update(deltaTime, world); radius and stair climb
+    // height come from controllerConfig above
 
     LOG_INFO("Game", "Game initialized successfully");
     LOG_INFO("Game", "Controls: WASD=Move, Mouse=Look, Shift=Sprint, Space=Jump, Ctrl=Crouch");
@@ -219,11 +231,13 @@ bool OnInit() {
 // Draw Collision Debug Visualization
 // ============================================================================
 void DrawCollisionDebug() {
-    auto& world = WorldCollision::Instance();
+    auto& world = PhysicsWorld::Instance();
     const auto& boxes = world.GetBoxes();
 
     // Draw each collision box as a wire cube (yellow for normal, cyan for stairs)
     for (const auto& box : boxes) {
+        if (!box.isSolid) continue;  // Freed slot or trigger
+
         AABB aabb = box.GetAABB();
         Vec3 center = (aabb.min + aabb.max) * 0.5f;
         Vec3 size = aabb.max - aabb.min;
@@ -320,13 +334,24 @@ void OnShutdown() {
 void OnInput(double deltaTime) {
     auto& input = InputManager::Instance();
 
+    // Startup map finished staging: light it and move the player to its spawn
+    if (g_mapLoad && g_mapLoad->IsDone()) {
+        if (!g_mapLoad->Succeeded()) {
+            LoadFallbackWorld();
+        }
+        g_player.Teleport(ApplyMapSettings());
+        g_mapLoad.reset();
+    }
+
     // Mouse look
     double dx, dy;
     input.GetMouseDelta(dx, dy);
 
-    if (dx != 0.0 || dy != 0.0) {
-        g_player.ProcessMouseLook(static_cast<float>(dx), static_cast<float>(dy));
-    }
+    // Movement keys (held state, the same for every tick this frame)
+    g_player.ProcessInput();
+
+    // Always: it also folds in last frame's late-latched motion
+    g_player.ProcessMouseLook(static_cast<float>(dx), static_cast<float>(dy));
 
     // Jump - must be detected per-frame, not in fixed update
     if (input.IsActionPressed(GameAction::Jump)) {
@@ -354,12 +379,34 @@ void OnInput(double deltaTime) {
     }
 }
 
+// ============================================================================
+// Late Input (mouse motion that arrived during the frame, just before Render)
+// ============================================================================
+void OnLateInput(double dx, double dy) {
+    g_player.ProcessLateMouseLook(static_cast<float>(dx), static_cast<float>(dy));
+}
+
 // ============================================================================
 // Game Update (Fixed Timestep)
 // ============================================================================
 void OnUpdate(double deltaTime) {
     // Update player with deltaTime (movement, physics)
     g_player.Update(deltaTime);
+
+    // Trigger events are not rolled back, so a re-simulation must not
+    // fire them again
+    if (!Engine::Instance().IsResimulating()) {
+        auto& triggers = TriggerSystem::Instance();
+        triggers.SetBodyBounds(g_playerTrigger, g_player.GetController().GetAABB());
+        triggers.Update();
+    }
+}
+
+// ============================================================================
+// Frame Snapshot (pipelined mode, after the last fixed updates of a frame)
+// ============================================================================
+void OnSnapshot(FrameState& state) {
+    g_player.WriteFrameState(state);
 }
 
 // ============================================================================
@@ -379,9 +426,8 @@ void OnRender(double interpolation) {
     // Render Debug Visualization (Grid, Axes)
     // ========================================================================
     if (g_debugShader && g_debugShader->IsValid()) {
+        // View/projection come from the per-frame FrameData block
         g_debugShader->Bind();
-        g_debugShader->SetMat4("u_View", camera.GetViewMatrix());
-        g_debugShader->SetMat4("u_Proj", camera.GetProjectionMatrix());
 
         g_gridMesh->Draw();
         g_axesMesh->Draw();
@@ -394,13 +440,15 @@ void OnRender(double interpolation) {
     // ========================================================================
     if (g_debugShader && g_debugShader->IsValid()) {
         g_debugShader->Bind();
-        g_debugShader->SetMat4("u_View", camera.GetViewMatrix());
-        g_debugShader->SetMat4("u_Proj", camera.GetProjectionMatrix());
 
         g_debugRenderer.BeginFrame();
 
-        // Render player debug visualization
-        g_player.Render(&g_debugRenderer);
+        // Render player debug visualization (pipelined: as simulated)
+        if (engine.IsPipelined()) {
+            g_debugRenderer.Append(engine.GetRenderState().debugDraw);
+        } else {
+            g_player.Render(&g_debugRenderer);
+        }
 
         // F1 - Draw collision debug wireframes over real geometry
         if (g_showCollisionDebug) {
@@ -409,6 +457,7 @@ void OnRender(double interpolation) {
 
         g_debugRenderer.RenderTriangles();
         g_debugRenderer.RenderLines();
+        g_debugRenderer.RenderShapes(*g_debugShader);
         g_debugRenderer.EndFrame();
 
         g_debugShader->Unbind();
@@ -427,16 +476,30 @@ int main() {
     config.fullscreen = false;  // Launch in fullscreen mode
     config.vsync = false;
     config.fixedTimestep = 1.0 / 66.0;
+    config.pipelinedSimulation = false;  // Overlap fixed updates with rendering
+    config.rollbackTicks = 64;           // ~1 s of history at 66 Hz (rollback_test)
 
     // Get engine instance
     auto& engine = Engine::Instance();
 
     // Set callbacks
+    engine.SetOnPreload([] {
+        // Parsed on a job while the window opens; OnInit's LoadMap() takes it
+        MapRenderer::Instance().PreloadMap("testmap.json");
+    });
     engine.SetOnInit(OnInit);
     engine.SetOnShutdown(OnShutdown);
     engine.SetOnInput(OnInput);
+    engine.SetOnLateInput(OnLateInput);
     engine.SetOnUpdate(OnUpdate);
     engine.SetOnRender(OnRender);
+    engine.SetOnSnapshot(OnSnapshot);
+
+    // Rollback: the player controller is the whole simulated game state
+    engine.SetRollbackCallbacks(sizeof(PlayerControllerSnapshot),
+        [](void* state) { g_player.GetController().SaveSnapshot(*static_cast<PlayerControllerSnapshot*>(state)); },
+        [](const void* state) { g_player.GetController().RestoreSnapshot(*static_cast<const PlayerControllerSnapshot*>(state)); },
+        [](const void* state) { g_player.GetController().RestoreInput(*static_cast<const PlayerControllerSnapshot*>(state)); });
 
     // Initialize and run
     if (!engine.Initialize(config)) {
@@ -0,0 +1,137 @@
+#include "CameraPath.h"
+#include "Camera.h"
+#include "core/Logger.h"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+namespace Genesis {
+
+void CameraPath::AddKey(const CameraKey& key) {
+    // Out-of-order keys would break the binary search in Sample()
+    if (!m_keys.empty() && key.time < m_keys.back().time) {
+        return;
+    }
+    m_keys.push_back(key);
+}
+
+void CameraPath::AddKey(float time, const FPSCamera& camera) {
+    CameraKey key;
+    key.time = time;
+    key.position = camera.GetPosition();
+    key.yaw = camera.GetYaw();
+    key.pitch = camera.GetPitch();
+    AddKey(key);
+}
+
+bool CameraPath::Sample(float time, CameraKey& out) const {
+    if (m_keys.empty()) return false;
+
+    if (time <= m_keys.front().time) {
+        out = m_keys.front();
+        return true;
+    }
+    if (time >= m_keys.back().time) {
+        out = m_keys.back();
+        return true;
+    }
+
+    // First key after 'time'; the one before it starts the segment
+    auto next = std::upper_bound(m_keys.begin(), m_keys.end(), time,
+        [](float t, const CameraKey& key) { return t < key.time; });
+    const CameraKey& b = *next;
+    const CameraKey& a = *(next - 1);
+
+    float span = b.time - a.time;
+    float t = span > 0.0f ? (time - a.time) / span : 0.0f;
+
+    out.time = time;
+    out.position = Math::Lerp(a.position, b.position, t);
+    out.yaw = Math::LerpAngle(a.yaw, b.yaw, t);
+    out.pitch = Math::Lerp(a.pitch, b.pitch, t);
+    return true;
+}
+
+bool CameraPath::Apply(float time, FPSCamera& camera) const {
+    CameraKey key;
+    if (!Sample(time, key)) return false;
+
+    camera.SetPosition(key.position);
+    camera.SetYaw(key.yaw);
+    camera.SetPitch(key.pitch);
+    return true;
+}
+
+// ============================================================================
+// File I/O
+// ============================================================================
+
+bool CameraPath::Load(const std::string& filepath) {
+    std::ifstream file(filepath);
+    if (!file.is_open()) {
+        LOG_ERROR("CameraPath", "Failed to open camera path: " + filepath);
+        return false;
+    }
+
+    m_keys.clear();
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line)) {
+        lineNumber++;
+        if (line.empty() || line[0] == '#') continue;
+
+        std::istringstream iss(line);
+        CameraKey key;
+        if (!(iss >> key.time >> key.position.x >> key.position.y >> key.position.z >> key.yaw >> key.pitch)) {
+            LOG_WARNING("CameraPath", filepath + ":" + std::to_string(lineNumber) + ": malformed key, skipped");
+            continue;
+        }
+        AddKey(key);
+    }
+
+    LOG_INFO("CameraPath", "Loaded " + std::to_string(m_keys.size()) + " keys from " + filepath);
+    return !m_keys.empty();
+}
+
+bool CameraPath::Save(const std::string& filepath) const {
+    std::ofstream file(filepath);
+    if (!file.is_open()) {
+        LOG_ERROR("CameraPath", "Failed to write camera path: " + filepath);
+        return false;
+    }
+
+    file << "# time x y z yaw pitch\n";
+    for (const CameraKey& key : m_keys) {
+        file << key.time << ' ' << key.position.x << ' ' << key.position.y << ' ' << key.position.z
+             << ' ' << key.yaw << ' ' << key.pitch << '\n';
+    }
+    return file.good();
+}
+
+// ============================================================================
+// Generated Paths
+// ============================================================================
+
+CameraPath CameraPath::CreateOrbit(const Vec3& center, float radius, float height,
+                                   float duration, int keyCount) {
+    CameraPath path;
+    keyCount = std::max(keyCount, 2);
+
+    for (int i = 0; i < keyCount; i++) {
+        float t = static_cast<float>(i) / static_cast<float>(keyCount - 1);
+        float angle = t * Math::TWO_PI;
+
+        CameraKey key;
+        key.time = t * duration;
+        key.position = center + Vec3(std::cos(angle) * radius, height, std::sin(angle) * radius);
+
+        // Inverse of FPSCamera::UpdateVectors
+        Vec3 toCenter = Math::Normalize(center - key.position);
+        key.yaw = Math::Degrees(std::atan2(toCenter.z, toCenter.x));
+        key.pitch = Math::Degrees(std::asin(toCenter.y));
+        path.AddKey(key);
+    }
+    return path;
+}
+
+} // namespace Genesis
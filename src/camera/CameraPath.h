@@ -0,0 +1,58 @@
+#pragma once
+
+#include "math/Math.h"
+#include <string>
+#include <vector>
+
+namespace Genesis {
+
+class FPSCamera;
+
+// ============================================================================
+// Camera Key - One recorded camera pose
+// ============================================================================
+struct CameraKey {
+    float time = 0.0f;       // Seconds from the start of the path
+    Vec3 position = Vec3(0.0f);
+    float yaw = 0.0f;        // Degrees (FPSCamera convention)
+    float pitch = 0.0f;
+};
+
+// ============================================================================
+// Camera Path - Timed camera poses for recorded flythroughs
+//
+// Recorded in game with the camera_record console command and replayed by
+// genesis_bench. Keys must be added in increasing time; Sample() lerps the
+// position and takes the short way round for yaw.
+//
+// File format: plain text, one key per line as "time x y z yaw pitch";
+// lines starting with '#' are comments.
+// ============================================================================
+class CameraPath {
+public:
+    void Clear() { m_keys.clear(); }
+    bool IsEmpty() const { return m_keys.empty(); }
+    size_t GetKeyCount() const { return m_keys.size(); }
+    const std::vector<CameraKey>& GetKeys() const { return m_keys; }
+
+    void AddKey(const CameraKey& key);
+    void AddKey(float time, const FPSCamera& camera);
+
+    float GetDuration() const { return m_keys.empty() ? 0.0f : m_keys.back().time; }
+
+    // Pose at 'time' (clamped to the path); false if the path is empty
+    bool Sample(float time, CameraKey& out) const;
+    bool Apply(float time, FPSCamera& camera) const;
+
+    bool Load(const std::string& filepath);
+    bool Save(const std::string& filepath) const;
+
+    // Circle around 'center' looking at it, one lap in 'duration' seconds
+    static CameraPath CreateOrbit(const Vec3& center, float radius, float height,
+                                  float duration, int keyCount = 64);
+
+private:
+    std::vector<CameraKey> m_keys;
+};
+
+} // namespace Genesis
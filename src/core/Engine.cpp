@@ -3,33 +3,111 @@
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 #include <iostream>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
 
 #include "input/GLFWInputBackend.h"
 #include "gui/GUIRenderer.h"
 #include "gui/Console.h"
 #include "gui/DebugOverlay.h"
+#include "renderer/DynamicResolution.h"
+#include "renderer/GLState.h"
+#include "renderer/GpuTimer.h"
+#include "renderer/world/StaticWorldRenderer.h"
+#include "renderer/texture/TextureStreamer.h"
+#include "renderer/shader/UniformBuffer.h"
+#include "map/MapRenderer.h"
+#include "map/MapLoader.h"
+#include "core/FrameArena.h"
+#include "core/MemoryTracker.h"
+#include "core/JobSystem.h"
+#include "core/FileWatcher.h"
+#include "core/Profiler.h"
+#include "core/ProfileCapture.h"
+#include "core/StartupProfile.h"
 
 namespace Genesis {
 
+namespace {
+
+// The active map with all its brushes: a streamed map only holds its
+// resident cells, so its file is loaded again in full (console commands)
+MapPtr LoadCompleteActiveMap() {
+    auto& console = GUI::Console::Instance();
+    auto& mapRenderer = MapRenderer::Instance();
+    MapPtr map = mapRenderer.GetActiveMap();
+    if (!map) {
+        console.PrintWarning("No map loaded");
+        return nullptr;
+    }
+    if (!map->IsStreamed()) return map;
+
+    auto& loader = MapLoader::Instance();
+    loader.SetCellStreaming(false);
+    MapPtr complete = loader.Load(mapRenderer.GetActiveMapPath());
+    if (!complete) {
+        console.PrintWarning(loader.GetLastError());
+    }
+    return complete;
+}
+
+} // anonymous namespace
+
 bool Engine::Initialize(const EngineConfig& config) {
     if (m_initialized) {
         LOG_WARNING("Engine", "Engine already initialized");
         return true;
     }
 
+    StartupProfile::Instance().Begin();
     m_config = config;
+    if (!m_config.logFile.empty() && !Logger::Instance().SetLogFile(m_config.logFile)) {
+        LOG_WARNING("Engine", "Failed to open log file: " + m_config.logFile);
+    }
+    if (m_config.asyncLogging) {
+        Logger::Instance().StartAsync();
+    }
     LOG_INFO("Engine", "Initializing Genesis Engine...");
+    GENESIS_PROFILE_THREAD("Main");
+
+    // CPU-only startup work goes on jobs first, so it overlaps window and
+    // context creation (which GLFW keeps on this thread); what needs GL
+    // waits on it where it is first used
+    if (!JobSystem::Instance().Initialize(m_config.workerThreads)) return false;
+    ShaderLibrary::Instance().SetShaderBasePath("../assets/shaders/");
+    ShaderLibrary::Instance().PrefetchSources();
+    GUI::GUIRenderer::Instance().PrepareFontAtlas();
+    if (m_onPreload) {
+        m_onPreload();
+    }
 
     // Initialize subsystems
-    if (!InitializeWindow()) return false;
-    if (!InitializeGraphics()) return false;
-    if (!InitializeInput()) return false;
-    if (!InitializeShaders()) return false;
-    if (!InitializeGUI()) return false;
+    {
+        StartupProfile::Scope scope("Window");
+        if (!InitializeWindow()) return false;
+    }
+    {
+        StartupProfile::Scope scope("Graphics");
+        if (!InitializeGraphics()) return false;
+    }
+    {
+        StartupProfile::Scope scope("Input");
+        if (!InitializeInput()) return false;
+    }
+    {
+        StartupProfile::Scope scope("Shaders");
+        if (!InitializeShaders()) return false;
+    }
+    {
+        StartupProfile::Scope scope("GUI");
+        if (!InitializeGUI()) return false;
+    }
 
     // Initialize time
     Time::Instance().Initialize();
     Time::Instance().SetFixedDeltaTime(m_config.fixedTimestep);
+    InitializeRollback();
 
     // Initialize camera
     m_camera.SetPosition(0.0f, 2.0f, 5.0f);
@@ -43,11 +121,14 @@ bool Engine::Initialize(const EngineConfig& config) {
 
     // Call user init callback
     if (m_onInit) {
+        StartupProfile::Scope scope("Game init");
         if (!m_onInit()) {
             LOG_ERROR("Engine", "User initialization failed");
             return false;
         }
     }
+    ShaderLibrary::Instance().ReleasePrefetchedSources();
+    StartupProfile::Instance().LogBreakdown();
 
     m_initialized = true;
     LOG_INFO("Engine", "Genesis Engine initialized successfully");
@@ -70,6 +151,23 @@ void Engine::Shutdown() {
     }
 
     // Shutdown subsystems
+    FileWatcher::Instance().Stop();
+    MapRenderer::Instance().CancelAsyncLoad();
+    MapRenderer::Instance().StopStreaming();
+    TextureStreamer::Instance().Shutdown();
+    JobSystem::Instance().Shutdown();
+#if defined(GENESIS_PROFILER_ENABLED)
+    ProfileCapture::Instance().Shutdown();
+    GpuTimers::Instance().Shutdown();
+#endif
+    FrameUniforms::Instance().Shutdown();
+    DynamicResolution::Instance().Shutdown();
+    StaticWorldRenderer::Instance().SetGpuDriven(false);
+    StaticWorldRenderer::Instance().SetShadows(false);
+    StaticWorldRenderer::Instance().SetDepthPrepass(false);
+    StaticWorldRenderer::Instance().SetOverdrawMeasure(false);
+    StaticWorldRenderer::Instance().GetLights().Shutdown();
+    StaticWorldRenderer::Instance().SetLightmap(nullptr);
     ShaderLibrary::Instance().Clear();
     InputManager::Instance().Shutdown();
 
@@ -81,6 +179,7 @@ void Engine::Shutdown() {
 
     m_initialized = false;
     LOG_INFO("Engine", "Genesis Engine shut down");
+    Logger::Instance().StopAsync();
 }
 
 void Engine::Run() {
@@ -91,14 +190,29 @@ void Engine::Run() {
 
     m_running = true;
     m_accumulator = 0.0;
+    SeedFrameStates();
 
     LOG_INFO("Engine", "Starting game loop...");
 
     while (m_running && !glfwWindowShouldClose(m_window)) {
+        // Close the profiler's previous frame before timing this one
+        GENESIS_PROFILE_FRAME();
+        GENESIS_PROFILE_SCOPE("Frame");
+
+        // Wait out the frame budget before sampling input
+        {
+            GENESIS_PROFILE_SCOPE("Frame Pacing");
+            UpdateFramePacing();
+            m_framePacer.WaitForFrame(m_config.vsync);
+        }
+
         // Update time
         Time::Instance().Update();
         double deltaTime = Time::Instance().GetDeltaTime();
 
+        // Last frame's transient allocations are dead now
+        FrameArena::Instance().Reset();
+
         // Clamp frame time to prevent spiral of death
         if (deltaTime > m_config.maxFrameSkip * m_config.fixedTimestep) {
             deltaTime = m_config.maxFrameSkip * m_config.fixedTimestep;
@@ -108,7 +222,11 @@ void Engine::Run() {
         InputManager::Instance().Update();
 
         // Poll events - this triggers callbacks that update current state
-        glfwPollEvents();
+        {
+            GENESIS_PROFILE_SCOPE("Poll Events");
+            glfwPollEvents();
+        }
+        InputManager::Instance().ProcessEvents();
 
         // Check if console is open - pause game when open
         bool consolePaused = GUI::Console::Instance().IsOpen();
@@ -137,33 +255,95 @@ void Engine::Run() {
             }
         }
 
+        // Queued console commands (exec'd configs, binds) run at this one
+        // point: after input, before the ticks, with no simulation in flight
+        GUI::Console::Instance().ExecuteBuffer();
+
         // Fixed timestep updates - SKIP when console is open (pause the game)
+        int ticks = 0;
         if (!consolePaused) {
             m_accumulator += deltaTime;
-            int updatesThisFrame = 0;
-            while (m_accumulator >= m_config.fixedTimestep &&
-                   updatesThisFrame < m_config.maxFrameSkip) {
-                Update(m_config.fixedTimestep);
+            while (m_accumulator >= m_config.fixedTimestep && ticks < m_config.maxFrameSkip) {
                 m_accumulator -= m_config.fixedTimestep;
-                updatesThisFrame++;
+                ticks++;
             }
         }
 
         // Calculate interpolation for smooth rendering
         double interpolation = m_accumulator / m_config.fixedTimestep;
 
-        // Render (always render even when paused)
-        Render(interpolation);
+        // Swap in shaders whose background compile has finished
+        ShaderLibrary::Instance().UpdatePendingShaders();
+
+        // Upload finished texture reads and start new ones (from the
+        // screen sizes the renderers reported last frame)
+        TextureStreamer::Instance().Update(static_cast<uint32_t>(std::max(m_screenHeight, 1)));
+
+        if (m_config.pipelinedSimulation && m_onSnapshot) {
+            // Simulate the next frame on a worker while this one renders
+            // from the last snapshots
+            auto& jobs = JobSystem::Instance();
+            JobCounter simulated;
+            if (ticks > 0) {
+                jobs.Submit([this, ticks] { Simulate(ticks); }, &simulated);
+            }
 
-        // Swap buffers
-        glfwSwapBuffers(m_window);
+            Logger::Instance().FlushConsole();
 
-        // Check for shader hot reload
-        static float hotReloadTimer = 0.0f;
-        hotReloadTimer += static_cast<float>(deltaTime);
-        if (hotReloadTimer >= 1.0f) {
-            ShaderLibrary::Instance().CheckForReloads();
-            hotReloadTimer = 0.0f;
+            ApplyRenderState();
+            LatchLateInput(consolePaused);
+            Render(m_renderInterpolation);
+            m_framePacer.EndWork();
+            {
+                GENESIS_PROFILE_SCOPE("Swap Buffers");
+                glfwSwapBuffers(m_window);
+            }
+            m_framePacer.EndFrame();
+
+            {
+                GENESIS_PROFILE_SCOPE("Wait Simulation");
+                jobs.Wait(simulated);
+            }
+            PublishFrameStates(ticks, interpolation);
+
+            // World edits only while the simulation is idle
+            MapRenderer::Instance().UpdateAsyncLoad();
+            MapRenderer::Instance().UpdateStreaming(m_camera.GetPosition());
+        } else {
+            for (int i = 0; i < ticks; i++) {
+                Update(m_config.fixedTimestep);
+            }
+
+            // Stream in a background map load and the cells around the
+            // camera (bounded main-thread time)
+            MapRenderer::Instance().UpdateAsyncLoad();
+            MapRenderer::Instance().UpdateStreaming(m_camera.GetPosition());
+
+            // Deliver log messages from worker threads to the console
+            Logger::Instance().FlushConsole();
+
+            // Render (always render even when paused)
+            LatchLateInput(consolePaused);
+            Render(interpolation);
+
+            // Swap buffers
+            m_framePacer.EndWork();
+            GENESIS_PROFILE_SCOPE("Swap Buffers");
+            glfwSwapBuffers(m_window);
+            m_framePacer.EndFrame();
+        }
+
+        // Hot reload: changed files from the watcher, or polling mod times
+        // where the OS has no change notifications
+        if (FileWatcher::Instance().IsRunning()) {
+            ProcessFileChanges();
+        } else {
+            static float hotReloadTimer = 0.0f;
+            hotReloadTimer += static_cast<float>(deltaTime);
+            if (hotReloadTimer >= 1.0f) {
+                ShaderLibrary::Instance().CheckForReloads();
+                hotReloadTimer = 0.0f;
+            }
         }
     }
 
@@ -200,6 +380,12 @@ bool Engine::InitializeWindow() {
     glfwSetFramebufferSizeCallback(m_window, FramebufferSizeCallback);
     glfwSwapInterval(m_config.vsync ? 1 : 0);
 
+    // Vblank interval for low-latency pacing
+    GLFWmonitor* display = monitor ? monitor : glfwGetPrimaryMonitor();
+    if (const GLFWvidmode* mode = display ? glfwGetVideoMode(display) : nullptr) {
+        m_framePacer.SetRefreshRate(mode->refreshRate);
+    }
+
     LOG_INFO("Engine", "Window created: " + std::to_string(m_config.windowWidth) +
              "x" + std::to_string(m_config.windowHeight));
     return true;
@@ -213,9 +399,11 @@ bool Engine::InitializeGraphics() {
         return false;
     }
 
-    // Enable depth testing
-    glEnable(GL_DEPTH_TEST);
-    glDepthFunc(GL_LESS);
+    // Fresh context: start from the engine's default depth/cull/blend state
+    auto& gl = GLStateCache::Instance();
+    gl.Invalidate();
+    gl.ApplyDefaults();
+    gl.SetDepthFunc(GL_LESS);
 
     // Enable line smoothing
     glEnable(GL_LINE_SMOOTH);
@@ -224,6 +412,28 @@ bool Engine::InitializeGraphics() {
     LOG_INFO("Engine", "OpenGL Version: " + std::string((char*)glGetString(GL_VERSION)));
     LOG_INFO("Engine", "Renderer: " + std::string((char*)glGetString(GL_RENDERER)));
 
+    // A 3.3 core request usually gets the newest core version the driver has
+    if (m_config.gpuDrivenWorld) {
+        StaticWorldRenderer::Instance().SetGpuDriven(true);
+    }
+    if (m_config.materialBatching) {
+        StaticWorldRenderer::Instance().SetMaterialBatching(MaterialBatching::Bindless);
+        LOG_INFO("Engine", std::string("Material batching: ") +
+                 (MaterialTable::IsBindlessSupported() ? "bindless textures" : "texture arrays"));
+    }
+    if (m_config.shadows) {
+        StaticWorldRenderer::Instance().SetShadows(true);
+    }
+
+    auto& dynamicResolution = DynamicResolution::Instance().GetConfig();
+    dynamicResolution.enabled = m_config.dynamicResolution;
+    dynamicResolution.targetMs = m_config.dynamicResolutionTargetMs;
+    dynamicResolution.minScale = m_config.dynamicResolutionMinScale;
+    dynamicResolution.maxScale = m_config.dynamicResolutionMaxScale;
+    dynamicResolution.sharpness = m_config.upscaleSharpness;
+
+    Mesh::SetReleaseCPUData(m_config.releaseMeshCPUData);
+
     return true;
 }
 
@@ -246,14 +456,364 @@ bool Engine::InitializeInput() {
 bool Engine::InitializeShaders() {
     LOG_INFO("Engine", "Initializing shader system...");
 
+    // Base path set (and its sources prefetched) at the start of Initialize()
     auto& shaderLib = ShaderLibrary::Instance();
-    shaderLib.SetShaderBasePath("../assets/shaders/");
     shaderLib.SetHotReloadEnabled(true);
 
+    // Watch shaders and maps for edits (Run() falls back to polling)
+    auto& watcher = FileWatcher::Instance();
+    if (watcher.Start()) {
+        watcher.WatchDirectory(shaderLib.GetShaderBasePath());
+        watcher.WatchDirectory(MapLoader::Instance().GetBasePath());
+    }
+
     LOG_INFO("Engine", "Shader system initialized");
     return true;
 }
 
+void Engine::ProcessFileChanges() {
+    std::vector<std::string> changed;
+    if (!FileWatcher::Instance().Poll(changed)) return;
+    GENESIS_PROFILE_SCOPE("Hot Reload");
+
+    ShaderLibrary::Instance().OnFilesChanged(changed);
+    MapRenderer::Instance().OnFilesChanged(changed);
+}
+
+void Engine::RegisterMapCommands() {
+    auto& console = GUI::Console::Instance();
+
+    // map <file> - Load a map in the background
+    console.RegisterCommand("map", [](const std::vector<std::string>& args) {
+        auto& console = GUI::Console::Instance();
+        if (args.size() < 2) {
+            console.PrintWarning("Usage: map <file>");
+            return;
+        }
+        if (MapRenderer::Instance().LoadMapAsync(args[1])) {
+            console.Print("Loading " + args[1] + "... (map_status for progress)");
+        }
+    }, "Load a map in the background");
+
+    // map_status - Show progress of the background map load
+    console.RegisterCommand("map_status", [](const std::vector<std::string>&) {
+        auto& console = GUI::Console::Instance();
+        auto& mapRenderer = MapRenderer::Instance();
+
+        if (auto handle = mapRenderer.GetPendingLoad()) {
+            int percent = static_cast<int>(handle->GetProgress() * 100.0f);
+            console.Print(handle->GetFilepath() + ": " + handle->GetStateName() +
+                          " (" + std::to_string(percent) + "%)");
+        } else if (mapRenderer.HasMap()) {
+            console.Print("Active map: " + mapRenderer.GetActiveMap()->GetName() + " (" +
+                          std::to_string(mapRenderer.GetBrushCount()) + " brushes)");
+            if (mapRenderer.IsStreaming()) {
+                const MapStreamingStats& stats = mapRenderer.GetStreamingStats();
+                console.Printf("Cells: %u resident, %u loading of %u (%llu loaded, %llu unloaded so far)",
+                               stats.residentCells, stats.loadingCells, stats.cells,
+                               static_cast<unsigned long long>(stats.cellsLoaded),
+                               static_cast<unsigned long long>(stats.cellsUnloaded));
+            }
+        } else {
+            console.Print("No map loaded");
+        }
+    }, "Show background map load progress");
+
+    // map_bake <file.gmap> - Bake the active map's lightmap and compile it
+    console.RegisterCommand("map_bake", [](const std::vector<std::string>& args) {
+        auto& console = GUI::Console::Instance();
+        if (args.size() < 2) {
+            console.PrintWarning("Usage: map_bake <file.gmap>");
+            return;
+        }
+        MapPtr map = LoadCompleteActiveMap();
+        if (!map) return;
+
+        // Blocks until the bake is done; the running map keeps its lighting
+        map->SetLightmap(LightmapBaker::Bake(*map));
+        if (MapLoader::Instance().SaveBinary(*map, args[1], true, true, true)) {
+            console.Print("Compiled " + args[1] + " with " + std::to_string(map->GetLightmap()->charts.size()) +
+                          " lightmap charts (map " + args[1] + " to load it)");
+        } else {
+            console.PrintWarning(MapLoader::Instance().GetLastError());
+        }
+    }, "Bake the active map's lightmap and compile it to a .gmap");
+
+    // map_compile <file.gmap> [cell size] - Compile the active map partitioned
+    console.RegisterCommand("map_compile", [](const std::vector<std::string>& args) {
+        auto& console = GUI::Console::Instance();
+        if (args.size() < 2) {
+            console.PrintWarning("Usage: map_compile <file.gmap> [cell size]");
+            return;
+        }
+        float cellSize = WorldPartitioner::DEFAULT_CELL_SIZE;
+        if (args.size() > 2) {
+            cellSize = std::strtof(args[2].c_str(), nullptr);
+            if (cellSize <= 0.0f) {
+                console.PrintWarning("Cell size must be positive");
+                return;
+            }
+        }
+        MapPtr map = LoadCompleteActiveMap();
+        if (!map) return;
+
+        // Keeps the lightmap if the map has one, but doesn't bake a new one
+        if (MapLoader::Instance().SaveBinary(*map, args[1], true, true, map->GetLightmap() != nullptr, cellSize)) {
+            console.Print("Compiled " + args[1] + " in " + std::to_string(static_cast<int>(cellSize)) +
+                          " unit cells (map " + args[1] + " to stream it)");
+        } else {
+            console.PrintWarning(MapLoader::Instance().GetLastError());
+        }
+    }, "Compile the active map to a .gmap partitioned into streaming cells");
+
+    // World partition streaming; map_streaming applies from the next load
+    MapStreamingConfig& streaming = MapRenderer::Instance().GetStreamingConfig();
+    console.BindConVar("map_streaming", &streaming.enabled, "Stream partitioned maps by cell around the camera");
+    console.BindConVar("map_stream_radius", &streaming.loadRadius, "Distance cells are loaded within");
+    console.BindConVar("map_stream_hysteresis", &streaming.unloadMargin,
+                       "Extra distance before a loaded cell is dropped again");
+    console.BindConVar("map_stream_loads", &streaming.maxLoads, "Cell reads in flight");
+}
+
+void Engine::RegisterCameraCommands() {
+    auto& console = GUI::Console::Instance();
+
+    // camera_record <file> | stop - Record the camera for genesis_bench
+    console.RegisterCommand("camera_record", [this](const std::vector<std::string>& args) {
+        auto& console = GUI::Console::Instance();
+        if (args.size() < 2) {
+            console.PrintWarning("Usage: camera_record <file> | camera_record stop");
+            return;
+        }
+
+        if (args[1] == "stop") {
+            if (!m_recordingCamera) {
+                console.PrintWarning("Not recording");
+                return;
+            }
+            m_recordingCamera = false;
+            if (m_cameraRecording.Save(m_cameraRecordFile)) {
+                console.Print("Saved " + std::to_string(m_cameraRecording.GetKeyCount()) +
+                              " camera keys to " + m_cameraRecordFile);
+            }
+            m_cameraRecording.Clear();
+            return;
+        }
+
+        m_cameraRecording.Clear();
+        m_cameraRecordFile = args[1];
+        m_cameraRecordStart = Time::Instance().GetTotalTime();
+        m_recordingCamera = true;
+        console.Print("Recording camera to " + m_cameraRecordFile + " (camera_record stop to finish)");
+    }, "Record the camera path to a file (replay with genesis_bench)");
+}
+
+void Engine::RegisterFramePacingConVars() {
+    auto& console = GUI::Console::Instance();
+
+    // Defaults come from EngineConfig; the convars are bound to its fields,
+    // which UpdateFramePacing reads on the next frame
+    console.BindConVar("ge_fps_max", &m_config.maxFPS,
+                       "Frame rate limit (0 = unlimited)");
+    console.BindConVar("ge_fps_max_menu", &m_config.menuMaxFPS,
+                       "Frame rate limit with the console open or the window in the background (0 = use ge_fps_max)");
+    console.BindConVar("ge_low_latency", &m_config.lowLatency,
+                       "With vsync, delay input sampling until just before the next vblank - 0 or 1");
+}
+
+void Engine::RegisterTextureConVars() {
+    auto& console = GUI::Console::Instance();
+    auto& config = TextureStreamer::Instance().GetConfig();
+
+    console.BindConVar("r_texture_budget_mb", &config.budgetMB,
+                       "VRAM for streamed texture mips, in MB (mip detail drops to fit)");
+    console.BindConVar("r_texture_upload_mb", &config.uploadMBPerFrame,
+                       "Texture mip data started per frame, in MB");
+    console.RegisterCommand("texture_status", [](const std::vector<std::string>&) {
+        const auto& stats = TextureStreamer::Instance().GetStats();
+        char line[160];
+        std::snprintf(line, sizeof(line), "%u textures, %.1f / %.1f MB resident (wanted %.1f MB, bias %u), %u reads in flight",
+                      stats.textures, stats.residentBytes / 1048576.0,
+                      TextureStreamer::Instance().GetConfig().budgetMB * 1.0,
+                      stats.wantedBytes / 1048576.0, stats.budgetBias, stats.inFlight);
+        GUI::Console::Instance().Print(line);
+    }, "Texture streaming residency and budget");
+}
+
+void Engine::RegisterShadowConVars() {
+    auto& console = GUI::Console::Instance();
+    auto& config = StaticWorldRenderer::Instance().GetShadows().GetConfig();
+
+    // Read by CascadedShadowMap::Update; a change redraws every cascade
+    console.BindConVar("r_shadow_cascades", &config.cascades,
+                       "Shadow cascades of the sun (1-4)");
+    console.BindConVar("r_shadow_resolution", &config.resolution,
+                       "Shadow map texels per cascade edge (reallocates the maps)");
+    console.BindConVar("r_shadow_distance", &config.distance,
+                       "View depth the sun's shadows reach, in world units");
+    console.BindConVar("r_shadow_cache_margin", &config.cacheMargin,
+                       "Extra cascade radius drawn so cached shadows survive camera motion (fraction)");
+    console.RegisterCommand("r_shadows", [](const std::vector<std::string>& args) {
+        auto& world = StaticWorldRenderer::Instance();
+        auto& console = GUI::Console::Instance();
+        if (args.size() > 1) {
+            world.SetShadows(args[1] != "0");
+        }
+        console.Print(std::string("r_shadows ") + (world.HasShadows() ? "1" : "0"));
+    }, "Cascaded sun shadows - 0 or 1 (no argument prints the state)");
+    console.RegisterCommand("shadow_status", [](const std::vector<std::string>&) {
+        auto& world = StaticWorldRenderer::Instance();
+        const auto& shadows = world.GetShadows();
+        GUI::Console::Instance().Printf("%u cascades, %u redrawn last frame (%llu total), %u caster draws",
+                                        shadows.GetCascadeCount(), shadows.GetCascadesRendered(),
+                                        static_cast<unsigned long long>(shadows.GetTotalCascadesRendered()),
+                                        world.GetShadowDrawCalls());
+    }, "Shadow cascades and caster cache activity");
+}
+
+void Engine::RegisterLightConVars() {
+    auto& console = GUI::Console::Instance();
+    auto& config = StaticWorldRenderer::Instance().GetLights().GetConfig();
+
+    // Read by ClusteredLighting::Update; a change rebins the grid
+    console.BindConVar("r_lights", &config.enabled, "Point and spot lights of the map");
+    console.BindConVar("r_light_distance", &config.distance,
+                       "View depth of the light clusters' last slice, in world units");
+    console.RegisterCommand("light_status", [](const std::vector<std::string>&) {
+        const ClusterStats& stats = StaticWorldRenderer::Instance().GetLights().GetStats();
+        GUI::Console::Instance().Printf("%u lights, %u in view, %u cluster refs (max %u per cluster)%s",
+                                        stats.lights, stats.visibleLights, stats.indices, stats.maxPerCluster,
+                                        stats.rebuilt ? ", rebinned this frame" : "");
+    }, "Local lights and their clusters");
+}
+
+void Engine::RegisterOverdrawConVars() {
+    auto& console = GUI::Console::Instance();
+
+    console.RegisterCommand("r_depth_prepass", [](const std::vector<std::string>& args) {
+        auto& world = StaticWorldRenderer::Instance();
+        auto& console = GUI::Console::Instance();
+        if (args.size() > 1) {
+            world.SetDepthPrepass(args[1] != "0");
+        }
+        console.Print(std::string("r_depth_prepass ") + (world.IsDepthPrepass() ? "1" : "0"));
+    }, "Depth-only pass of the opaque world before shading - 0 or 1 (no argument prints the state)");
+    console.RegisterCommand("r_front_to_back", [](const std::vector<std::string>& args) {
+        auto& world = StaticWorldRenderer::Instance();
+        auto& console = GUI::Console::Instance();
+        if (args.size() > 1) {
+            world.SetFrontToBack(args[1] != "0");
+        }
+        console.Print(std::string("r_front_to_back ") + (world.IsFrontToBack() ? "1" : "0"));
+    }, "Draw opaque unmerged objects nearest first - 0 or 1 (no argument prints the state)");
+    console.RegisterCommand("r_overdraw", [](const std::vector<std::string>& args) {
+        auto& world = StaticWorldRenderer::Instance();
+        auto& console = GUI::Console::Instance();
+        if (args.size() > 1) {
+            world.SetOverdrawMeasure(args[1] != "0");
+        }
+        if (world.IsOverdrawMeasure()) {
+            console.Printf("r_overdraw 1 (%.2fx, %u prepass draws)", world.GetOverdraw(), world.GetPrepassDrawCalls());
+        } else {
+            console.Print("r_overdraw 0");
+        }
+    }, "Measure the world color pass's overdraw - 0 or 1 (shown in the debug overlay)");
+}
+
+void Engine::RegisterDynamicResolutionConVars() {
+    auto& console = GUI::Console::Instance();
+    auto& config = DynamicResolution::Instance().GetConfig();
+
+    // Read by DynamicResolution::BeginScene every frame
+    console.BindConVar("r_dynres", &config.enabled,
+                       "Render the 3D scene at a scale that follows the GPU frame time");
+    console.BindConVar("r_dynres_target", &config.targetMs,
+                       "GPU milliseconds per frame dynamic resolution aims for");
+    console.BindConVar("r_dynres_min", &config.minScale, "Lowest render scale (0.25-1)");
+    console.BindConVar("r_dynres_max", &config.maxScale, "Highest render scale (reallocates the target)");
+    console.BindConVar("r_dynres_sharpen", &config.sharpness, "Upscale sharpening, 0 = bilinear (0-1)");
+    console.RegisterCommand("dynres_status", [](const std::vector<std::string>&) {
+        auto& dynamicResolution = DynamicResolution::Instance();
+        auto& console = GUI::Console::Instance();
+        if (!dynamicResolution.GetConfig().enabled) {
+            console.Print("Dynamic resolution off");
+            return;
+        }
+        console.Printf("Scale %.2f (%dx%d), GPU %.2f ms of %.2f ms target", dynamicResolution.GetScale(),
+                       dynamicResolution.GetRenderWidth(), dynamicResolution.GetRenderHeight(),
+                       dynamicResolution.GetGpuMilliseconds(), dynamicResolution.GetConfig().targetMs);
+    }, "Dynamic resolution scale and measured GPU time");
+}
+
+void Engine::RegisterMemoryCommands() {
+    auto& console = GUI::Console::Instance();
+
+    console.RegisterCommand("mem_report", [](const std::vector<std::string>&) {
+        auto& tracker = MemoryTracker::Instance();
+        auto& console = GUI::Console::Instance();
+        auto megabytes = [](int64_t bytes) { return static_cast<double>(bytes) / (1024.0 * 1024.0); };
+        auto print = [&](const char* name, const MemoryTagStats& stats) {
+            char budget[32] = "-";
+            if (stats.budget > 0) {
+                std::snprintf(budget, sizeof(budget), "%.1f MB", megabytes(stats.budget));
+            }
+            console.Printf("%-10s heap %8.2f MB (peak %8.2f)  gpu %8.2f MB (peak %8.2f)  %8llu allocs  budget %s%s",
+                           name, megabytes(stats.heapBytes), megabytes(stats.heapPeak),
+                           megabytes(stats.gpuBytes), megabytes(stats.gpuPeak),
+                           static_cast<unsigned long long>(stats.allocations), budget,
+                           stats.IsOverBudget() ? "  OVER" : "");
+        };
+        for (size_t i = 0; i < static_cast<size_t>(MemoryTag::Count); i++) {
+            MemoryTag tag = static_cast<MemoryTag>(i);
+            print(MemoryTracker::GetTagName(tag), tracker.GetStats(tag));
+        }
+        print("Total", tracker.GetTotalStats());
+    }, "Live and peak heap/GPU bytes per subsystem");
+    console.RegisterCommand("mem_budget", [](const std::vector<std::string>& args) {
+        auto& tracker = MemoryTracker::Instance();
+        auto& console = GUI::Console::Instance();
+        MemoryTag tag;
+        if (args.size() < 2 || !MemoryTracker::FindTag(args[1].c_str(), tag)) {
+            console.PrintError("Usage: mem_budget <tag> [MB] (tags: General, Meshes, Textures, Materials, "
+                               "World, Map, Console)");
+            return;
+        }
+        if (args.size() > 2) {
+            double megabytes = std::atof(args[2].c_str());
+            tracker.SetBudget(tag, static_cast<int64_t>(megabytes * 1024.0 * 1024.0));
+        }
+        MemoryTagStats stats = tracker.GetStats(tag);
+        if (stats.budget > 0) {
+            console.Printf("%s budget %.1f MB, using %.1f MB", MemoryTracker::GetTagName(tag),
+                           stats.budget / (1024.0 * 1024.0), stats.GetTotal() / (1024.0 * 1024.0));
+        } else {
+            console.Printf("%s has no budget", MemoryTracker::GetTagName(tag));
+        }
+    }, "Heap + GPU budget of a subsystem in MB, 0 = none (no MB prints it)");
+    console.RegisterCommand("mem_release_mesh_data", [](const std::vector<std::string>& args) {
+        if (args.size() > 1) {
+            Mesh::SetReleaseCPUData(args[1] != "0");
+        }
+        GUI::Console::Instance().Print(std::string("mem_release_mesh_data ") +
+                                       (Mesh::IsReleasingCPUData() ? "1" : "0"));
+    }, "Free mesh CPU copies after upload, for meshes uploaded from now on - 0 or 1");
+}
+
+void Engine::UpdateFramePacing() {
+    auto& console = GUI::Console::Instance();
+
+    // Menus get the lower of the two limits
+    double target = m_config.maxFPS;
+    bool inMenu = console.IsOpen() || !glfwGetWindowAttrib(m_window, GLFW_FOCUSED) ||
+                  glfwGetWindowAttrib(m_window, GLFW_ICONIFIED);
+    if (inMenu && m_config.menuMaxFPS > 0.0 && (target <= 0.0 || m_config.menuMaxFPS < target)) {
+        target = m_config.menuMaxFPS;
+    }
+
+    m_framePacer.SetTargetFPS(target);
+    m_framePacer.SetLowLatency(m_config.lowLatency && !inMenu);
+}
+
 bool Engine::InitializeGUI() {
     LOG_INFO("Engine", "Initializing GUI system...");
 
@@ -269,7 +829,8 @@ bool Engine::InitializeGUI() {
     // Hook up logger to console - forward log messages to in-game console
     Logger::Instance().SetConsoleCallback([](LogLevel level, const std::string& category, const std::string& message) {
         auto& console = GUI::Console::Instance();
-        std::string formattedMsg = "[" + category + "] " + message;
+        static std::string formattedMsg;    // Reused: log spam shouldn't allocate per line
+        formattedMsg.assign("[").append(category).append("] ").append(message);
 
         switch (level) {
             case LogLevel::Warning:
@@ -285,6 +846,17 @@ bool Engine::InitializeGUI() {
         }
     });
 
+    RegisterMapCommands();
+    RegisterCameraCommands();
+    RegisterFramePacingConVars();
+    RegisterTextureConVars();
+    RegisterShadowConVars();
+    RegisterLightConVars();
+    RegisterOverdrawConVars();
+    RegisterDynamicResolutionConVars();
+    RegisterMemoryCommands();
+    RegisterRollbackCommands();
+
     // Set up key callbacks for console
     glfwSetKeyCallback(m_window, KeyCallback);
     glfwSetCharCallback(m_window, CharCallback);
@@ -296,6 +868,8 @@ bool Engine::InitializeGUI() {
 }
 
 void Engine::RenderGUI() {
+    GENESIS_PROFILE_SCOPE("GUI");
+    GENESIS_GPU_SCOPE("GUI");
     int width, height;
     glfwGetFramebufferSize(m_window, &width, &height);
     m_screenWidth = width;
@@ -331,28 +905,252 @@ void Engine::ProcessInput() {
     // via the game's Player class. The engine no longer directly moves the camera.
 }
 
+void Engine::LatchLateInput(bool consolePaused) {
+    auto& input = InputManager::Instance();
+    if (!m_config.lateMouseLatch || !m_onLateInput || consolePaused || !input.IsCursorLocked()) return;
+
+    GENESIS_PROFILE_SCOPE("Late Input");
+    double dx, dy;
+    if (input.LatchMouseDelta(dx, dy)) {
+        // Even with no new motion: the pipelined camera was just set from
+        // older snapshots
+        m_onLateInput(dx, dy);
+    }
+}
+
 void Engine::Update(double deltaTime) {
+    GENESIS_PROFILE_SCOPE("Update");
     // Note: Player movement and camera control are now handled by the PlayerController
     // via the game's Player class. The engine's Update only calls the user callback.
 
+    bool saveState = m_onSaveState && m_rollback.GetCapacity() > 0;
+    Time::TimePoint start;
+    if (saveState) {
+        // Re-simulating: put back the input this tick ran with first
+        if (m_resimulating && m_onLoadInput && m_rollback.Has(m_tick)) {
+            m_onLoadInput(m_rollback.Read(m_tick));
+        }
+        m_onSaveState(m_rollback.Write(m_tick));
+        start = Time::Clock::now();
+    }
+
     // Call user update callback
     if (m_onUpdate) {
         m_onUpdate(deltaTime);
     }
+
+    if (saveState) {
+        double ms = std::chrono::duration<double, std::milli>(Time::Clock::now() - start).count();
+        m_tickCostMs = m_tickCostMs > 0.0 ? m_tickCostMs * 0.95 + ms * 0.05 : ms;
+    }
+    m_tick++;
+}
+
+// ============================================================================
+// Rollback
+// ============================================================================
+
+void Engine::SetRollbackCallbacks(size_t stateSize, SaveStateCallback save,
+                                  LoadStateCallback load, LoadStateCallback loadInput) {
+    m_rollbackStateSize = stateSize;
+    m_onSaveState = save;
+    m_onLoadState = load;
+    m_onLoadInput = loadInput;
+    if (m_initialized) {
+        InitializeRollback();
+    }
+}
+
+void Engine::InitializeRollback() {
+    if (m_config.rollbackTicks <= 0 || m_rollbackStateSize == 0) {
+        m_rollback.Initialize(0, 0);
+        m_liveState.clear();
+        return;
+    }
+    m_rollback.Initialize(static_cast<uint32_t>(m_config.rollbackTicks), m_rollbackStateSize);
+    m_liveState.assign(m_rollbackStateSize, 0);
+}
+
+bool Engine::Rollback(uint64_t tick) {
+    if (m_resimulating || !m_onLoadState || tick >= m_tick || !m_rollback.Has(tick)) {
+        return false;
+    }
+
+    uint64_t present = m_tick;
+    double estimateMs = static_cast<double>(present - tick) * m_tickCostMs;
+    if (estimateMs > m_config.rollbackBudgetMs) {
+        LOG_WARNING("Engine", "Rollback of " + std::to_string(present - tick) + " ticks (~" +
+                    std::to_string(estimateMs) + " ms) exceeds the budget");
+        return false;
+    }
+
+    GENESIS_PROFILE_SCOPE("Rollback");
+    // The replay leaves the last replayed tick's input behind; keep the
+    // live one (set by OnInput this frame) to put back afterwards
+    bool restoreLiveInput = m_onSaveState && m_onLoadInput && !m_liveState.empty();
+    if (restoreLiveInput) {
+        m_onSaveState(m_liveState.data());
+    }
+
+    m_onLoadState(m_rollback.Read(tick));
+    m_tick = tick;
+    m_resimulating = true;
+    while (m_tick < present) {
+        Update(m_config.fixedTimestep);
+    }
+    m_resimulating = false;
+
+    if (restoreLiveInput) {
+        m_onLoadInput(m_liveState.data());
+    }
+    return true;
+}
+
+void Engine::RegisterRollbackCommands() {
+    auto& console = GUI::Console::Instance();
+
+    // rollback_test <ticks> - Rewind and re-run the last ticks, report cost
+    console.RegisterCommand("rollback_test", [this](const std::vector<std::string>& args) {
+        auto& console = GUI::Console::Instance();
+        if (args.size() < 2) {
+            console.PrintWarning("Usage: rollback_test <ticks>");
+            return;
+        }
+
+        uint64_t ticks = static_cast<uint64_t>(std::max(1, std::atoi(args[1].c_str())));
+        if (m_rollback.GetCapacity() == 0 || ticks > m_rollback.GetCapacity() || ticks > m_tick) {
+            console.PrintWarning("Rollback history holds " + std::to_string(m_config.rollbackTicks) + " ticks");
+            return;
+        }
+
+        auto start = Time::Clock::now();
+        if (!Rollback(m_tick - ticks)) {
+            console.PrintWarning("Rollback refused (over rollbackBudgetMs)");
+            return;
+        }
+        double ms = std::chrono::duration<double, std::milli>(Time::Clock::now() - start).count();
+        console.Print("Re-simulated " + std::to_string(ticks) + " ticks in " + std::to_string(ms) +
+                      " ms (" + std::to_string(ms > 0.0 ? ticks / ms : 0.0) + " ticks/ms)");
+    }, "Rewind and re-simulate the last N fixed ticks");
+}
+
+// ============================================================================
+// Pipelined Simulation
+// ============================================================================
+
+void Engine::SeedFrameStates() {
+    if (!m_onSnapshot) return;
+
+    // Both rendered snapshots start at the current state
+    m_onSnapshot(m_frameStates[m_renderCurrent]);
+    m_frameStates[m_renderCurrent].tick = m_tick;
+    m_frameStates[m_renderPrevious] = m_frameStates[m_renderCurrent];
+    m_renderInterpolation = 0.0;
+}
+
+void Engine::Simulate(int ticks) {
+    GENESIS_PROFILE_SCOPE("Simulate");
+    for (int i = 0; i < ticks; i++) {
+        Update(m_config.fixedTimestep);
+
+        // Only the last two ticks can end up on screen
+        if (i >= ticks - 2) {
+            FrameState& state = m_frameStates[m_simSlots[i % 2]];
+            m_onSnapshot(state);
+            state.tick = m_tick;
+        }
+    }
+}
+
+void Engine::PublishFrameStates(int ticks, double interpolation) {
+    m_renderInterpolation = interpolation;
+    if (ticks == 0) return;
+
+    uint32_t last = m_simSlots[(ticks - 1) % 2];
+    uint32_t oldPrevious = m_renderPrevious;
+    uint32_t oldCurrent = m_renderCurrent;
+
+    if (ticks == 1) {
+        // Continue from what was on screen
+        m_renderPrevious = oldCurrent;
+        m_renderCurrent = last;
+        m_simSlots[0] = oldPrevious;   // Slot 1 was not written
+    } else {
+        m_renderPrevious = m_simSlots[(ticks - 2) % 2];
+        m_renderCurrent = last;
+        m_simSlots[0] = oldPrevious;
+        m_simSlots[1] = oldCurrent;
+    }
+}
+
+void Engine::ApplyRenderState() {
+    const FrameState& from = m_frameStates[m_renderPrevious];
+    const FrameState& to = m_frameStates[m_renderCurrent];
+    float t = static_cast<float>(std::min(m_renderInterpolation, 1.0));
+
+    m_camera.SetPosition(Math::Lerp(from.cameraPosition, to.cameraPosition, t));
+    m_camera.SetYaw(Math::LerpAngle(from.cameraYaw, to.cameraYaw, t));
+    m_camera.SetPitch(Math::Lerp(from.cameraPitch, to.cameraPitch, t));
 }
 
 void Engine::Render(double interpolation) {
+    GENESIS_PROFILE_SCOPE("Render");
+    GENESIS_GPU_FRAME();
+
+    // Back to 3D defaults after last frame's GUI pass. Depth writes must be
+    // on before the clear, or the depth buffer isn't cleared.
+    auto& gl = GLStateCache::Instance();
+    gl.ResetStats();
+    gl.ApplyDefaults();
+
+    // 3D scene offscreen at the dynamic resolution scale, when enabled
+    int width = 0, height = 0;
+    glfwGetFramebufferSize(m_window, &width, &height);
+    auto& dynamicResolution = DynamicResolution::Instance();
+    dynamicResolution.BeginScene(width, height);
+
     // Clear
     glClearColor(0.1f, 0.1f, 0.15f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
+    // Per-frame uniform block (camera + time); renderers add their lighting
+    auto& frameUniforms = FrameUniforms::Instance();
+    frameUniforms.SetCamera(m_camera.GetViewMatrix(), m_camera.GetProjectionMatrix(), m_camera.GetPosition());
+    frameUniforms.SetTime(static_cast<float>(Time::Instance().GetTotalTime()));
+    frameUniforms.Upload();
+
+    if (m_recordingCamera) {
+        float time = static_cast<float>(Time::Instance().GetTotalTime() - m_cameraRecordStart);
+        m_cameraRecording.AddKey(time, m_camera);
+    }
+
     // Call user render callback
     if (m_onRender) {
         m_onRender(interpolation);
     }
 
+    // Upscale to the backbuffer; the GUI stays at native resolution
+    dynamicResolution.EndScene();
+
     // Render GUI overlay (console, debug info, etc.)
     RenderGUI();
+
+#if defined(GENESIS_PROFILER_ENABLED)
+    // Per-frame counters for prof_capture
+    auto& capture = ProfileCapture::Instance();
+    if (capture.IsRecording()) {
+        auto& world = StaticWorldRenderer::Instance();
+        capture.AddCounter("Draw Calls", world.GetDrawCalls());
+        capture.AddCounter("Material Switches", world.GetMaterialSwitches());
+        capture.AddCounter("Objects Culled", world.GetObjectsCulled());
+        capture.AddCounter("Objects Occluded", world.GetObjectsOccluded());
+        capture.AddCounter("Objects PVS Culled", world.GetObjectsPvsCulled());
+        capture.AddCounter("GL State Calls", gl.GetStats().issued);
+        for (const auto& pass : GpuTimers::Instance().GetResults()) {
+            capture.AddGpuPass(pass.name, pass.milliseconds);
+        }
+    }
+#endif
 }
 
 void Engine::FramebufferSizeCallback(GLFWwindow* window, int width, int height) {
@@ -2,12 +2,17 @@
 
 #include "core/Time.h"
 #include "core/Logger.h"
+#include "core/FrameState.h"
+#include "core/FramePacer.h"
+#include "core/RollbackBuffer.h"
 #include "input/InputManager.h"
 #include "renderer/shader/Shader.h"
 #include "camera/Camera.h"
+#include "camera/CameraPath.h"
 
 #include <string>
 #include <functional>
+#include <vector>
 
 struct GLFWwindow;
 
@@ -24,6 +29,60 @@ struct EngineConfig {
     bool fullscreen = true;   // Default to fullscreen
     double fixedTimestep = 1.0 / 66.0;  // 66 Hz physics
     int maxFrameSkip = 5;
+    int workerThreads = -1;   // Job system workers besides the main thread (-1 = one per extra core)
+
+    // Run fixed updates for the next frame on a worker while the main thread
+    // renders the last FrameState snapshots (needs SetOnSnapshot). Adds one
+    // frame of latency; update code must not touch GL, the engine camera or
+    // the FrameArena.
+    bool pipelinedSimulation = false;
+
+    // Frame pacing (ge_fps_max, ge_fps_max_menu, ge_low_latency)
+    double maxFPS = 0.0;      // 0 = unlimited
+    double menuMaxFPS = 60.0; // While the console is open or the window is in the background
+    bool lowLatency = false;  // With vsync: start each frame just before the predicted vblank
+
+    // Poll mouse motion once more right before Render and hand it to the
+    // late input callback (view turns with input newer than the ticks)
+    bool lateMouseLatch = true;
+
+    // Cull and draw merged static geometry on the GPU when the driver
+    // provides OpenGL 4.3 (StaticWorldRenderer::SetGpuDriven)
+    bool gpuDrivenWorld = true;
+
+    // Draw merged static geometry of materials sharing a shader together
+    // (StaticWorldRenderer::SetMaterialBatching): bindless textures where
+    // the driver has ARB_bindless_texture, texture arrays elsewhere
+    bool materialBatching = true;
+
+    // Cascaded shadow maps of the sun for static geometry
+    // (StaticWorldRenderer::SetShadows; r_shadows toggles them at runtime)
+    bool shadows = true;
+
+    // Dynamic resolution (DynamicResolution; r_dynres* at runtime): the 3D
+    // scene renders offscreen at a scale of the window that follows the
+    // GPU frame time toward the target, and is upscaled with sharpening
+    // under the native-resolution GUI
+    bool dynamicResolution = false;
+    double dynamicResolutionTargetMs = 16.0;
+    float dynamicResolutionMinScale = 0.5f;
+    float dynamicResolutionMaxScale = 1.0f;
+    float upscaleSharpness = 0.25f;
+
+    // Free mesh vertex/index copies once uploaded (Mesh::SetReleaseCPUData;
+    // mem_release_mesh_data at runtime). Shared brush shapes, lightmapped
+    // brushes and meshes marked SetKeepCPUData keep theirs
+    bool releaseMeshCPUData = false;
+
+    // Rollback: fixed ticks of game state kept for Engine::Rollback()
+    // (0 = off; needs SetRollbackCallbacks). Rewinds that would take
+    // longer than the budget, at the measured cost per tick, are refused.
+    int rollbackTicks = 0;
+    double rollbackBudgetMs = 4.0;
+
+    // Format and write log messages on a background thread
+    bool asyncLogging = true;
+    std::string logFile;      // Also write the log here (empty = stdout only)
 };
 
 // ============================================================================
@@ -52,14 +111,54 @@ public:
     using UpdateCallback = std::function<void(double deltaTime)>;
     using RenderCallback = std::function<void(double interpolation)>;
     using InitCallback = std::function<bool()>;
+    using PreloadCallback = std::function<void()>;
     using ShutdownCallback = std::function<void()>;
     using InputCallback = std::function<void(double deltaTime)>;
+    using SnapshotCallback = std::function<void(FrameState& state)>;
+    using LateInputCallback = std::function<void(double dx, double dy)>;
 
     void SetOnInit(InitCallback callback) { m_onInit = callback; }
+    // Called before the window exists, to start CPU-only loading on jobs
+    // (e.g. MapRenderer::PreloadMap()) that OnInit then picks up
+    void SetOnPreload(PreloadCallback callback) { m_onPreload = callback; }
     void SetOnShutdown(ShutdownCallback callback) { m_onShutdown = callback; }
     void SetOnUpdate(UpdateCallback callback) { m_onUpdate = callback; }
     void SetOnRender(RenderCallback callback) { m_onRender = callback; }
     void SetOnInput(InputCallback callback) { m_onInput = callback; }  // Called once per frame
+    void SetOnSnapshot(SnapshotCallback callback) { m_onSnapshot = callback; }  // Fill render state after a tick
+
+    // Mouse motion since OnInput, just before Render (cursor locked only).
+    // Runs while a pipelined simulation may be in flight: aim the engine
+    // camera, don't touch simulated state.
+    void SetOnLateInput(LateInputCallback callback) { m_onLateInput = callback; }
+
+    // ========================================================================
+    // Rollback - Re-simulate past fixed ticks (netcode)
+    //
+    // Before every tick the game writes its state (stateSize bytes of POD,
+    // input included) into the history. Rollback(tick) loads that state and
+    // re-runs the ticks up to the present; each replayed tick first gets
+    // its recorded input back through loadInput, then saves over its old
+    // history entry. Afterwards the live input (this frame's, saved before
+    // the rewind) goes back through loadInput too, so the next tick does not
+    // run with the last replayed tick's input. Call between frames, never
+    // from inside an update.
+    // ========================================================================
+
+    using SaveStateCallback = std::function<void(void* state)>;
+    using LoadStateCallback = std::function<void(const void* state)>;
+
+    void SetRollbackCallbacks(size_t stateSize, SaveStateCallback save,
+                              LoadStateCallback load, LoadStateCallback loadInput);
+    bool Rollback(uint64_t tick);
+
+    bool IsResimulating() const { return m_resimulating; }
+    uint64_t GetTick() const { return m_tick; }
+    double GetTickCostMs() const { return m_tickCostMs; }   // Running average
+
+    // Saved state before `tick` (nullptr outside the window); netcode may
+    // patch remote input in here before rolling back
+    void* GetRollbackState(uint64_t tick) { return m_rollback.Has(tick) ? m_rollback.Write(tick) : nullptr; }
 
     // ========================================================================
     // Accessors
@@ -73,8 +172,14 @@ public:
     int GetScreenHeight() const { return m_screenHeight; }
 
     FPSCamera& GetCamera() { return m_camera; }
+    const FramePacer& GetFramePacer() const { return m_framePacer; }
     const FPSCamera& GetCamera() const { return m_camera; }
 
+    // Pipelined mode: the two snapshots being rendered this frame
+    bool IsPipelined() const { return m_config.pipelinedSimulation; }
+    const FrameState& GetRenderState() const { return m_frameStates[m_renderCurrent]; }
+    const FrameState& GetPreviousRenderState() const { return m_frameStates[m_renderPrevious]; }
+
 private:
     Engine() = default;
     ~Engine() = default;
@@ -86,12 +191,32 @@ private:
     bool InitializeInput();
     bool InitializeShaders();
     bool InitializeGUI();
+    void ProcessFileChanges();
+    void RegisterMapCommands();
+    void RegisterCameraCommands();
+    void RegisterFramePacingConVars();
+    void RegisterTextureConVars();
+    void RegisterShadowConVars();
+    void RegisterLightConVars();
+    void RegisterOverdrawConVars();
+    void RegisterDynamicResolutionConVars();
+    void RegisterMemoryCommands();
+    void RegisterRollbackCommands();
+    void InitializeRollback();
+    void UpdateFramePacing();
 
     void ProcessInput();
+    void LatchLateInput(bool consolePaused);
     void Update(double deltaTime);
     void Render(double interpolation);
     void RenderGUI();
 
+    // Pipelined simulation
+    void SeedFrameStates();
+    void Simulate(int ticks);
+    void PublishFrameStates(int ticks, double interpolation);
+    void ApplyRenderState();
+
     static void FramebufferSizeCallback(GLFWwindow* window, int width, int height);
     static void KeyCallback(GLFWwindow* window, int key, int scancode, int action, int mods);
     static void CharCallback(GLFWwindow* window, unsigned int codepoint);
@@ -109,16 +234,45 @@ private:
 
     // Core systems
     FPSCamera m_camera;
+    FramePacer m_framePacer;
 
     // Callbacks
     InitCallback m_onInit;
+    PreloadCallback m_onPreload;
     ShutdownCallback m_onShutdown;
     UpdateCallback m_onUpdate;
     RenderCallback m_onRender;
     InputCallback m_onInput;
+    SnapshotCallback m_onSnapshot;
+    LateInputCallback m_onLateInput;
 
     // Fixed timestep accumulator
     double m_accumulator = 0.0;
+    uint64_t m_tick = 0;
+
+    // Rollback history
+    RollbackBuffer m_rollback;
+    size_t m_rollbackStateSize = 0;
+    SaveStateCallback m_onSaveState;
+    LoadStateCallback m_onLoadState;
+    LoadStateCallback m_onLoadInput;
+    std::vector<uint8_t> m_liveState;   // State at the rewind, for its live input
+    bool m_resimulating = false;
+    double m_tickCostMs = 0.0;
+
+    // Pipelined mode: render reads [previous, current], simulation writes
+    // the other two, alternating per tick
+    FrameState m_frameStates[4];
+    uint32_t m_renderPrevious = 0;
+    uint32_t m_renderCurrent = 1;
+    uint32_t m_simSlots[2] = {2, 3};
+    double m_renderInterpolation = 0.0;   // Accumulator fraction at capture
+
+    // camera_record: one key per rendered frame until stopped
+    bool m_recordingCamera = false;
+    double m_cameraRecordStart = 0.0;
+    CameraPath m_cameraRecording;
+    std::string m_cameraRecordFile;
 };
 
 } // namespace Genesis
@@ -0,0 +1,365 @@
+#include "FileWatcher.h"
+#include "Logger.h"
+#include <filesystem>
+
+#if defined(_WIN32)
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <windows.h>
+#elif defined(__linux__)
+    #include <sys/inotify.h>
+    #include <poll.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+namespace Genesis {
+
+FileWatcher::~FileWatcher() {
+    Stop();
+}
+
+std::string FileWatcher::NormalizePath(const std::string& path) {
+    std::error_code ec;
+    std::filesystem::path absolute = std::filesystem::absolute(path, ec);
+    if (ec) absolute = path;
+
+    std::string normalized = absolute.lexically_normal().generic_string();
+    if (normalized.size() > 1 && normalized.back() == '/') {
+        normalized.pop_back();
+    }
+    return normalized;
+}
+
+bool FileWatcher::WatchDirectory(const std::string& directory, bool recursive) {
+    if (!IsRunning()) return false;
+
+    std::error_code ec;
+    if (!std::filesystem::is_directory(directory, ec)) {
+        LOG_WARNING("FileWatcher", "Not a directory: " + directory);
+        return false;
+    }
+    return AddWatch(NormalizePath(directory), recursive);
+}
+
+bool FileWatcher::Poll(std::vector<std::string>& out) {
+    if (!m_hasChanges.load(std::memory_order_acquire)) return false;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    out.insert(out.end(), m_changed.begin(), m_changed.end());
+    m_changed.clear();
+    m_hasChanges.store(false, std::memory_order_release);
+    return !out.empty();
+}
+
+void FileWatcher::QueueChange(const std::string& path) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_changed.insert(NormalizePath(path));
+    m_hasChanges.store(true, std::memory_order_release);
+}
+
+#if defined(__linux__)
+
+// ============================================================================
+// inotify backend
+// ============================================================================
+
+namespace {
+    constexpr uint32_t WATCH_MASK = IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE;
+}
+
+bool FileWatcher::Start() {
+    if (IsRunning()) return true;
+
+    m_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (m_fd < 0) {
+        LOG_WARNING("FileWatcher", "inotify unavailable, hot reload falls back to polling");
+        return false;
+    }
+    if (pipe2(m_wakePipe, O_CLOEXEC) != 0) {
+        close(m_fd);
+        m_fd = -1;
+        return false;
+    }
+
+    m_running.store(true, std::memory_order_release);
+    m_thread = std::thread(&FileWatcher::WatcherMain, this);
+    return true;
+}
+
+void FileWatcher::Stop() {
+    if (!IsRunning()) return;
+
+    m_running.store(false, std::memory_order_release);
+    char wake = 1;
+    (void)!write(m_wakePipe[1], &wake, 1);
+    m_thread.join();
+
+    // Closing the instance drops every watch
+    close(m_fd);
+    close(m_wakePipe[0]);
+    close(m_wakePipe[1]);
+    m_fd = -1;
+    m_wakePipe[0] = m_wakePipe[1] = -1;
+
+    std::lock_guard<std::mutex> lock(m_watchMutex);
+    m_watches.clear();
+}
+
+bool FileWatcher::AddWatch(const std::string& directory, bool recursive) {
+    int wd = inotify_add_watch(m_fd, directory.c_str(), WATCH_MASK);
+    if (wd < 0) {
+        LOG_WARNING("FileWatcher", "Failed to watch " + directory);
+        return false;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_watchMutex);
+        Watch& watch = m_watches[wd];
+        watch.directory = directory;
+        watch.recursive = recursive;
+    }
+
+    // inotify watches are per directory
+    if (recursive) {
+        std::error_code ec;
+        for (std::filesystem::directory_iterator it(directory, ec), end; !ec && it != end; it.increment(ec)) {
+            if (it->is_directory(ec)) {
+                AddWatch(NormalizePath(it->path().string()), true);
+            }
+        }
+    }
+    return true;
+}
+
+void FileWatcher::WatcherMain() {
+    alignas(inotify_event) char buffer[4096];
+
+    while (IsRunning()) {
+        pollfd fds[2] = {
+            { m_fd, POLLIN, 0 },
+            { m_wakePipe[0], POLLIN, 0 }
+        };
+        if (poll(fds, 2, -1) < 0) continue;   // EINTR
+        if (fds[1].revents & POLLIN) break;
+
+        for (;;) {
+            ssize_t length = read(m_fd, buffer, sizeof(buffer));
+            if (length <= 0) break;
+
+            for (char* ptr = buffer; ptr < buffer + length; ) {
+                const inotify_event* event = reinterpret_cast<const inotify_event*>(ptr);
+                ptr += sizeof(inotify_event) + event->len;
+
+                std::string directory;
+                bool recursive = false;
+                {
+                    std::lock_guard<std::mutex> lock(m_watchMutex);
+                    auto it = m_watches.find(event->wd);
+                    if (it == m_watches.end()) continue;
+                    if (event->mask & IN_IGNORED) {
+                        m_watches.erase(it);
+                        continue;
+                    }
+                    directory = it->second.directory;
+                    recursive = it->second.recursive;
+                }
+                if (event->len == 0) continue;
+
+                std::string path = directory + "/" + event->name;
+                if (event->mask & IN_ISDIR) {
+                    if (recursive && (event->mask & (IN_CREATE | IN_MOVED_TO))) {
+                        AddWatch(path, true);
+                    }
+                } else if (event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO)) {
+                    // IN_CREATE alone is skipped: the write that follows
+                    // reports IN_CLOSE_WRITE once the file is complete
+                    QueueChange(path);
+                }
+            }
+        }
+    }
+}
+
+#elif defined(_WIN32)
+
+// ============================================================================
+// ReadDirectoryChangesW backend
+// ============================================================================
+
+namespace {
+    constexpr DWORD NOTIFY_FILTER = FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME;
+    constexpr size_t NOTIFY_BUFFER_SIZE = 16 * 1024;
+
+    bool IssueRead(HANDLE directory, OVERLAPPED* overlapped, std::vector<unsigned char>& buffer, bool recursive) {
+        return ReadDirectoryChangesW(directory, buffer.data(), static_cast<DWORD>(buffer.size()),
+                                     recursive ? TRUE : FALSE, NOTIFY_FILTER, nullptr, overlapped, nullptr) != 0;
+    }
+
+    std::wstring Widen(const std::string& text) {
+        int size = MultiByteToWideChar(CP_UTF8, 0, text.data(), static_cast<int>(text.size()), nullptr, 0);
+        std::wstring result(static_cast<size_t>(size), L'\0');
+        MultiByteToWideChar(CP_UTF8, 0, text.data(), static_cast<int>(text.size()), result.data(), size);
+        return result;
+    }
+
+    std::string Narrow(const wchar_t* text, int length) {
+        int size = WideCharToMultiByte(CP_UTF8, 0, text, length, nullptr, 0, nullptr, nullptr);
+        std::string result(static_cast<size_t>(size), '\0');
+        WideCharToMultiByte(CP_UTF8, 0, text, length, result.data(), size, nullptr, nullptr);
+        return result;
+    }
+}
+
+bool FileWatcher::Start() {
+    if (IsRunning()) return true;
+
+    m_stopEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+    m_rescanEvent = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+    if (!m_stopEvent || !m_rescanEvent) {
+        if (m_stopEvent) CloseHandle(m_stopEvent);
+        if (m_rescanEvent) CloseHandle(m_rescanEvent);
+        m_stopEvent = m_rescanEvent = nullptr;
+        return false;
+    }
+
+    m_running.store(true, std::memory_order_release);
+    m_thread = std::thread(&FileWatcher::WatcherMain, this);
+    return true;
+}
+
+void FileWatcher::Stop() {
+    if (!IsRunning()) return;
+
+    m_running.store(false, std::memory_order_release);
+    SetEvent(m_stopEvent);
+    m_thread.join();
+
+    std::lock_guard<std::mutex> lock(m_watchMutex);
+    for (auto& [id, watch] : m_watches) {
+        CancelIoEx(watch.handle, static_cast<OVERLAPPED*>(watch.overlapped));
+        CloseHandle(watch.handle);
+        CloseHandle(watch.event);
+        delete static_cast<OVERLAPPED*>(watch.overlapped);
+    }
+    m_watches.clear();
+
+    CloseHandle(m_stopEvent);
+    CloseHandle(m_rescanEvent);
+    m_stopEvent = m_rescanEvent = nullptr;
+}
+
+bool FileWatcher::AddWatch(const std::string& directory, bool recursive) {
+    std::wstring widePath = Widen(directory);
+    HANDLE handle = CreateFileW(widePath.c_str(), FILE_LIST_DIRECTORY,
+                                FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+                                OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+    if (handle == INVALID_HANDLE_VALUE) {
+        LOG_WARNING("FileWatcher", "Failed to watch " + directory);
+        return false;
+    }
+
+    Watch watch;
+    watch.directory = directory;
+    watch.recursive = recursive;   // One watch covers the whole subtree
+    watch.handle = handle;
+    watch.event = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+    watch.buffer.resize(NOTIFY_BUFFER_SIZE);
+
+    OVERLAPPED* overlapped = new OVERLAPPED{};
+    overlapped->hEvent = watch.event;
+    watch.overlapped = overlapped;
+
+    if (!watch.event || !IssueRead(handle, overlapped, watch.buffer, recursive)) {
+        LOG_WARNING("FileWatcher", "Failed to watch " + directory);
+        if (watch.event) CloseHandle(watch.event);
+        CloseHandle(handle);
+        delete overlapped;
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_watchMutex);
+        int id = static_cast<int>(m_watches.size());
+        while (m_watches.count(id)) id++;
+        m_watches.emplace(id, std::move(watch));
+    }
+    SetEvent(m_rescanEvent);
+    return true;
+}
+
+void FileWatcher::WatcherMain() {
+    std::vector<HANDLE> handles;
+    std::vector<int> ids;
+
+    while (IsRunning()) {
+        // [stop, rescan, one event per watch]
+        handles.assign({ m_stopEvent, m_rescanEvent });
+        ids.clear();
+        {
+            std::lock_guard<std::mutex> lock(m_watchMutex);
+            for (const auto& [id, watch] : m_watches) {
+                if (handles.size() == MAXIMUM_WAIT_OBJECTS) break;
+                handles.push_back(watch.event);
+                ids.push_back(id);
+            }
+        }
+
+        DWORD result = WaitForMultipleObjects(static_cast<DWORD>(handles.size()), handles.data(), FALSE, INFINITE);
+        if (result == WAIT_OBJECT_0) break;
+        if (result == WAIT_OBJECT_0 + 1 || result == WAIT_FAILED) continue;
+
+        size_t index = result - WAIT_OBJECT_0 - 2;
+        if (index >= ids.size()) continue;
+
+        std::lock_guard<std::mutex> lock(m_watchMutex);
+        auto it = m_watches.find(ids[index]);
+        if (it == m_watches.end()) continue;
+        Watch& watch = it->second;
+        OVERLAPPED* overlapped = static_cast<OVERLAPPED*>(watch.overlapped);
+
+        DWORD bytes = 0;
+        if (GetOverlappedResult(watch.handle, overlapped, &bytes, FALSE) && bytes > 0) {
+            // Zero bytes means the buffer overflowed and the changes are lost
+            const unsigned char* ptr = watch.buffer.data();
+            for (;;) {
+                const FILE_NOTIFY_INFORMATION* info = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(ptr);
+                if (info->Action == FILE_ACTION_ADDED || info->Action == FILE_ACTION_MODIFIED ||
+                    info->Action == FILE_ACTION_RENAMED_NEW_NAME) {
+                    std::string name = Narrow(info->FileName, static_cast<int>(info->FileNameLength / sizeof(WCHAR)));
+                    QueueChange(watch.directory + "/" + name);
+                }
+                if (info->NextEntryOffset == 0) break;
+                ptr += info->NextEntryOffset;
+            }
+        }
+
+        ResetEvent(watch.event);
+        IssueRead(watch.handle, overlapped, watch.buffer, watch.recursive);
+    }
+}
+
+#else
+
+// ============================================================================
+// No backend: callers keep polling
+// ============================================================================
+
+bool FileWatcher::Start() {
+    return false;
+}
+
+void FileWatcher::Stop() {}
+
+bool FileWatcher::AddWatch(const std::string&, bool) {
+    return false;
+}
+
+void FileWatcher::WatcherMain() {}
+
+#endif
+
+} // namespace Genesis
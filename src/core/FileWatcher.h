@@ -0,0 +1,93 @@
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace Genesis {
+
+// ============================================================================
+// FileWatcher - OS change notifications for asset hot reload
+//
+// A background thread blocks on inotify (Linux) or ReadDirectoryChangesW
+// (Windows) and queues the paths of files that were written, created or
+// renamed into a watched directory. The main thread drains the queue once
+// per frame with Poll(), so nothing is stat'ed while nothing changes.
+//
+// Paths are reported absolute and lexically normalized (see NormalizePath),
+// with each path at most once per Poll() however many events a save caused.
+//
+// On other platforms Start() fails and callers fall back to polling
+// modification times.
+// ============================================================================
+class FileWatcher {
+public:
+    static FileWatcher& Instance() {
+        static FileWatcher instance;
+        return instance;
+    }
+
+    bool Start();
+    void Stop();
+    bool IsRunning() const { return m_running.load(std::memory_order_acquire); }
+
+    // Watch a directory and (if recursive) every directory below it,
+    // including ones created later. Call after Start().
+    bool WatchDirectory(const std::string& directory, bool recursive = true);
+
+    // Move the changed paths queued since the last call into 'out';
+    // false if nothing changed
+    bool Poll(std::vector<std::string>& out);
+
+    // Form used for reported paths, for comparing against asset paths
+    static std::string NormalizePath(const std::string& path);
+
+private:
+    FileWatcher() = default;
+    ~FileWatcher();
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    bool AddWatch(const std::string& directory, bool recursive);
+    void WatcherMain();
+    void QueueChange(const std::string& path);
+
+    struct Watch {
+        std::string directory;   // Normalized, no trailing slash
+        bool recursive = false;
+#ifdef _WIN32
+        void* handle = nullptr;  // Directory handle
+        void* event = nullptr;   // Overlapped completion event
+        void* overlapped = nullptr;
+        std::vector<unsigned char> buffer;
+#endif
+    };
+
+private:
+    std::atomic<bool> m_running{false};
+    std::thread m_thread;
+
+    // Changed paths waiting for Poll()
+    std::mutex m_mutex;
+    std::unordered_set<std::string> m_changed;
+    std::atomic<bool> m_hasChanges{false};
+
+    // Watches, keyed by inotify descriptor / registration index. Guarded by
+    // m_watchMutex; the watcher thread adds watches for new subdirectories.
+    std::mutex m_watchMutex;
+    std::unordered_map<int, Watch> m_watches;
+
+#ifdef _WIN32
+    void* m_stopEvent = nullptr;
+    void* m_rescanEvent = nullptr;  // A watch was added from another thread
+#else
+    int m_fd = -1;                  // inotify instance
+    int m_wakePipe[2] = {-1, -1};   // Written by Stop() to end the poll()
+#endif
+};
+
+} // namespace Genesis
@@ -0,0 +1,59 @@
+#include "FrameArena.h"
+#include <algorithm>
+
+namespace Genesis {
+
+FrameArena::FrameArena(size_t blockSize) : m_blockSize(blockSize) {
+    m_blocks.push_back(Block{std::make_unique<uint8_t[]>(m_blockSize), m_blockSize});
+    UseBlock(0);
+}
+
+void FrameArena::UseBlock(size_t index) {
+    m_blockIndex = index;
+    m_current = m_blocks[index].data.get();
+    m_remaining = m_blocks[index].size;
+    m_last = nullptr;
+}
+
+void* FrameArena::AllocateSlow(size_t size, size_t alignment) {
+    // Move on to the next block that fits, appending one if needed. The
+    // rest of the current block is wasted until Reset().
+    size_t needed = size + alignment;
+    size_t next = m_blockIndex + 1;
+    while (next < m_blocks.size() && m_blocks[next].size < needed) {
+        next++;
+    }
+    if (next >= m_blocks.size()) {
+        size_t blockSize = std::max(needed, m_blocks.back().size * 2);
+        m_blocks.push_back(Block{std::make_unique<uint8_t[]>(blockSize), blockSize});
+        next = m_blocks.size() - 1;
+    }
+
+    m_used += m_remaining;  // Count the abandoned tail so Reset() sizes up
+    UseBlock(next);
+    return Allocate(size, alignment);
+}
+
+void FrameArena::Reset() {
+    m_peak = std::max(m_peak, m_used);
+
+    // The frame spilled into extra blocks: fold them into one that fits
+    if (m_blockIndex > 0) {
+        size_t blockSize = std::max(m_blockSize, m_used);
+        m_blocks.clear();
+        m_blocks.push_back(Block{std::make_unique<uint8_t[]>(blockSize), blockSize});
+    }
+
+    m_used = 0;
+    UseBlock(0);
+}
+
+size_t FrameArena::GetCapacity() const {
+    size_t total = 0;
+    for (const auto& block : m_blocks) {
+        total += block.size;
+    }
+    return total;
+}
+
+} // namespace Genesis
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace Genesis {
+
+// ============================================================================
+// FrameArena - Linear allocator for data that lives until the next frame
+//
+// Allocation is a pointer bump; nothing is freed individually. Engine::Run
+// calls Reset() at the start of every frame, which makes all previous
+// allocations invalid. If a frame overflowed the current block, the next
+// Reset() replaces the blocks with one block big enough for that frame, so
+// steady state is a single block and no malloc at all.
+//
+// Only trivially destructible types can be allocated (no destructors run).
+// Main thread only.
+//
+// Usage:
+//   auto& arena = FrameArena::Instance();
+//   auto hits = world.QueryAABB(box, arena);     // std::span, valid this frame
+//   float* scratch = arena.AllocateArray<float>(count);
+// ============================================================================
+class FrameArena {
+public:
+    static FrameArena& Instance() {
+        static FrameArena instance;
+        return instance;
+    }
+
+    static constexpr size_t DEFAULT_BLOCK_SIZE = 256 * 1024;
+
+    explicit FrameArena(size_t blockSize = DEFAULT_BLOCK_SIZE);
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    // Raw storage; never returns nullptr for size > 0
+    void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t)) {
+        uintptr_t base = reinterpret_cast<uintptr_t>(m_current);
+        uintptr_t aligned = (base + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1);
+        size_t padding = static_cast<size_t>(aligned - base);
+
+        if (padding + size > m_remaining) {
+            return AllocateSlow(size, alignment);
+        }
+
+        m_last = reinterpret_cast<uint8_t*>(aligned);
+        m_current = m_last + size;
+        m_remaining -= padding + size;
+        m_used += padding + size;
+        return m_last;
+    }
+
+    // Uninitialized array of count T
+    template<typename T>
+    T* AllocateArray(size_t count) {
+        static_assert(std::is_trivially_destructible_v<T>, "FrameArena never runs destructors");
+        return static_cast<T*>(Allocate(sizeof(T) * count, alignof(T)));
+    }
+
+    // Give back the unused tail of the most recent allocation (e.g. after
+    // filling an upper-bound sized result). No-op for older allocations.
+    template<typename T>
+    std::span<T> Shrink(T* data, size_t count) {
+        uint8_t* end = reinterpret_cast<uint8_t*>(data + count);
+        if (reinterpret_cast<uint8_t*>(data) == m_last && end <= m_current) {
+            size_t freed = static_cast<size_t>(m_current - end);
+            m_current = end;
+            m_remaining += freed;
+            m_used -= freed;
+        }
+        return std::span<T>(data, count);
+    }
+
+    // Invalidate everything allocated since the last reset
+    void Reset();
+
+    // Bytes handed out since the last reset / highest of any frame
+    size_t GetUsed() const { return m_used; }
+    size_t GetPeak() const { return m_peak; }
+    size_t GetCapacity() const;
+
+private:
+    void* AllocateSlow(size_t size, size_t alignment);
+    void UseBlock(size_t index);
+
+    struct Block {
+        std::unique_ptr<uint8_t[]> data;
+        size_t size = 0;
+    };
+
+    std::vector<Block> m_blocks;
+    size_t m_blockIndex = 0;
+    size_t m_blockSize;
+
+    uint8_t* m_current = nullptr;
+    uint8_t* m_last = nullptr;     // Start of the most recent allocation
+    size_t m_remaining = 0;
+    size_t m_used = 0;
+    size_t m_peak = 0;
+};
+
+} // namespace Genesis
@@ -0,0 +1,108 @@
+#include "FramePacer.h"
+#include <algorithm>
+#include <thread>
+
+namespace Genesis {
+
+namespace {
+    using Seconds = std::chrono::duration<double>;
+
+    // Added to the predicted frame time in low-latency mode; missing the
+    // vblank costs a whole refresh, so err on the early side
+    constexpr double LOW_LATENCY_MARGIN = 0.001;
+
+    // Spin window limits: the OS timer is rarely better than ~0.5 ms, and a
+    // wider window just burns the core the limiter is meant to save
+    constexpr double MIN_SPIN_WINDOW = 0.0005;
+    constexpr double MAX_SPIN_WINDOW = 0.004;
+}
+
+void FramePacer::SetTargetFPS(double fps) {
+    if (fps == m_targetFPS) return;
+    m_targetFPS = fps > 0.0 ? fps : 0.0;
+    m_period = m_targetFPS > 0.0 ? 1.0 / m_targetFPS : 0.0;
+    m_started = false;
+}
+
+void FramePacer::SetRefreshRate(double hz) {
+    m_refreshPeriod = hz > 0.0 ? 1.0 / hz : 0.0;
+}
+
+void FramePacer::WaitForFrame(bool vsync) {
+    Clock::time_point now = Clock::now();
+    Clock::time_point deadline = now;
+
+    if (m_period > 0.0) {
+        auto period = std::chrono::duration_cast<Clock::duration>(Seconds(m_period));
+        // Hold a steady cadence; after a long hitch restart from now rather
+        // than rushing frames to catch up
+        if (!m_started || now - m_nextFrame > period) {
+            m_nextFrame = now;
+        }
+        deadline = m_nextFrame;
+        m_nextFrame += period;
+        m_started = true;
+    }
+
+    if (m_lowLatency && vsync && m_refreshPeriod > 0.0 && m_lastSwap != Clock::time_point()) {
+        // Swap returns just after a vblank; finish the next frame right
+        // before the one after it
+        double lead = m_refreshPeriod - m_predictedWork - LOW_LATENCY_MARGIN;
+        if (lead > 0.0) {
+            auto start = m_lastSwap + std::chrono::duration_cast<Clock::duration>(Seconds(lead));
+            deadline = std::max(deadline, start);
+        }
+    }
+
+    if (deadline > now) {
+        WaitUntil(deadline);
+    }
+
+    m_frameStart = Clock::now();
+    m_waitMs = Seconds(m_frameStart - now).count() * 1000.0;
+}
+
+void FramePacer::EndWork() {
+    // Before the swap: with vsync the swap blocks until the vblank, which
+    // isn't work the next frame has to fit in
+    double work = Seconds(Clock::now() - m_frameStart).count();
+    m_workSamples[m_workSampleNext] = work;
+    m_workSampleNext = (m_workSampleNext + 1) % WORK_SAMPLES;
+    m_workSampleCount = std::min(m_workSampleCount + 1, WORK_SAMPLES);
+
+    std::array<double, WORK_SAMPLES> sorted = m_workSamples;
+    auto end = sorted.begin() + m_workSampleCount;
+    auto nth = sorted.begin() + static_cast<size_t>((m_workSampleCount - 1) * WORK_PERCENTILE);
+    std::nth_element(sorted.begin(), nth, end);
+    m_predictedWork = *nth;
+}
+
+void FramePacer::EndFrame() {
+    m_lastSwap = Clock::now();
+}
+
+void FramePacer::WaitUntil(Clock::time_point deadline) {
+    // Sleep in short steps while the deadline is outside the spin window,
+    // widening the window whenever a sleep overshoots
+    for (;;) {
+        Clock::time_point now = Clock::now();
+        double remaining = Seconds(deadline - now).count();
+        if (remaining <= m_spinWindow) break;
+
+        double request = remaining - m_spinWindow;
+        std::this_thread::sleep_for(Seconds(request));
+
+        double overshoot = Seconds(Clock::now() - now).count() - request;
+        if (overshoot > m_spinWindow) {
+            m_spinWindow = std::min(overshoot, MAX_SPIN_WINDOW);
+        } else {
+            m_spinWindow = std::max(m_spinWindow * 0.99, MIN_SPIN_WINDOW);
+        }
+    }
+
+    while (Clock::now() < deadline) {
+        std::this_thread::yield();
+    }
+}
+
+} // namespace Genesis
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+
+namespace Genesis {
+
+// ============================================================================
+// FramePacer - Frame-rate limiter for the main loop
+//
+// WaitForFrame() runs at the top of each frame, before input is polled, so
+// time spent waiting never ages the input a frame is built from. Waiting
+// sleeps while the deadline is far off and spins for the last stretch; the
+// spin window follows the worst recent oversleep of the OS timer.
+//
+// Low-latency mode (vsync only) starts the frame as late as possible:
+// EndWork() (before the swap) tracks how long frames take to build, and
+// WaitForFrame() waits until that long (plus a safety margin) before the
+// next expected vblank, taken from when EndFrame() (after the swap) ran,
+// then lets the loop poll input. Without vsync a frame is shown as soon as
+// it is swapped, so the plain limiter already gives the same latency.
+// ============================================================================
+class FramePacer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // Frames per second to hold; 0 or less disables the limit
+    void SetTargetFPS(double fps);
+    double GetTargetFPS() const { return m_targetFPS; }
+
+    void SetLowLatency(bool enabled) { m_lowLatency = enabled; }
+    bool IsLowLatency() const { return m_lowLatency; }
+
+    // Display refresh rate, used to predict vblanks in low-latency mode
+    void SetRefreshRate(double hz);
+
+    // Call before polling input; blocks until the frame should start
+    void WaitForFrame(bool vsync);
+
+    // Call right before swapping buffers: the frame's work is done
+    void EndWork();
+
+    // Call right after swapping buffers (the swap returns at a vblank)
+    void EndFrame();
+
+    // Last frame, for the debug overlay
+    double GetWaitMilliseconds() const { return m_waitMs; }
+    double GetPredictedWorkMilliseconds() const { return m_predictedWork * 1000.0; }
+
+private:
+    void WaitUntil(Clock::time_point deadline);
+
+    double m_targetFPS = 0.0;
+    double m_period = 0.0;            // Seconds; 0 = unlimited
+    double m_refreshPeriod = 0.0;
+    bool m_lowLatency = false;
+
+    Clock::time_point m_nextFrame;    // Limiter deadline
+    Clock::time_point m_frameStart;
+    Clock::time_point m_lastSwap;
+    bool m_started = false;
+
+    // Seconds from WaitForFrame to EndWork: the last WORK_SAMPLES frames,
+    // and the WORK_PERCENTILE of them (one hitch doesn't move it)
+    static constexpr size_t WORK_SAMPLES = 32;
+    static constexpr double WORK_PERCENTILE = 0.9;
+    std::array<double, WORK_SAMPLES> m_workSamples{};
+    size_t m_workSampleCount = 0;
+    size_t m_workSampleNext = 0;
+    double m_predictedWork = 0.0;
+    double m_spinWindow = 0.002;      // Spin instead of sleeping below this
+    double m_waitMs = 0.0;
+};
+
+} // namespace Genesis
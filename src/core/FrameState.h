@@ -0,0 +1,29 @@
+#pragma once
+
+#include "math/Math.h"
+#include "renderer/DebugDrawList.h"
+#include <cstdint>
+
+namespace Genesis {
+
+// ============================================================================
+// FrameState - What the renderer needs from one simulation tick
+//
+// With EngineConfig::pipelinedSimulation the simulation fills one of these
+// after its last ticks of a frame (on a worker), while the main thread
+// renders the previous pair. The render side never reads live simulation
+// state, only these snapshots; the camera is interpolated between them.
+// ============================================================================
+struct FrameState {
+    uint64_t tick = 0;              // Fixed update count when captured
+
+    // Camera (degrees, like FPSCamera)
+    Vec3 cameraPosition = Vec3(0.0f);
+    float cameraYaw = 0.0f;
+    float cameraPitch = 0.0f;
+
+    // Debug primitives recorded by the simulation
+    DebugDrawList debugDraw;
+};
+
+} // namespace Genesis
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace Genesis {
+
+// ============================================================================
+// FNV-1a 64 - Content hashes for caches (shader binaries, interned meshes
+// and materials). Not for untrusted input or anything cryptographic.
+// ============================================================================
+constexpr uint64_t FNV_OFFSET = 14695981039346656037ull;
+constexpr uint64_t FNV_PRIME = 1099511628211ull;
+
+inline uint64_t HashBytes(uint64_t hash, const void* data, size_t size) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+template<typename T>
+inline uint64_t HashValue(uint64_t hash, const T& value) {
+    return HashBytes(hash, &value, sizeof(T));
+}
+
+// Length first, so "ab" + "c" and "a" + "bc" differ
+inline uint64_t HashString(uint64_t hash, std::string_view text) {
+    uint64_t length = text.size();
+    hash = HashBytes(hash, &length, sizeof(length));
+    return HashBytes(hash, text.data(), text.size());
+}
+
+} // namespace Genesis
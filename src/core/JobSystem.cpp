@@ -0,0 +1,252 @@
+#include "JobSystem.h"
+#include "Logger.h"
+#include "Profiler.h"
+
+namespace Genesis {
+
+namespace {
+    // Queue owned by this thread; -1 = not a job system thread (use the shared queue)
+    thread_local int t_queueIndex = -1;
+}
+
+JobSystem::~JobSystem() {
+    Shutdown();
+}
+
+bool JobSystem::Initialize(int workerCount) {
+    if (m_running) return true;
+
+    if (workerCount < 0) {
+        unsigned int hw = std::thread::hardware_concurrency();
+        workerCount = hw > 1 ? static_cast<int>(hw) - 1 : 0;
+    }
+
+    // Main thread, workers, shared
+    m_queues.clear();
+    for (int i = 0; i < workerCount + 2; i++) {
+        m_queues.push_back(std::make_unique<WorkQueue>());
+    }
+
+    t_queueIndex = 0;
+    m_stop = false;
+    m_running = true;
+
+    m_workers.reserve(workerCount);
+    for (int i = 0; i < workerCount; i++) {
+        m_workers.emplace_back(&JobSystem::WorkerMain, this, static_cast<uint32_t>(i + 1));
+    }
+
+    LOG_INFO("JobSystem", "Started " + std::to_string(workerCount) + " worker threads");
+    return true;
+}
+
+void JobSystem::Shutdown() {
+    if (!m_running) return;
+
+    // Workers drain their queues before they look at m_stop
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_stop = true;
+    }
+    m_wake.notify_all();
+
+    for (auto& worker : m_workers) {
+        worker.join();
+    }
+    m_workers.clear();
+
+    // Anything left was queued for the main thread (or with no workers at all)
+    Job job;
+    while (Pop(job)) {
+        Execute(job);
+    }
+
+    m_queues.clear();
+    m_running = false;
+    t_queueIndex = -1;
+}
+
+// ============================================================================
+// Submission
+// ============================================================================
+
+Job JobSystem::MakeTaskJob(std::function<void()> task, JobCounter* counter) {
+    Job job;
+    job.function = [](void* data) {
+        auto* fn = static_cast<std::function<void()>*>(data);
+        (*fn)();
+        delete fn;
+    };
+    job.context = new std::function<void()>(std::move(task));
+    job.counter = counter;
+    return job;
+}
+
+void JobSystem::Submit(const Job& job) {
+    if (job.counter) {
+        job.counter->m_pending.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    if (!m_running) {
+        Execute(job);   // No scheduler: run inline
+        return;
+    }
+    Push(job);
+}
+
+void JobSystem::Submit(std::function<void()> task, JobCounter* counter) {
+    Submit(MakeTaskJob(std::move(task), counter));
+}
+
+void JobSystem::SubmitAfter(JobCounter& dependency, const Job& job) {
+    {
+        std::lock_guard<std::mutex> lock(dependency.m_mutex);
+        if (!dependency.IsDone()) {
+            // Counted now so waiting on job.counter covers the deferred job
+            if (job.counter) {
+                job.counter->m_pending.fetch_add(1, std::memory_order_relaxed);
+            }
+            dependency.m_continuations.push_back(job);
+            return;
+        }
+    }
+    Submit(job);
+}
+
+void JobSystem::SubmitAfter(JobCounter& dependency, std::function<void()> task, JobCounter* counter) {
+    SubmitAfter(dependency, MakeTaskJob(std::move(task), counter));
+}
+
+void JobSystem::Push(const Job& job) {
+    size_t index = t_queueIndex >= 0 ? static_cast<size_t>(t_queueIndex) : m_queues.size() - 1;
+
+    // Counted first so m_queued never undercounts a job that is in a queue
+    m_queued.fetch_add(1);
+    {
+        WorkQueue& queue = *m_queues[index];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.jobs.push_back(job);
+    }
+
+    if (m_sleeping.load() > 0) {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_wake.notify_one();
+    }
+}
+
+// ============================================================================
+// Execution
+// ============================================================================
+
+bool JobSystem::TryPopBack(WorkQueue& queue, Job& out) {
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.jobs.empty()) return false;
+    out = queue.jobs.back();
+    queue.jobs.pop_back();
+    return true;
+}
+
+bool JobSystem::TryPopFront(WorkQueue& queue, Job& out) {
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.jobs.empty()) return false;
+    out = queue.jobs.front();
+    queue.jobs.pop_front();
+    return true;
+}
+
+bool JobSystem::Pop(Job& out) {
+    if (m_queued.load() == 0) return false;
+
+    size_t queueCount = m_queues.size();
+    size_t shared = queueCount - 1;
+    size_t own = t_queueIndex >= 0 ? static_cast<size_t>(t_queueIndex) : shared;
+
+    // Own work newest-first, then the shared queue, then steal oldest-first
+    bool found = TryPopBack(*m_queues[own], out) ||
+                 (own != shared && TryPopFront(*m_queues[shared], out));
+
+    if (!found) {
+        for (size_t i = 0; i < shared && !found; i++) {
+            size_t victim = (own + 1 + i) % shared;
+            if (victim == own) continue;
+            if (TryPopFront(*m_queues[victim], out)) {
+                found = true;
+                m_stolen.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    if (found) {
+        m_queued.fetch_sub(1);
+    }
+    return found;
+}
+
+void JobSystem::Execute(const Job& job) {
+    {
+        GENESIS_PROFILE_SCOPE("Job");
+        job.function(job.context);
+    }
+    m_executed.fetch_add(1, std::memory_order_relaxed);
+
+    if (job.counter) {
+        Finish(*job.counter);
+    }
+}
+
+void JobSystem::Finish(JobCounter& counter) {
+    // Decrement under the lock: Wait() takes it once before returning, so
+    // the counter can't be destroyed while we still touch it
+    std::vector<Job> ready;
+    {
+        std::lock_guard<std::mutex> lock(counter.m_mutex);
+        if (counter.m_pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            ready.swap(counter.m_continuations);
+        }
+    }
+
+    // Continuations were counted by SubmitAfter
+    for (const Job& job : ready) {
+        if (m_running) {
+            Push(job);
+        } else {
+            Execute(job);
+        }
+    }
+}
+
+void JobSystem::Wait(JobCounter& counter) {
+    while (!counter.IsDone()) {
+        Job job;
+        if (Pop(job)) {
+            Execute(job);
+        } else {
+            std::this_thread::yield();
+        }
+    }
+
+    // Let the thread that finished the last job release the counter
+    std::lock_guard<std::mutex> lock(counter.m_mutex);
+}
+
+void JobSystem::WorkerMain(uint32_t queueIndex) {
+    t_queueIndex = static_cast<int>(queueIndex);
+    GENESIS_PROFILE_THREAD("Worker " + std::to_string(queueIndex));
+
+    for (;;) {
+        Job job;
+        if (Pop(job)) {
+            Execute(job);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_wakeMutex);
+        if (m_stop && m_queued.load() == 0) break;
+
+        m_sleeping.fetch_add(1);
+        m_wake.wait(lock, [this] { return m_stop || m_queued.load() > 0; });
+        m_sleeping.fetch_sub(1);
+    }
+}
+
+} // namespace Genesis
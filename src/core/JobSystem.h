@@ -0,0 +1,200 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace Genesis {
+
+class JobCounter;
+
+// ============================================================================
+// Job - Plain function pointer + context; no allocation to schedule one
+// ============================================================================
+struct Job {
+    using Function = void (*)(void* context);
+
+    Function function = nullptr;
+    void* context = nullptr;
+    JobCounter* counter = nullptr;   // Decremented when the job has run
+};
+
+// ============================================================================
+// JobCounter - Number of unfinished jobs submitted against it
+//
+// Wait() on it to join a group of jobs; SubmitAfter() on it to make jobs
+// depend on the group. Must outlive every job submitted against it (waiting
+// on it before it goes out of scope guarantees that).
+// ============================================================================
+class JobCounter {
+public:
+    JobCounter() = default;
+    JobCounter(const JobCounter&) = delete;
+    JobCounter& operator=(const JobCounter&) = delete;
+
+    bool IsDone() const { return m_pending.load(std::memory_order_acquire) == 0; }
+    uint32_t GetPending() const { return m_pending.load(std::memory_order_acquire); }
+
+private:
+    friend class JobSystem;
+
+    std::atomic<uint32_t> m_pending{0};
+    std::mutex m_mutex;
+    std::vector<Job> m_continuations;   // Released when m_pending hits zero
+};
+
+// ============================================================================
+// JobSystem - Work-stealing scheduler owned by Engine
+//
+// One deque per thread: the owner pushes and pops at the back (LIFO, warm
+// caches), idle threads steal from the front of the others. The thread
+// that called Initialize() (the main thread) has its own deque and runs
+// jobs whenever it waits; other threads (e.g. the async map loader) submit
+// through a shared queue and can wait the same way.
+//
+// There are no fibers: Wait() runs other jobs on the waiting thread until
+// the counter drops to zero, so nested waits simply use more stack.
+// Jobs must not touch GL or other main-thread-only state.
+//
+// Usage:
+//   auto& jobs = JobSystem::Instance();
+//   JobCounter done;
+//   jobs.Submit([&] { BuildA(); }, &done);
+//   jobs.Submit([&] { BuildB(); }, &done);
+//   jobs.SubmitAfter(done, [&] { Merge(); }, &merged);
+//   jobs.ParallelFor(items.size(), 64, [&](size_t begin, size_t end) { ... });
+//   jobs.Wait(merged);
+// ============================================================================
+class JobSystem {
+public:
+    static JobSystem& Instance() {
+        static JobSystem instance;
+        return instance;
+    }
+
+    // workerCount < 0: one worker per hardware thread besides the caller.
+    // 0 is valid: jobs then only run on threads that Wait().
+    bool Initialize(int workerCount = -1);
+
+    // Runs whatever is still queued, then joins the workers
+    void Shutdown();
+
+    bool IsRunning() const { return m_running; }
+
+    uint32_t GetWorkerCount() const { return static_cast<uint32_t>(m_workers.size()); }
+    uint32_t GetThreadCount() const { return GetWorkerCount() + 1; }   // Including the main thread
+
+    // Schedule a job; its counter (if any) is incremented here
+    void Submit(const Job& job);
+    void Submit(std::function<void()> task, JobCounter* counter = nullptr);
+
+    // Schedule once 'dependency' reaches zero (immediately if it already has)
+    void SubmitAfter(JobCounter& dependency, const Job& job);
+    void SubmitAfter(JobCounter& dependency, std::function<void()> task, JobCounter* counter = nullptr);
+
+    // Run queued jobs on this thread until the counter is done
+    void Wait(JobCounter& counter);
+
+    // Split [0, count) into batches run across all threads; the caller takes
+    // part and the call returns once every batch has run
+    template<typename Fn>
+    void ParallelFor(size_t count, size_t batchSize, Fn&& fn);
+
+    // Stats
+    uint64_t GetJobsExecuted() const { return m_executed.load(std::memory_order_relaxed); }
+    uint64_t GetJobsStolen() const { return m_stolen.load(std::memory_order_relaxed); }
+
+private:
+    JobSystem() = default;
+    ~JobSystem();
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+    };
+
+    Job MakeTaskJob(std::function<void()> task, JobCounter* counter);
+
+    void Push(const Job& job);
+    bool Pop(Job& out);
+    bool TryPopBack(WorkQueue& queue, Job& out);
+    bool TryPopFront(WorkQueue& queue, Job& out);
+    void Execute(const Job& job);
+    void Finish(JobCounter& counter);
+
+    void WorkerMain(uint32_t queueIndex);
+
+private:
+    // [0] = main thread, [1..N] = workers, [N+1] = shared (other threads)
+    std::vector<std::unique_ptr<WorkQueue>> m_queues;
+    std::vector<std::thread> m_workers;
+
+    std::atomic<uint32_t> m_queued{0};
+    std::atomic<uint32_t> m_sleeping{0};
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wake;
+    std::atomic<bool> m_stop{false};
+    std::atomic<bool> m_running{false};
+
+    std::atomic<uint64_t> m_executed{0};
+    std::atomic<uint64_t> m_stolen{0};
+};
+
+// ============================================================================
+// Template Implementation
+// ============================================================================
+
+template<typename Fn>
+void JobSystem::ParallelFor(size_t count, size_t batchSize, Fn&& fn) {
+    if (count == 0) return;
+    batchSize = std::max<size_t>(batchSize, 1);
+
+    size_t batches = (count + batchSize - 1) / batchSize;
+    size_t jobCount = m_running ? std::min<size_t>(batches, GetThreadCount()) : 1;
+
+    if (jobCount <= 1) {
+        fn(size_t(0), count);
+        return;
+    }
+
+    // Every job pulls batches from a shared counter, so uneven batches
+    // balance themselves and only jobCount jobs are ever queued
+    struct Context {
+        std::remove_reference_t<Fn>* fn;
+        std::atomic<size_t> next;
+        size_t count;
+        size_t batchSize;
+        size_t batches;
+    };
+    Context context{&fn, {0}, count, batchSize, batches};
+
+    Job::Function run = [](void* data) {
+        Context& ctx = *static_cast<Context*>(data);
+        for (;;) {
+            size_t batch = ctx.next.fetch_add(1, std::memory_order_relaxed);
+            if (batch >= ctx.batches) break;
+            size_t begin = batch * ctx.batchSize;
+            (*ctx.fn)(begin, std::min(begin + ctx.batchSize, ctx.count));
+        }
+    };
+
+    JobCounter counter;
+    for (size_t i = 1; i < jobCount; i++) {
+        Submit(Job{run, &context, &counter});
+    }
+    run(&context);
+    Wait(counter);
+}
+
+} // namespace Genesis
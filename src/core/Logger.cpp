@@ -0,0 +1,288 @@
+#include "Logger.h"
+#include <cstring>
+#include <ctime>
+
+namespace Genesis {
+
+Logger::Logger() {
+    // Category 0 also takes messages once the table is full
+    m_categories[0] = "Log";
+    m_categoryCount.store(1, std::memory_order_release);
+}
+
+Logger::~Logger() {
+    StopAsync();
+}
+
+void Logger::Log(LogLevel level, const std::string& category, const std::string& message) {
+    if (level < GetMinLevel()) return;
+
+    int64_t timeMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+
+    if (IsAsync()) {
+        // Counted before checking again, so StopAsync() either sees this
+        // producer and waits for its record, or this one sees the stop
+        m_producers.fetch_add(1);
+        if (m_async.load()) {
+            bool queued = PushAsync(level, category, message, timeMs);
+            m_producers.fetch_sub(1);
+            if (queued && level == LogLevel::Fatal) {
+                Flush();
+            }
+            return;
+        }
+        m_producers.fetch_sub(1);
+    }
+
+    // Also covers std::localtime's shared buffer
+    std::unique_lock<std::mutex> lock(m_mutex);
+    WriteLine(level, category, message, timeMs);
+    std::cout.flush();
+
+    // Forward to console if callback is set
+    if (m_consoleCallback) {
+        if (std::this_thread::get_id() != m_consoleThread) {
+            m_pendingConsole.push_back({ level, category, message });
+            return;
+        }
+        lock.unlock();
+        m_consoleCallback(level, category, message);
+    }
+}
+
+void Logger::WriteLine(LogLevel level, const std::string& category, const std::string& message, int64_t timeMs) {
+    std::time_t time = static_cast<std::time_t>(timeMs / 1000);
+
+    std::ostringstream oss;
+    oss << std::put_time(std::localtime(&time), "%H:%M:%S");
+    oss << '.' << std::setfill('0') << std::setw(3) << (timeMs % 1000);
+    oss << " [" << LevelToString(level) << "] ";
+    oss << "[" << category << "] ";
+    oss << message;
+
+    // Color output based on level
+    switch (level) {
+        case LogLevel::Trace:   std::cout << "\033[90m"; break;  // Gray
+        case LogLevel::Debug:   std::cout << "\033[36m"; break;  // Cyan
+        case LogLevel::Info:    std::cout << "\033[32m"; break;  // Green
+        case LogLevel::Warning: std::cout << "\033[33m"; break;  // Yellow
+        case LogLevel::Error:   std::cout << "\033[31m"; break;  // Red
+        case LogLevel::Fatal:   std::cout << "\033[35m"; break;  // Magenta
+    }
+    std::cout << oss.str() << "\033[0m" << '\n';
+
+    if (m_file.is_open()) {
+        m_file << oss.str() << '\n';
+    }
+}
+
+bool Logger::SetLogFile(const std::string& path) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_file.is_open()) {
+        m_file.close();
+    }
+    if (path.empty()) return true;
+
+    m_file.open(path, std::ios::out | std::ios::trunc);
+    return m_file.is_open();
+}
+
+// ============================================================================
+// Categories
+// ============================================================================
+
+uint16_t Logger::InternCategory(const std::string& category) {
+    uint32_t count = m_categoryCount.load(std::memory_order_acquire);
+    for (uint32_t i = 0; i < count; i++) {
+        if (m_categories[i] == category) return static_cast<uint16_t>(i);
+    }
+
+    std::lock_guard<std::mutex> lock(m_categoryMutex);
+    count = m_categoryCount.load(std::memory_order_acquire);
+    for (uint32_t i = 0; i < count; i++) {
+        if (m_categories[i] == category) return static_cast<uint16_t>(i);
+    }
+    if (count == MAX_CATEGORIES) return 0;
+
+    m_categories[count] = category;
+    m_categoryCount.store(count + 1, std::memory_order_release);
+    return static_cast<uint16_t>(count);
+}
+
+// ============================================================================
+// Ring Buffer
+// ============================================================================
+
+bool Logger::PushAsync(LogLevel level, const std::string& category, const std::string& message, int64_t timeMs) {
+    uint16_t id = InternCategory(category);
+    while (!TryPush(level, id, message, timeMs)) {
+        // Ring full: drop chatter, wait for the writer on anything important
+        if (level < LogLevel::Warning) {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        m_wake.notify_one();
+        std::this_thread::yield();
+    }
+
+    if (m_writerSleeping.load()) {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_wake.notify_one();
+    }
+    return true;
+}
+
+bool Logger::TryPush(LogLevel level, uint16_t category, const std::string& message, int64_t timeMs) {
+    uint64_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+    Record* record = nullptr;
+
+    for (;;) {
+        record = &m_ring[pos & (RING_CAPACITY - 1)];
+        uint64_t sequence = record->sequence.load(std::memory_order_acquire);
+        int64_t diff = static_cast<int64_t>(sequence) - static_cast<int64_t>(pos);
+
+        if (diff == 0) {
+            // Slot free for this lap: claim it
+            if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+        } else if (diff < 0) {
+            return false;   // Still holds last lap's record: full
+        } else {
+            pos = m_enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    record->timeMs = timeMs;
+    record->level = level;
+    record->category = category;
+    record->length = static_cast<uint32_t>(message.size());
+    if (message.size() <= Record::INLINE_TEXT) {
+        std::memcpy(record->text, message.data(), message.size());
+        record->overflow = nullptr;
+    } else {
+        record->overflow = new char[message.size()];
+        std::memcpy(record->overflow, message.data(), message.size());
+    }
+
+    record->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+bool Logger::TryPop(Record*& out) {
+    uint64_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+    Record* record = &m_ring[pos & (RING_CAPACITY - 1)];
+    if (record->sequence.load(std::memory_order_acquire) != pos + 1) {
+        return false;
+    }
+    out = record;
+    return true;
+}
+
+// ============================================================================
+// Async Mode
+// ============================================================================
+
+bool Logger::StartAsync() {
+    if (IsAsync()) return true;
+
+    m_ring = std::make_unique<Record[]>(RING_CAPACITY);
+    for (uint64_t i = 0; i < RING_CAPACITY; i++) {
+        m_ring[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    m_enqueuePos.store(0, std::memory_order_relaxed);
+    m_dequeuePos.store(0, std::memory_order_relaxed);
+    m_stopWriter = false;
+
+    m_writer = std::thread(&Logger::WriterMain, this);
+    m_async.store(true, std::memory_order_release);
+    return true;
+}
+
+void Logger::StopAsync() {
+    if (!IsAsync()) return;
+
+    // New messages go the synchronous way from here on; the ones already
+    // on their way into the ring are waited for, and the writer drains
+    // every record before it exits
+    m_async.store(false);
+    while (m_producers.load() != 0) {
+        std::this_thread::yield();
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_stopWriter = true;
+    }
+    m_wake.notify_one();
+    m_writer.join();
+}
+
+void Logger::Flush() {
+    if (!IsAsync()) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::cout.flush();
+        if (m_file.is_open()) m_file.flush();
+        return;
+    }
+
+    uint64_t target = m_enqueuePos.load(std::memory_order_acquire);
+    std::unique_lock<std::mutex> lock(m_wakeMutex);
+    m_wake.notify_one();
+    m_drained.wait(lock, [&] {
+        return m_dequeuePos.load(std::memory_order_acquire) >= target || m_stopWriter;
+    });
+}
+
+void Logger::WriterMain() {
+    for (;;) {
+        bool wrote = false;
+        Record* record = nullptr;
+
+        while (TryPop(record)) {
+            const char* text = record->overflow ? record->overflow : record->text;
+            std::string message(text, record->length);
+            const std::string& category = m_categories[record->category];
+            LogLevel level = record->level;
+            int64_t timeMs = record->timeMs;
+
+            delete[] record->overflow;
+            record->overflow = nullptr;
+
+            // Hand the slot back to producers before the (slow) write
+            uint64_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+            record->sequence.store(pos + RING_CAPACITY, std::memory_order_release);
+
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                WriteLine(level, category, message, timeMs);
+                if (m_consoleCallback) {
+                    m_pendingConsole.push_back({ level, category, std::move(message) });
+                }
+            }
+            m_dequeuePos.store(pos + 1, std::memory_order_release);
+            wrote = true;
+        }
+
+        if (wrote) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            std::cout.flush();
+            if (m_file.is_open()) m_file.flush();
+        }
+
+        std::unique_lock<std::mutex> lock(m_wakeMutex);
+        m_drained.notify_all();
+
+        Record* next = nullptr;
+        if (m_stopWriter && !TryPop(next)) break;
+
+        // The timeout covers a producer that checked m_writerSleeping just
+        // before it was set
+        m_writerSleeping = true;
+        m_wake.wait_for(lock, std::chrono::milliseconds(20), [&] {
+            Record* pending = nullptr;
+            return m_stopWriter || TryPop(pending);
+        });
+        m_writerSleeping = false;
+    }
+}
+
+} // namespace Genesis
@@ -5,7 +5,22 @@
 #include <sstream>
 #include <chrono>
 #include <iomanip>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
 #include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Call sites below this level compile to nothing (0 = Trace ... 5 = Fatal).
+// CMake sets 2 (Info) for Release; the message expression isn't evaluated.
+#ifndef GENESIS_LOG_MIN_LEVEL
+#define GENESIS_LOG_MIN_LEVEL 0
+#endif
 
 namespace Genesis {
 
@@ -23,6 +38,18 @@ enum class LogLevel {
 
 // ============================================================================
 // Logger - Simple logging system with console integration
+//
+// Log() may be called from any thread. The console callback only ever runs
+// on the thread that installed it: messages from other threads are queued
+// until that thread calls FlushConsole() (once per frame).
+//
+// Synchronous by default: Log() formats and writes on the calling thread.
+// After StartAsync(), Log() only copies the message into a lock-free MPSC
+// ring (timestamp, level, interned category id, text); a writer thread adds
+// the timestamp text and colors and writes stdout, the log file and the
+// console queue. Fatal messages wait until they have been written. When the
+// ring is full, Trace/Debug/Info messages are dropped (counted) while
+// Warning and above wait for space.
 // ============================================================================
 class Logger {
 public:
@@ -31,47 +58,53 @@ public:
         return instance;
     }
 
-    void SetMinLevel(LogLevel level) { m_minLevel = level; }
-    LogLevel GetMinLevel() const { return m_minLevel; }
+    ~Logger();
+
+    void SetMinLevel(LogLevel level) { m_minLevel.store(level, std::memory_order_relaxed); }
+    LogLevel GetMinLevel() const { return m_minLevel.load(std::memory_order_relaxed); }
 
     // Set callback to forward logs to console
     using ConsoleCallback = std::function<void(LogLevel, const std::string&, const std::string&)>;
-    void SetConsoleCallback(ConsoleCallback callback) { m_consoleCallback = callback; }
+    void SetConsoleCallback(ConsoleCallback callback) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_consoleCallback = callback;
+        m_consoleThread = std::this_thread::get_id();
+    }
 
-    void Log(LogLevel level, const std::string& category, const std::string& message) {
-        if (level < m_minLevel) return;
+    // Forward messages logged by other threads to the console
+    void FlushConsole() {
+        std::vector<PendingMessage> pending;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            pending.swap(m_pendingConsole);
+        }
+        if (!m_consoleCallback) return;
+        for (const auto& msg : pending) {
+            m_consoleCallback(msg.level, msg.category, msg.message);
+        }
+    }
 
-        auto now = std::chrono::system_clock::now();
-        auto time = std::chrono::system_clock::to_time_t(now);
-        auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-            now.time_since_epoch()) % 1000;
+    void Log(LogLevel level, const std::string& category, const std::string& message);
 
-        std::ostringstream oss;
-        oss << std::put_time(std::localtime(&time), "%H:%M:%S");
-        oss << '.' << std::setfill('0') << std::setw(3) << ms.count();
-        oss << " [" << LevelToString(level) << "] ";
-        oss << "[" << category << "] ";
-        oss << message;
+    // ========================================================================
+    // Async Mode
+    // ========================================================================
+    bool StartAsync();
+    void StopAsync();          // Writes everything queued, then joins the writer
+    bool IsAsync() const { return m_async.load(std::memory_order_acquire); }
 
-        // Color output based on level
-        switch (level) {
-            case LogLevel::Trace:   std::cout << "\033[90m"; break;  // Gray
-            case LogLevel::Debug:   std::cout << "\033[36m"; break;  // Cyan
-            case LogLevel::Info:    std::cout << "\033[32m"; break;  // Green
-            case LogLevel::Warning: std::cout << "\033[33m"; break;  // Yellow
-            case LogLevel::Error:   std::cout << "\033[31m"; break;  // Red
-            case LogLevel::Fatal:   std::cout << "\033[35m"; break;  // Magenta
-        }
-        std::cout << oss.str() << "\033[0m" << std::endl;
+    // Block until everything logged so far has been written
+    void Flush();
 
-        // Forward to console if callback is set
-        if (m_consoleCallback) {
-            m_consoleCallback(level, category, message);
-        }
-    }
+    uint64_t GetDroppedCount() const { return m_dropped.load(std::memory_order_relaxed); }
+
+    // Also write to a file (no colors); empty path closes it
+    bool SetLogFile(const std::string& path);
 
 private:
-    Logger() = default;
+    Logger();
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
 
     const char* LevelToString(LogLevel level) {
         switch (level) {
@@ -85,19 +118,99 @@ private:
         }
     }
 
-    LogLevel m_minLevel = LogLevel::Info;
+    struct PendingMessage {
+        LogLevel level;
+        std::string category;
+        std::string message;
+    };
+
+    // One ring slot. Messages longer than the inline buffer are copied to
+    // the heap and freed by the writer.
+    struct Record {
+        static constexpr size_t INLINE_TEXT = 192;
+
+        std::atomic<uint64_t> sequence{0};
+        int64_t timeMs = 0;
+        LogLevel level = LogLevel::Info;
+        uint16_t category = 0;
+        uint32_t length = 0;
+        char* overflow = nullptr;
+        char text[INLINE_TEXT];
+    };
+
+    static constexpr uint64_t RING_CAPACITY = 1024;   // Power of two
+    static constexpr size_t MAX_CATEGORIES = 256;
+
+    uint16_t InternCategory(const std::string& category);
+    // Queue for the writer; false if dropped (ring full, below Warning)
+    bool PushAsync(LogLevel level, const std::string& category, const std::string& message, int64_t timeMs);
+    bool TryPush(LogLevel level, uint16_t category, const std::string& message, int64_t timeMs);
+    bool TryPop(Record*& out);
+
+    // Called with m_mutex held
+    void WriteLine(LogLevel level, const std::string& category, const std::string& message, int64_t timeMs);
+
+    void WriterMain();
+
+private:
+    std::atomic<LogLevel> m_minLevel{LogLevel::Info};
     ConsoleCallback m_consoleCallback = nullptr;
+    std::thread::id m_consoleThread;
+    std::vector<PendingMessage> m_pendingConsole;
+    std::mutex m_mutex;        // Output, console queue, file
+    std::ofstream m_file;
+
+    // Async ring (Vyukov bounded queue; many producers, the writer consumes)
+    std::unique_ptr<Record[]> m_ring;
+    std::atomic<uint64_t> m_enqueuePos{0};
+    std::atomic<uint64_t> m_dequeuePos{0};
+    std::atomic<uint64_t> m_dropped{0};
+    std::atomic<bool> m_async{false};
+    std::atomic<uint32_t> m_producers{0};      // Threads in Log()'s async path
+    std::atomic<bool> m_writerSleeping{false};
+    std::atomic<bool> m_stopWriter{false};
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_drained;
+    std::thread m_writer;
+
+    // Interned categories: slots below m_categoryCount are immutable
+    std::array<std::string, MAX_CATEGORIES> m_categories;
+    std::atomic<uint32_t> m_categoryCount{0};
+    std::mutex m_categoryMutex;
 };
 
 // ============================================================================
 // Logging Macros
 // ============================================================================
-#define LOG_TRACE(category, msg)   Genesis::Logger::Instance().Log(Genesis::LogLevel::Trace, category, msg)
-#define LOG_DEBUG(category, msg)   Genesis::Logger::Instance().Log(Genesis::LogLevel::Debug, category, msg)
-#define LOG_INFO(category, msg)    Genesis::Logger::Instance().Log(Genesis::LogLevel::Info, category, msg)
-#define LOG_WARNING(category, msg) Genesis::Logger::Instance().Log(Genesis::LogLevel::Warning, category, msg)
-#define LOG_ERROR(category, msg)   Genesis::Logger::Instance().Log(Genesis::LogLevel::Error, category, msg)
-#define LOG_FATAL(category, msg)   Genesis::Logger::Instance().Log(Genesis::LogLevel::Fatal, category, msg)
+#define GENESIS_LOG_AT(level, category, msg) Genesis::Logger::Instance().Log(level, category, msg)
+
+#if GENESIS_LOG_MIN_LEVEL <= 0
+#define LOG_TRACE(category, msg)   GENESIS_LOG_AT(Genesis::LogLevel::Trace, category, msg)
+#else
+#define LOG_TRACE(category, msg)   ((void)0)
+#endif
+
+#if GENESIS_LOG_MIN_LEVEL <= 1
+#define LOG_DEBUG(category, msg)   GENESIS_LOG_AT(Genesis::LogLevel::Debug, category, msg)
+#else
+#define LOG_DEBUG(category, msg)   ((void)0)
+#endif
+
+#if GENESIS_LOG_MIN_LEVEL <= 2
+#define LOG_INFO(category, msg)    GENESIS_LOG_AT(Genesis::LogLevel::Info, category, msg)
+#else
+#define LOG_INFO(category, msg)    ((void)0)
+#endif
+
+#if GENESIS_LOG_MIN_LEVEL <= 3
+#define LOG_WARNING(category, msg) GENESIS_LOG_AT(Genesis::LogLevel::Warning, category, msg)
+#else
+#define LOG_WARNING(category, msg) ((void)0)
+#endif
+
+// Errors and fatal messages are never compiled out
+#define LOG_ERROR(category, msg)   GENESIS_LOG_AT(Genesis::LogLevel::Error, category, msg)
+#define LOG_FATAL(category, msg)   GENESIS_LOG_AT(Genesis::LogLevel::Fatal, category, msg)
 
 } // namespace Genesis
-
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+namespace Genesis {
+
+// ============================================================================
+// MappedFile - Read-only memory mapping of a whole file
+//
+// The OS pages data in on demand, so opening is O(1) and reading a record is
+// a plain memory access. The mapping stays valid until Close()/destruction.
+//
+// Usage:
+//   MappedFile file;
+//   if (file.Open("assets/maps/level.gmap")) {
+//       const uint8_t* data = file.GetData();
+//       size_t size = file.GetSize();
+//   }
+// ============================================================================
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    // Non-copyable, movable
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    // Map the file (empty files fail: there is nothing to map)
+    bool Open(const std::string& path);
+    void Close();
+
+    bool IsOpen() const { return m_data != nullptr; }
+    const uint8_t* GetData() const { return m_data; }
+    size_t GetSize() const { return m_size; }
+
+private:
+    const uint8_t* m_data = nullptr;
+    size_t m_size = 0;
+
+#ifdef _WIN32
+    void* m_file = nullptr;
+    void* m_mapping = nullptr;
+#else
+    int m_fd = -1;
+#endif
+};
+
+} // namespace Genesis
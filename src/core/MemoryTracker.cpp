@@ -0,0 +1,119 @@
+#include "MemoryTracker.h"
+#include "Logger.h"
+#include <cctype>
+#include <string>
+
+namespace Genesis {
+
+static const char* g_tagNames[static_cast<size_t>(MemoryTag::Count)] = {
+    "General",
+    "Meshes",
+    "Textures",
+    "Materials",
+    "World",
+    "Map",
+    "Console",
+};
+
+void MemoryTracker::AddHeap(MemoryTag tag, size_t bytes) {
+    TagCounters& counters = m_tags[static_cast<size_t>(tag)];
+    counters.allocations.fetch_add(1, std::memory_order_relaxed);
+    Add(tag, counters.heap, static_cast<int64_t>(bytes));
+}
+
+void MemoryTracker::RemoveHeap(MemoryTag tag, size_t bytes) {
+    Add(tag, m_tags[static_cast<size_t>(tag)].heap, -static_cast<int64_t>(bytes));
+}
+
+void MemoryTracker::AddGpu(MemoryTag tag, size_t bytes) {
+    Add(tag, m_tags[static_cast<size_t>(tag)].gpu, static_cast<int64_t>(bytes));
+}
+
+void MemoryTracker::RemoveGpu(MemoryTag tag, size_t bytes) {
+    Add(tag, m_tags[static_cast<size_t>(tag)].gpu, -static_cast<int64_t>(bytes));
+}
+
+void MemoryTracker::Add(MemoryTag tag, Counter& counter, int64_t bytes) {
+    int64_t live = counter.bytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    if (bytes <= 0) {
+        if (m_tags[static_cast<size_t>(tag)].overBudget.load(std::memory_order_relaxed)) {
+            CheckBudget(tag);
+        }
+        return;
+    }
+
+    int64_t peak = counter.peak.load(std::memory_order_relaxed);
+    while (live > peak && !counter.peak.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+    }
+    if (m_tags[static_cast<size_t>(tag)].budget.load(std::memory_order_relaxed) > 0) {
+        CheckBudget(tag);
+    }
+}
+
+void MemoryTracker::CheckBudget(MemoryTag tag) {
+    TagCounters& counters = m_tags[static_cast<size_t>(tag)];
+    int64_t budget = counters.budget.load(std::memory_order_relaxed);
+    int64_t total = counters.heap.bytes.load(std::memory_order_relaxed) +
+                    counters.gpu.bytes.load(std::memory_order_relaxed);
+    bool over = budget > 0 && total > budget;
+
+    // Warn on the crossing only, not on every allocation above it
+    if (counters.overBudget.exchange(over, std::memory_order_relaxed) != over && over) {
+        LOG_WARNING("Memory", std::string(GetTagName(tag)) + " over budget: " +
+                    std::to_string(total / 1048576) + " of " + std::to_string(budget / 1048576) + " MB");
+    }
+}
+
+void MemoryTracker::SetBudget(MemoryTag tag, int64_t bytes) {
+    m_tags[static_cast<size_t>(tag)].budget.store(bytes > 0 ? bytes : 0, std::memory_order_relaxed);
+    CheckBudget(tag);
+}
+
+MemoryTagStats MemoryTracker::GetStats(MemoryTag tag) const {
+    const TagCounters& counters = m_tags[static_cast<size_t>(tag)];
+    MemoryTagStats stats;
+    stats.heapBytes = counters.heap.bytes.load(std::memory_order_relaxed);
+    stats.heapPeak = counters.heap.peak.load(std::memory_order_relaxed);
+    stats.gpuBytes = counters.gpu.bytes.load(std::memory_order_relaxed);
+    stats.gpuPeak = counters.gpu.peak.load(std::memory_order_relaxed);
+    stats.allocations = counters.allocations.load(std::memory_order_relaxed);
+    stats.budget = counters.budget.load(std::memory_order_relaxed);
+    return stats;
+}
+
+MemoryTagStats MemoryTracker::GetTotalStats() const {
+    MemoryTagStats total;
+    for (size_t i = 0; i < static_cast<size_t>(MemoryTag::Count); i++) {
+        MemoryTagStats stats = GetStats(static_cast<MemoryTag>(i));
+        total.heapBytes += stats.heapBytes;
+        total.heapPeak += stats.heapPeak;
+        total.gpuBytes += stats.gpuBytes;
+        total.gpuPeak += stats.gpuPeak;
+        total.allocations += stats.allocations;
+        total.budget += stats.budget;
+    }
+    return total;
+}
+
+const char* MemoryTracker::GetTagName(MemoryTag tag) {
+    size_t index = static_cast<size_t>(tag);
+    return index < static_cast<size_t>(MemoryTag::Count) ? g_tagNames[index] : "Unknown";
+}
+
+bool MemoryTracker::FindTag(const char* name, MemoryTag& out) {
+    for (size_t i = 0; i < static_cast<size_t>(MemoryTag::Count); i++) {
+        const char* a = g_tagNames[i];
+        const char* b = name;
+        while (*a && *b && std::tolower(static_cast<unsigned char>(*a)) == std::tolower(static_cast<unsigned char>(*b))) {
+            a++;
+            b++;
+        }
+        if (*a == '\0' && *b == '\0') {
+            out = static_cast<MemoryTag>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace Genesis
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace Genesis {
+
+// Subsystem a tracked allocation is charged to
+enum class MemoryTag : uint8_t {
+    General,
+    Meshes,         // Mesh vertex/index copies and GL buffers
+    Textures,       // Streamed textures, lightmap, shadow maps
+    Materials,      // Material property maps
+    World,          // StaticWorldRenderer object arrays
+    Map,            // Map brushes and entities
+    Console,        // Console scrollback
+    Count
+};
+
+struct MemoryTagStats {
+    int64_t heapBytes = 0;
+    int64_t heapPeak = 0;
+    int64_t gpuBytes = 0;
+    int64_t gpuPeak = 0;
+    uint64_t allocations = 0;       // Heap allocations so far
+    int64_t budget = 0;             // Heap + GPU bytes, 0 = none
+
+    int64_t GetTotal() const { return heapBytes + gpuBytes; }
+    bool IsOverBudget() const { return budget > 0 && GetTotal() > budget; }
+};
+
+// ============================================================================
+// MemoryTracker - Live and peak bytes per subsystem, heap and GPU
+//
+// Heap bytes come from containers using TaggedAllocator (TaggedVector and
+// friends) and from AddHeap/RemoveHeap where a subsystem allocates on its
+// own; GPU bytes from the code that sizes GL buffers and textures. Only
+// what is routed through here is counted: nested allocations of stored
+// elements (strings, per-object vectors) stay untracked.
+//
+// A tag over its budget logs a warning once each time it crosses it and
+// shows in the debug overlay; nothing is refused.
+//
+// Counters are atomics, safe from any thread. The tracker is constant
+// initialized and trivially destructible, so containers of other
+// singletons may still free into it during static destruction.
+// ============================================================================
+class MemoryTracker {
+public:
+    static MemoryTracker& Instance() {
+        static MemoryTracker instance;
+        return instance;
+    }
+
+    void AddHeap(MemoryTag tag, size_t bytes);
+    void RemoveHeap(MemoryTag tag, size_t bytes);
+    void AddGpu(MemoryTag tag, size_t bytes);
+    void RemoveGpu(MemoryTag tag, size_t bytes);
+
+    void SetBudget(MemoryTag tag, int64_t bytes);
+
+    MemoryTagStats GetStats(MemoryTag tag) const;
+    MemoryTagStats GetTotalStats() const;      // Peaks are the sums of per-tag peaks
+
+    static const char* GetTagName(MemoryTag tag);
+    static bool FindTag(const char* name, MemoryTag& out);   // Case insensitive
+
+private:
+    constexpr MemoryTracker() = default;
+
+    struct Counter {
+        std::atomic<int64_t> bytes{0};
+        std::atomic<int64_t> peak{0};
+    };
+
+    struct TagCounters {
+        Counter heap;
+        Counter gpu;
+        std::atomic<uint64_t> allocations{0};
+        std::atomic<int64_t> budget{0};
+        std::atomic<bool> overBudget{false};
+    };
+
+    void Add(MemoryTag tag, Counter& counter, int64_t bytes);
+    void CheckBudget(MemoryTag tag);
+
+private:
+    TagCounters m_tags[static_cast<size_t>(MemoryTag::Count)];
+};
+
+// ============================================================================
+// TaggedAllocator - std::allocator that charges MemoryTracker under Tag
+// ============================================================================
+template<typename T, MemoryTag Tag>
+struct TaggedAllocator {
+    using value_type = T;
+
+    // The tag is a non-type parameter, so allocator_traits needs it spelled out
+    template<typename U>
+    struct rebind {
+        using other = TaggedAllocator<U, Tag>;
+    };
+
+    TaggedAllocator() noexcept = default;
+    template<typename U>
+    TaggedAllocator(const TaggedAllocator<U, Tag>&) noexcept {}
+
+    T* allocate(size_t count) {
+        T* data = std::allocator<T>().allocate(count);
+        MemoryTracker::Instance().AddHeap(Tag, count * sizeof(T));
+        return data;
+    }
+
+    void deallocate(T* data, size_t count) noexcept {
+        MemoryTracker::Instance().RemoveHeap(Tag, count * sizeof(T));
+        std::allocator<T>().deallocate(data, count);
+    }
+
+    template<typename U>
+    bool operator==(const TaggedAllocator<U, Tag>&) const noexcept { return true; }
+    template<typename U>
+    bool operator!=(const TaggedAllocator<U, Tag>&) const noexcept { return false; }
+};
+
+template<typename T, MemoryTag Tag>
+using TaggedVector = std::vector<T, TaggedAllocator<T, Tag>>;
+
+} // namespace Genesis
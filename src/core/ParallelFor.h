@@ -0,0 +1,82 @@
+#pragma once
+
+#include "JobSystem.h"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace Genesis {
+
+// ============================================================================
+// ParallelFor - Split an index range across worker threads
+//
+// Workers pull fixed-size batches from a shared counter, so uneven work
+// balances itself. The calling thread takes part and the call returns once
+// every batch has run. The body must not touch GL or other main-thread-only
+// state.
+//
+// Runs on the engine's JobSystem when it is up; otherwise (tools, or an
+// explicit maxThreads) it spawns threads for the duration of the call.
+//
+// Usage:
+//   ParallelFor(brushes.size(), 64, [&](size_t begin, size_t end) {
+//       for (size_t i = begin; i < end; i++) Build(brushes[i]);
+//   });
+// ============================================================================
+
+// Worker threads worth using for this machine (including the caller)
+inline size_t GetParallelThreadCount() {
+    if (JobSystem::Instance().IsRunning()) {
+        return JobSystem::Instance().GetThreadCount();
+    }
+    unsigned int hw = std::thread::hardware_concurrency();
+    return hw > 0 ? static_cast<size_t>(hw) : 1;
+}
+
+template<typename Fn>
+void ParallelFor(size_t count, size_t batchSize, Fn&& fn, size_t maxThreads = 0) {
+    if (count == 0) return;
+
+    auto& jobs = JobSystem::Instance();
+    if (maxThreads == 0 && jobs.IsRunning()) {
+        jobs.ParallelFor(count, batchSize, std::forward<Fn>(fn));
+        return;
+    }
+
+    batchSize = std::max<size_t>(batchSize, 1);
+
+    size_t batches = (count + batchSize - 1) / batchSize;
+    size_t threads = maxThreads > 0 ? maxThreads : GetParallelThreadCount();
+    threads = std::min(threads, batches);
+
+    if (threads <= 1) {
+        fn(size_t(0), count);
+        return;
+    }
+
+    std::atomic<size_t> next{0};
+    auto worker = [&]() {
+        for (;;) {
+            size_t batch = next.fetch_add(1, std::memory_order_relaxed);
+            if (batch >= batches) break;
+            size_t begin = batch * batchSize;
+            fn(begin, std::min(begin + batchSize, count));
+        }
+    };
+
+    std::vector<std::thread> pool;
+    pool.reserve(threads - 1);
+    for (size_t i = 1; i < threads; i++) {
+        pool.emplace_back(worker);
+    }
+    worker();
+
+    for (auto& thread : pool) {
+        thread.join();
+    }
+}
+
+} // namespace Genesis
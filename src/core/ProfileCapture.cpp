@@ -0,0 +1,212 @@
+#include "ProfileCapture.h"
+
+#if defined(GENESIS_PROFILER_ENABLED)
+
+#include "Logger.h"
+
+namespace Genesis {
+
+namespace {
+    // Zone and counter names are literals, but __func__ zones or thread
+    // names could still hold characters JSON needs escaped
+    void WriteJsonString(std::FILE* file, const char* text) {
+        std::fputc('"', file);
+        for (const char* c = text; *c; c++) {
+            if (*c == '"' || *c == '\\') {
+                std::fputc('\\', file);
+                std::fputc(*c, file);
+            } else if (static_cast<unsigned char>(*c) < 0x20) {
+                std::fprintf(file, "\\u%04x", static_cast<unsigned char>(*c));
+            } else {
+                std::fputc(*c, file);
+            }
+        }
+        std::fputc('"', file);
+    }
+
+    constexpr uint32_t TRACE_PID = 1;
+}
+
+ProfileCapture::~ProfileCapture() {
+    Shutdown();
+}
+
+bool ProfileCapture::Start(uint32_t frames, const std::string& path) {
+    if (frames == 0 || IsBusy()) return false;
+    JoinWriter();
+
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        LOG_ERROR("Profiler", "Failed to create capture file: " + path);
+        return false;
+    }
+
+    m_path = path;
+    m_framesLeft = frames;
+    m_frame = CapturedFrame();
+    m_state = State::Armed;
+
+    m_writing = true;
+    m_writer = std::thread(&ProfileCapture::WriterMain, this, file);
+    return true;
+}
+
+void ProfileCapture::Shutdown() {
+    if (m_state != State::Idle) {
+        Finish(Profiler::Instance().GetThreadNames());
+    }
+    JoinWriter();
+}
+
+void ProfileCapture::JoinWriter() {
+    if (m_writer.joinable()) {
+        m_writer.join();
+    }
+}
+
+// ============================================================================
+// Recording (main thread)
+// ============================================================================
+
+void ProfileCapture::AddCounter(const char* name, double value) {
+    if (m_state != State::Recording) return;
+    m_frame.counters.push_back(CapturedValue{name, value, Profiler::Now()});
+}
+
+void ProfileCapture::AddGpuPass(const char* name, double milliseconds) {
+    if (m_state != State::Recording) return;
+    m_frame.gpuPasses.push_back(CapturedValue{name, milliseconds, Profiler::Now()});
+}
+
+void ProfileCapture::AddZones(uint32_t thread, const std::vector<ProfileEvent>& events) {
+    if (m_state != State::Recording) return;
+    for (const ProfileEvent& event : events) {
+        m_frame.zones.push_back(CapturedZone{event, thread});
+    }
+}
+
+void ProfileCapture::EndFrame(const std::vector<std::string>& threadNames) {
+    if (m_state == State::Armed) {
+        // Zones drained by this EndFrame belong to the frame before the
+        // capture; everything from here on is recorded
+        m_state = State::Recording;
+        m_originNs = Profiler::Now();
+        return;
+    }
+    if (m_state != State::Recording) return;
+
+    if (--m_framesLeft == 0) {
+        Finish(threadNames);
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_queue.push_back(std::move(m_frame));
+    m_frame = CapturedFrame();
+    m_ready.notify_one();
+}
+
+void ProfileCapture::Finish(const std::vector<std::string>& threadNames) {
+    m_frame.threadNames = threadNames;
+    m_frame.last = true;
+    m_state = State::Idle;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_queue.push_back(std::move(m_frame));
+    m_frame = CapturedFrame();
+    m_ready.notify_one();
+}
+
+// ============================================================================
+// Writer thread
+// ============================================================================
+
+void ProfileCapture::WriterMain(std::FILE* file) {
+    std::fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", file);
+    bool first = true;
+    size_t frames = 0;
+
+    for (;;) {
+        CapturedFrame frame;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_ready.wait(lock, [this] { return !m_queue.empty(); });
+            frame = std::move(m_queue.front());
+            m_queue.pop_front();
+        }
+
+        WriteFrame(file, frame, first);
+        frames++;
+        if (frame.last) break;
+    }
+
+    std::fputs("\n]}\n", file);
+    bool ok = std::ferror(file) == 0;
+    ok = std::fclose(file) == 0 && ok;
+
+    if (ok) {
+        LOG_INFO("Profiler", "Wrote " + std::to_string(frames) + " frames to " + m_path);
+    } else {
+        LOG_ERROR("Profiler", "Failed to write capture file: " + m_path);
+    }
+    m_writing = false;
+}
+
+void ProfileCapture::WriteFrame(std::FILE* file, const CapturedFrame& frame, bool& first) {
+    auto separator = [&]() {
+        if (!first) std::fputs(",\n", file);
+        first = false;
+    };
+    // Trace timestamps are microseconds from the start of the capture
+    auto micros = [this](uint64_t ns) {
+        return (static_cast<double>(ns) - static_cast<double>(m_originNs)) / 1000.0;
+    };
+
+    for (const CapturedZone& zone : frame.zones) {
+        separator();
+        std::fputs("{\"ph\":\"X\",\"name\":", file);
+        WriteJsonString(file, zone.event.name);
+        std::fprintf(file, ",\"pid\":%u,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                     TRACE_PID, zone.thread, micros(zone.event.startNs),
+                     static_cast<double>(zone.event.endNs - zone.event.startNs) / 1000.0);
+    }
+
+    for (const CapturedValue& counter : frame.counters) {
+        separator();
+        std::fputs("{\"ph\":\"C\",\"name\":", file);
+        WriteJsonString(file, counter.name);
+        std::fprintf(file, ",\"pid\":%u,\"ts\":%.3f,\"args\":{\"value\":%g}}",
+                     TRACE_PID, micros(counter.timeNs), counter.value);
+    }
+
+    // All GPU passes of a frame on one stacked counter track (milliseconds;
+    // GpuTimers reports them a few frames after the CPU side)
+    if (!frame.gpuPasses.empty()) {
+        separator();
+        std::fprintf(file, "{\"ph\":\"C\",\"name\":\"GPU ms\",\"pid\":%u,\"ts\":%.3f,\"args\":{",
+                     TRACE_PID, micros(frame.gpuPasses.front().timeNs));
+        for (size_t i = 0; i < frame.gpuPasses.size(); i++) {
+            if (i > 0) std::fputc(',', file);
+            WriteJsonString(file, frame.gpuPasses[i].name);
+            std::fprintf(file, ":%.4f", frame.gpuPasses[i].value);
+        }
+        std::fputs("}}", file);
+    }
+
+    for (size_t i = 0; i < frame.threadNames.size(); i++) {
+        separator();
+        std::fprintf(file, "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":%u,\"tid\":%zu,\"args\":{\"name\":",
+                     TRACE_PID, i);
+        WriteJsonString(file, frame.threadNames[i].c_str());
+        std::fputs("}}", file);
+    }
+    if (frame.last) {
+        separator();
+        std::fprintf(file, "{\"ph\":\"M\",\"name\":\"process_name\",\"pid\":%u,\"args\":{\"name\":\"Genesis Engine\"}}",
+                     TRACE_PID);
+    }
+}
+
+} // namespace Genesis
+
+#endif // GENESIS_PROFILER_ENABLED
@@ -0,0 +1,111 @@
+#pragma once
+
+// ============================================================================
+// ProfileCapture - Record N frames of profiler data to a Chrome trace file
+//
+// Start() arms a capture; it begins at the next frame boundary so only whole
+// frames are recorded. While it runs, Profiler::EndFrame() hands over every
+// zone it drains and the engine adds per-frame counters and GPU pass times.
+// Each finished frame is moved to a writer thread which formats and streams
+// it to disk, so the frames being captured only pay for a vector move.
+//
+// Output is the Chrome trace-event JSON format (chrome://tracing, Perfetto
+// UI, Speedscope): zones become complete ("X") events on one track per
+// profiler thread, counters and GPU times become counter ("C") tracks.
+//
+// Start(), AddCounter() and AddGpuPass() are main thread only.
+// ============================================================================
+
+#if defined(GENESIS_PROFILER_ENABLED)
+
+#include "Profiler.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Genesis {
+
+class ProfileCapture {
+public:
+    static ProfileCapture& Instance() {
+        static ProfileCapture instance;
+        return instance;
+    }
+
+    // Capture the next 'frames' frames into 'path'. Fails if a capture is
+    // still being recorded or the file can't be created.
+    bool Start(uint32_t frames, const std::string& path);
+
+    // Finish the current capture early and wait for the file to be written
+    void Shutdown();
+
+    // True while frames are being recorded (not while armed or writing)
+    bool IsRecording() const { return m_state == State::Recording; }
+
+    // Recording or still writing the previous capture
+    bool IsBusy() const { return m_state != State::Idle || m_writing.load(); }
+
+    // Values for the frame being recorded; names must be string literals
+    void AddCounter(const char* name, double value);
+    void AddGpuPass(const char* name, double milliseconds);
+
+    // Called by Profiler::EndFrame
+    void AddZones(uint32_t thread, const std::vector<ProfileEvent>& events);
+    void EndFrame(const std::vector<std::string>& threadNames);
+
+private:
+    ProfileCapture() = default;
+    ~ProfileCapture();
+    ProfileCapture(const ProfileCapture&) = delete;
+    ProfileCapture& operator=(const ProfileCapture&) = delete;
+
+    struct CapturedZone {
+        ProfileEvent event;
+        uint32_t thread = 0;
+    };
+
+    struct CapturedValue {
+        const char* name = nullptr;
+        double value = 0.0;
+        uint64_t timeNs = 0;
+    };
+
+    struct CapturedFrame {
+        std::vector<CapturedZone> zones;
+        std::vector<CapturedValue> counters;
+        std::vector<CapturedValue> gpuPasses;
+        std::vector<std::string> threadNames;   // Only on the last frame
+        bool last = false;
+    };
+
+    enum class State { Idle, Armed, Recording };
+
+    void Finish(const std::vector<std::string>& threadNames);
+    void JoinWriter();
+    void WriterMain(std::FILE* file);
+    void WriteFrame(std::FILE* file, const CapturedFrame& frame, bool& first);
+
+private:
+    State m_state = State::Idle;
+    uint32_t m_framesLeft = 0;
+    uint64_t m_originNs = 0;
+    std::string m_path;
+    CapturedFrame m_frame;         // Being recorded (main thread)
+
+    // Writer thread hand-off
+    std::thread m_writer;
+    std::mutex m_mutex;
+    std::condition_variable m_ready;
+    std::deque<CapturedFrame> m_queue;
+    std::atomic<bool> m_writing{false};   // Cleared once the file is closed
+};
+
+} // namespace Genesis
+
+#endif // GENESIS_PROFILER_ENABLED
@@ -0,0 +1,234 @@
+#include "Profiler.h"
+#include "ProfileCapture.h"
+
+#if defined(GENESIS_PROFILER_ENABLED)
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+namespace Genesis {
+
+// Hands the calling thread's ring back to the pool when the thread exits,
+// so short-lived threads (map loads) don't accumulate buffers
+struct ThreadBufferLease {
+    Profiler::ThreadBuffer* buffer = nullptr;
+
+    ~ThreadBufferLease() {
+        if (buffer) {
+            buffer->inUse.store(false, std::memory_order_release);
+        }
+    }
+};
+
+namespace {
+    thread_local ThreadBufferLease t_lease;
+    std::vector<std::string> g_registeredNames;   // Guarded by m_registryMutex
+
+    bool SameName(const char* a, const char* b) {
+        return a == b || std::strcmp(a, b) == 0;
+    }
+}
+
+uint64_t Profiler::Now() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// ============================================================================
+// Recording (any thread)
+// ============================================================================
+
+Profiler::ThreadBuffer* Profiler::GetThreadBuffer() {
+    if (!t_lease.buffer) {
+        t_lease.buffer = AcquireBuffer();
+    }
+    return t_lease.buffer;
+}
+
+Profiler::ThreadBuffer* Profiler::AcquireBuffer() {
+    std::lock_guard<std::mutex> lock(m_registryMutex);
+
+    for (auto& buffer : m_buffers) {
+        if (!buffer->inUse.load(std::memory_order_acquire)) {
+            buffer->inUse.store(true, std::memory_order_relaxed);
+            buffer->depth = 0;
+            g_registeredNames[buffer->index] = "Thread " + std::to_string(buffer->index);
+            return buffer.get();
+        }
+    }
+
+    auto buffer = std::make_unique<ThreadBuffer>();
+    buffer->index = static_cast<uint32_t>(m_buffers.size());
+    g_registeredNames.push_back("Thread " + std::to_string(buffer->index));
+    m_buffers.push_back(std::move(buffer));
+    return m_buffers.back().get();
+}
+
+void Profiler::SetThreadName(const std::string& name) {
+    ThreadBuffer* buffer = GetThreadBuffer();
+    std::lock_guard<std::mutex> lock(m_registryMutex);
+    g_registeredNames[buffer->index] = name;
+}
+
+uint32_t Profiler::BeginZone() {
+    return GetThreadBuffer()->depth++;
+}
+
+void Profiler::EndZone(const char* name, uint64_t startNs, uint32_t depth) {
+    uint64_t endNs = Now();
+    ThreadBuffer* buffer = t_lease.buffer;
+    buffer->depth = depth;
+
+    uint32_t write = buffer->write.load(std::memory_order_relaxed);
+    uint32_t read = buffer->read.load(std::memory_order_acquire);
+    if (write - read >= ThreadBuffer::CAPACITY) {
+        buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    buffer->events[write & (ThreadBuffer::CAPACITY - 1)] = ProfileEvent{name, startNs, endNs, depth};
+    buffer->write.store(write + 1, std::memory_order_release);
+}
+
+// ============================================================================
+// Aggregation (main thread)
+// ============================================================================
+
+void Profiler::EndFrame() {
+    uint64_t now = Now();
+    m_lastFrameNs = m_frameStartNs ? now - m_frameStartNs : 0;
+    m_frameStartNs = now;
+
+    m_lastFrame.clear();
+    m_dropped = 0;
+
+    std::lock_guard<std::mutex> lock(m_registryMutex);
+    m_threadNames = g_registeredNames;
+
+    auto& capture = ProfileCapture::Instance();
+
+    for (auto& buffer : m_buffers) {
+        uint32_t write = buffer->write.load(std::memory_order_acquire);
+        uint32_t read = buffer->read.load(std::memory_order_relaxed);
+
+        m_scratch.clear();
+        for (uint32_t i = read; i != write; i++) {
+            m_scratch.push_back(buffer->events[i & (ThreadBuffer::CAPACITY - 1)]);
+        }
+        buffer->read.store(write, std::memory_order_release);
+        m_dropped += buffer->dropped.exchange(0, std::memory_order_relaxed);
+
+        if (!m_scratch.empty()) {
+            capture.AddZones(buffer->index, m_scratch);
+            BuildTree(buffer->index, m_scratch);
+        }
+    }
+
+    capture.EndFrame(m_threadNames);
+}
+
+void Profiler::BuildTree(uint32_t thread, std::vector<ProfileEvent>& events) {
+    // Zones arrive innermost-first (on scope exit); by start time parents
+    // come before their children
+    std::sort(events.begin(), events.end(), [](const ProfileEvent& a, const ProfileEvent& b) {
+        return a.startNs != b.startNs ? a.startNs < b.startNs : a.depth < b.depth;
+    });
+
+    struct BuildNode {
+        ProfileNode node;
+        int32_t firstChild = -1;
+        int32_t lastChild = -1;
+        int32_t next = -1;
+    };
+    std::vector<BuildNode> nodes(1);   // [0] = thread root
+    std::vector<int32_t> stack = {0};  // stack[level] = parent for zones at that depth
+
+    for (const ProfileEvent& event : events) {
+        // Parents that closed in an earlier frame are gone: attach higher up
+        size_t level = std::min<size_t>(event.depth, stack.size() - 1);
+        int32_t parent = stack[level];
+
+        int32_t child = nodes[parent].firstChild;
+        while (child >= 0 && !SameName(nodes[child].node.name, event.name)) {
+            child = nodes[child].next;
+        }
+
+        if (child < 0) {
+            child = static_cast<int32_t>(nodes.size());
+            BuildNode created;
+            created.node.name = event.name;
+            created.node.thread = thread;
+            created.node.depth = static_cast<uint32_t>(level);
+            nodes.push_back(created);
+
+            if (nodes[parent].lastChild >= 0) {
+                nodes[nodes[parent].lastChild].next = child;
+            } else {
+                nodes[parent].firstChild = child;
+            }
+            nodes[parent].lastChild = child;
+        }
+
+        nodes[child].node.calls++;
+        nodes[child].node.totalNs += event.endNs - event.startNs;
+
+        stack.resize(level + 1);
+        stack.push_back(child);
+    }
+
+    // Depth-first into m_lastFrame
+    std::vector<int32_t> pending;
+    for (int32_t c = nodes[0].firstChild; c >= 0; c = nodes[c].next) {
+        pending.push_back(c);
+    }
+    std::reverse(pending.begin(), pending.end());
+
+    while (!pending.empty()) {
+        int32_t index = pending.back();
+        pending.pop_back();
+        m_lastFrame.push_back(nodes[index].node);
+
+        size_t mark = pending.size();
+        for (int32_t c = nodes[index].firstChild; c >= 0; c = nodes[c].next) {
+            pending.push_back(c);
+        }
+        std::reverse(pending.begin() + mark, pending.end());
+    }
+}
+
+std::vector<std::string> Profiler::FormatLastFrame() const {
+    std::vector<std::string> lines;
+    char line[160];
+
+    std::snprintf(line, sizeof(line), "Frame: %.2f ms", GetLastFrameMilliseconds());
+    lines.push_back(line);
+
+    uint32_t thread = UINT32_MAX;
+    for (const ProfileNode& node : m_lastFrame) {
+        if (node.thread != thread) {
+            thread = node.thread;
+            const char* threadName = thread < m_threadNames.size() ? m_threadNames[thread].c_str() : "?";
+            lines.push_back(std::string("[") + threadName + "]");
+        }
+
+        std::string label(2 + node.depth * 2, ' ');
+        label += node.name;
+        if (node.calls > 1) {
+            std::snprintf(line, sizeof(line), "%-32s %8.3f ms  x%u", label.c_str(), node.GetMilliseconds(), node.calls);
+        } else {
+            std::snprintf(line, sizeof(line), "%-32s %8.3f ms", label.c_str(), node.GetMilliseconds());
+        }
+        lines.push_back(line);
+    }
+
+    if (m_dropped > 0) {
+        lines.push_back("(" + std::to_string(m_dropped) + " zones dropped, ring full)");
+    }
+    return lines;
+}
+
+} // namespace Genesis
+
+#endif // GENESIS_PROFILER_ENABLED
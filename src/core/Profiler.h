@@ -0,0 +1,156 @@
+#pragma once
+
+// ============================================================================
+// Profiler - Scoped CPU zones aggregated into a per-frame hierarchy
+//
+// GENESIS_PROFILE_SCOPE("Name") times the enclosing scope. Each thread
+// writes finished zones into its own fixed-size ring (single producer, no
+// locks); Engine::Run calls GENESIS_PROFILE_FRAME() once per frame, which
+// drains every ring on the main thread and merges the zones into a tree per
+// thread (same name under the same parent = one node, calls summed).
+//
+// Zone names must be string literals (stored by pointer). Timing uses
+// steady_clock. Only built when GENESIS_PROFILER_ENABLED is defined (CMake
+// option GENESIS_PROFILER, off for Release); otherwise every macro expands
+// to nothing and this header declares nothing.
+//
+// Usage:
+//   void StaticWorldRenderer::Render(...) {
+//       GENESIS_PROFILE_SCOPE("World Render");
+//       ...
+//   }
+//   for (auto& node : Profiler::Instance().GetLastFrame()) { ... }
+// ============================================================================
+
+#if defined(GENESIS_PROFILER_ENABLED)
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Genesis {
+
+// One finished zone on one thread
+struct ProfileEvent {
+    const char* name = nullptr;
+    uint64_t startNs = 0;
+    uint64_t endNs = 0;
+    uint32_t depth = 0;
+};
+
+// Aggregated zone in the last frame's tree (GetLastFrame() is depth-first)
+struct ProfileNode {
+    const char* name = nullptr;
+    uint32_t thread = 0;       // Index into GetThreadNames()
+    uint32_t depth = 0;
+    uint32_t calls = 0;
+    uint64_t totalNs = 0;
+
+    double GetMilliseconds() const { return static_cast<double>(totalNs) / 1.0e6; }
+};
+
+class Profiler {
+public:
+    static Profiler& Instance() {
+        static Profiler instance;
+        return instance;
+    }
+
+    static uint64_t Now();
+
+    // Called by ProfileScope
+    uint32_t BeginZone();
+    void EndZone(const char* name, uint64_t startNs, uint32_t depth);
+
+    // Drain all threads and rebuild the last-frame tree (main thread)
+    void EndFrame();
+
+    // Label the calling thread in the output
+    void SetThreadName(const std::string& name);
+
+    const std::vector<ProfileNode>& GetLastFrame() const { return m_lastFrame; }
+    const std::vector<std::string>& GetThreadNames() const { return m_threadNames; }
+    double GetLastFrameMilliseconds() const { return m_lastFrameNs / 1.0e6; }
+    uint32_t GetDroppedEvents() const { return m_dropped; }
+
+    // Indented text, one line per node
+    std::vector<std::string> FormatLastFrame() const;
+
+private:
+    Profiler() = default;
+
+    struct ThreadBuffer {
+        static constexpr uint32_t CAPACITY = 1u << 14;
+
+        ProfileEvent events[CAPACITY];
+        std::atomic<uint32_t> write{0};    // Owner thread only
+        std::atomic<uint32_t> read{0};     // EndFrame only
+        std::atomic<uint32_t> dropped{0};
+        std::atomic<bool> inUse{true};
+        uint32_t depth = 0;                // Owner thread only
+        uint32_t index = 0;
+    };
+
+    ThreadBuffer* GetThreadBuffer();
+    ThreadBuffer* AcquireBuffer();
+    void BuildTree(uint32_t thread, std::vector<ProfileEvent>& events);
+
+    friend struct ThreadBufferLease;
+
+private:
+    std::mutex m_registryMutex;   // Thread registration only
+    std::vector<std::unique_ptr<ThreadBuffer>> m_buffers;
+    std::vector<std::string> m_threadNames;
+
+    // Main thread only
+    std::vector<ProfileEvent> m_scratch;
+    std::vector<ProfileNode> m_lastFrame;
+    uint64_t m_frameStartNs = 0;
+    uint64_t m_lastFrameNs = 0;
+    uint32_t m_dropped = 0;
+};
+
+// ============================================================================
+// ProfileScope - RAII zone; use through GENESIS_PROFILE_SCOPE
+// ============================================================================
+class ProfileScope {
+public:
+    explicit ProfileScope(const char* name)
+        : m_name(name)
+        , m_depth(Profiler::Instance().BeginZone())
+        , m_start(Profiler::Now()) {}
+
+    ~ProfileScope() {
+        Profiler::Instance().EndZone(m_name, m_start, m_depth);
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    const char* m_name;
+    uint32_t m_depth;
+    uint64_t m_start;
+};
+
+} // namespace Genesis
+
+#define GENESIS_PROFILE_CONCAT_INNER(a, b) a##b
+#define GENESIS_PROFILE_CONCAT(a, b) GENESIS_PROFILE_CONCAT_INNER(a, b)
+
+#define GENESIS_PROFILE_SCOPE(name) ::Genesis::ProfileScope GENESIS_PROFILE_CONCAT(profileScope_, __LINE__)(name)
+#define GENESIS_PROFILE_FUNCTION() GENESIS_PROFILE_SCOPE(__func__)
+#define GENESIS_PROFILE_FRAME() ::Genesis::Profiler::Instance().EndFrame()
+#define GENESIS_PROFILE_THREAD(name) ::Genesis::Profiler::Instance().SetThreadName(name)
+
+#else
+
+#define GENESIS_PROFILE_SCOPE(name) ((void)0)
+#define GENESIS_PROFILE_FUNCTION() ((void)0)
+#define GENESIS_PROFILE_FRAME() ((void)0)
+#define GENESIS_PROFILE_THREAD(name) ((void)0)
+
+#endif
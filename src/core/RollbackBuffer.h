@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace Genesis {
+
+// ============================================================================
+// RollbackBuffer - Fixed-size state history keyed by tick
+//
+// One contiguous block of `capacity` slots of `stateSize` bytes; tick t lives
+// in slot t % capacity, so saving never allocates and a tick older than the
+// window simply stops resolving. States are plain bytes (POD snapshots such
+// as PlayerControllerSnapshot), copied in and out with memcpy.
+// ============================================================================
+class RollbackBuffer {
+public:
+    static constexpr uint64_t INVALID_TICK = ~0ull;
+
+    void Initialize(uint32_t capacity, size_t stateSize) {
+        m_capacity = capacity;
+        m_stateSize = stateSize;
+        m_data.assign(static_cast<size_t>(capacity) * stateSize, 0);
+        m_ticks.assign(capacity, INVALID_TICK);
+    }
+
+    void Clear() {
+        m_ticks.assign(m_capacity, INVALID_TICK);
+    }
+
+    // Slot to fill with the state at `tick` (replaces tick - capacity)
+    void* Write(uint64_t tick) {
+        if (m_capacity == 0) return nullptr;
+        uint32_t slot = static_cast<uint32_t>(tick % m_capacity);
+        m_ticks[slot] = tick;
+        return m_data.data() + static_cast<size_t>(slot) * m_stateSize;
+    }
+
+    void Save(uint64_t tick, const void* state) {
+        if (void* slot = Write(tick)) {
+            std::memcpy(slot, state, m_stateSize);
+        }
+    }
+
+    // State at `tick`, or nullptr if it was never saved or has been overwritten
+    const void* Read(uint64_t tick) const {
+        if (!Has(tick)) return nullptr;
+        return m_data.data() + static_cast<size_t>(tick % m_capacity) * m_stateSize;
+    }
+
+    bool Has(uint64_t tick) const {
+        return m_capacity > 0 && tick != INVALID_TICK && m_ticks[tick % m_capacity] == tick;
+    }
+
+    uint32_t GetCapacity() const { return m_capacity; }
+    size_t GetStateSize() const { return m_stateSize; }
+
+private:
+    uint32_t m_capacity = 0;
+    size_t m_stateSize = 0;
+    std::vector<uint8_t> m_data;
+    std::vector<uint64_t> m_ticks;   // Tick held by each slot
+};
+
+} // namespace Genesis
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Genesis {
+
+// ============================================================================
+// Slot Handle - Stable reference to an element of a SlotMap
+//
+// 'index' names a slot that never moves; 'generation' changes every time the
+// slot is freed, so a handle to a removed element stops resolving instead of
+// silently pointing at whatever reused the slot.
+// ============================================================================
+struct SlotHandle {
+    static constexpr uint32_t INVALID_INDEX = 0xFFFFFFFFu;
+
+    uint32_t index = INVALID_INDEX;
+    uint32_t generation = 0;
+
+    bool IsValid() const { return index != INVALID_INDEX; }
+
+    bool operator==(const SlotHandle& other) const {
+        return index == other.index && generation == other.generation;
+    }
+    bool operator!=(const SlotHandle& other) const { return !(*this == other); }
+};
+
+// ============================================================================
+// SlotMap - Generational handles over densely packed elements
+//
+// Only the bookkeeping lives here; the owner keeps its element arrays (one or
+// several, struct-of-arrays style) packed at dense indices [0, Size()):
+//
+//   Insert()  -> owner appends the element at dense index Size() - 1
+//   Remove(h) -> owner moves its last element into the returned dense index
+//                and pops (the same swap-remove SlotMap did on its side)
+//
+// Both are O(1). Slot indices are stable for the element's lifetime, so
+// they can key side tables (BVH leaves etc.) that must not move.
+//
+// Usage:
+//   SlotHandle h = slots.Insert();   objects.push_back(obj);
+//   uint32_t hole = slots.Remove(h);
+//   objects[hole] = std::move(objects.back()); objects.pop_back();
+// ============================================================================
+class SlotMap {
+public:
+    static constexpr uint32_t INVALID_INDEX = SlotHandle::INVALID_INDEX;
+
+    SlotHandle Insert() {
+        uint32_t slot;
+        if (!m_freeSlots.empty()) {
+            slot = m_freeSlots.back();
+            m_freeSlots.pop_back();
+        } else {
+            slot = static_cast<uint32_t>(m_slots.size());
+            m_slots.emplace_back();
+        }
+
+        m_slots[slot].dense = static_cast<uint32_t>(m_denseToSlot.size());
+        m_denseToSlot.push_back(slot);
+        return SlotHandle{slot, m_slots[slot].generation};
+    }
+
+    // Free the handle's slot. Returns the dense index the owner must refill
+    // with its last element (equal to the new Size() when it was the last),
+    // or INVALID_INDEX if the handle was stale.
+    uint32_t Remove(SlotHandle handle) {
+        if (!IsAlive(handle)) return INVALID_INDEX;
+
+        Slot& slot = m_slots[handle.index];
+        uint32_t hole = slot.dense;
+        uint32_t lastSlot = m_denseToSlot.back();
+
+        m_denseToSlot[hole] = lastSlot;
+        m_slots[lastSlot].dense = hole;
+        m_denseToSlot.pop_back();
+
+        slot.dense = INVALID_INDEX;
+        slot.generation++;
+        m_freeSlots.push_back(handle.index);
+        return hole;
+    }
+
+    bool IsAlive(SlotHandle handle) const {
+        return handle.index < m_slots.size() &&
+               m_slots[handle.index].generation == handle.generation &&
+               m_slots[handle.index].dense != INVALID_INDEX;
+    }
+
+    // Dense index of a live handle, or INVALID_INDEX
+    uint32_t GetDenseIndex(SlotHandle handle) const {
+        return IsAlive(handle) ? m_slots[handle.index].dense : INVALID_INDEX;
+    }
+
+    // Dense index by raw slot (for side tables keyed by slot), or INVALID_INDEX
+    uint32_t GetDenseIndexOfSlot(uint32_t slot) const {
+        return slot < m_slots.size() ? m_slots[slot].dense : INVALID_INDEX;
+    }
+
+    SlotHandle GetHandle(uint32_t dense) const {
+        uint32_t slot = m_denseToSlot[dense];
+        return SlotHandle{slot, m_slots[slot].generation};
+    }
+
+    uint32_t GetSlot(uint32_t dense) const { return m_denseToSlot[dense]; }
+
+    // Live elements (dense range)
+    uint32_t Size() const { return static_cast<uint32_t>(m_denseToSlot.size()); }
+
+    // Slots ever allocated (live + free); side tables keyed by slot use this
+    uint32_t GetSlotCount() const { return static_cast<uint32_t>(m_slots.size()); }
+    uint32_t GetFreeCount() const { return static_cast<uint32_t>(m_freeSlots.size()); }
+
+    void Reserve(size_t count) {
+        m_slots.reserve(count);
+        m_denseToSlot.reserve(count);
+    }
+
+    // Remove everything. Generations are kept so old handles stay stale.
+    void Clear() {
+        for (uint32_t slot : m_denseToSlot) {
+            m_slots[slot].dense = INVALID_INDEX;
+            m_slots[slot].generation++;
+            m_freeSlots.push_back(slot);
+        }
+        m_denseToSlot.clear();
+    }
+
+private:
+    struct Slot {
+        uint32_t dense = INVALID_INDEX;
+        uint32_t generation = 0;
+    };
+
+    std::vector<Slot> m_slots;
+    std::vector<uint32_t> m_denseToSlot;
+    std::vector<uint32_t> m_freeSlots;
+};
+
+} // namespace Genesis
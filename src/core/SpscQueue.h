@@ -0,0 +1,67 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace Genesis {
+
+// ============================================================================
+// SpscQueue - Bounded lock-free single-producer / single-consumer ring
+//
+// Exactly one thread pushes and exactly one thread pops (they may be the
+// same thread). The producer owns m_tail and the consumer owns m_head; each
+// only reads the other's index, with release/acquire pairs publishing the
+// slot contents. Indices run freely and wrap through the power-of-two mask,
+// so a full ring is tail - head == Capacity. Never allocates; a push into a
+// full ring fails and the caller decides what to drop.
+// ============================================================================
+template<typename T, size_t Capacity>
+class SpscQueue {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    // Producer thread only
+    bool TryPush(const T& value) {
+        uint32_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_cachedHead == Capacity) {
+            m_cachedHead = m_head.load(std::memory_order_acquire);
+            if (tail - m_cachedHead == Capacity) return false;
+        }
+        m_slots[tail & MASK] = value;
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer thread only
+    bool TryPop(T& value) {
+        uint32_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_cachedTail) {
+            m_cachedTail = m_tail.load(std::memory_order_acquire);
+            if (head == m_cachedTail) return false;
+        }
+        value = m_slots[head & MASK];
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Approximate from any thread other than the two ends
+    size_t Size() const {
+        return m_tail.load(std::memory_order_acquire) - m_head.load(std::memory_order_acquire);
+    }
+    bool IsEmpty() const { return Size() == 0; }
+    static constexpr size_t GetCapacity() { return Capacity; }
+
+private:
+    static constexpr uint32_t MASK = static_cast<uint32_t>(Capacity - 1);
+
+    // The two ends on separate cache lines, each with a private copy of the
+    // other's index so the shared line is only touched when needed
+    alignas(64) std::atomic<uint32_t> m_head{0};
+    uint32_t m_cachedTail = 0;
+    alignas(64) std::atomic<uint32_t> m_tail{0};
+    uint32_t m_cachedHead = 0;
+    alignas(64) T m_slots[Capacity];
+};
+
+} // namespace Genesis
@@ -0,0 +1,61 @@
+#include "StartupProfile.h"
+#include "Logger.h"
+#include <cstdio>
+
+namespace Genesis {
+
+static double Milliseconds(StartupProfile::Clock::duration duration) {
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+void StartupProfile::Begin() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_begin = Clock::now();
+    m_mainThread = std::this_thread::get_id();
+    m_phases.clear();
+    m_closed = false;
+}
+
+void StartupProfile::Record(const char* name, Clock::time_point start, Clock::time_point end) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Phase phase{name, Milliseconds(start - m_begin), Milliseconds(end - start),
+                std::this_thread::get_id() != m_mainThread};
+    if (!m_closed) {
+        m_phases.push_back(std::move(phase));
+        return;
+    }
+
+    char line[160];
+    std::snprintf(line, sizeof(line), "Late phase %s: %.1f ms (at %.1f ms)", phase.name.c_str(),
+                  phase.durationMs, phase.startMs);
+    LOG_INFO("Startup", line);
+}
+
+void StartupProfile::LogBreakdown() {
+    std::vector<Phase> phases;
+    double totalMs = 0.0;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        phases.swap(m_phases);
+        totalMs = Milliseconds(Clock::now() - m_begin);
+        m_closed = true;
+    }
+
+    // Main thread phases add up to its busy time; background ones overlap it
+    double mainMs = 0.0, backgroundMs = 0.0;
+    for (const Phase& phase : phases) {
+        (phase.background ? backgroundMs : mainMs) += phase.durationMs;
+    }
+
+    char line[160];
+    std::snprintf(line, sizeof(line), "Started in %.1f ms: %.1f ms in main thread phases, "
+                  "%.1f ms of jobs alongside", totalMs, mainMs, backgroundMs);
+    LOG_INFO("Startup", line);
+    for (const Phase& phase : phases) {
+        std::snprintf(line, sizeof(line), "  %-24s %8.1f ms  at %8.1f ms%s", phase.name.c_str(),
+                      phase.durationMs, phase.startMs, phase.background ? "  (job)" : "");
+        LOG_INFO("Startup", line);
+    }
+}
+
+} // namespace Genesis
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Genesis {
+
+// ============================================================================
+// StartupProfile - Where startup time went, logged once Engine::Initialize()
+// is done
+//
+// Phases are timed with a Scope, on the main thread or on job workers
+// (which then overlap the main thread's). LogBreakdown() prints every phase
+// with its start and duration and closes the profile; phases that finish
+// after that (e.g. the deferred font upload) are logged as they end.
+//
+// Usage:
+//   {
+//       StartupProfile::Scope scope("Window");
+//       CreateWindow();
+//   }
+//   StartupProfile::Instance().LogBreakdown();
+// ============================================================================
+class StartupProfile {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static StartupProfile& Instance() {
+        static StartupProfile instance;
+        return instance;
+    }
+
+    class Scope {
+    public:
+        explicit Scope(const char* name) : m_name(name), m_start(Clock::now()) {}
+        ~Scope() { StartupProfile::Instance().Record(m_name, m_start, Clock::now()); }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        const char* m_name;
+        Clock::time_point m_start;
+    };
+
+    // Start of startup (the first call to Instance() otherwise)
+    void Begin();
+
+    void Record(const char* name, Clock::time_point start, Clock::time_point end);
+
+    // Log the phases so far and close the profile
+    void LogBreakdown();
+
+private:
+    StartupProfile() : m_begin(Clock::now()) {}
+
+    struct Phase {
+        std::string name;
+        double startMs;
+        double durationMs;
+        bool background;                // Not on the thread that called Begin()
+    };
+
+private:
+    Clock::time_point m_begin;
+    std::thread::id m_mainThread = std::this_thread::get_id();
+    std::mutex m_mutex;
+    std::vector<Phase> m_phases;
+    bool m_closed = false;
+};
+
+} // namespace Genesis
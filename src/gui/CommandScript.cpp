@@ -0,0 +1,97 @@
+#include "CommandScript.h"
+
+namespace Genesis {
+namespace GUI {
+
+void CommandScript::Clear() {
+    m_text.clear();
+    m_tokens.clear();
+    m_lines.clear();
+}
+
+void CommandScript::EndToken(uint32_t start) {
+    m_tokens.push_back({start, static_cast<uint32_t>(m_text.size()) - start});
+}
+
+void CommandScript::EndLine(uint32_t firstToken) {
+    uint32_t count = static_cast<uint32_t>(m_tokens.size()) - firstToken;
+    if (count > 0) {
+        m_lines.push_back({firstToken, count});
+    }
+}
+
+void CommandScript::Append(std::string_view text) {
+    m_text.reserve(m_text.size() + text.size());
+
+    uint32_t lineStart = static_cast<uint32_t>(m_tokens.size());
+    bool inToken = false;
+    bool inQuotes = false;
+    uint32_t tokenStart = 0;
+
+    for (size_t i = 0; i < text.size(); i++) {
+        char c = text[i];
+
+        if (inQuotes) {
+            if (c == '"' || c == '\n') {
+                inQuotes = false;       // An unterminated quote ends with its line
+                if (c == '\n') {
+                    EndToken(tokenStart);
+                    inToken = false;
+                    EndLine(lineStart);
+                    lineStart = static_cast<uint32_t>(m_tokens.size());
+                }
+            } else {
+                m_text.push_back(c);
+            }
+            continue;
+        }
+
+        bool lineEnd = c == '\n' || c == ';';
+        bool comment = c == '/' && i + 1 < text.size() && text[i + 1] == '/';
+        if (comment) {
+            while (i + 1 < text.size() && text[i + 1] != '\n') i++;
+            lineEnd = true;
+        }
+
+        if (lineEnd || c == ' ' || c == '\t' || c == '\r') {
+            if (inToken) {
+                EndToken(tokenStart);
+                inToken = false;
+            }
+            if (lineEnd) {
+                EndLine(lineStart);
+                lineStart = static_cast<uint32_t>(m_tokens.size());
+            }
+            continue;
+        }
+
+        if (!inToken) {
+            inToken = true;
+            tokenStart = static_cast<uint32_t>(m_text.size());
+        }
+        if (c == '"') {
+            inQuotes = true;            // Quotes join to the token ("a"b = ab)
+        } else {
+            m_text.push_back(c);
+        }
+    }
+
+    if (inToken) EndToken(tokenStart);
+    EndLine(lineStart);
+}
+
+void CommandScript::Append(const CommandScript& other) {
+    uint32_t textBase = static_cast<uint32_t>(m_text.size());
+    uint32_t tokenBase = static_cast<uint32_t>(m_tokens.size());
+
+    m_text += other.m_text;
+    for (const Token& token : other.m_tokens) {
+        m_tokens.push_back({token.offset + textBase, token.length});
+    }
+    for (const Line& line : other.m_lines) {
+        m_lines.push_back({line.firstToken + tokenBase, line.tokenCount});
+    }
+}
+
+} // namespace GUI
+} // namespace Genesis
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Genesis {
+namespace GUI {
+
+// ============================================================================
+// CommandScript - Console command lines tokenized once
+//
+// A whole config file (or a bind, or one typed line) is split into lines
+// and tokens in one pass. Token text is stored unquoted in a single buffer;
+// lines are ranges of tokens, so executing a line just reads views.
+//
+// Syntax (Source style): lines end at a newline or a ';' outside quotes,
+// tokens are separated by spaces/tabs, "quoted text" is one token and
+// "//" outside quotes starts a comment running to the end of the line.
+//
+// Each line has a resolve slot the Console uses to cache what its first
+// token names, so a script executed repeatedly (binds) skips the lookup.
+// ============================================================================
+class CommandScript {
+public:
+    struct Line {
+        uint32_t firstToken;
+        uint32_t tokenCount;
+
+        // Console lookup cache (see Console::ExecuteLine)
+        mutable const void* resolved = nullptr;
+        mutable uint32_t resolvedRevision = 0;
+        mutable bool resolvedConVar = false;
+    };
+
+    CommandScript() = default;
+    explicit CommandScript(std::string_view text) { Append(text); }
+
+    // Tokenize text and append its lines
+    void Append(std::string_view text);
+    void Append(const CommandScript& other);
+    void Clear();
+
+    bool IsEmpty() const { return m_lines.empty(); }
+    size_t GetLineCount() const { return m_lines.size(); }
+    const Line& GetLine(size_t index) const { return m_lines[index]; }
+
+    std::string_view GetToken(const Line& line, uint32_t index) const {
+        const Token& token = m_tokens[line.firstToken + index];
+        return std::string_view(m_text.data() + token.offset, token.length);
+    }
+
+private:
+    struct Token {
+        uint32_t offset;
+        uint32_t length;
+    };
+
+    void EndToken(uint32_t start);
+    void EndLine(uint32_t firstToken);
+
+    std::string m_text;         // Token characters, back to back
+    std::vector<Token> m_tokens;
+    std::vector<Line> m_lines;
+};
+
+} // namespace GUI
+} // namespace Genesis
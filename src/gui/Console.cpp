@@ -1,16 +1,130 @@
 #include "Console.h"
 #include "core/Time.h"
 #include "core/Engine.h"
+#include "core/Profiler.h"
+#include "core/ProfileCapture.h"
 #include <GLFW/glfw3.h>
 #include <algorithm>
 #include <cstdarg>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
 #include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
 #include <sstream>
 #include <iomanip>
 
 namespace Genesis {
 namespace GUI {
 
+namespace {
+
+// Whole-string number ("true"/"false" count as 1/0)
+bool ParseConVarNumber(const std::string& text, double& number) {
+    if (text == "true") { number = 1.0; return true; }
+    if (text == "false") { number = 0.0; return true; }
+    if (text.empty()) return false;
+
+    char* end = nullptr;
+    number = std::strtod(text.c_str(), &end);
+    return end == text.c_str() + text.size() && std::isfinite(number);
+}
+
+int ToConVarInt(double number) {
+    return static_cast<int>(std::clamp(number, static_cast<double>(std::numeric_limits<int>::min()),
+                                       static_cast<double>(std::numeric_limits<int>::max())));
+}
+
+} // anonymous namespace
+
+// ============================================================================
+// ConVar
+// ============================================================================
+
+ConVar::ConVar(const std::string& name, const std::string& defaultValue, const std::string& help, ConVarType type)
+    : m_name(name), m_defaultValue(defaultValue), m_help(help), m_type(type) {
+    if (!SetString(defaultValue)) {
+        m_value = defaultValue;     // Typed default that doesn't parse: reads as 0
+    }
+}
+
+bool ConVar::SetString(const std::string& value) {
+    double number = 0.0;
+    bool numeric = ParseConVarNumber(value, number);
+    if (!numeric && m_type != ConVarType::String) return false;
+
+    std::string text = value;
+    bool flag = number != 0.0;
+    switch (m_type) {
+        case ConVarType::Int:
+            number = std::trunc(number);
+            text = std::to_string(ToConVarInt(number));
+            break;
+        case ConVarType::Bool:
+            number = flag ? 1.0 : 0.0;
+            text = flag ? "1" : "0";
+            break;
+        case ConVarType::Float:
+            break;
+        case ConVarType::String:
+            flag = value == "1" || value == "true";
+            break;
+    }
+    if (text == m_value) return true;
+
+    m_value = std::move(text);
+    m_number = number;
+    m_float = static_cast<float>(number);
+    m_int = ToConVarInt(number);
+    m_bool = flag;
+    WriteBinding();
+
+    // By index and by copy: a callback may add or remove callbacks
+    for (size_t i = 0; i < m_callbacks.size(); i++) {
+        ChangeCallback callback = m_callbacks[i].callback;
+        callback(*this);
+    }
+    return true;
+}
+
+void ConVar::SetInt(int value) {
+    SetString(std::to_string(value));
+}
+
+void ConVar::SetFloat(float value) {
+    SetString(Console::FormatConVarValue(value));
+}
+
+void ConVar::SetBool(bool value) {
+    SetString(value ? "1" : "0");
+}
+
+uint32_t ConVar::AddChangeCallback(ChangeCallback callback) {
+    uint32_t id = m_nextCallbackId++;
+    m_callbacks.push_back({id, std::move(callback)});
+    return id;
+}
+
+void ConVar::RemoveChangeCallback(uint32_t id) {
+    m_callbacks.erase(std::remove_if(m_callbacks.begin(), m_callbacks.end(),
+                                     [id](const Callback& c) { return c.id == id; }),
+                      m_callbacks.end());
+}
+
+void ConVar::WriteBinding() const {
+    if (auto* target = std::get_if<int*>(&m_binding)) **target = m_int;
+    else if (auto* target = std::get_if<float*>(&m_binding)) **target = m_float;
+    else if (auto* target = std::get_if<double*>(&m_binding)) **target = m_number;
+    else if (auto* target = std::get_if<bool*>(&m_binding)) **target = m_bool;
+    else if (auto* target = std::get_if<std::string*>(&m_binding)) **target = m_value;
+}
+
+// ============================================================================
+// Console
+// ============================================================================
+
 void Console::Initialize() {
     if (m_initialized) return;
 
@@ -26,7 +140,17 @@ void Console::Initialize() {
 void Console::Shutdown() {
     m_commands.clear();
     m_convars.clear();
-    m_messages.clear();
+    m_registryRevision++;
+    m_commandBuffer.Clear();
+    m_consoleMode = m_timeScale = m_fov = m_sensitivity = nullptr;
+    m_applyConVars = true;
+    m_scrollback.Clear();
+    m_windowList.Clear();
+    m_messagesList.Clear();
+    m_inputList.Clear();
+    m_lineLayouts.clear();
+    m_lineLayoutSequence.clear();
+    m_messagesDirty = true;
     m_initialized = false;
 }
 
@@ -169,6 +293,17 @@ void Console::RegisterBuiltInCommands() {
         }
     }, "Toggle a boolean variable (0/1)");
 
+    // Exec command - queue a config file (runs before the next ticks)
+    RegisterCommand("exec", [this](const std::vector<std::string>& args) {
+        if (args.size() < 2) {
+            PrintError("Usage: exec <file>");
+            return;
+        }
+        if (!ExecFile(args[1])) {
+            PrintError("Couldn't exec " + args[1]);
+        }
+    }, "Run a config file of console commands");
+
     // Version command
     RegisterCommand("version", [this](const std::vector<std::string>&) {
         Print("Genesis Engine v0.1.0", MessageType::Success);
@@ -176,16 +311,72 @@ void Console::RegisterBuiltInCommands() {
         Print("(c) 2025 Genesis Engine Team", MessageType::Normal);
     }, "Show engine version information");
 
+    // Profiler - Print the last frame's zone tree
+    RegisterCommand("prof_dump", [this](const std::vector<std::string>&) {
+#if defined(GENESIS_PROFILER_ENABLED)
+        for (const auto& line : Profiler::Instance().FormatLastFrame()) {
+            Print(line, MessageType::Normal);
+        }
+#else
+        PrintWarning("Profiler is compiled out of this build (GENESIS_PROFILER)");
+#endif
+    }, "Print the last frame's profiler zones");
+
+    // prof_capture - Write N frames of zones and counters as a Chrome trace
+    RegisterCommand("prof_capture", [this](const std::vector<std::string>& args) {
+#if defined(GENESIS_PROFILER_ENABLED)
+        if (args.size() < 2) {
+            PrintError("Usage: prof_capture <frames> [file]");
+            return;
+        }
+
+        int frames = 0;
+        try {
+            frames = std::stoi(args[1]);
+        } catch (...) {
+            frames = 0;
+        }
+        if (frames <= 0) {
+            PrintError("Frame count must be a positive number");
+            return;
+        }
+
+        std::string path = args.size() > 2 ? args[2] : "profile_capture.json";
+        auto& capture = ProfileCapture::Instance();
+        if (capture.IsBusy()) {
+            PrintWarning("A capture is already in progress");
+            return;
+        }
+        if (!capture.Start(static_cast<uint32_t>(frames), path)) {
+            PrintError("Failed to start capture: " + path);
+            return;
+        }
+        Print("Capturing " + std::to_string(frames) + " frames to " + path, MessageType::Normal);
+#else
+        PrintWarning("Profiler is compiled out of this build (GENESIS_PROFILER)");
+#endif
+    }, "Record N frames of profiler data to a Chrome trace JSON file");
+
     // ge_showinfo - Show debug info on screen
-    RegisterConVar("ge_showinfo", "0", "Show debug info on screen (FPS, position, etc.) - 0 or 1");
+    RegisterConVar("ge_showinfo", "0", "Show debug info on screen (FPS, position, etc.) - 0 or 1", ConVarType::Bool);
 
     // ge_console_mode - Console display mode (0 = docked at top, 1 = floating window)
-    RegisterConVar("ge_console_mode", "0", "Console mode: 0 = docked at top, 1 = floating window");
+    m_consoleMode = RegisterConVar("ge_console_mode", "0", "Console mode: 0 = docked at top, 1 = floating window",
+                                   ConVarType::Int);
+
+    // Other useful convars (pushed to Time/camera on the next Update after a change)
+    m_timeScale = RegisterConVar("ge_timescale", "1.0", "Time scale multiplier", ConVarType::Float);
+    m_fov = RegisterConVar("ge_fov", "70", "Field of view in degrees", ConVarType::Float);
+    m_sensitivity = RegisterConVar("ge_sensitivity", "0.35", "Mouse sensitivity", ConVarType::Float);
+    for (ConVar* cvar : {m_timeScale, m_fov, m_sensitivity}) {
+        cvar->AddChangeCallback([this](const ConVar&) { m_applyConVars = true; });
+    }
+}
 
-    // Other useful convars
-    RegisterConVar("ge_timescale", "1.0", "Time scale multiplier");
-    RegisterConVar("ge_fov", "70", "Field of view in degrees");
-    RegisterConVar("ge_sensitivity", "0.35", "Mouse sensitivity");
+std::string Console::FormatConVarValue(double value) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%g", value);
+    return buffer;
 }
 
 void Console::Update(float deltaTime) {
@@ -203,39 +394,145 @@ void Console::Update(float deltaTime) {
         m_cursorVisible = !m_cursorVisible;
     }
 
-    // Apply convars
-    auto* timescale = FindConVar("ge_timescale");
-    if (timescale) {
-        Time::Instance().SetTimeScale(timescale->GetFloat());
-    }
-
-    auto* fov = FindConVar("ge_fov");
-    if (fov) {
-        Engine::Instance().GetCamera().SetFOV(fov->GetFloat());
-    }
-
-    auto* sensitivity = FindConVar("ge_sensitivity");
-    if (sensitivity) {
-        Engine::Instance().GetCamera().SetMouseSensitivity(sensitivity->GetFloat());
+    // Apply convars (once at startup, then after they change)
+    if (m_applyConVars && m_timeScale) {
+        Time::Instance().SetTimeScale(m_timeScale->GetFloat());
+        Engine::Instance().GetCamera().SetFOV(m_fov->GetFloat());
+        Engine::Instance().GetCamera().SetMouseSensitivity(m_sensitivity->GetFloat());
+        m_applyConVars = false;
     }
 }
 
 void Console::Render(int screenWidth, int screenHeight) {
-    auto* consoleMode = FindConVar("ge_console_mode");
-    int mode = consoleMode ? consoleMode->GetInt() : 0;
+    int mode = m_consoleMode ? m_consoleMode->GetInt() : 0;
 
     if (mode == 1) {
         // Floating mode: show/hide immediately, no animation
         if (!m_isOpen) return;
-        RenderFloating(screenWidth, screenHeight);
+
+        // Clamp window position to screen bounds
+        m_windowX = std::max(0.0f, std::min(m_windowX, static_cast<float>(screenWidth) - m_windowWidth));
+        m_windowY = std::max(0.0f, std::min(m_windowY, static_cast<float>(screenHeight) - m_windowHeight));
     } else {
         // Docked mode: uses animation
         if (m_openAmount < 0.01f) return;
-        RenderDocked(screenWidth, screenHeight);
     }
+
+    RenderLayout layout;
+    layout.screenWidth = screenWidth;
+    layout.screenHeight = screenHeight;
+    layout.mode = mode;
+    layout.openAmount = m_openAmount;
+    layout.scrollOffset = m_scrollOffset;
+    layout.windowX = m_windowX;
+    layout.windowY = m_windowY;
+    layout.windowWidth = m_windowWidth;
+    layout.windowHeight = m_windowHeight;
+    layout.isOpen = m_isOpen;
+
+    bool windowDirty = false;
+    bool inputDirty = false;
+    if (!(layout == m_builtLayout)) {
+        m_builtLayout = layout;
+        windowDirty = true;
+        inputDirty = true;
+        m_messagesDirty = true;
+    }
+    if (m_inputBuffer != m_builtInput) {
+        m_builtInput = m_inputBuffer;
+        inputDirty = true;
+    }
+
+    auto& renderer = GUIRenderer::Instance();
+    if (windowDirty) {
+        renderer.BeginDrawList(m_windowList);
+        if (mode == 1) BuildFloatingWindow();
+        else BuildDockedWindow(screenWidth, screenHeight);
+        renderer.EndDrawList();
+    }
+    if (m_messagesDirty) {
+        renderer.BeginDrawList(m_messagesList);
+        BuildMessages(mode, screenHeight);
+        renderer.EndDrawList();
+        m_messagesDirty = false;
+    }
+    if (inputDirty) {
+        renderer.BeginDrawList(m_inputList);
+        if (mode == 1) BuildFloatingInput();
+        else BuildDockedInput(screenWidth, screenHeight);
+        renderer.EndDrawList();
+    }
+
+    renderer.SubmitDrawList(m_windowList);
+    renderer.SubmitDrawList(m_messagesList);
+    renderer.SubmitDrawList(m_inputList);
+
+    // Cursor
+    if (m_cursorVisible && m_isOpen) {
+        renderer.DrawRect(GetCursorRect(mode, screenHeight),
+                         Vec4(Colors::Accent.x, Colors::Accent.y, Colors::Accent.z, 0.7f));
+    }
+}
+
+void Console::BuildMessages(int mode, int screenHeight) {
+    auto& renderer = GUIRenderer::Instance();
+
+    float inputHeight = 28.0f;
+    float x, messagesTop, messagesBottom;
+    if (mode == 1) {
+        x = m_windowX + 10;
+        messagesTop = m_windowY + 28.0f + 6;
+        messagesBottom = m_windowY + m_windowHeight - inputHeight - 10;
+    } else {
+        x = 8;
+        messagesTop = 30;
+        messagesBottom = screenHeight * m_openAmount - inputHeight - 4;
+    }
+    float messagesHeight = messagesBottom - messagesTop;
+
+    float lineHeight = renderer.GetFontHeight(1.0f) + 2;
+    float y = messagesBottom - lineHeight - 4;
+    int visibleLines = std::max(0, static_cast<int>(messagesHeight / lineHeight));
+
+    // Every visible line needs its own cache slot
+    if (m_lineLayouts.size() < static_cast<size_t>(visibleLines) + 1) {
+        size_t size = 64;
+        while (size < static_cast<size_t>(visibleLines) + 1) size *= 2;
+        m_lineLayouts.resize(size);
+        m_lineLayoutSequence.assign(size, ~0ull);
+    }
+
+    // Newest first, starting at the scroll position, visible lines only
+    size_t first = static_cast<size_t>(m_scrollOffset);
+    for (size_t i = first; i < m_scrollback.Size() && i < first + visibleLines && y > messagesTop; i++) {
+        renderer.SubmitDrawList(GetLineLayout(m_scrollback.GetFromNewest(i)), Vec2(x, y));
+        y -= lineHeight;
+    }
+}
+
+const GUIDrawList& Console::GetLineLayout(const ConsoleLine& line) {
+    size_t slot = static_cast<size_t>(line.sequence % m_lineLayouts.size());
+    if (m_lineLayoutSequence[slot] != line.sequence) {
+        auto& renderer = GUIRenderer::Instance();
+        renderer.BeginDrawList(m_lineLayouts[slot]);
+        renderer.DrawText(line.text, 0, 0, GetMessageColor(line.type), 1.0f);
+        renderer.EndDrawList();
+        m_lineLayoutSequence[slot] = line.sequence;
+    }
+    return m_lineLayouts[slot];
+}
+
+Rect Console::GetCursorRect(int mode, int screenHeight) const {
+    float inputHeight = 28.0f;
+    if (mode == 1) {
+        float inputY = m_windowY + m_windowHeight - inputHeight - 6;
+        return Rect(m_windowX + 26 + m_cursorPos * 8, inputY + 7, 8, 14);
+    }
+    float consoleHeight = screenHeight * m_openAmount;
+    return Rect(24 + m_cursorPos * 8.0f, consoleHeight - inputHeight + 5, 8, 14);
 }
 
-void Console::RenderDocked(int screenWidth, int screenHeight) {
+void Console::BuildDockedWindow(int screenWidth, int screenHeight) {
     auto& renderer = GUIRenderer::Instance();
 
     float consoleHeight = screenHeight * m_openAmount;
@@ -270,19 +567,13 @@ void Console::RenderDocked(int screenWidth, int screenHeight) {
     Rect messagesRect(4, messagesTop, static_cast<float>(screenWidth) - 8, messagesHeight);
     renderer.DrawRect(messagesRect, Vec4(0.04f, 0.03f, 0.07f, 0.95f));
     renderer.DrawBorder3D(messagesRect, false);
+}
 
-    // Render messages
-    float lineHeight = renderer.GetFontHeight(1.0f) + 2;
-    float y = messagesBottom - lineHeight - 4;
-
-    int visibleLines = static_cast<int>(messagesHeight / lineHeight);
-    int startIndex = std::max(0, static_cast<int>(m_messages.size()) - visibleLines - static_cast<int>(m_scrollOffset));
+void Console::BuildDockedInput(int screenWidth, int screenHeight) {
+    auto& renderer = GUIRenderer::Instance();
 
-    for (int i = static_cast<int>(m_messages.size()) - 1; i >= startIndex && y > messagesTop; i--) {
-        const auto& msg = m_messages[i];
-        renderer.DrawText(msg.text, 8, y, GetMessageColor(msg.type), 1.0f);
-        y -= lineHeight;
-    }
+    float consoleHeight = screenHeight * m_openAmount;
+    float inputHeight = 28;
 
     // Input area with Windows 7 style
     Rect inputRect(4, consoleHeight - inputHeight - 2, static_cast<float>(screenWidth) - 8, inputHeight);
@@ -300,25 +591,14 @@ void Console::RenderDocked(int screenWidth, int screenHeight) {
     // Input text
     renderer.DrawText(m_inputBuffer, 24, consoleHeight - inputHeight + 5, Colors::Text, 1.0f);
 
-    // Cursor
-    if (m_cursorVisible && m_isOpen) {
-        float cursorX = 24 + m_cursorPos * 8;
-        renderer.DrawRect(Rect(cursorX, consoleHeight - inputHeight + 5, 8, 14),
-                         Vec4(Colors::Accent.x, Colors::Accent.y, Colors::Accent.z, 0.7f));
-    }
-
     // Bottom border with red accent
     renderer.DrawRect(Rect(0, consoleHeight - 3, static_cast<float>(screenWidth), 3), Colors::BorderDark);
     renderer.DrawRect(Rect(0, consoleHeight - 2, static_cast<float>(screenWidth), 2), Colors::Accent);
 }
 
-void Console::RenderFloating(int screenWidth, int screenHeight) {
+void Console::BuildFloatingWindow() {
     auto& renderer = GUIRenderer::Instance();
 
-    // Clamp window position to screen bounds
-    m_windowX = std::max(0.0f, std::min(m_windowX, static_cast<float>(screenWidth) - m_windowWidth));
-    m_windowY = std::max(0.0f, std::min(m_windowY, static_cast<float>(screenHeight) - m_windowHeight));
-
     // Window shadow
     Rect shadowRect(m_windowX + 4, m_windowY + 4, m_windowWidth, m_windowHeight);
     renderer.DrawRect(shadowRect, Vec4(0.0f, 0.0f, 0.0f, 0.4f));
@@ -370,18 +650,23 @@ void Console::RenderFloating(int screenWidth, int screenHeight) {
     renderer.DrawRect(messagesRect, Vec4(0.04f, 0.03f, 0.07f, 0.95f));
     renderer.DrawBorder3D(messagesRect, false);
 
-    // Render messages
-    float lineHeight = renderer.GetFontHeight(1.0f) + 2;
-    float y = messagesBottom - lineHeight - 4;
-
-    int visibleLines = static_cast<int>(messagesHeight / lineHeight);
-    int startIndex = std::max(0, static_cast<int>(m_messages.size()) - visibleLines - static_cast<int>(m_scrollOffset));
+    // Resize grip (bottom-right corner) - Windows 7 style
+    float gripSize = 16.0f;
+    float gripX = m_windowX + m_windowWidth - gripSize;
+    float gripY = m_windowY + m_windowHeight - gripSize;
 
-    for (int i = static_cast<int>(m_messages.size()) - 1; i >= startIndex && y > messagesTop; i--) {
-        const auto& msg = m_messages[i];
-        renderer.DrawText(msg.text, m_windowX + 10, y, GetMessageColor(msg.type), 1.0f);
-        y -= lineHeight;
+    // Draw diagonal lines for resize grip
+    for (int i = 0; i < 3; i++) {
+        float offset = i * 4.0f;
+        renderer.DrawRect(Rect(gripX + 6 + offset, gripY + gripSize - 4 - offset, 2, 2), Colors::BorderLight);
+        renderer.DrawRect(Rect(gripX + 8 + offset, gripY + gripSize - 2 - offset, 2, 2), Colors::BorderDark);
     }
+}
+
+void Console::BuildFloatingInput() {
+    auto& renderer = GUIRenderer::Instance();
+
+    float inputHeight = 28.0f;
 
     // Input area with Windows 7 style
     float inputY = m_windowY + m_windowHeight - inputHeight - 6;
@@ -399,25 +684,6 @@ void Console::RenderFloating(int screenWidth, int screenHeight) {
 
     // Input text
     renderer.DrawText(m_inputBuffer, m_windowX + 26, inputY + 7, Colors::Text, 1.0f);
-
-    // Cursor
-    if (m_cursorVisible && m_isOpen) {
-        float cursorX = m_windowX + 26 + m_cursorPos * 8;
-        renderer.DrawRect(Rect(cursorX, inputY + 7, 8, 14),
-                         Vec4(Colors::Accent.x, Colors::Accent.y, Colors::Accent.z, 0.7f));
-    }
-
-    // Resize grip (bottom-right corner) - Windows 7 style
-    float gripSize = 16.0f;
-    float gripX = m_windowX + m_windowWidth - gripSize;
-    float gripY = m_windowY + m_windowHeight - gripSize;
-
-    // Draw diagonal lines for resize grip
-    for (int i = 0; i < 3; i++) {
-        float offset = i * 4.0f;
-        renderer.DrawRect(Rect(gripX + 6 + offset, gripY + gripSize - 4 - offset, 2, 2), Colors::BorderLight);
-        renderer.DrawRect(Rect(gripX + 8 + offset, gripY + gripSize - 2 - offset, 2, 2), Colors::BorderDark);
-    }
 }
 
 void Console::Toggle() {
@@ -510,7 +776,7 @@ void Console::OnKeyPressed(int key) {
 
         case GLFW_KEY_PAGE_UP:
             m_scrollOffset += 5;
-            m_scrollOffset = std::min(m_scrollOffset, static_cast<float>(m_messages.size()));
+            m_scrollOffset = std::min(m_scrollOffset, static_cast<float>(m_scrollback.Size()));
             break;
 
         case GLFW_KEY_PAGE_DOWN:
@@ -538,8 +804,7 @@ void Console::OnCharInput(unsigned int codepoint) {
 void Console::OnMouseMove(float x, float y) {
     if (!m_isOpen) return;
 
-    auto* consoleMode = FindConVar("ge_console_mode");
-    if (!consoleMode || consoleMode->GetInt() != 1) return; // Only for floating mode
+    if (!m_consoleMode || m_consoleMode->GetInt() != 1) return; // Only for floating mode
 
     if (m_isDragging) {
         m_windowX = x - m_dragOffsetX;
@@ -560,8 +825,7 @@ void Console::OnMouseDown(float x, float y, int button) {
     if (!m_isOpen) return;
     if (button != 0) return; // Left button only
 
-    auto* consoleMode = FindConVar("ge_console_mode");
-    if (!consoleMode || consoleMode->GetInt() != 1) return; // Only for floating mode
+    if (!m_consoleMode || m_consoleMode->GetInt() != 1) return; // Only for floating mode
 
     float titleBarHeight = 28.0f;
     float gripSize = 16.0f;
@@ -605,12 +869,10 @@ void Console::OnMouseUp(float x, float y, int button) {
     m_isResizing = false;
 }
 
-void Console::Print(const std::string& message, MessageType type) {
-    m_messages.emplace_back(message, type);
-    if (m_messages.size() > MAX_MESSAGES) {
-        m_messages.pop_front();
-    }
+void Console::Print(std::string_view message, MessageType type) {
+    m_scrollback.Push(message, type);
     m_scrollOffset = 0;  // Auto-scroll to bottom
+    m_messagesDirty = true;
 }
 
 void Console::Printf(const char* format, ...) {
@@ -622,39 +884,64 @@ void Console::Printf(const char* format, ...) {
     Print(buffer, MessageType::Normal);
 }
 
-void Console::PrintWarning(const std::string& message) {
-    Print("[WARNING] " + message, MessageType::Warning);
+void Console::PrintWarning(std::string_view message) {
+    m_printScratch.assign("[WARNING] ").append(message);
+    Print(m_printScratch, MessageType::Warning);
 }
 
-void Console::PrintError(const std::string& message) {
-    Print("[ERROR] " + message, MessageType::Error);
+void Console::PrintError(std::string_view message) {
+    m_printScratch.assign("[ERROR] ").append(message);
+    Print(m_printScratch, MessageType::Error);
 }
 
-void Console::PrintSuccess(const std::string& message) {
+void Console::PrintSuccess(std::string_view message) {
     Print(message, MessageType::Success);
 }
 
 void Console::Clear() {
-    m_messages.clear();
+    m_scrollback.Clear();
     m_scrollOffset = 0;
+    m_messagesDirty = true;
 }
 
 void Console::RegisterCommand(const std::string& name, CommandCallback callback, const std::string& help) {
+    RetireCommand(name);
     m_commands[name] = {name, help, callback};
+    m_registryRevision++;
 }
 
 void Console::UnregisterCommand(const std::string& name) {
-    m_commands.erase(name);
+    if (!RetireCommand(name)) {
+        m_commands.erase(name);
+    }
+    m_registryRevision++;
+}
+
+bool Console::RetireCommand(const std::string& name) {
+    if (m_executeDepth == 0) return false;
+    auto it = m_commands.find(name);
+    if (it == m_commands.end()) return false;
+
+    // The node keeps the element where it is, callback included
+    m_retiredCommands.push_back(m_commands.extract(it));
+    return true;
 }
 
-ConVar* Console::RegisterConVar(const std::string& name, const std::string& defaultValue, const std::string& help) {
-    auto cvar = std::make_unique<ConVar>(name, defaultValue, help);
+ConVar* Console::RegisterConVar(const std::string& name, const std::string& defaultValue, const std::string& help,
+                                ConVarType type) {
+    auto it = m_convars.find(name);
+    if (it != m_convars.end()) {
+        return it->second.get();
+    }
+
+    auto cvar = std::make_unique<ConVar>(name, defaultValue, help, type);
     ConVar* ptr = cvar.get();
     m_convars[name] = std::move(cvar);
+    m_registryRevision++;
     return ptr;
 }
 
-ConVar* Console::FindConVar(const std::string& name) {
+ConVar* Console::FindConVar(std::string_view name) {
     auto it = m_convars.find(name);
     if (it != m_convars.end()) {
         return it->second.get();
@@ -663,61 +950,112 @@ ConVar* Console::FindConVar(const std::string& name) {
 }
 
 void Console::ExecuteCommand(const std::string& commandLine) {
-    auto args = ParseCommandLine(commandLine);
-    if (args.empty()) return;
+    CommandScript script(commandLine);
+    ExecuteScript(script, true);
+}
 
-    const std::string& cmdName = args[0];
+void Console::ExecuteScript(const CommandScript& script, bool echo) {
+    for (size_t i = 0; i < script.GetLineCount(); i++) {
+        ExecuteLine(script, script.GetLine(i), echo);
+    }
+}
+
+void Console::ExecuteLine(const CommandScript& script, const CommandScript::Line& line, bool echo) {
+    std::string_view name = script.GetToken(line, 0);
+
+    // Resolve the first token once per registry revision
+    if (line.resolvedRevision != m_registryRevision) {
+        line.resolved = nullptr;
+        line.resolvedConVar = false;
+        if (auto cmdIt = m_commands.find(name); cmdIt != m_commands.end()) {
+            line.resolved = &cmdIt->second;
+        } else if (auto cvarIt = m_convars.find(name); cvarIt != m_convars.end()) {
+            line.resolved = cvarIt->second.get();
+            line.resolvedConVar = true;
+        }
+        line.resolvedRevision = m_registryRevision;
+    }
 
-    // Check if it's a command
-    auto cmdIt = m_commands.find(cmdName);
-    if (cmdIt != m_commands.end()) {
-        cmdIt->second.callback(args);
+    if (!line.resolved) {
+        PrintError("Unknown command: " + std::string(name));
         return;
     }
 
-    // Check if it's a convar
-    auto* cvar = FindConVar(cmdName);
-    if (cvar) {
+    // Arguments go into reused strings; a command running commands gets
+    // its own
+    std::vector<std::string> nestedArgs;
+    std::vector<std::string>& args = m_executeDepth == 0 ? m_args : nestedArgs;
+    args.resize(line.tokenCount);
+    for (uint32_t i = 0; i < line.tokenCount; i++) {
+        args[i].assign(script.GetToken(line, i));
+    }
+
+    m_executeDepth++;
+    if (!line.resolvedConVar) {
+        static_cast<const ConsoleCommand*>(line.resolved)->callback(args);
+    } else {
+        auto* cvar = const_cast<ConVar*>(static_cast<const ConVar*>(line.resolved));
         if (args.size() > 1) {
-            // Set value
-            cvar->SetString(args[1]);
-            Print(cmdName + " = \"" + cvar->GetString() + "\"", MessageType::Normal);
+            // Set value (silent from configs and binds)
+            if (!cvar->SetString(args[1])) {
+                PrintError("Invalid value for " + args[0] + ": \"" + args[1] + "\"");
+            } else if (echo) {
+                Print(args[0] + " = \"" + cvar->GetString() + "\"", MessageType::Normal);
+            }
         } else {
             // Print current value
-            Print(cmdName + " = \"" + cvar->GetString() + "\"", MessageType::Normal);
+            Print(args[0] + " = \"" + cvar->GetString() + "\"", MessageType::Normal);
             if (!cvar->GetHelp().empty()) {
                 Print("  " + cvar->GetHelp(), MessageType::Normal);
             }
         }
-        return;
     }
+    if (--m_executeDepth == 0) {
+        m_retiredCommands.clear();
+    }
+}
 
-    PrintError("Unknown command: " + cmdName);
+void Console::BufferCommand(std::string_view text) {
+    m_commandBuffer.Append(text);
 }
 
-std::vector<std::string> Console::ParseCommandLine(const std::string& line) {
-    std::vector<std::string> args;
-    std::string current;
-    bool inQuotes = false;
+void Console::BufferScript(const CommandScript& script) {
+    m_commandBuffer.Append(script);
+}
 
-    for (char c : line) {
-        if (c == '"') {
-            inQuotes = !inQuotes;
-        } else if (c == ' ' && !inQuotes) {
-            if (!current.empty()) {
-                args.push_back(current);
-                current.clear();
-            }
-        } else {
-            current += c;
-        }
+bool Console::ExecFile(const std::string& path) {
+    std::string name = path;
+    if (std::filesystem::path(name).extension().empty()) {
+        name += ".cfg";
     }
 
-    if (!current.empty()) {
-        args.push_back(current);
+    std::ifstream file;
+    for (const std::string& candidate : {path, name, "cfg/" + name}) {
+        file.open(candidate, std::ios::binary);
+        if (file.is_open()) break;
     }
+    if (!file.is_open()) return false;
 
-    return args;
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    m_commandBuffer.Append(buffer.str());
+    return true;
+}
+
+void Console::ExecuteBuffer() {
+    if (m_commandBuffer.IsEmpty()) return;
+    GENESIS_PROFILE_SCOPE("Console::ExecuteBuffer");
+
+    for (int round = 0; round < MAX_BUFFER_ROUNDS && !m_commandBuffer.IsEmpty(); round++) {
+        std::swap(m_executingBuffer, m_commandBuffer);
+        ExecuteScript(m_executingBuffer);
+        m_executingBuffer.Clear();
+    }
+
+    if (!m_commandBuffer.IsEmpty()) {
+        PrintWarning("Command buffer still busy after " + std::to_string(MAX_BUFFER_ROUNDS) +
+                     " rounds (recursive exec?), continuing next frame");
+    }
 }
 
 void Console::AddToHistory(const std::string& command) {
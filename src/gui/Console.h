@@ -1,63 +1,97 @@
 #pragma once
 
 #include "GUIRenderer.h"
+#include "ConsoleScrollback.h"
+#include "CommandScript.h"
 #include <string>
+#include <string_view>
 #include <vector>
-#include <deque>
 #include <unordered_map>
+#include <concepts>
 #include <functional>
 #include <sstream>
+#include <variant>
 
 namespace Genesis {
 namespace GUI {
 
 // ============================================================================
-// Console Message Types
+// Console Variable (ConVar)
+//
+// Values are parsed once when set, so GetInt/GetFloat/GetBool are plain
+// loads. Typed convars (Int, Float, Bool) reject text that doesn't parse;
+// String convars accept anything (numeric reads are 0 for non-numbers).
+// A convar can be bound to a field it writes on every change, and change
+// callbacks run after the new value is stored.
 // ============================================================================
-enum class MessageType {
-    Normal,
-    Command,
-    Warning,
-    Error,
-    Success
-};
-
-struct ConsoleMessage {
-    std::string text;
-    MessageType type;
-
-    ConsoleMessage(const std::string& t, MessageType mt = MessageType::Normal)
-        : text(t), type(mt) {}
+enum class ConVarType : uint8_t {
+    String,
+    Int,
+    Float,
+    Bool
 };
 
-// ============================================================================
-// Console Variable (ConVar)
-// ============================================================================
 class ConVar {
 public:
-    ConVar(const std::string& name, const std::string& defaultValue, const std::string& help = "")
-        : m_name(name), m_value(defaultValue), m_defaultValue(defaultValue), m_help(help) {}
+    using ChangeCallback = std::function<void(const ConVar&)>;
+
+    ConVar(const std::string& name, const std::string& defaultValue, const std::string& help = "",
+           ConVarType type = ConVarType::String);
 
     const std::string& GetName() const { return m_name; }
     const std::string& GetString() const { return m_value; }
     const std::string& GetHelp() const { return m_help; }
+    ConVarType GetType() const { return m_type; }
+
+    int GetInt() const { return m_int; }
+    float GetFloat() const { return m_float; }
+    double GetDouble() const { return m_number; }
+    bool GetBool() const { return m_bool; }
+
+    // False (value unchanged) if the text doesn't parse as the convar's type
+    bool SetString(const std::string& value);
+    void SetInt(int value);
+    void SetFloat(float value);
+    void SetBool(bool value);
+
+    void Reset() { SetString(m_defaultValue); }
+
+    // Writes the current value to target now and on every change. The
+    // target must outlive the convar or be unbound first.
+    void Bind(int* target) { m_binding = target; WriteBinding(); }
+    void Bind(float* target) { m_binding = target; WriteBinding(); }
+    void Bind(double* target) { m_binding = target; WriteBinding(); }
+    void Bind(bool* target) { m_binding = target; WriteBinding(); }
+    void Bind(std::string* target) { m_binding = target; WriteBinding(); }
+    void Unbind() { m_binding = std::monostate(); }
+
+    // Returns an id for RemoveChangeCallback
+    uint32_t AddChangeCallback(ChangeCallback callback);
+    void RemoveChangeCallback(uint32_t id);
 
-    int GetInt() const { return std::stoi(m_value); }
-    float GetFloat() const { return std::stof(m_value); }
-    bool GetBool() const { return m_value == "1" || m_value == "true"; }
-
-    void SetString(const std::string& value) { m_value = value; }
-    void SetInt(int value) { m_value = std::to_string(value); }
-    void SetFloat(float value) { m_value = std::to_string(value); }
-    void SetBool(bool value) { m_value = value ? "1" : "0"; }
+private:
+    struct Callback {
+        uint32_t id;
+        ChangeCallback callback;
+    };
 
-    void Reset() { m_value = m_defaultValue; }
+    void WriteBinding() const;
 
-private:
     std::string m_name;
     std::string m_value;
     std::string m_defaultValue;
     std::string m_help;
+    ConVarType m_type;
+
+    // Parsed forms of m_value
+    double m_number = 0.0;
+    float m_float = 0.0f;
+    int m_int = 0;
+    bool m_bool = false;
+
+    std::variant<std::monostate, int*, float*, double*, bool*, std::string*> m_binding;
+    std::vector<Callback> m_callbacks;
+    uint32_t m_nextCallbackId = 1;
 };
 
 // ============================================================================
@@ -116,11 +150,12 @@ public:
     // Output
     // ========================================================================
 
-    void Print(const std::string& message, MessageType type = MessageType::Normal);
+    // The text is copied into the scrollback (no allocation per message)
+    void Print(std::string_view message, MessageType type = MessageType::Normal);
     void Printf(const char* format, ...);
-    void PrintWarning(const std::string& message);
-    void PrintError(const std::string& message);
-    void PrintSuccess(const std::string& message);
+    void PrintWarning(std::string_view message);
+    void PrintError(std::string_view message);
+    void PrintSuccess(std::string_view message);
     void Clear();
 
     // ========================================================================
@@ -130,29 +165,74 @@ public:
     void RegisterCommand(const std::string& name, CommandCallback callback, const std::string& help = "");
     void UnregisterCommand(const std::string& name);
 
-    ConVar* RegisterConVar(const std::string& name, const std::string& defaultValue, const std::string& help = "");
-    ConVar* FindConVar(const std::string& name);
+    // Registering an existing name returns the existing convar (pointers
+    // stay valid for the console's lifetime)
+    ConVar* RegisterConVar(const std::string& name, const std::string& defaultValue, const std::string& help = "",
+                           ConVarType type = ConVarType::String);
+    ConVar* FindConVar(std::string_view name);
+
+    // Typed convar bound to field; a new convar takes the field's current
+    // value as its default, an existing one writes its value to the field
+    template<typename T>
+        requires std::same_as<T, int> || std::same_as<T, float> || std::same_as<T, double> || std::same_as<T, bool>
+    ConVar* BindConVar(const std::string& name, T* field, const std::string& help = "");
 
+    // Shortest text for a numeric convar value ("%g")
+    static std::string FormatConVarValue(double value);
+
+    // Run one typed line now (may hold several ';'-separated commands)
     void ExecuteCommand(const std::string& commandLine);
 
+    // Run a pre-tokenized script now (binds: lookups are cached per line)
+    void ExecuteScript(const CommandScript& script, bool echo = false);
+
+    // ========================================================================
+    // Command Buffer
+    // ========================================================================
+
+    // Queue commands for ExecuteBuffer()
+    void BufferCommand(std::string_view text);
+    void BufferScript(const CommandScript& script);
+
+    // Tokenize a config file once and queue it. Looks for path, then
+    // cfg/path, adding ".cfg" when there is no extension.
+    bool ExecFile(const std::string& path);
+
+    // Run everything queued. Engine::Run calls this once per frame, after
+    // input and before the fixed ticks. Commands queued meanwhile (exec
+    // from a config) run in further rounds, up to MAX_BUFFER_ROUNDS.
+    void ExecuteBuffer();
+    static constexpr int MAX_BUFFER_ROUNDS = 16;
+
     // ========================================================================
     // History
     // ========================================================================
 
-    const std::deque<ConsoleMessage>& GetMessages() const { return m_messages; }
+    const ConsoleScrollback& GetScrollback() const { return m_scrollback; }
 
 private:
     Console() = default;
 
     void RegisterBuiltInCommands();
-    std::vector<std::string> ParseCommandLine(const std::string& line);
+
+    // Mid-execution, take name's command out of the table without
+    // destroying it (false if not executing or not registered)
+    bool RetireCommand(const std::string& name);
+
+    void ExecuteLine(const CommandScript& script, const CommandScript::Line& line, bool echo);
     void AddToHistory(const std::string& command);
     void AutoComplete();
     Vec4 GetMessageColor(MessageType type) const;
 
-    // Render helpers for different modes
-    void RenderDocked(int screenWidth, int screenHeight);
-    void RenderFloating(int screenWidth, int screenHeight);
+    // Render helpers for different modes: the window (chrome, messages)
+    // and the input line are recorded into draw lists
+    void BuildDockedWindow(int screenWidth, int screenHeight);
+    void BuildDockedInput(int screenWidth, int screenHeight);
+    void BuildFloatingWindow();
+    void BuildFloatingInput();
+    void BuildMessages(int mode, int screenHeight);
+    const GUIDrawList& GetLineLayout(const ConsoleLine& line);
+    Rect GetCursorRect(int mode, int screenHeight) const;
 
 private:
     bool m_isOpen = false;
@@ -185,21 +265,79 @@ private:
     int m_historyIndex = -1;
 
     // Messages
-    std::deque<ConsoleMessage> m_messages;
-    static constexpr size_t MAX_MESSAGES = 1000;
+    ConsoleScrollback m_scrollback;
+    std::string m_printScratch;     // Prefixed warning/error text
     float m_scrollOffset = 0.0f;
 
-    // Commands and variables
-    std::unordered_map<std::string, ConsoleCommand> m_commands;
-    std::unordered_map<std::string, std::unique_ptr<ConVar>> m_convars;
+    // Commands and variables (looked up by string_view without allocating)
+    struct NameHash {
+        using is_transparent = void;
+        size_t operator()(std::string_view name) const { return std::hash<std::string_view>{}(name); }
+    };
+    std::unordered_map<std::string, ConsoleCommand, NameHash, std::equal_to<>> m_commands;
+    std::unordered_map<std::string, std::unique_ptr<ConVar>, NameHash, std::equal_to<>> m_convars;
+    uint32_t m_registryRevision = 1;    // Bumped on (un)register; invalidates line lookups
+
+    // Commands replaced or removed while commands run: kept whole until the
+    // outermost one returns, since one of them may be the running callback
+    std::vector<decltype(m_commands)::node_type> m_retiredCommands;
+
+    // Command buffer
+    CommandScript m_commandBuffer;
+    CommandScript m_executingBuffer;
+    std::vector<std::string> m_args;    // Reused argument strings (outermost line)
+    int m_executeDepth = 0;
 
     // Auto-complete
     std::vector<std::string> m_autoCompleteOptions;
     int m_autoCompleteIndex = 0;
 
+    // Retained geometry. Rebuilt only when the layout, the messages or the
+    // input text change; the blinking cursor is drawn every frame.
+    // Message text is laid out once per line (glyph quads at the origin,
+    // cached by sequence) and only visible lines are ever touched.
+    struct RenderLayout {
+        int screenWidth = 0, screenHeight = 0, mode = -1;
+        float openAmount = 0.0f, scrollOffset = 0.0f;
+        float windowX = 0.0f, windowY = 0.0f, windowWidth = 0.0f, windowHeight = 0.0f;
+        bool isOpen = false;
+        bool operator==(const RenderLayout&) const = default;
+    };
+    RenderLayout m_builtLayout;
+    GUIDrawList m_windowList;
+    GUIDrawList m_messagesList;
+    GUIDrawList m_inputList;
+    std::string m_builtInput;
+    bool m_messagesDirty = true;
+
+    std::vector<GUIDrawList> m_lineLayouts;         // By sequence % size
+    std::vector<uint64_t> m_lineLayoutSequence;
+
+    // Built-in convars, looked up once
+    ConVar* m_consoleMode = nullptr;
+    ConVar* m_timeScale = nullptr;
+    ConVar* m_fov = nullptr;
+    ConVar* m_sensitivity = nullptr;
+    bool m_applyConVars = true;     // Push timescale/fov/sensitivity on the next Update
+
     bool m_initialized = false;
 };
 
+template<typename T>
+    requires std::same_as<T, int> || std::same_as<T, float> || std::same_as<T, double> || std::same_as<T, bool>
+ConVar* Console::BindConVar(const std::string& name, T* field, const std::string& help) {
+    ConVar* cvar = nullptr;
+    if constexpr (std::is_same_v<T, bool>) {
+        cvar = RegisterConVar(name, *field ? "1" : "0", help, ConVarType::Bool);
+    } else if constexpr (std::is_same_v<T, int>) {
+        cvar = RegisterConVar(name, std::to_string(*field), help, ConVarType::Int);
+    } else {
+        cvar = RegisterConVar(name, FormatConVarValue(*field), help, ConVarType::Float);
+    }
+    cvar->Bind(field);
+    return cvar;
+}
+
 } // namespace GUI
 } // namespace Genesis
 
@@ -0,0 +1,67 @@
+#include "ConsoleScrollback.h"
+#include <algorithm>
+#include <cstring>
+
+namespace Genesis {
+namespace GUI {
+
+ConsoleScrollback::ConsoleScrollback(size_t lineCapacity, size_t chunkCount)
+    : m_lines(std::max<size_t>(lineCapacity, 1)),
+      m_chunks(std::max<size_t>(chunkCount, 1)),
+      m_chunkLines(m_chunks.size(), 0) {}
+
+void ConsoleScrollback::Push(std::string_view text, MessageType type) {
+    uint32_t length = static_cast<uint32_t>(std::min(text.size(), MAX_LINE_BYTES));
+
+    // Wrap to the next chunk, evicting the lines still stored there (the
+    // chunks fill in ring order, so those are the oldest lines)
+    if (m_writeOffset + length > CHUNK_BYTES) {
+        m_writeChunk = static_cast<uint32_t>((m_writeChunk + 1) % m_chunks.size());
+        m_writeOffset = 0;
+        while (m_chunkLines[m_writeChunk] > 0) {
+            PopOldest();
+        }
+    }
+    if (m_count == m_lines.size()) {
+        PopOldest();
+    }
+
+    if (m_chunks[m_writeChunk].empty()) {
+        m_chunks[m_writeChunk].resize(CHUNK_BYTES);
+        m_allocatedChunks++;
+    }
+    if (length > 0) {
+        std::memcpy(m_chunks[m_writeChunk].data() + m_writeOffset, text.data(), length);
+    }
+
+    m_lines[(m_head + m_count) % m_lines.size()] = {m_writeChunk, m_writeOffset, length, type};
+    m_count++;
+    m_nextSequence++;
+    m_chunkLines[m_writeChunk]++;
+    m_writeOffset += length;
+}
+
+void ConsoleScrollback::PopOldest() {
+    if (m_count == 0) return;
+    m_chunkLines[m_lines[m_head].chunk]--;
+    m_head = (m_head + 1) % m_lines.size();
+    m_count--;
+}
+
+void ConsoleScrollback::Clear() {
+    // Keeps the chunks; sequences keep counting so cached layouts go stale
+    m_head = 0;
+    m_count = 0;
+    std::fill(m_chunkLines.begin(), m_chunkLines.end(), 0);
+    m_writeChunk = 0;
+    m_writeOffset = 0;
+}
+
+ConsoleLine ConsoleScrollback::Get(size_t index) const {
+    const Line& line = m_lines[(m_head + index) % m_lines.size()];
+    std::string_view text(m_chunks[line.chunk].data() + line.offset, line.length);
+    return {text, line.type, m_nextSequence - m_count + index};
+}
+
+} // namespace GUI
+} // namespace Genesis
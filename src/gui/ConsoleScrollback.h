@@ -0,0 +1,95 @@
+#pragma once
+
+#include "core/MemoryTracker.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace Genesis {
+namespace GUI {
+
+// ============================================================================
+// Console Message Types
+// ============================================================================
+enum class MessageType : uint8_t {
+    Normal,
+    Command,
+    Warning,
+    Error,
+    Success
+};
+
+struct ConsoleLine {
+    std::string_view text;      // Valid until the line is evicted
+    MessageType type;
+    uint64_t sequence;          // Unique per pushed line (survives Clear)
+};
+
+// ============================================================================
+// ConsoleScrollback - Fixed-capacity ring of console lines
+//
+// Line records live in a ring of lineCapacity entries; their text is copied
+// into a ring of fixed-size chunks. Pushing never allocates once every chunk
+// has been touched: the oldest lines are evicted when the line ring is full
+// or when the write position wraps onto a chunk they still occupy. Lines
+// longer than MAX_LINE_BYTES are truncated.
+//
+// Main thread only (the Logger forwards to the console from FlushConsole).
+// ============================================================================
+class ConsoleScrollback {
+public:
+    static constexpr size_t DEFAULT_LINE_CAPACITY = 4096;
+    static constexpr size_t CHUNK_BYTES = 64 * 1024;
+    static constexpr size_t DEFAULT_CHUNK_COUNT = 8;
+    static constexpr size_t MAX_LINE_BYTES = 1024;
+
+    explicit ConsoleScrollback(size_t lineCapacity = DEFAULT_LINE_CAPACITY,
+                               size_t chunkCount = DEFAULT_CHUNK_COUNT);
+
+    ConsoleScrollback(const ConsoleScrollback&) = delete;
+    ConsoleScrollback& operator=(const ConsoleScrollback&) = delete;
+
+    void Push(std::string_view text, MessageType type);
+    void Clear();
+
+    size_t Size() const { return m_count; }
+    bool IsEmpty() const { return m_count == 0; }
+    size_t GetCapacity() const { return m_lines.size(); }
+
+    // 0 = oldest line
+    ConsoleLine Get(size_t index) const;
+    // 0 = newest line
+    ConsoleLine GetFromNewest(size_t index) const { return Get(m_count - 1 - index); }
+
+    // Text bytes reserved (chunks are allocated on first use)
+    size_t GetReservedBytes() const { return m_allocatedChunks * CHUNK_BYTES; }
+
+private:
+    struct Line {
+        uint32_t chunk;
+        uint32_t offset;
+        uint32_t length;
+        MessageType type;
+    };
+
+    void PopOldest();
+
+    // Line ring and text chunks are charged to MemoryTag::Console
+    using Chunk = TaggedVector<char, MemoryTag::Console>;
+
+    TaggedVector<Line, MemoryTag::Console> m_lines;   // Ring, oldest at m_head
+    size_t m_head = 0;
+    size_t m_count = 0;
+    uint64_t m_nextSequence = 0;
+
+    std::vector<Chunk> m_chunks;        // Empty until first written
+    std::vector<uint32_t> m_chunkLines; // Live lines per chunk
+    size_t m_allocatedChunks = 0;
+    uint32_t m_writeChunk = 0;
+    uint32_t m_writeOffset = 0;
+};
+
+} // namespace GUI
+} // namespace Genesis
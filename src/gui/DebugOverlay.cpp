@@ -2,30 +2,20 @@
 #include "core/Engine.h"
 #include "core/Time.h"
 #include "renderer/world/StaticWorldRenderer.h"
+#include "core/FrameArena.h"
+#include "core/MemoryTracker.h"
+#include "core/Profiler.h"
+#include "renderer/DynamicResolution.h"
+#include "renderer/GLState.h"
+#include "renderer/GpuTimer.h"
 #include <sstream>
 #include <iomanip>
 
 namespace Genesis {
 namespace GUI {
 
-void DebugOverlay::Render(int screenWidth, int screenHeight) {
-    // Check convar OR force visible flag
-    auto* showInfo = Console::Instance().FindConVar("ge_showinfo");
-    bool showViaConvar = showInfo && showInfo->GetBool();
-
-    if (!showViaConvar && !m_forceVisible) return;
-
+void DebugOverlay::BuildPanel(float panelWidth, float panelHeight, float padding, float lineHeight) {
     auto& renderer = GUIRenderer::Instance();
-    auto& engine = Engine::Instance();
-    auto& camera = engine.GetCamera();
-    auto& time = Time::Instance();
-
-    float lineHeight = 14;
-    float padding = 8;
-
-    // Background panel - positioned at TOP LEFT
-    float panelWidth = 280;
-    float panelHeight = lineHeight * 21 + padding * 2;  // Expanded for render stats + vertices
     Rect panelRect(10, 10, panelWidth, panelHeight);
 
     // Windows 7 style panel with gradient
@@ -44,6 +34,69 @@ void DebugOverlay::Render(int screenWidth, int screenHeight) {
 
     // Separator line
     renderer.DrawRect(Rect(x, y - 2, panelWidth - padding * 2, 1), Colors::BorderDark);
+}
+
+void DebugOverlay::Render(int screenWidth, int screenHeight) {
+    // Check convar OR force visible flag
+    if (!m_showInfo) {
+        m_showInfo = Console::Instance().FindConVar("ge_showinfo");
+    }
+    bool showViaConvar = m_showInfo && m_showInfo->GetBool();
+
+    if (!showViaConvar && !m_forceVisible) return;
+
+    auto& renderer = GUIRenderer::Instance();
+    auto& engine = Engine::Instance();
+    auto& camera = engine.GetCamera();
+    auto& time = Time::Instance();
+
+    float lineHeight = 14;
+    float padding = 8;
+
+#if defined(GENESIS_PROFILER_ENABLED)
+    // Main thread zones (thread 0: Engine::Initialize names it first)
+    constexpr size_t MAX_PROFILE_LINES = 10;
+    std::vector<const ProfileNode*> zones;
+    for (const auto& node : Profiler::Instance().GetLastFrame()) {
+        if (node.thread == 0 && node.depth <= 2 && zones.size() < MAX_PROFILE_LINES) {
+            zones.push_back(&node);
+        }
+    }
+    int profileLines = static_cast<int>(zones.size()) + 3;  // Header + GPU total + spacing
+#else
+    int profileLines = 0;
+#endif
+
+    // Overdraw line only while it has something to show
+    const auto& world = StaticWorldRenderer::Instance();
+    int overdrawLines = (world.IsOverdrawMeasure() || world.IsDepthPrepass()) ? 1 : 0;
+    auto& dynamicResolution = DynamicResolution::Instance();
+    int resolutionLines = dynamicResolution.GetConfig().enabled ? 1 : 0;
+
+    // Memory: header, total, then the tags that hold anything
+    const auto& tracker = MemoryTracker::Instance();
+    MemoryTagStats memoryStats[static_cast<size_t>(MemoryTag::Count)];
+    int memoryLines = 2;
+    for (size_t i = 0; i < static_cast<size_t>(MemoryTag::Count); i++) {
+        memoryStats[i] = tracker.GetStats(static_cast<MemoryTag>(i));
+        if (memoryStats[i].heapPeak > 0 || memoryStats[i].gpuPeak > 0) {
+            memoryLines++;
+        }
+    }
+
+    // Background panel - positioned at TOP LEFT
+    float panelWidth = 280;
+    float panelHeight = lineHeight * (24 + overdrawLines + resolutionLines + memoryLines + profileLines) + padding * 2;  // Expanded for render stats + profiler
+    if (panelHeight != m_builtPanelHeight) {
+        renderer.BeginDrawList(m_panelList);
+        BuildPanel(panelWidth, panelHeight, padding, lineHeight);
+        renderer.EndDrawList();
+        m_builtPanelHeight = panelHeight;
+    }
+    renderer.SubmitDrawList(m_panelList);
+
+    float x = 10 + padding;
+    float y = 10 + padding + 4 + lineHeight + 6;   // Below the title
 
     // FPS
     std::ostringstream oss;
@@ -126,11 +179,47 @@ void DebugOverlay::Render(int screenWidth, int screenHeight) {
     renderer.DrawText(oss.str(), x, y, Colors::Text, 1.0f);
     y += lineHeight;
 
+    oss.str("");
+    oss << "Culled: " << worldRenderer.GetObjectsCulled();
+    renderer.DrawText(oss.str(), x, y, Colors::Text, 1.0f);
+    y += lineHeight;
+
+    oss.str("");
+    oss << "Occluded: " << worldRenderer.GetObjectsOccluded()
+        << "  PVS: " << worldRenderer.GetObjectsPvsCulled();
+    renderer.DrawText(oss.str(), x, y, Colors::Text, 1.0f);
+    y += lineHeight;
+
     oss.str("");
     oss << "Draw Calls: " << worldRenderer.GetDrawCalls();
     renderer.DrawText(oss.str(), x, y, Colors::Text, 1.0f);
     y += lineHeight;
 
+    // Shaded fragments per pixel (r_overdraw), a few frames late
+    if (overdrawLines > 0) {
+        oss.str("");
+        if (worldRenderer.IsOverdrawMeasure()) {
+            oss << "Overdraw: " << std::setprecision(2) << worldRenderer.GetOverdraw() << "x";
+        } else {
+            oss << "Overdraw: -";
+        }
+        if (worldRenderer.IsDepthPrepass()) {
+            oss << "  Prepass: " << worldRenderer.GetPrepassDrawCalls();
+        }
+        renderer.DrawText(oss.str(), x, y, Colors::Text, 1.0f);
+        y += lineHeight;
+    }
+
+    // Dynamic resolution scale (r_dynres) and the GPU time steering it
+    if (resolutionLines > 0) {
+        oss.str("");
+        oss << "Render Scale: " << std::setprecision(2) << dynamicResolution.GetScale() << " ("
+            << dynamicResolution.GetRenderWidth() << "x" << dynamicResolution.GetRenderHeight() << ", "
+            << std::setprecision(1) << dynamicResolution.GetGpuMilliseconds() << " ms)";
+        renderer.DrawText(oss.str(), x, y, Colors::Text, 1.0f);
+        y += lineHeight;
+    }
+
     // Vertex count
     oss.str("");
     uint32_t vertices = worldRenderer.GetVerticesRendered();
@@ -163,6 +252,71 @@ void DebugOverlay::Render(int screenWidth, int screenHeight) {
     oss.str("");
     oss << "World Objects: " << worldRenderer.GetObjectCount();
     renderer.DrawText(oss.str(), x, y, Colors::Text, 1.0f);
+    y += lineHeight;
+
+    // GL state cache (previous frame)
+    const auto& glStats = GLStateCache::Instance().GetLastFrameStats();
+    oss.str("");
+    oss << "GL State: " << glStats.issued << " issued, " << glStats.skipped << " skipped";
+    renderer.DrawText(oss.str(), x, y, Colors::Text, 1.0f);
+    y += lineHeight;
+
+    // Transient per-frame allocations
+    const auto& arena = FrameArena::Instance();
+    oss.str("");
+    oss << "Frame Arena: " << (arena.GetUsed() / 1024) << " KB (peak " << (arena.GetPeak() / 1024) << " KB)";
+    renderer.DrawText(oss.str(), x, y, Colors::Text, 1.0f);
+    y += lineHeight;
+
+    // Tracked heap / GPU megabytes (mem_report for peaks and budgets)
+    y += 4;
+    renderer.DrawText("-- Memory --", x, y, Colors::AccentLight, 1.0f);
+    y += lineHeight;
+
+    MemoryTagStats memoryTotal = tracker.GetTotalStats();
+    oss.str("");
+    oss << std::setprecision(1) << "Heap: " << memoryTotal.heapBytes / 1048576.0
+        << " MB  GPU: " << memoryTotal.gpuBytes / 1048576.0 << " MB";
+    renderer.DrawText(oss.str(), x, y, Colors::Text, 1.0f);
+    y += lineHeight;
+
+    for (size_t i = 0; i < static_cast<size_t>(MemoryTag::Count); i++) {
+        const MemoryTagStats& stats = memoryStats[i];
+        if (stats.heapPeak <= 0 && stats.gpuPeak <= 0) continue;
+        oss.str("");
+        oss << "  " << MemoryTracker::GetTagName(static_cast<MemoryTag>(i)) << ": "
+            << stats.heapBytes / 1048576.0 << " / " << stats.gpuBytes / 1048576.0 << " MB";
+        if (stats.budget > 0) {
+            oss << " of " << stats.budget / 1048576.0;
+        }
+        renderer.DrawText(oss.str(), x, y, stats.IsOverBudget() ? Colors::AccentHover : Colors::Text, 1.0f);
+        y += lineHeight;
+    }
+
+#if defined(GENESIS_PROFILER_ENABLED)
+    // Profiler section header (full tree: prof_dump)
+    y += 4;
+    renderer.DrawText("-- Profiler --", x, y, Colors::AccentLight, 1.0f);
+    y += lineHeight;
+
+    // GPU time is FRAME_LATENCY frames old and only exists for timed passes
+    const auto& gpuTimers = GpuTimers::Instance();
+    oss.str("");
+    oss << std::setprecision(2) << "GPU: " << gpuTimers.GetTotalMilliseconds() << " ms";
+    renderer.DrawText(oss.str(), x, y, Colors::Text, 1.0f);
+    y += lineHeight;
+
+    for (const ProfileNode* zone : zones) {
+        oss.str("");
+        oss << std::string(zone->depth * 2, ' ') << zone->name << ": "
+            << std::setprecision(2) << zone->GetMilliseconds() << " ms";
+        if (const GpuTimerResult* gpu = gpuTimers.FindResult(zone->name)) {
+            oss << " (GPU " << gpu->milliseconds << ")";
+        }
+        renderer.DrawText(oss.str(), x, y, Colors::Text, 1.0f);
+        y += lineHeight;
+    }
+#endif
 }
 
 } // namespace GUI
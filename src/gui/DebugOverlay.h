@@ -25,7 +25,15 @@ public:
 
 private:
     DebugOverlay() = default;
+    void BuildPanel(float panelWidth, float panelHeight, float padding, float lineHeight);
+
     bool m_forceVisible = false;
+    ConVar* m_showInfo = nullptr;   // ge_showinfo, looked up once
+
+    // The panel frame is retained (rebuilt when its height changes); the
+    // stat lines change every frame and are drawn directly
+    GUIDrawList m_panelList;
+    float m_builtPanelHeight = -1.0f;
 };
 
 } // namespace GUI
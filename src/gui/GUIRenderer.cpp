@@ -1,4 +1,6 @@
 #include "GUIRenderer.h"
+#include "renderer/GLState.h"
+#include "core/StartupProfile.h"
 #include <glad/glad.h>
 #include <cstring>
 #include <algorithm>
@@ -226,34 +228,52 @@ in vec4 Color;
 
 out vec4 FragColor;
 
+#ifdef USE_TEXTURE
 uniform sampler2D u_Texture;
-uniform int u_UseTexture;
+#endif
 
 void main() {
-    if (u_UseTexture == 1) {
-        float alpha = texture(u_Texture, TexCoord).r;
-        FragColor = vec4(Color.rgb, Color.a * alpha);
-    } else {
-        FragColor = Color;
-    }
+#ifdef USE_TEXTURE
+    float alpha = texture(u_Texture, TexCoord).r;
+    FragColor = vec4(Color.rgb, Color.a * alpha);
+#else
+    FragColor = Color;
+#endif
 }
 )";
 
 bool GUIRenderer::Initialize() {
     if (m_initialized) return true;
 
-    // Create shader
+    // Create shaders: solid quads, and text sampling the font atlas
     m_shader = std::make_shared<Shader>();
     if (!m_shader->LoadFromSource(g_guiVertexShader, g_guiFragmentShader, "gui")) {
         return false;
     }
+    m_textShader = std::make_shared<Shader>();
+    if (!m_textShader->LoadFromSource(g_guiVertexShader, g_guiFragmentShader, "gui_text",
+                                      "#define USE_TEXTURE 1\n")) {
+        return false;
+    }
 
-    // Create VAO/VBO
+    // Create VAO and the vertex stream
     glGenVertexArrays(1, &m_vao);
-    glGenBuffers(1, &m_vbo);
+    if (!m_stream.Create(GL_ARRAY_BUFFER, STREAM_FRAME_BYTES)) {
+        return false;
+    }
+    SetupVertexFormat();
+
+    // Font atlas: rasterized on a job, uploaded by the first BeginFrame()
+    PrepareFontAtlas();
+
+    m_initialized = true;
+    return true;
+}
 
-    glBindVertexArray(m_vao);
-    glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+void GUIRenderer::SetupVertexFormat() {
+    auto& gl = GLStateCache::Instance();
+    gl.BindVertexArray(m_vao);
+    glBindBuffer(GL_ARRAY_BUFFER, m_stream.GetId());
 
     // Position
     glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(GUIVertex), (void*)0);
@@ -265,16 +285,20 @@ bool GUIRenderer::Initialize() {
     glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(GUIVertex), (void*)(4 * sizeof(float)));
     glEnableVertexAttribArray(2);
 
-    glBindVertexArray(0);
-
-    // Create font texture
-    CreateFontTexture();
+    gl.BindVertexArray(0);
+    m_streamVersion = m_stream.GetVersion();
+}
 
-    m_initialized = true;
-    return true;
+void GUIRenderer::PrepareFontAtlas() {
+    if (m_fontPrepared || m_fontTexture) return;
+    m_fontPrepared = true;
+    JobSystem::Instance().Submit([this] {
+        StartupProfile::Scope scope("Font atlas");
+        RasterizeFontAtlas();
+    }, &m_fontDone);
 }
 
-void GUIRenderer::CreateFontTexture() {
+void GUIRenderer::RasterizeFontAtlas() {
     // Create a texture atlas for the font
     std::vector<unsigned char> textureData(FONT_TEXTURE_SIZE * FONT_TEXTURE_SIZE, 0);
 
@@ -297,74 +321,175 @@ void GUIRenderer::CreateFontTexture() {
         }
     }
 
+    m_fontPixels = std::move(textureData);
+}
+
+void GUIRenderer::UploadFontTexture() {
+    StartupProfile::Scope scope("Font upload");
+    PrepareFontAtlas();
+    JobSystem::Instance().Wait(m_fontDone);
+
     glGenTextures(1, &m_fontTexture);
-    glBindTexture(GL_TEXTURE_2D, m_fontTexture);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RED, FONT_TEXTURE_SIZE, FONT_TEXTURE_SIZE, 0, GL_RED, GL_UNSIGNED_BYTE, textureData.data());
+    GLStateCache::Instance().BindTexture(0, GL_TEXTURE_2D, m_fontTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RED, FONT_TEXTURE_SIZE, FONT_TEXTURE_SIZE, 0, GL_RED, GL_UNSIGNED_BYTE, m_fontPixels.data());
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    m_fontPixels.clear();
+    m_fontPixels.shrink_to_fit();
+    m_fontPrepared = false;
 }
 
 void GUIRenderer::Shutdown() {
-    if (m_vao) { glDeleteVertexArrays(1, &m_vao); m_vao = 0; }
-    if (m_vbo) { glDeleteBuffers(1, &m_vbo); m_vbo = 0; }
-    if (m_fontTexture) { glDeleteTextures(1, &m_fontTexture); m_fontTexture = 0; }
+    JobSystem::Instance().Wait(m_fontDone);
+    m_fontPixels.clear();
+    m_fontPrepared = false;
+
+    auto& gl = GLStateCache::Instance();
+    if (m_vao) { glDeleteVertexArrays(1, &m_vao); gl.OnVertexArrayDeleted(m_vao); m_vao = 0; }
+    m_stream.Release();
+    m_streamVersion = 0;
+    if (m_fontTexture) { glDeleteTextures(1, &m_fontTexture); gl.OnTextureDeleted(m_fontTexture); m_fontTexture = 0; }
     m_shader.reset();
+    m_textShader.reset();
     m_initialized = false;
 }
 
 void GUIRenderer::BeginFrame(int screenWidth, int screenHeight) {
     m_screenWidth = screenWidth;
     m_screenHeight = screenHeight;
-    m_vertices.clear();
+    if (!m_fontTexture) {
+        UploadFontTexture();
+    }
+    m_frame.Clear();
+    m_target = &m_frame;
+    m_recordStack.clear();
+    m_clipRects.clear();
     m_clipStack.clear();
+    m_stream.BeginFrame();
 }
 
 void GUIRenderer::EndFrame() {
     Flush();
+    m_stream.EndFrame();
 }
 
 void GUIRenderer::Flush() {
-    if (m_vertices.empty()) return;
+    m_lastVertexCount = static_cast<uint32_t>(m_frame.m_vertices.size());
+    m_lastBatchCount = static_cast<uint32_t>(m_frame.m_batches.size());
+    if (m_frame.m_vertices.empty()) return;
+
+    // The whole frame in one write
+    size_t offset = m_stream.Write(m_frame.m_vertices.data(), m_frame.m_vertices.size() * sizeof(GUIVertex),
+                                   sizeof(GUIVertex));
+    if (offset == StreamBuffer::INVALID_OFFSET) return;
+
+    // The stream reallocated itself (a frame outgrew its region)
+    if (m_streamVersion != m_stream.GetVersion()) {
+        SetupVertexFormat();
+    }
+
+    // Setup state for 2D GUI rendering. Not restored afterwards: the 3D
+    // passes set what they need through the state cache.
+    ApplyGUIState();
 
-    // Setup state for 2D GUI rendering
-    glDisable(GL_DEPTH_TEST);
-    glDepthMask(GL_FALSE);  // Don't write to depth buffer
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    glDisable(GL_CULL_FACE);  // GUI quads may have any winding
+    auto& gl = GLStateCache::Instance();
+    gl.BindVertexArray(m_vao);
+    gl.BindTexture(0, GL_TEXTURE_2D, m_fontTexture);
 
     // Create orthographic projection
     Mat4 projection = glm::ortho(0.0f, (float)m_screenWidth, (float)m_screenHeight, 0.0f, -1.0f, 1.0f);
-
+    m_textShader->Bind();
+    m_textShader->SetMat4("u_Projection", projection);
     m_shader->Bind();
     m_shader->SetMat4("u_Projection", projection);
-    m_shader->SetInt("u_UseTexture", 0);
 
-    glBindVertexArray(m_vao);
-    glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
-    glBufferData(GL_ARRAY_BUFFER, m_vertices.size() * sizeof(GUIVertex), m_vertices.data(), GL_DYNAMIC_DRAW);
+    GLint base = static_cast<GLint>(offset / sizeof(GUIVertex));
+    bool textured = false;
+    int clip = -1;
+    for (const GUIDrawBatch& batch : m_frame.m_batches) {
+        if (batch.count == 0) continue;
+        if (batch.textured != textured) {
+            textured = batch.textured;
+            (textured ? m_textShader : m_shader)->Bind();
+        }
+        if (batch.clip != clip) {
+            clip = batch.clip;
+            SetScissor(clip);
+        }
+        glDrawArrays(GL_TRIANGLES, base + static_cast<GLint>(batch.first), static_cast<GLsizei>(batch.count));
+    }
+    if (clip != -1) SetScissor(-1);
+}
 
-    glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(m_vertices.size()));
+void GUIRenderer::SetScissor(int clip) {
+    auto& gl = GLStateCache::Instance();
+    if (clip < 0) {
+        gl.SetScissorTest(false);
+        return;
+    }
+    const Rect& rect = m_clipRects[clip];
+    gl.SetScissorTest(true);
+    glScissor(static_cast<int>(rect.x),
+              m_screenHeight - static_cast<int>(rect.y + rect.height),
+              static_cast<int>(rect.width),
+              static_cast<int>(rect.height));
+}
 
-    glBindVertexArray(0);
-    m_shader->Unbind();
+void GUIRenderer::UseBatch(bool textured) {
+    // Draw lists are clip-free; the frame takes the current clip rect
+    int clip = (m_target == &m_frame && !m_clipStack.empty()) ? m_clipStack.back() : -1;
 
-    // Restore state
-    glEnable(GL_DEPTH_TEST);
-    glDepthMask(GL_TRUE);
-    glDisable(GL_BLEND);
-    glEnable(GL_CULL_FACE);
+    auto& batches = m_target->m_batches;
+    if (!batches.empty() && batches.back().textured == textured && batches.back().clip == clip) return;
 
-    m_vertices.clear();
+    GUIDrawBatch batch;
+    batch.first = static_cast<uint32_t>(m_target->m_vertices.size());
+    batch.textured = textured;
+    batch.clip = clip;
+    batches.push_back(batch);
 }
 
 void GUIRenderer::AddVertex(float x, float y, float u, float v, const Vec4& color) {
-    m_vertices.emplace_back(x, y, u, v, color);
+    m_target->m_vertices.emplace_back(x, y, u, v, color);
+    m_target->m_batches.back().count++;
+}
+
+void GUIRenderer::BeginDrawList(GUIDrawList& list) {
+    list.Clear();
+    m_recordStack.push_back(m_target);
+    m_target = &list;
+}
+
+void GUIRenderer::EndDrawList() {
+    if (m_recordStack.empty()) return;
+    m_target = m_recordStack.back();
+    m_recordStack.pop_back();
+}
+
+void GUIRenderer::SubmitDrawList(const GUIDrawList& list, const Vec2& offset) {
+    bool moved = offset.x != 0.0f || offset.y != 0.0f;
+    for (const GUIDrawBatch& batch : list.m_batches) {
+        UseBatch(batch.textured);
+
+        auto begin = list.m_vertices.begin() + batch.first;
+        auto& vertices = m_target->m_vertices;
+        size_t start = vertices.size();
+        vertices.insert(vertices.end(), begin, begin + batch.count);
+        if (moved) {
+            for (size_t i = start; i < vertices.size(); i++) {
+                vertices[i].x += offset.x;
+                vertices[i].y += offset.y;
+            }
+        }
+        m_target->m_batches.back().count += batch.count;
+    }
 }
 
 void GUIRenderer::DrawRect(const Rect& rect, const Vec4& color) {
+    UseBatch(false);
     // Two triangles
     AddVertex(rect.x, rect.y, 0, 0, color);
     AddVertex(rect.x + rect.width, rect.y, 1, 0, color);
@@ -387,6 +512,7 @@ void GUIRenderer::DrawRectOutline(const Rect& rect, const Vec4& color, float thi
 }
 
 void GUIRenderer::DrawRectGradientV(const Rect& rect, const Vec4& topColor, const Vec4& bottomColor) {
+    UseBatch(false);
     AddVertex(rect.x, rect.y, 0, 0, topColor);
     AddVertex(rect.x + rect.width, rect.y, 1, 0, topColor);
     AddVertex(rect.x + rect.width, rect.y + rect.height, 1, 1, bottomColor);
@@ -397,6 +523,7 @@ void GUIRenderer::DrawRectGradientV(const Rect& rect, const Vec4& topColor, cons
 }
 
 void GUIRenderer::DrawRectGradientH(const Rect& rect, const Vec4& leftColor, const Vec4& rightColor) {
+    UseBatch(false);
     AddVertex(rect.x, rect.y, 0, 0, leftColor);
     AddVertex(rect.x + rect.width, rect.y, 1, 0, rightColor);
     AddVertex(rect.x + rect.width, rect.y + rect.height, 1, 1, rightColor);
@@ -419,24 +546,9 @@ void GUIRenderer::DrawBorder3D(const Rect& rect, bool raised) {
     DrawRect(Rect(rect.x + rect.width - 1, rect.y, 1, rect.height), dark);
 }
 
-void GUIRenderer::DrawText(const std::string& text, float x, float y, const Vec4& color, float scale) {
-    Flush();  // Flush non-text geometry first
-
-    // Setup for text rendering
-    glDisable(GL_DEPTH_TEST);
-    glDepthMask(GL_FALSE);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    glDisable(GL_CULL_FACE);
-
-    Mat4 projection = glm::ortho(0.0f, (float)m_screenWidth, (float)m_screenHeight, 0.0f, -1.0f, 1.0f);
-
-    m_shader->Bind();
-    m_shader->SetMat4("u_Projection", projection);
-    m_shader->SetInt("u_UseTexture", 1);
-
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, m_fontTexture);
+void GUIRenderer::DrawText(std::string_view text, float x, float y, const Vec4& color, float scale) {
+    if (text.empty()) return;
+    UseBatch(true);
 
     float charWidth = FONT_CHAR_WIDTH * scale;
     float charHeight = FONT_CHAR_HEIGHT * scale;
@@ -465,31 +577,25 @@ void GUIRenderer::DrawText(const std::string& text, float x, float y, const Vec4
 
         cursorX += charWidth;
     }
+}
 
-    // Render text
-    glBindVertexArray(m_vao);
-    glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
-    glBufferData(GL_ARRAY_BUFFER, m_vertices.size() * sizeof(GUIVertex), m_vertices.data(), GL_DYNAMIC_DRAW);
-    glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(m_vertices.size()));
-    glBindVertexArray(0);
-
-    m_vertices.clear();
-    m_shader->Unbind();
-
-    // Restore state
-    glEnable(GL_DEPTH_TEST);
-    glDepthMask(GL_TRUE);
-    glEnable(GL_CULL_FACE);
+void GUIRenderer::ApplyGUIState() {
+    auto& gl = GLStateCache::Instance();
+    gl.SetDepthTest(false);
+    gl.SetDepthWrite(false);    // Don't write to depth buffer
+    gl.SetBlend(true);
+    gl.SetBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    gl.SetCulling(false);       // GUI quads may have any winding
 }
 
-void GUIRenderer::DrawTextCentered(const std::string& text, const Rect& rect, const Vec4& color, float scale) {
+void GUIRenderer::DrawTextCentered(std::string_view text, const Rect& rect, const Vec4& color, float scale) {
     Vec2 textSize = MeasureText(text, scale);
     float x = rect.x + (rect.width - textSize.x) / 2.0f;
     float y = rect.y + (rect.height - textSize.y) / 2.0f;
     DrawText(text, x, y, color, scale);
 }
 
-Vec2 GUIRenderer::MeasureText(const std::string& text, float scale) const {
+Vec2 GUIRenderer::MeasureText(std::string_view text, float scale) const {
     float width = text.length() * FONT_CHAR_WIDTH * scale;
     float height = FONT_CHAR_HEIGHT * scale;
     return Vec2(width, height);
@@ -500,27 +606,14 @@ float GUIRenderer::GetFontHeight(float scale) const {
 }
 
 void GUIRenderer::PushClipRect(const Rect& rect) {
-    m_clipStack.push_back(rect);
-    glEnable(GL_SCISSOR_TEST);
-    glScissor(static_cast<int>(rect.x),
-              m_screenHeight - static_cast<int>(rect.y + rect.height),
-              static_cast<int>(rect.width),
-              static_cast<int>(rect.height));
+    m_clipStack.push_back(static_cast<int>(m_clipRects.size()));
+    m_clipRects.push_back(rect);
 }
 
 void GUIRenderer::PopClipRect() {
     if (!m_clipStack.empty()) {
         m_clipStack.pop_back();
     }
-    if (m_clipStack.empty()) {
-        glDisable(GL_SCISSOR_TEST);
-    } else {
-        const auto& rect = m_clipStack.back();
-        glScissor(static_cast<int>(rect.x),
-                  m_screenHeight - static_cast<int>(rect.y + rect.height),
-                  static_cast<int>(rect.width),
-                  static_cast<int>(rect.height));
-    }
 }
 
 } // namespace GUI
@@ -2,14 +2,49 @@
 
 #include "GUITypes.h"
 #include "renderer/shader/Shader.h"
+#include "renderer/StreamBuffer.h"
+#include "core/JobSystem.h"
 #include <vector>
 #include <string>
+#include <string_view>
 
 namespace Genesis {
 namespace GUI {
 
+// Run of vertices drawn with one shader (and one clip rect in a frame)
+struct GUIDrawBatch {
+    uint32_t first = 0;
+    uint32_t count = 0;
+    bool textured = false;      // Samples the font atlas
+    int clip = -1;              // Frame clip rect index, -1 = none
+};
+
+// ============================================================================
+// GUIDrawList - Retained GUI geometry
+//
+// Recorded through the normal Draw* calls between BeginDrawList() and
+// EndDrawList(), then replayed each frame with SubmitDrawList() until its
+// owner's content or layout changes. Replaying is a copy into the frame
+// batches, not a rebuild (no glyph lookups, no string work).
+// ============================================================================
+class GUIDrawList {
+public:
+    void Clear() { m_vertices.clear(); m_batches.clear(); }
+    bool IsEmpty() const { return m_vertices.empty(); }
+    size_t GetVertexCount() const { return m_vertices.size(); }
+
+private:
+    friend class GUIRenderer;
+    std::vector<GUIVertex> m_vertices;
+    std::vector<GUIDrawBatch> m_batches;
+};
+
 // ============================================================================
 // GUIRenderer - Low-level GUI rendering backend
+//
+// Draw calls only append vertices to the frame's batches; EndFrame() writes
+// them to the stream once and issues one draw per batch (a batch breaks
+// where text and solid geometry alternate or the clip rect changes).
 // ============================================================================
 class GUIRenderer {
 public:
@@ -21,6 +56,11 @@ public:
     bool Initialize();
     void Shutdown();
 
+    // Rasterize the font atlas on a job, before there is a GL context (as
+    // early in startup as possible); Initialize() starts it otherwise. The
+    // texture is uploaded by the first BeginFrame().
+    void PrepareFontAtlas();
+
     // Begin/End frame
     void BeginFrame(int screenWidth, int screenHeight);
     void EndFrame();
@@ -38,35 +78,76 @@ public:
     void DrawBorder3D(const Rect& rect, bool raised = true);
 
     // Text drawing (simple bitmap font)
-    void DrawText(const std::string& text, float x, float y, const Vec4& color, float scale = 1.0f);
-    void DrawTextCentered(const std::string& text, const Rect& rect, const Vec4& color, float scale = 1.0f);
+    void DrawText(std::string_view text, float x, float y, const Vec4& color, float scale = 1.0f);
+    void DrawTextCentered(std::string_view text, const Rect& rect, const Vec4& color, float scale = 1.0f);
 
     // Get text dimensions
-    Vec2 MeasureText(const std::string& text, float scale = 1.0f) const;
+    Vec2 MeasureText(std::string_view text, float scale = 1.0f) const;
     float GetFontHeight(float scale = 1.0f) const;
 
     // ========================================================================
     // Scissor/Clipping
     // ========================================================================
 
+    // Applies to everything drawn or submitted until the matching pop
+    // (not recorded into draw lists)
     void PushClipRect(const Rect& rect);
     void PopClipRect();
 
+    // ========================================================================
+    // Retained draw lists
+    // ========================================================================
+
+    // Draw* calls in between go into list (cleared first) instead of the
+    // frame. Recording nests: EndDrawList() returns to the list before.
+    void BeginDrawList(GUIDrawList& list);
+    void EndDrawList();
+
+    // Append a recorded list to the frame, moved by offset
+    void SubmitDrawList(const GUIDrawList& list, const Vec2& offset = Vec2(0.0f));
+
+    // ========================================================================
+    // Statistics (last EndFrame)
+    // ========================================================================
+    uint32_t GetVertexCount() const { return m_lastVertexCount; }
+    uint32_t GetBatchCount() const { return m_lastBatchCount; }
+
 private:
     GUIRenderer() = default;
 
     void Flush();
+    void SetupVertexFormat();
+    void UseBatch(bool textured);
     void AddVertex(float x, float y, float u, float v, const Vec4& color);
-    void CreateFontTexture();
+    void SetScissor(int clip);
+    void RasterizeFontAtlas();
+    void UploadFontTexture();
+
+    // Depth off, alpha blending, no culling (through GLStateCache)
+    void ApplyGUIState();
 
 private:
-    std::shared_ptr<Shader> m_shader;
+    std::shared_ptr<Shader> m_shader;       // Solid quads
+    std::shared_ptr<Shader> m_textShader;   // Same source with USE_TEXTURE
     unsigned int m_vao = 0;
-    unsigned int m_vbo = 0;
+    StreamBuffer m_stream;
+    uint32_t m_streamVersion = 0;   // Stream version m_vao points at
     unsigned int m_fontTexture = 0;
+    std::vector<unsigned char> m_fontPixels;    // Rasterized, not uploaded yet
+    JobCounter m_fontDone;
+    bool m_fontPrepared = false;
 
-    std::vector<GUIVertex> m_vertices;
-    std::vector<Rect> m_clipStack;
+    // The frame, and the list Draw* calls currently append to (the frame,
+    // or a draw list being recorded)
+    GUIDrawList m_frame;
+    GUIDrawList* m_target = &m_frame;
+    std::vector<GUIDrawList*> m_recordStack;    // Targets to return to
+
+    std::vector<Rect> m_clipRects;      // Every clip rect pushed this frame
+    std::vector<int> m_clipStack;       // Indices into m_clipRects
+
+    uint32_t m_lastVertexCount = 0;
+    uint32_t m_lastBatchCount = 0;
 
     int m_screenWidth = 1280;
     int m_screenHeight = 720;
@@ -77,6 +158,8 @@ private:
     static constexpr int FONT_CHAR_WIDTH = 8;
     static constexpr int FONT_CHAR_HEIGHT = 12;
     static constexpr int FONT_TEXTURE_SIZE = 128;
+
+    static constexpr size_t STREAM_FRAME_BYTES = 256 * 1024;
 };
 
 } // namespace GUI
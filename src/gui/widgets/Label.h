@@ -19,20 +19,24 @@ public:
         m_rect = Rect(x, y, 100, 16);
     }
 
-    void SetText(const std::string& text) { m_text = text; }
+    void SetText(const std::string& text) { if (m_text != text) { m_text = text; Invalidate(); } }
     const std::string& GetText() const { return m_text; }
 
-    void SetColor(const Vec4& color) { m_color = color; }
+    void SetColor(const Vec4& color) { m_color = color; Invalidate(); }
     const Vec4& GetColor() const { return m_color; }
 
-    void SetScale(float scale) { m_scale = scale; }
+    void SetScale(float scale) { m_scale = scale; Invalidate(); }
     float GetScale() const { return m_scale; }
 
-    void SetAlignment(int align) { m_alignment = align; } // 0=left, 1=center, 2=right
+    void SetAlignment(int align) { m_alignment = align; Invalidate(); } // 0=left, 1=center, 2=right
 
     void Render(GUIRenderer& renderer) override {
         if (!m_visible) return;
+        RenderCached(renderer);
+    }
 
+protected:
+    void BuildDrawList(GUIRenderer& renderer) override {
         Vec4 color = m_enabled ? m_color : Colors::TextDisabled;
 
         if (m_alignment == 1) {  // Center
@@ -21,13 +21,13 @@ public:
         m_rect = Rect(x, y, width, height);
     }
 
-    void SetTitle(const std::string& title) { m_title = title; }
+    void SetTitle(const std::string& title) { if (m_title != title) { m_title = title; Invalidate(); } }
     const std::string& GetTitle() const { return m_title; }
 
     void SetDraggable(bool draggable) { m_draggable = draggable; }
     bool IsDraggable() const { return m_draggable; }
 
-    void SetCloseable(bool closeable) { m_closeable = closeable; }
+    void SetCloseable(bool closeable) { m_closeable = closeable; Invalidate(); }
     bool IsCloseable() const { return m_closeable; }
 
     // Child widget management
@@ -54,35 +54,8 @@ public:
     void Render(GUIRenderer& renderer) override {
         if (!m_visible) return;
 
-        // Panel background with gradient
-        renderer.DrawRectGradientV(m_rect, Colors::PanelHeader, Colors::PanelBackground);
-
-        // 3D border
-        renderer.DrawBorder3D(m_rect, true);
-
-        // Title bar
-        float titleBarHeight = 24;
-        Rect titleRect(m_rect.x, m_rect.y, m_rect.width, titleBarHeight);
-        renderer.DrawRectGradientV(titleRect, Colors::TitleBarGradientTop, Colors::TitleBarGradientBottom);
-
-        // Red accent line at top
-        renderer.DrawRect(Rect(m_rect.x, m_rect.y, m_rect.width, 2), Colors::Accent);
-
-        // Title text
-        renderer.DrawText(m_title, m_rect.x + 8, m_rect.y + 6, Colors::TextHighlight, 1.0f);
-
-        // Close button (if closeable)
-        if (m_closeable) {
-            float closeSize = 16;
-            Rect closeRect(m_rect.x + m_rect.width - closeSize - 4, m_rect.y + 4, closeSize, closeSize);
-
-            Vec4 closeColor = m_closeHovered ? Colors::AccentHover : Colors::Accent;
-            renderer.DrawRect(closeRect, closeColor);
-            renderer.DrawBorder3D(closeRect, !m_closePressed);
-
-            // X mark
-            renderer.DrawText("X", closeRect.x + 4, closeRect.y + 2, Colors::TextHighlight, 1.0f);
-        }
+        // The frame is retained; children keep their own lists
+        RenderCached(renderer);
 
         // Render children (offset by title bar)
         for (auto& child : m_children) {
@@ -98,13 +71,18 @@ public:
         if (m_closeable) {
             float closeSize = 16;
             Rect closeRect(m_rect.x + m_rect.width - closeSize - 4, m_rect.y + 4, closeSize, closeSize);
-            m_closeHovered = closeRect.Contains(x, y);
+            bool closeHovered = closeRect.Contains(x, y);
+            if (closeHovered != m_closeHovered) {
+                m_closeHovered = closeHovered;
+                Invalidate();
+            }
         }
 
         // Handle dragging
         if (m_dragging) {
             m_rect.x = x - m_dragOffsetX;
             m_rect.y = y - m_dragOffsetY;
+            Invalidate();
             return true;
         }
 
@@ -125,6 +103,7 @@ public:
             Rect closeRect(m_rect.x + m_rect.width - closeSize - 4, m_rect.y + 4, closeSize, closeSize);
             if (closeRect.Contains(x, y)) {
                 m_closePressed = true;
+                Invalidate();
                 return true;
             }
         }
@@ -155,6 +134,7 @@ public:
         // Check close button click
         if (m_closeable && m_closePressed) {
             m_closePressed = false;
+            Invalidate();
             float closeSize = 16;
             Rect closeRect(m_rect.x + m_rect.width - closeSize - 4, m_rect.y + 4, closeSize, closeSize);
             if (closeRect.Contains(x, y)) {
@@ -181,6 +161,39 @@ public:
                    m_rect.width - 8, m_rect.height - titleBarHeight - 8);
     }
 
+protected:
+    void BuildDrawList(GUIRenderer& renderer) override {
+        // Panel background with gradient
+        renderer.DrawRectGradientV(m_rect, Colors::PanelHeader, Colors::PanelBackground);
+
+        // 3D border
+        renderer.DrawBorder3D(m_rect, true);
+
+        // Title bar
+        float titleBarHeight = 24;
+        Rect titleRect(m_rect.x, m_rect.y, m_rect.width, titleBarHeight);
+        renderer.DrawRectGradientV(titleRect, Colors::TitleBarGradientTop, Colors::TitleBarGradientBottom);
+
+        // Red accent line at top
+        renderer.DrawRect(Rect(m_rect.x, m_rect.y, m_rect.width, 2), Colors::Accent);
+
+        // Title text
+        renderer.DrawText(m_title, m_rect.x + 8, m_rect.y + 6, Colors::TextHighlight, 1.0f);
+
+        // Close button (if closeable)
+        if (m_closeable) {
+            float closeSize = 16;
+            Rect closeRect(m_rect.x + m_rect.width - closeSize - 4, m_rect.y + 4, closeSize, closeSize);
+
+            Vec4 closeColor = m_closeHovered ? Colors::AccentHover : Colors::Accent;
+            renderer.DrawRect(closeRect, closeColor);
+            renderer.DrawBorder3D(closeRect, !m_closePressed);
+
+            // X mark
+            renderer.DrawText("X", closeRect.x + 4, closeRect.y + 2, Colors::TextHighlight, 1.0f);
+        }
+    }
+
 private:
     std::string m_title;
     std::vector<std::shared_ptr<Widget>> m_children;
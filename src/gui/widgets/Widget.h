@@ -38,9 +38,9 @@ public:
     // ========================================================================
     // Position and Size
     // ========================================================================
-    void SetPosition(float x, float y) { m_rect.x = x; m_rect.y = y; }
-    void SetSize(float width, float height) { m_rect.width = width; m_rect.height = height; }
-    void SetRect(const Rect& rect) { m_rect = rect; }
+    void SetPosition(float x, float y) { m_rect.x = x; m_rect.y = y; Invalidate(); }
+    void SetSize(float width, float height) { m_rect.width = width; m_rect.height = height; Invalidate(); }
+    void SetRect(const Rect& rect) { m_rect = rect; Invalidate(); }
     const Rect& GetRect() const { return m_rect; }
 
     float GetX() const { return m_rect.x; }
@@ -54,14 +54,18 @@ public:
     void SetVisible(bool visible) { m_visible = visible; }
     bool IsVisible() const { return m_visible; }
 
-    void SetEnabled(bool enabled) { m_enabled = enabled; }
+    void SetEnabled(bool enabled) { if (m_enabled != enabled) { m_enabled = enabled; Invalidate(); } }
     bool IsEnabled() const { return m_enabled; }
 
-    void SetFocused(bool focused) { m_focused = focused; }
+    void SetFocused(bool focused) { if (m_focused != focused) { m_focused = focused; Invalidate(); } }
     bool IsFocused() const { return m_focused; }
 
     WidgetState GetState() const { return m_state; }
 
+    // Content, layout or state changed: retained widgets rebuild their
+    // draw list on the next Render
+    void Invalidate() { m_dirty = true; }
+
     // ========================================================================
     // Input handling
     // ========================================================================
@@ -86,6 +90,23 @@ protected:
         return m_rect.Contains(x, y);
     }
 
+    void SetState(WidgetState state) {
+        if (m_state != state) { m_state = state; Invalidate(); }
+    }
+
+    // Retained rendering: replays m_drawList, recording it again through
+    // BuildDrawList() only after Invalidate()
+    virtual void BuildDrawList(GUIRenderer& renderer) {}
+    void RenderCached(GUIRenderer& renderer) {
+        if (m_dirty) {
+            renderer.BeginDrawList(m_drawList);
+            BuildDrawList(renderer);
+            renderer.EndDrawList();
+            m_dirty = false;
+        }
+        renderer.SubmitDrawList(m_drawList);
+    }
+
 protected:
     Rect m_rect;
     std::string m_id;
@@ -97,6 +118,9 @@ protected:
     bool m_hovered = false;
 
     WidgetState m_state = WidgetState::Normal;
+
+    GUIDrawList m_drawList;
+    bool m_dirty = true;
 };
 
 // ============================================================================
@@ -109,9 +133,9 @@ inline bool Widget::OnMouseMove(float x, float y) {
     m_hovered = ContainsPoint(x, y);
 
     if (m_hovered && m_state != WidgetState::Pressed) {
-        m_state = WidgetState::Hovered;
+        SetState(WidgetState::Hovered);
     } else if (!m_hovered && m_state == WidgetState::Hovered) {
-        m_state = WidgetState::Normal;
+        SetState(WidgetState::Normal);
     }
 
     return m_hovered;
@@ -121,8 +145,8 @@ inline bool Widget::OnMouseDown(float x, float y, int button) {
     if (!m_visible || !m_enabled) return false;
 
     if (ContainsPoint(x, y)) {
-        m_state = WidgetState::Pressed;
-        m_focused = true;
+        SetState(WidgetState::Pressed);
+        SetFocused(true);
         return true;
     }
     return false;
@@ -132,11 +156,7 @@ inline bool Widget::OnMouseUp(float x, float y, int button) {
     if (!m_visible || !m_enabled) return false;
 
     bool wasPressed = (m_state == WidgetState::Pressed);
-    if (m_hovered) {
-        m_state = WidgetState::Hovered;
-    } else {
-        m_state = WidgetState::Normal;
-    }
+    SetState(m_hovered ? WidgetState::Hovered : WidgetState::Normal);
 
     return wasPressed && ContainsPoint(x, y);
 }
@@ -155,4 +175,3 @@ inline bool Widget::OnCharInput(unsigned int codepoint) {
 
 } // namespace GUI
 } // namespace Genesis
-ll
\ No newline at end of file
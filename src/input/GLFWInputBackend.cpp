@@ -49,6 +49,9 @@ void GLFWInputBackend::Update() {
     m_keysPrevious = m_keysCurrent;
     m_mouseButtonsPrevious = m_mouseButtonsCurrent;
 
+    // Presses that came in during last frame's late poll count for this frame
+    ReplayDeferredEvents();
+
     // Transfer accumulated mouse delta and reset accumulator
     m_mouseDeltaX = m_accumulatedDeltaX;
     m_mouseDeltaY = m_accumulatedDeltaY;
@@ -131,6 +134,12 @@ void GLFWInputBackend::SetCursorMode(bool locked) {
     glfwSetInputMode(m_window, GLFW_CURSOR,
                      locked ? GLFW_CURSOR_DISABLED : GLFW_CURSOR_NORMAL);
 
+    // Raw (unaccelerated, unscaled) motion while the cursor is captured
+    if (glfwRawMouseMotionSupported()) {
+        glfwSetInputMode(m_window, GLFW_RAW_MOUSE_MOTION, locked ? GLFW_TRUE : GLFW_FALSE);
+        m_rawMouseMotion = locked;
+    }
+
     if (locked) {
         m_firstMouse = true; // Reset to avoid jump when locking
     }
@@ -349,9 +358,23 @@ static MouseButton FromGLFWMouseButton(int glfwButton) {
 }
 
 // ============================================================================
-// Forward Key Events (used by Engine when it intercepts callbacks)
+// Event Handling
 // ============================================================================
-void GLFWInputBackend::ForwardKeyEvent(int glfwKey, int action) {
+void GLFWInputBackend::PushEvent(InputEventType type, uint16_t code, bool down, double dx, double dy) {
+    // GLFW has no OS event times; the callback runs as the event is read
+    InputEvent event;
+    event.timestamp = glfwGetTime();
+    event.type = type;
+    event.code = code;
+    event.down = down;
+    event.dx = dx;
+    event.dy = dy;
+    if (!m_events.TryPush(event)) {
+        m_droppedEvents++;
+    }
+}
+
+void GLFWInputBackend::OnKey(int glfwKey, int action) {
     KeyCode keyCode = FromGLFWKey(glfwKey);
     if (keyCode == KeyCode::Unknown) return;
 
@@ -359,9 +382,12 @@ void GLFWInputBackend::ForwardKeyEvent(int glfwKey, int action) {
     if (index < m_keysCurrent.size()) {
         m_keysCurrent[index] = (action != GLFW_RELEASE);
     }
+    if (action != GLFW_REPEAT) {
+        PushEvent(InputEventType::Key, static_cast<uint16_t>(keyCode), action == GLFW_PRESS, 0.0, 0.0);
+    }
 }
 
-void GLFWInputBackend::ForwardMouseButtonEvent(int glfwButton, int action) {
+void GLFWInputBackend::OnMouseButton(int glfwButton, int action) {
     MouseButton mb = FromGLFWMouseButton(glfwButton);
     if (mb == MouseButton::Unknown) return;
 
@@ -369,62 +395,136 @@ void GLFWInputBackend::ForwardMouseButtonEvent(int glfwButton, int action) {
     if (index < m_mouseButtonsCurrent.size()) {
         m_mouseButtonsCurrent[index] = (action != GLFW_RELEASE);
     }
+    PushEvent(InputEventType::MouseButton, static_cast<uint16_t>(mb), action == GLFW_PRESS, 0.0, 0.0);
 }
 
-void GLFWInputBackend::ForwardCursorPosEvent(double xpos, double ypos) {
-    // Accumulate delta from cursor movement
+void GLFWInputBackend::OnCursorPos(double xpos, double ypos) {
     if (!m_firstMouse) {
-        m_accumulatedDeltaX += xpos - m_mouseX;
-        m_accumulatedDeltaY += ypos - m_mouseY;
+        double dx = xpos - m_mouseX;
+        double dy = ypos - m_mouseY;
+
+        // Late motion was already consumed before rendering; it only goes
+        // to the event stream
+        if (!m_latePolling) {
+            m_accumulatedDeltaX += dx;
+            m_accumulatedDeltaY += dy;
+        }
+        PushEvent(InputEventType::MouseMotion, 0, false, dx, dy);
     }
 
     m_mouseX = xpos;
     m_mouseY = ypos;
 }
 
+void GLFWInputBackend::OnScroll(double yoffset) {
+    m_scrollAccumulator += yoffset;
+    PushEvent(InputEventType::Scroll, 0, false, 0.0, yoffset);
+}
+
 // ============================================================================
-// GLFW Callbacks
+// Late Poll
 // ============================================================================
-void GLFWInputBackend::KeyCallback(GLFWwindow* window, int key, int scancode, int action, int mods) {
+void GLFWInputBackend::PollLateEvents() {
+    if (!m_window) return;
+
+    // Only cursor motion goes through live; keys, text, buttons and scroll
+    // are recorded (they would otherwise land after this frame's Update and
+    // lose their pressed/released edge)
+    m_keyCallback = glfwSetKeyCallback(m_window, DeferKeyCallback);
+    m_charCallback = glfwSetCharCallback(m_window, DeferCharCallback);
+    m_mouseButtonCallback = glfwSetMouseButtonCallback(m_window, DeferMouseButtonCallback);
+    m_scrollCallback = glfwSetScrollCallback(m_window, DeferScrollCallback);
+
+    m_latePolling = true;
+    glfwPollEvents();
+    m_latePolling = false;
+
+    glfwSetKeyCallback(m_window, m_keyCallback);
+    glfwSetCharCallback(m_window, m_charCallback);
+    glfwSetMouseButtonCallback(m_window, m_mouseButtonCallback);
+    glfwSetScrollCallback(m_window, m_scrollCallback);
+}
+
+void GLFWInputBackend::ReplayDeferredEvents() {
+    if (m_deferred.empty()) return;
+
+    // Through the callbacks that were installed, so the Engine (console,
+    // bindings) sees them like any other event
+    for (const DeferredEvent& event : m_deferred) {
+        switch (event.kind) {
+            case DeferredEvent::Kind::Key:
+                if (m_keyCallback) m_keyCallback(m_window, event.a, event.b, event.c, event.d);
+                break;
+            case DeferredEvent::Kind::Char:
+                if (m_charCallback) m_charCallback(m_window, static_cast<unsigned int>(event.a));
+                break;
+            case DeferredEvent::Kind::MouseButton:
+                if (m_mouseButtonCallback) m_mouseButtonCallback(m_window, event.a, event.b, event.c);
+                break;
+            case DeferredEvent::Kind::Scroll:
+                if (m_scrollCallback) m_scrollCallback(m_window, event.x, event.y);
+                break;
+        }
+    }
+    m_deferred.clear();
+}
+
+void GLFWInputBackend::DeferKeyCallback(GLFWwindow* window, int key, int scancode, int action, int mods) {
     if (!s_instance) return;
+    s_instance->m_deferred.push_back({DeferredEvent::Kind::Key, key, scancode, action, mods});
+}
 
-    KeyCode keyCode = FromGLFWKey(key);
-    if (keyCode == KeyCode::Unknown) return;
+void GLFWInputBackend::DeferCharCallback(GLFWwindow* window, unsigned int codepoint) {
+    if (!s_instance) return;
+    s_instance->m_deferred.push_back({DeferredEvent::Kind::Char, static_cast<int>(codepoint)});
+}
 
-    size_t index = static_cast<size_t>(keyCode);
-    if (index < s_instance->m_keysCurrent.size()) {
-        s_instance->m_keysCurrent[index] = (action != GLFW_RELEASE);
-    }
+void GLFWInputBackend::DeferMouseButtonCallback(GLFWwindow* window, int button, int action, int mods) {
+    if (!s_instance) return;
+    s_instance->m_deferred.push_back({DeferredEvent::Kind::MouseButton, button, action, mods});
 }
 
-void GLFWInputBackend::MouseButtonCallback(GLFWwindow* window, int button, int action, int mods) {
+void GLFWInputBackend::DeferScrollCallback(GLFWwindow* window, double xoffset, double yoffset) {
     if (!s_instance) return;
+    s_instance->m_deferred.push_back({DeferredEvent::Kind::Scroll, 0, 0, 0, 0, xoffset, yoffset});
+}
 
-    MouseButton mb = FromGLFWMouseButton(button);
-    if (mb == MouseButton::Unknown) return;
+// ============================================================================
+// Forward Key Events (used by Engine when it intercepts callbacks)
+// ============================================================================
+void GLFWInputBackend::ForwardKeyEvent(int glfwKey, int action) {
+    OnKey(glfwKey, action);
+}
 
-    size_t index = static_cast<size_t>(mb);
-    if (index < s_instance->m_mouseButtonsCurrent.size()) {
-        s_instance->m_mouseButtonsCurrent[index] = (action != GLFW_RELEASE);
-    }
+void GLFWInputBackend::ForwardMouseButtonEvent(int glfwButton, int action) {
+    OnMouseButton(glfwButton, action);
 }
 
-void GLFWInputBackend::CursorPosCallback(GLFWwindow* window, double xpos, double ypos) {
+void GLFWInputBackend::ForwardCursorPosEvent(double xpos, double ypos) {
+    OnCursorPos(xpos, ypos);
+}
+
+// ============================================================================
+// GLFW Callbacks
+// ============================================================================
+void GLFWInputBackend::KeyCallback(GLFWwindow* window, int key, int scancode, int action, int mods) {
     if (!s_instance) return;
+    s_instance->OnKey(key, action);
+}
 
-    // Accumulate delta from cursor movement
-    if (!s_instance->m_firstMouse) {
-        s_instance->m_accumulatedDeltaX += xpos - s_instance->m_mouseX;
-        s_instance->m_accumulatedDeltaY += ypos - s_instance->m_mouseY;
-    }
+void GLFWInputBackend::MouseButtonCallback(GLFWwindow* window, int button, int action, int mods) {
+    if (!s_instance) return;
+    s_instance->OnMouseButton(button, action);
+}
 
-    s_instance->m_mouseX = xpos;
-    s_instance->m_mouseY = ypos;
+void GLFWInputBackend::CursorPosCallback(GLFWwindow* window, double xpos, double ypos) {
+    if (!s_instance) return;
+    s_instance->OnCursorPos(xpos, ypos);
 }
 
 void GLFWInputBackend::ScrollCallback(GLFWwindow* window, double xoffset, double yoffset) {
     if (!s_instance) return;
-    s_instance->m_scrollAccumulator += yoffset;
+    s_instance->OnScroll(yoffset);
 }
 
 } // namespace Genesis
@@ -3,11 +3,19 @@
 #include "IInputBackend.h"
 #include <GLFW/glfw3.h>
 #include <array>
+#include <vector>
 
 namespace Genesis {
 
 // ============================================================================
 // GLFW Input Backend Implementation
+//
+// Besides the per-frame key/button state, every callback also pushes a
+// timestamped InputEvent into the backend's event queue. With the cursor
+// captured, motion is GLFW raw motion where the platform supports it.
+// GLFW only delivers events on the main thread inside glfwPollEvents, so
+// PollLateEvents() polls once more right before rendering to pick up the
+// motion that arrived during the frame.
 // ============================================================================
 class GLFWInputBackend : public IInputBackend {
 public:
@@ -40,6 +48,13 @@ public:
     void SetCursorMode(bool locked) override;
     bool IsCursorLocked() const override;
 
+    // Event stream
+    InputEventQueue* GetEventQueue() override { return &m_events; }
+    void PollLateEvents() override;
+
+    bool IsRawMouseMotion() const { return m_rawMouseMotion; }
+    uint32_t GetDroppedEventCount() const { return m_droppedEvents; }
+
     // Forward key events from external callbacks (used by Engine)
     void ForwardKeyEvent(int glfwKey, int action);
     void ForwardMouseButtonEvent(int glfwButton, int action);
@@ -50,12 +65,26 @@ private:
     static int ToGLFWKey(KeyCode key);
     static int ToGLFWMouseButton(MouseButton button);
 
+    // Shared by the GLFW callbacks and the Forward* entry points
+    void OnKey(int glfwKey, int action);
+    void OnMouseButton(int glfwButton, int action);
+    void OnCursorPos(double xpos, double ypos);
+    void OnScroll(double yoffset);
+    void PushEvent(InputEventType type, uint16_t code, bool down, double dx, double dy);
+    void ReplayDeferredEvents();
+
     // GLFW callbacks (static for C callback compatibility)
     static void KeyCallback(GLFWwindow* window, int key, int scancode, int action, int mods);
     static void MouseButtonCallback(GLFWwindow* window, int button, int action, int mods);
     static void CursorPosCallback(GLFWwindow* window, double xpos, double ypos);
     static void ScrollCallback(GLFWwindow* window, double xoffset, double yoffset);
 
+    // Installed for the length of PollLateEvents: record, replay in Update()
+    static void DeferKeyCallback(GLFWwindow* window, int key, int scancode, int action, int mods);
+    static void DeferCharCallback(GLFWwindow* window, unsigned int codepoint);
+    static void DeferMouseButtonCallback(GLFWwindow* window, int button, int action, int mods);
+    static void DeferScrollCallback(GLFWwindow* window, double xoffset, double yoffset);
+
 private:
     GLFWwindow* m_window = nullptr;
 
@@ -81,6 +110,26 @@ private:
 
     // Cursor mode
     bool m_cursorLocked = false;
+    bool m_rawMouseMotion = false;
+
+    // Timestamped events for InputManager
+    InputEventQueue m_events;
+    uint32_t m_droppedEvents = 0;
+
+    // Late poll: non-motion events held back for the next Update(), and the
+    // callbacks (ours or the Engine's) they are replayed through
+    struct DeferredEvent {
+        enum class Kind : uint8_t { Key, Char, MouseButton, Scroll };
+        Kind kind;
+        int a = 0, b = 0, c = 0, d = 0;
+        double x = 0.0, y = 0.0;
+    };
+    std::vector<DeferredEvent> m_deferred;
+    GLFWkeyfun m_keyCallback = nullptr;
+    GLFWcharfun m_charCallback = nullptr;
+    GLFWmousebuttonfun m_mouseButtonCallback = nullptr;
+    GLFWscrollfun m_scrollCallback = nullptr;
+    bool m_latePolling = false;
 
     // Static instance for callbacks
     static GLFWInputBackend* s_instance;
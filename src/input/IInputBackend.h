@@ -1,10 +1,14 @@
 #pragma once
 
 #include "InputTypes.h"
+#include "core/SpscQueue.h"
 #include <functional>
 
 namespace Genesis {
 
+// Events in flight between a backend (producer) and InputManager (consumer)
+using InputEventQueue = SpscQueue<InputEvent, 1024>;
+
 // ============================================================================
 // Input Interface - Abstract base for all input implementations
 // ============================================================================
@@ -40,6 +44,16 @@ public:
     virtual void SetCursorMode(bool locked) = 0;
     virtual bool IsCursorLocked() const = 0;
 
+    // Timestamped event stream, for backends that have one (nullptr = state
+    // queries only). The backend pushes from wherever its events arrive
+    // (window callbacks, an input thread); InputManager is the one consumer.
+    virtual InputEventQueue* GetEventQueue() { return nullptr; }
+
+    // Gather mouse motion that arrived since the last poll, just before
+    // rendering. Anything else that comes in is held back until the next
+    // Update(), so per-frame pressed/released edges are not lost.
+    virtual void PollLateEvents() {}
+
     // Gamepad (future)
     virtual bool IsGamepadConnected(int gamepadId) const { return false; }
     virtual float GetGamepadAxis(int gamepadId, int axis) const { return 0.0f; }
@@ -24,6 +24,7 @@
 // Action-based input (recommended):
 //   if (input.IsActionPressed(Genesis::GameAction::Jump)) { ... }
 //   if (input.IsActionDown(Genesis::GameAction::MoveForward)) { ... }
+//   Genesis::ActionState actions = input.GetActionState();   // Store per tick
 //
 // Direct input (when needed):
 //   if (input.IsKeyPressed(Genesis::KeyCode::Space)) { ... }
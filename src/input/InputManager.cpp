@@ -1,5 +1,6 @@
 #include "InputManager.h"
 #include "gui/Console.h"
+#include <algorithm>
 #include <iostream>
 
 namespace Genesis {
@@ -19,7 +20,7 @@ void InputManager::Shutdown() {
     if (m_backend) {
         m_backend->Shutdown();
     }
-    m_bindings.clear();
+    ClearBindings();
 }
 
 void InputManager::Update() {
@@ -34,66 +35,105 @@ void InputManager::Update() {
 }
 
 // ============================================================================
-// Action Bindings
+// Event Stream
 // ============================================================================
-void InputManager::BindAction(GameAction action, InputBinding binding) {
-    m_bindings[action].push_back(binding);
+void InputManager::DrainEvents(double& dx, double& dy) {
+    dx = dy = 0.0;
+    InputEventQueue* queue = m_backend ? m_backend->GetEventQueue() : nullptr;
+    if (!queue) return;
+
+    InputEvent event;
+    while (queue->TryPop(event)) {
+        m_lastEventTime = event.timestamp;
+        if (event.type == InputEventType::MouseMotion) {
+            dx += event.dx;
+            dy += event.dy;
+        }
+        m_frameEvents.push_back(event);
+    }
 }
 
-void InputManager::UnbindAction(GameAction action) {
-    m_bindings.erase(action);
+void InputManager::ProcessEvents() {
+    UpdateActionState();
+
+    m_frameEvents.clear();
+    DrainEvents(m_mouseDeltaX, m_mouseDeltaY);
 }
 
-void InputManager::ClearBindings() {
-    m_bindings.clear();
+bool InputManager::LatchMouseDelta(double& dx, double& dy) {
+    dx = dy = 0.0;
+    if (!m_backend || !m_backend->GetEventQueue()) return false;
+
+    m_backend->PollLateEvents();
+    DrainEvents(dx, dy);
+    return true;
 }
 
-bool InputManager::CheckBinding(const InputBinding& binding,
-                                 bool (IInputBackend::*keyCheck)(KeyCode) const,
-                                 bool (IInputBackend::*mouseCheck)(MouseButton) const) const {
-    if (!m_backend) return false;
+// ============================================================================
+// Action Bindings
+// ============================================================================
+void InputManager::BindAction(GameAction action, InputBinding binding) {
+    size_t index = static_cast<size_t>(action);
+    if (index >= m_bindings.size()) return;
 
-    if (binding.type == InputBinding::Type::Key) {
-        return (m_backend.get()->*keyCheck)(binding.key);
-    } else {
-        return (m_backend.get()->*mouseCheck)(binding.mouseButton);
-    }
+    m_bindings[index].push_back(binding);
+    CompileBindings();
 }
 
-bool InputManager::IsActionDown(GameAction action) const {
-    auto it = m_bindings.find(action);
-    if (it == m_bindings.end()) return false;
+void InputManager::UnbindAction(GameAction action) {
+    size_t index = static_cast<size_t>(action);
+    if (index >= m_bindings.size()) return;
 
-    for (const auto& binding : it->second) {
-        if (CheckBinding(binding, &IInputBackend::IsKeyDown, &IInputBackend::IsMouseButtonDown)) {
-            return true;
-        }
-    }
-    return false;
+    m_bindings[index].clear();
+    CompileBindings();
 }
 
-bool InputManager::IsActionPressed(GameAction action) const {
-    auto it = m_bindings.find(action);
-    if (it == m_bindings.end()) return false;
+void InputManager::ClearBindings() {
+    for (auto& bindings : m_bindings) {
+        bindings.clear();
+    }
+    CompileBindings();
+}
 
-    for (const auto& binding : it->second) {
-        if (CheckBinding(binding, &IInputBackend::IsKeyPressed, &IInputBackend::IsMouseButtonPressed)) {
-            return true;
+void InputManager::CompileBindings() {
+    m_boundInputs.clear();
+    for (size_t action = 0; action < m_bindings.size(); action++) {
+        ActionMask bit = ActionBit(static_cast<GameAction>(action));
+        for (const InputBinding& binding : m_bindings[action]) {
+            uint16_t code = binding.type == InputBinding::Type::Key
+                ? static_cast<uint16_t>(binding.key)
+                : static_cast<uint16_t>(binding.mouseButton);
+
+            auto it = std::find_if(m_boundInputs.begin(), m_boundInputs.end(), [&](const BoundInput& input) {
+                return input.type == binding.type && input.code == code;
+            });
+            if (it != m_boundInputs.end()) {
+                it->actions |= bit;
+            } else {
+                m_boundInputs.push_back({binding.type, code, bit});
+            }
         }
     }
-    return false;
-}
 
-bool InputManager::IsActionReleased(GameAction action) const {
-    auto it = m_bindings.find(action);
-    if (it == m_bindings.end()) return false;
+    // Drop bits of actions that lost their bindings (no released edge)
+    ActionMask bound = 0;
+    for (const BoundInput& input : m_boundInputs) bound |= input.actions;
+    m_actionState.down &= bound;
+    m_actionState.pressed &= bound;
+    m_actionState.released &= bound;
+}
 
-    for (const auto& binding : it->second) {
-        if (CheckBinding(binding, &IInputBackend::IsKeyReleased, &IInputBackend::IsMouseButtonReleased)) {
-            return true;
+void InputManager::UpdateActionState() {
+    ActionMask down = 0;
+    if (m_backend) {
+        for (const BoundInput& input : m_boundInputs) {
+            bool held = input.type == InputBinding::Type::Key
+                ? m_backend->IsKeyDown(static_cast<KeyCode>(input.code))
+                : m_backend->IsMouseButtonDown(static_cast<MouseButton>(input.code));
+            if (held) down |= input.actions;
         }
     }
-    return false;
+    m_actionState = ActionState::FromDown(m_actionState.down, down);
 }
 
 // ============================================================================
@@ -132,7 +172,12 @@ void InputManager::GetMousePosition(double& x, double& y) const {
 }
 
 void InputManager::GetMouseDelta(double& dx, double& dy) const {
-    if (m_backend) {
+    if (m_backend && m_backend->GetEventQueue()) {
+        // Drained after this frame's poll (the backend's own delta is a
+        // frame older)
+        dx = m_mouseDeltaX;
+        dy = m_mouseDeltaY;
+    } else if (m_backend) {
         m_backend->GetMouseDelta(dx, dy);
     } else {
         dx = dy = 0.0;
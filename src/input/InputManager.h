@@ -2,8 +2,9 @@
 
 #include "IInputBackend.h"
 #include "InputTypes.h"
+#include <array>
 #include <memory>
-#include <unordered_map>
+#include <span>
 #include <vector>
 #include <string>
 
@@ -54,16 +55,42 @@ public:
     // Call once per frame before checking input
     void Update();
 
+    // ========================================================================
+    // Event stream (backends with an event queue)
+    //
+    // ProcessEvents() runs right after the frame's event poll: it refreshes
+    // the action state and drains the backend queue. The queue's motion is
+    // this frame's GetMouseDelta(), and the drained events stay readable, in
+    // arrival order, until the next call.
+    // LatchMouseDelta() runs again at the last moment before rendering and
+    // returns only the motion that arrived in between, so the view can be
+    // turned with input newer than the frame's simulation.
+    // ========================================================================
+    void ProcessEvents();
+    bool LatchMouseDelta(double& dx, double& dy);   // false without an event queue
+
+    std::span<const InputEvent> GetFrameEvents() const { return m_frameEvents; }
+    double GetLastEventTime() const { return m_lastEventTime; }   // Newest drained timestamp
+
     // ========================================================================
     // Action-based input (bindable)
+    //
+    // Bindings are compiled into one entry per distinct bound key or button,
+    // carrying the mask of actions it drives. ProcessEvents() ORs the masks
+    // of the held inputs into an ActionState once per frame; the queries
+    // below are bit tests on it. An action is pressed when it went from no
+    // bound input held to any, whichever binding did it.
     // ========================================================================
     void BindAction(GameAction action, InputBinding binding);
     void UnbindAction(GameAction action);
     void ClearBindings();
 
-    bool IsActionDown(GameAction action) const;
-    bool IsActionPressed(GameAction action) const;
-    bool IsActionReleased(GameAction action) const;
+    bool IsActionDown(GameAction action) const { return m_actionState.IsDown(action); }
+    bool IsActionPressed(GameAction action) const { return m_actionState.IsPressed(action); }
+    bool IsActionReleased(GameAction action) const { return m_actionState.IsReleased(action); }
+
+    // The whole frame's action input (for per-tick storage and replication)
+    const ActionState& GetActionState() const { return m_actionState; }
 
     // ========================================================================
     // Direct input access (for when you need it)
@@ -97,16 +124,35 @@ private:
     InputManager(const InputManager&) = delete;
     InputManager& operator=(const InputManager&) = delete;
 
-    bool CheckBinding(const InputBinding& binding, bool (IInputBackend::*keyCheck)(KeyCode) const,
-                      bool (IInputBackend::*mouseCheck)(MouseButton) const) const;
+    // Rebuild m_boundInputs from m_bindings (on every binding change)
+    void CompileBindings();
+    void UpdateActionState();
 
     // Internal helpers for Update()
     void HandleMouseLocking();
     void LogWASDKeys();
 
+    // Pops the backend queue; motion is summed into dx/dy, everything else
+    // appended to m_frameEvents
+    void DrainEvents(double& dx, double& dy);
+
 private:
     std::unique_ptr<IInputBackend> m_backend;
-    std::unordered_map<GameAction, std::vector<InputBinding>> m_bindings;
+    std::array<std::vector<InputBinding>, static_cast<size_t>(GameAction::Count)> m_bindings;
+
+    // Compiled bindings: each bound key/button once, with its actions
+    struct BoundInput {
+        InputBinding::Type type;
+        uint16_t code;          // KeyCode or MouseButton
+        ActionMask actions;
+    };
+    std::vector<BoundInput> m_boundInputs;
+    ActionState m_actionState;
+
+    // Event stream state
+    std::vector<InputEvent> m_frameEvents;
+    double m_mouseDeltaX = 0.0, m_mouseDeltaY = 0.0;
+    double m_lastEventTime = 0.0;
 };
 
 } // namespace Genesis
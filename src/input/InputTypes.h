@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 
 namespace Genesis {
@@ -71,6 +72,24 @@ enum class InputState : uint8_t {
     JustReleased    // Just released this frame
 };
 
+// ============================================================================
+// Timestamped input events (backend -> InputManager)
+// ============================================================================
+enum class InputEventType : uint8_t {
+    MouseMotion,    // dx, dy: relative motion (raw when the backend has it)
+    MouseButton,    // code = MouseButton, down
+    Key,            // code = KeyCode, down
+    Scroll          // dy: wheel offset
+};
+
+struct InputEvent {
+    double timestamp = 0.0;     // Seconds on the glfwGetTime clock
+    double dx = 0.0, dy = 0.0;
+    InputEventType type = InputEventType::MouseMotion;
+    bool down = false;
+    uint16_t code = 0;
+};
+
 // ============================================================================
 // Game actions (bindable)
 // ============================================================================
@@ -109,5 +128,37 @@ enum class GameAction : uint16_t {
     None = 0xFFFF
 };
 
+// ============================================================================
+// Action state - One bit per GameAction
+//
+// A whole frame's (or tick's) action input in three words: what is held,
+// and what went down or up since the last refresh. Plain data, so it can be
+// stored per tick and sent over the network as is.
+// ============================================================================
+using ActionMask = uint32_t;
+static_assert(static_cast<size_t>(GameAction::Count) <= 32, "GameAction no longer fits an ActionMask");
+
+// No bit (0) for None or anything else out of range: shifting by it would
+// be undefined
+constexpr ActionMask ActionBit(GameAction action) {
+    uint32_t index = static_cast<uint32_t>(action);
+    return index < static_cast<uint32_t>(GameAction::Count) ? ActionMask(1) << index : 0;
+}
+
+struct ActionState {
+    ActionMask down = 0;
+    ActionMask pressed = 0;     // Down now, up at the last refresh
+    ActionMask released = 0;    // Up now, down at the last refresh
+
+    bool IsDown(GameAction action) const { return (down & ActionBit(action)) != 0; }
+    bool IsPressed(GameAction action) const { return (pressed & ActionBit(action)) != 0; }
+    bool IsReleased(GameAction action) const { return (released & ActionBit(action)) != 0; }
+
+    // Next state from the held bits
+    static ActionState FromDown(ActionMask previousDown, ActionMask down) {
+        return {down, down & ~previousDown, previousDown & ~down};
+    }
+};
+
 } // namespace Genesis
 
@@ -4,6 +4,7 @@
 #include "physics/Collider.h"
 #include "renderer/mesh/Mesh.h"
 #include "renderer/material/Material.h"
+#include "core/MemoryTracker.h"
 #include <string>
 #include <memory>
 
@@ -106,6 +107,7 @@ struct Brush {
     MaterialPtr material = nullptr;
     ColliderPtr collider = nullptr;
     Mat4 transform = Mat4(1.0f);
+    AABB worldBounds;                // GetWorldAABB() at build time
 
     // ========================================================================
     // Helpers
@@ -141,5 +143,8 @@ struct Brush {
 
 using BrushPtr = std::shared_ptr<Brush>;
 
+// Brush storage of a map or a streamed cell, charged to MemoryTag::Map
+using BrushList = TaggedVector<Brush, MemoryTag::Map>;
+
 } // namespace Genesis
 
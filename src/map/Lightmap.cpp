@@ -0,0 +1,614 @@
+#include "Lightmap.h"
+#include "Map.h"
+#include "core/Logger.h"
+#include "core/ParallelFor.h"
+#include "core/Profiler.h"
+#include "math/BVH.h"
+#include "renderer/material/Material.h"
+#include "renderer/mesh/Mesh.h"
+#include "renderer/mesh/VertexCompression.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace Genesis {
+
+// ============================================================================
+// MapLightmap
+// ============================================================================
+
+const LightmapChart* MapLightmap::FindCharts(uint32_t brushId) const {
+    auto it = m_firstChart.find(brushId);
+    return it != m_firstChart.end() ? &charts[it->second] : nullptr;
+}
+
+void MapLightmap::IndexCharts() {
+    m_firstChart.clear();
+    for (uint32_t i = 0; i + FACE_COUNT <= charts.size(); i += FACE_COUNT) {
+        m_firstChart.emplace(charts[i].brushId, i);
+    }
+}
+
+void MapLightmap::GetFaceAxes(uint32_t face, int& axis, float& sign, int& u, int& v) {
+    axis = static_cast<int>(face / 2);
+    sign = (face % 2 == 0) ? 1.0f : -1.0f;
+    u = (axis + 1) % 3;
+    v = (axis + 2) % 3;
+}
+
+bool MapLightmap::BuildVertexUVs(const LightmapChart* faces, const Mesh& mesh, std::vector<Vec3>& out) const {
+    const VertexLayout& layout = mesh.GetLayout();
+    const auto& attributes = layout.GetAttributes();
+    const MeshData& data = mesh.GetVertexData();
+    if (!faces || size == 0 || attributes.empty() || attributes[0].type != VertexAttribType::Float3 ||
+        data.size() < static_cast<size_t>(mesh.GetVertexCount()) * layout.GetStride()) {
+        return false;
+    }
+
+    const VertexAttribute* normalAttrib = nullptr;
+    for (const VertexAttribute& attrib : attributes) {
+        if (attrib.name == "normal" && (attrib.type == VertexAttribType::Float3 ||
+                                        attrib.type == VertexAttribType::Int2_10_10_10_Rev)) {
+            normalAttrib = &attrib;
+        }
+    }
+    if (!normalAttrib) return false;
+
+    const float invSize = 1.0f / static_cast<float>(size);
+    const uint32_t stride = layout.GetStride();
+    out.resize(mesh.GetVertexCount());
+
+    for (uint32_t i = 0; i < mesh.GetVertexCount(); i++) {
+        const uint8_t* vertex = data.data() + static_cast<size_t>(i) * stride;
+
+        Vec3 position;
+        std::memcpy(&position, vertex + attributes[0].offset, sizeof(Vec3));
+
+        Vec3 normal;
+        if (normalAttrib->type == VertexAttribType::Int2_10_10_10_Rev) {
+            uint32_t word;
+            std::memcpy(&word, vertex + normalAttrib->offset, sizeof(word));
+            normal = VertexCompression::UnpackNormal(word);
+        } else {
+            std::memcpy(&normal, vertex + normalAttrib->offset, sizeof(Vec3));
+        }
+
+        // The face is the dominant normal axis
+        Vec3 magnitude = glm::abs(normal);
+        int axis = magnitude.x >= magnitude.y && magnitude.x >= magnitude.z ? 0 : (magnitude.y >= magnitude.z ? 1 : 2);
+        const LightmapChart& chart = faces[axis * 2 + (normal[axis] < 0.0f ? 1 : 0)];
+
+        int faceAxis, u, v;
+        float sign;
+        GetFaceAxes(chart.face, faceAxis, sign, u, v);
+        float s = glm::clamp(position[u] + 0.5f, 0.0f, 1.0f);
+        float t = glm::clamp(position[v] + 0.5f, 0.0f, 1.0f);
+
+        out[i] = Vec3((static_cast<float>(chart.x) + s * static_cast<float>(chart.width)) * invSize,
+                      (static_cast<float>(chart.y) + t * static_cast<float>(chart.height)) * invSize,
+                      static_cast<float>(chart.layer + 1));
+    }
+    return true;
+}
+
+// ============================================================================
+// LightmapBaker
+// ============================================================================
+
+namespace {
+
+// Start of a texel's rays off its surface, and of shadow rays off hits
+constexpr float RAY_OFFSET = 0.01f;
+constexpr uint32_t CHART_BORDER = 1;
+constexpr uint32_t MIN_LAYER_SIZE = 64;
+constexpr int MAX_DENSITY_RETRIES = 8;
+
+struct BakeOccluder {
+    Mat4 inverse;           // World -> unit shape space
+    Mat3 normalToWorld;     // Transpose of the inverse's linear part
+    BrushShape shape;
+    Vec3 albedo;
+};
+
+struct RayHit {
+    float distance;
+    Vec3 normal;            // World space, outward
+    uint32_t occluder;
+};
+
+// Small, fast, deterministic per texel (PCG hash step)
+struct BakeRandom {
+    uint32_t state;
+
+    explicit BakeRandom(uint32_t seed) : state(seed * 747796405u + 2891336453u) {}
+
+    float Next() {
+        state = state * 747796405u + 2891336453u;
+        uint32_t word = ((state >> ((state >> 28u) + 4u)) ^ state) * 277803737u;
+        word = (word >> 22u) ^ word;
+        return static_cast<float>(word >> 8) * (1.0f / 16777216.0f);
+    }
+};
+
+uint32_t HashTexel(uint32_t chart, uint32_t x, uint32_t y) {
+    uint32_t h = chart * 0x9E3779B1u ^ (x * 0x85EBCA77u + 0x165667B1u) ^ (y * 0xC2B2AE3Du);
+    h ^= h >> 16;
+    h *= 0x7FEB352Du;
+    h ^= h >> 15;
+    return h;
+}
+
+AABB TransformedUnitCube(const Mat4& transform) {
+    Vec3 bmin(std::numeric_limits<float>::max());
+    Vec3 bmax(std::numeric_limits<float>::lowest());
+    for (int i = 0; i < 8; i++) {
+        Vec3 corner((i & 1) ? 0.5f : -0.5f, (i & 2) ? 0.5f : -0.5f, (i & 4) ? 0.5f : -0.5f);
+        Vec3 p = Vec3(transform * Vec4(corner, 1.0f));
+        bmin = glm::min(bmin, p);
+        bmax = glm::max(bmax, p);
+    }
+    return AABB(bmin, bmax);
+}
+
+// Orthonormal tangent frame around a unit vector
+void BuildBasis(const Vec3& n, Vec3& tangent, Vec3& bitangent) {
+    Vec3 helper = std::fabs(n.y) < 0.99f ? Vec3(0.0f, 1.0f, 0.0f) : Vec3(1.0f, 0.0f, 0.0f);
+    tangent = glm::normalize(glm::cross(helper, n));
+    bitangent = glm::cross(n, tangent);
+}
+
+// Smallest root in (tMin, tMax) of a t^2 + b t + c that passes accept(t)
+template<typename Fn>
+bool SolveQuadratic(float a, float b, float c, float tMin, float tMax, float& t, Fn&& accept) {
+    if (std::fabs(a) < 1e-12f) {
+        if (std::fabs(b) < 1e-12f) return false;
+        float root = -c / b;
+        if (root > tMin && root < tMax && accept(root)) { t = root; return true; }
+        return false;
+    }
+    float disc = b * b - 4.0f * a * c;
+    if (disc < 0.0f) return false;
+    float sq = std::sqrt(disc);
+    float r0 = (-b - sq) / (2.0f * a);
+    float r1 = (-b + sq) / (2.0f * a);
+    if (r0 > r1) std::swap(r0, r1);
+    if (r0 > tMin && r0 < tMax && accept(r0)) { t = r0; return true; }
+    if (r1 > tMin && r1 < tMax && accept(r1)) { t = r1; return true; }
+    return false;
+}
+
+// Ray o + t d against the unit shape (same t as the world ray); on a hit
+// in (tMin, tMax) returns t and the outward local normal
+bool IntersectShape(BrushShape shape, const Vec3& o, const Vec3& d, float tMin, float tMax,
+                    float& tHit, Vec3& normal) {
+    float best = tMax;
+    bool hit = false;
+    auto take = [&](float t, const Vec3& n) {
+        if (t < best) { best = t; normal = n; hit = true; }
+    };
+
+    switch (shape) {
+        case BrushShape::Sphere: {
+            float t;
+            if (SolveQuadratic(glm::dot(d, d), 2.0f * glm::dot(o, d), glm::dot(o, o) - 0.25f, tMin, best, t,
+                               [](float) { return true; })) {
+                take(t, o + d * t);
+            }
+            break;
+        }
+
+        case BrushShape::Cylinder:
+        case BrushShape::Cone: {
+            // Side: x^2 + z^2 = r(y)^2 with r = 0.5 (cylinder) or
+            // (0.5 - y) / 2 (cone, apex at +y), for |y| <= 0.5
+            bool cone = shape == BrushShape::Cone;
+            float a = d.x * d.x + d.z * d.z;
+            float b = 2.0f * (o.x * d.x + o.z * d.z);
+            float c = o.x * o.x + o.z * o.z - 0.25f;
+            if (cone) {
+                float k = 0.5f - o.y;
+                a -= 0.25f * d.y * d.y;
+                b += 0.5f * k * d.y;
+                c = o.x * o.x + o.z * o.z - 0.25f * k * k;
+            }
+            float t;
+            if (SolveQuadratic(a, b, c, tMin, best, t, [&](float root) {
+                    return std::fabs(o.y + d.y * root) <= 0.5f;
+                })) {
+                Vec3 p = o + d * t;
+                take(t, cone ? Vec3(2.0f * p.x, 0.5f * (0.5f - p.y), 2.0f * p.z) : Vec3(p.x, 0.0f, p.z));
+            }
+
+            // Caps (the cone has only the base)
+            if (std::fabs(d.y) > 1e-12f) {
+                for (float y : { -0.5f, 0.5f }) {
+                    if (cone && y > 0.0f) continue;
+                    float tc = (y - o.y) / d.y;
+                    if (tc <= tMin || tc >= best) continue;
+                    Vec3 p = o + d * tc;
+                    if (p.x * p.x + p.z * p.z <= 0.25f) take(tc, Vec3(0.0f, y, 0.0f));
+                }
+            }
+            break;
+        }
+
+        default: {
+            // Box (cubes, and wedges, which render as cubes): slab test,
+            // keeping the axis the ray enters through
+            float t0 = tMin, t1 = best;
+            int enterAxis = -1;
+            for (int axis = 0; axis < 3; axis++) {
+                if (std::fabs(d[axis]) < 1e-12f) {
+                    if (o[axis] < -0.5f || o[axis] > 0.5f) return false;
+                    continue;
+                }
+                float inv = 1.0f / d[axis];
+                float near = (-0.5f - o[axis]) * inv;
+                float far = (0.5f - o[axis]) * inv;
+                if (near > far) std::swap(near, far);
+                if (near > t0) { t0 = near; enterAxis = axis; }
+                t1 = std::min(t1, far);
+                if (t0 > t1) return false;
+            }
+            if (enterAxis < 0) return false;   // Starts inside
+            Vec3 n(0.0f);
+            n[enterAxis] = d[enterAxis] > 0.0f ? -1.0f : 1.0f;
+            take(t0, n);
+            break;
+        }
+    }
+
+    tHit = best;
+    return hit;
+}
+
+bool PointInShape(BrushShape shape, const Vec3& p) {
+    switch (shape) {
+        case BrushShape::Sphere:
+            return glm::dot(p, p) < 0.25f;
+        case BrushShape::Cylinder:
+            return std::fabs(p.y) < 0.5f && p.x * p.x + p.z * p.z < 0.25f;
+        case BrushShape::Cone: {
+            float r = (0.5f - p.y) * 0.5f;
+            return std::fabs(p.y) < 0.5f && p.x * p.x + p.z * p.z < r * r;
+        }
+        default:
+            return std::fabs(p.x) < 0.5f && std::fabs(p.y) < 0.5f && std::fabs(p.z) < 0.5f;
+    }
+}
+
+bool IsReceiverShape(BrushShape shape) {
+    return shape == BrushShape::Cube || shape == BrushShape::Wedge;
+}
+
+// Shelf packing, tallest charts first; false if they need more than maxLayers
+bool PackCharts(std::vector<LightmapChart>& charts, const std::vector<uint32_t>& order,
+                uint32_t layerSize, uint32_t maxLayers, uint32_t& layersUsed) {
+    uint32_t layer = 0, x = 0, y = 0, shelf = 0;
+    for (uint32_t index : order) {
+        LightmapChart& chart = charts[index];
+        uint32_t w = chart.width + CHART_BORDER * 2;
+        uint32_t h = chart.height + CHART_BORDER * 2;
+        if (w > layerSize || h > layerSize) return false;
+
+        if (x + w > layerSize) {
+            x = 0;
+            y += shelf;
+            shelf = 0;
+        }
+        if (y + h > layerSize) {
+            if (++layer >= maxLayers) return false;
+            x = y = shelf = 0;
+        }
+
+        chart.layer = layer;
+        chart.x = x + CHART_BORDER;
+        chart.y = y + CHART_BORDER;
+        x += w;
+        shelf = std::max(shelf, h);
+    }
+    layersUsed = layer + 1;
+    return true;
+}
+
+} // namespace
+
+MapLightmapPtr LightmapBaker::Bake(const Map& map, const LightmapBakeSettings& settings) {
+    GENESIS_PROFILE_SCOPE("LightmapBaker::Bake");
+
+    auto lightmap = std::make_shared<MapLightmap>();
+    const auto& brushes = map.GetBrushes();
+    const MapMetadata& meta = map.GetMetadata();
+
+    // Occluders and receivers, with transforms rebuilt so unbuilt maps work too
+    std::vector<BakeOccluder> occluders;
+    std::vector<AABB> occluderBounds;
+    std::vector<Brush> receivers;
+    for (const Brush& brush : brushes) {
+        if (!brush.IsVisible() || brush.IsTrigger()) continue;
+
+        Brush built = brush;
+        built.BuildTransform();
+
+        if (HasFlag(built.flags, BrushFlags::CastShadow) && built.shape != BrushShape::Custom) {
+            BakeOccluder occluder;
+            occluder.inverse = glm::inverse(built.transform);
+            occluder.normalToWorld = glm::transpose(Mat3(occluder.inverse));
+            occluder.shape = built.shape;
+            occluder.albedo = built.material ? built.material->GetVec3("u_Color", Vec3(0.5f)) : Vec3(0.5f);
+            occluders.push_back(occluder);
+            occluderBounds.push_back(TransformedUnitCube(built.transform));
+        }
+
+        if (IsReceiverShape(built.shape) && HasFlag(built.flags, BrushFlags::ReceiveShadow)) {
+            receivers.push_back(std::move(built));
+        }
+    }
+    if (receivers.empty()) return lightmap;
+
+    // Charts, shrinking the density until they pack
+    const uint32_t atlasSize = std::max(settings.atlasSize, MIN_LAYER_SIZE);
+    const uint32_t maxChart = std::clamp(settings.maxChartSize, 1u, atlasSize - CHART_BORDER * 2);
+    auto& charts = lightmap->charts;
+    charts.resize(receivers.size() * MapLightmap::FACE_COUNT);
+
+    std::vector<uint32_t> order(charts.size());
+    float density = std::max(settings.texelsPerUnit, 1e-3f);
+    bool packed = false;
+    for (int attempt = 0; attempt < MAX_DENSITY_RETRIES && !packed; attempt++) {
+        if (attempt > 0) density *= 0.7f;
+
+        for (size_t r = 0; r < receivers.size(); r++) {
+            Vec3 size = glm::abs(receivers[r].size);
+            for (uint32_t face = 0; face < MapLightmap::FACE_COUNT; face++) {
+                int axis, u, v;
+                float sign;
+                MapLightmap::GetFaceAxes(face, axis, sign, u, v);
+
+                LightmapChart& chart = charts[r * MapLightmap::FACE_COUNT + face];
+                chart.brushId = receivers[r].id;
+                chart.face = face;
+                chart.width = std::clamp(static_cast<uint32_t>(std::ceil(size[u] * density)), 1u, maxChart);
+                chart.height = std::clamp(static_cast<uint32_t>(std::ceil(size[v] * density)), 1u, maxChart);
+            }
+        }
+
+        for (uint32_t i = 0; i < order.size(); i++) order[i] = i;
+        std::sort(order.begin(), order.end(), [&charts](uint32_t a, uint32_t b) {
+            if (charts[a].height != charts[b].height) return charts[a].height > charts[b].height;
+            return a < b;
+        });
+
+        // Smallest single layer first, then layers of the full size
+        for (uint32_t size = MIN_LAYER_SIZE; size <= atlasSize && !packed; size *= 2) {
+            uint32_t layers = 0;
+            if (PackCharts(charts, order, size, 1, layers)) {
+                lightmap->size = size;
+                lightmap->layerCount = layers;
+                packed = true;
+            }
+        }
+        uint32_t layers = 0;
+        if (!packed && PackCharts(charts, order, atlasSize, std::max(settings.maxLayers, 1u), layers)) {
+            lightmap->size = atlasSize;
+            lightmap->layerCount = layers;
+            packed = true;
+        }
+    }
+    if (!packed) {
+        LOG_WARNING("LightmapBaker", "Charts of '" + map.GetName() + "' don't fit the atlas, not baking");
+        charts.clear();
+        return lightmap;
+    }
+
+    BVH bvh;
+    bvh.Build(occluderBounds);
+
+    const Vec3 sunDir = Math::SafeNormalize(meta.sunDirection);
+    const Vec3 sunRadiance = meta.sunColor * meta.sunIntensity;
+    const Vec3 sky = meta.ambientColor;
+    const float maxDistance = std::max(settings.maxDistance, RAY_OFFSET * 2.0f);
+    const uint32_t sunSamples = std::max(settings.sunSamples, 1u);
+    const uint32_t rayCount = settings.raysPerTexel;
+    const float cosSunAngle = std::cos(glm::radians(std::clamp(settings.sunAngle, 0.0f, 45.0f)));
+
+    auto closestHit = [&](const Vec3& origin, const Vec3& dir, RayHit& hit) {
+        hit.distance = maxDistance;
+        bool found = false;
+        bvh.Raycast(origin, dir, maxDistance, [&](uint32_t index, float& maxDist) {
+            const BakeOccluder& occluder = occluders[index];
+            Vec3 o = Vec3(occluder.inverse * Vec4(origin, 1.0f));
+            Vec3 d = Vec3(occluder.inverse * Vec4(dir, 0.0f));
+            float t;
+            Vec3 localNormal;
+            if (IntersectShape(occluder.shape, o, d, 0.0f, maxDist, t, localNormal)) {
+                hit.distance = t;
+                hit.normal = Math::SafeNormalize(occluder.normalToWorld * localNormal);
+                hit.occluder = index;
+                maxDist = t;
+                found = true;
+            }
+        });
+        return found;
+    };
+
+    auto occluded = [&](const Vec3& origin, const Vec3& dir) {
+        bool blocked = false;
+        bvh.Raycast(origin, dir, maxDistance, [&](uint32_t index, float& maxDist) {
+            if (blocked) return;
+            const BakeOccluder& occluder = occluders[index];
+            Vec3 o = Vec3(occluder.inverse * Vec4(origin, 1.0f));
+            Vec3 d = Vec3(occluder.inverse * Vec4(dir, 0.0f));
+            float t;
+            Vec3 localNormal;
+            if (IntersectShape(occluder.shape, o, d, 0.0f, maxDist, t, localNormal)) {
+                blocked = true;
+                maxDist = 0.0f;   // Prune the rest of the traversal
+            }
+        });
+        return blocked;
+    };
+
+    auto insideOccluder = [&](const Vec3& point) {
+        bool inside = false;
+        bvh.QueryAABB(AABB(point, point), [&](uint32_t index) {
+            const BakeOccluder& occluder = occluders[index];
+            inside = inside || PointInShape(occluder.shape, Vec3(occluder.inverse * Vec4(point, 1.0f)));
+        });
+        return inside;
+    };
+
+    lightmap->texels.assign(lightmap->GetTexelCount() * MapLightmap::CHANNELS, 0);
+    const uint32_t atlas = lightmap->size;
+    std::atomic<uint64_t> buriedTexels{0};
+
+    // Every chart writes only its own rectangle (border included)
+    ParallelFor(charts.size(), 4, [&](size_t begin, size_t end) {
+        std::vector<Vec4> values;
+        std::vector<uint8_t> valid;
+
+        for (size_t c = begin; c < end; c++) {
+            const LightmapChart& chart = charts[c];
+            const Brush& brush = receivers[c / MapLightmap::FACE_COUNT];
+            const Mat3 normalMatrix = glm::transpose(glm::inverse(Mat3(brush.transform)));
+
+            int axis, u, v;
+            float sign;
+            MapLightmap::GetFaceAxes(chart.face, axis, sign, u, v);
+            Vec3 localNormal(0.0f);
+            localNormal[axis] = sign;
+            const Vec3 normal = Math::SafeNormalize(normalMatrix * localNormal);
+            Vec3 tangent, bitangent;
+            BuildBasis(normal, tangent, bitangent);
+
+            const float NdotL = glm::dot(normal, sunDir);
+            Vec3 sunTangent, sunBitangent;
+            BuildBasis(sunDir, sunTangent, sunBitangent);
+
+            const uint32_t w = chart.width, h = chart.height;
+            values.assign(static_cast<size_t>(w) * h, Vec4(0.0f));
+            valid.assign(static_cast<size_t>(w) * h, 0);
+            uint32_t validCount = 0;
+
+            for (uint32_t j = 0; j < h; j++) {
+                for (uint32_t i = 0; i < w; i++) {
+                    Vec3 local(0.0f);
+                    local[axis] = sign * 0.5f;
+                    local[u] = (static_cast<float>(i) + 0.5f) / static_cast<float>(w) - 0.5f;
+                    local[v] = (static_cast<float>(j) + 0.5f) / static_cast<float>(h) - 0.5f;
+                    Vec3 origin = Vec3(brush.transform * Vec4(local, 1.0f)) + normal * RAY_OFFSET;
+
+                    // Faces pressed against another brush are never seen
+                    if (insideOccluder(origin)) continue;
+
+                    BakeRandom random(HashTexel(static_cast<uint32_t>(c), i, j));
+
+                    // Sun visibility over the sun's disk
+                    float visibility = 0.0f;
+                    if (NdotL > 0.0f) {
+                        uint32_t lit = 0;
+                        for (uint32_t s = 0; s < sunSamples; s++) {
+                            Vec3 dir = sunDir;
+                            if (sunSamples > 1) {
+                                float z = 1.0f - random.Next() * (1.0f - cosSunAngle);
+                                float r = std::sqrt(std::max(0.0f, 1.0f - z * z));
+                                float phi = Math::TWO_PI * random.Next();
+                                dir = sunTangent * (r * std::cos(phi)) + sunBitangent * (r * std::sin(phi)) + sunDir * z;
+                            }
+                            if (!occluded(origin, dir)) lit++;
+                        }
+                        visibility = static_cast<float>(lit) / static_cast<float>(sunSamples);
+                    }
+
+                    // Sky and one bounce, cosine weighted
+                    Vec3 indirect = sky;
+                    if (rayCount > 0) {
+                        indirect = Vec3(0.0f);
+                        for (uint32_t r = 0; r < rayCount; r++) {
+                            float r1 = random.Next(), r2 = random.Next();
+                            float radius = std::sqrt(r2);
+                            float phi = Math::TWO_PI * r1;
+                            Vec3 dir = tangent * (radius * std::cos(phi)) + bitangent * (radius * std::sin(phi)) +
+                                       normal * std::sqrt(std::max(0.0f, 1.0f - r2));
+
+                            RayHit hit;
+                            if (!closestHit(origin, dir, hit)) {
+                                indirect += sky;
+                                continue;
+                            }
+
+                            Vec3 point = origin + dir * hit.distance + hit.normal * RAY_OFFSET;
+                            float hitNdotL = glm::dot(hit.normal, sunDir);
+                            Vec3 incoming = sky;
+                            if (hitNdotL > 0.0f && !occluded(point, sunDir)) {
+                                incoming += sunRadiance * hitNdotL;
+                            }
+                            indirect += occluders[hit.occluder].albedo * incoming;
+                        }
+                        indirect /= static_cast<float>(rayCount);
+                    }
+
+                    values[j * w + i] = Vec4(indirect, visibility);
+                    valid[j * w + i] = 1;
+                    validCount++;
+                }
+            }
+
+            // Fill buried texels from their neighbours, ring by ring
+            buriedTexels += static_cast<uint64_t>(w) * h - validCount;
+            while (validCount > 0 && validCount < w * h) {
+                std::vector<uint8_t> next = valid;
+                for (uint32_t j = 0; j < h; j++) {
+                    for (uint32_t i = 0; i < w; i++) {
+                        if (valid[j * w + i]) continue;
+                        Vec4 sum(0.0f);
+                        int count = 0;
+                        for (int dy = -1; dy <= 1; dy++) {
+                            for (int dx = -1; dx <= 1; dx++) {
+                                int nx = static_cast<int>(i) + dx, ny = static_cast<int>(j) + dy;
+                                if (nx < 0 || ny < 0 || nx >= static_cast<int>(w) || ny >= static_cast<int>(h)) continue;
+                                if (!valid[ny * w + nx]) continue;
+                                sum += values[ny * w + nx];
+                                count++;
+                            }
+                        }
+                        if (count > 0) {
+                            values[j * w + i] = sum / static_cast<float>(count);
+                            next[j * w + i] = 1;
+                            validCount++;
+                        }
+                    }
+                }
+                valid.swap(next);
+            }
+
+            // Write the face texels and the border (clamped copies)
+            uint16_t* layer = lightmap->texels.data() +
+                static_cast<size_t>(chart.layer) * atlas * atlas * MapLightmap::CHANNELS;
+            for (int j = -static_cast<int>(CHART_BORDER); j < static_cast<int>(h + CHART_BORDER); j++) {
+                for (int i = -static_cast<int>(CHART_BORDER); i < static_cast<int>(w + CHART_BORDER); i++) {
+                    int si = std::clamp(i, 0, static_cast<int>(w) - 1);
+                    int sj = std::clamp(j, 0, static_cast<int>(h) - 1);
+                    const Vec4& value = values[sj * w + si];
+                    size_t texel = (static_cast<size_t>(chart.y + j) * atlas + (chart.x + i)) * MapLightmap::CHANNELS;
+                    for (uint32_t k = 0; k < MapLightmap::CHANNELS; k++) {
+                        layer[texel + k] = VertexCompression::FloatToHalf(value[k]);
+                    }
+                }
+            }
+        }
+    });
+
+    lightmap->IndexCharts();
+
+    LOG_INFO("LightmapBaker", "Baked lightmap of '" + map.GetName() + "': " + std::to_string(charts.size()) +
+             " charts in " + std::to_string(lightmap->layerCount) + " layer(s) of " + std::to_string(atlas) +
+             "^2 at " + std::to_string(density).substr(0, 4) + " texels/unit, " +
+             std::to_string(occluders.size()) + " occluders, " + std::to_string(buriedTexels.load()) +
+             " buried texels filled");
+    return lightmap;
+}
+
+} // namespace Genesis
@@ -0,0 +1,120 @@
+#pragma once
+
+#include "math/Math.h"
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace Genesis {
+
+class Map;
+class Mesh;
+
+// One face of a brush in the lightmap atlas. Texel (i, j) of the chart is
+// at (x + i, y + j) of its layer and samples the face point at
+// ((i + 0.5) / width, (j + 0.5) / height), with a one texel border on
+// every side copied from the nearest face texel so bilinear filtering
+// never reaches a neighbour.
+struct LightmapChart {
+    uint32_t brushId = 0;
+    uint32_t face = 0;      // MapLightmap::FACE_COUNT per brush, see GetFaceAxes
+    uint32_t layer = 0;
+    uint32_t x = 0;         // First face texel (inside the border)
+    uint32_t y = 0;
+    uint32_t width = 0;
+    uint32_t height = 0;
+};
+
+// ============================================================================
+// MapLightmap - Baked static lighting of a map's box brushes
+//
+// An RGBA16F texture array (size x size x layerCount texels):
+//   rgb = indirect light reaching the texel: sky (ambientColor) that isn't
+//         occluded, so ambient occlusion is built in, plus one bounce of
+//         sun and sky off the surfaces around it
+//   a   = sun visibility, 0 (shadowed) to 1 (lit), softened by sunAngle
+// The shader multiplies rgb by the albedo for the ambient term and a by
+// the sun's N.L, in place of the shadow maps.
+//
+// Charts cover the six faces of every cube (and wedge, which still renders
+// as a cube) brush that was visible when the map was baked. Face f lies on
+// axis f / 2 at +0.5 (even f) or -0.5 (odd f) of the brush's unit cube,
+// and spans the two other axes (see GetFaceAxes).
+//
+// Built by LightmapBaker when a map is compiled and stored in the .gmap;
+// editing brushes afterwards does not update it.
+// ============================================================================
+struct MapLightmap {
+    static constexpr uint32_t FACE_COUNT = 6;
+    static constexpr uint32_t CHANNELS = 4;     // Half floats per texel
+
+    // Loader limits for file values, at what drivers report at most for
+    // GL_MAX_TEXTURE_SIZE / GL_MAX_ARRAY_TEXTURE_LAYERS (the upload checks
+    // the actual ones); they also keep the texel count from overflowing
+    static constexpr uint32_t MAX_SIZE = 16384;
+    static constexpr uint32_t MAX_LAYERS = 2048;
+
+    uint32_t size = 0;                  // Layer width and height
+    uint32_t layerCount = 0;
+    std::vector<uint16_t> texels;       // Half floats, layer by layer, rows from y = 0
+    std::vector<LightmapChart> charts;  // FACE_COUNT consecutive charts per brush
+
+    bool IsEmpty() const { return charts.empty() || texels.empty(); }
+
+    // First of the brush's FACE_COUNT charts, or nullptr (IndexCharts first)
+    const LightmapChart* FindCharts(uint32_t brushId) const;
+    void IndexCharts();
+
+    // Normal axis, sign and the (u, v) axes a face spans
+    static void GetFaceAxes(uint32_t face, int& axis, float& sign, int& u, int& v);
+
+    // Lightmap coordinates (u, v, layer + 1) for every vertex of a unit
+    // cube mesh (positions Float3 at attribute 0, normals Float3 or packed
+    // at "normal"); faces come from the dominant normal axis
+    bool BuildVertexUVs(const LightmapChart* faces, const Mesh& mesh, std::vector<Vec3>& out) const;
+
+    size_t GetTexelCount() const { return static_cast<size_t>(size) * size * layerCount; }
+
+private:
+    std::unordered_map<uint32_t, uint32_t> m_firstChart;   // brushId -> chart index
+};
+
+using MapLightmapPtr = std::shared_ptr<const MapLightmap>;
+
+// ============================================================================
+// LightmapBaker - Computes MapLightmap from a map's brushes
+//
+// Charts are sized at texelsPerUnit (clamped to maxChartSize), then shelf
+// packed into the smallest power-of-two layer that holds them, with more
+// layers of atlasSize when one isn't enough; a map that needs more than
+// maxLayers is rebaked at a lower density.
+//
+// Every texel is ray traced on the worker threads against the brushes
+// that cast shadows (boxes, spheres, cylinders and cones in their local
+// space, found through a BVH over their bounds):
+//   - sunSamples rays towards the sun, jittered over a cone of sunAngle,
+//     give the visibility in a
+//   - raysPerTexel cosine-weighted rays over the hemisphere give rgb: a
+//     miss sees the sky, a hit sees the albedo (the material's u_Color)
+//     lit by the sun (itself shadow tested) and the sky
+// Texels inside another brush (faces against a wall) are filled from
+// their lit neighbours, as are the chart borders.
+// ============================================================================
+struct LightmapBakeSettings {
+    float texelsPerUnit = 2.0f;
+    uint32_t atlasSize = 1024;         // Largest layer
+    uint32_t maxLayers = 16;
+    uint32_t maxChartSize = 256;       // Texels per chart edge
+    uint32_t raysPerTexel = 64;
+    uint32_t sunSamples = 8;
+    float sunAngle = 1.0f;             // Cone half angle (degrees) of the soft shadow
+    float maxDistance = 512.0f;        // Rays longer than this escape to the sky
+};
+
+class LightmapBaker {
+public:
+    static MapLightmapPtr Bake(const Map& map, const LightmapBakeSettings& settings = LightmapBakeSettings());
+};
+
+} // namespace Genesis
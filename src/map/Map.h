@@ -1,11 +1,19 @@
 #pragma once
 
 #include "Brush.h"
+#include "MapVis.h"
+#include "Lightmap.h"
+#include "MapPartition.h"
+#include "math/BVH.h"
+#include "core/FrameArena.h"
+#include <algorithm>
 #include <vector>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <memory>
 #include <functional>
+#include <span>
 
 namespace Genesis {
 
@@ -62,6 +70,8 @@ struct MapEntity {
     }
 };
 
+using EntityList = TaggedVector<MapEntity, MemoryTag::Map>;
+
 // ============================================================================
 // Map - A complete game level
 //
@@ -76,11 +86,12 @@ struct MapEntity {
 //  ├── Entities[] (spawn points, triggers, lights)
 //  └── Layers[] (organizational groups)
 //
+// Vis data (areas + PVS), the lightmap and the cell partition come from
+// compiling the map, see MapVis.h, Lightmap.h and MapPartition.h. A map
+// streamed by cell only holds the brushes of its resident cells.
+//
 // Future extensions:
 // - BSP tree for visibility/collision
-// - Lightmaps
-// - Vis data
-// - Area portals
 // ============================================================================
 class Map {
 public:
@@ -106,15 +117,25 @@ public:
     size_t AddBrush(const Brush& brush) {
         m_brushes.push_back(brush);
         m_brushes.back().id = m_nextBrushId++;
-        return m_brushes.size() - 1;
+        return OnBrushAdded();
     }
 
     size_t AddBrush(Brush&& brush) {
         brush.id = m_nextBrushId++;
         m_brushes.push_back(std::move(brush));
-        return m_brushes.size() - 1;
+        return OnBrushAdded();
+    }
+
+    // Add a brush keeping its existing id (compiled maps)
+    size_t AddBrushWithId(Brush&& brush) {
+        m_nextBrushId = std::max(m_nextBrushId, brush.id + 1);
+        m_brushes.push_back(std::move(brush));
+        return OnBrushAdded();
     }
 
+    // Ids below nextId are taken, even by brushes not loaded (streamed cells)
+    void ReserveBrushIds(uint32_t nextId) { m_nextBrushId = std::max(m_nextBrushId, nextId); }
+
     // Get brush by index
     Brush* GetBrush(size_t index) {
         return (index < m_brushes.size()) ? &m_brushes[index] : nullptr;
@@ -124,29 +145,104 @@ public:
         return (index < m_brushes.size()) ? &m_brushes[index] : nullptr;
     }
 
-    // Get brush by ID
+    // Get brush by ID (hash lookup)
     Brush* GetBrushById(uint32_t id) {
-        for (auto& brush : m_brushes) {
-            if (brush.id == id) return &brush;
+        size_t index = FindBrushIndex(id);
+        return index != INVALID_BRUSH ? &m_brushes[index] : nullptr;
+    }
+
+    const Brush* GetBrushById(uint32_t id) const {
+        size_t index = FindBrushIndex(id);
+        return index != INVALID_BRUSH ? &m_brushes[index] : nullptr;
+    }
+
+    // Index of a brush in GetBrushes(), or INVALID_BRUSH
+    static constexpr size_t INVALID_BRUSH = static_cast<size_t>(-1);
+    size_t FindBrushIndex(uint32_t id) const {
+        // Brushes appended straight into GetBrushes() are picked up here
+        if (m_brushIndex.size() != m_brushes.size()) {
+            RebuildBrushIndex();
         }
-        return nullptr;
+        auto it = m_brushIndex.find(id);
+        return it != m_brushIndex.end() ? it->second : INVALID_BRUSH;
     }
 
     // Get all brushes
-    std::vector<Brush>& GetBrushes() { return m_brushes; }
-    const std::vector<Brush>& GetBrushes() const { return m_brushes; }
+    BrushList& GetBrushes() { return m_brushes; }
+    const BrushList& GetBrushes() const { return m_brushes; }
 
     size_t GetBrushCount() const { return m_brushes.size(); }
 
     // Remove brush
     void RemoveBrush(size_t index) {
         if (index < m_brushes.size()) {
+            uint32_t id = m_brushes[index].id;
+            m_dirtyBrushes.erase(id);
+            m_removedBrushes.push_back(id);
             m_brushes.erase(m_brushes.begin() + index);
+            m_brushIndex.clear();  // Later indices shifted
+        }
+    }
+
+    void RemoveBrushById(uint32_t id) {
+        size_t index = FindBrushIndex(id);
+        if (index != INVALID_BRUSH) {
+            RemoveBrush(index);
+        }
+    }
+
+    // Remove several brushes in one pass (e.g. a cell being unloaded)
+    void RemoveBrushesById(const std::unordered_set<uint32_t>& ids) {
+        if (ids.empty()) return;
+        auto removed = std::remove_if(m_brushes.begin(), m_brushes.end(), [&](const Brush& brush) {
+            if (ids.count(brush.id) == 0) return false;
+            m_dirtyBrushes.erase(brush.id);
+            m_removedBrushes.push_back(brush.id);
+            return true;
+        });
+        if (removed != m_brushes.end()) {
+            m_brushes.erase(removed, m_brushes.end());
+            m_brushIndex.clear();
         }
     }
 
     // Clear all brushes
-    void ClearBrushes() { m_brushes.clear(); }
+    void ClearBrushes() {
+        for (const auto& brush : m_brushes) {
+            m_removedBrushes.push_back(brush.id);
+        }
+        m_dirtyBrushes.clear();
+        m_brushIndex.clear();
+        m_brushes.clear();
+    }
+
+    // ========================================================================
+    // Change Tracking - What MapRenderer::SyncChanges() has to push
+    //
+    // Adds and removals are recorded automatically; call MarkBrushDirty()
+    // after editing a brush in place (and rebuilding it with MapLoader).
+    // ========================================================================
+
+    void MarkBrushDirty(uint32_t id) { m_dirtyBrushes.insert(id); }
+
+    void MarkLayerDirty(const std::string& layer) {
+        for (const auto& brush : m_brushes) {
+            if (brush.layer == layer) {
+                m_dirtyBrushes.insert(brush.id);
+            }
+        }
+    }
+
+    bool HasChanges() const { return !m_dirtyBrushes.empty() || !m_removedBrushes.empty(); }
+
+    // Ids added or edited (may include ids removed since; check GetBrushById)
+    const std::unordered_set<uint32_t>& GetDirtyBrushes() const { return m_dirtyBrushes; }
+    const std::vector<uint32_t>& GetRemovedBrushes() const { return m_removedBrushes; }
+
+    void ClearChanges() {
+        m_dirtyBrushes.clear();
+        m_removedBrushes.clear();
+    }
 
     // ========================================================================
     // Entity Management
@@ -161,8 +257,8 @@ public:
         return (index < m_entities.size()) ? &m_entities[index] : nullptr;
     }
 
-    std::vector<MapEntity>& GetEntities() { return m_entities; }
-    const std::vector<MapEntity>& GetEntities() const { return m_entities; }
+    EntityList& GetEntities() { return m_entities; }
+    const EntityList& GetEntities() const { return m_entities; }
 
     size_t GetEntityCount() const { return m_entities.size(); }
 
@@ -247,6 +343,95 @@ public:
         return result;
     }
 
+    // Per-frame variants: results live in the arena (valid until its Reset)
+    std::span<const Brush* const> GetBrushesInLayer(const std::string& layer, FrameArena& arena) const {
+        return CollectBrushes(arena, [&](const Brush& brush) { return brush.layer == layer; });
+    }
+
+    std::span<const Brush* const> GetCollisionBrushes(FrameArena& arena) const {
+        return CollectBrushes(arena, [](const Brush& brush) { return brush.HasCollision(); });
+    }
+
+    std::span<const Brush* const> GetVisibleBrushes(FrameArena& arena) const {
+        return CollectBrushes(arena, [this](const Brush& brush) {
+            return brush.IsVisible() && IsLayerVisible(brush.layer);
+        });
+    }
+
+    // Brushes whose world bounds overlap the box (uses the brush BVH)
+    template<typename Fn>
+    void QueryBrushes(const AABB& box, Fn&& fn) const {
+        m_brushBVH.QueryAABB(box, [&](uint32_t index) {
+            const Brush& brush = m_brushes[index];
+            if (brush.worldBounds.Intersects(box)) fn(brush);
+        });
+    }
+
+    // ========================================================================
+    // Brush BVH - Over Brush::worldBounds, item = brush index
+    //
+    // Built by MapLoader after the brushes are built, or restored from a
+    // compiled .gmap. Must be rebuilt after adding/removing brushes.
+    // ========================================================================
+
+    void BuildBrushBVH() {
+        std::vector<AABB> bounds;
+        bounds.reserve(m_brushes.size());
+        for (const auto& brush : m_brushes) {
+            bounds.push_back(brush.worldBounds);
+        }
+        m_brushBVH.Build(bounds);
+    }
+
+    // Cheaper than a rebuild when brushes only moved (same brush set)
+    void RefitBrushBVH() {
+        std::vector<AABB> bounds;
+        bounds.reserve(m_brushes.size());
+        for (const auto& brush : m_brushes) {
+            bounds.push_back(brush.worldBounds);
+        }
+        m_brushBVH.Refit(bounds);
+    }
+
+    void SetBrushBVH(BVH&& bvh) { m_brushBVH = std::move(bvh); }
+    const BVH& GetBrushBVH() const { return m_brushBVH; }
+
+    // ========================================================================
+    // Vis Data - Areas and PVS (VisCompiler, stored in compiled .gmap)
+    //
+    // Computed from the brushes at compile time; editing brushes afterwards
+    // does not update it. nullptr when the map has none.
+    // ========================================================================
+
+    void SetVis(MapVisPtr vis) { m_vis = std::move(vis); }
+    const MapVisPtr& GetVis() const { return m_vis; }
+
+    // ========================================================================
+    // Lightmap - Baked sun, bounce light and AO (LightmapBaker, stored in
+    // compiled .gmap)
+    //
+    // Like vis data, a snapshot of the brushes at bake time. Brush meshes
+    // only carry its coordinates once MapLoader attaches them. nullptr when
+    // the map has none.
+    // ========================================================================
+
+    void SetLightmap(MapLightmapPtr lightmap) { m_lightmap = std::move(lightmap); }
+    const MapLightmapPtr& GetLightmap() const { return m_lightmap; }
+
+    // ========================================================================
+    // Partition - Grid cells of brushes/entities (WorldPartitioner, stored in
+    // compiled .gmap)
+    //
+    // With a cell source set the map is streamed: GetBrushes() are only the
+    // resident cells' brushes (plus any added since), and saving it would
+    // lose the rest. nullptr when the map has none.
+    // ========================================================================
+
+    void SetPartition(MapPartitionPtr partition) { m_partition = std::move(partition); }
+    const MapPartitionPtr& GetPartition() const { return m_partition; }
+
+    bool IsStreamed() const { return m_partition && m_partition->IsStreamed(); }
+
     // Iterate over all brushes
     void ForEachBrush(const std::function<void(Brush&)>& callback) {
         for (auto& brush : m_brushes) {
@@ -266,9 +451,18 @@ public:
 
     // Clear entire map
     void Clear() {
+        for (const auto& brush : m_brushes) {
+            m_removedBrushes.push_back(brush.id);
+        }
+        m_dirtyBrushes.clear();
+        m_brushIndex.clear();
         m_brushes.clear();
         m_entities.clear();
         m_layers.clear();
+        m_brushBVH.Clear();
+        m_vis.reset();
+        m_lightmap.reset();
+        m_partition.reset();
         m_metadata = MapMetadata();
         m_nextBrushId = 1;
     }
@@ -296,11 +490,51 @@ public:
     }
 
 private:
+    template<typename Pred>
+    std::span<const Brush* const> CollectBrushes(FrameArena& arena, Pred&& pred) const {
+        // Worst case is every brush; the unused tail goes back to the arena
+        const Brush** out = arena.AllocateArray<const Brush*>(m_brushes.size());
+        size_t count = 0;
+        for (const auto& brush : m_brushes) {
+            if (pred(brush)) {
+                out[count++] = &brush;
+            }
+        }
+        return arena.Shrink(out, count);
+    }
+
+    size_t OnBrushAdded() {
+        size_t index = m_brushes.size() - 1;
+        uint32_t id = m_brushes[index].id;
+        if (m_brushIndex.size() == index) {
+            m_brushIndex[id] = index;
+        }
+        m_dirtyBrushes.insert(id);
+        return index;
+    }
+
+    void RebuildBrushIndex() const {
+        m_brushIndex.clear();
+        m_brushIndex.reserve(m_brushes.size());
+        for (size_t i = 0; i < m_brushes.size(); i++) {
+            m_brushIndex[m_brushes[i].id] = i;
+        }
+    }
+
     MapMetadata m_metadata;
-    std::vector<Brush> m_brushes;
-    std::vector<MapEntity> m_entities;
+    BrushList m_brushes;
+    EntityList m_entities;
     std::unordered_map<std::string, bool> m_layers;
+    BVH m_brushBVH;
+    MapVisPtr m_vis;
+    MapLightmapPtr m_lightmap;
+    MapPartitionPtr m_partition;
     uint32_t m_nextBrushId = 1;
+
+    // Change tracking (by Brush::id)
+    std::unordered_set<uint32_t> m_dirtyBrushes;
+    std::vector<uint32_t> m_removedBrushes;
+    mutable std::unordered_map<uint32_t, size_t> m_brushIndex;  // id -> index
 };
 
 using MapPtr = std::shared_ptr<Map>;
@@ -0,0 +1,176 @@
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+
+namespace Genesis {
+
+// ============================================================================
+// Genesis Binary Map (.gmap) - On-disk layout
+//
+// A compiled map is a header followed by fixed-size record arrays. Records
+// are read with a memcpy each, so loading is a walk over mapped memory with
+// no text parsing:
+//
+//   GMapHeader
+//   GMapMetadata
+//   GMapBrush[brushCount]       transform and world AABB precomputed
+//   GMapEntity[entityCount]     (both grouped by cell when partitioned)
+//   GMapProperty[propertyCount] entity key/values
+//   GMapBVHNode[bvhNodeCount]   optional prebuilt brush BVH
+//   uint32_t[bvhItemCount]      BVH leaf items (brush indices)
+//   GMapArea[areaCount]         optional vis areas (see MapVis.h)
+//   uint32_t[pvsWordCount]      PVS bit rows, ceil(areaCount / 32) words each
+//   GMapLightmapChart[lightmapChartCount]  optional lightmap (see Lightmap.h)
+//   uint16_t[lightmapSize^2 * lightmapLayers * 4]  RGBA16F lightmap texels
+//   GMapCell[cellCount]         optional partition (see MapPartition.h)
+//   char[stringTableSize]       deduplicated names, NUL-terminated
+//
+// Section offsets are from the start of the file and 8-byte aligned.
+// All values are little-endian.
+// ============================================================================
+
+namespace GMap {
+    constexpr char MAGIC[4] = { 'G', 'M', 'A', 'P' };
+    constexpr uint32_t VERSION = 4;
+
+    constexpr uint32_t FLAG_HAS_BVH = 1 << 0;
+    constexpr uint32_t FLAG_HAS_VIS = 1 << 1;
+    constexpr uint32_t FLAG_HAS_LIGHTMAP = 1 << 2;
+    constexpr uint32_t FLAG_HAS_CELLS = 1 << 3;
+}
+
+// Reference into the string table
+struct GMapString {
+    uint32_t offset = 0;
+    uint32_t length = 0;
+};
+
+struct GMapHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t flags;
+    uint32_t brushCount;
+    uint32_t entityCount;
+    uint32_t propertyCount;
+    uint32_t bvhNodeCount;
+    uint32_t bvhItemCount;
+    uint32_t stringTableSize;
+    uint32_t areaCount;
+    uint32_t pvsWordCount;
+    uint32_t lightmapChartCount;
+    uint32_t lightmapSize;
+    uint32_t lightmapLayers;
+    uint32_t cellCount;
+    float cellSize;
+
+    uint64_t metadataOffset;
+    uint64_t brushOffset;
+    uint64_t entityOffset;
+    uint64_t propertyOffset;
+    uint64_t bvhNodeOffset;
+    uint64_t bvhItemOffset;
+    uint64_t areaOffset;
+    uint64_t pvsOffset;
+    uint64_t lightmapChartOffset;
+    uint64_t lightmapTexelOffset;
+    uint64_t cellOffset;
+    uint64_t stringOffset;
+};
+
+struct GMapMetadata {
+    GMapString name;
+    GMapString author;
+    GMapString version;
+    GMapString description;
+    GMapString skybox;
+
+    float spawnPosition[3];
+    float spawnRotation[3];
+    float ambientColor[3];
+    float sunDirection[3];
+    float sunColor[3];
+    float sunIntensity;
+    float fogColor[3];
+    float fogStart;
+    float fogEnd;
+};
+
+struct GMapBrush {
+    GMapString name;
+    GMapString material;
+    GMapString layer;
+
+    uint32_t id;
+    uint32_t shape;       // BrushShape
+    uint32_t flags;       // BrushFlags
+    uint32_t visGroup;
+
+    float position[3];
+    float size[3];
+    float rotation[3];
+
+    float transform[16];  // Column-major, as BuildTransform() produces
+    float boundsMin[3];   // World-space AABB
+    float boundsMax[3];
+};
+
+struct GMapEntity {
+    GMapString classname;
+    GMapString targetname;
+    float position[3];
+    float rotation[3];
+    uint32_t firstProperty;
+    uint32_t propertyCount;
+};
+
+struct GMapProperty {
+    GMapString key;
+    GMapString value;
+};
+
+// Mirrors BVHNode
+struct GMapBVHNode {
+    float boundsMin[3];
+    float boundsMax[3];
+    uint32_t first;
+    uint32_t count;
+};
+
+// Mirrors MapVis::areas
+struct GMapArea {
+    float boundsMin[3];
+    float boundsMax[3];
+};
+
+// Mirrors LightmapChart
+struct GMapLightmapChart {
+    uint32_t brushId;
+    uint32_t face;
+    uint32_t layer;
+    uint32_t x;
+    uint32_t y;
+    uint32_t width;
+    uint32_t height;
+};
+
+// Mirrors MapCell
+struct GMapCell {
+    int32_t x;
+    int32_t z;
+    float boundsMin[3];
+    float boundsMax[3];
+    uint32_t firstBrush;
+    uint32_t brushCount;
+    uint32_t firstEntity;
+    uint32_t entityCount;
+};
+
+static_assert(std::is_trivially_copyable_v<GMapHeader>, "GMap records must be POD");
+static_assert(std::is_trivially_copyable_v<GMapBrush>, "GMap records must be POD");
+static_assert(sizeof(GMapBrush) == 24 + 16 + 36 + 64 + 24, "GMapBrush layout changed (bump GMap::VERSION)");
+static_assert(sizeof(GMapBVHNode) == 32, "GMapBVHNode layout changed (bump GMap::VERSION)");
+static_assert(sizeof(GMapLightmapChart) == 28, "GMapLightmapChart layout changed (bump GMap::VERSION)");
+static_assert(sizeof(GMapCell) == 48, "GMapCell layout changed (bump GMap::VERSION)");
+
+} // namespace Genesis
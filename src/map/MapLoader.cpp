@@ -4,11 +4,23 @@
 #include <sstream>
 #include <algorithm>
 #include <cctype>
+#include <charconv>
+#include <string_view>
+#include <cstddef>
+#include <cstring>
+#include "core/MappedFile.h"
+#include "core/ParallelFor.h"
+#include "core/Profiler.h"
+#include "MapFormat.h"
 
 namespace Genesis {
 
 // ============================================================================
-// Simple JSON Parser (minimal, no external dependencies)
+// JSON Reader - Single-pass tokenizer over the source text
+//
+// Values are parsed in place (std::string_view + std::from_chars), and
+// strings are only copied into their final destination, so load time is
+// linear in file size.
 // ============================================================================
 namespace {
 
@@ -29,150 +41,295 @@ namespace {
         }
     }
 
-    // Parse an int from string
-    int ParseInt(const std::string& str) {
-        try {
-            return std::stoi(Trim(str));
-        } catch (...) {
-            return 0;
-        }
-    }
+    class JsonReader {
+    public:
+        explicit JsonReader(std::string_view text) : m_text(text) {}
+
+        bool Ok() const { return m_error.empty(); }
+        const std::string& GetError() const { return m_error; }
 
-    // Extract string value from JSON (simple parser)
-    std::string ExtractString(const std::string& json, const std::string& key) {
-        std::string searchKey = "\"" + key + "\"";
-        size_t keyPos = json.find(searchKey);
-        if (keyPos == std::string::npos) return "";
+        // Iterate the members of an object; fn(key) must consume the value
+        template<typename Fn>
+        bool ForEachMember(Fn&& fn) {
+            if (!Expect('{')) return false;
+            if (TryConsume('}')) return true;
 
-        size_t colonPos = json.find(':', keyPos);
-        if (colonPos == std::string::npos) return "";
+            do {
+                std::string_view key;
+                if (!ReadKey(key) || !Expect(':')) return false;
+                if (!fn(key) || !Ok()) return false;
+            } while (TryConsume(','));
 
-        size_t startQuote = json.find('"', colonPos + 1);
-        if (startQuote == std::string::npos) return "";
+            return Expect('}');
+        }
 
-        size_t endQuote = json.find('"', startQuote + 1);
-        if (endQuote == std::string::npos) return "";
+        // Iterate the elements of an array; fn() must consume the element
+        template<typename Fn>
+        bool ForEachElement(Fn&& fn) {
+            if (!Expect('[')) return false;
+            if (TryConsume(']')) return true;
 
-        return json.substr(startQuote + 1, endQuote - startQuote - 1);
-    }
+            do {
+                if (!fn() || !Ok()) return false;
+            } while (TryConsume(','));
 
-    // Extract number value from JSON
-    float ExtractNumber(const std::string& json, const std::string& key, float defaultValue = 0.0f) {
-        std::string searchKey = "\"" + key + "\"";
-        size_t keyPos = json.find(searchKey);
-        if (keyPos == std::string::npos) return defaultValue;
+            return Expect(']');
+        }
 
-        size_t colonPos = json.find(':', keyPos);
-        if (colonPos == std::string::npos) return defaultValue;
+        bool ReadString(std::string& out) {
+            std::string_view raw;
+            bool escaped = false;
+            if (!ReadStringToken(raw, escaped)) return false;
 
-        // Skip whitespace
-        size_t valueStart = colonPos + 1;
-        while (valueStart < json.size() && std::isspace(json[valueStart])) valueStart++;
+            if (!escaped) {
+                out.assign(raw.data(), raw.size());
+                return true;
+            }
 
-        // Find end of number
-        size_t valueEnd = valueStart;
-        while (valueEnd < json.size() && (std::isdigit(json[valueEnd]) || json[valueEnd] == '.' || json[valueEnd] == '-' || json[valueEnd] == '+')) {
-            valueEnd++;
+            out.clear();
+            out.reserve(raw.size());
+            for (size_t i = 0; i < raw.size(); i++) {
+                char c = raw[i];
+                if (c != '\\' || i + 1 >= raw.size()) {
+                    out.push_back(c);
+                    continue;
+                }
+                switch (raw[++i]) {
+                    case 'n': out.push_back('\n'); break;
+                    case 't': out.push_back('\t'); break;
+                    case 'r': out.push_back('\r'); break;
+                    case 'b': out.push_back('\b'); break;
+                    case 'f': out.push_back('\f'); break;
+                    // \uXXXX is kept verbatim; map files are plain ASCII
+                    case 'u': out.append("\\u"); break;
+                    default:  out.push_back(raw[i]); break;  // \" \\ \/
+                }
+            }
+            return true;
         }
 
-        if (valueEnd == valueStart) return defaultValue;
+        bool ReadNumber(float& out) {
+            SkipWhitespace();
+            const char* begin = m_text.data() + m_pos;
+            const char* end = m_text.data() + m_text.size();
+            auto [ptr, ec] = std::from_chars(begin, end, out);
+            if (ec != std::errc()) return Fail("expected a number");
+            m_pos += static_cast<size_t>(ptr - begin);
+            return true;
+        }
 
-        return ParseFloat(json.substr(valueStart, valueEnd - valueStart));
-    }
+        bool ReadBool(bool& out) {
+            SkipWhitespace();
+            if (TryLiteral("true")) { out = true; return true; }
+            if (TryLiteral("false")) { out = false; return true; }
+            return Fail("expected true or false");
+        }
 
-    // Extract boolean value from JSON
-    bool ExtractBool(const std::string& json, const std::string& key, bool defaultValue = false) {
-        std::string searchKey = "\"" + key + "\"";
-        size_t keyPos = json.find(searchKey);
-        if (keyPos == std::string::npos) return defaultValue;
+        // [x, y, z] - missing trailing components keep their current value
+        bool ReadVec3(Vec3& out) {
+            int i = 0;
+            return ForEachElement([&]() {
+                float value;
+                if (!ReadNumber(value)) return false;
+                if (i < 3) out[i] = value;
+                i++;
+                return true;
+            });
+        }
 
-        size_t colonPos = json.find(':', keyPos);
-        if (colonPos == std::string::npos) return defaultValue;
+        // Raw text of a scalar value (string contents, number or literal)
+        // Next value is a string, number or literal (not an object/array)
+        bool IsScalarNext() {
+            SkipWhitespace();
+            return Peek() != '{' && Peek() != '[';
+        }
 
-        size_t truePos = json.find("true", colonPos);
-        size_t falsePos = json.find("false", colonPos);
+        bool ReadScalarText(std::string& out) {
+            SkipWhitespace();
+            if (Peek() == '"') return ReadString(out);
 
-        if (truePos != std::string::npos && (falsePos == std::string::npos || truePos < falsePos)) {
+            size_t start = m_pos;
+            if (!SkipValue()) return false;
+            out.assign(m_text.data() + start, m_pos - start);
             return true;
         }
-        return false;
-    }
 
-    // Extract Vec3 from JSON array
-    Vec3 ExtractVec3(const std::string& json, const std::string& key, const Vec3& defaultValue = Vec3(0.0f)) {
-        std::string searchKey = "\"" + key + "\"";
-        size_t keyPos = json.find(searchKey);
-        if (keyPos == std::string::npos) return defaultValue;
+        // Skip over any value (used for unknown keys)
+        bool SkipValue() {
+            SkipWhitespace();
+            char c = Peek();
+            if (c == '{') {
+                return ForEachMember([this](std::string_view) { return SkipValue(); });
+            }
+            if (c == '[') {
+                return ForEachElement([this]() { return SkipValue(); });
+            }
+            if (c == '"') {
+                std::string_view raw;
+                bool escaped;
+                return ReadStringToken(raw, escaped);
+            }
+            if (TryLiteral("true") || TryLiteral("false") || TryLiteral("null")) {
+                return true;
+            }
+            float ignored;
+            return ReadNumber(ignored);
+        }
 
-        size_t arrayStart = json.find('[', keyPos);
-        if (arrayStart == std::string::npos) return defaultValue;
+        // Report an error at the current position (line-based for readability)
+        bool Fail(const char* message) {
+            if (!m_error.empty()) return false;
+            size_t line = 1 + static_cast<size_t>(std::count(m_text.begin(), m_text.begin() + m_pos, '\n'));
+            m_error = std::string("JSON parse error at line ") + std::to_string(line) + ": " + message;
+            return false;
+        }
 
-        size_t arrayEnd = json.find(']', arrayStart);
-        if (arrayEnd == std::string::npos) return defaultValue;
+        bool AtEnd() {
+            SkipWhitespace();
+            return m_pos >= m_text.size();
+        }
 
-        std::string arrayContent = json.substr(arrayStart + 1, arrayEnd - arrayStart - 1);
+    private:
+        void SkipWhitespace() {
+            while (m_pos < m_text.size()) {
+                char c = m_text[m_pos];
+                if (c != ' ' && c != '\t' && c != '\n' && c != '\r') break;
+                m_pos++;
+            }
+        }
 
-        // Parse comma-separated values
-        Vec3 result;
-        std::stringstream ss(arrayContent);
-        std::string token;
-        int i = 0;
-        while (std::getline(ss, token, ',') && i < 3) {
-            result[i++] = ParseFloat(token);
+        char Peek() const {
+            return m_pos < m_text.size() ? m_text[m_pos] : '\0';
         }
 
-        return result;
-    }
+        bool TryConsume(char c) {
+            SkipWhitespace();
+            if (Peek() != c) return false;
+            m_pos++;
+            return true;
+        }
 
-    // Find matching brace
-    size_t FindMatchingBrace(const std::string& json, size_t start) {
-        if (start >= json.size() || json[start] != '{') return std::string::npos;
+        bool Expect(char c) {
+            if (TryConsume(c)) return true;
+            char message[] = "expected 'x'";
+            message[10] = c;
+            return Fail(message);
+        }
 
-        int depth = 1;
-        for (size_t i = start + 1; i < json.size(); i++) {
-            if (json[i] == '{') depth++;
-            else if (json[i] == '}') {
-                depth--;
-                if (depth == 0) return i;
+        bool TryLiteral(std::string_view literal) {
+            if (m_text.compare(m_pos, literal.size(), literal) != 0) return false;
+            m_pos += literal.size();
+            return true;
+        }
+
+        // View of the characters between the quotes (escapes not processed)
+        bool ReadStringToken(std::string_view& out, bool& escaped) {
+            if (!Expect('"')) return false;
+
+            size_t start = m_pos;
+            escaped = false;
+            while (m_pos < m_text.size()) {
+                char c = m_text[m_pos];
+                if (c == '"') {
+                    out = m_text.substr(start, m_pos - start);
+                    m_pos++;
+                    return true;
+                }
+                if (c == '\\') {
+                    escaped = true;
+                    m_pos++;
+                }
+                m_pos++;
             }
+            return Fail("unterminated string");
         }
-        return std::string::npos;
-    }
 
-    // Extract array of objects
-    std::vector<std::string> ExtractObjectArray(const std::string& json, const std::string& key) {
-        std::vector<std::string> result;
+        bool ReadKey(std::string_view& out) {
+            bool escaped;
+            return ReadStringToken(out, escaped);
+        }
 
-        std::string searchKey = "\"" + key + "\"";
-        size_t keyPos = json.find(searchKey);
-        if (keyPos == std::string::npos) return result;
+        std::string_view m_text;
+        size_t m_pos = 0;
+        std::string m_error;
+    };
 
-        size_t arrayStart = json.find('[', keyPos);
-        if (arrayStart == std::string::npos) return result;
+    bool ParseBrush(JsonReader& reader, Brush& brush, const std::string& defaultMaterial) {
+        brush.materialName = defaultMaterial;
+        brush.flags = BrushFlags::CastShadow | BrushFlags::ReceiveShadow;
 
-        size_t pos = arrayStart + 1;
-        while (pos < json.size()) {
-            // Skip whitespace
-            while (pos < json.size() && std::isspace(json[pos])) pos++;
+        auto setFlag = [&](BrushFlags flag) {
+            bool enabled = false;
+            if (!reader.ReadBool(enabled)) return false;
+            if (enabled) brush.flags = brush.flags | flag;
+            return true;
+        };
+
+        bool ok = reader.ForEachMember([&](std::string_view key) {
+            if (key == "shape") {
+                std::string shape;
+                if (!reader.ReadString(shape)) return false;
+                brush.shape = StringToBrushShape(shape.empty() ? "cube" : shape);
+                return true;
+            }
+            if (key == "position") return reader.ReadVec3(brush.position);
+            if (key == "size") return reader.ReadVec3(brush.size);
+            if (key == "rotation") return reader.ReadVec3(brush.rotation);
+            if (key == "material") return reader.ReadString(brush.materialName);
+            if (key == "name") return reader.ReadString(brush.name);
+            if (key == "layer") return reader.ReadString(brush.layer);
+            if (key == "no_collision") return setFlag(BrushFlags::NoCollision);
+            if (key == "stair") return setFlag(BrushFlags::Stair);
+            if (key == "trigger") return setFlag(BrushFlags::Trigger);
+            if (key == "no_render") return setFlag(BrushFlags::NoRender);
+            if (key == "detail") return setFlag(BrushFlags::Detail);
+            if (key == "vis_group") {
+                float group = 0.0f;
+                if (!reader.ReadNumber(group)) return false;
+                brush.visGroup = group > 0.0f ? static_cast<uint32_t>(group) : 0;
+                return true;
+            }
+            return reader.SkipValue();
+        });
 
-            if (pos >= json.size() || json[pos] == ']') break;
+        if (brush.materialName.empty()) brush.materialName = defaultMaterial;
+        if (brush.layer.empty()) brush.layer = "default";
+        return ok;
+    }
 
-            if (json[pos] == '{') {
-                size_t objEnd = FindMatchingBrace(json, pos);
-                if (objEnd != std::string::npos) {
-                    result.push_back(json.substr(pos, objEnd - pos + 1));
-                    pos = objEnd + 1;
-                } else {
-                    break;
-                }
-            } else if (json[pos] == ',') {
-                pos++;
-            } else {
-                pos++;
+    bool ParseEntity(JsonReader& reader, MapEntity& entity) {
+        return reader.ForEachMember([&](std::string_view key) {
+            if (key == "classname") return reader.ReadString(entity.classname);
+            if (key == "targetname") return reader.ReadString(entity.targetname);
+            if (key == "position") return reader.ReadVec3(entity.position);
+            if (key == "rotation") return reader.ReadVec3(entity.rotation);
+
+            // Any other scalar becomes a string property; objects and arrays
+            // have no property form and are skipped
+            if (!reader.IsScalarNext()) return reader.SkipValue();
+            std::string value;
+            if (!reader.ReadScalarText(value)) return false;
+            entity.properties.emplace(std::string(key), std::move(value));
+            return true;
+        });
+    }
+
+    // Quoted JSON string, escaped the way ReadString unescapes it
+    void WriteJsonString(std::ostream& out, std::string_view text) {
+        out << '"';
+        for (char c : text) {
+            switch (c) {
+                case '"':  out << "\\\""; break;
+                case '\\': out << "\\\\"; break;
+                case '\n': out << "\\n"; break;
+                case '\t': out << "\\t"; break;
+                case '\r': out << "\\r"; break;
+                case '\b': out << "\\b"; break;
+                case '\f': out << "\\f"; break;
+                default:   out << c; break;
             }
         }
-
-        return result;
+        out << '"';
     }
 
 } // anonymous namespace
@@ -185,7 +342,8 @@ MapLoader::MapLoader() {
     // Register default materials if needed
 }
 
-MapPtr MapLoader::Load(const std::string& filepath) {
+MapPtr MapLoader::Load(const std::string& filepath, bool deferResources) {
+    GENESIS_PROFILE_SCOPE("Map Load");
     ClearError();
 
     std::string fullPath = m_basePath + filepath;
@@ -196,89 +354,107 @@ MapPtr MapLoader::Load(const std::string& filepath) {
     std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
 
     if (ext == ".json") {
-        return LoadJSON(fullPath);
+        return LoadJSON(fullPath, deferResources);
+    } else if (ext == ".gmap") {
+        return LoadBinary(fullPath, deferResources);
     } else if (ext == ".map" || ext == ".txt") {
-        return LoadSimple(fullPath);
+        return LoadSimple(fullPath, deferResources);
     } else {
         // Default to JSON
-        return LoadJSON(fullPath);
+        return LoadJSON(fullPath, deferResources);
     }
 }
 
-MapPtr MapLoader::LoadJSON(const std::string& filepath) {
+MapPtr MapLoader::LoadJSON(const std::string& filepath, bool deferResources) {
     ClearError();
 
-    std::ifstream file(filepath);
+    std::ifstream file(filepath, std::ios::binary);
     if (!file.is_open()) {
         SetError("Failed to open file: " + filepath);
         return nullptr;
     }
 
-    std::stringstream buffer;
-    buffer << file.rdbuf();
-    std::string content = buffer.str();
+    // Read the whole file in one allocation
+    file.seekg(0, std::ios::end);
+    std::string content(static_cast<size_t>(file.tellg()), '\0');
+    file.seekg(0, std::ios::beg);
+    file.read(content.data(), static_cast<std::streamsize>(content.size()));
+    content.resize(static_cast<size_t>(file.gcount()));
     file.close();
 
-    return LoadFromString(content);
+    return LoadFromString(content, deferResources);
 }
 
-MapPtr MapLoader::LoadFromString(const std::string& jsonString) {
+MapPtr MapLoader::LoadFromString(const std::string& jsonString, bool deferResources) {
     ClearError();
 
     auto map = std::make_shared<Map>();
-
-    // Parse metadata
     MapMetadata& meta = map->GetMetadata();
-    meta.name = ExtractString(jsonString, "name");
-    if (meta.name.empty()) meta.name = "Untitled";
-    meta.author = ExtractString(jsonString, "author");
-    meta.version = ExtractString(jsonString, "version");
-    meta.description = ExtractString(jsonString, "description");
-
-    // Parse spawn
-    meta.spawnPosition = ExtractVec3(jsonString, "spawn_position", Vec3(0, 1, 0));
-    meta.spawnRotation = ExtractVec3(jsonString, "spawn_rotation", Vec3(0));
-
-    // Parse environment
-    meta.sunDirection = ExtractVec3(jsonString, "sun_direction", Vec3(0.5f, 1.0f, 0.3f));
-    meta.sunColor = ExtractVec3(jsonString, "sun_color", Vec3(1.0f, 0.98f, 0.95f));
-    meta.sunIntensity = ExtractNumber(jsonString, "sun_intensity", 1.0f);
-    meta.ambientColor = ExtractVec3(jsonString, "ambient_color", Vec3(0.15f, 0.15f, 0.2f));
-
-    // Parse brushes
-    auto brushObjects = ExtractObjectArray(jsonString, "brushes");
-    for (const auto& brushJson : brushObjects) {
-        Brush brush;
-        if (ParseJSONBrush(brushJson, brush)) {
-            map->AddBrush(std::move(brush));
+    JsonReader reader(jsonString);
+
+    bool ok = reader.ForEachMember([&](std::string_view key) {
+        // Metadata
+        if (key == "name") return reader.ReadString(meta.name);
+        if (key == "author") return reader.ReadString(meta.author);
+        if (key == "version") return reader.ReadString(meta.version);
+        if (key == "description") return reader.ReadString(meta.description);
+
+        // Spawn
+        if (key == "spawn_position") return reader.ReadVec3(meta.spawnPosition);
+        if (key == "spawn_rotation") return reader.ReadVec3(meta.spawnRotation);
+
+        // Environment
+        if (key == "sun_direction") return reader.ReadVec3(meta.sunDirection);
+        if (key == "sun_color") return reader.ReadVec3(meta.sunColor);
+        if (key == "sun_intensity") return reader.ReadNumber(meta.sunIntensity);
+        if (key == "ambient_color") return reader.ReadVec3(meta.ambientColor);
+
+        if (key == "brushes") {
+            return reader.ForEachElement([&]() {
+                Brush brush;
+                if (!ParseBrush(reader, brush, m_defaultMaterial)) return false;
+                map->AddBrush(std::move(brush));
+                return true;
+            });
         }
-    }
-
-    // Parse entities
-    auto entityObjects = ExtractObjectArray(jsonString, "entities");
-    for (const auto& entityJson : entityObjects) {
-        MapEntity entity;
-        entity.classname = ExtractString(entityJson, "classname");
-        entity.targetname = ExtractString(entityJson, "targetname");
-        entity.position = ExtractVec3(entityJson, "position");
-        entity.rotation = ExtractVec3(entityJson, "rotation");
 
-        if (!entity.classname.empty()) {
-            map->AddEntity(entity);
+        if (key == "entities") {
+            return reader.ForEachElement([&]() {
+                MapEntity entity;
+                if (!ParseEntity(reader, entity)) return false;
+                if (!entity.classname.empty()) {
+                    map->AddEntity(std::move(entity));
+                }
+                return true;
+            });
         }
+
+        return reader.SkipValue();
+    });
+
+    if (ok && !reader.AtEnd()) {
+        reader.Fail("unexpected data after the top-level object");
+        ok = false;
+    }
+
+    if (!ok) {
+        SetError(reader.GetError());
+        return nullptr;
     }
 
+    if (meta.name.empty()) meta.name = "Untitled";
+
     LOG_INFO("MapLoader", "Loaded map '" + meta.name + "' with " +
              std::to_string(map->GetBrushCount()) + " brushes, " +
              std::to_string(map->GetEntityCount()) + " entities");
 
     // Build the map (resolve meshes, materials, colliders)
-    BuildMap(*map);
+    BuildMap(*map, deferResources);
 
     return map;
 }
 
-MapPtr MapLoader::LoadSimple(const std::string& filepath) {
+MapPtr MapLoader::LoadSimple(const std::string& filepath, bool deferResources) {
     ClearError();
 
     std::ifstream file(filepath);
@@ -343,53 +519,11 @@ MapPtr MapLoader::LoadSimple(const std::string& filepath) {
     LOG_INFO("MapLoader", "Loaded simple map with " + std::to_string(map->GetBrushCount()) + " brushes");
 
     // Build the map
-    BuildMap(*map);
+    BuildMap(*map, deferResources);
 
     return map;
 }
 
-bool MapLoader::ParseJSONBrush(const std::string& json, Brush& brush) {
-    // Shape
-    std::string shapeStr = ExtractString(json, "shape");
-    brush.shape = StringToBrushShape(shapeStr.empty() ? "cube" : shapeStr);
-
-    // Position and size
-    brush.position = ExtractVec3(json, "position", Vec3(0.0f));
-    brush.size = ExtractVec3(json, "size", Vec3(1.0f));
-    brush.rotation = ExtractVec3(json, "rotation", Vec3(0.0f));
-
-    // Material
-    brush.materialName = ExtractString(json, "material");
-    if (brush.materialName.empty()) {
-        brush.materialName = m_defaultMaterial;
-    }
-
-    // Name and layer
-    brush.name = ExtractString(json, "name");
-    brush.layer = ExtractString(json, "layer");
-    if (brush.layer.empty()) brush.layer = "default";
-
-    // Flags
-    brush.flags = BrushFlags::CastShadow | BrushFlags::ReceiveShadow;
-    if (ExtractBool(json, "no_collision")) {
-        brush.flags = brush.flags | BrushFlags::NoCollision;
-    }
-    if (ExtractBool(json, "stair")) {
-        brush.flags = brush.flags | BrushFlags::Stair;
-    }
-    if (ExtractBool(json, "trigger")) {
-        brush.flags = brush.flags | BrushFlags::Trigger;
-    }
-    if (ExtractBool(json, "no_render")) {
-        brush.flags = brush.flags | BrushFlags::NoRender;
-    }
-    if (ExtractBool(json, "detail")) {
-        brush.flags = brush.flags | BrushFlags::Detail;
-    }
-
-    return true;
-}
-
 bool MapLoader::ParseSimpleLine(const std::string& line, Brush& brush) {
     std::stringstream ss(line);
     std::string token;
@@ -442,72 +576,222 @@ bool MapLoader::ParseSimpleLine(const std::string& line, Brush& brush) {
     return true;
 }
 
-void MapLoader::BuildMap(Map& map) {
-    for (auto& brush : map.GetBrushes()) {
-        BuildBrush(brush);
+void MapLoader::BuildMap(Map& map, bool deferResources) {
+    auto& brushes = map.GetBrushes();
+    bool resolve = !deferResources;
+
+    // GL-owning resources first, on this thread
+    SharedResources shared;
+    if (resolve) {
+        shared = PrepareSharedResources(brushes);
     }
 
+    // Transforms, bounds and colliders are independent per brush
+    ParallelFor(brushes.size(), BUILD_BATCH_SIZE, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            Brush& brush = brushes[i];
+            brush.BuildTransform();
+            if (resolve) {
+                ResolveBrushResources(brush, shared);
+            }
+            BuildBrushCollider(brush);
+            brush.worldBounds = brush.GetWorldAABB();
+        }
+    });
+
     // Register layers
-    for (const auto& brush : map.GetBrushes()) {
+    for (const auto& brush : brushes) {
         map.AddLayer(brush.layer);
     }
+
+    map.BuildBrushBVH();
 }
 
 void MapLoader::BuildBrush(Brush& brush) {
+    SharedResources shared;
+    PrepareBrushResources(brush, shared);
+
     // Build transform matrix
     brush.BuildTransform();
 
-    // Get mesh from library
-    auto& meshLib = MeshLibrary::Instance();
-    brush.mesh = meshLib.GetForShape(brush.shape);
+    ResolveBrushResources(brush, shared);
+    BuildBrushCollider(brush);
+    brush.worldBounds = brush.GetWorldAABB();
+}
+
+MapPtr MapLoader::LoadDeferred(const std::string& filepath) {
+    return Load(filepath, true);
+}
+
+MapPtr MapLoader::LoadFromStringDeferred(const std::string& jsonString) {
+    return LoadFromString(jsonString, true);
+}
+
+void MapLoader::ResolveResources(Map& map) {
+    auto& brushes = map.GetBrushes();
+    SharedResources shared = PrepareSharedResources(brushes);
+
+    ParallelFor(brushes.size(), BUILD_BATCH_SIZE, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            ResolveBrushResources(brushes[i], shared);
+        }
+    });
+
+    AttachLightmap(map);
+}
+
+void MapLoader::AttachLightmap(Map& map) {
+    const MapLightmapPtr& lightmap = map.GetLightmap();
+    if (!lightmap || lightmap->IsEmpty()) return;
+
+    uint32_t attached = 0;
+    for (Brush& brush : map.GetBrushes()) {
+        if (AttachBrushLightmap(*lightmap, brush)) {
+            attached++;
+        }
+    }
+
+    LOG_INFO("MapLoader", "Lightmap attached to " + std::to_string(attached) + " brushes");
+}
+
+bool MapLoader::AttachBrushLightmap(const MapLightmap& lightmap, Brush& brush) {
+    std::vector<Vec3> uvs;
+    const LightmapChart* charts = lightmap.FindCharts(brush.id);
+    if (!charts || !brush.mesh || !lightmap.BuildVertexUVs(charts, *brush.mesh, uvs)) return false;
+
+    // Same vertices and indices as the shared shape mesh, plus the UVs
+    const Mesh& shared = *brush.mesh;
+    auto mesh = std::make_shared<Mesh>(shared.GetName() + "_lightmap" + std::to_string(brush.id));
+    mesh->SetLayout(shared.GetLayout());
+    mesh->SetVertexData(shared.GetVertexData().data(), shared.GetVertexData().size(), shared.GetVertexCount());
+    const uint8_t* indexData = shared.GetIndexData().data();
+    if (shared.GetIndexType() == IndexType::UInt16 && shared.HasIndices()) {
+        const uint16_t* src = reinterpret_cast<const uint16_t*>(indexData);
+        mesh->SetIndexData(std::vector<uint16_t>(src, src + shared.GetIndexCount()));
+    } else if (shared.GetIndexType() == IndexType::UInt32 && shared.HasIndices()) {
+        const uint32_t* src = reinterpret_cast<const uint32_t*>(indexData);
+        mesh->SetIndexData(std::vector<uint32_t>(src, src + shared.GetIndexCount()));
+    }
+    mesh->SetDrawMode(shared.GetDrawMode());
+    mesh->SetBoundingBox(shared.GetBoundsMin(), shared.GetBoundsMax());
+    mesh->SetLightmapUVs(std::move(uvs));
+    mesh->SetKeepCPUData(true);     // Merge source for the static world, and interned
+
+    // Brushes with identical charts share one clone
+    MeshPtr interned = MeshLibrary::Instance().Intern(mesh);
+    if (interned == mesh) {
+        mesh->Upload();
+    }
+
+    brush.mesh = std::move(interned);
+    return true;
+}
+
+bool MapLoader::ReadCell(const MapPartition& partition, uint32_t cell, BrushList& out) {
+    if (!partition.source || cell >= partition.GetCellCount()) return false;
+
+    size_t first = out.size();
+    if (!partition.source->ReadCell(partition.cells[cell], out)) return false;
+    for (size_t i = first; i < out.size(); i++) {
+        BuildBrushCollider(out[i]);
+    }
+    return true;
+}
+
+void MapLoader::ResolveBrushes(const Map& map, BrushList& brushes) {
+    SharedResources shared = PrepareSharedResources(brushes);
+    for (Brush& brush : brushes) {
+        ResolveBrushResources(brush, shared);
+    }
+
+    const MapLightmapPtr& lightmap = map.GetLightmap();
+    if (lightmap && !lightmap->IsEmpty()) {
+        for (Brush& brush : brushes) {
+            AttachBrushLightmap(*lightmap, brush);
+        }
+    }
+}
+
+MapLoader::SharedResources MapLoader::PrepareSharedResources(const BrushList& brushes) {
+    // Few distinct shapes/materials, many brushes: prepare each one once
+    SharedResources shared;
+    uint32_t shapesSeen = 0;
+
+    for (const auto& brush : brushes) {
+        uint32_t shapeBit = 1u << (static_cast<uint32_t>(brush.shape) & 31u);
+        bool newShape = (shapesSeen & shapeBit) == 0;
+        bool newMaterial = !shared.materials.contains(brush.materialName);
+        if (newShape || newMaterial) {
+            PrepareBrushResources(brush, shared);
+            shapesSeen |= shapeBit;
+        }
+    }
+    return shared;
+}
+
+void MapLoader::PrepareBrushResources(const Brush& brush, SharedResources& shared) {
+    // Creates (and uploads) the shape mesh if this is its first use
+    shared.meshes[static_cast<uint32_t>(brush.shape) & 31u] = MeshLibrary::Instance().GetForShape(brush.shape);
 
-    // Get material from library
     auto& matLib = MaterialLibrary::Instance();
-    brush.material = matLib.Get(brush.materialName);
-
-    // If material not found, create a default one
-    if (!brush.material) {
-        // Create a simple colored material based on material name
-        Vec3 color(0.5f, 0.5f, 0.5f); // Default gray
-
-        // Some common material name to color mappings
-        std::string matName = brush.materialName;
-        std::transform(matName.begin(), matName.end(), matName.begin(), ::tolower);
-
-        if (matName == "floor" || matName == "ground") {
-            color = Vec3(0.3f, 0.3f, 0.35f);
-        } else if (matName == "wall") {
-            color = Vec3(0.6f, 0.55f, 0.5f);
-        } else if (matName == "ceiling") {
-            color = Vec3(0.7f, 0.7f, 0.75f);
-        } else if (matName == "brick") {
-            color = Vec3(0.6f, 0.3f, 0.2f);
-        } else if (matName == "concrete" || matName == "cement") {
-            color = Vec3(0.5f, 0.5f, 0.5f);
-        } else if (matName == "wood") {
-            color = Vec3(0.5f, 0.35f, 0.2f);
-        } else if (matName == "metal") {
-            color = Vec3(0.6f, 0.6f, 0.65f);
-        } else if (matName == "grass") {
-            color = Vec3(0.2f, 0.5f, 0.2f);
-        } else if (matName == "water") {
-            color = Vec3(0.2f, 0.4f, 0.7f);
-        } else if (matName == "red") {
-            color = Vec3(0.7f, 0.2f, 0.2f);
-        } else if (matName == "green") {
-            color = Vec3(0.2f, 0.7f, 0.2f);
-        } else if (matName == "blue") {
-            color = Vec3(0.2f, 0.2f, 0.7f);
-        } else if (matName == "white") {
-            color = Vec3(0.9f, 0.9f, 0.9f);
-        } else if (matName == "black") {
-            color = Vec3(0.1f, 0.1f, 0.1f);
-        }
-
-        brush.material = matLib.CreateSolidColor(brush.materialName, color);
-        LOG_DEBUG("MapLoader", "Created material '" + brush.materialName + "'");
+    if (!matLib.Exists(brush.materialName)) {
+        CreateFallbackMaterial(brush.materialName);
     }
+    shared.materials.emplace(brush.materialName, matLib.Get(brush.materialName));
+}
+
+MaterialPtr MapLoader::CreateFallbackMaterial(const std::string& name) {
+    // Create a simple colored material based on material name
+    Vec3 color(0.5f, 0.5f, 0.5f); // Default gray
+
+    // Some common material name to color mappings
+    std::string matName = name;
+    std::transform(matName.begin(), matName.end(), matName.begin(), ::tolower);
+
+    if (matName == "floor" || matName == "ground") {
+        color = Vec3(0.3f, 0.3f, 0.35f);
+    } else if (matName == "wall") {
+        color = Vec3(0.6f, 0.55f, 0.5f);
+    } else if (matName == "ceiling") {
+        color = Vec3(0.7f, 0.7f, 0.75f);
+    } else if (matName == "brick") {
+        color = Vec3(0.6f, 0.3f, 0.2f);
+    } else if (matName == "concrete" || matName == "cement") {
+        color = Vec3(0.5f, 0.5f, 0.5f);
+    } else if (matName == "wood") {
+        color = Vec3(0.5f, 0.35f, 0.2f);
+    } else if (matName == "metal") {
+        color = Vec3(0.6f, 0.6f, 0.65f);
+    } else if (matName == "grass") {
+        color = Vec3(0.2f, 0.5f, 0.2f);
+    } else if (matName == "water") {
+        color = Vec3(0.2f, 0.4f, 0.7f);
+    } else if (matName == "red") {
+        color = Vec3(0.7f, 0.2f, 0.2f);
+    } else if (matName == "green") {
+        color = Vec3(0.2f, 0.7f, 0.2f);
+    } else if (matName == "blue") {
+        color = Vec3(0.2f, 0.2f, 0.7f);
+    } else if (matName == "white") {
+        color = Vec3(0.9f, 0.9f, 0.9f);
+    } else if (matName == "black") {
+        color = Vec3(0.1f, 0.1f, 0.1f);
+    }
+
+    // Never modified afterwards, so identical fallbacks can share one
+    auto material = MaterialLibrary::Instance().InternSolidColor(name, color);
+    LOG_DEBUG("MapLoader", "Created material '" + name + "'");
+    return material;
+}
 
+void MapLoader::ResolveBrushResources(Brush& brush, const SharedResources& shared) {
+    // PrepareSharedResources() saw every shape and material of the brushes
+    brush.mesh = shared.meshes[static_cast<uint32_t>(brush.shape) & 31u];
+    auto it = shared.materials.find(brush.materialName);
+    brush.material = it != shared.materials.end() ? it->second : nullptr;
+}
+
+void MapLoader::BuildBrushCollider(Brush& brush) {
     // Create collider if brush has collision
     if (brush.HasCollision()) {
         brush.collider = CreateCollider(brush);
@@ -549,6 +833,11 @@ ColliderPtr MapLoader::CreateCollider(const Brush& brush) {
 bool MapLoader::SaveJSON(const Map& map, const std::string& filepath) {
     ClearError();
 
+    if (map.IsStreamed()) {
+        SetError("Can't save a streamed map (only its resident cells are loaded): " + filepath);
+        return false;
+    }
+
     std::string fullPath = m_basePath + filepath;
     std::ofstream file(fullPath);
     if (!file.is_open()) {
@@ -592,6 +881,7 @@ bool MapLoader::SaveJSON(const Map& map, const std::string& filepath) {
         if (HasFlag(brush.flags, BrushFlags::Trigger)) file << ",\n      \"trigger\": true";
         if (HasFlag(brush.flags, BrushFlags::NoRender)) file << ",\n      \"no_render\": true";
         if (HasFlag(brush.flags, BrushFlags::Detail)) file << ",\n      \"detail\": true";
+        if (brush.visGroup != 0) file << ",\n      \"vis_group\": " << brush.visGroup;
         if (!brush.layer.empty() && brush.layer != "default") {
             file << ",\n      \"layer\": \"" << brush.layer << "\"";
         }
@@ -617,8 +907,25 @@ bool MapLoader::SaveJSON(const Map& map, const std::string& filepath) {
             file << "      \"targetname\": \"" << entity.targetname << "\",\n";
         }
         file << "      \"position\": [" << entity.position.x << ", " << entity.position.y << ", " << entity.position.z << "],\n";
-        file << "      \"rotation\": [" << entity.rotation.x << ", " << entity.rotation.y << ", " << entity.rotation.z << "]\n";
-        file << "    }";
+        file << "      \"rotation\": [" << entity.rotation.x << ", " << entity.rotation.y << ", " << entity.rotation.z << "]";
+
+        // Properties as strings (the loader keeps every scalar as its text),
+        // sorted so saving the same map twice gives the same file
+        std::vector<const std::pair<const std::string, std::string>*> properties;
+        properties.reserve(entity.properties.size());
+        for (const auto& property : entity.properties) {
+            properties.push_back(&property);
+        }
+        std::sort(properties.begin(), properties.end(),
+                  [](const auto* a, const auto* b) { return a->first < b->first; });
+        for (const auto* property : properties) {
+            file << ",\n      ";
+            WriteJsonString(file, property->first);
+            file << ": ";
+            WriteJsonString(file, property->second);
+        }
+
+        file << "\n    }";
         if (i < entities.size() - 1) file << ",";
         file << "\n";
     }
@@ -635,6 +942,11 @@ bool MapLoader::SaveJSON(const Map& map, const std::string& filepath) {
 bool MapLoader::SaveSimple(const Map& map, const std::string& filepath) {
     ClearError();
 
+    if (map.IsStreamed()) {
+        SetError("Can't save a streamed map (only its resident cells are loaded): " + filepath);
+        return false;
+    }
+
     std::string fullPath = m_basePath + filepath;
     std::ofstream file(fullPath);
     if (!file.is_open()) {
@@ -676,6 +988,672 @@ bool MapLoader::SaveSimple(const Map& map, const std::string& filepath) {
     return true;
 }
 
+// ============================================================================
+// Binary Format (.gmap)
+// ============================================================================
+
+namespace {
+
+    // Builds the deduplicated string table while writing records
+    class GMapStringTable {
+    public:
+        GMapString Add(const std::string& str) {
+            auto it = m_lookup.find(str);
+            if (it != m_lookup.end()) return it->second;
+
+            GMapString ref;
+            ref.offset = static_cast<uint32_t>(m_data.size());
+            ref.length = static_cast<uint32_t>(str.size());
+            m_data.insert(m_data.end(), str.begin(), str.end());
+            m_data.push_back('\0');
+            m_lookup.emplace(str, ref);
+            return ref;
+        }
+
+        const std::vector<char>& GetData() const { return m_data; }
+
+    private:
+        std::vector<char> m_data;
+        std::unordered_map<std::string, GMapString> m_lookup;
+    };
+
+    void CopyVec3(float* dst, const Vec3& v) {
+        dst[0] = v.x; dst[1] = v.y; dst[2] = v.z;
+    }
+
+    Vec3 ToVec3(const float* src) {
+        return Vec3(src[0], src[1], src[2]);
+    }
+
+    uint64_t AlignOffset(uint64_t offset) {
+        return (offset + 7) & ~uint64_t(7);
+    }
+
+    // Bounds-checked view over the mapped file
+    struct GMapView {
+        const uint8_t* data;
+        size_t size;
+        const char* strings;
+        uint32_t stringSize;
+
+        bool HasRange(uint64_t offset, uint64_t count, size_t stride) const {
+            return offset <= size && count <= (size - offset) / stride;
+        }
+
+        template<typename T>
+        T Read(uint64_t offset, uint32_t index) const {
+            T value;
+            std::memcpy(&value, data + offset + static_cast<uint64_t>(index) * sizeof(T), sizeof(T));
+            return value;
+        }
+
+        bool ReadString(const GMapString& ref, std::string& out) const {
+            if (ref.offset > stringSize || ref.length > stringSize - ref.offset) return false;
+            out.assign(strings + ref.offset, ref.length);
+            return true;
+        }
+    };
+
+    // Records carry everything but GPU/library resources and the collider
+    bool ReadBrushRecord(const GMapView& view, const GMapBrush& record, Brush& brush) {
+        bool stringsOk = view.ReadString(record.name, brush.name);
+        stringsOk &= view.ReadString(record.material, brush.materialName);
+        stringsOk &= view.ReadString(record.layer, brush.layer);
+        brush.id = record.id;
+        brush.shape = static_cast<BrushShape>(record.shape);
+        brush.flags = static_cast<BrushFlags>(record.flags);
+        brush.visGroup = record.visGroup;
+        brush.position = ToVec3(record.position);
+        brush.size = ToVec3(record.size);
+        brush.rotation = ToVec3(record.rotation);
+        std::memcpy(&brush.transform[0][0], record.transform, sizeof(record.transform));
+        brush.worldBounds = AABB(ToVec3(record.boundsMin), ToVec3(record.boundsMax));
+        return stringsOk;
+    }
+
+    // Keeps a streamed .gmap mapped and reads cells' brush records from it
+    class GMapCellSource : public MapCellSource {
+    public:
+        GMapCellSource(MappedFile&& file, const GMapHeader& header)
+            : m_file(std::move(file)),
+              m_view{ m_file.GetData(), m_file.GetSize(),
+                      reinterpret_cast<const char*>(m_file.GetData() + header.stringOffset),
+                      header.stringTableSize },
+              m_brushOffset(header.brushOffset),
+              m_brushCount(header.brushCount) {}
+
+        bool ReadCell(const MapCell& cell, BrushList& out) const override {
+            if (cell.firstBrush > m_brushCount || cell.brushCount > m_brushCount - cell.firstBrush) return false;
+
+            out.reserve(out.size() + cell.brushCount);
+            bool stringsOk = true;
+            for (uint32_t i = 0; i < cell.brushCount; i++) {
+                Brush brush;
+                stringsOk &= ReadBrushRecord(m_view, m_view.Read<GMapBrush>(m_brushOffset, cell.firstBrush + i), brush);
+                out.push_back(std::move(brush));
+            }
+            return stringsOk;
+        }
+
+    private:
+        MappedFile m_file;
+        GMapView m_view;
+        uint64_t m_brushOffset;
+        uint32_t m_brushCount;
+    };
+
+} // anonymous namespace
+
+bool MapLoader::SaveBinary(const Map& map, const std::string& filepath, bool includeBVH, bool includeVis,
+                           bool includeLightmap, float cellSize) {
+    ClearError();
+
+    if (map.IsStreamed()) {
+        SetError("Can't save a streamed map (only its resident cells are loaded): " + filepath);
+        return false;
+    }
+
+    std::string fullPath = m_basePath + filepath;
+    std::ofstream file(fullPath, std::ios::binary);
+    if (!file.is_open()) {
+        SetError("Failed to open file for writing: " + fullPath);
+        return false;
+    }
+
+    GMapStringTable strings;
+    const auto& meta = map.GetMetadata();
+
+    GMapMetadata metaRecord = {};
+    metaRecord.name = strings.Add(meta.name);
+    metaRecord.author = strings.Add(meta.author);
+    metaRecord.version = strings.Add(meta.version);
+    metaRecord.description = strings.Add(meta.description);
+    metaRecord.skybox = strings.Add(meta.skybox);
+    CopyVec3(metaRecord.spawnPosition, meta.spawnPosition);
+    CopyVec3(metaRecord.spawnRotation, meta.spawnRotation);
+    CopyVec3(metaRecord.ambientColor, meta.ambientColor);
+    CopyVec3(metaRecord.sunDirection, meta.sunDirection);
+    CopyVec3(metaRecord.sunColor, meta.sunColor);
+    metaRecord.sunIntensity = meta.sunIntensity;
+    CopyVec3(metaRecord.fogColor, meta.fogColor);
+    metaRecord.fogStart = meta.fogStart;
+    metaRecord.fogEnd = meta.fogEnd;
+
+    // Brushes (transform and bounds recomputed so unbuilt maps work too)
+    const auto& brushes = map.GetBrushes();
+    std::vector<GMapBrush> brushRecords(brushes.size());
+    for (size_t i = 0; i < brushes.size(); i++) {
+        const Brush& brush = brushes[i];
+        GMapBrush& record = brushRecords[i];
+        record = {};
+        record.name = strings.Add(brush.name);
+        record.material = strings.Add(brush.materialName);
+        record.layer = strings.Add(brush.layer);
+        record.id = brush.id;
+        record.shape = static_cast<uint32_t>(brush.shape);
+        record.flags = static_cast<uint32_t>(brush.flags);
+        record.visGroup = brush.visGroup;
+        CopyVec3(record.position, brush.position);
+        CopyVec3(record.size, brush.size);
+        CopyVec3(record.rotation, brush.rotation);
+
+        Brush built = brush;
+        built.BuildTransform();
+        std::memcpy(record.transform, &built.transform[0][0], sizeof(record.transform));
+
+        AABB bounds = built.GetWorldAABB();
+        CopyVec3(record.boundsMin, bounds.min);
+        CopyVec3(record.boundsMax, bounds.max);
+    }
+
+    // Entities and their properties
+    const auto& entities = map.GetEntities();
+    std::vector<GMapEntity> entityRecords(entities.size());
+    std::vector<GMapProperty> propertyRecords;
+    for (size_t i = 0; i < entities.size(); i++) {
+        const MapEntity& entity = entities[i];
+        GMapEntity& record = entityRecords[i];
+        record = {};
+        record.classname = strings.Add(entity.classname);
+        record.targetname = strings.Add(entity.targetname);
+        CopyVec3(record.position, entity.position);
+        CopyVec3(record.rotation, entity.rotation);
+        record.firstProperty = static_cast<uint32_t>(propertyRecords.size());
+        record.propertyCount = static_cast<uint32_t>(entity.properties.size());
+        for (const auto& [key, value] : entity.properties) {
+            propertyRecords.push_back({ strings.Add(key), strings.Add(value) });
+        }
+    }
+
+    // Partition: brush and entity records regrouped by cell, so each cell
+    // is one range of both (the BVH below is built in the new order)
+    std::vector<GMapCell> cellRecords;
+    if (cellSize <= 0.0f && map.GetPartition()) {
+        cellSize = map.GetPartition()->cellSize;
+    }
+    if (cellSize > 0.0f && !(brushRecords.empty() && entityRecords.empty())) {
+        std::vector<AABB> bounds;
+        bounds.reserve(brushRecords.size());
+        for (const auto& record : brushRecords) {
+            bounds.emplace_back(ToVec3(record.boundsMin), ToVec3(record.boundsMax));
+        }
+
+        std::vector<uint32_t> brushOrder, entityOrder;
+        auto partition = WorldPartitioner::Compute(bounds, entities, cellSize, brushOrder, entityOrder);
+        cellSize = partition->cellSize;
+
+        std::vector<GMapBrush> sortedBrushes(brushRecords.size());
+        for (size_t i = 0; i < brushOrder.size(); i++) {
+            sortedBrushes[i] = brushRecords[brushOrder[i]];
+        }
+        brushRecords = std::move(sortedBrushes);
+
+        std::vector<GMapEntity> sortedEntities(entityRecords.size());
+        for (size_t i = 0; i < entityOrder.size(); i++) {
+            sortedEntities[i] = entityRecords[entityOrder[i]];
+        }
+        entityRecords = std::move(sortedEntities);
+
+        for (const MapCell& cell : partition->cells) {
+            GMapCell record;
+            record.x = cell.x;
+            record.z = cell.z;
+            CopyVec3(record.boundsMin, cell.bounds.min);
+            CopyVec3(record.boundsMax, cell.bounds.max);
+            record.firstBrush = cell.firstBrush;
+            record.brushCount = cell.brushCount;
+            record.firstEntity = cell.firstEntity;
+            record.entityCount = cell.entityCount;
+            cellRecords.push_back(record);
+        }
+    }
+
+    // Brush BVH, built over the same bounds that were just written
+    std::vector<GMapBVHNode> nodeRecords;
+    std::vector<uint32_t> itemRecords;
+    if (includeBVH && !brushRecords.empty()) {
+        std::vector<AABB> bounds;
+        bounds.reserve(brushRecords.size());
+        for (const auto& record : brushRecords) {
+            bounds.emplace_back(ToVec3(record.boundsMin), ToVec3(record.boundsMax));
+        }
+
+        BVH bvh;
+        bvh.Build(bounds);
+        for (const BVHNode& node : bvh.GetNodes()) {
+            GMapBVHNode record;
+            CopyVec3(record.boundsMin, node.bounds.min);
+            CopyVec3(record.boundsMax, node.bounds.max);
+            record.first = node.first;
+            record.count = node.count;
+            nodeRecords.push_back(record);
+        }
+        itemRecords = bvh.GetItems();
+    }
+
+    // Areas and PVS
+    std::vector<GMapArea> areaRecords;
+    std::vector<uint32_t> pvsRecords;
+    if (includeVis && !brushRecords.empty()) {
+        MapVisPtr vis = map.GetVis() ? map.GetVis() : VisCompiler::Compute(map);
+        for (const AABB& area : vis->areas) {
+            GMapArea record;
+            CopyVec3(record.boundsMin, area.min);
+            CopyVec3(record.boundsMax, area.max);
+            areaRecords.push_back(record);
+        }
+        pvsRecords = vis->pvs;
+    }
+
+    // Lightmap charts and texels
+    std::vector<GMapLightmapChart> chartRecords;
+    MapLightmapPtr lightmap;
+    if (includeLightmap && !brushRecords.empty()) {
+        lightmap = map.GetLightmap() ? map.GetLightmap() : LightmapBaker::Bake(map);
+        if (lightmap->IsEmpty()) {
+            lightmap.reset();
+        } else {
+            for (const LightmapChart& chart : lightmap->charts) {
+                chartRecords.push_back({ chart.brushId, chart.face, chart.layer, chart.x, chart.y,
+                                         chart.width, chart.height });
+            }
+        }
+    }
+    const size_t texelBytes = lightmap ? lightmap->texels.size() * sizeof(uint16_t) : 0;
+
+    const auto& stringData = strings.GetData();
+
+    // Lay out sections
+    GMapHeader header = {};
+    std::memcpy(header.magic, GMap::MAGIC, sizeof(header.magic));
+    header.version = GMap::VERSION;
+    header.flags = (nodeRecords.empty() ? 0 : GMap::FLAG_HAS_BVH) |
+                   (areaRecords.empty() ? 0 : GMap::FLAG_HAS_VIS) |
+                   (chartRecords.empty() ? 0 : GMap::FLAG_HAS_LIGHTMAP) |
+                   (cellRecords.empty() ? 0 : GMap::FLAG_HAS_CELLS);
+    header.brushCount = static_cast<uint32_t>(brushRecords.size());
+    header.entityCount = static_cast<uint32_t>(entityRecords.size());
+    header.propertyCount = static_cast<uint32_t>(propertyRecords.size());
+    header.bvhNodeCount = static_cast<uint32_t>(nodeRecords.size());
+    header.bvhItemCount = static_cast<uint32_t>(itemRecords.size());
+    header.areaCount = static_cast<uint32_t>(areaRecords.size());
+    header.pvsWordCount = static_cast<uint32_t>(pvsRecords.size());
+    header.lightmapChartCount = static_cast<uint32_t>(chartRecords.size());
+    header.lightmapSize = lightmap ? lightmap->size : 0;
+    header.lightmapLayers = lightmap ? lightmap->layerCount : 0;
+    header.cellCount = static_cast<uint32_t>(cellRecords.size());
+    header.cellSize = cellRecords.empty() ? 0.0f : cellSize;
+    header.stringTableSize = static_cast<uint32_t>(stringData.size());
+
+    uint64_t offset = AlignOffset(sizeof(GMapHeader));
+    auto place = [&offset](uint64_t& sectionOffset, size_t bytes) {
+        sectionOffset = offset;
+        offset = AlignOffset(offset + bytes);
+    };
+    place(header.metadataOffset, sizeof(GMapMetadata));
+    place(header.brushOffset, brushRecords.size() * sizeof(GMapBrush));
+    place(header.entityOffset, entityRecords.size() * sizeof(GMapEntity));
+    place(header.propertyOffset, propertyRecords.size() * sizeof(GMapProperty));
+    place(header.bvhNodeOffset, nodeRecords.size() * sizeof(GMapBVHNode));
+    place(header.bvhItemOffset, itemRecords.size() * sizeof(uint32_t));
+    place(header.areaOffset, areaRecords.size() * sizeof(GMapArea));
+    place(header.pvsOffset, pvsRecords.size() * sizeof(uint32_t));
+    place(header.lightmapChartOffset, chartRecords.size() * sizeof(GMapLightmapChart));
+    place(header.lightmapTexelOffset, texelBytes);
+    place(header.cellOffset, cellRecords.size() * sizeof(GMapCell));
+    place(header.stringOffset, stringData.size());
+
+    // Write sections in order, padding up to each offset
+    uint64_t written = 0;
+    auto writeAt = [&](uint64_t sectionOffset, const void* data, size_t bytes) {
+        static const char padding[8] = {};
+        file.write(padding, static_cast<std::streamsize>(sectionOffset - written));
+        if (bytes > 0) {
+            file.write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+        }
+        written = sectionOffset + bytes;
+    };
+    writeAt(0, &header, sizeof(header));
+    writeAt(header.metadataOffset, &metaRecord, sizeof(metaRecord));
+    writeAt(header.brushOffset, brushRecords.data(), brushRecords.size() * sizeof(GMapBrush));
+    writeAt(header.entityOffset, entityRecords.data(), entityRecords.size() * sizeof(GMapEntity));
+    writeAt(header.propertyOffset, propertyRecords.data(), propertyRecords.size() * sizeof(GMapProperty));
+    writeAt(header.bvhNodeOffset, nodeRecords.data(), nodeRecords.size() * sizeof(GMapBVHNode));
+    writeAt(header.bvhItemOffset, itemRecords.data(), itemRecords.size() * sizeof(uint32_t));
+    writeAt(header.areaOffset, areaRecords.data(), areaRecords.size() * sizeof(GMapArea));
+    writeAt(header.pvsOffset, pvsRecords.data(), pvsRecords.size() * sizeof(uint32_t));
+    writeAt(header.lightmapChartOffset, chartRecords.data(), chartRecords.size() * sizeof(GMapLightmapChart));
+    writeAt(header.lightmapTexelOffset, lightmap ? lightmap->texels.data() : nullptr, texelBytes);
+    writeAt(header.cellOffset, cellRecords.data(), cellRecords.size() * sizeof(GMapCell));
+    writeAt(header.stringOffset, stringData.data(), stringData.size());
+
+    if (!file.good()) {
+        SetError("Failed to write file: " + fullPath);
+        return false;
+    }
+    file.close();
+
+    LOG_INFO("MapLoader", "Saved binary map to " + fullPath + " (" +
+             std::to_string(brushRecords.size()) + " brushes, " +
+             std::to_string(areaRecords.size()) + " vis areas, " +
+             std::to_string(chartRecords.size()) + " lightmap charts, " +
+             std::to_string(cellRecords.size()) + " cells)");
+    return true;
+}
+
+MapPtr MapLoader::LoadBinary(const std::string& filepath, bool deferResources) {
+    ClearError();
+
+    MappedFile file;
+    if (!file.Open(filepath)) {
+        SetError("Failed to open file: " + filepath);
+        return nullptr;
+    }
+
+    if (file.GetSize() < sizeof(GMapHeader)) {
+        SetError("Not a .gmap file (too small): " + filepath);
+        return nullptr;
+    }
+
+    GMapHeader header;
+    std::memcpy(&header, file.GetData(), sizeof(header));
+    if (std::memcmp(header.magic, GMap::MAGIC, sizeof(header.magic)) != 0) {
+        SetError("Not a .gmap file (bad magic): " + filepath);
+        return nullptr;
+    }
+    if (header.version != GMap::VERSION) {
+        SetError("Unsupported .gmap version " + std::to_string(header.version) + ": " + filepath);
+        return nullptr;
+    }
+
+    GMapView view{ file.GetData(), file.GetSize(), nullptr, header.stringTableSize };
+    if (!view.HasRange(header.metadataOffset, 1, sizeof(GMapMetadata)) ||
+        !view.HasRange(header.brushOffset, header.brushCount, sizeof(GMapBrush)) ||
+        !view.HasRange(header.entityOffset, header.entityCount, sizeof(GMapEntity)) ||
+        !view.HasRange(header.propertyOffset, header.propertyCount, sizeof(GMapProperty)) ||
+        !view.HasRange(header.bvhNodeOffset, header.bvhNodeCount, sizeof(GMapBVHNode)) ||
+        !view.HasRange(header.bvhItemOffset, header.bvhItemCount, sizeof(uint32_t)) ||
+        !view.HasRange(header.areaOffset, header.areaCount, sizeof(GMapArea)) ||
+        !view.HasRange(header.pvsOffset, header.pvsWordCount, sizeof(uint32_t)) ||
+        !view.HasRange(header.lightmapChartOffset, header.lightmapChartCount, sizeof(GMapLightmapChart)) ||
+        !view.HasRange(header.cellOffset, header.cellCount, sizeof(GMapCell)) ||
+        !view.HasRange(header.stringOffset, header.stringTableSize, 1)) {
+        SetError("Corrupt .gmap (section out of range): " + filepath);
+        return nullptr;
+    }
+    view.strings = reinterpret_cast<const char*>(file.GetData() + header.stringOffset);
+
+    auto map = std::make_shared<Map>();
+    bool stringsOk = true;
+
+    // Metadata
+    MapMetadata& meta = map->GetMetadata();
+    GMapMetadata metaRecord = view.Read<GMapMetadata>(header.metadataOffset, 0);
+    stringsOk &= view.ReadString(metaRecord.name, meta.name);
+    stringsOk &= view.ReadString(metaRecord.author, meta.author);
+    stringsOk &= view.ReadString(metaRecord.version, meta.version);
+    stringsOk &= view.ReadString(metaRecord.description, meta.description);
+    stringsOk &= view.ReadString(metaRecord.skybox, meta.skybox);
+    meta.spawnPosition = ToVec3(metaRecord.spawnPosition);
+    meta.spawnRotation = ToVec3(metaRecord.spawnRotation);
+    meta.ambientColor = ToVec3(metaRecord.ambientColor);
+    meta.sunDirection = ToVec3(metaRecord.sunDirection);
+    meta.sunColor = ToVec3(metaRecord.sunColor);
+    meta.sunIntensity = metaRecord.sunIntensity;
+    meta.fogColor = ToVec3(metaRecord.fogColor);
+    meta.fogStart = metaRecord.fogStart;
+    meta.fogEnd = metaRecord.fogEnd;
+
+    // Partition; dropped whole if a cell range leaves the records
+    std::shared_ptr<MapPartition> partition;
+    if ((header.flags & GMap::FLAG_HAS_CELLS) && header.cellCount > 0) {
+        partition = std::make_shared<MapPartition>();
+        partition->cellSize = header.cellSize;
+        partition->cells.reserve(header.cellCount);
+
+        bool valid = header.cellSize > 0.0f;
+        for (uint32_t i = 0; i < header.cellCount && valid; i++) {
+            GMapCell record = view.Read<GMapCell>(header.cellOffset, i);
+            valid = record.firstBrush <= header.brushCount &&
+                    record.brushCount <= header.brushCount - record.firstBrush &&
+                    record.firstEntity <= header.entityCount &&
+                    record.entityCount <= header.entityCount - record.firstEntity;
+
+            MapCell cell;
+            cell.x = record.x;
+            cell.z = record.z;
+            cell.bounds = AABB(ToVec3(record.boundsMin), ToVec3(record.boundsMax));
+            cell.firstBrush = record.firstBrush;
+            cell.brushCount = record.brushCount;
+            cell.firstEntity = record.firstEntity;
+            cell.entityCount = record.entityCount;
+            partition->cells.push_back(cell);
+        }
+
+        if (!valid) {
+            LOG_WARNING("MapLoader", "Ignoring invalid partition in " + filepath);
+            partition.reset();
+        }
+    }
+
+    // Streamed maps start without brushes (MapRenderer reads cells in)
+    const bool streamed = partition && m_streamCells;
+
+    // Brushes - records carry everything but GPU/library resources
+    auto& brushes = map->GetBrushes();
+    const uint32_t brushCount = streamed ? 0 : header.brushCount;
+    brushes.reserve(brushCount);
+    for (uint32_t i = 0; i < brushCount; i++) {
+        Brush brush;
+        stringsOk &= ReadBrushRecord(view, view.Read<GMapBrush>(header.brushOffset, i), brush);
+        map->AddBrushWithId(std::move(brush));
+    }
+    if (streamed) {
+        // Brushes added before their cells arrive mustn't take those ids
+        uint32_t maxId = 0;
+        for (uint32_t i = 0; i < header.brushCount; i++) {
+            uint32_t id;
+            std::memcpy(&id, file.GetData() + header.brushOffset + static_cast<uint64_t>(i) * sizeof(GMapBrush) +
+                        offsetof(GMapBrush, id), sizeof(id));
+            maxId = std::max(maxId, id);
+        }
+        map->ReserveBrushIds(maxId + 1);
+    }
+
+    // Entities
+    for (uint32_t i = 0; i < header.entityCount; i++) {
+        GMapEntity record = view.Read<GMapEntity>(header.entityOffset, i);
+        MapEntity entity;
+        stringsOk &= view.ReadString(record.classname, entity.classname);
+        stringsOk &= view.ReadString(record.targetname, entity.targetname);
+        entity.position = ToVec3(record.position);
+        entity.rotation = ToVec3(record.rotation);
+
+        if (record.firstProperty > header.propertyCount ||
+            record.propertyCount > header.propertyCount - record.firstProperty) {
+            stringsOk = false;
+            break;
+        }
+        for (uint32_t p = 0; p < record.propertyCount; p++) {
+            GMapProperty prop = view.Read<GMapProperty>(header.propertyOffset, record.firstProperty + p);
+            std::string key, value;
+            stringsOk &= view.ReadString(prop.key, key);
+            stringsOk &= view.ReadString(prop.value, value);
+            entity.properties.emplace(std::move(key), std::move(value));
+        }
+        map->AddEntity(entity);
+    }
+
+    if (!stringsOk) {
+        SetError("Corrupt .gmap (bad string or property reference): " + filepath);
+        return nullptr;
+    }
+
+    // Resolve meshes/materials/colliders (transforms are already built)
+    bool resolve = !deferResources;
+    SharedResources shared;
+    if (resolve) {
+        shared = PrepareSharedResources(brushes);
+    }
+    ParallelFor(brushes.size(), BUILD_BATCH_SIZE, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            if (resolve) {
+                ResolveBrushResources(brushes[i], shared);
+            }
+            BuildBrushCollider(brushes[i]);
+        }
+    });
+    for (const auto& brush : brushes) {
+        map->AddLayer(brush.layer);
+    }
+
+    // Prebuilt BVH, validated so a corrupt file can't send queries out of range
+    bool bvhLoaded = false;
+    if ((header.flags & GMap::FLAG_HAS_BVH) && header.bvhNodeCount > 0 && !streamed) {
+        std::vector<BVHNode> nodes(header.bvhNodeCount);
+        std::vector<uint32_t> items(header.bvhItemCount);
+        bool valid = header.bvhItemCount == header.brushCount;
+
+        // Queries walk the tree on a fixed stack of BVH::MAX_DEPTH entries:
+        // every node needs a single parent and a depth that fits in it.
+        // Children come after their parent, so depths are known in order.
+        constexpr uint8_t NO_PARENT = 0xFF;     // Root, or not reached yet
+        std::vector<uint8_t> depths(header.bvhNodeCount, NO_PARENT);
+        depths[0] = 0;
+
+        for (uint32_t i = 0; i < header.bvhItemCount && valid; i++) {
+            items[i] = view.Read<uint32_t>(header.bvhItemOffset, i);
+            valid = items[i] < header.brushCount;
+        }
+        for (uint32_t i = 0; i < header.bvhNodeCount && valid; i++) {
+            GMapBVHNode record = view.Read<GMapBVHNode>(header.bvhNodeOffset, i);
+            nodes[i].bounds = AABB(ToVec3(record.boundsMin), ToVec3(record.boundsMax));
+            nodes[i].first = record.first;
+            nodes[i].count = record.count;
+            valid = record.count > 0
+                ? record.first <= header.bvhItemCount && record.count <= header.bvhItemCount - record.first
+                : record.first > i && record.first < header.bvhNodeCount - 1;
+            if (!valid || record.count > 0) continue;
+
+            valid = depths[i] != NO_PARENT && depths[i] + 1 < BVH::MAX_DEPTH &&
+                    depths[record.first] == NO_PARENT && depths[record.first + 1] == NO_PARENT;
+            depths[record.first] = depths[record.first + 1] = static_cast<uint8_t>(depths[i] + 1);
+        }
+
+        if (valid) {
+            BVH bvh;
+            bvh.Assign(std::move(nodes), std::move(items));
+            map->SetBrushBVH(std::move(bvh));
+            bvhLoaded = true;
+        } else {
+            LOG_WARNING("MapLoader", "Ignoring invalid BVH in " + filepath);
+        }
+    }
+
+    if (!bvhLoaded) {
+        map->BuildBrushBVH();
+    }
+
+    // Vis data; a PVS that doesn't match the area count is dropped
+    if ((header.flags & GMap::FLAG_HAS_VIS) && header.areaCount > 0) {
+        auto vis = std::make_shared<MapVis>();
+        vis->areas.reserve(header.areaCount);
+        for (uint32_t i = 0; i < header.areaCount; i++) {
+            GMapArea record = view.Read<GMapArea>(header.areaOffset, i);
+            vis->areas.emplace_back(ToVec3(record.boundsMin), ToVec3(record.boundsMax));
+        }
+
+        if (static_cast<uint64_t>(header.pvsWordCount) ==
+            static_cast<uint64_t>(header.areaCount) * vis->GetRowWords()) {
+            vis->pvs.resize(header.pvsWordCount);
+            std::memcpy(vis->pvs.data(), file.GetData() + header.pvsOffset,
+                        static_cast<size_t>(header.pvsWordCount) * sizeof(uint32_t));
+            map->SetVis(std::move(vis));
+        } else {
+            LOG_WARNING("MapLoader", "Ignoring invalid vis data in " + filepath);
+        }
+    }
+
+    // Lightmap; dropped whole if a chart leaves the atlas or the texels are short
+    if ((header.flags & GMap::FLAG_HAS_LIGHTMAP) && header.lightmapChartCount > 0) {
+        auto lightmap = std::make_shared<MapLightmap>();
+        lightmap->size = header.lightmapSize;
+        lightmap->layerCount = header.lightmapLayers;
+
+        const uint64_t size = header.lightmapSize;
+        bool valid = size > 0 && size <= MapLightmap::MAX_SIZE &&
+                     header.lightmapLayers > 0 && header.lightmapLayers <= MapLightmap::MAX_LAYERS &&
+                     header.lightmapChartCount % MapLightmap::FACE_COUNT == 0 &&
+                     view.HasRange(header.lightmapTexelOffset, size * size * header.lightmapLayers,
+                                   sizeof(uint16_t) * MapLightmap::CHANNELS);
+
+        lightmap->charts.reserve(header.lightmapChartCount);
+        for (uint32_t i = 0; i < header.lightmapChartCount && valid; i++) {
+            GMapLightmapChart record = view.Read<GMapLightmapChart>(header.lightmapChartOffset, i);
+            valid = record.layer < header.lightmapLayers && record.face < MapLightmap::FACE_COUNT &&
+                    record.width > 0 && record.height > 0 &&
+                    static_cast<uint64_t>(record.x) + record.width < size &&
+                    static_cast<uint64_t>(record.y) + record.height < size && record.x > 0 && record.y > 0;
+            lightmap->charts.push_back({ record.brushId, record.face, record.layer, record.x, record.y,
+                                         record.width, record.height });
+        }
+
+        if (valid) {
+            lightmap->texels.resize(lightmap->GetTexelCount() * MapLightmap::CHANNELS);
+            std::memcpy(lightmap->texels.data(), file.GetData() + header.lightmapTexelOffset,
+                        lightmap->texels.size() * sizeof(uint16_t));
+            lightmap->IndexCharts();
+            map->SetLightmap(std::move(lightmap));
+            if (resolve) {
+                AttachLightmap(*map);
+            }
+        } else {
+            LOG_WARNING("MapLoader", "Ignoring invalid lightmap in " + filepath);
+        }
+    }
+
+    // Last: the cell source takes over the mapping
+    if (partition) {
+        if (streamed) {
+            partition->source = std::make_shared<GMapCellSource>(std::move(file), header);
+        }
+        map->SetPartition(std::move(partition));
+    }
+
+    if (streamed) {
+        LOG_INFO("MapLoader", "Loaded binary map '" + meta.name + "' for streaming: " +
+                 std::to_string(header.brushCount) + " brushes in " +
+                 std::to_string(map->GetPartition()->GetCellCount()) + " cells, " +
+                 std::to_string(map->GetEntityCount()) + " entities");
+    } else {
+        LOG_INFO("MapLoader", "Loaded binary map '" + meta.name + "' with " +
+                 std::to_string(map->GetBrushCount()) + " brushes, " +
+                 std::to_string(map->GetEntityCount()) + " entities");
+    }
+
+    return map;
+}
+
 void MapLoader::SetError(const std::string& error) {
     m_lastError = error;
     LOG_ERROR("MapLoader", error);
@@ -3,8 +3,11 @@
 #include "Map.h"
 #include "MeshLibrary.h"
 #include "renderer/material/MaterialLibrary.h"
+#include <array>
 #include <string>
+#include <string_view>
 #include <functional>
+#include <unordered_map>
 
 namespace Genesis {
 
@@ -14,6 +17,7 @@ namespace Genesis {
 // Supported formats:
 // - JSON (.json) - Primary format, human-readable
 // - Simple Text (.map) - Compact format for quick editing
+// - Binary (.gmap) - Compiled format, memory-mapped (see MapFormat.h)
 //
 // The loader:
 // 1. Parses the file format
@@ -33,17 +37,30 @@ public:
     // Loading
     // ========================================================================
 
+    // deferResources: see LoadDeferred(). Passed down the call rather than
+    // kept on the loader, so a load on another thread can't change it.
+
     // Load a map from file (auto-detects format)
-    MapPtr Load(const std::string& filepath);
+    MapPtr Load(const std::string& filepath, bool deferResources = false);
 
     // Load from JSON file
-    MapPtr LoadJSON(const std::string& filepath);
+    MapPtr LoadJSON(const std::string& filepath, bool deferResources = false);
 
     // Load from simple text format
-    MapPtr LoadSimple(const std::string& filepath);
+    MapPtr LoadSimple(const std::string& filepath, bool deferResources = false);
 
     // Load from string (JSON)
-    MapPtr LoadFromString(const std::string& jsonString);
+    MapPtr LoadFromString(const std::string& jsonString, bool deferResources = false);
+
+    // Load a compiled .gmap (memory-mapped; transforms, bounds and the
+    // brush BVH come precomputed)
+    MapPtr LoadBinary(const std::string& filepath, bool deferResources = false);
+
+    // Load without touching GL: everything is built except brush meshes and
+    // materials. Safe on a worker thread (one load at a time); finish with
+    // ResolveResources() on the main thread.
+    MapPtr LoadDeferred(const std::string& filepath);
+    MapPtr LoadFromStringDeferred(const std::string& jsonString);
 
     // ========================================================================
     // Saving
@@ -55,17 +72,57 @@ public:
     // Save map to simple text format
     bool SaveSimple(const Map& map, const std::string& filepath);
 
+    // Compile a built map to .gmap (includeBVH stores the brush BVH,
+    // includeVis the map's vis data, computed by VisCompiler if it has none,
+    // includeLightmap its lightmap, baked by LightmapBaker if it has none;
+    // cellSize > 0 partitions it into cells of that size for streaming, as
+    // does a map that already has a partition).
+    // Streamed maps can't be saved: only their resident cells are loaded.
+    bool SaveBinary(const Map& map, const std::string& filepath, bool includeBVH = true, bool includeVis = true,
+                    bool includeLightmap = false, float cellSize = 0.0f);
+
     // ========================================================================
     // Map Building
     // ========================================================================
 
     // Build runtime data for all brushes in a map
-    // This resolves materials, creates meshes, and builds colliders
-    void BuildMap(Map& map);
+    // This resolves materials, creates meshes, and builds colliders.
+    // Shared meshes/materials are created on the calling (GL) thread, then
+    // per-brush work is spread across worker threads. deferResources leaves
+    // meshes and materials to ResolveResources() (any thread then).
+    void BuildMap(Map& map, bool deferResources = false);
 
     // Build a single brush (mesh, material, collider, transform)
+    // Main thread only: may create and upload shared resources
     void BuildBrush(Brush& brush);
 
+    // Attach meshes/materials to a map from LoadDeferred() (main thread)
+    void ResolveResources(Map& map);
+
+    // Give every brush the map's lightmap has charts for its own copy of
+    // the shape mesh with lightmap coordinates (main thread: uploads).
+    // Resolving or rebuilding a brush puts the shared mesh back.
+    void AttachLightmap(Map& map);
+
+    // ========================================================================
+    // Cell Streaming (see MapPartition.h)
+    // ========================================================================
+
+    // Load partitioned .gmaps streamed: metadata, entities, vis, lightmap
+    // and cells up front, brushes only through ReadCell(). Off by default;
+    // MapRenderer turns it on for the maps it plays.
+    void SetCellStreaming(bool enabled) { m_streamCells = enabled; }
+    bool IsCellStreaming() const { return m_streamCells; }
+
+    // Append a streamed cell's brushes with transforms, bounds and
+    // colliders. Reads no loader state, so any number may run on worker
+    // threads (even during a load).
+    bool ReadCell(const MapPartition& partition, uint32_t cell, BrushList& out);
+
+    // Attach meshes/materials (and lightmap meshes) to brushes from
+    // ReadCell() before they join the map (main thread)
+    void ResolveBrushes(const Map& map, BrushList& brushes);
+
     // ========================================================================
     // Configuration
     // ========================================================================
@@ -96,10 +153,37 @@ private:
     MapLoader& operator=(const MapLoader&) = delete;
 
     // Internal parsing
-    bool ParseJSONBrush(const std::string& jsonObj, Brush& brush);
     bool ParseSimpleLine(const std::string& line, Brush& brush);
     BrushFlags ParseFlags(const std::string& flagsStr);
 
+    // Brushes per worker batch in BuildMap/LoadBinary
+    static constexpr size_t BUILD_BATCH_SIZE = 256;
+
+    // Mesh per shape and material per name, looked up once on the main
+    // thread so the per-brush resolve takes no library lock. Material keys
+    // view the brushes' own names: valid while those brushes are
+    struct SharedResources {
+        std::array<MeshPtr, 32> meshes;     // By BrushShape (low 5 bits)
+        std::unordered_map<std::string_view, MaterialPtr> materials;
+    };
+
+    // Create every mesh/material the brushes reference (main thread)
+    SharedResources PrepareSharedResources(const BrushList& brushes);
+    void PrepareBrushResources(const Brush& brush, SharedResources& shared);
+
+    // Gray-ish solid color material guessed from the name
+    MaterialPtr CreateFallbackMaterial(const std::string& name);
+
+    // Attach the shared mesh/material from the prepared table. Reads only,
+    // so this is safe on worker threads
+    static void ResolveBrushResources(Brush& brush, const SharedResources& shared);
+
+    // Collider from shape and size (no shared state)
+    void BuildBrushCollider(Brush& brush);
+
+    // Copy of the shape mesh with the brush's lightmap coordinates
+    bool AttachBrushLightmap(const MapLightmap& lightmap, Brush& brush);
+
     // Error reporting
     void SetError(const std::string& error);
 
@@ -111,6 +195,7 @@ private:
     std::string m_defaultMaterial = "default";
     std::string m_lastError;
     ErrorCallback m_errorCallback;
+    bool m_streamCells = false;
 };
 
 } // namespace Genesis
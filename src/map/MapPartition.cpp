@@ -0,0 +1,96 @@
+#include "MapPartition.h"
+#include "Map.h"
+#include "core/Logger.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <utility>
+
+namespace Genesis {
+
+// ============================================================================
+// MapPartition
+// ============================================================================
+
+float MapPartition::GetDistance(uint32_t cell, const Vec3& point) const {
+    const AABB& bounds = cells[cell].bounds;
+    Vec3 closest = glm::clamp(point, bounds.min, bounds.max);
+    return glm::length(point - closest);
+}
+
+// ============================================================================
+// WorldPartitioner
+// ============================================================================
+
+namespace {
+
+struct CellContents {
+    AABB bounds = AABB(Vec3(std::numeric_limits<float>::max()), Vec3(std::numeric_limits<float>::lowest()));
+    std::vector<uint32_t> brushes;
+    std::vector<uint32_t> entities;
+
+    void Expand(const AABB& box) {
+        bounds.min = glm::min(bounds.min, box.min);
+        bounds.max = glm::max(bounds.max, box.max);
+    }
+};
+
+// floor(v / cellSize), clamped so far-off positions can't overflow
+int32_t GetCellCoord(float v, float cellSize) {
+    float coord = std::floor(v / cellSize);
+    coord = std::clamp(coord, -1.0e9f, 1.0e9f);
+    return static_cast<int32_t>(coord);
+}
+
+} // anonymous namespace
+
+std::shared_ptr<MapPartition> WorldPartitioner::Compute(const std::vector<AABB>& brushBounds,
+                                                        std::span<const MapEntity> entities, float cellSize,
+                                                        std::vector<uint32_t>& brushOrder,
+                                                        std::vector<uint32_t>& entityOrder) {
+    auto partition = std::make_shared<MapPartition>();
+    partition->cellSize = cellSize > 0.0f ? cellSize : DEFAULT_CELL_SIZE;
+    brushOrder.clear();
+    entityOrder.clear();
+
+    // Ordered by (z, x) so cells come out in rows
+    std::map<std::pair<int32_t, int32_t>, CellContents> grid;
+
+    for (uint32_t i = 0; i < static_cast<uint32_t>(brushBounds.size()); i++) {
+        Vec3 center = brushBounds[i].GetCenter();
+        CellContents& cell = grid[{ GetCellCoord(center.z, partition->cellSize),
+                                    GetCellCoord(center.x, partition->cellSize) }];
+        cell.brushes.push_back(i);
+        cell.Expand(brushBounds[i]);
+    }
+    for (uint32_t i = 0; i < static_cast<uint32_t>(entities.size()); i++) {
+        const Vec3& position = entities[i].position;
+        CellContents& cell = grid[{ GetCellCoord(position.z, partition->cellSize),
+                                    GetCellCoord(position.x, partition->cellSize) }];
+        cell.entities.push_back(i);
+        cell.Expand(AABB(position, position));
+    }
+
+    partition->cells.reserve(grid.size());
+    for (const auto& [coord, contents] : grid) {
+        MapCell cell;
+        cell.z = coord.first;
+        cell.x = coord.second;
+        cell.bounds = contents.bounds;
+        cell.firstBrush = static_cast<uint32_t>(brushOrder.size());
+        cell.brushCount = static_cast<uint32_t>(contents.brushes.size());
+        cell.firstEntity = static_cast<uint32_t>(entityOrder.size());
+        cell.entityCount = static_cast<uint32_t>(contents.entities.size());
+        brushOrder.insert(brushOrder.end(), contents.brushes.begin(), contents.brushes.end());
+        entityOrder.insert(entityOrder.end(), contents.entities.begin(), contents.entities.end());
+        partition->cells.push_back(cell);
+    }
+
+    LOG_INFO("WorldPartitioner", std::to_string(partition->cells.size()) + " cells of " +
+             std::to_string(static_cast<int>(partition->cellSize)) + " units for " +
+             std::to_string(brushBounds.size()) + " brushes, " + std::to_string(entities.size()) + " entities");
+    return partition;
+}
+
+} // namespace Genesis
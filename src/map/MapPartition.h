@@ -0,0 +1,82 @@
+#pragma once
+
+#include "Brush.h"
+#include "math/Math.h"
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace Genesis {
+
+struct MapEntity;
+
+// One square of the partition grid (only cells with content are stored)
+struct MapCell {
+    int32_t x = 0;                  // Grid coordinate: floor(position / cellSize) on X and Z
+    int32_t z = 0;
+    AABB bounds;                    // Its brushes' world bounds and entity positions
+    uint32_t firstBrush = 0;        // Range of the brush records in the .gmap
+    uint32_t brushCount = 0;
+    uint32_t firstEntity = 0;       // Range in Map::GetEntities()
+    uint32_t entityCount = 0;
+};
+
+// Where a streamed map's brushes are read from (the mapped .gmap)
+class MapCellSource {
+public:
+    virtual ~MapCellSource() = default;
+
+    // Thread safe. The brushes come with transform and world bounds, but no
+    // mesh, material or collider (see MapLoader::ReadCell)
+    virtual bool ReadCell(const MapCell& cell, BrushList& out) const = 0;
+};
+
+// ============================================================================
+// MapPartition - World partition of a large map into XZ grid cells
+//
+// Every brush belongs to the cell its world bounds' centre falls in, every
+// entity to the cell of its position. A compiled .gmap stores the brush
+// and entity records grouped by cell, so each cell is two ranges.
+//
+// A map loaded with cell streaming keeps source set and only holds the
+// brushes of its resident cells: MapRenderer::UpdateStreaming() reads cells
+// in and drops them again around the viewer. Entities are small, and
+// gameplay refers to them by index, so they all stay loaded; a cell's
+// entity range is what it contributes (its lights) while resident.
+//
+// Built by WorldPartitioner when a map is compiled and stored in the .gmap.
+// ============================================================================
+struct MapPartition {
+    float cellSize = 0.0f;
+    std::vector<MapCell> cells;
+    std::shared_ptr<const MapCellSource> source;    // Streamed maps only
+
+    bool IsEmpty() const { return cells.empty(); }
+    bool IsStreamed() const { return source != nullptr; }
+    uint32_t GetCellCount() const { return static_cast<uint32_t>(cells.size()); }
+
+    // Distance from a point to a cell's bounds (0 inside)
+    float GetDistance(uint32_t cell, const Vec3& point) const;
+};
+
+using MapPartitionPtr = std::shared_ptr<const MapPartition>;
+
+// ============================================================================
+// WorldPartitioner - Computes MapPartition from brush bounds and entities
+//
+// brushOrder and entityOrder receive the brush and entity indices in cell
+// order (cells sorted by z, then x; map order within a cell), which is the
+// order the cell ranges refer to.
+// ============================================================================
+class WorldPartitioner {
+public:
+    static constexpr float DEFAULT_CELL_SIZE = 128.0f;
+
+    static std::shared_ptr<MapPartition> Compute(const std::vector<AABB>& brushBounds,
+                                                 std::span<const MapEntity> entities, float cellSize,
+                                                 std::vector<uint32_t>& brushOrder,
+                                                 std::vector<uint32_t>& entityOrder);
+};
+
+} // namespace Genesis
@@ -1,15 +1,85 @@
 #include "MapRenderer.h"
 #include "MapLoader.h"
 #include "core/Logger.h"
+#include "core/Profiler.h"
+#include "core/FileWatcher.h"
+#include "core/StartupProfile.h"
+#include "physics/TriggerSystem.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
 
 namespace Genesis {
 
+namespace {
+
+// "r g b" property (0..1 per channel)
+Vec3 GetColorProperty(const MapEntity& entity, const std::string& key, const Vec3& defaultValue) {
+    std::string text = entity.GetProperty(key);
+    Vec3 color = defaultValue;
+    if (!text.empty() && std::sscanf(text.c_str(), "%f %f %f", &color.x, &color.y, &color.z) != 3) {
+        LOG_WARNING("MapRenderer", entity.classname + " '" + entity.targetname + "': bad " + key + " \"" +
+                    text + "\"");
+        return defaultValue;
+    }
+    return color;
+}
+
+// Map light entities:
+//   light      - point light: color ("r g b"), intensity, range
+//   light_spot - also inner_angle / outer_angle (half angles in degrees);
+//                shines along -Z turned by the entity's rotation
+bool BuildLocalLight(const MapEntity& entity, LocalLight& light) {
+    if (entity.classname == "light") {
+        light.type = LocalLightType::Point;
+    } else if (entity.classname == "light_spot") {
+        light.type = LocalLightType::Spot;
+    } else {
+        return false;
+    }
+
+    light.position = entity.position;
+    light.color = GetColorProperty(entity, "color", Vec3(1.0f));
+    light.intensity = entity.GetFloat("intensity", 1.0f);
+    light.range = entity.GetFloat("range", 10.0f);
+    if (light.type == LocalLightType::Spot) {
+        // Same rotation order as Brush::GetTransform
+        Mat4 rotation(1.0f);
+        rotation = glm::rotate(rotation, glm::radians(entity.rotation.x), Vec3(1, 0, 0));
+        rotation = glm::rotate(rotation, glm::radians(entity.rotation.y), Vec3(0, 1, 0));
+        rotation = glm::rotate(rotation, glm::radians(entity.rotation.z), Vec3(0, 0, 1));
+        light.direction = Vec3(rotation * Vec4(Vectors::Forward, 0.0f));
+        light.innerAngle = entity.GetFloat("inner_angle", 30.0f);
+        light.outerAngle = entity.GetFloat("outer_angle", 45.0f);
+    }
+    return light.range > 0.0f;
+}
+
+} // anonymous namespace
+
 bool MapRenderer::LoadMap(const std::string& filepath) {
+    // Already loading in the background (PreloadMap()): finish that load
+    // now instead of parsing the file again
+    if (m_pending && m_pending->handle->GetFilepath() == filepath) {
+        MapLoadHandlePtr handle = m_pending->handle;
+        while (m_pending) {
+            if (m_pending->future.valid()) {
+                m_pending->future.wait();
+            }
+            UpdateAsyncLoad(UNBOUNDED_SYNC_BUDGET_MS);
+        }
+        return handle->Succeeded();
+    }
+
+    // The loader is shared with the async worker
+    CancelAsyncLoad();
+
     // Unload current map
     UnloadMap();
 
     // Load new map
     auto& loader = MapLoader::Instance();
+    loader.SetCellStreaming(m_streamConfig.enabled);
     MapPtr map = loader.Load(filepath);
 
     if (!map) {
@@ -18,9 +88,161 @@ bool MapRenderer::LoadMap(const std::string& filepath) {
     }
 
     SetActiveMap(map);
+    m_activeMapPath = filepath;
     return true;
 }
 
+// ============================================================================
+// Async Loading
+// ============================================================================
+
+MapLoadHandlePtr MapRenderer::LoadMapAsync(const std::string& filepath) {
+    return StartAsyncLoad(filepath, false);
+}
+
+MapLoadHandlePtr MapRenderer::PreloadMap(const std::string& filepath) {
+    return StartAsyncLoad(filepath, true);
+}
+
+MapLoadHandlePtr MapRenderer::StartAsyncLoad(const std::string& filepath, bool startup) {
+    if (m_pending) {
+        LOG_WARNING("MapRenderer", "Map load already in progress: " + m_pending->handle->GetFilepath());
+        return nullptr;
+    }
+
+    m_pending = std::make_unique<PendingLoad>();
+    m_pending->handle = std::make_shared<MapLoadHandle>(filepath);
+
+    // Parse + CPU build only; meshes/materials are resolved on this thread
+    MapLoader::Instance().SetCellStreaming(m_streamConfig.enabled);
+    m_pending->future = std::async(std::launch::async, [filepath, startup]() {
+        if (startup) {
+            StartupProfile::Scope scope("Map parse");
+            return MapLoader::Instance().LoadDeferred(filepath);
+        }
+        return MapLoader::Instance().LoadDeferred(filepath);
+    });
+
+    LOG_INFO("MapRenderer", "Loading map in background: " + filepath);
+    return m_pending->handle;
+}
+
+void MapRenderer::UpdateAsyncLoad(double budgetMs) {
+    if (!m_pending) return;
+    GENESIS_PROFILE_SCOPE("Map Streaming");
+    PendingLoad& pending = *m_pending;
+
+    // Progress: worker 0-60%, staging 60-95%, activation the rest
+    if (!pending.map) {
+        if (pending.future.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            return;
+        }
+        pending.map = pending.future.get();
+        if (!pending.map) {
+            FailPendingLoad(MapLoader::Instance().GetLastError());
+            return;
+        }
+        pending.handle->m_progress.store(0.6f, std::memory_order_relaxed);
+        pending.handle->m_state.store(MapLoadState::Syncing, std::memory_order_release);
+        LOG_INFO("MapRenderer", "Parsed " + pending.handle->GetFilepath() + ", syncing " +
+                 std::to_string(pending.map->GetBrushCount()) + " brushes");
+        return;  // The wait may have eaten into this frame; stage from the next
+    }
+
+    using Clock = std::chrono::steady_clock;
+    auto deadline = Clock::now() + std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double, std::milli>(budgetMs));
+
+    if (!pending.resolved) {
+        MapLoader::Instance().ResolveResources(*pending.map);
+        pending.resolved = true;
+        pending.objects.reserve(pending.map->GetBrushCount());
+        pending.objectBrushIds.reserve(pending.map->GetBrushCount());
+        pending.colliders.reserve(pending.map->GetBrushCount());
+    }
+
+    // Stage brushes in slices, checking the clock every few brushes
+    constexpr size_t SLICE = 64;
+    const auto& brushes = pending.map->GetBrushes();
+    while (pending.cursor < brushes.size() && Clock::now() < deadline) {
+        size_t end = std::min(pending.cursor + SLICE, brushes.size());
+        for (; pending.cursor < end; pending.cursor++) {
+            const Brush& brush = brushes[pending.cursor];
+            if (!pending.map->IsLayerVisible(brush.layer)) continue;
+
+            if (brush.HasCollision()) {
+                pending.colliders.push_back(&brush);
+            }
+            StaticObject obj;
+            if (brush.IsVisible() && BuildStaticObject(brush, obj)) {
+                pending.objects.push_back(std::move(obj));
+                pending.objectBrushIds.push_back(brush.id);
+            }
+        }
+    }
+
+    float staged = brushes.empty() ? 1.0f : static_cast<float>(pending.cursor) / brushes.size();
+    pending.handle->m_progress.store(0.6f + 0.35f * staged, std::memory_order_relaxed);
+
+    if (pending.cursor >= brushes.size()) {
+        ActivatePendingLoad();
+    }
+}
+
+void MapRenderer::CancelAsyncLoad() {
+    if (!m_pending) return;
+
+    if (m_pending->future.valid()) {
+        m_pending->future.wait();
+    }
+    FailPendingLoad("Cancelled");
+}
+
+void MapRenderer::ActivatePendingLoad() {
+    std::unique_ptr<PendingLoad> pending = std::move(m_pending);
+
+    UnloadMap();
+    m_activeMap = pending->map;
+    m_activeMapPath = pending->handle->GetFilepath();
+
+    // Bulk hand-off of the staged data (collision grid + render batches)
+    auto& worldCol = PhysicsWorld::Instance();
+    worldCol.Clear();
+    worldCol.SetFloorHeight(-1000.0f);
+    for (const Brush* brush : pending->colliders) {
+        m_brushSync[brush->id].collisionIndex = AddBrushToWorld(*brush);
+    }
+    TriggerSystem::Instance().ClearVolumes();
+    LinkTriggerEntities();
+
+    // Batches are rebuilt once at the end, so each Add is just a slot write
+    auto& worldRender = StaticWorldRenderer::Instance();
+    worldRender.Clear();
+    worldRender.SetVisData(m_activeMap->GetVis());
+    ApplyEnvironment();
+    for (size_t i = 0; i < pending->objects.size(); i++) {
+        m_brushSync[pending->objectBrushIds[i]].renderHandle = worldRender.Add(pending->objects[i]);
+    }
+    worldRender.RebuildBatches();
+    m_activeMap->ClearChanges();
+    BeginStreaming();
+
+    pending->handle->m_map = m_activeMap;
+    pending->handle->m_progress.store(1.0f, std::memory_order_relaxed);
+    pending->handle->m_state.store(MapLoadState::Done, std::memory_order_release);
+
+    LOG_INFO("MapRenderer", "Activated map: " + m_activeMap->GetName());
+}
+
+void MapRenderer::FailPendingLoad(const std::string& error) {
+    std::unique_ptr<PendingLoad> pending = std::move(m_pending);
+
+    pending->handle->m_error = error;
+    pending->handle->m_state.store(MapLoadState::Failed, std::memory_order_release);
+
+    LOG_ERROR("MapRenderer", "Failed to load map " + pending->handle->GetFilepath() + ": " + error);
+}
+
 void MapRenderer::SetActiveMap(MapPtr map) {
     // Unload current
     UnloadMap();
@@ -29,6 +251,7 @@ void MapRenderer::SetActiveMap(MapPtr map) {
 
     if (m_activeMap) {
         SyncToRenderers();
+        BeginStreaming();
         LOG_INFO("MapRenderer", "Activated map: " + m_activeMap->GetName());
     }
 }
@@ -37,16 +260,31 @@ void MapRenderer::UnloadMap() {
     if (!m_activeMap) return;
 
     LOG_INFO("MapRenderer", "Unloading map: " + m_activeMap->GetName());
+    StopStreaming();
 
     // Clear world collision
-    auto& worldCol = WorldCollision::Instance();
+    auto& worldCol = PhysicsWorld::Instance();
     worldCol.Clear();
+    TriggerSystem::Instance().ClearVolumes();
 
     // Clear static world renderer
     auto& worldRender = StaticWorldRenderer::Instance();
     worldRender.Clear();
+    worldRender.SetVisData(nullptr);
 
+    m_brushSync.clear();
     m_activeMap = nullptr;
+    m_activeMapPath.clear();
+}
+
+void MapRenderer::OnFilesChanged(const std::vector<std::string>& paths) {
+    if (!m_activeMap || m_activeMapPath.empty() || m_pending) return;
+
+    std::string source = FileWatcher::NormalizePath(MapLoader::Instance().GetBasePath() + m_activeMapPath);
+    if (std::find(paths.begin(), paths.end(), source) == paths.end()) return;
+
+    LOG_INFO("MapRenderer", "Map file changed, reloading: " + m_activeMapPath);
+    LoadMapAsync(m_activeMapPath);
 }
 
 void MapRenderer::SyncToRenderers() {
@@ -54,22 +292,105 @@ void MapRenderer::SyncToRenderers() {
 
     SyncCollision();
     SyncRendering();
+    m_activeMap->ClearChanges();
+}
+
+void MapRenderer::SyncChanges() {
+    if (!m_activeMap || !m_activeMap->HasChanges()) return;
+
+    size_t removed = 0, synced = 0;
+
+    // Removals first: ids may be reused by brushes added after a Clear()
+    for (uint32_t id : m_activeMap->GetRemovedBrushes()) {
+        auto it = m_brushSync.find(id);
+        if (it == m_brushSync.end()) continue;
+        RemoveBrushSync(it->second);
+        m_brushSync.erase(it);
+        removed++;
+    }
+
+    for (uint32_t id : m_activeMap->GetDirtyBrushes()) {
+        const Brush* brush = m_activeMap->GetBrushById(id);
+        if (!brush) continue;  // Added and removed again before this sync
+
+        SyncBrush(*brush, m_brushSync[id]);
+        synced++;
+    }
+
+    // Adds/removals change the brush set (and indices); edits only move leaves
+    const BVH& bvh = m_activeMap->GetBrushBVH();
+    if (!m_activeMap->GetRemovedBrushes().empty() || bvh.GetItemCount() != m_activeMap->GetBrushCount()) {
+        m_activeMap->BuildBrushBVH();
+    } else if (synced > 0) {
+        m_activeMap->RefitBrushBVH();
+    }
+
+    m_activeMap->ClearChanges();
+    LinkTriggerEntities();   // Re-added trigger brushes have new colliders
+
+    LOG_DEBUG("MapRenderer", "Synced " + std::to_string(synced) + " changed brushes, removed " +
+              std::to_string(removed));
+}
+
+void MapRenderer::SyncBrush(const Brush& brush, BrushSync& sync) {
+    bool layerVisible = m_activeMap->IsLayerVisible(brush.layer);
+
+    // Collision
+    auto& worldCol = PhysicsWorld::Instance();
+    if (brush.HasCollision() && layerVisible) {
+        if (sync.collisionIndex != NO_COLLISION_BOX) {
+            worldCol.UpdateBox(sync.collisionIndex, BuildWorldBox(brush));
+        } else {
+            sync.collisionIndex = AddBrushToWorld(brush);
+        }
+    } else if (sync.collisionIndex != NO_COLLISION_BOX) {
+        worldCol.RemoveBox(sync.collisionIndex);
+        sync.collisionIndex = NO_COLLISION_BOX;
+    }
+
+    // Rendering
+    auto& worldRender = StaticWorldRenderer::Instance();
+    StaticObject obj;
+    if (brush.IsVisible() && layerVisible && BuildStaticObject(brush, obj)) {
+        if (worldRender.IsAlive(sync.renderHandle)) {
+            worldRender.Update(sync.renderHandle, obj);
+        } else {
+            sync.renderHandle = worldRender.Add(obj);
+        }
+    } else if (sync.renderHandle.IsValid()) {
+        worldRender.Remove(sync.renderHandle);
+        sync.renderHandle = StaticObjectHandle();
+    }
+}
+
+void MapRenderer::RemoveBrushSync(const BrushSync& sync) {
+    if (sync.collisionIndex != NO_COLLISION_BOX) {
+        PhysicsWorld::Instance().RemoveBox(sync.collisionIndex);
+    }
+    // Stale handles are ignored
+    StaticWorldRenderer::Instance().Remove(sync.renderHandle);
 }
 
 void MapRenderer::SyncCollision() {
     if (!m_activeMap) return;
 
-    auto& worldCol = WorldCollision::Instance();
+    auto& worldCol = PhysicsWorld::Instance();
     worldCol.Clear();
     worldCol.SetFloorHeight(-1000.0f); // Disable auto floor, use map geometry
 
+    for (auto& entry : m_brushSync) {
+        entry.second.collisionIndex = NO_COLLISION_BOX;
+    }
+
     for (const auto& brush : m_activeMap->GetBrushes()) {
         if (brush.HasCollision() && m_activeMap->IsLayerVisible(brush.layer)) {
-            AddBrushToWorld(brush);
+            m_brushSync[brush.id].collisionIndex = AddBrushToWorld(brush);
         }
     }
+    TriggerSystem::Instance().ClearVolumes();
+    LinkTriggerEntities();
 
-    LOG_DEBUG("MapRenderer", "Synced " + std::to_string(worldCol.GetBoxes().size()) + " collision boxes");
+    LOG_DEBUG("MapRenderer", "Synced " + std::to_string(worldCol.GetActiveBoxCount()) + " collision boxes");
 }
 
 void MapRenderer::SyncRendering() {
@@ -77,56 +398,314 @@ void MapRenderer::SyncRendering() {
 
     auto& worldRender = StaticWorldRenderer::Instance();
     worldRender.Clear();
+    worldRender.SetVisData(m_activeMap->GetVis());
+    ApplyEnvironment();
+
+    for (auto& entry : m_brushSync) {
+        entry.second.renderHandle = StaticObjectHandle();
+    }
 
     for (const auto& brush : m_activeMap->GetBrushes()) {
         if (brush.IsVisible() && m_activeMap->IsLayerVisible(brush.layer)) {
-            AddBrushToRenderer(brush);
+            m_brushSync[brush.id].renderHandle = AddBrushToRenderer(brush);
         }
     }
 
     worldRender.RebuildBatches();
 
+    // Bake the static brushes now rather than on the first frame
+    if (worldRender.IsStaticMerging()) {
+        worldRender.MergeStaticGeometry();
+    }
+
     LOG_DEBUG("MapRenderer", "Synced " + std::to_string(worldRender.GetObjectCount()) + " render objects");
 }
 
-void MapRenderer::AddBrushToWorld(const Brush& brush) {
-    auto& worldCol = WorldCollision::Instance();
+void MapRenderer::ApplyEnvironment() {
+    // The map's sun lights the world (and aims the shadow cascades)
+    const MapMetadata& meta = m_activeMap->GetMetadata();
+    auto& worldRender = StaticWorldRenderer::Instance();
+    worldRender.SetDirectionalLight(meta.sunDirection, meta.sunColor, meta.sunIntensity);
+    worldRender.SetAmbientLight(meta.ambientColor);
+    worldRender.SetLightmap(m_activeMap->GetLightmap());
 
-    // Add to world collision based on brush type
-    Vec3 halfSize = brush.size * 0.5f;
+    size_t lights = ApplyLocalLights();
+    if (lights > 0) {
+        LOG_INFO("MapRenderer", std::to_string(lights) + " local lights");
+    }
+}
 
-    if (brush.IsStair()) {
-        // Add as stair (auto-climbable)
-        worldCol.AddStair(
-            brush.position.x, brush.position.y, brush.position.z,
-            brush.size.x, brush.size.y, brush.size.z
-        );
+size_t MapRenderer::ApplyLocalLights() {
+    const auto& entities = m_activeMap->GetEntities();
+    std::vector<LocalLight> lights;
+    auto addLights = [&](size_t first, size_t count) {
+        for (size_t i = first; i < first + count; i++) {
+            LocalLight light;
+            if (BuildLocalLight(entities[i], light)) {
+                lights.push_back(light);
+            }
+        }
+    };
+
+    if (m_activeMap->IsStreamed()) {
+        const MapPartition& partition = *m_activeMap->GetPartition();
+        for (uint32_t i = 0; i < partition.GetCellCount(); i++) {
+            if (IsCellResident(i)) {
+                addLights(partition.cells[i].firstEntity, partition.cells[i].entityCount);
+            }
+        }
     } else {
-        // Add as regular box
-        worldCol.AddBox(
-            brush.position.x, brush.position.y, brush.position.z,
-            brush.size.x, brush.size.y, brush.size.z
-        );
+        addLights(0, entities.size());
     }
+
+    size_t count = lights.size();
+    StaticWorldRenderer::Instance().GetLights().SetLights(std::move(lights));
+    return count;
 }
 
-void MapRenderer::AddBrushToRenderer(const Brush& brush) {
-    auto& worldRender = StaticWorldRenderer::Instance();
+// ============================================================================
+// Cell Streaming
+// ============================================================================
+
+void MapRenderer::UpdateStreaming(const Vec3& viewer, double budgetMs) {
+    if (m_cells.empty() || !m_activeMap) return;
+    GENESIS_PROFILE_SCOPE("Cell Streaming");
+    StreamCells(viewer, false, budgetMs);
+}
+
+void MapRenderer::BeginStreaming() {
+    StopStreaming();
+    if (!m_activeMap || !m_activeMap->IsStreamed()) return;
+
+    const MapPartition& partition = *m_activeMap->GetPartition();
+    m_cells.resize(partition.GetCellCount());
+    m_streamStats = MapStreamingStats();
+    m_streamStats.cells = partition.GetCellCount();
 
+    // The spawn area is read in before the first frame, or the player would
+    // fall through it
+    StreamCells(m_activeMap->GetSpawnPosition(), true, 0.0);
+
+    LOG_INFO("MapRenderer", "Streaming " + std::to_string(partition.GetCellCount()) + " cells, " +
+             std::to_string(m_streamStats.residentCells) + " resident at spawn");
+}
+
+void MapRenderer::StopStreaming() {
+    for (CellStream& cell : m_cells) {
+        if (cell.load) {
+            JobSystem::Instance().Wait(cell.load->done);
+        }
+    }
+    m_cells.clear();
+    m_streamStats.residentCells = 0;
+    m_streamStats.loadingCells = 0;
+}
+
+void MapRenderer::StreamCells(const Vec3& viewer, bool wait, double budgetMs) {
+    const MapPartition& partition = *m_activeMap->GetPartition();
+    const float loadRadius = std::max(m_streamConfig.loadRadius, 0.0f);
+    const float unloadRadius = loadRadius + std::max(m_streamConfig.unloadMargin, 0.0f);
+    bool changed = false;
+
+    // Drop resident cells the viewer has left behind
+    std::unordered_set<uint32_t> removed;
+    for (uint32_t i = 0; i < m_cells.size(); i++) {
+        CellStream& cell = m_cells[i];
+        if (cell.state != CellState::Resident || partition.GetDistance(i, viewer) <= unloadRadius) continue;
+
+        removed.insert(cell.brushIds.begin(), cell.brushIds.end());
+        cell.brushIds.clear();
+        cell.state = CellState::Unloaded;
+        m_streamStats.cellsUnloaded++;
+        changed = true;
+    }
+    m_activeMap->RemoveBrushesById(removed);
+
+    // Request the cells coming into range, nearest first
+    std::vector<std::pair<float, uint32_t>> wanted;
+    uint32_t loading = 0;
+    for (uint32_t i = 0; i < m_cells.size(); i++) {
+        if (m_cells[i].state == CellState::Loading) {
+            loading++;
+        } else if (m_cells[i].state == CellState::Unloaded) {
+            float distance = partition.GetDistance(i, viewer);
+            if (distance <= loadRadius) {
+                wanted.emplace_back(distance, i);
+            }
+        }
+    }
+    std::sort(wanted.begin(), wanted.end());
+    const uint32_t maxLoads = static_cast<uint32_t>(std::max(m_streamConfig.maxLoads, 1));
+    for (const auto& [distance, index] : wanted) {
+        if (!wait && loading >= maxLoads) break;
+        StartCellLoad(index);
+        loading++;
+    }
+
+    // Join finished reads, unless the viewer moved out of range meanwhile
+    using Clock = std::chrono::steady_clock;
+    auto deadline = Clock::now() + std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double, std::milli>(budgetMs));
+    bool joined = false;
+    for (uint32_t i = 0; i < m_cells.size(); i++) {
+        CellStream& cell = m_cells[i];
+        if (cell.state != CellState::Loading) continue;
+        if (!wait) {
+            if (!cell.load->done.IsDone()) continue;
+            if (joined && Clock::now() >= deadline) break;   // At least one per frame
+        }
+        JobSystem::Instance().Wait(cell.load->done);
+
+        if (partition.GetDistance(i, viewer) > unloadRadius) {
+            cell.load.reset();
+            cell.state = CellState::Unloaded;
+            continue;
+        }
+        JoinCell(i);
+        joined = true;
+    }
+
+    m_streamStats.residentCells = 0;
+    m_streamStats.loadingCells = 0;
+    for (const CellStream& cell : m_cells) {
+        m_streamStats.residentCells += cell.state == CellState::Resident ? 1 : 0;
+        m_streamStats.loadingCells += cell.state == CellState::Loading ? 1 : 0;
+    }
+
+    // Adds and removals reach collision/rendering like any brush edit
+    if (changed || joined) {
+        SyncChanges();
+        ApplyLocalLights();
+    }
+}
+
+void MapRenderer::StartCellLoad(uint32_t index) {
+    CellStream& cell = m_cells[index];
+    cell.load = std::make_unique<CellLoad>();
+    cell.state = CellState::Loading;
+
+    // The partition (and the mapped file behind it) outlives the read even
+    // if the map is dropped meanwhile
+    CellLoad* raw = cell.load.get();
+    MapPartitionPtr partition = m_activeMap->GetPartition();
+    auto read = [raw, partition, index] {
+        raw->failed = !MapLoader::Instance().ReadCell(*partition, index, raw->brushes);
+    };
+
+    auto& jobs = JobSystem::Instance();
+    if (jobs.GetWorkerCount() > 0) {
+        jobs.Submit(read, &raw->done);
+    } else {
+        read();   // No workers would only run it inside a Wait()
+    }
+}
+
+void MapRenderer::JoinCell(uint32_t index) {
+    CellStream& cell = m_cells[index];
+    std::unique_ptr<CellLoad> load = std::move(cell.load);
+    if (load->failed) {
+        LOG_WARNING("MapRenderer", "Failed to read map cell " + std::to_string(index));
+        cell.state = CellState::Failed;
+        return;
+    }
+
+    MapLoader::Instance().ResolveBrushes(*m_activeMap, load->brushes);
+    cell.brushIds.clear();
+    cell.brushIds.reserve(load->brushes.size());
+    for (Brush& brush : load->brushes) {
+        cell.brushIds.push_back(brush.id);
+        m_activeMap->AddLayer(brush.layer);
+        m_activeMap->AddBrushWithId(std::move(brush));
+    }
+    cell.state = CellState::Resident;
+    m_streamStats.cellsLoaded++;
+}
+
+WorldBox MapRenderer::BuildWorldBox(const Brush& brush) {
+    if (brush.IsTrigger()) {
+        // Not solid, and only seen by trigger-layer queries (TriggerSystem)
+        return WorldBox(brush.position, brush.size * 0.5f, BoxTag::Trigger);
+    }
+
+    // Stairs are auto-climbable
+    return WorldBox(brush.position, brush.size * 0.5f,
+                    brush.IsStair() ? BoxTag::Stair : BoxTag::Default);
+}
+
+void MapRenderer::LinkTriggerEntities() {
+    if (!m_activeMap) return;
+
+    const auto& entities = m_activeMap->GetEntities();
+    auto& physics = PhysicsWorld::Instance();
+    auto& triggers = TriggerSystem::Instance();
+
+    for (uint32_t i = 0; i < static_cast<uint32_t>(entities.size()); i++) {
+        const MapEntity& entity = entities[i];
+        if (entity.classname.rfind("trigger_", 0) != 0) continue;
+
+        // The volume is the trigger brush named by "brush" (default: targetname)
+        std::string brushName = entity.GetProperty("brush", entity.targetname);
+        const Brush* brush = nullptr;
+        for (const auto& candidate : m_activeMap->GetBrushes()) {
+            if (candidate.IsTrigger() && candidate.name == brushName) {
+                brush = &candidate;
+                break;
+            }
+        }
+        if (!brush) {
+            // A streamed map's trigger brush may just not be resident yet
+            if (!m_activeMap->IsStreamed()) {
+                LOG_WARNING("MapRenderer", entity.classname + " '" + entity.targetname + "' has no trigger brush");
+            }
+            continue;
+        }
+
+        auto it = m_brushSync.find(brush->id);
+        if (it == m_brushSync.end() || it->second.collisionIndex == NO_COLLISION_BOX) continue;
+
+        // Already linked volumes keep their state (a fired trigger_once)
+        ColliderHandle collider = physics.GetHandle(it->second.collisionIndex);
+        if (triggers.GetVolume(collider).entity == i) continue;
+
+        TriggerVolume volume;
+        volume.classname = entity.classname;
+        volume.name = entity.targetname;
+        volume.entity = i;
+        volume.once = entity.classname == "trigger_once";
+        triggers.SetVolume(collider, volume);
+    }
+}
+
+uint32_t MapRenderer::AddBrushToWorld(const Brush& brush) {
+    auto& physics = PhysicsWorld::Instance();
+    uint32_t index = physics.AddWorldBox(BuildWorldBox(brush));
+    physics.SetUserData(index, brush.id);
+    return index;
+}
+
+StaticObjectHandle MapRenderer::AddBrushToRenderer(const Brush& brush) {
+    StaticObject obj;
+    if (BuildStaticObject(brush, obj)) {
+        return StaticWorldRenderer::Instance().Add(obj);
+    }
+    return StaticObjectHandle();
+}
+
+bool MapRenderer::BuildStaticObject(const Brush& brush, StaticObject& obj) const {
     if (!brush.mesh || !brush.material) {
         LOG_WARNING("MapRenderer", "Brush missing mesh or material: " + brush.name);
-        return;
+        return false;
     }
 
     // Create static object from brush
-    StaticObject obj;
     obj.mesh = brush.mesh;
     obj.material = brush.material;
     obj.transform = brush.transform;
-    obj.collider = brush.collider;
+    obj.collider = nullptr;  // Already in the PhysicsWorld (AddBrushToWorld)
     obj.name = brush.name;
     obj.visible = true;
     obj.castShadow = HasFlag(brush.flags, BrushFlags::CastShadow);
+    obj.receiveShadow = HasFlag(brush.flags, BrushFlags::ReceiveShadow);
 
     // Determine object type based on material name
     std::string matName = brush.materialName;
@@ -142,7 +721,7 @@ void MapRenderer::AddBrushToRenderer(const Brush& brush) {
         obj.type = StaticObjectType::Generic;
     }
 
-    worldRender.Add(obj);
+    return true;
 }
 
 Vec3 MapRenderer::GetSpawnPosition() const {
@@ -165,8 +744,10 @@ size_t MapRenderer::GetBrushCount() const {
 
 void MapRenderer::SetLayerVisible(const std::string& layer, bool visible) {
     if (m_activeMap) {
+        if (m_activeMap->IsLayerVisible(layer) == visible) return;
         m_activeMap->SetLayerVisible(layer, visible);
-        SyncToRenderers(); // Re-sync after visibility change
+        m_activeMap->MarkLayerDirty(layer);
+        SyncChanges(); // Only the layer's brushes change
     }
 }
 
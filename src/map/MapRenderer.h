@@ -2,20 +2,114 @@
 
 #include "Map.h"
 #include "renderer/world/StaticWorldRenderer.h"
-#include "world/WorldCollision.h"
+#include "physics/PhysicsWorld.h"
+#include "core/JobSystem.h"
 #include <memory>
+#include <atomic>
+#include <future>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 namespace Genesis {
 
 // ============================================================================
-// MapRenderer - Bridges Map to StaticWorldRenderer and WorldCollision
+// Map Load Handle - Progress of an asynchronous map load
+// ============================================================================
+enum class MapLoadState {
+    Loading,    // Parsing and building on a worker thread
+    Syncing,    // Handing brushes to collision/rendering on the main thread
+    Done,
+    Failed
+};
+
+class MapLoadHandle {
+public:
+    explicit MapLoadHandle(std::string filepath) : m_filepath(std::move(filepath)) {}
+
+    const std::string& GetFilepath() const { return m_filepath; }
+    MapLoadState GetState() const { return m_state.load(std::memory_order_acquire); }
+
+    // 0..1 across all stages (safe to poll from any thread)
+    float GetProgress() const { return m_progress.load(std::memory_order_relaxed); }
+
+    bool IsDone() const { return GetState() == MapLoadState::Done || GetState() == MapLoadState::Failed; }
+    bool Succeeded() const { return GetState() == MapLoadState::Done; }
+
+    // Set once the load has failed (main thread)
+    const std::string& GetError() const { return m_error; }
+
+    // Loaded map, once Done
+    MapPtr GetMap() const { return m_map; }
+
+    const char* GetStateName() const {
+        switch (GetState()) {
+            case MapLoadState::Loading: return "loading";
+            case MapLoadState::Syncing: return "syncing";
+            case MapLoadState::Done:    return "done";
+            case MapLoadState::Failed:  return "failed";
+            default:                    return "unknown";
+        }
+    }
+
+private:
+    friend class MapRenderer;
+
+    std::string m_filepath;
+    std::atomic<MapLoadState> m_state{MapLoadState::Loading};
+    std::atomic<float> m_progress{0.0f};
+    std::string m_error;
+    MapPtr m_map;
+};
+
+using MapLoadHandlePtr = std::shared_ptr<MapLoadHandle>;
+
+// ============================================================================
+// Cell Streaming - Settings and counters for streamed maps
+// ============================================================================
+struct MapStreamingConfig {
+    bool enabled = true;            // Load partitioned maps by cell (map_streaming, next load)
+    float loadRadius = 192.0f;      // Cells nearer the viewer are read in (map_stream_radius)
+    float unloadMargin = 64.0f;     // ...and dropped beyond radius + margin (map_stream_hysteresis)
+    int maxLoads = 4;               // Cell reads in flight (map_stream_loads)
+};
+
+struct MapStreamingStats {
+    uint32_t cells = 0;
+    uint32_t residentCells = 0;
+    uint32_t loadingCells = 0;
+    uint64_t cellsLoaded = 0;       // Since the map was activated
+    uint64_t cellsUnloaded = 0;
+};
+
+// ============================================================================
+// MapRenderer - Bridges Map to StaticWorldRenderer and PhysicsWorld
 //
 // Takes a loaded Map and:
 // 1. Adds all visible brushes to StaticWorldRenderer for rendering
-// 2. Adds all collision brushes to WorldCollision for physics
+// 2. Adds all collision brushes to PhysicsWorld for physics (only there:
+//    their render objects carry no collider, so nothing is stored twice).
+//    Trigger brushes go to the trigger layer and are linked to their
+//    trigger_* entities for the TriggerSystem.
 // 3. Handles map unloading/switching
 //
 // This keeps the map system decoupled from the rendering system.
+//
+// Each synced brush remembers its render object and collision box (keyed by
+// Brush::id), so SyncChanges() only touches the brushes the map reports as
+// added, edited or removed instead of rebuilding everything.
+//
+// LoadMapAsync() parses and builds on a worker thread while the current map
+// stays playable; UpdateAsyncLoad() (called by Engine::Run every frame) then
+// stages the result within a per-frame time budget and swaps it in.
+//
+// Partitioned maps are loaded streamed (see MapPartition.h): activation
+// reads in the cells around the spawn point, then UpdateStreaming() keeps
+// the cells within loadRadius of the viewer resident. Cells are read on
+// job workers and join or leave the map as brush adds/removals, which
+// SyncChanges() pushes, so only resident cells are rendered and collided
+// with. A cell is dropped only once the viewer is unloadMargin further
+// out, so walking along a cell edge doesn't thrash it.
 // ============================================================================
 class MapRenderer {
 public:
@@ -31,6 +125,29 @@ public:
     // Load and activate a map (clears previous map)
     bool LoadMap(const std::string& filepath);
 
+    // LoadMapAsync() started during startup, before there is a GL context
+    // (timed in the startup profile): the parse overlaps window creation,
+    // resource resolving and staging spread over the first frames. A
+    // LoadMap() of the same file meanwhile finishes it at once.
+    MapLoadHandlePtr PreloadMap(const std::string& filepath);
+
+    // Load a map in the background; the previous map stays active until the
+    // new one is ready. Returns nullptr if another load is still running.
+    MapLoadHandlePtr LoadMapAsync(const std::string& filepath);
+
+    // Advance the pending async load (main thread, once per frame)
+    void UpdateAsyncLoad(double budgetMs = ASYNC_SYNC_BUDGET_MS);
+
+    // Block until the pending async load has finished and drop it
+    void CancelAsyncLoad();
+
+    bool IsLoading() const { return m_pending != nullptr; }
+    MapLoadHandlePtr GetPendingLoad() const { return m_pending ? m_pending->handle : nullptr; }
+
+    // Main-thread time per frame spent staging an async load
+    static constexpr double ASYNC_SYNC_BUDGET_MS = 2.0;
+    static constexpr double UNBOUNDED_SYNC_BUDGET_MS = 1.0e9;   // LoadMap() finishing one
+
     // Set the active map (already loaded)
     void SetActiveMap(MapPtr map);
 
@@ -43,19 +160,51 @@ public:
     // Check if a map is loaded
     bool HasMap() const { return m_activeMap != nullptr; }
 
+    // File the active map was loaded from (relative to the MapLoader base
+    // path); empty for maps set with SetActiveMap()
+    const std::string& GetActiveMapPath() const { return m_activeMapPath; }
+
+    // Hot reload: reload the active map in the background if its file is
+    // among these (paths as reported by FileWatcher)
+    void OnFilesChanged(const std::vector<std::string>& paths);
+
     // ========================================================================
     // Syncing
     // ========================================================================
 
-    // Sync map to renderers (call after modifying brushes)
+    // Full re-sync of the map to renderers
     void SyncToRenderers();
 
-    // Sync only collision (for physics-only updates)
+    // Full re-sync of collision only (for physics-only updates)
     void SyncCollision();
 
-    // Sync only rendering (for visual-only updates)
+    // Full re-sync of rendering only (for visual-only updates)
     void SyncRendering();
 
+    // Apply only the brushes marked dirty/removed on the active map
+    // (call after editing brushes; see Map::MarkBrushDirty)
+    void SyncChanges();
+
+    // ========================================================================
+    // Cell Streaming
+    // ========================================================================
+
+    // Read in / drop cells of a streamed map around the viewer (main thread,
+    // once per frame; joining finished cells is bounded by budgetMs)
+    void UpdateStreaming(const Vec3& viewer, double budgetMs = ASYNC_SYNC_BUDGET_MS);
+
+    // Wait for the cell reads in flight and stop streaming (resident cells
+    // stay); the next activated map starts again
+    void StopStreaming();
+
+    bool IsStreaming() const { return !m_cells.empty(); }
+    bool IsCellResident(uint32_t cell) const {
+        return cell < m_cells.size() && m_cells[cell].state == CellState::Resident;
+    }
+
+    MapStreamingConfig& GetStreamingConfig() { return m_streamConfig; }
+    const MapStreamingStats& GetStreamingStats() const { return m_streamStats; }
+
     // ========================================================================
     // Queries
     // ========================================================================
@@ -80,12 +229,88 @@ private:
     MapRenderer(const MapRenderer&) = delete;
     MapRenderer& operator=(const MapRenderer&) = delete;
 
+    static constexpr uint32_t NO_COLLISION_BOX = 0xFFFFFFFFu;
+
+    // Where a brush currently lives in the renderers
+    struct BrushSync {
+        StaticObjectHandle renderHandle;  // Invalid when not rendered
+        uint32_t collisionIndex = NO_COLLISION_BOX;
+    };
+
     // Internal sync helpers
-    void AddBrushToWorld(const Brush& brush);
-    void AddBrushToRenderer(const Brush& brush);
+    uint32_t AddBrushToWorld(const Brush& brush);
+    StaticObjectHandle AddBrushToRenderer(const Brush& brush);
+    bool BuildStaticObject(const Brush& brush, StaticObject& obj) const;
+    static WorldBox BuildWorldBox(const Brush& brush);
+
+    // Sun, ambient and local lights from the active map
+    void ApplyEnvironment();
+
+    // Lights of the active map's entities (resident cells' only when
+    // streamed); returns their count
+    size_t ApplyLocalLights();
+
+    // Give trigger_* entities' brushes their TriggerSystem volume info
+    void LinkTriggerEntities();
+
+    // Bring one brush's render object/collision box in line with the map
+    void SyncBrush(const Brush& brush, BrushSync& sync);
+    void RemoveBrushSync(const BrushSync& sync);
+
+    // Async load: swap the staged map into collision/rendering
+    void ActivatePendingLoad();
+    void FailPendingLoad(const std::string& error);
+
+    enum class CellState : uint8_t {
+        Unloaded,
+        Loading,
+        Resident,
+        Failed      // Unreadable; not retried
+    };
+
+    // A cell's brushes, read on a job worker
+    struct CellLoad {
+        JobCounter done;
+        BrushList brushes;
+        bool failed = false;
+    };
+
+    struct CellStream {
+        CellState state = CellState::Unloaded;
+        std::unique_ptr<CellLoad> load;      // While Loading
+        std::vector<uint32_t> brushIds;      // While Resident: what it added to the map
+    };
+
+    // Streaming of the active map, if streamed (blocks for the spawn area)
+    void BeginStreaming();
+
+    // One streaming step; wait reads in every cell in range before returning
+    void StreamCells(const Vec3& viewer, bool wait, double budgetMs);
+    void StartCellLoad(uint32_t cell);
+    void JoinCell(uint32_t cell);
+
+    MapLoadHandlePtr StartAsyncLoad(const std::string& filepath, bool startup);
+
+    struct PendingLoad {
+        MapLoadHandlePtr handle;
+        std::future<MapPtr> future;
+        MapPtr map;
+        bool resolved = false;
+        size_t cursor = 0;                       // Next brush to stage
+        std::vector<StaticObject> objects;       // Staged render objects
+        std::vector<uint32_t> objectBrushIds;    // Brush id of each staged object
+        std::vector<const Brush*> colliders;     // Staged collision brushes
+    };
 
 private:
     MapPtr m_activeMap;
+    std::string m_activeMapPath;
+    std::unique_ptr<PendingLoad> m_pending;
+    std::unordered_map<uint32_t, BrushSync> m_brushSync;  // By Brush::id
+
+    std::vector<CellStream> m_cells;    // By MapPartition cell, while streaming
+    MapStreamingConfig m_streamConfig;
+    MapStreamingStats m_streamStats;
 };
 
 } // namespace Genesis
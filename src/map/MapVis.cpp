@@ -0,0 +1,245 @@
+#include "MapVis.h"
+#include "Map.h"
+#include "core/Logger.h"
+#include "core/ParallelFor.h"
+#include "core/Profiler.h"
+#include "math/BVH.h"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <limits>
+#include <map>
+
+namespace Genesis {
+
+// ============================================================================
+// MapVis
+// ============================================================================
+
+uint32_t MapVis::FindArea(const Vec3& point) const {
+    for (uint32_t i = 0; i < areas.size(); i++) {
+        if (areas[i].Contains(point)) return i;
+    }
+    return NO_AREA;
+}
+
+uint32_t MapVis::FindAreaForBounds(const AABB& bounds) const {
+    for (uint32_t i = 0; i < areas.size(); i++) {
+        if (areas[i].Contains(bounds.min) && areas[i].Contains(bounds.max)) return i;
+    }
+    return NO_AREA;
+}
+
+uint32_t MapVis::CountVisible(uint32_t from) const {
+    if (from >= areas.size()) return GetAreaCount();
+    uint32_t count = 0;
+    const uint32_t* row = &pvs[from * GetRowWords()];
+    for (uint32_t w = 0; w < GetRowWords(); w++) {
+        count += static_cast<uint32_t>(std::popcount(row[w]));
+    }
+    return count;
+}
+
+// ============================================================================
+// VisCompiler
+// ============================================================================
+
+namespace {
+
+struct VisOccluder {
+    Mat4 inverse;   // World -> unit cube [-0.5, 0.5]
+};
+
+AABB TransformedUnitCube(const Mat4& transform) {
+    Vec3 bmin(std::numeric_limits<float>::max());
+    Vec3 bmax(std::numeric_limits<float>::lowest());
+    for (int i = 0; i < 8; i++) {
+        Vec3 corner((i & 1) ? 0.5f : -0.5f, (i & 2) ? 0.5f : -0.5f, (i & 4) ? 0.5f : -0.5f);
+        Vec3 p = Vec3(transform * Vec4(corner, 1.0f));
+        bmin = glm::min(bmin, p);
+        bmax = glm::max(bmax, p);
+    }
+    return AABB(bmin, bmax);
+}
+
+// Segment a->b against the occluder's unit cube (slab test in local space)
+bool SegmentHitsOccluder(const VisOccluder& occluder, const Vec3& a, const Vec3& b) {
+    Vec3 origin = Vec3(occluder.inverse * Vec4(a, 1.0f));
+    Vec3 delta = Vec3(occluder.inverse * Vec4(b - a, 0.0f));
+
+    float tMin = 0.0f, tMax = 1.0f;
+    for (int axis = 0; axis < 3; axis++) {
+        if (std::fabs(delta[axis]) < 1e-8f) {
+            if (origin[axis] < -0.5f || origin[axis] > 0.5f) return false;
+            continue;
+        }
+        float inv = 1.0f / delta[axis];
+        float t0 = (-0.5f - origin[axis]) * inv;
+        float t1 = (0.5f - origin[axis]) * inv;
+        if (t0 > t1) std::swap(t0, t1);
+        tMin = std::max(tMin, t0);
+        tMax = std::min(tMax, t1);
+        if (tMin > tMax) return false;
+    }
+    return true;
+}
+
+bool PointInOccluder(const VisOccluder& occluder, const Vec3& point) {
+    Vec3 local = Vec3(occluder.inverse * Vec4(point, 1.0f));
+    return std::fabs(local.x) < 0.5f && std::fabs(local.y) < 0.5f && std::fabs(local.z) < 0.5f;
+}
+
+// Halton sequence, so samples spread evenly for any count
+float Halton(uint32_t index, uint32_t base) {
+    float result = 0.0f;
+    float fraction = 1.0f / static_cast<float>(base);
+    while (index > 0) {
+        result += fraction * static_cast<float>(index % base);
+        index /= base;
+        fraction /= static_cast<float>(base);
+    }
+    return result;
+}
+
+} // namespace
+
+MapVisPtr VisCompiler::Compute(const Map& map, const VisCompileSettings& settings) {
+    GENESIS_PROFILE_SCOPE("VisCompiler::Compute");
+
+    auto vis = std::make_shared<MapVis>();
+    const auto& brushes = map.GetBrushes();
+    if (brushes.empty()) return vis;
+
+    // Brush bounds from the transform, so unbuilt maps work too
+    std::vector<VisOccluder> occluders;
+    std::vector<AABB> occluderBounds;
+    std::map<uint32_t, AABB> groups;   // Ordered: area order is stable
+    AABB mapBounds;
+    for (size_t i = 0; i < brushes.size(); i++) {
+        Brush built = brushes[i];
+        built.BuildTransform();
+        AABB bounds = TransformedUnitCube(built.transform);
+
+        if (i == 0) {
+            mapBounds = bounds;
+        } else {
+            mapBounds = AABB(glm::min(mapBounds.min, bounds.min), glm::max(mapBounds.max, bounds.max));
+        }
+
+        if (built.visGroup != 0) {
+            auto [it, inserted] = groups.emplace(built.visGroup, bounds);
+            if (!inserted) {
+                it->second = AABB(glm::min(it->second.min, bounds.min), glm::max(it->second.max, bounds.max));
+            }
+        }
+
+        if (built.IsVisible() && !built.IsDetail() && !built.IsTrigger() && built.shape == BrushShape::Cube) {
+            occluders.push_back({glm::inverse(built.transform)});
+            occluderBounds.push_back(bounds);
+        }
+    }
+
+    // Areas
+    if (!groups.empty()) {
+        for (const auto& [group, bounds] : groups) {
+            vis->areas.push_back(bounds);
+        }
+    } else {
+        Vec3 size = mapBounds.GetSize();
+        float cell = std::max(settings.cellSize, 0.01f);
+        auto cellsFor = [&size](float c) {
+            return glm::max(Vec3(std::ceil(size.x / c), std::ceil(size.y / c), std::ceil(size.z / c)), Vec3(1.0f));
+        };
+        Vec3 cells = cellsFor(cell);
+        while (cells.x * cells.y * cells.z > static_cast<float>(settings.maxGridAreas)) {
+            cell *= 1.25f;
+            cells = cellsFor(cell);
+        }
+
+        for (int z = 0; z < static_cast<int>(cells.z); z++) {
+            for (int y = 0; y < static_cast<int>(cells.y); y++) {
+                for (int x = 0; x < static_cast<int>(cells.x); x++) {
+                    Vec3 bmin = mapBounds.min + Vec3(static_cast<float>(x), static_cast<float>(y), static_cast<float>(z)) * cell;
+                    vis->areas.emplace_back(bmin, glm::min(bmin + Vec3(cell), mapBounds.max));
+                }
+            }
+        }
+    }
+
+    const uint32_t areaCount = vis->GetAreaCount();
+    const uint32_t rowWords = vis->GetRowWords();
+    vis->pvs.assign(static_cast<size_t>(areaCount) * rowWords, 0);
+
+    BVH bvh;
+    bvh.Build(occluderBounds);
+
+    // Sample points per area (the center first), minus those inside solids
+    std::vector<std::vector<Vec3>> samples(areaCount);
+    for (uint32_t a = 0; a < areaCount; a++) {
+        const AABB& area = vis->areas[a];
+        Vec3 inset = area.GetSize() * 0.05f;
+        for (uint32_t s = 0; s < std::max(settings.samplesPerArea, 1u); s++) {
+            Vec3 t = s == 0 ? Vec3(0.5f) : Vec3(Halton(s, 2), Halton(s, 3), Halton(s, 5));
+            Vec3 point = area.min + inset + (area.GetSize() - inset * 2.0f) * t;
+
+            AABB pointBox(point, point);
+            bool solid = false;
+            bvh.QueryAABB(pointBox, [&](uint32_t index) {
+                solid = solid || PointInOccluder(occluders[index], point);
+            });
+            if (!solid) samples[a].push_back(point);
+        }
+    }
+
+    auto segmentClear = [&](const Vec3& from, const Vec3& to) {
+        Vec3 delta = to - from;
+        float length = glm::length(delta);
+        if (length < 1e-4f) return true;
+
+        bool blocked = false;
+        bvh.Raycast(from, delta / length, length, [&](uint32_t index, float& maxDist) {
+            if (!blocked && SegmentHitsOccluder(occluders[index], from, to)) {
+                blocked = true;
+                maxDist = 0.0f;   // Prune the rest of the traversal
+            }
+        });
+        return !blocked;
+    };
+
+    // Upper triangle by row; each row writes only its own entries
+    std::vector<uint8_t> visible(static_cast<size_t>(areaCount) * areaCount, 0);
+    ParallelFor(areaCount, 4, [&](size_t begin, size_t end) {
+        for (size_t a = begin; a < end; a++) {
+            visible[a * areaCount + a] = 1;
+            AABB grown(vis->areas[a].min - Vec3(0.01f), vis->areas[a].max + Vec3(0.01f));
+
+            for (size_t b = a + 1; b < areaCount; b++) {
+                bool seen = grown.Intersects(vis->areas[b]);
+                for (size_t i = 0; i < samples[a].size() && !seen; i++) {
+                    for (size_t j = 0; j < samples[b].size() && !seen; j++) {
+                        seen = segmentClear(samples[a][i], samples[b][j]);
+                    }
+                }
+                visible[a * areaCount + b] = seen ? 1 : 0;
+            }
+        }
+    });
+
+    uint64_t visiblePairs = 0;
+    for (uint32_t a = 0; a < areaCount; a++) {
+        for (uint32_t b = a; b < areaCount; b++) {
+            if (!visible[static_cast<size_t>(a) * areaCount + b]) continue;
+            vis->pvs[a * rowWords + b / 32] |= 1u << (b % 32);
+            vis->pvs[b * rowWords + a / 32] |= 1u << (a % 32);
+            visiblePairs += (a == b) ? 1 : 2;
+        }
+    }
+
+    LOG_INFO("VisCompiler", "Computed PVS for '" + map.GetName() + "': " + std::to_string(areaCount) +
+             (groups.empty() ? " grid areas, " : " vis group areas, ") +
+             std::to_string(visiblePairs * 100 / (static_cast<uint64_t>(areaCount) * areaCount)) +
+             "% of area pairs visible");
+    return vis;
+}
+
+} // namespace Genesis
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "math/Math.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace Genesis {
+
+class Map;
+
+// ============================================================================
+// MapVis - Area partition and potentially visible set (PVS)
+//
+// Space is split into areas (boxes), and pvs holds one bitset row per area:
+// bit b of row a is set when anything in area b may be seen from area a.
+// Rows are symmetric and every area sees itself. Positions outside every
+// area see everything.
+//
+// Built by VisCompiler when a map is compiled and stored in the .gmap.
+// ============================================================================
+struct MapVis {
+    static constexpr uint32_t NO_AREA = 0xFFFFFFFFu;
+
+    std::vector<AABB> areas;
+    std::vector<uint32_t> pvs;      // areas.size() rows of GetRowWords() words
+
+    bool IsEmpty() const { return areas.empty(); }
+    uint32_t GetAreaCount() const { return static_cast<uint32_t>(areas.size()); }
+    uint32_t GetRowWords() const { return (GetAreaCount() + 31) / 32; }
+
+    // First area containing the point, or NO_AREA
+    uint32_t FindArea(const Vec3& point) const;
+
+    // First area that fully contains the box, or NO_AREA when it is in
+    // none or straddles several (such objects are never PVS culled)
+    uint32_t FindAreaForBounds(const AABB& bounds) const;
+
+    bool IsVisible(uint32_t from, uint32_t to) const {
+        if (from >= areas.size() || to >= areas.size()) return true;
+        return (pvs[from * GetRowWords() + to / 32] >> (to % 32)) & 1u;
+    }
+
+    // Number of areas visible from an area (including itself)
+    uint32_t CountVisible(uint32_t from) const;
+};
+
+using MapVisPtr = std::shared_ptr<const MapVis>;
+
+// ============================================================================
+// VisCompiler - Computes MapVis from a map's brushes
+//
+// Areas: one per non-zero Brush::visGroup, spanning the union of that
+// group's brush bounds. Maps without vis groups fall back to a grid of
+// cellSize cubes over the map bounds.
+//
+// Visibility: areas that touch see each other (the shared face is the
+// portal between them). Other pairs are tested with rays between sample
+// points of the two areas, blocked by every visible, non-detail cube brush
+// (detail brushes never block vis, as in Source). One clear ray marks the
+// pair visible. Sampling is approximate: an opening narrower than the
+// sample spacing can be missed, so raise samplesPerArea for such maps.
+// ============================================================================
+struct VisCompileSettings {
+    float cellSize = 16.0f;            // Grid fallback only
+    uint32_t maxGridAreas = 2048;      // Cells grow until the grid fits
+    uint32_t samplesPerArea = 16;
+};
+
+class VisCompiler {
+public:
+    static MapVisPtr Compute(const Map& map, const VisCompileSettings& settings = VisCompileSettings());
+};
+
+} // namespace Genesis
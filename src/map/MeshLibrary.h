@@ -5,6 +5,7 @@
 #include <string>
 #include <unordered_map>
 #include <memory>
+#include <mutex>
 
 namespace Genesis {
 
@@ -13,6 +14,12 @@ namespace Genesis {
 //
 // Prevents creating duplicate meshes for common shapes.
 // A cube is a cube - we only need one VBO, and use instancing/transforms.
+//
+// Lookups are thread-safe. Creating a mesh uploads it, so the Get*() calls
+// that may create belong on the main thread; workers use FindForShape().
+//
+// Custom meshes are interned by content (Intern, Add): identical ones
+// resolve to one instance, so they upload once and batch together.
 // ============================================================================
 class MeshLibrary {
 public:
@@ -32,10 +39,18 @@ public:
         });
     }
 
+    // Round primitives carry an LOD chain at half and quarter tessellation,
+    // switched by projected size (see Mesh::AddLOD)
+    static constexpr float LOD1_SCREEN_SIZE = 0.25f;
+    static constexpr float LOD2_SCREEN_SIZE = 0.08f;
+
     // Get a unit sphere (radius 0.5)
     MeshPtr GetSphere() {
         return GetOrCreate("__sphere", []() {
-            return MeshPrimitives::CreateSphere(0.5f, 32, 32, "__sphere");
+            MeshPtr mesh = MeshPrimitives::CreateSphere(0.5f, 32, 32, "__sphere");
+            mesh->AddLOD(MeshPrimitives::CreateSphere(0.5f, 16, 16, "__sphere_lod1"), LOD1_SCREEN_SIZE);
+            mesh->AddLOD(MeshPrimitives::CreateSphere(0.5f, 8, 8, "__sphere_lod2"), LOD2_SCREEN_SIZE);
+            return mesh;
         });
     }
 
@@ -49,14 +64,20 @@ public:
     // Get a unit cylinder (radius 0.5, height 1)
     MeshPtr GetCylinder() {
         return GetOrCreate("__cylinder", []() {
-            return MeshPrimitives::CreateCylinder(0.5f, 1.0f, 32, "__cylinder");
+            MeshPtr mesh = MeshPrimitives::CreateCylinder(0.5f, 1.0f, 32, "__cylinder");
+            mesh->AddLOD(MeshPrimitives::CreateCylinder(0.5f, 1.0f, 16, "__cylinder_lod1"), LOD1_SCREEN_SIZE);
+            mesh->AddLOD(MeshPrimitives::CreateCylinder(0.5f, 1.0f, 8, "__cylinder_lod2"), LOD2_SCREEN_SIZE);
+            return mesh;
         });
     }
 
     // Get a unit cone (radius 0.5, height 1)
     MeshPtr GetCone() {
         return GetOrCreate("__cone", []() {
-            return MeshPrimitives::CreateCone(0.5f, 1.0f, 32, "__cone");
+            MeshPtr mesh = MeshPrimitives::CreateCone(0.5f, 1.0f, 32, "__cone");
+            mesh->AddLOD(MeshPrimitives::CreateCone(0.5f, 1.0f, 16, "__cone_lod1"), LOD1_SCREEN_SIZE);
+            mesh->AddLOD(MeshPrimitives::CreateCone(0.5f, 1.0f, 8, "__cone_lod2"), LOD2_SCREEN_SIZE);
+            return mesh;
         });
     }
 
@@ -66,32 +87,58 @@ public:
 
     // Get mesh by name (returns nullptr if not found)
     MeshPtr Get(const std::string& name) const {
+        std::lock_guard<std::mutex> lock(m_mutex);
         auto it = m_meshes.find(name);
         return (it != m_meshes.end()) ? it->second : nullptr;
     }
 
-    // Add a custom mesh to the library
-    void Add(const std::string& name, MeshPtr mesh) {
-        m_meshes[name] = std::move(mesh);
+    // Add a custom mesh to the library; name resolves to an identical mesh
+    // already interned if there is one (returned)
+    MeshPtr Add(const std::string& name, MeshPtr mesh) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        MeshPtr shared = InternLocked(mesh);
+        m_meshes[name] = shared;
+        return shared;
+    }
+
+    // The interned mesh with the same content as mesh (Mesh::HasSameContent),
+    // else mesh, now interned. Intern before Upload() and upload only when
+    // mesh itself comes back, so a duplicate is never uploaded. Meshes
+    // without CPU copies or with LODs are returned as they are; interned
+    // meshes need to keep their copies to be matched (SetKeepCPUData).
+    MeshPtr Intern(const MeshPtr& mesh) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return InternLocked(mesh);
+    }
+
+    // Intern() calls that returned an existing mesh
+    size_t GetInternHits() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_internHits;
     }
 
     // Check if mesh exists
     bool Exists(const std::string& name) const {
+        std::lock_guard<std::mutex> lock(m_mutex);
         return m_meshes.find(name) != m_meshes.end();
     }
 
     // Remove a mesh
     void Remove(const std::string& name) {
+        std::lock_guard<std::mutex> lock(m_mutex);
         m_meshes.erase(name);
     }
 
     // Clear all meshes (except built-in primitives)
     void Clear() {
+        std::lock_guard<std::mutex> lock(m_mutex);
         m_meshes.clear();
+        m_interned.clear();
     }
 
     // Get mesh count
     size_t GetMeshCount() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
         return m_meshes.size();
     }
 
@@ -120,17 +167,48 @@ private:
 
     // Get or create a mesh with lazy initialization
     MeshPtr GetOrCreate(const std::string& name, std::function<MeshPtr()> creator) {
+        std::lock_guard<std::mutex> lock(m_mutex);
         auto it = m_meshes.find(name);
         if (it != m_meshes.end()) {
             return it->second;
         }
+        // Shared shapes are cloned (lightmapped brushes) and merged from,
+        // so they keep their CPU copies whatever the mesh policy
+        Mesh::KeepCPUDataScope keep;
         MeshPtr mesh = creator();
+        if (mesh) mesh->SetKeepCPUData(true);
         m_meshes[name] = mesh;
         return mesh;
     }
 
+    MeshPtr InternLocked(const MeshPtr& mesh) {
+        if (!mesh || !mesh->HasCPUData() || mesh->HasLODs()) return mesh;
+
+        // Entries hold weak references: a mesh nobody uses any more drops out
+        uint64_t hash = mesh->ComputeContentHash();
+        auto [first, last] = m_interned.equal_range(hash);
+        for (auto it = first; it != last;) {
+            MeshPtr candidate = it->second.lock();
+            if (!candidate) {
+                it = m_interned.erase(it);
+                continue;
+            }
+            if (candidate == mesh) return mesh;
+            if (candidate->HasSameContent(*mesh)) {
+                m_internHits++;
+                return candidate;
+            }
+            ++it;
+        }
+        m_interned.emplace(hash, mesh);
+        return mesh;
+    }
+
 private:
     std::unordered_map<std::string, MeshPtr> m_meshes;
+    std::unordered_multimap<uint64_t, std::weak_ptr<Mesh>> m_interned;
+    size_t m_internHits = 0;
+    mutable std::mutex m_mutex;
 };
 
 } // namespace Genesis
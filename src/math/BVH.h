@@ -0,0 +1,299 @@
+#pragma once
+
+// ============================================================================
+// Genesis Engine BVH
+// Static bounding volume hierarchy over a list of AABBs
+// ============================================================================
+
+#include "Math.h"
+#include "Frustum.h"
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+
+namespace Genesis {
+
+// ============================================================================
+// BVH Node - Flat array node
+//
+// count > 0: leaf, items are m_items[first .. first + count)
+// count == 0: internal, children are nodes[first] and nodes[first + 1]
+// ============================================================================
+struct BVHNode {
+    AABB bounds;
+    uint32_t first = 0;
+    uint32_t count = 0;
+
+    bool IsLeaf() const { return count > 0; }
+};
+
+// ============================================================================
+// BVH - Top-down median split tree over item indices
+//
+// Items are identified by their index in the bounds array passed to Build().
+// The tree only stores indices; callers own the actual objects.
+//
+// Usage:
+//   BVH bvh;
+//   bvh.Build(bounds);
+//   bvh.QueryAABB(box, [&](uint32_t index) { ... });
+//
+//   // Bounds moved but item set unchanged:
+//   bvh.Refit(bounds);
+// ============================================================================
+class BVH {
+public:
+    static constexpr uint32_t MAX_LEAF_ITEMS = 4;
+    static constexpr int MAX_DEPTH = 64;
+
+    // ========================================================================
+    // Construction
+    // ========================================================================
+
+    void Build(const std::vector<AABB>& bounds) {
+        m_nodes.clear();
+        m_items.resize(bounds.size());
+        for (uint32_t i = 0; i < static_cast<uint32_t>(bounds.size()); i++) {
+            m_items[i] = i;
+        }
+
+        if (bounds.empty()) return;
+
+        m_nodes.reserve(bounds.size() * 2);
+        m_nodes.emplace_back();
+        BuildRecursive(0, 0, static_cast<uint32_t>(bounds.size()), bounds, 0);
+    }
+
+    // Recompute node bounds bottom-up without changing the topology.
+    // Children are always stored after their parent, so a reverse walk works.
+    void Refit(const std::vector<AABB>& bounds) {
+        for (size_t n = m_nodes.size(); n-- > 0;) {
+            BVHNode& node = m_nodes[n];
+            if (node.IsLeaf()) {
+                node.bounds = bounds[m_items[node.first]];
+                for (uint32_t i = 1; i < node.count; i++) {
+                    Grow(node.bounds, bounds[m_items[node.first + i]]);
+                }
+            } else {
+                node.bounds = m_nodes[node.first].bounds;
+                Grow(node.bounds, m_nodes[node.first + 1].bounds);
+            }
+        }
+    }
+
+    void Clear() {
+        m_nodes.clear();
+        m_items.clear();
+    }
+
+    bool IsEmpty() const { return m_nodes.empty(); }
+    size_t GetNodeCount() const { return m_nodes.size(); }
+    size_t GetItemCount() const { return m_items.size(); }
+    const std::vector<BVHNode>& GetNodes() const { return m_nodes; }
+    const std::vector<uint32_t>& GetItems() const { return m_items; }
+
+    // Adopt a tree built earlier (e.g. stored in a compiled map).
+    // Caller guarantees the data came from GetNodes()/GetItems().
+    void Assign(std::vector<BVHNode> nodes, std::vector<uint32_t> items) {
+        m_nodes = std::move(nodes);
+        m_items = std::move(items);
+    }
+
+    // ========================================================================
+    // Queries - callbacks receive item indices
+    // ========================================================================
+
+    // Visit every item whose leaf bounds overlap the box (caller does the
+    // exact per-item test)
+    template<typename Fn>
+    void QueryAABB(const AABB& box, Fn&& fn) const {
+        if (m_nodes.empty()) return;
+
+        uint32_t stack[MAX_DEPTH];
+        int top = 0;
+        stack[top++] = 0;
+
+        while (top > 0) {
+            const BVHNode& node = m_nodes[stack[--top]];
+            if (!node.bounds.Intersects(box)) continue;
+
+            if (node.IsLeaf()) {
+                for (uint32_t i = 0; i < node.count; i++) {
+                    fn(m_items[node.first + i]);
+                }
+            } else {
+                stack[top++] = node.first;
+                stack[top++] = node.first + 1;
+            }
+        }
+    }
+
+    // Visit every item whose leaf bounds contain the point
+    template<typename Fn>
+    void QueryPoint(const Vec3& point, Fn&& fn) const {
+        QueryAABB(AABB(point, point), std::forward<Fn>(fn));
+    }
+
+    // Visit items against a frustum. fn(index, fullyInside) - when
+    // fullyInside is true the item's node was entirely inside the frustum
+    // and no per-item test is needed.
+    template<typename Fn>
+    void QueryFrustum(const Frustum& frustum, Fn&& fn) const {
+        if (m_nodes.empty()) return;
+
+        struct Entry { uint32_t node; bool inside; };
+        Entry stack[MAX_DEPTH];
+        int top = 0;
+        stack[top++] = {0, false};
+
+        while (top > 0) {
+            Entry e = stack[--top];
+            const BVHNode& node = m_nodes[e.node];
+
+            bool inside = e.inside;
+            if (!inside) {
+                FrustumResult r = frustum.Classify(node.bounds.min, node.bounds.max);
+                if (r == FrustumResult::Outside) continue;
+                inside = (r == FrustumResult::Inside);
+            }
+
+            if (node.IsLeaf()) {
+                for (uint32_t i = 0; i < node.count; i++) {
+                    fn(m_items[node.first + i], inside);
+                }
+            } else {
+                stack[top++] = {node.first, inside};
+                stack[top++] = {node.first + 1, inside};
+            }
+        }
+    }
+
+    // Ray traversal, near child first. fn(index, maxDist) tests the item
+    // and may shrink maxDist to the hit distance to prune farther nodes.
+    template<typename Fn>
+    void Raycast(const Vec3& origin, const Vec3& direction, float maxDist, Fn&& fn) const {
+        if (m_nodes.empty()) return;
+
+        Vec3 invDir(
+            1.0f / (std::abs(direction.x) > Math::EPSILON ? direction.x : Math::EPSILON),
+            1.0f / (std::abs(direction.y) > Math::EPSILON ? direction.y : Math::EPSILON),
+            1.0f / (std::abs(direction.z) > Math::EPSILON ? direction.z : Math::EPSILON)
+        );
+
+        uint32_t stack[MAX_DEPTH];
+        int top = 0;
+        stack[top++] = 0;
+
+        while (top > 0) {
+            const BVHNode& node = m_nodes[stack[--top]];
+            float tEntry;
+            if (!RayAABB(origin, invDir, node.bounds, maxDist, tEntry)) continue;
+
+            if (node.IsLeaf()) {
+                for (uint32_t i = 0; i < node.count; i++) {
+                    fn(m_items[node.first + i], maxDist);
+                }
+            } else {
+                // Push the farther child first so the nearer one pops first
+                float tA, tB;
+                bool hitA = RayAABB(origin, invDir, m_nodes[node.first].bounds, maxDist, tA);
+                bool hitB = RayAABB(origin, invDir, m_nodes[node.first + 1].bounds, maxDist, tB);
+                if (hitA && hitB) {
+                    if (tA <= tB) {
+                        stack[top++] = node.first + 1;
+                        stack[top++] = node.first;
+                    } else {
+                        stack[top++] = node.first;
+                        stack[top++] = node.first + 1;
+                    }
+                } else if (hitA) {
+                    stack[top++] = node.first;
+                } else if (hitB) {
+                    stack[top++] = node.first + 1;
+                }
+            }
+        }
+    }
+
+    // Slab test. Returns entry distance in tEntry (0 if origin is inside).
+    static bool RayAABB(const Vec3& origin, const Vec3& invDir, const AABB& box,
+                        float maxDist, float& tEntry) {
+        float t1 = (box.min.x - origin.x) * invDir.x;
+        float t2 = (box.max.x - origin.x) * invDir.x;
+        float tmin = std::min(t1, t2);
+        float tmax = std::max(t1, t2);
+
+        t1 = (box.min.y - origin.y) * invDir.y;
+        t2 = (box.max.y - origin.y) * invDir.y;
+        tmin = std::max(tmin, std::min(t1, t2));
+        tmax = std::min(tmax, std::max(t1, t2));
+
+        t1 = (box.min.z - origin.z) * invDir.z;
+        t2 = (box.max.z - origin.z) * invDir.z;
+        tmin = std::max(tmin, std::min(t1, t2));
+        tmax = std::min(tmax, std::max(t1, t2));
+
+        tEntry = std::max(tmin, 0.0f);
+        return tmax >= tEntry && tEntry <= maxDist;
+    }
+
+private:
+    static void Grow(AABB& a, const AABB& b) {
+        a.min = glm::min(a.min, b.min);
+        a.max = glm::max(a.max, b.max);
+    }
+
+    void BuildRecursive(uint32_t nodeIndex, uint32_t first, uint32_t count,
+                        const std::vector<AABB>& bounds, int depth) {
+        // Bounds of all items and of their centroids
+        AABB nodeBounds = bounds[m_items[first]];
+        Vec3 cMin = nodeBounds.GetCenter();
+        Vec3 cMax = cMin;
+        for (uint32_t i = 1; i < count; i++) {
+            const AABB& b = bounds[m_items[first + i]];
+            Grow(nodeBounds, b);
+            Vec3 c = b.GetCenter();
+            cMin = glm::min(cMin, c);
+            cMax = glm::max(cMax, c);
+        }
+        m_nodes[nodeIndex].bounds = nodeBounds;
+
+        // Leaf: small enough, too deep (stack limit), or degenerate centroids
+        Vec3 extent = cMax - cMin;
+        float maxExtent = std::max(extent.x, std::max(extent.y, extent.z));
+        if (count <= MAX_LEAF_ITEMS || depth >= MAX_DEPTH - 2 || maxExtent <= Math::EPSILON) {
+            m_nodes[nodeIndex].first = first;
+            m_nodes[nodeIndex].count = count;
+            return;
+        }
+
+        // Median split on the longest centroid axis
+        int axis = 0;
+        if (extent.y > extent[axis]) axis = 1;
+        if (extent.z > extent[axis]) axis = 2;
+
+        uint32_t mid = count / 2;
+        std::nth_element(m_items.begin() + first, m_items.begin() + first + mid,
+                         m_items.begin() + first + count,
+            [&bounds, axis](uint32_t a, uint32_t b) {
+                return (bounds[a].min[axis] + bounds[a].max[axis])
+                     < (bounds[b].min[axis] + bounds[b].max[axis]);
+            });
+
+        uint32_t left = static_cast<uint32_t>(m_nodes.size());
+        m_nodes.emplace_back();
+        m_nodes.emplace_back();
+        m_nodes[nodeIndex].first = left;
+        m_nodes[nodeIndex].count = 0;
+
+        BuildRecursive(left, first, mid, bounds, depth + 1);
+        BuildRecursive(left + 1, first + mid, count - mid, bounds, depth + 1);
+    }
+
+private:
+    std::vector<BVHNode> m_nodes;
+    std::vector<uint32_t> m_items;
+};
+
+} // namespace Genesis
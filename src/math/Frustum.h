@@ -0,0 +1,178 @@
+#pragma once
+
+// ============================================================================
+// Genesis Engine Frustum
+// View frustum extraction and batched AABB visibility tests
+// ============================================================================
+
+#include "Math.h"
+#include <cstdint>
+#include <cstddef>
+
+namespace Genesis {
+
+// ============================================================================
+// Frustum test result for hierarchical culling
+// ============================================================================
+enum class FrustumResult {
+    Outside,
+    Intersect,
+    Inside
+};
+
+// ============================================================================
+// Frustum - Six planes extracted from a view-projection matrix
+//
+// Planes are stored as (normal.xyz, distance) with normals pointing inward,
+// so a point p is inside a plane when dot(normal, p) + distance >= 0.
+// Extraction assumes GLM_FORCE_DEPTH_ZERO_TO_ONE (clip z in [0, w]).
+// ============================================================================
+struct Frustum {
+    enum Plane { Left = 0, Right, Bottom, Top, Near, Far, Count };
+
+    Vec4 planes[Count];
+
+    Frustum() = default;
+
+    // Build from projection * view (Gribb/Hartmann plane extraction)
+    static Frustum FromMatrix(const Mat4& viewProj) {
+        // GLM is column-major: viewProj[col][row]
+        auto row = [&viewProj](int r) {
+            return Vec4(viewProj[0][r], viewProj[1][r], viewProj[2][r], viewProj[3][r]);
+        };
+        Vec4 r0 = row(0), r1 = row(1), r2 = row(2), r3 = row(3);
+
+        Frustum f;
+        f.planes[Left]   = r3 + r0;
+        f.planes[Right]  = r3 - r0;
+        f.planes[Bottom] = r3 + r1;
+        f.planes[Top]    = r3 - r1;
+        f.planes[Near]   = r2;        // Zero-to-one depth
+        f.planes[Far]    = r3 - r2;
+
+        for (auto& p : f.planes) {
+            float len = glm::length(Vec3(p));
+            if (len > Math::EPSILON) {
+                p /= len;
+            }
+        }
+        return f;
+    }
+
+    // Sphere test (conservative)
+    bool Intersects(const Vec3& center, float radius) const {
+        for (const auto& p : planes) {
+            if (Math::Dot(Vec3(p), center) + p.w < -radius) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // AABB test using the "positive vertex" of each plane.
+    // Conservative: may report boxes near frustum corners as visible.
+    bool Intersects(const Vec3& bmin, const Vec3& bmax) const {
+        for (const auto& p : planes) {
+            Vec3 positive(
+                p.x >= 0.0f ? bmax.x : bmin.x,
+                p.y >= 0.0f ? bmax.y : bmin.y,
+                p.z >= 0.0f ? bmax.z : bmin.z
+            );
+            if (p.x * positive.x + p.y * positive.y + p.z * positive.z + p.w < 0.0f) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool Intersects(const AABB& aabb) const {
+        return Intersects(aabb.min, aabb.max);
+    }
+
+    // Full classification: also reports boxes entirely inside all planes,
+    // which lets a hierarchy skip testing children
+    FrustumResult Classify(const Vec3& bmin, const Vec3& bmax) const {
+        FrustumResult result = FrustumResult::Inside;
+        for (const auto& p : planes) {
+            Vec3 positive(
+                p.x >= 0.0f ? bmax.x : bmin.x,
+                p.y >= 0.0f ? bmax.y : bmin.y,
+                p.z >= 0.0f ? bmax.z : bmin.z
+            );
+            if (p.x * positive.x + p.y * positive.y + p.z * positive.z + p.w < 0.0f) {
+                return FrustumResult::Outside;
+            }
+
+            Vec3 negative(
+                p.x >= 0.0f ? bmin.x : bmax.x,
+                p.y >= 0.0f ? bmin.y : bmax.y,
+                p.z >= 0.0f ? bmin.z : bmax.z
+            );
+            if (p.x * negative.x + p.y * negative.y + p.z * negative.z + p.w < 0.0f) {
+                result = FrustumResult::Intersect;
+            }
+        }
+        return result;
+    }
+
+    // ========================================================================
+    // Batched test - writes 1 (visible) or 0 (culled) per box into outVisible.
+    // Processes 4 boxes per iteration with SSE when available.
+    // Returns the number of visible boxes.
+    // ========================================================================
+    size_t TestAABBs(const AABBSoA& bounds, uint8_t* outVisible) const {
+        const size_t count = bounds.Size();
+        size_t visible = 0;
+        size_t i = 0;
+
+#ifdef GENESIS_SSE
+        // Per plane: broadcast normal/distance, and remember which bound
+        // array supplies the positive vertex on each axis
+        __m128 nx[Count], ny[Count], nz[Count], nd[Count];
+        const float* px[Count];
+        const float* py[Count];
+        const float* pz[Count];
+        for (int p = 0; p < Count; p++) {
+            nx[p] = _mm_set1_ps(planes[p].x);
+            ny[p] = _mm_set1_ps(planes[p].y);
+            nz[p] = _mm_set1_ps(planes[p].z);
+            nd[p] = _mm_set1_ps(planes[p].w);
+            px[p] = planes[p].x >= 0.0f ? bounds.maxX.data() : bounds.minX.data();
+            py[p] = planes[p].y >= 0.0f ? bounds.maxY.data() : bounds.minY.data();
+            pz[p] = planes[p].z >= 0.0f ? bounds.maxZ.data() : bounds.minZ.data();
+        }
+
+        const __m128 zero = _mm_setzero_ps();
+        for (; i + 4 <= count; i += 4) {
+            __m128 outside = _mm_setzero_ps();
+            for (int p = 0; p < Count; p++) {
+                __m128 d = _mm_add_ps(
+                    _mm_add_ps(_mm_mul_ps(nx[p], _mm_loadu_ps(px[p] + i)),
+                               _mm_mul_ps(ny[p], _mm_loadu_ps(py[p] + i))),
+                    _mm_add_ps(_mm_mul_ps(nz[p], _mm_loadu_ps(pz[p] + i)), nd[p]));
+                outside = _mm_or_ps(outside, _mm_cmplt_ps(d, zero));
+            }
+
+            int mask = _mm_movemask_ps(outside);
+            for (int k = 0; k < 4; k++) {
+                uint8_t v = (mask & (1 << k)) ? 0 : 1;
+                outVisible[i + k] = v;
+                visible += v;
+            }
+        }
+#endif
+
+        // Scalar tail (or full loop without SSE)
+        for (; i < count; i++) {
+            Vec3 bmin(bounds.minX[i], bounds.minY[i], bounds.minZ[i]);
+            Vec3 bmax(bounds.maxX[i], bounds.maxY[i], bounds.maxZ[i]);
+            uint8_t v = Intersects(bmin, bmax) ? 1 : 0;
+            outVisible[i] = v;
+            visible += v;
+        }
+
+        return visible;
+    }
+};
+
+} // namespace Genesis
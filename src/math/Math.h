@@ -20,6 +20,14 @@
 #include <glm/gtx/norm.hpp>
 #include <glm/gtx/string_cast.hpp>
 
+#include <vector>
+
+// SSE2 is baseline on every x64 target; used by the batched bounds kernels
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define GENESIS_SSE 1
+    #include <emmintrin.h>
+#endif
+
 namespace Genesis {
 
 // ============================================================================
@@ -81,6 +89,63 @@ struct AABB {
     }
 };
 
+// ============================================================================
+// AABB SoA - Structure-of-arrays bounds storage for batched tests
+//
+// Keeps each component in its own contiguous array so four boxes can be
+// loaded into one SSE register per component.
+// ============================================================================
+struct AABBSoA {
+    std::vector<float> minX, minY, minZ;
+    std::vector<float> maxX, maxY, maxZ;
+
+    size_t Size() const { return minX.size(); }
+    bool Empty() const { return minX.empty(); }
+
+    void Clear() {
+        minX.clear(); minY.clear(); minZ.clear();
+        maxX.clear(); maxY.clear(); maxZ.clear();
+    }
+
+    void Reserve(size_t count) {
+        minX.reserve(count); minY.reserve(count); minZ.reserve(count);
+        maxX.reserve(count); maxY.reserve(count); maxZ.reserve(count);
+    }
+
+    void Resize(size_t count) {
+        minX.resize(count); minY.resize(count); minZ.resize(count);
+        maxX.resize(count); maxY.resize(count); maxZ.resize(count);
+    }
+
+    void Push(const Vec3& bmin, const Vec3& bmax) {
+        minX.push_back(bmin.x); minY.push_back(bmin.y); minZ.push_back(bmin.z);
+        maxX.push_back(bmax.x); maxY.push_back(bmax.y); maxZ.push_back(bmax.z);
+    }
+
+    void Set(size_t index, const Vec3& bmin, const Vec3& bmax) {
+        minX[index] = bmin.x; minY[index] = bmin.y; minZ[index] = bmin.z;
+        maxX[index] = bmax.x; maxY[index] = bmax.y; maxZ[index] = bmax.z;
+    }
+
+    AABB Get(size_t index) const {
+        return AABB(Vec3(minX[index], minY[index], minZ[index]), Vec3(maxX[index], maxY[index], maxZ[index]));
+    }
+
+    void Erase(size_t index) {
+        minX.erase(minX.begin() + index); minY.erase(minY.begin() + index); minZ.erase(minZ.begin() + index);
+        maxX.erase(maxX.begin() + index); maxY.erase(maxY.begin() + index); maxZ.erase(maxZ.begin() + index);
+    }
+
+    // O(1) removal: the last entry moves into index
+    void SwapRemove(size_t index) {
+        size_t last = Size() - 1;
+        minX[index] = minX[last]; minY[index] = minY[last]; minZ[index] = minZ[last];
+        maxX[index] = maxX[last]; maxY[index] = maxY[last]; maxZ[index] = maxZ[last];
+        minX.pop_back(); minY.pop_back(); minZ.pop_back();
+        maxX.pop_back(); maxY.pop_back(); maxZ.pop_back();
+    }
+};
+
 // ============================================================================
 // Math Constants
 // ============================================================================
@@ -148,6 +213,14 @@ namespace Math {
     inline Vec3 Lerp(const Vec3& a, const Vec3& b, float t) { return glm::mix(a, b, t); }
     inline Vec4 Lerp(const Vec4& a, const Vec4& b, float t) { return glm::mix(a, b, t); }
 
+    // Lerp between angles in degrees along the shorter arc
+    inline float LerpAngle(float a, float b, float t) {
+        float delta = std::fmod(b - a, 360.0f);
+        if (delta > 180.0f) delta -= 360.0f;
+        if (delta < -180.0f) delta += 360.0f;
+        return a + delta * t;
+    }
+
     // Clamp
     inline float Clamp(float value, float min, float max) { return glm::clamp(value, min, max); }
     inline Vec3 Clamp(const Vec3& value, const Vec3& min, const Vec3& max) { return glm::clamp(value, min, max); }
@@ -213,6 +286,22 @@ namespace Math {
     inline Mat4 Inverse(const Mat4& matrix) { return glm::inverse(matrix); }
     inline Mat3 Inverse(const Mat3& matrix) { return glm::inverse(matrix); }
 
+    // World AABB of a local box under an affine transform. Same result as
+    // transforming all 8 corners, for the cost of one point transform.
+    inline AABB TransformAABB(const Mat4& matrix, const Vec3& localMin, const Vec3& localMax) {
+        Vec3 center = (localMin + localMax) * 0.5f;
+        Vec3 extents = (localMax - localMin) * 0.5f;
+
+        Vec3 worldCenter = Vec3(matrix * Vec4(center, 1.0f));
+        Vec3 worldExtents;
+        for (int row = 0; row < 3; row++) {
+            worldExtents[row] = std::abs(matrix[0][row]) * extents.x +
+                                std::abs(matrix[1][row]) * extents.y +
+                                std::abs(matrix[2][row]) * extents.z;
+        }
+        return AABB(worldCenter - worldExtents, worldCenter + worldExtents);
+    }
+
     // Transpose
     inline Mat4 Transpose(const Mat4& matrix) { return glm::transpose(matrix); }
     inline Mat3 Transpose(const Mat3& matrix) { return glm::transpose(matrix); }
@@ -0,0 +1,113 @@
+#pragma once
+
+#include "math/Math.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace Genesis {
+
+// ============================================================================
+// CapsuleCollision - Exact capsule narrowphase (segment distance tests)
+//
+// A capsule is its core segment [a, b] inflated by a radius, so every test
+// reduces to the closest points between the segment and a shape: the
+// capsule overlaps the shape when their distance is below the radius. The
+// contact normal is segmentPoint - shapePoint.
+// ============================================================================
+namespace CapsuleCollision {
+
+    struct ClosestPoints {
+        float distanceSq = std::numeric_limits<float>::infinity();
+        float t = 0.0f;              // Along the segment (0 = a, 1 = b)
+        Vec3 segmentPoint = Vec3(0.0f);
+        Vec3 shapePoint = Vec3(0.0f);
+    };
+
+    inline float PointAABBDistanceSq(const Vec3& p, const Vec3& bmin, const Vec3& bmax) {
+        Vec3 d = p - glm::clamp(p, bmin, bmax);
+        return Math::Dot(d, d);
+    }
+
+    // Segment vs AABB. The squared distance along the segment is convex and
+    // piecewise quadratic, with pieces split where a coordinate crosses a
+    // slab plane; each piece (at most 7) is minimized in closed form.
+    inline ClosestPoints SegmentAABB(const Vec3& a, const Vec3& b, const Vec3& bmin, const Vec3& bmax) {
+        const Vec3 u = b - a;
+
+        float breaks[8];
+        int count = 0;
+        breaks[count++] = 0.0f;
+        for (int axis = 0; axis < 3; axis++) {
+            if (u[axis] == 0.0f) continue;
+            float t0 = (bmin[axis] - a[axis]) / u[axis];
+            float t1 = (bmax[axis] - a[axis]) / u[axis];
+            if (t0 > 0.0f && t0 < 1.0f) breaks[count++] = t0;
+            if (t1 > 0.0f && t1 < 1.0f) breaks[count++] = t1;
+        }
+        breaks[count++] = 1.0f;
+        std::sort(breaks, breaks + count);
+
+        ClosestPoints result;
+        for (int piece = 0; piece + 1 < count; piece++) {
+            float t0 = breaks[piece], t1 = breaks[piece + 1];
+            float mid = (t0 + t1) * 0.5f;
+
+            // sum over clamped axes of (a + t*u - plane)^2 = A t^2 + B t + C
+            float A = 0.0f, B = 0.0f;
+            for (int axis = 0; axis < 3; axis++) {
+                float p = a[axis] + u[axis] * mid;
+                float plane = p < bmin[axis] ? bmin[axis] : (p > bmax[axis] ? bmax[axis] : p);
+                if (plane == p) continue;
+                A += u[axis] * u[axis];
+                B += 2.0f * u[axis] * (a[axis] - plane);
+            }
+
+            float t = A > 0.0f ? std::clamp(-B / (2.0f * A), t0, t1) : t0;
+            Vec3 p = a + u * t;
+            float distanceSq = PointAABBDistanceSq(p, bmin, bmax);
+            if (distanceSq < result.distanceSq) {
+                result.distanceSq = distanceSq;
+                result.t = t;
+                result.segmentPoint = p;
+            }
+        }
+        result.shapePoint = glm::clamp(result.segmentPoint, bmin, bmax);
+        return result;
+    }
+
+    // Segment vs oriented box: SegmentAABB in the box's frame
+    inline ClosestPoints SegmentOrientedBox(const Vec3& a, const Vec3& b, const Vec3& center,
+                                            const Vec3 axes[3], const Vec3& halfExtents) {
+        auto toLocal = [&](const Vec3& p) {
+            Vec3 d = p - center;
+            return Vec3(Math::Dot(d, axes[0]), Math::Dot(d, axes[1]), Math::Dot(d, axes[2]));
+        };
+        auto toWorld = [&](const Vec3& p) {
+            return center + axes[0] * p.x + axes[1] * p.y + axes[2] * p.z;
+        };
+
+        ClosestPoints result = SegmentAABB(toLocal(a), toLocal(b), -halfExtents, halfExtents);
+        result.segmentPoint = toWorld(result.segmentPoint);
+        result.shapePoint = toWorld(result.shapePoint);
+        return result;
+    }
+
+    // Segment vs point (sphere center)
+    inline ClosestPoints SegmentPoint(const Vec3& a, const Vec3& b, const Vec3& point) {
+        Vec3 u = b - a;
+        float lengthSq = Math::Dot(u, u);
+        float t = lengthSq > 0.0f ? std::clamp(Math::Dot(point - a, u) / lengthSq, 0.0f, 1.0f) : 0.0f;
+
+        ClosestPoints result;
+        result.t = t;
+        result.segmentPoint = a + u * t;
+        result.shapePoint = point;
+        Vec3 d = result.segmentPoint - point;
+        result.distanceSq = Math::Dot(d, d);
+        return result;
+    }
+
+} // namespace CapsuleCollision
+
+} // namespace Genesis
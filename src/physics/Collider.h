@@ -32,11 +32,11 @@ enum class CollisionLayer : uint32_t {
     All         = 0xFFFFFFFF
 };
 
-inline CollisionLayer operator|(CollisionLayer a, CollisionLayer b) {
+constexpr CollisionLayer operator|(CollisionLayer a, CollisionLayer b) {
     return static_cast<CollisionLayer>(static_cast<uint32_t>(a) | static_cast<uint32_t>(b));
 }
 
-inline CollisionLayer operator&(CollisionLayer a, CollisionLayer b) {
+constexpr CollisionLayer operator&(CollisionLayer a, CollisionLayer b) {
     return static_cast<CollisionLayer>(static_cast<uint32_t>(a) & static_cast<uint32_t>(b));
 }
 
@@ -55,6 +55,13 @@ public:
     // Check if point is inside collider
     virtual bool ContainsPoint(const Vec3& point, const Mat4& transform) const = 0;
 
+    // Same test with the transform's inverse precomputed (static geometry
+    // caches it instead of inverting per query)
+    virtual bool ContainsPoint(const Vec3& point, const Mat4& transform, const Mat4& inverseTransform) const {
+        (void)inverseTransform;
+        return ContainsPoint(point, transform);
+    }
+
     // Collision layer for filtering
     void SetLayer(CollisionLayer layer) { m_layer = layer; }
     CollisionLayer GetLayer() const { return m_layer; }
@@ -106,36 +113,18 @@ public:
     ColliderType GetType() const override { return ColliderType::Box; }
 
     AABB GetWorldAABB(const Mat4& transform) const override {
-        // Get the 8 corners of the box
-        Vec3 corners[8] = {
-            Vec3(-m_halfExtents.x, -m_halfExtents.y, -m_halfExtents.z),
-            Vec3( m_halfExtents.x, -m_halfExtents.y, -m_halfExtents.z),
-            Vec3(-m_halfExtents.x,  m_halfExtents.y, -m_halfExtents.z),
-            Vec3( m_halfExtents.x,  m_halfExtents.y, -m_halfExtents.z),
-            Vec3(-m_halfExtents.x, -m_halfExtents.y,  m_halfExtents.z),
-            Vec3( m_halfExtents.x, -m_halfExtents.y,  m_halfExtents.z),
-            Vec3(-m_halfExtents.x,  m_halfExtents.y,  m_halfExtents.z),
-            Vec3( m_halfExtents.x,  m_halfExtents.y,  m_halfExtents.z)
-        };
-
-        AABB result;
-        result.min = Vec3(std::numeric_limits<float>::max());
-        result.max = Vec3(std::numeric_limits<float>::lowest());
-
-        for (const auto& corner : corners) {
-            Vec4 transformed = transform * Vec4(corner, 1.0f);
-            Vec3 worldCorner(transformed.x, transformed.y, transformed.z);
-            result.min = glm::min(result.min, worldCorner);
-            result.max = glm::max(result.max, worldCorner);
-        }
-
-        return result;
+        return Math::TransformAABB(transform, -m_halfExtents, m_halfExtents);
     }
 
     bool ContainsPoint(const Vec3& point, const Mat4& transform) const override {
+        return ContainsPoint(point, transform, glm::inverse(transform));
+    }
+
+    bool ContainsPoint(const Vec3& point, const Mat4& transform, const Mat4& inverseTransform) const override {
+        (void)transform;
+
         // Transform point to local space
-        Mat4 invTransform = glm::inverse(transform);
-        Vec4 localPoint4 = invTransform * Vec4(point, 1.0f);
+        Vec4 localPoint4 = inverseTransform * Vec4(point, 1.0f);
         Vec3 localPoint(localPoint4.x, localPoint4.y, localPoint4.z);
 
         return std::abs(localPoint.x) <= m_halfExtents.x &&
@@ -174,6 +163,8 @@ public:
         };
     }
 
+    using Collider::ContainsPoint;
+
     bool ContainsPoint(const Vec3& point, const Mat4& transform) const override {
         Vec3 center(transform[3]);
         float distSq = glm::length2(point - center);
@@ -0,0 +1,408 @@
+#include "PhysicsWorld.h"
+#include "core/ParallelFor.h"
+
+namespace Genesis {
+
+namespace {
+
+constexpr float RAY_INFINITY = std::numeric_limits<float>::infinity();
+
+// 1/d with zero components replaced by a tiny signed value, so the slab
+// tests stay finite (no 0 * inf NaN) for axis-parallel rays
+Vec3 SafeInverse(const Vec3& d) {
+    auto inv = [](float v) {
+        constexpr float tiny = 1e-12f;
+        return 1.0f / (std::abs(v) > tiny ? v : std::copysign(tiny, v));
+    };
+    return Vec3(inv(d.x), inv(d.y), inv(d.z));
+}
+
+// Slab test against [bmin, bmax] in the ray's frame. On a hit within
+// [0, maxDistance], distance is the entry distance (0 when starting inside)
+// and axis is the entered face (-1 when inside).
+bool SlabRay(const Vec3& origin, const Vec3& invDir, const Vec3& bmin, const Vec3& bmax,
+             float maxDistance, float& distance, int& axis) {
+    float tEnter = -RAY_INFINITY, tExit = RAY_INFINITY;
+    axis = -1;
+    for (int a = 0; a < 3; a++) {
+        float t0 = (bmin[a] - origin[a]) * invDir[a];
+        float t1 = (bmax[a] - origin[a]) * invDir[a];
+        if (t0 > t1) std::swap(t0, t1);
+        if (t0 > tEnter) {
+            tEnter = t0;
+            axis = a;
+        }
+        tExit = std::min(tExit, t1);
+    }
+    if (tEnter > tExit || tExit < 0.0f || tEnter > maxDistance) return false;
+
+    if (tEnter < 0.0f) {
+        distance = 0.0f;
+        axis = -1;
+    } else {
+        distance = tEnter;
+    }
+    return true;
+}
+
+// Ray vs 4 boxes at a time: fn(slot) for every active box of the block
+// whose bounds the ray enters before `best` (re-read every 4 boxes, so
+// closer hits found by fn prune the rest of the block)
+template<typename Fn>
+void RayBlock(const WorldBoxBlock& block, const Vec3& origin, const Vec3& invDir,
+              const float& best, Fn&& fn) {
+    const size_t count = block.Size();
+    const AABBSoA& b = block.bounds;
+    size_t i = 0;
+
+#ifdef GENESIS_SSE
+    const __m128 ox = _mm_set1_ps(origin.x), oy = _mm_set1_ps(origin.y), oz = _mm_set1_ps(origin.z);
+    const __m128 ix = _mm_set1_ps(invDir.x), iy = _mm_set1_ps(invDir.y), iz = _mm_set1_ps(invDir.z);
+    const __m128 zero = _mm_setzero_ps();
+
+    for (; i + 4 <= count; i += 4) {
+        __m128 t0 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(&b.minX[i]), ox), ix);
+        __m128 t1 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(&b.maxX[i]), ox), ix);
+        __m128 tEnter = _mm_min_ps(t0, t1);
+        __m128 tExit = _mm_max_ps(t0, t1);
+
+        t0 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(&b.minY[i]), oy), iy);
+        t1 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(&b.maxY[i]), oy), iy);
+        tEnter = _mm_max_ps(tEnter, _mm_min_ps(t0, t1));
+        tExit = _mm_min_ps(tExit, _mm_max_ps(t0, t1));
+
+        t0 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(&b.minZ[i]), oz), iz);
+        t1 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(&b.maxZ[i]), oz), iz);
+        tEnter = _mm_max_ps(tEnter, _mm_min_ps(t0, t1));
+        tExit = _mm_min_ps(tExit, _mm_max_ps(t0, t1));
+
+        __m128 hit = _mm_and_ps(_mm_cmple_ps(_mm_max_ps(tEnter, zero), tExit),
+                                _mm_cmple_ps(tEnter, _mm_set1_ps(best)));
+
+        int mask = _mm_movemask_ps(hit);
+        while (mask) {
+            int k = std::countr_zero(static_cast<unsigned>(mask));
+            mask &= mask - 1;
+            if (block.flags[i + k] & BOX_FLAG_ACTIVE) {
+                fn(i + k);
+            }
+        }
+    }
+#endif
+
+    // Scalar tail (or full loop without SSE)
+    for (; i < count; i++) {
+        if (!(block.flags[i] & BOX_FLAG_ACTIVE)) continue;
+        float distance;
+        int axis;
+        if (SlabRay(origin, invDir, Vec3(b.minX[i], b.minY[i], b.minZ[i]),
+                    Vec3(b.maxX[i], b.maxY[i], b.maxZ[i]), best, distance, axis)) {
+            fn(i);
+        }
+    }
+}
+
+} // anonymous namespace
+
+// Up to 4 rays of a batch, SoA for the packet kernel. Unused lanes keep
+// best = -1 and never hit.
+struct PhysicsWorld::RayPacket {
+    float ox[4], oy[4], oz[4];
+    float ix[4], iy[4], iz[4];
+    float best[4];
+    const RaycastQuery* queries[4];
+    RaycastHit* hits[4];
+
+    Vec3 Origin(int lane) const { return Vec3(ox[lane], oy[lane], oz[lane]); }
+    Vec3 InvDir(int lane) const { return Vec3(ix[lane], iy[lane], iz[lane]); }
+
+    // Narrowphase one candidate for a lane and keep it if it is closer
+    void Test(const PhysicsWorld& world, int lane, uint32_t index) {
+        float distance;
+        Vec3 normal;
+        if (world.RayShape(index, Origin(lane), queries[lane]->direction, InvDir(lane),
+                           best[lane], distance, normal) &&
+            distance < best[lane]) {
+            best[lane] = distance;
+            hits[lane]->collider = index;
+            hits[lane]->distance = distance;
+            hits[lane]->normal = normal;
+        }
+    }
+};
+
+// ============================================================================
+// Raycasts
+// ============================================================================
+
+void PhysicsWorld::RaycastBatch(std::span<const RaycastQuery> queries, std::span<RaycastHit> hits) const {
+    for (size_t i = 0; i < queries.size(); i += 4) {
+        RaycastPacket(&queries[i], &hits[i], std::min<size_t>(4, queries.size() - i));
+    }
+}
+
+bool PhysicsWorld::Raycast(const RaycastQuery& query, RaycastHit& hit) const {
+    RaycastPacket(&query, &hit, 1);
+    return hit.IsHit();
+}
+
+void PhysicsWorld::RaycastBatchParallel(std::span<const RaycastQuery> queries, std::span<RaycastHit> hits,
+                                        size_t batchSize) const {
+    ParallelFor(queries.size(), batchSize, [&](size_t begin, size_t end) {
+        RaycastBatch(queries.subspan(begin, end - begin), hits.subspan(begin, end - begin));
+    });
+}
+
+void PhysicsWorld::RaycastPacket(const RaycastQuery* queries, RaycastHit* hits, size_t count) const {
+    RayPacket packet{};
+    int rayLanes = 0;
+    uint32_t layers = 0;
+
+    for (int lane = 0; lane < 4; lane++) {
+        packet.best[lane] = -1.0f;
+        if (lane >= static_cast<int>(count)) continue;
+
+        const RaycastQuery& query = queries[lane];
+        hits[lane] = RaycastHit();
+        hits[lane].distance = query.maxDistance;
+
+        if (query.halfExtents.x > 0.0f || query.halfExtents.y > 0.0f || query.halfExtents.z > 0.0f) {
+            BoxCast(query, hits[lane]);
+            continue;
+        }
+
+        Vec3 invDir = SafeInverse(query.direction);
+        packet.ox[lane] = query.origin.x; packet.oy[lane] = query.origin.y; packet.oz[lane] = query.origin.z;
+        packet.ix[lane] = invDir.x; packet.iy[lane] = invDir.y; packet.iz[lane] = invDir.z;
+        packet.best[lane] = query.maxDistance;
+        packet.queries[lane] = &query;
+        packet.hits[lane] = &hits[lane];
+        rayLanes |= 1 << lane;
+        layers |= query.layerMask;
+    }
+
+    for (layers &= m_usedLayers; layers != 0; layers &= layers - 1) {
+        int layer = std::countr_zero(layers);
+        int lanes = 0;
+        for (int lane = 0; lane < 4; lane++) {
+            if ((rayLanes & (1 << lane)) && (packet.queries[lane]->layerMask & (1u << layer))) {
+                lanes |= 1 << lane;
+            }
+        }
+        if (lanes == 0) continue;
+
+        const LayerGrid& grid = m_grids[layer];
+        if (grid.largeBoxes.Size() > 0) {
+            RaycastLargeBoxes(grid, packet, lanes);
+        }
+        if (!grid.cells.empty()) {
+            for (int lane = 0; lane < 4; lane++) {
+                if (lanes & (1 << lane)) RaycastCells(grid, packet, lane);
+            }
+        }
+    }
+
+    for (size_t lane = 0; lane < count; lane++) {
+        RaycastHit& hit = hits[lane];
+        if (hit.IsHit()) {
+            hit.point = queries[lane].origin + queries[lane].direction * hit.distance;
+        }
+    }
+}
+
+// A layer's large boxes against the whole packet: one box per iteration,
+// the 4 rays in the SSE lanes
+void PhysicsWorld::RaycastLargeBoxes(const LayerGrid& grid, RayPacket& packet, int lanes) const {
+    const WorldBoxBlock& block = grid.largeBoxes;
+    const AABBSoA& b = block.bounds;
+
+#ifdef GENESIS_SSE
+    const __m128 ox = _mm_loadu_ps(packet.ox), oy = _mm_loadu_ps(packet.oy), oz = _mm_loadu_ps(packet.oz);
+    const __m128 ix = _mm_loadu_ps(packet.ix), iy = _mm_loadu_ps(packet.iy), iz = _mm_loadu_ps(packet.iz);
+    const __m128 zero = _mm_setzero_ps();
+#endif
+
+    for (size_t slot = 0; slot < block.Size(); slot++) {
+        if (!(block.flags[slot] & BOX_FLAG_ACTIVE)) continue;
+
+        int mask = 0;
+#ifdef GENESIS_SSE
+        __m128 t0 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(b.minX[slot]), ox), ix);
+        __m128 t1 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(b.maxX[slot]), ox), ix);
+        __m128 tEnter = _mm_min_ps(t0, t1);
+        __m128 tExit = _mm_max_ps(t0, t1);
+
+        t0 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(b.minY[slot]), oy), iy);
+        t1 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(b.maxY[slot]), oy), iy);
+        tEnter = _mm_max_ps(tEnter, _mm_min_ps(t0, t1));
+        tExit = _mm_min_ps(tExit, _mm_max_ps(t0, t1));
+
+        t0 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(b.minZ[slot]), oz), iz);
+        t1 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(b.maxZ[slot]), oz), iz);
+        tEnter = _mm_max_ps(tEnter, _mm_min_ps(t0, t1));
+        tExit = _mm_min_ps(tExit, _mm_max_ps(t0, t1));
+
+        __m128 hit = _mm_and_ps(_mm_cmple_ps(_mm_max_ps(tEnter, zero), tExit),
+                                _mm_cmple_ps(tEnter, _mm_loadu_ps(packet.best)));
+        mask = _mm_movemask_ps(hit) & lanes;
+#else
+        Vec3 bmin(b.minX[slot], b.minY[slot], b.minZ[slot]);
+        Vec3 bmax(b.maxX[slot], b.maxY[slot], b.maxZ[slot]);
+        for (int lane = 0; lane < 4; lane++) {
+            float distance;
+            int axis;
+            if ((lanes & (1 << lane)) &&
+                SlabRay(packet.Origin(lane), packet.InvDir(lane), bmin, bmax, packet.best[lane], distance, axis)) {
+                mask |= 1 << lane;
+            }
+        }
+#endif
+
+        while (mask) {
+            int lane = std::countr_zero(static_cast<unsigned>(mask));
+            mask &= mask - 1;
+            packet.Test(*this, lane, block.indices[slot]);
+        }
+    }
+}
+
+// Walk the grid cells under one ray in order (2D DDA over XZ, clipped to
+// the layer's occupied cell range). A hit at distance t lies in the cell
+// the ray is crossing at t, so once the closest hit is no further than the
+// current cell's exit, no later cell can beat it.
+void PhysicsWorld::RaycastCells(const LayerGrid& grid, RayPacket& packet, int lane) const {
+    const Vec3 origin = packet.Origin(lane);
+    const Vec3 invDir = packet.InvDir(lane);
+
+    float tStart = 0.0f;
+    float tEnd = packet.best[lane];
+    auto clip = [&](float o, float inv, float lo, float hi) {
+        float t0 = (lo - o) * inv, t1 = (hi - o) * inv;
+        if (t0 > t1) std::swap(t0, t1);
+        tStart = std::max(tStart, t0);
+        tEnd = std::min(tEnd, t1);
+    };
+    clip(origin.x, invDir.x, grid.minCellX * m_cellSize, (grid.maxCellX + 1) * m_cellSize);
+    clip(origin.z, invDir.z, grid.minCellZ * m_cellSize, (grid.maxCellZ + 1) * m_cellSize);
+    if (tStart > tEnd) return;
+
+    const Vec3 direction = packet.queries[lane]->direction;
+    Vec3 start = origin + direction * tStart;
+    int32_t cx = std::clamp(CellCoord(start.x), grid.minCellX, grid.maxCellX);
+    int32_t cz = std::clamp(CellCoord(start.z), grid.minCellZ, grid.maxCellZ);
+
+    const int32_t stepX = invDir.x >= 0.0f ? 1 : -1;
+    const int32_t stepZ = invDir.z >= 0.0f ? 1 : -1;
+    const float deltaX = m_cellSize * std::abs(invDir.x);
+    const float deltaZ = m_cellSize * std::abs(invDir.z);
+    float nextX = ((cx + (stepX > 0 ? 1 : 0)) * m_cellSize - origin.x) * invDir.x;
+    float nextZ = ((cz + (stepZ > 0 ? 1 : 0)) * m_cellSize - origin.z) * invDir.z;
+
+    for (;;) {
+        auto it = grid.cells.find(CellKey(cx, cz));
+        if (it != grid.cells.end()) {
+            const WorldBoxBlock& block = it->second;
+            RayBlock(block, origin, invDir, packet.best[lane], [&](size_t slot) {
+                packet.Test(*this, lane, block.indices[slot]);
+            });
+        }
+
+        float cellExit = std::min(nextX, nextZ);
+        if (packet.best[lane] <= cellExit || cellExit >= tEnd) break;
+
+        if (nextX < nextZ) {
+            cx += stepX;
+            nextX += deltaX;
+            if (cx < grid.minCellX || cx > grid.maxCellX) break;
+        } else {
+            cz += stepZ;
+            nextZ += deltaZ;
+            if (cz < grid.minCellZ || cz > grid.maxCellZ) break;
+        }
+    }
+}
+
+// Box cast: a ray against every box of the swept bounds, each expanded by
+// the cast's half extents (exact for boxes, conservative for other shapes)
+void PhysicsWorld::BoxCast(const RaycastQuery& query, RaycastHit& hit) const {
+    const Vec3& h = query.halfExtents;
+    const Vec3 end = query.origin + query.direction * query.maxDistance;
+    const Vec3 qmin(std::min(query.origin.x, end.x) - h.x, std::min(query.origin.y, end.y) - h.y,
+                    std::min(query.origin.z, end.z) - h.z);
+    const Vec3 qmax(std::max(query.origin.x, end.x) + h.x, std::max(query.origin.y, end.y) + h.y,
+                    std::max(query.origin.z, end.z) + h.z);
+    const Vec3 invDir = SafeInverse(query.direction);
+
+    ForEachOverlap(qmin, qmax, BOX_FLAG_ACTIVE, query.layerMask, [&](uint32_t index) {
+        AABB bounds = m_bounds.Get(index);
+        float distance;
+        int axis;
+        if (!SlabRay(query.origin, invDir, bounds.min - h, bounds.max + h, hit.distance, distance, axis)) return;
+        if (hit.IsHit() && distance >= hit.distance) return;
+
+        hit.collider = index;
+        hit.distance = distance;
+        hit.normal = -query.direction;
+        if (axis >= 0) {
+            hit.normal = Vec3(0.0f);
+            hit.normal[axis] = invDir[axis] > 0.0f ? -1.0f : 1.0f;
+        }
+    });
+
+    if (hit.IsHit()) {
+        hit.point = query.origin + query.direction * hit.distance;
+    }
+}
+
+// Exact ray test for one collider
+bool PhysicsWorld::RayShape(uint32_t index, const Vec3& origin, const Vec3& direction, const Vec3& invDir,
+                            float maxDistance, float& distance, Vec3& normal) const {
+    int axis;
+    switch (m_shapes[index].type) {
+        case ShapeType::OrientedBox: {
+            // Slab test in the box's frame
+            const OrientedBoxShape& obb = m_orientedBoxes[m_shapes[index].index];
+            Vec3 d = origin - obb.center;
+            Vec3 localOrigin(Math::Dot(d, obb.axes[0]), Math::Dot(d, obb.axes[1]), Math::Dot(d, obb.axes[2]));
+            Vec3 localDir(Math::Dot(direction, obb.axes[0]), Math::Dot(direction, obb.axes[1]),
+                          Math::Dot(direction, obb.axes[2]));
+            Vec3 localInv = SafeInverse(localDir);
+            if (!SlabRay(localOrigin, localInv, -obb.halfExtents, obb.halfExtents, maxDistance, distance, axis)) {
+                return false;
+            }
+            normal = axis >= 0 ? obb.axes[axis] * (localInv[axis] > 0.0f ? -1.0f : 1.0f) : -direction;
+            return true;
+        }
+        case ShapeType::Sphere: {
+            const SphereShape& sphere = m_spheres[m_shapes[index].index];
+            Vec3 m = origin - sphere.center;
+            float b = Math::Dot(m, direction);
+            float c = Math::Dot(m, m) - sphere.radius * sphere.radius;
+            if (c > 0.0f && b > 0.0f) return false;   // Outside, pointing away
+            float discriminant = b * b - c;
+            if (discriminant < 0.0f) return false;
+
+            distance = -b - std::sqrt(discriminant);
+            if (distance < 0.0f) {
+                distance = 0.0f;
+                normal = -direction;
+                return true;
+            }
+            if (distance > maxDistance) return false;
+            normal = (m + direction * distance) / sphere.radius;
+            return true;
+        }
+        default: {
+            AABB bounds = m_bounds.Get(index);
+            if (!SlabRay(origin, invDir, bounds.min, bounds.max, maxDistance, distance, axis)) return false;
+            normal = -direction;
+            if (axis >= 0) {
+                normal = Vec3(0.0f);
+                normal[axis] = invDir[axis] > 0.0f ? -1.0f : 1.0f;
+            }
+            return true;
+        }
+    }
+}
+
+} // namespace Genesis
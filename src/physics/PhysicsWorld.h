@@ -0,0 +1,1475 @@
+#pragma once
+
+#include "math/Math.h"
+#include "physics/Collider.h"
+#include "physics/CapsuleCollision.h"
+#include "player/PlayerController.h"
+#include "core/SlotMap.h"
+#include "core/FrameArena.h"
+#include <algorithm>
+#include <bit>
+#include <utility>
+#include <span>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <cmath>
+#include <limits>
+
+namespace Genesis {
+
+// ============================================================================
+// World Box Tags - Identifies special geometry types
+// ============================================================================
+enum class BoxTag {
+    Default,    // Normal collision box
+    Stair,      // Auto-climb stair step
+    Ramp,       // Smooth ramp (future use)
+    Platform,   // Moving platform (AddPlatform / MoveCollider)
+    Trigger     // Non-solid trigger volume (always CollisionLayer::Trigger)
+};
+
+// ============================================================================
+// World Box - A collidable box in the world
+// ============================================================================
+struct WorldBox {
+    Vec3 center;
+    Vec3 halfExtents;
+    bool isSolid = true;  // Can be walked on and collided with
+    BoxTag tag = BoxTag::Default;
+    CollisionLayer layer = CollisionLayer::Static;  // One layer (lowest bit used)
+
+    WorldBox() = default;
+    // A trigger-tagged box is non-solid and lives in the trigger layer
+    WorldBox(const Vec3& c, const Vec3& he, BoxTag t = BoxTag::Default)
+        : center(c), halfExtents(he), isSolid(t != BoxTag::Trigger), tag(t),
+          layer(t == BoxTag::Trigger ? CollisionLayer::Trigger : CollisionLayer::Static) {}
+
+    AABB GetAABB() const {
+        return AABB(center - halfExtents, center + halfExtents);
+    }
+
+    float GetTop() const { return center.y + halfExtents.y; }
+    float GetBottom() const { return center.y - halfExtents.y; }
+    bool IsStair() const { return tag == BoxTag::Stair; }
+};
+
+// ============================================================================
+// Box Flags - Packed per-box bits tested alongside the SoA bounds
+// ============================================================================
+enum BoxFlags : uint8_t {
+    BOX_FLAG_SOLID = 1 << 0,
+    BOX_FLAG_STAIR = 1 << 1,
+    BOX_FLAG_ACTIVE = 1 << 2   // Cleared on RemoveBox (slot free for reuse)
+};
+
+// ============================================================================
+// Collision Masks - CollisionLayer bits selecting which layers a query visits
+// ============================================================================
+constexpr uint32_t COLLISION_MASK_ALL = 0xFFFFFFFFu;
+
+// Everything with a physical response (gameplay query default)
+constexpr uint32_t COLLISION_MASK_SOLID = ~static_cast<uint32_t>(CollisionLayer::Trigger);
+
+// What player movement collides with: triggers, debris and projectiles are
+// never visited by the player queries
+constexpr uint32_t COLLISION_MASK_PLAYER = static_cast<uint32_t>(
+    CollisionLayer::Default | CollisionLayer::Static | CollisionLayer::Dynamic);
+
+// ============================================================================
+// Box Block - SoA bounds + flags for a set of boxes
+//
+// indices[i] is the box index in PhysicsWorld; bounds/flags are copies so
+// each block can be scanned contiguously, 4 boxes per SSE compare.
+// ============================================================================
+struct WorldBoxBlock {
+    std::vector<uint32_t> indices;
+    AABBSoA bounds;
+    std::vector<uint8_t> flags;
+
+    size_t Size() const { return indices.size(); }
+
+    void Push(uint32_t index, const Vec3& bmin, const Vec3& bmax, uint8_t boxFlags) {
+        indices.push_back(index);
+        bounds.Push(bmin, bmax);
+        flags.push_back(boxFlags);
+    }
+
+    // O(1) removal of one slot (order is not preserved)
+    void RemoveAt(size_t slot) {
+        indices[slot] = indices.back();
+        indices.pop_back();
+        bounds.SwapRemove(slot);
+        flags[slot] = flags.back();
+        flags.pop_back();
+    }
+
+    void Clear() {
+        indices.clear();
+        bounds.Clear();
+        flags.clear();
+    }
+};
+
+// ============================================================================
+// Collider Shapes - One array per shape type, no virtual dispatch
+//
+// Every collider also has a WorldBox holding its world bounds, and the
+// broadphase and player queries work on those. Oriented boxes and spheres
+// keep their exact shape here for the gameplay queries (ContainsPoint,
+// QueryAABB).
+// ============================================================================
+enum class ShapeType : uint8_t {
+    Box,            // Axis-aligned: the WorldBox is the shape
+    OrientedBox,
+    Sphere
+};
+
+struct OrientedBoxShape {
+    Vec3 center;
+    Vec3 axes[3];        // Unit world-space axes
+    Vec3 halfExtents;    // Along axes
+    uint32_t collider;   // Owning collider index
+};
+
+struct SphereShape {
+    Vec3 center;
+    float radius;
+    uint32_t collider;
+};
+
+// Collider index + generation; stops resolving once the collider is removed
+// or the world cleared
+using ColliderHandle = SlotHandle;
+
+// ============================================================================
+// Batched Query Inputs - One entry per agent (PlayerControllerSystem)
+// ============================================================================
+struct GroundQuery {
+    float x, z;
+    float playerY;
+    float radius;
+};
+
+struct StairClimbQuery {
+    float x, z;
+    float playerY;
+    float radius;
+    float maxHeight;
+    Vec3 moveDir;
+};
+
+struct SweepQuery {
+    AABB bounds;
+    Vec3 delta;
+    float maxClimbHeight;
+};
+
+struct PenetrationQuery {
+    AABB bounds;
+    float maxClimbHeight;
+};
+
+// ============================================================================
+// Raycast Queries - Gameplay rays and box casts (RaycastBatch)
+// ============================================================================
+struct RaycastQuery {
+    Vec3 origin;
+    Vec3 direction;                     // Normalized
+    float maxDistance = 1000.0f;
+    Vec3 halfExtents = Vec3(0.0f);      // Non-zero: cast a box of this size
+    uint32_t layerMask = COLLISION_MASK_SOLID;
+};
+
+struct RaycastHit {
+    static constexpr uint32_t INVALID = 0xFFFFFFFFu;
+
+    uint32_t collider = INVALID;        // Collider index (GetHandle for a handle)
+    float distance = 0.0f;              // maxDistance on a miss
+    Vec3 point = Vec3(0.0f);            // Ray: hit point; box cast: box center at contact
+    Vec3 normal = Vec3(0.0f);           // Surface normal (-direction when starting inside)
+
+    bool IsHit() const { return collider != INVALID; }
+};
+
+// ============================================================================
+// Physics World - Every static collider, behind one broadphase
+//
+// Map brushes, colliders of static render objects (StaticWorldRenderer)
+// and game-added boxes are stored here once and serve both the player
+// controller and gameplay queries. Box indices are collider indices.
+//
+// Boxes are bucketed into a uniform XZ hash grid so every query only touches
+// boxes near the player. Boxes spanning too many cells (large floors) live in
+// a short "large" block that is always tested. Bounds are stored precomputed
+// as SoA, so the inner loops never rebuild an AABB from center/halfExtents.
+//
+// Each CollisionLayer has its own grid, and queries take a layer mask: only
+// the grids of layers in the mask are visited, so a trigger query never
+// scans world geometry and player movement never scans trigger volumes.
+//
+// Box indices are stable: RemoveBox() frees a slot (reused by later adds)
+// instead of shifting the arrays, so callers can keep indices for updates.
+// ============================================================================
+class PhysicsWorld {
+public:
+    static PhysicsWorld& Instance() {
+        static PhysicsWorld instance;
+        return instance;
+    }
+
+    // ========================================================================
+    // Box Management
+    // ========================================================================
+    void Clear() {
+        // Indices restart at 0; generations carry on so old handles die
+        for (uint32_t& generation : m_generations) {
+            generation++;
+        }
+        m_boxes.clear();
+        m_bounds.Clear();
+        m_flags.clear();
+        m_shapes.clear();
+        m_userData.clear();
+        m_velocities.clear();
+        m_movingBoxes = 0;
+        m_orientedBoxes.clear();
+        m_spheres.clear();
+        m_layers.clear();
+        m_freeBoxes.clear();
+        for (LayerGrid& grid : m_grids) {
+            grid.Clear();
+        }
+        for (uint32_t& revision : m_layerRevisions) {
+            revision++;
+        }
+        m_usedLayers = 0;
+    }
+
+    // Add a box, returning its (stable) index
+    uint32_t AddWorldBox(const WorldBox& box) {
+        return Insert(box);
+    }
+
+    // Replace a box in place (any shape becomes a box); only the grid cells
+    // it touches are updated
+    void UpdateBox(uint32_t index, const WorldBox& input) {
+        if (!IsBoxActive(index)) return;
+        WorldBox box = Normalized(input);
+        RemoveFromGrid(index);
+        FreeShape(index);
+        m_boxes[index] = box;
+        m_bounds.Set(index, box.center - box.halfExtents, box.center + box.halfExtents);
+        m_flags[index] = MakeFlags(box);
+        m_layers[index] = LayerIndex(box.layer);
+        AddToGrid(index);
+    }
+
+    // Remove a collider of any shape; its index is recycled by a later add
+    void RemoveBox(uint32_t index) {
+        if (!IsBoxActive(index)) return;
+        RemoveFromGrid(index);
+        FreeShape(index);
+        m_boxes[index] = WorldBox();
+        m_boxes[index].isSolid = false;
+        m_flags[index] = 0;
+        m_userData[index] = 0;
+        SetVelocity(index, Vec3(0.0f));
+        m_generations[index]++;
+        m_freeBoxes.push_back(index);
+    }
+
+    bool IsBoxActive(uint32_t index) const {
+        return index < m_flags.size() && (m_flags[index] & BOX_FLAG_ACTIVE) != 0;
+    }
+
+    // Boxes in use (GetBoxes() also holds freed slots, marked non-solid)
+    size_t GetActiveBoxCount() const { return m_boxes.size() - m_freeBoxes.size(); }
+
+    void AddBox(const Vec3& center, const Vec3& halfExtents) {
+        Insert(WorldBox(center, halfExtents));
+    }
+
+    // Add a box from position and size (like DrawCube uses)
+    void AddCube(float x, float y, float z, float size) {
+        float half = size * 0.5f;
+        Insert(WorldBox(Vec3(x, y, z), Vec3(half, half, half)));
+    }
+
+    // Add a box from center position and dimensions (width, height, depth)
+    void AddBox(float x, float y, float z, float width, float height, float depth) {
+        Insert(WorldBox(Vec3(x, y, z), Vec3(width * 0.5f, height * 0.5f, depth * 0.5f)));
+    }
+
+    // Add a stair step (auto-climbable)
+    void AddStair(float x, float y, float z, float width, float height, float depth) {
+        Insert(WorldBox(Vec3(x, y, z), Vec3(width * 0.5f, height * 0.5f, depth * 0.5f), BoxTag::Stair));
+    }
+
+    // Add a cube as a stair step
+    void AddStairCube(float x, float y, float z, float size) {
+        float half = size * 0.5f;
+        Insert(WorldBox(Vec3(x, y, z), Vec3(half, half, half), BoxTag::Stair));
+    }
+
+    // Indexed by box index; freed slots and triggers have isSolid == false
+    // (IsBoxActive tells them apart). Non-box shapes show their bounds.
+    const std::vector<WorldBox>& GetBoxes() const { return m_boxes; }
+
+    // ========================================================================
+    // Colliders - Typed shapes with handles and user data
+    // ========================================================================
+
+    // Store a Collider description placed by transform (its virtual methods
+    // are only used here, never per query). Axis-aligned boxes become boxes,
+    // rotated ones oriented boxes. Capsule and mesh colliders are kept as
+    // their world bounds. Stair / trigger flags and the layer carry over
+    // (triggers always go to CollisionLayer::Trigger).
+    ColliderHandle AddCollider(const Collider& collider, const Mat4& transform, uint64_t userData = 0) {
+        BoxTag tag = collider.IsTrigger() ? BoxTag::Trigger
+                   : collider.IsStair() ? BoxTag::Stair : BoxTag::Default;
+        CollisionLayer layer = collider.IsTrigger() ? CollisionLayer::Trigger : collider.GetLayer();
+
+        ColliderHandle handle;
+        switch (collider.GetType()) {
+            case ColliderType::None:
+                return ColliderHandle();
+
+            case ColliderType::Box: {
+                const Vec3& h = static_cast<const BoxCollider&>(collider).GetHalfExtents();
+                Vec3 axes[3] = { Vec3(transform[0]), Vec3(transform[1]), Vec3(transform[2]) };
+                if (IsAxisAligned(axes)) {
+                    handle = AddShapeBox(MakeBox(collider.GetWorldAABB(transform), tag, layer));
+                } else {
+                    Vec3 halfExtents;
+                    for (int axis = 0; axis < 3; axis++) {
+                        float scale = Math::Length(axes[axis]);
+                        halfExtents[axis] = h[axis] * scale;
+                        axes[axis] = scale > 0.0f ? axes[axis] / scale : Vec3(0.0f);
+                    }
+                    handle = AddOrientedBox(Vec3(transform[3]), halfExtents, axes, tag, layer);
+                }
+                break;
+            }
+
+            case ColliderType::Sphere:
+                handle = AddSphere(Vec3(transform[3]),
+                                   static_cast<const SphereCollider&>(collider).GetRadius(), tag, layer);
+                break;
+
+            default:
+                handle = AddShapeBox(MakeBox(collider.GetWorldAABB(transform), tag, layer));
+                break;
+        }
+        m_userData[handle.index] = userData;
+        return handle;
+    }
+
+    ColliderHandle AddOrientedBox(const Vec3& center, const Vec3& halfExtents, const Vec3 axes[3],
+                                  BoxTag tag = BoxTag::Default,
+                                  CollisionLayer layer = CollisionLayer::Static) {
+        // Bounds: each world axis gets |axis| * halfExtent from every local axis
+        Vec3 extent(0.0f);
+        for (int axis = 0; axis < 3; axis++) {
+            extent += glm::abs(axes[axis]) * halfExtents[axis];
+        }
+        ColliderHandle handle = AddShapeBox(MakeBox(AABB(center - extent, center + extent), tag, layer));
+        m_shapes[handle.index] = { ShapeType::OrientedBox, static_cast<uint32_t>(m_orientedBoxes.size()) };
+        m_orientedBoxes.push_back({ center, { axes[0], axes[1], axes[2] }, halfExtents, handle.index });
+        return handle;
+    }
+
+    ColliderHandle AddSphere(const Vec3& center, float radius, BoxTag tag = BoxTag::Default,
+                             CollisionLayer layer = CollisionLayer::Static) {
+        ColliderHandle handle = AddShapeBox(MakeBox(AABB(center - Vec3(radius), center + Vec3(radius)), tag, layer));
+        m_shapes[handle.index] = { ShapeType::Sphere, static_cast<uint32_t>(m_spheres.size()) };
+        m_spheres.push_back({ center, radius, handle.index });
+        return handle;
+    }
+
+    void RemoveCollider(ColliderHandle handle) {
+        if (IsAlive(handle)) RemoveBox(handle.index);
+    }
+
+    ColliderHandle GetHandle(uint32_t index) const {
+        if (!IsBoxActive(index)) return ColliderHandle();
+        ColliderHandle handle;
+        handle.index = index;
+        handle.generation = m_generations[index];
+        return handle;
+    }
+
+    bool IsAlive(ColliderHandle handle) const {
+        return IsBoxActive(handle.index) && m_generations[handle.index] == handle.generation;
+    }
+
+    ShapeType GetShapeType(uint32_t index) const { return m_shapes[index].type; }
+    CollisionLayer GetLayer(uint32_t index) const { return m_boxes[index].layer; }
+
+    // Bumped whenever a collider of the layer is added, moved or removed, so
+    // systems caching query results (TriggerSystem) know when to re-query
+    uint32_t GetLayerRevision(CollisionLayer layer) const { return m_layerRevisions[LayerIndex(layer)]; }
+
+    // Owner-defined tag (MapRenderer: brush id, StaticWorldRenderer: object)
+    uint64_t GetUserData(uint32_t index) const { return m_userData[index]; }
+    void SetUserData(uint32_t index, uint64_t userData) {
+        if (IsBoxActive(index)) m_userData[index] = userData;
+    }
+
+    size_t GetOrientedBoxCount() const { return m_orientedBoxes.size(); }
+    size_t GetSphereCount() const { return m_spheres.size(); }
+
+    // ========================================================================
+    // Moving Colliders (platforms, elevators, doors)
+    // ========================================================================
+    // A mover is an ordinary collider that the game translates every tick;
+    // nothing is rebuilt for it. The box's grid cells are refit in place
+    // while it spans the same cells and reinserted only when it crosses
+    // into new ones, so the cost scales with the movers, not the world.
+
+    ColliderHandle AddPlatform(const Vec3& center, const Vec3& halfExtents,
+                               CollisionLayer layer = CollisionLayer::Dynamic) {
+        WorldBox box(center, halfExtents, BoxTag::Platform);
+        box.layer = layer;
+        return AddShapeBox(box);
+    }
+
+    // Translate a collider of any shape by delta. Its velocity becomes
+    // delta / deltaTime (players standing on it inherit it), so move each
+    // platform every tick, with a zero delta while it stands still.
+    void MoveCollider(ColliderHandle handle, const Vec3& delta, float deltaTime) {
+        if (!IsAlive(handle)) return;
+        uint32_t index = handle.index;
+
+        SetVelocity(index, deltaTime > 0.0f ? delta / deltaTime : Vec3(0.0f));
+        if (delta == Vec3(0.0f)) return;
+
+        m_boxes[index].center += delta;
+        if (m_shapes[index].type == ShapeType::OrientedBox) {
+            m_orientedBoxes[m_shapes[index].index].center += delta;
+        } else if (m_shapes[index].type == ShapeType::Sphere) {
+            m_spheres[m_shapes[index].index].center += delta;
+        }
+
+        AABB oldBounds = m_bounds.Get(index);
+        AABB newBounds(oldBounds.min + delta, oldBounds.max + delta);
+        if (CellCoord(oldBounds.min.x) == CellCoord(newBounds.min.x) &&
+            CellCoord(oldBounds.max.x) == CellCoord(newBounds.max.x) &&
+            CellCoord(oldBounds.min.z) == CellCoord(newBounds.min.z) &&
+            CellCoord(oldBounds.max.z) == CellCoord(newBounds.max.z)) {
+            m_bounds.Set(index, newBounds.min, newBounds.max);
+            RefitInGrid(index);
+        } else {
+            RemoveFromGrid(index);
+            m_bounds.Set(index, newBounds.min, newBounds.max);
+            AddToGrid(index);
+        }
+    }
+
+    // World velocity of a collider (zero unless moved by MoveCollider)
+    Vec3 GetBoxVelocity(uint32_t index) const {
+        return index < m_velocities.size() ? m_velocities[index] : Vec3(0.0f);
+    }
+
+    // Zero once the collider is gone, even if its slot was reused since
+    Vec3 GetBoxVelocity(ColliderHandle handle) const {
+        return IsAlive(handle) ? m_velocities[handle.index] : Vec3(0.0f);
+    }
+
+    // Colliders with a non-zero velocity
+    uint32_t GetMovingBoxCount() const { return m_movingBoxes; }
+
+    // ========================================================================
+    // Gameplay Queries - Exact shapes
+    // ========================================================================
+
+    // Narrowphase for one collider
+    bool ContainsPoint(uint32_t index, const Vec3& point) const {
+        switch (m_shapes[index].type) {
+            case ShapeType::OrientedBox: {
+                const OrientedBoxShape& obb = m_orientedBoxes[m_shapes[index].index];
+                Vec3 d = point - obb.center;
+                for (int axis = 0; axis < 3; axis++) {
+                    if (std::abs(Math::Dot(d, obb.axes[axis])) > obb.halfExtents[axis]) return false;
+                }
+                return true;
+            }
+            case ShapeType::Sphere: {
+                const SphereShape& sphere = m_spheres[m_shapes[index].index];
+                Vec3 d = point - sphere.center;
+                return Math::Dot(d, d) <= sphere.radius * sphere.radius;
+            }
+            default:
+                return m_bounds.Get(index).Contains(point);
+        }
+    }
+
+    bool OverlapsAABB(uint32_t index, const AABB& box) const {
+        switch (m_shapes[index].type) {
+            case ShapeType::OrientedBox:
+                return OverlapOrientedBox(m_orientedBoxes[m_shapes[index].index], box);
+            case ShapeType::Sphere: {
+                const SphereShape& sphere = m_spheres[m_shapes[index].index];
+                Vec3 closest = glm::clamp(sphere.center, box.min, box.max);
+                Vec3 d = closest - sphere.center;
+                return Math::Dot(d, d) <= sphere.radius * sphere.radius;
+            }
+            default:
+                return m_bounds.Get(index).Intersects(box);
+        }
+    }
+
+    // fn(uint32_t index) for every collider in layerMask whose shape
+    // overlaps box (e.g. CollisionLayer::Trigger for trigger volumes only)
+    template<typename Fn>
+    void QueryAABB(const AABB& box, Fn&& fn, uint32_t layerMask = COLLISION_MASK_SOLID) const {
+        ForEachOverlap(box.min, box.max, BOX_FLAG_ACTIVE, layerMask, [&](uint32_t index) {
+            if (m_shapes[index].type == ShapeType::Box || OverlapsAABB(index, box)) {
+                fn(index);
+            }
+        });
+    }
+
+    std::vector<uint32_t> QueryAABB(const AABB& box, uint32_t layerMask = COLLISION_MASK_SOLID) const {
+        std::vector<uint32_t> result;
+        QueryAABB(box, [&](uint32_t index) { result.push_back(index); }, layerMask);
+        return result;
+    }
+
+    // Per-frame variant: the result lives in the arena (valid until its Reset)
+    std::span<const uint32_t> QueryAABB(const AABB& box, FrameArena& arena,
+                                        uint32_t layerMask = COLLISION_MASK_SOLID) const {
+        uint32_t* out = arena.AllocateArray<uint32_t>(GetActiveBoxCount());
+        size_t count = 0;
+        QueryAABB(box, [&](uint32_t index) { out[count++] = index; }, layerMask);
+        return arena.Shrink(out, count);
+    }
+
+    bool PointInAnyCollider(const Vec3& point, uint32_t layerMask = COLLISION_MASK_SOLID) const {
+        bool found = false;
+        ForEachOverlap(point, point, BOX_FLAG_ACTIVE, layerMask, [&](uint32_t index) {
+            if (!found && ContainsPoint(index, point)) {
+                found = true;
+            }
+        });
+        return found;
+    }
+
+    // ========================================================================
+    // Raycasts (PhysicsWorld.cpp)
+    // ========================================================================
+    // Closest hit of each query against the exact collider shapes in its
+    // layerMask; hits[i] answers queries[i]. Rays are processed in packets
+    // of 4: the large boxes of a layer are tested against the whole packet
+    // at once, then each ray walks the grid cells it crosses in order
+    // (testing 4 boxes per SSE compare) and stops at the first cell that
+    // lies past its closest hit. Box casts (halfExtents != 0) sweep the
+    // broadphase with their swept bounds and test each box expanded by the
+    // half extents; spheres and oriented boxes are cast as their bounds.
+    //
+    // Const and allocation-free: any thread may run a batch while the world
+    // is not being modified.
+    void RaycastBatch(std::span<const RaycastQuery> queries, std::span<RaycastHit> hits) const;
+    bool Raycast(const RaycastQuery& query, RaycastHit& hit) const;
+
+    // RaycastBatch split across the JobSystem (AI visibility, hitscan
+    // weapons: hundreds of rays per tick)
+    void RaycastBatchParallel(std::span<const RaycastQuery> queries, std::span<RaycastHit> hits,
+                              size_t batchSize = 64) const;
+
+    // ========================================================================
+    // Broadphase Grid
+    // ========================================================================
+
+    // Change the XZ cell size (rebuilds the grid)
+    void SetCellSize(float size) {
+        if (size <= 0.0f) return;
+        m_cellSize = size;
+        m_invCellSize = 1.0f / size;
+        RebuildGrid();
+    }
+    float GetCellSize() const { return m_cellSize; }
+
+    size_t GetGridCellCount() const {
+        size_t count = 0;
+        for (const LayerGrid& grid : m_grids) count += grid.cells.size();
+        return count;
+    }
+    size_t GetLargeBoxCount() const {
+        size_t count = 0;
+        for (const LayerGrid& grid : m_grids) count += grid.largeBoxes.Size();
+        return count;
+    }
+
+    // SoA bounds, parallel to GetBoxes()
+    const AABBSoA& GetBounds() const { return m_bounds; }
+
+    // Visit every box in a layer of layerMask whose bounds overlap
+    // [qmin, qmax] (inclusive) and whose flags contain all of requiredFlags.
+    // Grids of other layers are never touched. Each box is visited at most
+    // once. fn(uint32_t index)
+    template<typename Fn>
+    void ForEachOverlap(const Vec3& qmin, const Vec3& qmax, uint8_t requiredFlags,
+                        uint32_t layerMask, Fn&& fn) const {
+        for (uint32_t layers = layerMask & m_usedLayers; layers != 0; layers &= layers - 1) {
+            OverlapGrid(m_grids[std::countr_zero(layers)], qmin, qmax, requiredFlags, fn);
+        }
+    }
+
+    // Visit every box whose XZ footprint overlaps the given XZ rectangle.
+    // fn(uint32_t index)
+    template<typename Fn>
+    void ForEachBoxInRegion(float minX, float minZ, float maxX, float maxZ,
+                            uint8_t requiredFlags, uint32_t layerMask, Fn&& fn) const {
+        constexpr float inf = std::numeric_limits<float>::infinity();
+        ForEachOverlap(Vec3(minX, -inf, minZ), Vec3(maxX, inf, maxZ), requiredFlags, layerMask,
+                       std::forward<Fn>(fn));
+    }
+
+    // ========================================================================
+    // Stair Detection
+    // ========================================================================
+    // Check if there's a stair in front of the player that can be auto-climbed
+    // Returns the height to climb to, or -1 if no stair found
+    float GetStairClimbHeight(float x, float z, float playerY, float playerRadius,
+                               float maxStairHeight, const Vec3& moveDir) const {
+        float bestStairTop = -1.0f;
+
+        float checkRadius = playerRadius + 0.1f;
+        float regionX = x + moveDir.x * checkRadius;
+        float regionZ = z + moveDir.z * checkRadius;
+
+        // The region test is exactly the expanded XZ check below
+        ForEachBoxInRegion(regionX - checkRadius, regionZ - checkRadius,
+                           regionX + checkRadius, regionZ + checkRadius,
+                           BOX_FLAG_SOLID | BOX_FLAG_STAIR, COLLISION_MASK_PLAYER, [&](uint32_t index) {
+            float boxTop = m_bounds.maxY[index];
+
+            // Check height constraints:
+            // - Stair top must be above player feet
+            // - Stair must be climbable (not too high)
+            float heightAbovePlayer = boxTop - playerY;
+            if (heightAbovePlayer <= 0.0f || heightAbovePlayer > maxStairHeight) return;
+
+            // Player is approaching/touching this stair horizontally (check area
+            // expanded slightly in movement direction), take the highest valid one
+            if (boxTop > bestStairTop) {
+                bestStairTop = boxTop;
+            }
+        });
+
+        return bestStairTop;
+    }
+
+    // ========================================================================
+    // Ground Height Query
+    // ========================================================================
+    // Returns the highest ground point at the given XZ position that the player can stand on
+    // A box counts as ground only if the player is above or very close to the box's top
+    float GetGroundHeight(float x, float z, float radius = 0.3f, float playerY = 1000.0f) const {
+        ColliderHandle groundBox;
+        return GetGroundHeight(x, z, radius, playerY, groundBox);
+    }
+
+    // Same, also naming the collider the height comes from (an invalid
+    // handle for the floor) so the controller can ride moving platforms
+    float GetGroundHeight(float x, float z, float radius, float playerY, ColliderHandle& groundBox) const {
+        float highestGround = m_floorHeight;
+        uint32_t groundIndex = ColliderHandle::INVALID_INDEX;
+
+        // Use a small inset to prevent standing on the very edge
+        float inset = radius * 0.5f;  // Increased from 0.3f for more reliable edge handling
+
+        // Region test: player CENTER is within the box XZ bounds (expanded by inset)
+        ForEachBoxInRegion(x - inset, z - inset, x + inset, z + inset,
+                           BOX_FLAG_SOLID, COLLISION_MASK_PLAYER, [&](uint32_t index) {
+            float boxTop = m_bounds.maxY[index];
+
+            // Only consider this box as ground if:
+            // 1. The player is above the box top (can land on it)
+            // 2. The player is slightly below the box top (already standing on it or just landed)
+            // Use stricter tolerance (0.3) to prevent teleporting onto boxes from the side
+            if (playerY >= boxTop - 0.3f) {
+                if (boxTop > highestGround) {
+                    highestGround = boxTop;
+                    groundIndex = index;
+                }
+            }
+        });
+
+        groundBox = groundIndex != ColliderHandle::INVALID_INDEX ? GetHandle(groundIndex) : ColliderHandle();
+        return highestGround;
+    }
+
+    // ========================================================================
+    // Collision Query
+    // ========================================================================
+    // Check if an AABB collides with any world geometry
+    // Uses a small "skin" to prevent getting stuck on edges
+    // maxClimbHeight: stairs below this height are ignored (can be climbed)
+    bool CheckCollision(const Vec3& position, const AABB& playerBounds, float maxClimbHeight = 0.5f) const {
+        AABB shrunkBounds = ShrinkPlayerBounds(playerBounds);
+
+        float playerBottom = shrunkBounds.min.y;
+        bool blocked = false;
+
+        // Overlap test is done 4 boxes at a time; only hits reach the callback
+        ForEachOverlap(shrunkBounds.min, shrunkBounds.max, BOX_FLAG_SOLID, COLLISION_MASK_PLAYER,
+                       [&](uint32_t index) {
+            if (!blocked && BlocksSides(index, playerBottom, maxClimbHeight)) {
+                blocked = true;  // Collision with side
+            }
+        });
+        return blocked;
+    }
+
+    // ========================================================================
+    // Swept Collision (Continuous Collision Detection)
+    // ========================================================================
+    // Move playerBounds by delta and report the first box it would enter:
+    // hit.time is the fraction of delta before contact, hit.normal the face
+    // hit. Boxes are filtered as in CheckCollision (same skin, stairs and
+    // standing-on-top rules), so a sweep stops where CheckCollision would
+    // start blocking, but no wall is skipped however long delta is. Boxes
+    // the bounds already sink into are left to GetPenetration.
+    bool SweepAABB(const AABB& playerBounds, const Vec3& delta, SweepHit& hit, float maxClimbHeight = 0.5f) const {
+        hit = SweepHit();
+        AABB start = ShrinkPlayerBounds(playerBounds);
+        float playerBottom = start.min.y;
+        bool found = false;
+
+        // One broadphase query over the whole swept volume
+        Vec3 qmin = glm::min(start.min, start.min + delta);
+        Vec3 qmax = glm::max(start.max, start.max + delta);
+        ForEachOverlap(qmin, qmax, BOX_FLAG_SOLID, COLLISION_MASK_PLAYER, [&](uint32_t index) {
+            if (!BlocksSides(index, playerBottom, maxClimbHeight)) return;
+
+            const float boxMin[3] = { m_bounds.minX[index], m_bounds.minY[index], m_bounds.minZ[index] };
+            const float boxMax[3] = { m_bounds.maxX[index], m_bounds.maxY[index], m_bounds.maxZ[index] };
+
+            // Slab test of the moving box against the static one
+            float tEnter = -std::numeric_limits<float>::infinity();
+            float tExit = std::numeric_limits<float>::infinity();
+            int enterAxis = -1;
+            for (int axis = 0; axis < 3; axis++) {
+                float d = delta[axis];
+                if (d == 0.0f) {
+                    if (start.max[axis] <= boxMin[axis] || start.min[axis] >= boxMax[axis]) return;
+                    continue;
+                }
+                float t0 = (boxMin[axis] - start.max[axis]) / d;
+                float t1 = (boxMax[axis] - start.min[axis]) / d;
+                if (t0 > t1) std::swap(t0, t1);
+                if (t0 > tEnter) {
+                    tEnter = t0;
+                    enterAxis = axis;
+                }
+                tExit = std::min(tExit, t1);
+            }
+            if (enterAxis < 0 || tEnter >= tExit || tExit <= 0.0f || tEnter > hit.time) return;
+
+            // Started inside: a touching contact still blocks, a real overlap
+            // is depenetration's business
+            if (tEnter < 0.0f) {
+                if (-tEnter * std::abs(delta[enterAxis]) > SWEEP_START_TOLERANCE) return;
+                tEnter = 0.0f;
+            }
+
+            hit.time = tEnter;
+            hit.normal = Vec3(0.0f);
+            hit.normal[enterAxis] = delta[enterAxis] > 0.0f ? -1.0f : 1.0f;
+            hit.box = index;
+            found = true;
+        });
+        return found;
+    }
+
+    // ========================================================================
+    // Penetration Query
+    // ========================================================================
+    // Returns the penetration depth and pushout direction if colliding
+    // maxClimbHeight: stairs below this height are ignored (can be climbed)
+    bool GetPenetration(const AABB& playerBounds, Vec3& pushOut, float maxClimbHeight = 0.5f) const {
+        pushOut = Vec3(0.0f);
+        float smallestPenetration = 1000.0f;
+        bool anyCollision = false;
+
+        float playerBottom = playerBounds.min.y;
+
+        // Broadphase overlap is inclusive; the strict overlap test below
+        // rejects boxes that only touch
+        ForEachOverlap(playerBounds.min, playerBounds.max, BOX_FLAG_SOLID, COLLISION_MASK_PLAYER,
+                       [&](uint32_t index) {
+            AABB boxAABB(Vec3(m_bounds.minX[index], m_bounds.minY[index], m_bounds.minZ[index]),
+                         Vec3(m_bounds.maxX[index], m_bounds.maxY[index], m_bounds.maxZ[index]));
+
+            // Check if there's overlap
+            float overlapX = std::min(playerBounds.max.x - boxAABB.min.x, boxAABB.max.x - playerBounds.min.x);
+            float overlapY = std::min(playerBounds.max.y - boxAABB.min.y, boxAABB.max.y - playerBounds.min.y);
+            float overlapZ = std::min(playerBounds.max.z - boxAABB.min.z, boxAABB.max.z - playerBounds.min.z);
+
+            if (overlapX > 0 && overlapY > 0 && overlapZ > 0) {
+                float boxTop = boxAABB.max.y;
+
+                // Skip climbable stairs
+                if (m_flags[index] & BOX_FLAG_STAIR) {
+                    float heightAbovePlayer = boxTop - playerBottom;
+                    if (heightAbovePlayer > 0.0f && heightAbovePlayer <= maxClimbHeight) {
+                        return;  // This stair can be climbed, don't push out
+                    }
+                }
+
+                // We have penetration
+                anyCollision = true;
+
+                // Check if standing on top - don't push horizontally if on top
+                if (playerBottom >= boxTop - 0.1f) {
+                    return; // Standing on top, no horizontal push needed
+                }
+
+                // Find minimum penetration axis (for horizontal only)
+                // Ignore Y axis for pushout to prevent weird vertical behavior
+                float playerCenterX = (playerBounds.min.x + playerBounds.max.x) * 0.5f;
+                float playerCenterZ = (playerBounds.min.z + playerBounds.max.z) * 0.5f;
+                float boxCenterX = (boxAABB.min.x + boxAABB.max.x) * 0.5f;
+                float boxCenterZ = (boxAABB.min.z + boxAABB.max.z) * 0.5f;
+
+                // Determine push direction based on which axis has less overlap
+                if (overlapX < overlapZ) {
+                    float pushDist = overlapX + 0.01f; // Small extra push
+                    if (playerCenterX < boxCenterX) {
+                        if (pushDist < smallestPenetration) {
+                            smallestPenetration = pushDist;
+                            pushOut = Vec3(-pushDist, 0.0f, 0.0f);
+                        }
+                    } else {
+                        if (pushDist < smallestPenetration) {
+                            smallestPenetration = pushDist;
+                            pushOut = Vec3(pushDist, 0.0f, 0.0f);
+                        }
+                    }
+                } else {
+                    float pushDist = overlapZ + 0.01f;
+                    if (playerCenterZ < boxCenterZ) {
+                        if (pushDist < smallestPenetration) {
+                            smallestPenetration = pushDist;
+                            pushOut = Vec3(0.0f, 0.0f, -pushDist);
+                        }
+                    } else {
+                        if (pushDist < smallestPenetration) {
+                            smallestPenetration = pushDist;
+                            pushOut = Vec3(0.0f, 0.0f, pushDist);
+                        }
+                    }
+                }
+            }
+        });
+
+        return anyCollision;
+    }
+
+    // ========================================================================
+    // Capsule Queries - Exact narrowphase (PlayerColliderType::Capsule)
+    // ========================================================================
+    // Same rules as the box versions (stairs, standing on top), but each
+    // broadphase candidate is tested as its exact shape against the capsule,
+    // so no skin is needed: round sides slide past box corners and rotated
+    // brushes collide as rotated boxes, not as their bounds.
+
+    bool CheckCollision(const Capsule& capsule, float maxClimbHeight = 0.5f) const {
+        Vec3 a, b;
+        float radius;
+        capsule.GetSegment(a, b, radius);
+        float contactRadius = radius - CAPSULE_CONTACT_SKIN;
+        AABB bounds = capsule.GetBoundingAABB();
+        bool blocked = false;
+
+        ForEachOverlap(bounds.min, bounds.max, BOX_FLAG_SOLID, COLLISION_MASK_PLAYER, [&](uint32_t index) {
+            if (blocked || !BlocksSides(index, capsule.base.y, maxClimbHeight)) return;
+            blocked = ClosestToCapsule(index, a, b).distanceSq < contactRadius * contactRadius;
+        });
+        return blocked;
+    }
+
+    // Horizontal push out of the shallowest penetrated collider
+    bool GetPenetration(const Capsule& capsule, Vec3& pushOut, float maxClimbHeight = 0.5f) const {
+        pushOut = Vec3(0.0f);
+        Vec3 a, b;
+        float radius;
+        capsule.GetSegment(a, b, radius);
+        AABB bounds = capsule.GetBoundingAABB();
+        float playerBottom = capsule.base.y;
+        float smallestPenetration = std::numeric_limits<float>::infinity();
+        bool anyCollision = false;
+
+        ForEachOverlap(bounds.min, bounds.max, BOX_FLAG_SOLID, COLLISION_MASK_PLAYER, [&](uint32_t index) {
+            float boxTop = m_bounds.maxY[index];
+            if (m_flags[index] & BOX_FLAG_STAIR) {
+                float heightAbovePlayer = boxTop - playerBottom;
+                if (heightAbovePlayer > 0.0f && heightAbovePlayer <= maxClimbHeight) return;
+            }
+
+            CapsuleCollision::ClosestPoints closest = ClosestToCapsule(index, a, b);
+            if (closest.distanceSq >= radius * radius) return;
+            anyCollision = true;
+            if (playerBottom >= boxTop - 0.1f) return;   // Standing on top
+
+            // Push along the horizontal contact normal; a core segment inside
+            // the shape has none, so fall back to the bounds' smallest axis
+            Vec3 normal = closest.segmentPoint - closest.shapePoint;
+            normal.y = 0.0f;
+            float normalLength = Math::Length(normal);
+            Vec3 push;
+            if (closest.distanceSq > 1e-8f && normalLength > 1e-4f) {
+                push = normal / normalLength * (radius - std::sqrt(closest.distanceSq) + 0.01f);
+            } else {
+                AABB box = m_bounds.Get(index);
+                float overlapX = std::min(bounds.max.x - box.min.x, box.max.x - bounds.min.x);
+                float overlapZ = std::min(bounds.max.z - box.min.z, box.max.z - bounds.min.z);
+                Vec3 away = capsule.base - box.GetCenter();
+                push = overlapX < overlapZ ? Vec3(std::copysign(overlapX + 0.01f, away.x), 0.0f, 0.0f)
+                                           : Vec3(0.0f, 0.0f, std::copysign(overlapZ + 0.01f, away.z));
+            }
+
+            float penetration = Math::Length(push);
+            if (penetration < smallestPenetration) {
+                smallestPenetration = penetration;
+                pushOut = push;
+            }
+        });
+        return anyCollision;
+    }
+
+    // ========================================================================
+    // Raycast Query (for ground detection)
+    // ========================================================================
+    // Cast a ray down from a point, return the Y position of the hit
+    bool RaycastDown(const Vec3& origin, float maxDistance, float& hitY) const {
+        hitY = m_floorHeight;
+        bool hit = false;
+
+        // Check floor first
+        if (origin.y >= m_floorHeight && origin.y - maxDistance <= m_floorHeight) {
+            hitY = m_floorHeight;
+            hit = true;
+        }
+
+        // Check boxes under the ray
+        // Region test: the ray is within the XZ bounds of the box
+        ForEachBoxInRegion(origin.x, origin.z, origin.x, origin.z,
+                           BOX_FLAG_SOLID, COLLISION_MASK_PLAYER, [&](uint32_t index) {
+            float boxTop = m_bounds.maxY[index];
+
+            // Is the box top below us and within range?
+            if (boxTop <= origin.y && boxTop >= origin.y - maxDistance) {
+                if (boxTop > hitY) {
+                    hitY = boxTop;
+                    hit = true;
+                }
+            }
+        });
+
+        return hit;
+    }
+
+    // ========================================================================
+    // Batched Queries
+    // ========================================================================
+    // Answer many queries per call (output spans match the input size). Each
+    // entry gives the same result as the single query; the batch keeps the
+    // grid and box arrays hot across entries and replaces one type-erased
+    // callback per agent with one direct call per tick.
+
+    void GetGroundHeights(std::span<const GroundQuery> queries, std::span<float> heights) const {
+        for (size_t i = 0; i < queries.size(); i++) {
+            const GroundQuery& q = queries[i];
+            heights[i] = GetGroundHeight(q.x, q.z, q.radius, q.playerY);
+        }
+    }
+
+    void GetStairClimbHeights(std::span<const StairClimbQuery> queries, std::span<float> heights) const {
+        for (size_t i = 0; i < queries.size(); i++) {
+            const StairClimbQuery& q = queries[i];
+            heights[i] = GetStairClimbHeight(q.x, q.z, q.playerY, q.radius, q.maxHeight, q.moveDir);
+        }
+    }
+
+    // hits[i].box is INVALID (0xFFFFFFFF) when query i is unobstructed
+    void SweepAABBs(std::span<const SweepQuery> queries, std::span<SweepHit> hits) const {
+        for (size_t i = 0; i < queries.size(); i++) {
+            const SweepQuery& q = queries[i];
+            SweepAABB(q.bounds, q.delta, hits[i], q.maxClimbHeight);
+        }
+    }
+
+    // pushOuts[i] is zero when query i needs no push
+    void GetPenetrations(std::span<const PenetrationQuery> queries, std::span<Vec3> pushOuts) const {
+        for (size_t i = 0; i < queries.size(); i++) {
+            const PenetrationQuery& q = queries[i];
+            GetPenetration(q.bounds, pushOuts[i], q.maxClimbHeight);
+        }
+    }
+
+    // ========================================================================
+    // Configuration
+    // ========================================================================
+    void SetFloorHeight(float height) { m_floorHeight = height; }
+    float GetFloorHeight() const { return m_floorHeight; }
+
+private:
+    PhysicsWorld() = default;
+
+    struct ColliderShape {
+        ShapeType type = ShapeType::Box;
+        uint32_t index = 0;   // Into m_orientedBoxes / m_spheres
+    };
+
+    // One broadphase per CollisionLayer bit
+    struct LayerGrid {
+        std::unordered_map<int64_t, WorldBoxBlock> cells;
+        WorldBoxBlock largeBoxes;
+
+        // Cell range that ever received a box (raycasts clip to it; not
+        // shrunk on removal)
+        int32_t minCellX = std::numeric_limits<int32_t>::max();
+        int32_t minCellZ = std::numeric_limits<int32_t>::max();
+        int32_t maxCellX = std::numeric_limits<int32_t>::min();
+        int32_t maxCellZ = std::numeric_limits<int32_t>::min();
+
+        void Clear() {
+            cells.clear();
+            largeBoxes.Clear();
+            minCellX = minCellZ = std::numeric_limits<int32_t>::max();
+            maxCellX = maxCellZ = std::numeric_limits<int32_t>::min();
+        }
+    };
+
+    // Raycast internals (PhysicsWorld.cpp)
+    struct RayPacket;
+    void RaycastPacket(const RaycastQuery* queries, RaycastHit* hits, size_t count) const;
+    void RaycastLargeBoxes(const LayerGrid& grid, RayPacket& packet, int lanes) const;
+    void RaycastCells(const LayerGrid& grid, RayPacket& packet, int lane) const;
+    void BoxCast(const RaycastQuery& query, RaycastHit& hit) const;
+    bool RayShape(uint32_t index, const Vec3& origin, const Vec3& direction, const Vec3& invDir,
+                  float maxDistance, float& distance, Vec3& normal) const;
+
+    template<typename Fn>
+    void OverlapGrid(const LayerGrid& grid, const Vec3& qmin, const Vec3& qmax,
+                     uint8_t requiredFlags, Fn& fn) const {
+        // Large boxes are stored once, no de-duplication needed
+        OverlapBlock(grid.largeBoxes, qmin, qmax, requiredFlags, [&](size_t slot) {
+            fn(grid.largeBoxes.indices[slot]);
+        });
+        if (grid.cells.empty()) return;
+
+        int32_t qMinX = CellCoord(qmin.x), qMaxX = CellCoord(qmax.x);
+        int32_t qMinZ = CellCoord(qmin.z), qMaxZ = CellCoord(qmax.z);
+
+        for (int32_t cz = qMinZ; cz <= qMaxZ; cz++) {
+            for (int32_t cx = qMinX; cx <= qMaxX; cx++) {
+                auto it = grid.cells.find(CellKey(cx, cz));
+                if (it == grid.cells.end()) continue;
+
+                const WorldBoxBlock& block = it->second;
+                OverlapBlock(block, qmin, qmax, requiredFlags, [&](size_t slot) {
+                    // A box is stored in every cell it overlaps; only report it
+                    // from the first cell shared by the box and the query
+                    int32_t firstX = std::max(CellCoord(block.bounds.minX[slot]), qMinX);
+                    int32_t firstZ = std::max(CellCoord(block.bounds.minZ[slot]), qMinZ);
+                    if (cx != firstX || cz != firstZ) return;
+
+                    fn(block.indices[slot]);
+                });
+            }
+        }
+    }
+
+    // Boxes covering more cells than this go into the grid's largeBoxes
+    static constexpr int64_t MAX_CELLS_PER_BOX = 64;
+
+    // Overlap a sweep may start with and still count as touching
+    static constexpr float SWEEP_START_TOLERANCE = 0.01f;
+
+    // A capsule this close to a collider touches it without being blocked
+    static constexpr float CAPSULE_CONTACT_SKIN = 0.01f;
+
+    // Closest points between a capsule core segment and a collider's shape
+    CapsuleCollision::ClosestPoints ClosestToCapsule(uint32_t index, const Vec3& a, const Vec3& b) const {
+        switch (m_shapes[index].type) {
+            case ShapeType::OrientedBox: {
+                const OrientedBoxShape& obb = m_orientedBoxes[m_shapes[index].index];
+                return CapsuleCollision::SegmentOrientedBox(a, b, obb.center, obb.axes, obb.halfExtents);
+            }
+            case ShapeType::Sphere: {
+                const SphereShape& sphere = m_spheres[m_shapes[index].index];
+                CapsuleCollision::ClosestPoints closest = CapsuleCollision::SegmentPoint(a, b, sphere.center);
+                // Measure from the sphere's surface
+                float distance = std::sqrt(closest.distanceSq);
+                float surface = std::max(distance - sphere.radius, 0.0f);
+                if (distance > 0.0f) {
+                    closest.shapePoint = sphere.center + (closest.segmentPoint - sphere.center) * (sphere.radius / distance);
+                }
+                closest.distanceSq = surface * surface;
+                return closest;
+            }
+            default: {
+                AABB box = m_bounds.Get(index);
+                return CapsuleCollision::SegmentAABB(a, b, box.min, box.max);
+            }
+        }
+    }
+
+    // Shrink the player bounds more aggressively to prevent edge catching
+    static AABB ShrinkPlayerBounds(const AABB& playerBounds) {
+        const float skinXZ = 0.05f;  // More forgiving on horizontal
+        const float skinY = 0.02f;   // Tighter on vertical
+        return AABB(playerBounds.min + Vec3(skinXZ, skinY, skinXZ),
+                    playerBounds.max - Vec3(skinXZ, skinY, skinXZ));
+    }
+
+    // Whether an overlapping box blocks sideways movement (CheckCollision
+    // and SweepAABB)
+    bool BlocksSides(uint32_t index, float playerBottom, float maxClimbHeight) const {
+        float boxTop = m_bounds.maxY[index];
+
+        // Check if this is a climbable stair
+        if (m_flags[index] & BOX_FLAG_STAIR) {
+            float heightAbovePlayer = boxTop - playerBottom;
+            // Skip this stair if it's within climbable range
+            if (heightAbovePlayer > 0.0f && heightAbovePlayer <= maxClimbHeight) {
+                return false;  // This stair can be climbed, don't block
+            }
+        }
+
+        // Check if player is on TOP of the box (or close to it)
+
+        // Use generous tolerance - if player's bottom is near box top, they're standing on it
+        // Increased tolerance to 0.6 to prevent edge sticking
+        return playerBottom < boxTop - 0.6f;
+    }
+
+    int32_t CellCoord(float v) const {
+        return static_cast<int32_t>(std::floor(v * m_invCellSize));
+    }
+
+    static int64_t CellKey(int32_t cx, int32_t cz) {
+        return (static_cast<int64_t>(cx) << 32) | static_cast<uint32_t>(cz);
+    }
+
+    static uint8_t MakeFlags(const WorldBox& box) {
+        uint8_t flags = BOX_FLAG_ACTIVE;
+        if (box.isSolid) flags |= BOX_FLAG_SOLID;
+        if (box.IsStair()) flags |= BOX_FLAG_STAIR;
+        return flags;
+    }
+
+    // Trigger-tagged boxes never reach the solid layers, however they were
+    // filled in: Static-layer queries must not see a trigger as geometry
+    static WorldBox Normalized(const WorldBox& input) {
+        WorldBox box = input;
+        if (box.tag == BoxTag::Trigger) {
+            box.isSolid = false;
+            box.layer = CollisionLayer::Trigger;
+        }
+        return box;
+    }
+
+    static WorldBox MakeBox(const AABB& bounds, BoxTag tag, CollisionLayer layer) {
+        WorldBox box((bounds.min + bounds.max) * 0.5f, (bounds.max - bounds.min) * 0.5f, tag);
+        box.isSolid = tag != BoxTag::Trigger;
+        box.layer = layer;
+        return box;
+    }
+
+    // Grid a box lives in: its lowest layer bit
+    static uint8_t LayerIndex(CollisionLayer layer) {
+        uint32_t bits = static_cast<uint32_t>(layer);
+        return bits != 0 ? static_cast<uint8_t>(std::countr_zero(bits)) : 0;
+    }
+
+    // Only a permutation/scale of the world axes (no real rotation)
+    static bool IsAxisAligned(const Vec3 axes[3]) {
+        constexpr float epsilon = 1e-5f;
+        for (int axis = 0; axis < 3; axis++) {
+            const Vec3& a = axes[axis];
+            int nonZero = (std::abs(a.x) > epsilon) + (std::abs(a.y) > epsilon) + (std::abs(a.z) > epsilon);
+            if (nonZero > 1) return false;
+        }
+        return true;
+    }
+
+    ColliderHandle AddShapeBox(const WorldBox& box) {
+        return GetHandle(Insert(box));
+    }
+
+    uint32_t Insert(const WorldBox& input) {
+        WorldBox box = Normalized(input);
+        Vec3 bmin = box.center - box.halfExtents;
+        Vec3 bmax = box.center + box.halfExtents;
+
+        uint32_t index;
+        if (!m_freeBoxes.empty()) {
+            index = m_freeBoxes.back();
+            m_freeBoxes.pop_back();
+            m_boxes[index] = box;
+            m_bounds.Set(index, bmin, bmax);
+            m_flags[index] = MakeFlags(box);
+            m_layers[index] = LayerIndex(box.layer);
+            m_shapes[index] = ColliderShape();
+            m_velocities[index] = Vec3(0.0f);
+        } else {
+            index = static_cast<uint32_t>(m_boxes.size());
+            m_boxes.push_back(box);
+            m_bounds.Push(bmin, bmax);
+            m_flags.push_back(MakeFlags(box));
+            m_layers.push_back(LayerIndex(box.layer));
+            m_shapes.emplace_back();
+            m_userData.push_back(0);
+            m_velocities.emplace_back(0.0f);
+            if (index >= m_generations.size()) {
+                m_generations.push_back(0);
+            }
+        }
+
+        AddToGrid(index);
+        return index;
+    }
+
+    // Drop the typed shape data of a collider (swap-remove from its array)
+    void FreeShape(uint32_t index) {
+        ColliderShape& shape = m_shapes[index];
+        auto swapRemove = [this](auto& shapes, uint32_t hole) {
+            if (hole + 1 != shapes.size()) {
+                shapes[hole] = shapes.back();
+                m_shapes[shapes[hole].collider].index = hole;
+            }
+            shapes.pop_back();
+        };
+        if (shape.type == ShapeType::OrientedBox) {
+            swapRemove(m_orientedBoxes, shape.index);
+        } else if (shape.type == ShapeType::Sphere) {
+            swapRemove(m_spheres, shape.index);
+        }
+        shape = ColliderShape();
+    }
+
+    // Separating axis test: the box's 3 axes, the OBB's 3 and their 9 cross
+    // products
+    static bool OverlapOrientedBox(const OrientedBoxShape& obb, const AABB& box) {
+        const Vec3 worldAxes[3] = { Vec3(1, 0, 0), Vec3(0, 1, 0), Vec3(0, 0, 1) };
+        Vec3 boxCenter = (box.min + box.max) * 0.5f;
+        Vec3 boxHalf = (box.max - box.min) * 0.5f;
+        Vec3 d = obb.center - boxCenter;
+
+        auto separated = [&](const Vec3& axis) {
+            if (Math::Dot(axis, axis) < 1e-10f) return false;   // Parallel edges
+            float rBox = boxHalf.x * std::abs(axis.x) + boxHalf.y * std::abs(axis.y) + boxHalf.z * std::abs(axis.z);
+            float rObb = 0.0f;
+            for (int i = 0; i < 3; i++) {
+                rObb += obb.halfExtents[i] * std::abs(Math::Dot(obb.axes[i], axis));
+            }
+            return std::abs(Math::Dot(d, axis)) > rBox + rObb;
+        };
+
+        for (int i = 0; i < 3; i++) {
+            if (separated(worldAxes[i]) || separated(obb.axes[i])) return false;
+        }
+        for (int i = 0; i < 3; i++) {
+            for (int j = 0; j < 3; j++) {
+                if (separated(glm::cross(worldAxes[i], obb.axes[j]))) return false;
+            }
+        }
+        return true;
+    }
+
+    void SetVelocity(uint32_t index, const Vec3& velocity) {
+        bool wasMoving = m_velocities[index] != Vec3(0.0f);
+        bool moving = velocity != Vec3(0.0f);
+        m_movingBoxes += static_cast<uint32_t>(moving) - static_cast<uint32_t>(wasMoving);
+        m_velocities[index] = velocity;
+    }
+
+    // Copy new bounds of a box into the block slots holding it (the box
+    // must still span the cells it was added to)
+    void RefitInGrid(uint32_t index) {
+        Vec3 bmin(m_bounds.minX[index], m_bounds.minY[index], m_bounds.minZ[index]);
+        Vec3 bmax(m_bounds.maxX[index], m_bounds.maxY[index], m_bounds.maxZ[index]);
+        auto refit = [&](WorldBoxBlock& block) {
+            for (size_t slot = 0; slot < block.Size(); slot++) {
+                if (block.indices[slot] == index) {
+                    block.bounds.Set(slot, bmin, bmax);
+                    return;
+                }
+            }
+        };
+
+        int32_t minX = CellCoord(bmin.x), maxX = CellCoord(bmax.x);
+        int32_t minZ = CellCoord(bmin.z), maxZ = CellCoord(bmax.z);
+        LayerGrid& grid = m_grids[m_layers[index]];
+        m_layerRevisions[m_layers[index]]++;
+
+        int64_t cellCount = static_cast<int64_t>(maxX - minX + 1) * (maxZ - minZ + 1);
+        if (cellCount > MAX_CELLS_PER_BOX) {
+            refit(grid.largeBoxes);
+            return;
+        }
+        for (int32_t cz = minZ; cz <= maxZ; cz++) {
+            for (int32_t cx = minX; cx <= maxX; cx++) {
+                auto it = grid.cells.find(CellKey(cx, cz));
+                if (it != grid.cells.end()) refit(it->second);
+            }
+        }
+    }
+
+    // Inverse of AddToGrid (bounds must still be the ones it was added with)
+    void RemoveFromGrid(uint32_t index) {
+        auto removeFrom = [index](WorldBoxBlock& block) {
+            for (size_t slot = 0; slot < block.Size(); slot++) {
+                if (block.indices[slot] == index) {
+                    block.RemoveAt(slot);
+                    return;
+                }
+            }
+        };
+
+        int32_t minX = CellCoord(m_bounds.minX[index]);
+        int32_t maxX = CellCoord(m_bounds.maxX[index]);
+        int32_t minZ = CellCoord(m_bounds.minZ[index]);
+        int32_t maxZ = CellCoord(m_bounds.maxZ[index]);
+
+        LayerGrid& grid = m_grids[m_layers[index]];
+        m_layerRevisions[m_layers[index]]++;
+        int64_t cellCount = static_cast<int64_t>(maxX - minX + 1) * (maxZ - minZ + 1);
+        if (cellCount > MAX_CELLS_PER_BOX) {
+            removeFrom(grid.largeBoxes);
+            return;
+        }
+
+        for (int32_t cz = minZ; cz <= maxZ; cz++) {
+            for (int32_t cx = minX; cx <= maxX; cx++) {
+                auto it = grid.cells.find(CellKey(cx, cz));
+                if (it == grid.cells.end()) continue;
+                removeFrom(it->second);
+                if (it->second.Size() == 0) {
+                    grid.cells.erase(it);
+                }
+            }
+        }
+    }
+
+    void AddToGrid(uint32_t index) {
+        Vec3 bmin(m_bounds.minX[index], m_bounds.minY[index], m_bounds.minZ[index]);
+        Vec3 bmax(m_bounds.maxX[index], m_bounds.maxY[index], m_bounds.maxZ[index]);
+        uint8_t flags = m_flags[index];
+        LayerGrid& grid = m_grids[m_layers[index]];
+        m_usedLayers |= 1u << m_layers[index];
+        m_layerRevisions[m_layers[index]]++;
+
+        int32_t minX = CellCoord(bmin.x);
+        int32_t maxX = CellCoord(bmax.x);
+        int32_t minZ = CellCoord(bmin.z);
+        int32_t maxZ = CellCoord(bmax.z);
+
+        int64_t cellCount = static_cast<int64_t>(maxX - minX + 1) * (maxZ - minZ + 1);
+        if (cellCount > MAX_CELLS_PER_BOX) {
+            grid.largeBoxes.Push(index, bmin, bmax, flags);
+            return;
+        }
+
+        grid.minCellX = std::min(grid.minCellX, minX);
+        grid.minCellZ = std::min(grid.minCellZ, minZ);
+        grid.maxCellX = std::max(grid.maxCellX, maxX);
+        grid.maxCellZ = std::max(grid.maxCellZ, maxZ);
+        for (int32_t cz = minZ; cz <= maxZ; cz++) {
+            for (int32_t cx = minX; cx <= maxX; cx++) {
+                grid.cells[CellKey(cx, cz)].Push(index, bmin, bmax, flags);
+            }
+        }
+    }
+
+    void RebuildGrid() {
+        for (LayerGrid& grid : m_grids) {
+            grid.Clear();
+        }
+        m_usedLayers = 0;
+        for (uint32_t i = 0; i < static_cast<uint32_t>(m_boxes.size()); i++) {
+            if (IsBoxActive(i)) {
+                AddToGrid(i);
+            }
+        }
+    }
+
+    // Overlap kernel: fn(slot) for every box in the block whose bounds overlap
+    // [qmin, qmax] (inclusive, same as AABB::Intersects) and whose flags contain
+    // all of requiredFlags
+    template<typename Fn>
+    static void OverlapBlock(const WorldBoxBlock& block, const Vec3& qmin, const Vec3& qmax,
+                             uint8_t requiredFlags, Fn&& fn) {
+        const size_t count = block.Size();
+        const AABBSoA& b = block.bounds;
+        size_t i = 0;
+
+#ifdef GENESIS_SSE
+        const __m128 qMinX = _mm_set1_ps(qmin.x), qMaxX = _mm_set1_ps(qmax.x);
+        const __m128 qMinY = _mm_set1_ps(qmin.y), qMaxY = _mm_set1_ps(qmax.y);
+        const __m128 qMinZ = _mm_set1_ps(qmin.z), qMaxZ = _mm_set1_ps(qmax.z);
+
+        for (; i + 4 <= count; i += 4) {
+            __m128 hit = _mm_and_ps(
+                _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(&b.minX[i]), qMaxX),
+                           _mm_cmpge_ps(_mm_loadu_ps(&b.maxX[i]), qMinX)),
+                _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(&b.minZ[i]), qMaxZ),
+                           _mm_cmpge_ps(_mm_loadu_ps(&b.maxZ[i]), qMinZ)));
+            hit = _mm_and_ps(hit,
+                _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(&b.minY[i]), qMaxY),
+                           _mm_cmpge_ps(_mm_loadu_ps(&b.maxY[i]), qMinY)));
+
+            int mask = _mm_movemask_ps(hit);
+            while (mask) {
+                int k = 0;
+                while (!(mask & (1 << k))) k++;
+                mask &= ~(1 << k);
+                if ((block.flags[i + k] & requiredFlags) == requiredFlags) {
+                    fn(i + k);
+                }
+            }
+        }
+#endif
+
+        // Scalar tail (or full loop without SSE)
+        for (; i < count; i++) {
+            if (b.minX[i] <= qmax.x && b.maxX[i] >= qmin.x &&
+                b.minZ[i] <= qmax.z && b.maxZ[i] >= qmin.z &&
+                b.minY[i] <= qmax.y && b.maxY[i] >= qmin.y &&
+                (block.flags[i] & requiredFlags) == requiredFlags) {
+                fn(i);
+            }
+        }
+    }
+
+    std::vector<WorldBox> m_boxes;
+    AABBSoA m_bounds;              // Precomputed bounds, parallel to m_boxes
+    std::vector<uint8_t> m_flags;  // BoxFlags, parallel to m_boxes
+    std::vector<uint8_t> m_layers; // Grid (layer bit) of each box, parallel to m_boxes
+    std::vector<ColliderShape> m_shapes;   // Parallel to m_boxes
+    std::vector<uint64_t> m_userData;      // Parallel to m_boxes
+    std::vector<Vec3> m_velocities;        // Parallel to m_boxes (MoveCollider)
+    uint32_t m_movingBoxes = 0;            // Non-zero entries of m_velocities
+    std::vector<uint32_t> m_generations;   // By index; outlives Clear()
+    std::vector<uint32_t> m_freeBoxes;  // Removed slots, reused by Insert
+
+    // Exact shapes of the non-box colliders, packed by type
+    std::vector<OrientedBoxShape> m_orientedBoxes;
+    std::vector<SphereShape> m_spheres;
+    float m_floorHeight = 0.0f;  // Base floor level
+
+    // Broadphase: one XZ hash grid of box blocks per layer
+    static constexpr size_t LAYER_COUNT = 32;
+    float m_cellSize = 4.0f;
+    float m_invCellSize = 1.0f / 4.0f;
+    LayerGrid m_grids[LAYER_COUNT];
+    uint32_t m_usedLayers = 0;   // Layers that received boxes (grid may be empty)
+    uint32_t m_layerRevisions[LAYER_COUNT] = {};
+};
+
+} // namespace Genesis
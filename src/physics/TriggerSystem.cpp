@@ -0,0 +1,226 @@
+#include "TriggerSystem.h"
+#include "core/Profiler.h"
+#include <algorithm>
+
+namespace Genesis {
+
+namespace {
+
+// Move the last element into the hole left by SlotMap::Remove
+template<typename T>
+void SwapRemove(std::vector<T>& values, uint32_t hole) {
+    values[hole] = std::move(values.back());
+    values.pop_back();
+}
+
+bool SameBounds(const AABB& a, const AABB& b) {
+    return a.min == b.min && a.max == b.max;
+}
+
+} // anonymous namespace
+
+// ============================================================================
+// Volumes
+// ============================================================================
+
+void TriggerSystem::SetVolume(ColliderHandle trigger, const TriggerVolume& volume) {
+    if (!trigger.IsValid()) return;
+
+    if (trigger.index >= m_volumes.size()) {
+        m_volumes.resize(trigger.index + 1);
+        m_volumeHandles.resize(trigger.index + 1);
+    }
+    m_volumes[trigger.index] = volume;
+    m_volumeHandles[trigger.index] = trigger;
+    m_volumesChanged = true;
+}
+
+void TriggerSystem::SetVolumeEnabled(ColliderHandle trigger, bool enabled) {
+    if (trigger.index >= m_volumes.size() || m_volumeHandles[trigger.index] != trigger) {
+        // No info yet: store a default volume so the flag has a home
+        if (enabled) return;
+        SetVolume(trigger, TriggerVolume());
+    }
+    if (m_volumes[trigger.index].enabled != enabled) {
+        m_volumes[trigger.index].enabled = enabled;
+        m_volumesChanged = true;
+    }
+}
+
+void TriggerSystem::ClearVolumes() {
+    m_volumes.clear();
+    m_volumeHandles.clear();
+    m_volumesChanged = true;
+}
+
+const TriggerVolume& TriggerSystem::GetVolume(ColliderHandle trigger) const {
+    // Still answers for a removed collider until its index gets new info,
+    // so exit events keep the volume's entity
+    if (trigger.index < m_volumes.size() && m_volumeHandles[trigger.index] == trigger) {
+        return m_volumes[trigger.index];
+    }
+    return m_defaultVolume;
+}
+
+bool TriggerSystem::IsVolumeEnabled(uint32_t index) const {
+    if (index >= m_volumes.size()) return true;
+    return m_volumeHandles[index] != PhysicsWorld::Instance().GetHandle(index) || m_volumes[index].enabled;
+}
+
+// ============================================================================
+// Bodies
+// ============================================================================
+
+TriggerBodyHandle TriggerSystem::AddBody(const AABB& bounds, uint64_t userData) {
+    TriggerBodyHandle handle = m_bodies.Insert();
+    m_bodyBounds.push_back(bounds);
+    m_bodyUserData.push_back(userData);
+    m_bodyMoved.push_back(1);
+    m_bodyOverlaps.emplace_back();
+    return handle;
+}
+
+void TriggerSystem::RemoveBody(TriggerBodyHandle handle) {
+    uint32_t dense = m_bodies.GetDenseIndex(handle);
+    if (dense == SlotMap::INVALID_INDEX) return;
+
+    QueueOverlaps(dense, TriggerEventType::Exit);
+
+    uint32_t hole = m_bodies.Remove(handle);
+    SwapRemove(m_bodyBounds, hole);
+    SwapRemove(m_bodyUserData, hole);
+    SwapRemove(m_bodyMoved, hole);
+    SwapRemove(m_bodyOverlaps, hole);
+}
+
+void TriggerSystem::SetBodyBounds(TriggerBodyHandle handle, const AABB& bounds) {
+    uint32_t dense = m_bodies.GetDenseIndex(handle);
+    if (dense == SlotMap::INVALID_INDEX || SameBounds(m_bodyBounds[dense], bounds)) return;
+
+    m_bodyBounds[dense] = bounds;
+    m_bodyMoved[dense] = 1;
+}
+
+const std::vector<ColliderHandle>* TriggerSystem::GetOverlaps(TriggerBodyHandle handle) const {
+    uint32_t dense = m_bodies.GetDenseIndex(handle);
+    return dense != SlotMap::INVALID_INDEX ? &m_bodyOverlaps[dense] : nullptr;
+}
+
+// ============================================================================
+// Events
+// ============================================================================
+
+uint32_t TriggerSystem::Subscribe(const std::string& classname, TriggerCallback callback, bool wantsStay) {
+    uint32_t id = m_nextListenerId++;
+    m_listeners.push_back({id, classname, std::move(callback), wantsStay});
+    if (wantsStay) m_stayListeners++;
+    return id;
+}
+
+void TriggerSystem::Unsubscribe(uint32_t id) {
+    auto it = std::find_if(m_listeners.begin(), m_listeners.end(),
+                           [id](const Listener& listener) { return listener.id == id; });
+    if (it == m_listeners.end()) return;
+
+    if (it->wantsStay) m_stayListeners--;
+    m_listeners.erase(it);
+}
+
+void TriggerSystem::QueueOverlaps(uint32_t dense, TriggerEventType type) {
+    TriggerBodyHandle body = m_bodies.GetHandle(dense);
+    for (const ColliderHandle& trigger : m_bodyOverlaps[dense]) {
+        m_pending.push_back({type, trigger, body, m_bodyUserData[dense]});
+    }
+}
+
+void TriggerSystem::Diff(uint32_t dense, const std::vector<ColliderHandle>& current) {
+    const std::vector<ColliderHandle>& previous = m_bodyOverlaps[dense];
+    TriggerBodyHandle body = m_bodies.GetHandle(dense);
+    uint64_t userData = m_bodyUserData[dense];
+    bool stay = m_stayListeners > 0;
+
+    // Both sets are sorted by collider index; a recycled index (different
+    // generation) is a different trigger
+    size_t a = 0, b = 0;
+    while (a < previous.size() || b < current.size()) {
+        if (b == current.size() || (a < previous.size() && previous[a].index < current[b].index)) {
+            m_pending.push_back({TriggerEventType::Exit, previous[a++], body, userData});
+        } else if (a == previous.size() || current[b].index < previous[a].index) {
+            m_pending.push_back({TriggerEventType::Enter, current[b++], body, userData});
+        } else if (previous[a] != current[b]) {
+            m_pending.push_back({TriggerEventType::Exit, previous[a++], body, userData});
+            m_pending.push_back({TriggerEventType::Enter, current[b++], body, userData});
+        } else {
+            if (stay) m_pending.push_back({TriggerEventType::Stay, current[b], body, userData});
+            a++;
+            b++;
+        }
+    }
+}
+
+void TriggerSystem::Update() {
+    GENESIS_PROFILE_SCOPE("TriggerSystem::Update");
+
+    const auto& world = PhysicsWorld::Instance();
+    uint32_t revision = world.GetLayerRevision(CollisionLayer::Trigger);
+    bool requeryAll = revision != m_seenRevision || m_volumesChanged;
+    m_seenRevision = revision;
+    m_volumesChanged = false;
+
+    m_bodiesQueried = 0;
+    for (uint32_t i = 0; i < m_bodies.Size(); i++) {
+        if (!requeryAll && !m_bodyMoved[i]) {
+            // Nothing that could change the pairs happened
+            if (m_stayListeners > 0) QueueOverlaps(i, TriggerEventType::Stay);
+            continue;
+        }
+        m_bodyMoved[i] = 0;
+        m_bodiesQueried++;
+
+        m_current.clear();
+        world.QueryAABB(m_bodyBounds[i], [&](uint32_t index) {
+            if (IsVolumeEnabled(index)) {
+                m_current.push_back(world.GetHandle(index));
+            }
+        }, static_cast<uint32_t>(CollisionLayer::Trigger));
+        std::sort(m_current.begin(), m_current.end(),
+                  [](const ColliderHandle& x, const ColliderHandle& y) { return x.index < y.index; });
+
+        Diff(i, m_current);
+        m_bodyOverlaps[i].swap(m_current);
+    }
+
+    Dispatch();
+}
+
+void TriggerSystem::Dispatch() {
+    // Listeners may add/remove bodies and volumes; those events wait for
+    // the next Update
+    m_dispatching.swap(m_pending);
+    m_pending.clear();
+    m_eventCount = static_cast<uint32_t>(m_dispatching.size());
+
+    for (const PendingEvent& pending : m_dispatching) {
+        const TriggerVolume& volume = GetVolume(pending.trigger);
+        bool once = volume.once;
+        if (pending.type == TriggerEventType::Enter && once && !volume.enabled) continue;   // Already fired
+        const std::string classname = volume.classname;
+
+        TriggerEvent event{pending.type, pending.trigger, pending.body, pending.bodyUserData, &volume};
+        for (size_t l = 0; l < m_listeners.size(); l++) {
+            const Listener& listener = m_listeners[l];
+            if (pending.type == TriggerEventType::Stay && !listener.wantsStay) continue;
+            if (!listener.classname.empty() && listener.classname != classname) continue;
+            TriggerCallback callback = listener.callback;   // Survives Unsubscribe from inside
+            event.volume = &GetVolume(pending.trigger);       // SetVolume may have moved it
+            callback(event);
+        }
+
+        if (pending.type == TriggerEventType::Enter && once) {
+            SetVolumeEnabled(pending.trigger, false);
+        }
+    }
+    m_dispatching.clear();
+}
+
+} // namespace Genesis
@@ -0,0 +1,162 @@
+#pragma once
+
+#include "physics/PhysicsWorld.h"
+#include "core/SlotMap.h"
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace Genesis {
+
+// Stable reference to a body tracked by the TriggerSystem
+using TriggerBodyHandle = SlotHandle;
+
+enum class TriggerEventType : uint8_t {
+    Enter,
+    Stay,     // Every Update while overlapping (only for Stay listeners)
+    Exit
+};
+
+// ============================================================================
+// Trigger Volume - What a PhysicsWorld trigger collider stands for
+// ============================================================================
+struct TriggerVolume {
+    static constexpr uint32_t NO_ENTITY = 0xFFFFFFFFu;
+
+    std::string classname;          // e.g. "trigger_once"; empty for a bare trigger brush
+    std::string name;               // Entity targetname
+    uint32_t entity = NO_ENTITY;    // Map entity index
+    bool once = false;              // Disabled after its first enter (trigger_once)
+    bool enabled = true;            // Disabled volumes are skipped (their pairs exit)
+};
+
+struct TriggerEvent {
+    TriggerEventType type;
+    ColliderHandle trigger;         // Trigger collider in the PhysicsWorld
+    TriggerBodyHandle body;
+    uint64_t bodyUserData;
+    const TriggerVolume* volume;    // Never null; valid during the callback
+};
+
+using TriggerCallback = std::function<void(const TriggerEvent&)>;
+
+// ============================================================================
+// TriggerSystem - Persistent body/trigger overlap pairs
+//
+// Bodies (players, projectiles...) are AABBs registered here; trigger
+// volumes are the CollisionLayer::Trigger colliders of the PhysicsWorld.
+// Each body keeps its sorted set of overlapping triggers. Update()
+// re-queries (through the trigger layer's broadphase only) just the bodies
+// that moved, or all of them when the trigger layer changed, and diffs the
+// new set against the old one: enter/exit events are emitted only for pairs
+// that changed, never by testing every trigger.
+//
+// Listeners subscribe by volume classname (empty = every volume). Events
+// are collected during the pass and dispatched at the end of Update().
+// ============================================================================
+class TriggerSystem {
+public:
+    static TriggerSystem& Instance() {
+        static TriggerSystem instance;
+        return instance;
+    }
+
+    // ========================================================================
+    // Volumes
+    // ========================================================================
+
+    // Attach entity info to a trigger collider (kept until the collider is
+    // removed or ClearVolumes())
+    void SetVolume(ColliderHandle trigger, const TriggerVolume& volume);
+    void SetVolumeEnabled(ColliderHandle trigger, bool enabled);
+    void ClearVolumes();
+
+    // Info for a trigger collider (a default volume if none was set)
+    const TriggerVolume& GetVolume(ColliderHandle trigger) const;
+
+    // ========================================================================
+    // Bodies
+    // ========================================================================
+    TriggerBodyHandle AddBody(const AABB& bounds, uint64_t userData = 0);
+
+    // Pending overlaps exit on the next Update()
+    void RemoveBody(TriggerBodyHandle handle);
+
+    // Cheap when the bounds didn't change
+    void SetBodyBounds(TriggerBodyHandle handle, const AABB& bounds);
+
+    bool IsAlive(TriggerBodyHandle handle) const { return m_bodies.IsAlive(handle); }
+    uint32_t GetBodyCount() const { return m_bodies.Size(); }
+
+    // Triggers the body currently overlaps (sorted by collider index)
+    const std::vector<ColliderHandle>* GetOverlaps(TriggerBodyHandle handle) const;
+
+    // ========================================================================
+    // Events
+    // ========================================================================
+
+    // Returns an id for Unsubscribe. Stay events are only produced while a
+    // listener asks for them.
+    uint32_t Subscribe(const std::string& classname, TriggerCallback callback, bool wantsStay = false);
+    void Unsubscribe(uint32_t id);
+
+    // Once per fixed tick, after the bodies were moved
+    void Update();
+
+    // ========================================================================
+    // Statistics (last Update)
+    // ========================================================================
+    uint32_t GetBodiesQueried() const { return m_bodiesQueried; }
+    uint32_t GetEventCount() const { return m_eventCount; }
+
+private:
+    TriggerSystem() = default;
+
+    struct PendingEvent {
+        TriggerEventType type;
+        ColliderHandle trigger;
+        TriggerBodyHandle body;
+        uint64_t bodyUserData;
+    };
+
+    struct Listener {
+        uint32_t id;
+        std::string classname;
+        TriggerCallback callback;
+        bool wantsStay;
+    };
+
+    bool IsVolumeEnabled(uint32_t index) const;
+    void QueueOverlaps(uint32_t dense, TriggerEventType type);
+    void Diff(uint32_t dense, const std::vector<ColliderHandle>& current);
+    void Dispatch();
+
+    // Volumes, by collider index (m_volumeHandles says which collider the
+    // entry belongs to)
+    std::vector<TriggerVolume> m_volumes;
+    std::vector<ColliderHandle> m_volumeHandles;
+    TriggerVolume m_defaultVolume;
+    bool m_volumesChanged = false;
+
+    // Bodies, packed by dense index
+    SlotMap m_bodies;
+    std::vector<AABB> m_bodyBounds;
+    std::vector<uint64_t> m_bodyUserData;
+    std::vector<uint8_t> m_bodyMoved;
+    std::vector<std::vector<ColliderHandle>> m_bodyOverlaps;
+    uint32_t m_seenRevision = ~0u;
+
+    std::vector<Listener> m_listeners;
+    uint32_t m_nextListenerId = 1;
+    uint32_t m_stayListeners = 0;
+
+    // Per-Update scratch
+    std::vector<ColliderHandle> m_current;
+    std::vector<PendingEvent> m_pending;
+    std::vector<PendingEvent> m_dispatching;
+
+    uint32_t m_bodiesQueried = 0;
+    uint32_t m_eventCount = 0;
+};
+
+} // namespace Genesis
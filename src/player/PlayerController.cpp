@@ -1,9 +1,66 @@
 #include "PlayerController.h"
+#include "PlayerMovement.h"
+#include "physics/PhysicsWorld.h"
 #include <cmath>
 #include <algorithm>
 
 namespace Genesis {
 
+namespace {
+
+template<typename World>
+bool HasQuery(const World& world, PlayerQuery query) {
+    if constexpr (requires { world.HasQuery(query); }) {
+        return world.HasQuery(query);
+    } else {
+        return true;
+    }
+}
+
+// Ground height plus the box it belongs to, when the world can tell
+template<typename World>
+float QueryGroundHeight(const World& world, const Vec3& position, float radius, float playerY, SlotHandle& groundBox) {
+    if constexpr (PlayerMovingGroundWorld<World>) {
+        return world.GetGroundHeight(position.x, position.z, radius, playerY, groundBox);
+    } else {
+        groundBox = SlotHandle();
+        return world.GetGroundHeight(position.x, position.z, radius, playerY);
+    }
+}
+
+// Side collision and depenetration of the player body: the exact capsule
+// when the config asks for one and the world can test it, else the box
+template<typename World>
+bool CheckBodyCollision(const World& world, bool capsule, const Vec3& position, const AABB& bounds,
+                        float maxClimbHeight) {
+    if constexpr (PlayerCapsuleWorld<World>) {
+        if (capsule && HasQuery(world, PlayerQuery::Capsule)) {
+            return world.CheckCollision(Capsule::FromBounds(bounds), maxClimbHeight);
+        }
+    }
+    return world.CheckCollision(position, bounds, maxClimbHeight);
+}
+
+template<typename World>
+bool GetBodyPenetration(const World& world, bool capsule, const AABB& bounds, Vec3& pushOut, float maxClimbHeight) {
+    if constexpr (PlayerCapsuleWorld<World>) {
+        if (capsule && HasQuery(world, PlayerQuery::Capsule)) {
+            return world.GetPenetration(Capsule::FromBounds(bounds), pushOut, maxClimbHeight);
+        }
+    }
+    return world.GetPenetration(bounds, pushOut, maxClimbHeight);
+}
+
+template<typename World>
+Vec3 QueryBoxVelocity(const World& world, SlotHandle box) {
+    if constexpr (PlayerMovingGroundWorld<World>) {
+        if (box.IsValid()) return world.GetBoxVelocity(box);
+    }
+    return Vec3(0.0f);
+}
+
+} // anonymous namespace
+
 PlayerController::PlayerController() {
     m_currentHeight = m_config.capsuleHeight;
 }
@@ -34,6 +91,17 @@ void PlayerController::SetConfig(const PlayerControllerConfig& config) {
 }
 
 void PlayerController::Update(float deltaTime) {
+    Update(deltaTime, m_callbacks);
+}
+
+template<PlayerCollisionWorld World>
+void PlayerController::Update(float deltaTime, const World& world) {
+    // Ride the platform we stand on: it has already moved this tick
+    if (m_groundInfo.isGrounded) {
+        m_groundInfo.groundVelocity = QueryBoxVelocity(world, m_groundInfo.groundBox);
+        m_position += m_groundInfo.groundVelocity * deltaTime;
+    }
+
     // Update jump cooldown
     if (m_jumpCooldownTimer > 0.0f) {
         m_jumpCooldownTimer -= deltaTime;
@@ -52,7 +120,12 @@ void PlayerController::Update(float deltaTime) {
             }
 
             if (canJump) {
-                m_velocity.y = m_config.jumpForce;
+                float lift = 0.0f;
+                if (m_groundInfo.isGrounded) {
+                    lift = std::max(m_groundInfo.groundVelocity.y, 0.0f);
+                    InheritGroundVelocity();
+                }
+                m_velocity.y = m_config.jumpForce + lift;
                 m_isJumping = true;
                 m_jumpCooldownTimer = m_config.jumpCooldown;
                 m_groundInfo.isGrounded = false;
@@ -75,7 +148,7 @@ void PlayerController::Update(float deltaTime) {
 
     // === AUTO STAIR CLIMBING ===
     // Check for tagged stairs and auto-climb them
-    if (m_autoClimbStairs && m_stairClimbCallback && m_groundInfo.isGrounded && m_isMoving) {
+    if (m_autoClimbStairs && HasQuery(world, PlayerQuery::StairClimb) && m_groundInfo.isGrounded && m_isMoving) {
         // Get movement direction
         Vec3 moveDir = Vec3(0.0f);
         float horizSpeed = std::sqrt(m_velocity.x * m_velocity.x + m_velocity.z * m_velocity.z);
@@ -84,7 +157,7 @@ void PlayerController::Update(float deltaTime) {
         }
 
         if (Math::Length(moveDir) > 0.01f) {
-            float stairTop = m_stairClimbCallback(
+            float stairTop = world.GetStairClimbHeight(
                 newPosition.x, newPosition.z, m_position.y,
                 m_config.capsuleRadius, m_config.autoClimbStairHeight, moveDir
             );
@@ -112,7 +185,20 @@ void PlayerController::Update(float deltaTime) {
     // === HORIZONTAL COLLISION (sides of cubes) ===
     // Use a collision check that ignores the bottom part of the player
     // This prevents getting stuck on edges of blocks we're standing on
-    if (m_collisionCallback) {
+    if (HasQuery(world, PlayerQuery::Sweep)) {
+        // Continuous: one sweep per bump, so fast moves can't skip walls
+        float stepOffset = m_config.stepHeight + 0.15f;
+        float checkHeight = m_currentHeight - stepOffset;
+
+        if (checkHeight > 0.1f) {
+            Vec3 checkExtents = Vec3(m_config.capsuleRadius * 0.95f, checkHeight * 0.5f, m_config.capsuleRadius * 0.95f);
+            Vec3 slid = SlideMove(world, m_position, deltaTime, stepOffset + checkHeight * 0.5f, checkExtents);
+            newPosition.x = slid.x;
+            newPosition.z = slid.z;
+        }
+    } else if (HasQuery(world, PlayerQuery::Collision)) {
+        const bool capsule = m_config.colliderType == PlayerColliderType::Capsule;
+
         // Create AABB that's raised slightly off the ground to avoid false collisions
         float stepOffset = m_config.stepHeight + 0.15f;  // Increased offset
         float checkHeight = m_currentHeight - stepOffset;
@@ -122,7 +208,7 @@ void PlayerController::Update(float deltaTime) {
             Vec3 checkExtents = Vec3(m_config.capsuleRadius * 0.95f, checkHeight * 0.5f, m_config.capsuleRadius * 0.95f);  // Slightly smaller
             AABB horizontalBounds = AABB::FromCenterExtents(checkCenter, checkExtents);
 
-            bool blocked = m_collisionCallback(newPosition, horizontalBounds);
+            bool blocked = CheckBodyCollision(world, capsule, newPosition, horizontalBounds, m_config.autoClimbStairHeight);
 
             if (blocked) {
                 // Use separate-axis collision resolution
@@ -134,12 +220,12 @@ void PlayerController::Update(float deltaTime) {
                 // Test X movement independently
                 Vec3 xTestCenter = Vec3(newPosition.x, m_position.y + stepOffset + checkHeight * 0.5f, m_position.z);
                 AABB xTestBounds = AABB::FromCenterExtents(xTestCenter, checkExtents);
-                bool xBlocked = m_collisionCallback(Vec3(newPosition.x, m_position.y, m_position.z), xTestBounds);
+                bool xBlocked = CheckBodyCollision(world, capsule, Vec3(newPosition.x, m_position.y, m_position.z), xTestBounds, m_config.autoClimbStairHeight);
 
                 // Test Z movement independently
                 Vec3 zTestCenter = Vec3(m_position.x, m_position.y + stepOffset + checkHeight * 0.5f, newPosition.z);
                 AABB zTestBounds = AABB::FromCenterExtents(zTestCenter, checkExtents);
-                bool zBlocked = m_collisionCallback(Vec3(m_position.x, m_position.y, newPosition.z), zTestBounds);
+                bool zBlocked = CheckBodyCollision(world, capsule, Vec3(m_position.x, m_position.y, newPosition.z), zTestBounds, m_config.autoClimbStairHeight);
 
                 // Apply sliding resolution
                 if (xBlocked && zBlocked) {
@@ -175,7 +261,7 @@ void PlayerController::Update(float deltaTime) {
                     // Verify the chosen direction is actually clear
                     Vec3 finalCenter = Vec3(newPosition.x, m_position.y + stepOffset + checkHeight * 0.5f, newPosition.z);
                     AABB finalBounds = AABB::FromCenterExtents(finalCenter, checkExtents);
-                    if (m_collisionCallback(newPosition, finalBounds)) {
+                    if (CheckBodyCollision(world, capsule, newPosition, finalBounds, m_config.autoClimbStairHeight)) {
                         // Still blocked, cancel all movement
                         newPosition.x = m_position.x;
                         newPosition.z = m_position.z;
@@ -189,7 +275,8 @@ void PlayerController::Update(float deltaTime) {
 
     // === VERTICAL COLLISION (ground/top of cubes) ===
     // Get ground height at the new XZ position, using current Y to find valid ground
-    float groundHeight = GetGroundHeight(newPosition.x, newPosition.z, m_position.y);
+    SlotHandle groundBox;
+    float groundHeight = QueryGroundHeight(world, newPosition, m_config.capsuleRadius, m_position.y, groundBox);
 
     // Ground collision: if we would go below ground, stop at ground level
     if (newPosition.y <= groundHeight) {
@@ -205,12 +292,16 @@ void PlayerController::Update(float deltaTime) {
         m_groundInfo.groundPoint = Vec3(newPosition.x, groundHeight, newPosition.z);
         m_groundInfo.groundNormal = Vec3(0.0f, 1.0f, 0.0f);
         m_groundInfo.groundDistance = 0.0f;
+        m_groundInfo.groundBox = groundBox;
         m_isJumping = false;
         m_airJumpsRemaining = m_config.maxAirJumps;
     } else {
         // We're in the air
         float distToGround = newPosition.y - groundHeight;
         if (distToGround > m_config.groundCheckDistance) {
+            if (m_groundInfo.isGrounded) {
+                InheritGroundVelocity();   // Walked off a moving platform
+            }
             m_groundInfo.isGrounded = false;
         }
     }
@@ -219,10 +310,11 @@ void PlayerController::Update(float deltaTime) {
     m_position = newPosition;
 
     // === DEPENETRATION (safety net for stuck situations) ===
-    if (m_depenetrationCallback) {
+    if (HasQuery(world, PlayerQuery::Depenetration)) {
         Vec3 pushOut;
         AABB currentBounds = GetAABB();
-        if (m_depenetrationCallback(currentBounds, pushOut)) {
+        bool capsule = m_config.colliderType == PlayerColliderType::Capsule;
+        if (GetBodyPenetration(world, capsule, currentBounds, pushOut, m_config.autoClimbStairHeight)) {
             // Apply pushout
             m_position += pushOut;
             // Also adjust velocity to prevent re-entering the collision
@@ -235,6 +327,52 @@ void PlayerController::Update(float deltaTime) {
     UpdateCapsule();
 }
 
+// ============================================================================
+// Snapshots
+// ============================================================================
+
+void PlayerController::SaveSnapshot(PlayerControllerSnapshot& snapshot) const {
+    using S = PlayerControllerSnapshot;
+    snapshot.position = m_position;
+    snapshot.velocity = m_velocity;
+    snapshot.groundInfo = m_groundInfo;
+    snapshot.jumpCooldownTimer = m_jumpCooldownTimer;
+    snapshot.airJumpsRemaining = m_airJumpsRemaining;
+    snapshot.moveInput = m_moveInput;
+    snapshot.yaw = m_yaw;
+    snapshot.pitch = m_pitch;
+    snapshot.flags = static_cast<uint8_t>((m_isSprinting ? S::FLAG_SPRINTING : 0) |
+                                          (m_isCrouching ? S::FLAG_CROUCHING : 0) |
+                                          (m_isJumping ? S::FLAG_JUMPING : 0) |
+                                          (m_isMoving ? S::FLAG_MOVING : 0) |
+                                          (m_wantsToJump ? S::FLAG_WANTS_JUMP : 0));
+}
+
+void PlayerController::RestoreSnapshot(const PlayerControllerSnapshot& snapshot) {
+    m_position = snapshot.position;
+    m_velocity = snapshot.velocity;
+    m_groundInfo = snapshot.groundInfo;
+    m_jumpCooldownTimer = snapshot.jumpCooldownTimer;
+    m_airJumpsRemaining = snapshot.airJumpsRemaining;
+    m_isJumping = (snapshot.flags & PlayerControllerSnapshot::FLAG_JUMPING) != 0;
+    RestoreInput(snapshot);
+}
+
+void PlayerController::RestoreInput(const PlayerControllerSnapshot& snapshot) {
+    using S = PlayerControllerSnapshot;
+    // Through the setters, so state derived from the input (m_isMoving)
+    // follows it even when netcode patched only the input fields
+    SetMoveInput(snapshot.moveInput);
+    m_yaw = snapshot.yaw;
+    m_pitch = snapshot.pitch;
+    m_isSprinting = (snapshot.flags & S::FLAG_SPRINTING) != 0;
+    m_isCrouching = (snapshot.flags & S::FLAG_CROUCHING) != 0;
+    m_wantsToJump = (snapshot.flags & S::FLAG_WANTS_JUMP) != 0;
+
+    // Crouch changes the capsule height
+    UpdateCapsule();
+}
+
 void PlayerController::SetMoveInput(const Vec3& input) {
     m_moveInput = input;
     // Clamp input magnitude
@@ -273,10 +411,15 @@ void PlayerController::SetPosition(const Vec3& position) {
 }
 
 void PlayerController::Teleport(const Vec3& position) {
+    Teleport(position, m_callbacks);
+}
+
+template<PlayerCollisionWorld World>
+void PlayerController::Teleport(const Vec3& position, const World& world) {
     m_position = position;
     m_velocity = Vec3(0.0f);
     UpdateCapsule();
-    CheckGroundCollision();
+    CheckGroundCollision(world);
 }
 
 Vec3 PlayerController::GetEyePosition() const {
@@ -285,13 +428,11 @@ Vec3 PlayerController::GetEyePosition() const {
 }
 
 Vec3 PlayerController::GetForwardXZ() const {
-    float yawRad = Math::Radians(m_yaw);
-    return Math::Normalize(Vec3(cos(yawRad), 0.0f, sin(yawRad)));
+    return PlayerMovement::GetForwardXZ(m_yaw);
 }
 
 Vec3 PlayerController::GetRightXZ() const {
-    float yawRad = Math::Radians(m_yaw);
-    return Math::Normalize(Vec3(-sin(yawRad), 0.0f, cos(yawRad)));
+    return PlayerMovement::GetRightXZ(m_yaw);
 }
 
 AABB PlayerController::GetAABB() const {
@@ -302,6 +443,15 @@ AABB PlayerController::GetAABB() const {
     return AABB::FromCenterExtents(m_position + Vec3(0.0f, m_currentHeight * 0.5f, 0.0f), halfExtents);
 }
 
+// Leaving the ground keeps the platform's motion (momentum, Source-style)
+void PlayerController::InheritGroundVelocity() {
+    const Vec3& groundVelocity = m_groundInfo.groundVelocity;
+    m_velocity.x += groundVelocity.x;
+    m_velocity.z += groundVelocity.z;
+    m_velocity.y += std::max(groundVelocity.y, 0.0f);   // Launched by a rising platform
+    m_groundInfo.groundVelocity = Vec3(0.0f);
+}
+
 void PlayerController::ApplyGravity(float deltaTime) {
     if (!m_groundInfo.isGrounded) {
         m_velocity.y -= m_config.gravity * deltaTime;
@@ -315,29 +465,12 @@ void PlayerController::ApplyGravity(float deltaTime) {
 
 void PlayerController::ApplyMovement(float deltaTime) {
     // Get max speed based on state
-    float maxSpeed = m_config.walkSpeed;
-    if (m_isSprinting && m_isMoving) {
-        maxSpeed = m_config.sprintSpeed;
-    } else if (m_isCrouching) {
-        maxSpeed = m_config.crouchSpeed;
-    }
+    float maxSpeed = PlayerMovement::GetMaxSpeed(m_config, m_isSprinting, m_isMoving, m_isCrouching);
 
     // Calculate wish direction and speed in world space
-    Vec3 forward = GetForwardXZ();
-    Vec3 right = GetRightXZ();
-
-    Vec3 wishDir = Vec3(0.0f);
-    wishDir += forward * m_moveInput.z;  // Forward/back
-    wishDir += right * m_moveInput.x;    // Left/right
-
-    float wishSpeed = Math::Length(wishDir);
-    if (wishSpeed > 0.0001f) {
-        wishDir = Math::Normalize(wishDir);
-        wishSpeed = std::min(wishSpeed, 1.0f) * maxSpeed;
-    } else {
-        wishDir = Vec3(0.0f);
-        wishSpeed = 0.0f;
-    }
+    Vec3 wishDir;
+    float wishSpeed;
+    PlayerMovement::GetWishMove(m_yaw, m_moveInput, maxSpeed, wishDir, wishSpeed);
 
     if (m_groundInfo.isGrounded) {
         // === GROUND MOVEMENT (Source-style) ===
@@ -349,117 +482,20 @@ void PlayerController::ApplyMovement(float deltaTime) {
     }
 }
 
-// ============================================================================
-// Source-Style Friction
-// ============================================================================
 void PlayerController::ApplyFriction(float deltaTime) {
-    Vec3 vel = Vec3(m_velocity.x, 0.0f, m_velocity.z);
-    float speed = Math::Length(vel);
-
-    if (speed < 0.1f) {
-        // Below threshold, just stop
-        m_velocity.x = 0.0f;
-        m_velocity.z = 0.0f;
-        return;
-    }
-
-    // Apply much stronger friction when not providing input
-    float friction = m_config.groundFriction;
-    if (!m_isMoving) {
-        // Apply extra stopping friction when no input
-        friction *= 2.5f;
-    }
-
-    // Calculate friction drop
-    // Source uses: drop = speed * friction * deltaTime
-    // But if speed < stopspeed, use stopspeed for the calculation
-    float control = (speed < m_config.stopSpeed) ? m_config.stopSpeed : speed;
-    float drop = control * friction * deltaTime;
-
-    // Scale the velocity
-    float newSpeed = speed - drop;
-    if (newSpeed < 0.0f) {
-        newSpeed = 0.0f;
-    }
-
-    if (speed > 0.0f) {
-        float scale = newSpeed / speed;
-        m_velocity.x *= scale;
-        m_velocity.z *= scale;
-    }
+    PlayerMovement::ApplyFriction(m_velocity, m_config, m_isMoving, deltaTime);
 }
 
-// ============================================================================
-// Source-Style Ground Acceleration
-// ============================================================================
 void PlayerController::ApplyGroundAcceleration(const Vec3& wishDir, float wishSpeed, float deltaTime) {
-    // Current speed in wish direction
-    float currentSpeed = Math::Dot(Vec3(m_velocity.x, 0.0f, m_velocity.z), wishDir);
-
-    // How much we need to add
-    float addSpeed = wishSpeed - currentSpeed;
-
-    if (addSpeed <= 0.0f) {
-        return;  // Already going fast enough in this direction
-    }
-
-    // Acceleration: accelspeed = accel * deltaTime * wishspeed
-    float accelSpeed = m_config.groundAccelerate * deltaTime * wishSpeed;
-
-    // Cap the acceleration
-    if (accelSpeed > addSpeed) {
-        accelSpeed = addSpeed;
-    }
-
-    // Add to velocity
-    m_velocity.x += accelSpeed * wishDir.x;
-    m_velocity.z += accelSpeed * wishDir.z;
+    PlayerMovement::ApplyGroundAcceleration(m_velocity, wishDir, wishSpeed, m_config, deltaTime);
 }
 
-// ============================================================================
-// Source-Style Air Acceleration (enables strafing/bhop)
-// ============================================================================
 void PlayerController::ApplyAirAcceleration(const Vec3& wishDir, float wishSpeed, float deltaTime) {
-    // Cap wish speed for air movement (this is key for strafe jumping)
-    float wishSpeedCapped = std::min(wishSpeed, m_config.airSpeedCap * m_config.walkSpeed);
-
-    // Current speed in wish direction
-    float currentSpeed = Math::Dot(Vec3(m_velocity.x, 0.0f, m_velocity.z), wishDir);
-
-    // How much we need to add
-    float addSpeed = wishSpeedCapped - currentSpeed;
-
-    if (addSpeed <= 0.0f) {
-        return;
-    }
-
-    // Air acceleration
-    float accelSpeed = m_config.airAccelerate * deltaTime * wishSpeed;
-
-    // Cap it
-    if (accelSpeed > addSpeed) {
-        accelSpeed = addSpeed;
-    }
-
-    // Add to velocity
-    m_velocity.x += accelSpeed * wishDir.x;
-    m_velocity.z += accelSpeed * wishDir.z;
-
-    // Optional: Apply air friction (usually 0 in Source)
-    if (m_config.airFriction > 0.0f) {
-        Vec3 vel = Vec3(m_velocity.x, 0.0f, m_velocity.z);
-        float speed = Math::Length(vel);
-        if (speed > 0.1f) {
-            float drop = speed * m_config.airFriction * deltaTime;
-            float newSpeed = std::max(0.0f, speed - drop);
-            float scale = newSpeed / speed;
-            m_velocity.x *= scale;
-            m_velocity.z *= scale;
-        }
-    }
+    PlayerMovement::ApplyAirAcceleration(m_velocity, wishDir, wishSpeed, m_config, deltaTime);
 }
 
-void PlayerController::CheckGroundCollision() {
+template<PlayerCollisionWorld World>
+void PlayerController::CheckGroundCollision(const World& world) {
     // Reset ground info
     m_groundInfo = GroundInfo();
 
@@ -469,7 +505,8 @@ void PlayerController::CheckGroundCollision() {
     }
 
     // Get ground height at current position
-    float groundHeight = GetGroundHeight(m_position.x, m_position.z, m_position.y);
+    SlotHandle groundBox;
+    float groundHeight = QueryGroundHeight(world, m_position, m_config.capsuleRadius, m_position.y, groundBox);
 
     // Calculate distance to ground (positive = above, negative = below/inside)
     float distanceToGround = m_position.y - groundHeight;
@@ -488,6 +525,8 @@ void PlayerController::CheckGroundCollision() {
         m_groundInfo.groundDistance = distanceToGround;
         m_groundInfo.groundPoint = Vec3(m_position.x, groundHeight, m_position.z);
         m_groundInfo.groundNormal = Vec3(0.0f, 1.0f, 0.0f);
+        m_groundInfo.groundBox = groundBox;
+        m_groundInfo.groundVelocity = QueryBoxVelocity(world, groundBox);
 
         // Snap to ground surface if we're at or below it
         if (distanceToGround <= 0.0f) {
@@ -575,7 +614,10 @@ void PlayerController::UpdateCapsule() {
 }
 
 bool PlayerController::CheckCollision(const Vec3& position) const {
-    if (!m_collisionCallback) {
+    if (m_config.colliderType == PlayerColliderType::Capsule && m_callbacks.capsuleCollision) {
+        return m_callbacks.capsuleCollision(Capsule(position, m_config.capsuleRadius, m_currentHeight));
+    }
+    if (!m_callbacks.collision) {
         return false;
     }
 
@@ -585,15 +627,46 @@ bool PlayerController::CheckCollision(const Vec3& position) const {
         : m_config.aabbHalfExtents;
 
     AABB bounds = AABB::FromCenterExtents(position + Vec3(0.0f, m_currentHeight * 0.5f, 0.0f), halfExtents);
-    return m_collisionCallback(position, bounds);
+    return m_callbacks.collision(position, bounds);
 }
 
 float PlayerController::GetGroundHeight(float x, float z, float playerY) const {
-    if (m_groundHeightCallback) {
-        return m_groundHeightCallback(x, z, playerY);
-    }
     // Default: flat ground at y = 0
-    return 0.0f;
+    return m_callbacks.GetGroundHeight(x, z, m_config.capsuleRadius, playerY);
+}
+
+template<PlayerCollisionWorld World>
+Vec3 PlayerController::SlideMove(const World& world, const Vec3& start, float deltaTime, float boundsOffsetY, const Vec3& extents) {
+    Vec3 position = start;
+    PlayerMovement::SlideState slide;
+    slide.primalVelocity = Vec3(m_velocity.x, 0.0f, m_velocity.z);
+    Vec3 velocity = slide.primalVelocity;
+    float timeLeft = deltaTime;
+
+    for (int bump = 0; bump < PlayerMovement::SLIDE_MAX_BUMPS; bump++) {
+        Vec3 delta = velocity * timeLeft;
+        float distance = Math::Length(delta);
+        if (distance < 1e-6f) {
+            break;
+        }
+
+        AABB bounds = AABB::FromCenterExtents(position + Vec3(0.0f, boundsOffsetY, 0.0f), extents);
+        SweepHit hit;
+        if (!world.SweepAABB(bounds, delta, hit, m_config.autoClimbStairHeight)) {
+            position += delta;
+            break;
+        }
+
+        position += delta * std::max(hit.time - PlayerMovement::SLIDE_SKIN / distance, 0.0f);
+        timeLeft -= timeLeft * hit.time;
+        if (!PlayerMovement::ClipSlideVelocity(slide, velocity, hit.normal)) {
+            break;
+        }
+    }
+
+    m_velocity.x = velocity.x;
+    m_velocity.z = velocity.z;
+    return position;
 }
 
 Vec3 PlayerController::ResolveCollision(const Vec3& desiredPosition) {
@@ -619,7 +692,7 @@ Vec3 PlayerController::ResolveCollision(const Vec3& desiredPosition) {
     }
 
     // Check collision callback for world geometry
-    if (m_collisionCallback) {
+    if (m_callbacks.collision || m_callbacks.capsuleCollision) {
         // Try to resolve by sliding along obstacles
         if (CheckCollision(resolvedPos)) {
             // Try moving only horizontally
@@ -652,5 +725,9 @@ Vec3 PlayerController::ResolveCollision(const Vec3& desiredPosition) {
     return resolvedPos;
 }
 
+// Direct path for the engine's collision world (game/Player.cpp)
+template void PlayerController::Update<PhysicsWorld>(float deltaTime, const PhysicsWorld& world);
+template void PlayerController::Teleport<PhysicsWorld>(const Vec3& position, const PhysicsWorld& world);
+
 } // namespace Genesis
 
@@ -1,7 +1,12 @@
 #pragma once
 
+#include "core/SlotMap.h"
 #include "math/Math.h"
+#include <algorithm>
+#include <concepts>
+#include <cstdint>
 #include <functional>
+#include <type_traits>
 #include <vector>
 
 namespace Genesis {
@@ -42,6 +47,22 @@ struct Capsule {
             base + Vec3(radius, height, radius)
         );
     }
+
+    // Core segment and the radius around it (a capsule shorter than its
+    // diameter degenerates to a sphere)
+    void GetSegment(Vec3& a, Vec3& b, float& segmentRadius) const {
+        segmentRadius = std::min(radius, height * 0.5f);
+        a = base + Vec3(0.0f, segmentRadius, 0.0f);
+        b = base + Vec3(0.0f, height - segmentRadius, 0.0f);
+    }
+
+    // Upright capsule inscribed in bounds
+    static Capsule FromBounds(const AABB& bounds) {
+        Vec3 center = bounds.GetCenter();
+        Vec3 extents = bounds.GetExtents();
+        return Capsule(Vec3(center.x, bounds.min.y, center.z), std::min(extents.x, extents.z),
+                       bounds.max.y - bounds.min.y);
+    }
 };
 
 // ============================================================================
@@ -54,6 +75,17 @@ struct GroundInfo {
     Vec3 groundPoint = Vec3(0.0f);
     bool isOnSlope = false;
     float slopeAngle = 0.0f;
+    SlotHandle groundBox;                       // Collider stood on (invalid: floor, or unknown)
+    Vec3 groundVelocity = Vec3(0.0f);           // Its velocity (moving platforms)
+};
+
+// ============================================================================
+// Sweep Hit - First contact of a swept box (PhysicsWorld::SweepAABB)
+// ============================================================================
+struct SweepHit {
+    float time = 1.0f;              // Fraction of the move before contact (0..1)
+    Vec3 normal = Vec3(0.0f);       // Axis-aligned normal of the surface hit
+    uint32_t box = 0xFFFFFFFFu;     // Index of the box hit
 };
 
 // ============================================================================
@@ -111,6 +143,150 @@ struct PlayerControllerConfig {
     float crouchEyeHeight = 0.9f;
 };
 
+// ============================================================================
+// Player Controller Snapshot - Everything Update() reads and writes
+//
+// POD, so rollback can memcpy it into a RollbackBuffer. Holds the input
+// too: a snapshot taken before a tick replays that tick exactly. Config,
+// callbacks and the collision world are not included and must match when
+// re-simulating.
+// ============================================================================
+struct PlayerControllerSnapshot {
+    static constexpr uint8_t FLAG_SPRINTING  = 1 << 0;
+    static constexpr uint8_t FLAG_CROUCHING  = 1 << 1;
+    static constexpr uint8_t FLAG_JUMPING    = 1 << 2;
+    static constexpr uint8_t FLAG_MOVING     = 1 << 3;
+    static constexpr uint8_t FLAG_WANTS_JUMP = 1 << 4;
+
+    Vec3 position;
+    Vec3 velocity;
+    GroundInfo groundInfo;
+    float jumpCooldownTimer;
+    int32_t airJumpsRemaining;
+
+    // Input
+    Vec3 moveInput;
+    float yaw;
+    float pitch;
+
+    uint8_t flags;
+};
+static_assert(std::is_trivially_copyable_v<PlayerControllerSnapshot>,
+              "PlayerControllerSnapshot is copied as raw bytes");
+// One per tick in the rollback history (64 ticks: ~7.3 KB); update this when
+// adding fields so the history cost stays a decision, not an accident
+static_assert(sizeof(PlayerControllerSnapshot) == 116,
+              "PlayerControllerSnapshot size changed");
+
+// ============================================================================
+// Collision World - The queries PlayerController makes every tick
+//
+// Same signatures as PhysicsWorld, which models this directly: pass it to
+// Update(deltaTime, world) and the queries inline into the controller instead
+// of going through std::function. The template bodies live in
+// PlayerController.cpp, instantiated there for PhysicsWorld and
+// PlayerCollisionCallbacks.
+// ============================================================================
+template<typename World>
+concept PlayerCollisionWorld = requires(const World& world, float f, const Vec3& v,
+                                        const AABB& bounds, SweepHit& hit, Vec3& pushOut) {
+    { world.GetGroundHeight(f, f, f, f) } -> std::convertible_to<float>;
+    { world.CheckCollision(v, bounds, f) } -> std::convertible_to<bool>;
+    { world.SweepAABB(bounds, v, hit, f) } -> std::convertible_to<bool>;
+    { world.GetPenetration(bounds, pushOut, f) } -> std::convertible_to<bool>;
+    { world.GetStairClimbHeight(f, f, f, f, f, v) } -> std::convertible_to<float>;
+};
+
+// Moving ground, also optional: a world that can name the box under the
+// player and give its velocity (PhysicsWorld) lets the controller ride
+// moving platforms; GroundInfo carries the box and velocity.
+template<typename World>
+concept PlayerMovingGroundWorld = requires(const World& world, float f, SlotHandle& box) {
+    { world.GetGroundHeight(f, f, f, f, box) } -> std::convertible_to<float>;
+    { world.GetBoxVelocity(box) } -> std::convertible_to<Vec3>;
+};
+
+// Capsule queries, also optional: with PlayerColliderType::Capsule the
+// collision and depenetration checks go through the world's exact capsule
+// narrowphase instead of the capsule's bounding box.
+template<typename World>
+concept PlayerCapsuleWorld = requires(const World& world, const Capsule& capsule, float f, Vec3& pushOut) {
+    { world.CheckCollision(capsule, f) } -> std::convertible_to<bool>;
+    { world.GetPenetration(capsule, pushOut, f) } -> std::convertible_to<bool>;
+};
+
+// Optional queries. A world with a `bool HasQuery(PlayerQuery) const` can
+// turn them off; any other world answers all of them.
+enum class PlayerQuery {
+    Collision,
+    Sweep,
+    Depenetration,
+    StairClimb,
+    Capsule
+};
+
+// ============================================================================
+// Player Collision Callbacks - std::function adapter for PlayerCollisionWorld
+//
+// Backs PlayerController::Update(deltaTime) and the Set*Callback API. Unset
+// callbacks turn their query off (ground defaults to flat y = 0).
+// ============================================================================
+struct PlayerCollisionCallbacks {
+    using CollisionCallback = std::function<bool(const Vec3& position, const AABB& bounds)>;
+    using GroundHeightCallback = std::function<float(float x, float z, float playerY)>;
+    using SweepCallback = std::function<bool(const AABB& bounds, const Vec3& delta, SweepHit& hit)>;
+    using DepenetrationCallback = std::function<bool(const AABB& bounds, Vec3& pushOut)>;
+    using StairClimbCallback = std::function<float(float x, float z, float playerY, float radius, float maxHeight, const Vec3& moveDir)>;
+    using CapsuleCollisionCallback = std::function<bool(const Capsule& capsule)>;
+    using CapsuleDepenetrationCallback = std::function<bool(const Capsule& capsule, Vec3& pushOut)>;
+
+    CollisionCallback collision;
+    GroundHeightCallback groundHeight;
+    SweepCallback sweep;
+    DepenetrationCallback depenetration;
+    StairClimbCallback stairClimb;
+    CapsuleCollisionCallback capsuleCollision;
+    CapsuleDepenetrationCallback capsuleDepenetration;
+
+    bool HasQuery(PlayerQuery query) const {
+        switch (query) {
+            case PlayerQuery::Collision: return static_cast<bool>(collision);
+            case PlayerQuery::Sweep: return static_cast<bool>(sweep);
+            case PlayerQuery::Depenetration: return static_cast<bool>(depenetration);
+            case PlayerQuery::StairClimb: return static_cast<bool>(stairClimb);
+            case PlayerQuery::Capsule: return capsuleCollision || capsuleDepenetration;
+        }
+        return false;
+    }
+
+    // The callbacks capture their own radius / climb height
+    float GetGroundHeight(float x, float z, float radius, float playerY) const {
+        return groundHeight ? groundHeight(x, z, playerY) : 0.0f;
+    }
+    bool CheckCollision(const Vec3& position, const AABB& bounds, float maxClimbHeight) const {
+        return collision && collision(position, bounds);
+    }
+    bool SweepAABB(const AABB& bounds, const Vec3& delta, SweepHit& hit, float maxClimbHeight) const {
+        return sweep && sweep(bounds, delta, hit);
+    }
+    bool GetPenetration(const AABB& bounds, Vec3& pushOut, float maxClimbHeight) const {
+        return depenetration && depenetration(bounds, pushOut);
+    }
+    float GetStairClimbHeight(float x, float z, float playerY, float radius, float maxHeight, const Vec3& moveDir) const {
+        return stairClimb ? stairClimb(x, z, playerY, radius, maxHeight, moveDir) : -1.0f;
+    }
+
+    // Capsule queries fall back to the box callbacks with the capsule's bounds
+    bool CheckCollision(const Capsule& capsule, float maxClimbHeight) const {
+        return capsuleCollision ? capsuleCollision(capsule)
+                                : CheckCollision(capsule.base, capsule.GetBoundingAABB(), maxClimbHeight);
+    }
+    bool GetPenetration(const Capsule& capsule, Vec3& pushOut, float maxClimbHeight) const {
+        return capsuleDepenetration ? capsuleDepenetration(capsule, pushOut)
+                                    : GetPenetration(capsule.GetBoundingAABB(), pushOut, maxClimbHeight);
+    }
+};
+
 // ============================================================================
 // Player Controller - Handles player physics and movement
 // ============================================================================
@@ -128,7 +304,19 @@ public:
     // ========================================================================
     // Update
     // ========================================================================
-    void Update(float deltaTime);
+    void Update(float deltaTime);   // Through the callbacks below
+
+    // Query the world directly (e.g. PhysicsWorld::Instance()); the
+    // callbacks are ignored. Radius and climb height come from the config.
+    template<PlayerCollisionWorld World>
+    void Update(float deltaTime, const World& world);
+
+    // ========================================================================
+    // Snapshots (rollback / re-simulation)
+    // ========================================================================
+    void SaveSnapshot(PlayerControllerSnapshot& snapshot) const;
+    void RestoreSnapshot(const PlayerControllerSnapshot& snapshot);
+    void RestoreInput(const PlayerControllerSnapshot& snapshot);   // Input fields only
 
     // ========================================================================
     // Movement Input
@@ -145,6 +333,8 @@ public:
     const Vec3& GetPosition() const { return m_position; }
     void SetPosition(const Vec3& position);
     void Teleport(const Vec3& position);
+    template<PlayerCollisionWorld World>
+    void Teleport(const Vec3& position, const World& world);
 
     const Vec3& GetVelocity() const { return m_velocity; }
     void SetVelocity(const Vec3& velocity) { m_velocity = velocity; }
@@ -179,21 +369,34 @@ public:
     AABB GetAABB() const;
 
     // Ground/World collision callback - return true if position is blocked
-    using CollisionCallback = std::function<bool(const Vec3& position, const AABB& bounds)>;
-    void SetCollisionCallback(CollisionCallback callback) { m_collisionCallback = callback; }
+    using CollisionCallback = PlayerCollisionCallbacks::CollisionCallback;
+    void SetCollisionCallback(CollisionCallback callback) { m_callbacks.collision = callback; }
 
     // Ground height callback - returns ground height at XZ position, playerY is current player height
-    using GroundHeightCallback = std::function<float(float x, float z, float playerY)>;
-    void SetGroundHeightCallback(GroundHeightCallback callback) { m_groundHeightCallback = callback; }
+    using GroundHeightCallback = PlayerCollisionCallbacks::GroundHeightCallback;
+    void SetGroundHeightCallback(GroundHeightCallback callback) { m_callbacks.groundHeight = callback; }
+
+    // Sweep callback - moves bounds by delta, returns true and the first
+    // contact if anything blocks it. When set, horizontal movement uses
+    // SlideMove() instead of probing positions with the collision callback.
+    using SweepCallback = PlayerCollisionCallbacks::SweepCallback;
+    void SetSweepCallback(SweepCallback callback) { m_callbacks.sweep = callback; }
 
     // Depenetration callback - returns push direction if stuck
-    using DepenetrationCallback = std::function<bool(const AABB& bounds, Vec3& pushOut)>;
-    void SetDepenetrationCallback(DepenetrationCallback callback) { m_depenetrationCallback = callback; }
+    using DepenetrationCallback = PlayerCollisionCallbacks::DepenetrationCallback;
+    void SetDepenetrationCallback(DepenetrationCallback callback) { m_callbacks.depenetration = callback; }
 
     // Stair climb callback - returns stair top height to auto-climb, or -1 if no stair
     // Parameters: x, z, playerY, radius, maxStairHeight, moveDirection
-    using StairClimbCallback = std::function<float(float x, float z, float playerY, float radius, float maxHeight, const Vec3& moveDir)>;
-    void SetStairClimbCallback(StairClimbCallback callback) { m_stairClimbCallback = callback; }
+    using StairClimbCallback = PlayerCollisionCallbacks::StairClimbCallback;
+    void SetStairClimbCallback(StairClimbCallback callback) { m_callbacks.stairClimb = callback; }
+
+    // Exact capsule tests (used with PlayerColliderType::Capsule, e.g.
+    // PhysicsWorld::CheckCollision(const Capsule&, ...))
+    using CapsuleCollisionCallback = PlayerCollisionCallbacks::CapsuleCollisionCallback;
+    void SetCapsuleCollisionCallback(CapsuleCollisionCallback callback) { m_callbacks.capsuleCollision = callback; }
+    using CapsuleDepenetrationCallback = PlayerCollisionCallbacks::CapsuleDepenetrationCallback;
+    void SetCapsuleDepenetrationCallback(CapsuleDepenetrationCallback callback) { m_callbacks.capsuleDepenetration = callback; }
 
     // Enable/disable auto stair climbing
     void SetAutoClimbStairs(bool enabled) { m_autoClimbStairs = enabled; }
@@ -207,21 +410,29 @@ public:
 
 private:
     // Internal update methods
+    void InheritGroundVelocity();
     void ApplyGravity(float deltaTime);
     void ApplyMovement(float deltaTime);
     void ApplyFriction(float deltaTime);
     void ApplyGroundAcceleration(const Vec3& wishDir, float wishSpeed, float deltaTime);
     void ApplyAirAcceleration(const Vec3& wishDir, float wishSpeed, float deltaTime);
-    void CheckGroundCollision();
+    template<PlayerCollisionWorld World>
+    void CheckGroundCollision(const World& world);
     void HandleStepUp(float deltaTime);
     void HandleSlopes();
     void UpdateCapsule();
 
-    // Helper methods
+    // Helper methods (through the callbacks)
     bool CheckCollision(const Vec3& position) const;
     float GetGroundHeight(float x, float z, float playerY) const;
     Vec3 ResolveCollision(const Vec3& desiredPosition);
 
+    // Quake PM_SlideMove-style horizontal move: sweep, stop at the first
+    // contact, clip the velocity against the planes hit and sweep the rest.
+    // Returns the final position; clips m_velocity's XZ in place.
+    template<PlayerCollisionWorld World>
+    Vec3 SlideMove(const World& world, const Vec3& start, float deltaTime, float boundsOffsetY, const Vec3& extents);
+
 private:
     // Configuration
     PlayerControllerConfig m_config;
@@ -258,11 +469,8 @@ private:
     // Auto stair climbing
     bool m_autoClimbStairs = true;
 
-    // Callbacks
-    CollisionCallback m_collisionCallback;
-    GroundHeightCallback m_groundHeightCallback;
-    DepenetrationCallback m_depenetrationCallback;
-    StairClimbCallback m_stairClimbCallback;
+    // Callbacks (world for Update(deltaTime))
+    PlayerCollisionCallbacks m_callbacks;
 };
 
 } // namespace Genesis
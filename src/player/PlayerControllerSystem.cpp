@@ -0,0 +1,416 @@
+#include "PlayerControllerSystem.h"
+#include <cmath>
+#include <algorithm>
+
+namespace Genesis {
+
+namespace {
+
+// Move the last element into the hole left by SlotMap::Remove
+template<typename T>
+void SwapRemove(std::vector<T>& values, uint32_t hole) {
+    values[hole] = values.back();
+    values.pop_back();
+}
+
+} // anonymous namespace
+
+PlayerControllerSystem::PlayerControllerSystem(PhysicsWorld& world)
+    : m_world(world) {
+    m_configs.emplace_back();
+}
+
+// ============================================================================
+// Configs
+// ============================================================================
+
+uint32_t PlayerControllerSystem::AddConfig(const PlayerControllerConfig& config) {
+    m_configs.push_back(config);
+    return static_cast<uint32_t>(m_configs.size() - 1);
+}
+
+void PlayerControllerSystem::SetConfig(uint32_t index, const PlayerControllerConfig& config) {
+    if (index < m_configs.size()) {
+        m_configs[index] = config;
+    }
+}
+
+// ============================================================================
+// Agents
+// ============================================================================
+
+PlayerAgentHandle PlayerControllerSystem::Add(const Vec3& position, uint32_t config) {
+    if (config >= m_configs.size()) {
+        config = 0;
+    }
+
+    PlayerAgentHandle handle = m_handles.Insert();
+    m_position.push_back(position);
+    m_velocity.push_back(Vec3(0.0f));
+    m_moveInput.push_back(Vec3(0.0f));
+    m_yaw.push_back(0.0f);
+    m_jumpCooldown.push_back(0.0f);
+    m_airJumps.push_back(m_configs[config].maxAirJumps);
+    m_config.push_back(config);
+    m_flags.push_back(0);
+    CheckGround(m_handles.Size() - 1);
+    return handle;
+}
+
+void PlayerControllerSystem::Remove(PlayerAgentHandle handle) {
+    uint32_t hole = m_handles.Remove(handle);
+    if (hole == SlotMap::INVALID_INDEX) return;
+
+    SwapRemove(m_position, hole);
+    SwapRemove(m_velocity, hole);
+    SwapRemove(m_moveInput, hole);
+    SwapRemove(m_yaw, hole);
+    SwapRemove(m_jumpCooldown, hole);
+    SwapRemove(m_airJumps, hole);
+    SwapRemove(m_config, hole);
+    SwapRemove(m_flags, hole);
+}
+
+void PlayerControllerSystem::Clear() {
+    m_handles.Clear();
+    m_position.clear();
+    m_velocity.clear();
+    m_moveInput.clear();
+    m_yaw.clear();
+    m_jumpCooldown.clear();
+    m_airJumps.clear();
+    m_config.clear();
+    m_flags.clear();
+}
+
+void PlayerControllerSystem::Reserve(size_t count) {
+    m_handles.Reserve(count);
+    m_position.reserve(count);
+    m_velocity.reserve(count);
+    m_moveInput.reserve(count);
+    m_yaw.reserve(count);
+    m_jumpCooldown.reserve(count);
+    m_airJumps.reserve(count);
+    m_config.reserve(count);
+    m_flags.reserve(count);
+}
+
+// ============================================================================
+// Input / State
+// ============================================================================
+
+void PlayerControllerSystem::SetMoveInput(PlayerAgentHandle handle, const Vec3& input) {
+    uint32_t i = m_handles.GetDenseIndex(handle);
+    if (i == SlotMap::INVALID_INDEX) return;
+
+    // Clamp input magnitude
+    Vec3 clamped = input;
+    float length = Math::Length(Vec3(input.x, 0.0f, input.z));
+    if (length > 1.0f) {
+        clamped.x /= length;
+        clamped.z /= length;
+    }
+    m_moveInput[i] = clamped;
+    SetFlag(i, AGENT_MOVING, length > 0.01f);
+}
+
+void PlayerControllerSystem::SetYaw(PlayerAgentHandle handle, float yaw) {
+    uint32_t i = m_handles.GetDenseIndex(handle);
+    if (i != SlotMap::INVALID_INDEX) m_yaw[i] = yaw;
+}
+
+void PlayerControllerSystem::Jump(PlayerAgentHandle handle) {
+    uint32_t i = m_handles.GetDenseIndex(handle);
+    if (i != SlotMap::INVALID_INDEX) SetFlag(i, AGENT_WANTS_JUMP, true);
+}
+
+void PlayerControllerSystem::SetSprinting(PlayerAgentHandle handle, bool sprinting) {
+    uint32_t i = m_handles.GetDenseIndex(handle);
+    if (i != SlotMap::INVALID_INDEX) SetFlag(i, AGENT_SPRINTING, sprinting && !Has(i, AGENT_CROUCHING));
+}
+
+void PlayerControllerSystem::SetCrouching(PlayerAgentHandle handle, bool crouching) {
+    uint32_t i = m_handles.GetDenseIndex(handle);
+    if (i == SlotMap::INVALID_INDEX) return;
+    SetFlag(i, AGENT_CROUCHING, crouching);
+    if (crouching) SetFlag(i, AGENT_SPRINTING, false);
+}
+
+Vec3 PlayerControllerSystem::GetPosition(PlayerAgentHandle handle) const {
+    uint32_t i = m_handles.GetDenseIndex(handle);
+    return i != SlotMap::INVALID_INDEX ? m_position[i] : Vec3(0.0f);
+}
+
+Vec3 PlayerControllerSystem::GetVelocity(PlayerAgentHandle handle) const {
+    uint32_t i = m_handles.GetDenseIndex(handle);
+    return i != SlotMap::INVALID_INDEX ? m_velocity[i] : Vec3(0.0f);
+}
+
+bool PlayerControllerSystem::IsGrounded(PlayerAgentHandle handle) const {
+    uint32_t i = m_handles.GetDenseIndex(handle);
+    return i != SlotMap::INVALID_INDEX && Has(i, AGENT_GROUNDED);
+}
+
+void PlayerControllerSystem::SetVelocity(PlayerAgentHandle handle, const Vec3& velocity) {
+    uint32_t i = m_handles.GetDenseIndex(handle);
+    if (i != SlotMap::INVALID_INDEX) m_velocity[i] = velocity;
+}
+
+void PlayerControllerSystem::Teleport(PlayerAgentHandle handle, const Vec3& position) {
+    uint32_t i = m_handles.GetDenseIndex(handle);
+    if (i == SlotMap::INVALID_INDEX) return;
+    m_position[i] = position;
+    m_velocity[i] = Vec3(0.0f);
+    SetFlag(i, AGENT_JUMPING, false);
+    CheckGround(i);
+}
+
+void PlayerControllerSystem::CheckGround(uint32_t i) {
+    // PlayerController::CheckGroundCollision for a standing agent
+    const PlayerControllerConfig& config = ConfigOf(i);
+    Vec3& position = m_position[i];
+    float groundHeight = m_world.GetGroundHeight(position.x, position.z, config.capsuleRadius, position.y);
+    float distanceToGround = position.y - groundHeight;
+
+    SetFlag(i, AGENT_GROUNDED, distanceToGround <= config.groundCheckDistance);
+    if (distanceToGround <= 0.0f) {
+        position.y = groundHeight;
+    }
+}
+
+float PlayerControllerSystem::HeightOf(uint32_t i) const {
+    const PlayerControllerConfig& config = ConfigOf(i);
+    return Has(i, AGENT_CROUCHING) ? config.capsuleHeight * 0.5f : config.capsuleHeight;
+}
+
+// ============================================================================
+// Update
+// ============================================================================
+
+void PlayerControllerSystem::Update(float deltaTime) {
+    if (m_position.empty()) return;
+
+    m_newPosition.resize(m_position.size());
+    UpdateMovement(deltaTime);
+    UpdateStairs(deltaTime);
+    UpdateSlideMove(deltaTime);
+    UpdateGround();
+    UpdateDepenetration();
+}
+
+void PlayerControllerSystem::UpdateMovement(float deltaTime) {
+    for (uint32_t i = 0; i < m_position.size(); i++) {
+        const PlayerControllerConfig& config = ConfigOf(i);
+        Vec3& velocity = m_velocity[i];
+
+        if (m_jumpCooldown[i] > 0.0f) {
+            m_jumpCooldown[i] -= deltaTime;
+        }
+
+        // Jump before the ground check so we can leave the ground
+        if (Has(i, AGENT_WANTS_JUMP)) {
+            if (m_jumpCooldown[i] <= 0.0f) {
+                bool canJump = Has(i, AGENT_GROUNDED);
+                if (!canJump && m_airJumps[i] > 0) {
+                    canJump = true;
+                    m_airJumps[i]--;
+                }
+                if (canJump) {
+                    velocity.y = config.jumpForce;
+                    m_jumpCooldown[i] = config.jumpCooldown;
+                    SetFlag(i, AGENT_JUMPING, true);
+                    SetFlag(i, AGENT_GROUNDED, false);
+                }
+            }
+            SetFlag(i, AGENT_WANTS_JUMP, false);
+        }
+
+        bool grounded = Has(i, AGENT_GROUNDED);
+        if (!grounded || Has(i, AGENT_JUMPING)) {
+            velocity.y -= config.gravity * deltaTime;
+            velocity.y = std::max(velocity.y, -config.maxFallSpeed);
+        }
+
+        float maxSpeed = PlayerMovement::GetMaxSpeed(config, Has(i, AGENT_SPRINTING),
+                                                     Has(i, AGENT_MOVING), Has(i, AGENT_CROUCHING));
+        Vec3 wishDir;
+        float wishSpeed;
+        PlayerMovement::GetWishMove(m_yaw[i], m_moveInput[i], maxSpeed, wishDir, wishSpeed);
+        if (grounded) {
+            PlayerMovement::ApplyFriction(velocity, config, Has(i, AGENT_MOVING), deltaTime);
+            PlayerMovement::ApplyGroundAcceleration(velocity, wishDir, wishSpeed, config, deltaTime);
+        } else {
+            PlayerMovement::ApplyAirAcceleration(velocity, wishDir, wishSpeed, config, deltaTime);
+        }
+
+        m_newPosition[i] = m_position[i] + velocity * deltaTime;
+    }
+}
+
+void PlayerControllerSystem::UpdateStairs(float deltaTime) {
+    m_queryAgents.clear();
+    m_stairQueries.clear();
+    for (uint32_t i = 0; i < m_position.size(); i++) {
+        if (!Has(i, AGENT_GROUNDED) || !Has(i, AGENT_MOVING)) continue;
+
+        const Vec3& velocity = m_velocity[i];
+        float horizSpeed = std::sqrt(velocity.x * velocity.x + velocity.z * velocity.z);
+        if (horizSpeed <= 0.1f) continue;
+
+        const PlayerControllerConfig& config = ConfigOf(i);
+        Vec3 moveDir(velocity.x / horizSpeed, 0.0f, velocity.z / horizSpeed);
+        m_queryAgents.push_back(i);
+        m_stairQueries.push_back({ m_newPosition[i].x, m_newPosition[i].z, m_position[i].y,
+                                   config.capsuleRadius, config.autoClimbStairHeight, moveDir });
+    }
+    if (m_queryAgents.empty()) return;
+
+    m_heights.resize(m_stairQueries.size());
+    m_world.GetStairClimbHeights(m_stairQueries, m_heights);
+
+    for (size_t q = 0; q < m_queryAgents.size(); q++) {
+        uint32_t i = m_queryAgents[q];
+        float stairTop = m_heights[q];
+        if (stairTop <= 0.0f || stairTop <= m_position[i].y) continue;
+
+        float heightDiff = stairTop - m_position[i].y;
+        float climbAmount = ConfigOf(i).stairClimbSpeed * deltaTime;
+        m_newPosition[i].y = climbAmount >= heightDiff ? stairTop : m_position[i].y + climbAmount;
+
+        // Keep grounded during stair climb
+        SetFlag(i, AGENT_GROUNDED, true);
+        m_velocity[i].y = 0.0f;
+    }
+}
+
+void PlayerControllerSystem::UpdateSlideMove(float deltaTime) {
+    // Same bounds as PlayerController: raised off the ground, so the boxes
+    // being stood on don't block
+    m_slides.clear();
+    for (uint32_t i = 0; i < m_position.size(); i++) {
+        const PlayerControllerConfig& config = ConfigOf(i);
+        float stepOffset = config.stepHeight + 0.15f;
+        float checkHeight = HeightOf(i) - stepOffset;
+        if (checkHeight <= 0.1f) continue;
+
+        SlideAgent agent;
+        agent.agent = i;
+        agent.position = m_position[i];
+        agent.velocity = Vec3(m_velocity[i].x, 0.0f, m_velocity[i].z);
+        agent.timeLeft = deltaTime;
+        agent.boundsOffsetY = stepOffset + checkHeight * 0.5f;
+        agent.extents = Vec3(config.capsuleRadius * 0.95f, checkHeight * 0.5f, config.capsuleRadius * 0.95f);
+        agent.slide.primalVelocity = agent.velocity;
+        m_slides.push_back(agent);
+    }
+
+    auto finish = [this](const SlideAgent& agent) {
+        m_newPosition[agent.agent].x = agent.position.x;
+        m_newPosition[agent.agent].z = agent.position.z;
+        m_velocity[agent.agent].x = agent.velocity.x;
+        m_velocity[agent.agent].z = agent.velocity.z;
+    };
+
+    // One batched sweep per bump; agents drop out as their move completes
+    for (int bump = 0; bump < PlayerMovement::SLIDE_MAX_BUMPS && !m_slides.empty(); bump++) {
+        m_sweepQueries.clear();
+        size_t active = 0;
+        for (const SlideAgent& agent : m_slides) {
+            Vec3 delta = agent.velocity * agent.timeLeft;
+            if (Math::Length(delta) < 1e-6f) {
+                finish(agent);
+                continue;
+            }
+            AABB bounds = AABB::FromCenterExtents(agent.position + Vec3(0.0f, agent.boundsOffsetY, 0.0f), agent.extents);
+            m_sweepQueries.push_back({ bounds, delta, ConfigOf(agent.agent).autoClimbStairHeight });
+            m_slides[active++] = agent;
+        }
+        m_slides.resize(active);
+        if (m_slides.empty()) break;
+
+        m_hits.resize(m_sweepQueries.size());
+        m_world.SweepAABBs(m_sweepQueries, m_hits);
+
+        active = 0;
+        for (size_t q = 0; q < m_slides.size(); q++) {
+            SlideAgent agent = m_slides[q];
+            const Vec3& delta = m_sweepQueries[q].delta;
+            const SweepHit& hit = m_hits[q];
+
+            if (hit.box == SweepHit().box) {
+                agent.position += delta;
+                finish(agent);
+                continue;
+            }
+
+            float distance = Math::Length(delta);
+            agent.position += delta * std::max(hit.time - PlayerMovement::SLIDE_SKIN / distance, 0.0f);
+            agent.timeLeft -= agent.timeLeft * hit.time;
+            if (!PlayerMovement::ClipSlideVelocity(agent.slide, agent.velocity, hit.normal)) {
+                finish(agent);
+                continue;
+            }
+            m_slides[active++] = agent;
+        }
+        m_slides.resize(active);
+    }
+
+    // Out of bumps: keep what was reached
+    for (const SlideAgent& agent : m_slides) {
+        finish(agent);
+    }
+}
+
+void PlayerControllerSystem::UpdateGround() {
+    m_groundQueries.resize(m_position.size());
+    for (uint32_t i = 0; i < m_position.size(); i++) {
+        m_groundQueries[i] = { m_newPosition[i].x, m_newPosition[i].z, m_position[i].y, ConfigOf(i).capsuleRadius };
+    }
+    m_heights.resize(m_groundQueries.size());
+    m_world.GetGroundHeights(m_groundQueries, m_heights);
+
+    for (uint32_t i = 0; i < m_position.size(); i++) {
+        const PlayerControllerConfig& config = ConfigOf(i);
+        Vec3& newPosition = m_newPosition[i];
+        float groundHeight = m_heights[i];
+
+        if (newPosition.y <= groundHeight) {
+            // Landed (or still standing)
+            newPosition.y = groundHeight;
+            if (m_velocity[i].y < 0.0f) {
+                m_velocity[i].y = 0.0f;
+            }
+            SetFlag(i, AGENT_GROUNDED, true);
+            SetFlag(i, AGENT_JUMPING, false);
+            m_airJumps[i] = config.maxAirJumps;
+        } else if (newPosition.y - groundHeight > config.groundCheckDistance) {
+            SetFlag(i, AGENT_GROUNDED, false);
+        }
+
+        m_position[i] = newPosition;
+    }
+}
+
+void PlayerControllerSystem::UpdateDepenetration() {
+    m_penetrationQueries.resize(m_position.size());
+    for (uint32_t i = 0; i < m_position.size(); i++) {
+        const PlayerControllerConfig& config = ConfigOf(i);
+        float height = HeightOf(i);
+        Vec3 halfExtents = config.colliderType == PlayerColliderType::Capsule
+            ? Vec3(config.capsuleRadius, height * 0.5f, config.capsuleRadius)
+            : config.aabbHalfExtents;
+        AABB bounds = AABB::FromCenterExtents(m_position[i] + Vec3(0.0f, height * 0.5f, 0.0f), halfExtents);
+        m_penetrationQueries[i] = { bounds, config.autoClimbStairHeight };
+    }
+    m_pushOuts.resize(m_penetrationQueries.size());
+    m_world.GetPenetrations(m_penetrationQueries, m_pushOuts);
+
+    for (uint32_t i = 0; i < m_position.size(); i++) {
+        const Vec3& pushOut = m_pushOuts[i];
+        m_position[i] += pushOut;
+        if (pushOut.x != 0.0f) m_velocity[i].x = 0.0f;
+        if (pushOut.z != 0.0f) m_velocity[i].z = 0.0f;
+    }
+}
+
+} // namespace Genesis
@@ -0,0 +1,145 @@
+#pragma once
+
+#include "PlayerController.h"
+#include "PlayerMovement.h"
+#include "physics/PhysicsWorld.h"
+#include "core/SlotMap.h"
+#include <span>
+#include <vector>
+
+namespace Genesis {
+
+using PlayerAgentHandle = SlotHandle;
+
+// ============================================================================
+// PlayerControllerSystem - Many PlayerControllers updated in one pass
+//
+// For bots and server simulation (64+ agents per tick). Agent state lives in
+// dense SoA arrays behind generational handles; configs are shared through
+// a small table (agents reference one by index), so per-agent memory is just
+// the simulation state.
+//
+// Update() runs the PlayerController rules (PlayerMovement) phase by phase
+// over all agents: movement, stair climbing, slide move, ground and
+// depenetration. Each phase gathers its PhysicsWorld queries and answers
+// them with one batched call, instead of four std::function callbacks per
+// agent. Collision is always continuous (SweepAABB), as in PlayerController
+// with a sweep callback set.
+// ============================================================================
+class PlayerControllerSystem {
+public:
+    explicit PlayerControllerSystem(PhysicsWorld& world);
+
+    // ========================================================================
+    // Configs (index 0 is the default PlayerControllerConfig)
+    // ========================================================================
+    uint32_t AddConfig(const PlayerControllerConfig& config);
+    void SetConfig(uint32_t index, const PlayerControllerConfig& config);
+    const PlayerControllerConfig& GetConfig(uint32_t index) const { return m_configs[index]; }
+    uint32_t GetConfigCount() const { return static_cast<uint32_t>(m_configs.size()); }
+
+    // ========================================================================
+    // Agents
+    // ========================================================================
+    PlayerAgentHandle Add(const Vec3& position, uint32_t config = 0);
+    void Remove(PlayerAgentHandle handle);
+    void Clear();
+    void Reserve(size_t count);
+
+    bool IsAlive(PlayerAgentHandle handle) const { return m_handles.IsAlive(handle); }
+    uint32_t GetAgentCount() const { return m_handles.Size(); }
+
+    // ========================================================================
+    // Input (same meaning as the PlayerController methods)
+    // ========================================================================
+    void SetMoveInput(PlayerAgentHandle handle, const Vec3& input);
+    void SetYaw(PlayerAgentHandle handle, float yaw);
+    void Jump(PlayerAgentHandle handle);
+    void SetSprinting(PlayerAgentHandle handle, bool sprinting);
+    void SetCrouching(PlayerAgentHandle handle, bool crouching);
+
+    // ========================================================================
+    // State
+    // ========================================================================
+    Vec3 GetPosition(PlayerAgentHandle handle) const;
+    Vec3 GetVelocity(PlayerAgentHandle handle) const;
+    bool IsGrounded(PlayerAgentHandle handle) const;
+    void SetVelocity(PlayerAgentHandle handle, const Vec3& velocity);
+    void Teleport(PlayerAgentHandle handle, const Vec3& position);
+
+    // Dense views for bulk readers (snapshots, replication); index i
+    // belongs to GetHandle(i)
+    std::span<const Vec3> GetPositions() const { return m_position; }
+    std::span<const Vec3> GetVelocities() const { return m_velocity; }
+    PlayerAgentHandle GetHandle(uint32_t dense) const { return m_handles.GetHandle(dense); }
+
+    // ========================================================================
+    // Update
+    // ========================================================================
+    void Update(float deltaTime);
+
+private:
+    enum AgentFlags : uint8_t {
+        AGENT_GROUNDED   = 1 << 0,
+        AGENT_JUMPING    = 1 << 1,
+        AGENT_SPRINTING  = 1 << 2,
+        AGENT_CROUCHING  = 1 << 3,
+        AGENT_MOVING     = 1 << 4,
+        AGENT_WANTS_JUMP = 1 << 5
+    };
+
+    bool Has(uint32_t i, uint8_t flag) const { return (m_flags[i] & flag) != 0; }
+    void SetFlag(uint32_t i, uint8_t flag, bool on) {
+        m_flags[i] = on ? (m_flags[i] | flag) : (m_flags[i] & ~flag);
+    }
+    const PlayerControllerConfig& ConfigOf(uint32_t i) const { return m_configs[m_config[i]]; }
+    float HeightOf(uint32_t i) const;
+    void CheckGround(uint32_t i);   // Single query, after Add/Teleport
+
+    // Update phases (dense indices)
+    void UpdateMovement(float deltaTime);
+    void UpdateStairs(float deltaTime);
+    void UpdateSlideMove(float deltaTime);
+    void UpdateGround();
+    void UpdateDepenetration();
+
+private:
+    PhysicsWorld& m_world;
+    std::vector<PlayerControllerConfig> m_configs;
+
+    // Agent state, parallel and packed by dense index
+    SlotMap m_handles;
+    std::vector<Vec3> m_position;
+    std::vector<Vec3> m_velocity;
+    std::vector<Vec3> m_moveInput;
+    std::vector<float> m_yaw;
+    std::vector<float> m_jumpCooldown;
+    std::vector<int32_t> m_airJumps;
+    std::vector<uint32_t> m_config;
+    std::vector<uint8_t> m_flags;
+
+    // Per-tick scratch (kept to avoid reallocating every Update)
+    std::vector<Vec3> m_newPosition;
+    std::vector<uint32_t> m_queryAgents;
+    std::vector<GroundQuery> m_groundQueries;
+    std::vector<StairClimbQuery> m_stairQueries;
+    std::vector<SweepQuery> m_sweepQueries;
+    std::vector<PenetrationQuery> m_penetrationQueries;
+    std::vector<float> m_heights;
+    std::vector<SweepHit> m_hits;
+    std::vector<Vec3> m_pushOuts;
+
+    // Slide move in flight for one agent (PlayerController::SlideMove state)
+    struct SlideAgent {
+        uint32_t agent;
+        Vec3 position;
+        Vec3 velocity;
+        float timeLeft;
+        float boundsOffsetY;
+        Vec3 extents;
+        PlayerMovement::SlideState slide;
+    };
+    std::vector<SlideAgent> m_slides;
+};
+
+} // namespace Genesis
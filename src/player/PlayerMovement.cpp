@@ -0,0 +1,204 @@
+#include "PlayerMovement.h"
+#include <cmath>
+#include <algorithm>
+
+namespace Genesis {
+namespace PlayerMovement {
+
+float GetMaxSpeed(const PlayerControllerConfig& config, bool sprinting, bool moving, bool crouching) {
+    if (sprinting && moving) {
+        return config.sprintSpeed;
+    }
+    if (crouching) {
+        return config.crouchSpeed;
+    }
+    return config.walkSpeed;
+}
+
+Vec3 GetForwardXZ(float yaw) {
+    float yawRad = Math::Radians(yaw);
+    return Math::Normalize(Vec3(cos(yawRad), 0.0f, sin(yawRad)));
+}
+
+Vec3 GetRightXZ(float yaw) {
+    float yawRad = Math::Radians(yaw);
+    return Math::Normalize(Vec3(-sin(yawRad), 0.0f, cos(yawRad)));
+}
+
+void GetWishMove(float yaw, const Vec3& moveInput, float maxSpeed, Vec3& wishDir, float& wishSpeed) {
+    wishDir = Vec3(0.0f);
+    wishDir += GetForwardXZ(yaw) * moveInput.z;  // Forward/back
+    wishDir += GetRightXZ(yaw) * moveInput.x;    // Left/right
+
+    wishSpeed = Math::Length(wishDir);
+    if (wishSpeed > 0.0001f) {
+        wishDir = Math::Normalize(wishDir);
+        wishSpeed = std::min(wishSpeed, 1.0f) * maxSpeed;
+    } else {
+        wishDir = Vec3(0.0f);
+        wishSpeed = 0.0f;
+    }
+}
+
+// ============================================================================
+// Source-Style Friction
+// ============================================================================
+void ApplyFriction(Vec3& velocity, const PlayerControllerConfig& config, bool moving, float deltaTime) {
+    Vec3 vel = Vec3(velocity.x, 0.0f, velocity.z);
+    float speed = Math::Length(vel);
+
+    if (speed < 0.1f) {
+        // Below threshold, just stop
+        velocity.x = 0.0f;
+        velocity.z = 0.0f;
+        return;
+    }
+
+    // Apply much stronger friction when not providing input
+    float friction = config.groundFriction;
+    if (!moving) {
+        // Apply extra stopping friction when no input
+        friction *= 2.5f;
+    }
+
+    // Calculate friction drop
+    // Source uses: drop = speed * friction * deltaTime
+    // But if speed < stopspeed, use stopspeed for the calculation
+    float control = (speed < config.stopSpeed) ? config.stopSpeed : speed;
+    float drop = control * friction * deltaTime;
+
+    // Scale the velocity
+    float newSpeed = speed - drop;
+    if (newSpeed < 0.0f) {
+        newSpeed = 0.0f;
+    }
+
+    if (speed > 0.0f) {
+        float scale = newSpeed / speed;
+        velocity.x *= scale;
+        velocity.z *= scale;
+    }
+}
+
+// ============================================================================
+// Source-Style Ground Acceleration
+// ============================================================================
+void ApplyGroundAcceleration(Vec3& velocity, const Vec3& wishDir, float wishSpeed,
+                             const PlayerControllerConfig& config, float deltaTime) {
+    // Current speed in wish direction
+    float currentSpeed = Math::Dot(Vec3(velocity.x, 0.0f, velocity.z), wishDir);
+
+    // How much we need to add
+    float addSpeed = wishSpeed - currentSpeed;
+
+    if (addSpeed <= 0.0f) {
+        return;  // Already going fast enough in this direction
+    }
+
+    // Acceleration: accelspeed = accel * deltaTime * wishspeed
+    float accelSpeed = config.groundAccelerate * deltaTime * wishSpeed;
+
+    // Cap the acceleration
+    if (accelSpeed > addSpeed) {
+        accelSpeed = addSpeed;
+    }
+
+    // Add to velocity
+    velocity.x += accelSpeed * wishDir.x;
+    velocity.z += accelSpeed * wishDir.z;
+}
+
+// ============================================================================
+// Source-Style Air Acceleration (enables strafing/bhop)
+// ============================================================================
+void ApplyAirAcceleration(Vec3& velocity, const Vec3& wishDir, float wishSpeed,
+                          const PlayerControllerConfig& config, float deltaTime) {
+    // Cap wish speed for air movement (this is key for strafe jumping)
+    float wishSpeedCapped = std::min(wishSpeed, config.airSpeedCap * config.walkSpeed);
+
+    // Current speed in wish direction
+    float currentSpeed = Math::Dot(Vec3(velocity.x, 0.0f, velocity.z), wishDir);
+
+    // How much we need to add
+    float addSpeed = wishSpeedCapped - currentSpeed;
+
+    if (addSpeed <= 0.0f) {
+        return;
+    }
+
+    // Air acceleration
+    float accelSpeed = config.airAccelerate * deltaTime * wishSpeed;
+
+    // Cap it
+    if (accelSpeed > addSpeed) {
+        accelSpeed = addSpeed;
+    }
+
+    // Add to velocity
+    velocity.x += accelSpeed * wishDir.x;
+    velocity.z += accelSpeed * wishDir.z;
+
+    // Optional: Apply air friction (usually 0 in Source)
+    if (config.airFriction > 0.0f) {
+        Vec3 vel = Vec3(velocity.x, 0.0f, velocity.z);
+        float speed = Math::Length(vel);
+        if (speed > 0.1f) {
+            float drop = speed * config.airFriction * deltaTime;
+            float newSpeed = std::max(0.0f, speed - drop);
+            float scale = newSpeed / speed;
+            velocity.x *= scale;
+            velocity.z *= scale;
+        }
+    }
+}
+
+// ============================================================================
+// Slide Move
+// ============================================================================
+bool ClipSlideVelocity(SlideState& state, Vec3& velocity, const Vec3& normal) {
+    if (state.planeCount >= SLIDE_MAX_PLANES) {
+        velocity = Vec3(0.0f);
+        return false;
+    }
+    state.planes[state.planeCount++] = normal;
+
+    // Find a plane whose clipped velocity doesn't move into any other
+    Vec3 original = velocity;
+    int i = 0;
+    for (; i < state.planeCount; i++) {
+        velocity = original - state.planes[i] * Math::Dot(original, state.planes[i]);
+        int j = 0;
+        for (; j < state.planeCount; j++) {
+            if (j != i && Math::Dot(velocity, state.planes[j]) < 0.0f) break;
+        }
+        if (j == state.planeCount) break;
+    }
+
+    if (i == state.planeCount) {
+        // Wedged between two planes: slide along their crease (vertical
+        // for two walls, so this stops horizontal movement in a corner)
+        if (state.planeCount != 2) {
+            velocity = Vec3(0.0f);
+            return false;
+        }
+        Vec3 crease = glm::cross(state.planes[0], state.planes[1]);
+        float creaseLength = Math::Length(crease);
+        if (creaseLength < 1e-6f) {
+            velocity = Vec3(0.0f);
+            return false;
+        }
+        crease /= creaseLength;
+        velocity = crease * Math::Dot(crease, velocity);
+        velocity.y = 0.0f;
+    }
+
+    // Never turn back against the original move (avoids corner jitter)
+    if (Math::Dot(velocity, state.primalVelocity) <= 0.0f) {
+        velocity = Vec3(0.0f);
+        return false;
+    }
+    return true;
+}
+
+} // namespace PlayerMovement
+} // namespace Genesis
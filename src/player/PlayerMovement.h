@@ -0,0 +1,52 @@
+#pragma once
+
+#include "PlayerController.h"
+
+namespace Genesis {
+
+// ============================================================================
+// PlayerMovement - Source-style movement math shared by PlayerController
+// and PlayerControllerSystem
+//
+// Free functions over plain state, so the single controller (members) and
+// the batched system (SoA arrays) run exactly the same rules.
+// ============================================================================
+namespace PlayerMovement {
+
+    // Max speed for the current state
+    float GetMaxSpeed(const PlayerControllerConfig& config, bool sprinting, bool moving, bool crouching);
+
+    // Forward/right on the XZ plane for a yaw in degrees
+    Vec3 GetForwardXZ(float yaw);
+    Vec3 GetRightXZ(float yaw);
+
+    // World-space wish direction and speed from input (x = strafe, z = forward)
+    void GetWishMove(float yaw, const Vec3& moveInput, float maxSpeed, Vec3& wishDir, float& wishSpeed);
+
+    void ApplyFriction(Vec3& velocity, const PlayerControllerConfig& config, bool moving, float deltaTime);
+    void ApplyGroundAcceleration(Vec3& velocity, const Vec3& wishDir, float wishSpeed,
+                                 const PlayerControllerConfig& config, float deltaTime);
+    void ApplyAirAcceleration(Vec3& velocity, const Vec3& wishDir, float wishSpeed,
+                              const PlayerControllerConfig& config, float deltaTime);
+
+    // ========================================================================
+    // Slide Move (Quake PM_SlideMove) - one bump at a time
+    // ========================================================================
+    constexpr int SLIDE_MAX_BUMPS = 4;
+    constexpr int SLIDE_MAX_PLANES = 5;
+    constexpr float SLIDE_SKIN = 0.001f;   // Stop this far short of a contact
+
+    struct SlideState {
+        Vec3 primalVelocity = Vec3(0.0f);   // Horizontal velocity at the start
+        Vec3 planes[SLIDE_MAX_PLANES];
+        int planeCount = 0;
+    };
+
+    // Clip velocity after a contact with the given normal: find a plane whose
+    // clipped velocity doesn't move into any other, else slide along a
+    // two-plane crease. Returns false (velocity zeroed) when it must stop.
+    bool ClipSlideVelocity(SlideState& state, Vec3& velocity, const Vec3& normal);
+
+} // namespace PlayerMovement
+
+} // namespace Genesis
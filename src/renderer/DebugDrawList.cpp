@@ -0,0 +1,261 @@
+#include "DebugDrawList.h"
+#include <cmath>
+
+namespace Genesis {
+
+void DebugDrawList::Clear() {
+    m_lineVertices.clear();
+    m_triVertices.clear();
+    for (auto& instances : m_shapeInstances) {
+        instances.clear();
+    }
+}
+
+void DebugDrawList::Append(const DebugDrawList& other) {
+    m_lineVertices.insert(m_lineVertices.end(), other.m_lineVertices.begin(), other.m_lineVertices.end());
+    m_triVertices.insert(m_triVertices.end(), other.m_triVertices.begin(), other.m_triVertices.end());
+    for (size_t s = 0; s < SHAPE_COUNT; s++) {
+        m_shapeInstances[s].insert(m_shapeInstances[s].end(), other.m_shapeInstances[s].begin(),
+                                   other.m_shapeInstances[s].end());
+    }
+}
+
+bool DebugDrawList::IsEmpty() const {
+    if (!m_lineVertices.empty() || !m_triVertices.empty()) return false;
+    for (const auto& instances : m_shapeInstances) {
+        if (!instances.empty()) return false;
+    }
+    return true;
+}
+
+void DebugDrawList::DrawLine(float x1, float y1, float z1, float x2, float y2, float z2,
+                              float r, float g, float b) {
+    m_lineVertices.emplace_back(x1, y1, z1, r, g, b);
+    m_lineVertices.emplace_back(x2, y2, z2, r, g, b);
+}
+
+void DebugDrawList::DrawGrid(float size, float spacing, float r, float g, float b) {
+    float halfSize = size / 2.0f;
+    int lines = static_cast<int>(size / spacing);
+
+    for (int i = -lines / 2; i <= lines / 2; i++) {
+        float pos = i * spacing;
+
+        // Skip center lines (they'll be drawn as axes)
+        if (i == 0) continue;
+
+        // Lines parallel to X axis
+        DrawLine(-halfSize, 0, pos, halfSize, 0, pos, r, g, b);
+
+        // Lines parallel to Z axis
+        DrawLine(pos, 0, -halfSize, pos, 0, halfSize, r, g, b);
+    }
+}
+
+void DebugDrawList::DrawAxes(float length) {
+    // X axis - Red
+    DrawLine(0, 0, 0, length, 0, 0, 1.0f, 0.2f, 0.2f);
+    // Small arrow head for X
+    DrawLine(length, 0, 0, length - 0.2f, 0.1f, 0, 1.0f, 0.2f, 0.2f);
+    DrawLine(length, 0, 0, length - 0.2f, -0.1f, 0, 1.0f, 0.2f, 0.2f);
+
+    // Y axis - Green
+    DrawLine(0, 0, 0, 0, length, 0, 0.2f, 1.0f, 0.2f);
+    // Small arrow head for Y
+    DrawLine(0, length, 0, 0.1f, length - 0.2f, 0, 0.2f, 1.0f, 0.2f);
+    DrawLine(0, length, 0, -0.1f, length - 0.2f, 0, 0.2f, 1.0f, 0.2f);
+
+    // Z axis - Blue
+    DrawLine(0, 0, 0, 0, 0, length, 0.2f, 0.2f, 1.0f);
+    // Small arrow head for Z
+    DrawLine(0, 0, length, 0, 0.1f, length - 0.2f, 0.2f, 0.2f, 1.0f);
+    DrawLine(0, 0, length, 0, -0.1f, length - 0.2f, 0.2f, 0.2f, 1.0f);
+
+    // Negative axes (dimmer)
+    DrawLine(0, 0, 0, -length * 0.5f, 0, 0, 0.5f, 0.1f, 0.1f);  // -X
+    DrawLine(0, 0, 0, 0, -length * 0.5f, 0, 0.1f, 0.5f, 0.1f);  // -Y
+    DrawLine(0, 0, 0, 0, 0, -length * 0.5f, 0.1f, 0.1f, 0.5f);  // -Z
+}
+
+void DebugDrawList::DrawCube(float x, float y, float z, float size, float r, float g, float b) {
+    float hs = size / 2.0f;  // half size
+
+    // Front face
+    m_triVertices.emplace_back(x - hs, y - hs, z + hs, r, g, b);
+    m_triVertices.emplace_back(x + hs, y - hs, z + hs, r, g, b);
+    m_triVertices.emplace_back(x + hs, y + hs, z + hs, r, g, b);
+    m_triVertices.emplace_back(x - hs, y - hs, z + hs, r, g, b);
+    m_triVertices.emplace_back(x + hs, y + hs, z + hs, r, g, b);
+    m_triVertices.emplace_back(x - hs, y + hs, z + hs, r, g, b);
+
+    // Back face
+    m_triVertices.emplace_back(x + hs, y - hs, z - hs, r * 0.8f, g * 0.8f, b * 0.8f);
+    m_triVertices.emplace_back(x - hs, y - hs, z - hs, r * 0.8f, g * 0.8f, b * 0.8f);
+    m_triVertices.emplace_back(x - hs, y + hs, z - hs, r * 0.8f, g * 0.8f, b * 0.8f);
+    m_triVertices.emplace_back(x + hs, y - hs, z - hs, r * 0.8f, g * 0.8f, b * 0.8f);
+    m_triVertices.emplace_back(x - hs, y + hs, z - hs, r * 0.8f, g * 0.8f, b * 0.8f);
+    m_triVertices.emplace_back(x + hs, y + hs, z - hs, r * 0.8f, g * 0.8f, b * 0.8f);
+
+    // Top face
+    m_triVertices.emplace_back(x - hs, y + hs, z + hs, r * 1.0f, g * 1.0f, b * 1.0f);
+    m_triVertices.emplace_back(x + hs, y + hs, z + hs, r * 1.0f, g * 1.0f, b * 1.0f);
+    m_triVertices.emplace_back(x + hs, y + hs, z - hs, r * 1.0f, g * 1.0f, b * 1.0f);
+    m_triVertices.emplace_back(x - hs, y + hs, z + hs, r * 1.0f, g * 1.0f, b * 1.0f);
+    m_triVertices.emplace_back(x + hs, y + hs, z - hs, r * 1.0f, g * 1.0f, b * 1.0f);
+    m_triVertices.emplace_back(x - hs, y + hs, z - hs, r * 1.0f, g * 1.0f, b * 1.0f);
+
+    // Bottom face
+    m_triVertices.emplace_back(x - hs, y - hs, z - hs, r * 0.6f, g * 0.6f, b * 0.6f);
+    m_triVertices.emplace_back(x + hs, y - hs, z - hs, r * 0.6f, g * 0.6f, b * 0.6f);
+    m_triVertices.emplace_back(x + hs, y - hs, z + hs, r * 0.6f, g * 0.6f, b * 0.6f);
+    m_triVertices.emplace_back(x - hs, y - hs, z - hs, r * 0.6f, g * 0.6f, b * 0.6f);
+    m_triVertices.emplace_back(x + hs, y - hs, z + hs, r * 0.6f, g * 0.6f, b * 0.6f);
+    m_triVertices.emplace_back(x - hs, y - hs, z + hs, r * 0.6f, g * 0.6f, b * 0.6f);
+
+    // Right face
+    m_triVertices.emplace_back(x + hs, y - hs, z + hs, r * 0.9f, g * 0.9f, b * 0.9f);
+    m_triVertices.emplace_back(x + hs, y - hs, z - hs, r * 0.9f, g * 0.9f, b * 0.9f);
+    m_triVertices.emplace_back(x + hs, y + hs, z - hs, r * 0.9f, g * 0.9f, b * 0.9f);
+    m_triVertices.emplace_back(x + hs, y - hs, z + hs, r * 0.9f, g * 0.9f, b * 0.9f);
+    m_triVertices.emplace_back(x + hs, y + hs, z - hs, r * 0.9f, g * 0.9f, b * 0.9f);
+    m_triVertices.emplace_back(x + hs, y + hs, z + hs, r * 0.9f, g * 0.9f, b * 0.9f);
+
+    // Left face
+    m_triVertices.emplace_back(x - hs, y - hs, z - hs, r * 0.7f, g * 0.7f, b * 0.7f);
+    m_triVertices.emplace_back(x - hs, y - hs, z + hs, r * 0.7f, g * 0.7f, b * 0.7f);
+    m_triVertices.emplace_back(x - hs, y + hs, z + hs, r * 0.7f, g * 0.7f, b * 0.7f);
+    m_triVertices.emplace_back(x - hs, y - hs, z - hs, r * 0.7f, g * 0.7f, b * 0.7f);
+    m_triVertices.emplace_back(x - hs, y + hs, z + hs, r * 0.7f, g * 0.7f, b * 0.7f);
+    m_triVertices.emplace_back(x - hs, y + hs, z - hs, r * 0.7f, g * 0.7f, b * 0.7f);
+}
+
+void DebugDrawList::DrawWireCube(float x, float y, float z, float size, float r, float g, float b) {
+    DrawWireBox(x, y, z, size, size, size, r, g, b);
+}
+
+void DebugDrawList::DrawWireBox(float x, float y, float z, float width, float height, float depth, float r, float g, float b) {
+    DrawWireShape(DebugWireShape::Box, x, y, z, width, height, depth, r, g, b);
+}
+
+void DebugDrawList::DrawWireSphere(float x, float y, float z, float radius, float r, float g, float b, int segments) {
+    float d = radius * 2.0f;
+    if (segments == WIRE_SEGMENTS) {
+        DrawWireShape(DebugWireShape::Sphere, x, y, z, d, d, d, r, g, b);
+    } else {
+        AppendWireShape(m_lineVertices, DebugWireShape::Sphere, x, y, z, d, d, d, r, g, b, segments);
+    }
+}
+
+void DebugDrawList::DrawWireCone(float x, float y, float z, float radius, float height, float r, float g, float b, int segments) {
+    float d = radius * 2.0f;
+    if (segments == WIRE_SEGMENTS) {
+        DrawWireShape(DebugWireShape::Cone, x, y, z, d, height, d, r, g, b);
+    } else {
+        AppendWireShape(m_lineVertices, DebugWireShape::Cone, x, y, z, d, height, d, r, g, b, segments);
+    }
+}
+
+void DebugDrawList::DrawWireCylinder(float x, float y, float z, float radius, float height, float r, float g, float b, int segments) {
+    float d = radius * 2.0f;
+    if (segments == WIRE_SEGMENTS) {
+        DrawWireShape(DebugWireShape::Cylinder, x, y, z, d, height, d, r, g, b);
+    } else {
+        AppendWireShape(m_lineVertices, DebugWireShape::Cylinder, x, y, z, d, height, d, r, g, b, segments);
+    }
+}
+
+void DebugDrawList::DrawWireShape(DebugWireShape shape, float x, float y, float z, float sx, float sy, float sz,
+                                  float r, float g, float b) {
+    if (shape == DebugWireShape::Count) return;
+    m_shapeInstances[static_cast<size_t>(shape)].push_back({x, y, z, sx, sy, sz, r, g, b});
+}
+
+void DebugDrawList::AppendWireShape(std::vector<Vertex>& out, DebugWireShape shape, float x, float y, float z,
+                                    float sx, float sy, float sz, float r, float g, float b, int segments) {
+    const float PI = 3.14159265358979323846f;
+
+    // Unit-space endpoints, placed by the center and scale
+    auto line = [&](float x1, float y1, float z1, float x2, float y2, float z2) {
+        out.emplace_back(x + x1 * sx, y + y1 * sy, z + z1 * sz, r, g, b);
+        out.emplace_back(x + x2 * sx, y + y2 * sy, z + z2 * sz, r, g, b);
+    };
+
+    if (shape == DebugWireShape::Box) {
+        const float h = 0.5f;
+
+        // Bottom face edges
+        line(-h, -h, -h,  h, -h, -h);
+        line( h, -h, -h,  h, -h,  h);
+        line( h, -h,  h, -h, -h,  h);
+        line(-h, -h,  h, -h, -h, -h);
+
+        // Top face edges
+        line(-h,  h, -h,  h,  h, -h);
+        line( h,  h, -h,  h,  h,  h);
+        line( h,  h,  h, -h,  h,  h);
+        line(-h,  h,  h, -h,  h, -h);
+
+        // Vertical edges
+        line(-h, -h, -h, -h,  h, -h);
+        line( h, -h, -h,  h,  h, -h);
+        line( h, -h,  h,  h,  h,  h);
+        line(-h, -h,  h, -h,  h,  h);
+        return;
+    }
+
+    const float radius = 0.5f;
+    const float halfHeight = 0.5f;
+    for (int i = 0; i < segments; ++i) {
+        float theta1 = 2.0f * PI * i / segments;
+        float theta2 = 2.0f * PI * (i + 1) / segments;
+
+        float c1 = std::cos(theta1) * radius;
+        float s1 = std::sin(theta1) * radius;
+        float c2 = std::cos(theta2) * radius;
+        float s2 = std::sin(theta2) * radius;
+
+        switch (shape) {
+            case DebugWireShape::Sphere:
+                // XZ plane (horizontal circle), XY plane (facing Z), YZ plane (facing X)
+                line(c1, 0.0f, s1, c2, 0.0f, s2);
+                line(c1, s1, 0.0f, c2, s2, 0.0f);
+                line(0.0f, c1, s1, 0.0f, c2, s2);
+                break;
+
+            case DebugWireShape::Cylinder:
+                // Top and bottom circles, plus vertical lines every few segments
+                line(c1, halfHeight, s1, c2, halfHeight, s2);
+                line(c1, -halfHeight, s1, c2, -halfHeight, s2);
+                if (i % 4 == 0) {
+                    line(c1, -halfHeight, s1, c1, halfHeight, s1);
+                }
+                break;
+
+            case DebugWireShape::Cone:
+                // Base circle, plus lines from the apex every few segments
+                line(c1, -halfHeight, s1, c2, -halfHeight, s2);
+                if (i % 4 == 0) {
+                    line(0.0f, halfHeight, 0.0f, c1, -halfHeight, s1);
+                }
+                break;
+
+            default:
+                return;
+        }
+    }
+}
+
+void DebugDrawList::DrawFloor(float size, float y, float r, float g, float b) {
+    float hs = size / 2.0f;
+
+    // Two triangles for the floor quad
+    m_triVertices.emplace_back(-hs, y, -hs, r, g, b);
+    m_triVertices.emplace_back( hs, y, -hs, r, g, b);
+    m_triVertices.emplace_back( hs, y,  hs, r, g, b);
+
+    m_triVertices.emplace_back(-hs, y, -hs, r, g, b);
+    m_triVertices.emplace_back( hs, y,  hs, r, g, b);
+    m_triVertices.emplace_back(-hs, y,  hs, r, g, b);
+}
+
+} // namespace Genesis
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Genesis {
+
+// ============================================================================
+// Simple Vertex structure
+// ============================================================================
+struct Vertex {
+    float x, y, z;      // Position
+    float r, g, b;      // Color
+
+    Vertex(float px, float py, float pz, float cr = 1.0f, float cg = 1.0f, float cb = 1.0f)
+        : x(px), y(py), z(pz), r(cr), g(cg), b(cb) {}
+};
+
+// ============================================================================
+// Wire shapes drawn instanced from a cached unit mesh (DebugRenderer)
+// ============================================================================
+enum class DebugWireShape : uint8_t {
+    Box,        // Unit cube [-0.5, 0.5]
+    Sphere,     // Three circles of radius 0.5
+    Cylinder,   // Radius 0.5, height 1, along Y
+    Cone,       // Base radius 0.5 at y = -0.5, apex at +0.5
+    Count
+};
+
+struct DebugShapeInstance {
+    float x, y, z;      // Center
+    float sx, sy, sz;   // Scale of the unit shape
+    float r, g, b;
+};
+
+// ============================================================================
+// DebugDrawList - CPU-side list of debug lines, triangles and wire shapes
+//
+// No GL: can be filled on any thread (e.g. into a simulation snapshot) and
+// handed to DebugRenderer::Append() on the render thread.
+//
+// DrawWire* calls at WIRE_SEGMENTS (the default) only record an instance
+// of the shape; DebugRenderer draws all instances of a shape in one
+// instanced call. Other segment counts are expanded into lines.
+// ============================================================================
+class DebugDrawList {
+public:
+    void Clear();
+    void Append(const DebugDrawList& other);
+
+    bool IsEmpty() const;
+
+    // Segments of the cached round wire meshes
+    static constexpr int WIRE_SEGMENTS = 16;
+
+    // Add primitives
+    void DrawLine(float x1, float y1, float z1, float x2, float y2, float z2,
+                  float r, float g, float b);
+    void DrawGrid(float size, float spacing, float r = 0.3f, float g = 0.3f, float b = 0.3f);
+    void DrawAxes(float length);
+    void DrawCube(float x, float y, float z, float size, float r, float g, float b);
+    void DrawWireCube(float x, float y, float z, float size, float r, float g, float b);
+    void DrawWireBox(float x, float y, float z, float width, float height, float depth, float r, float g, float b);
+    void DrawWireSphere(float x, float y, float z, float radius, float r, float g, float b, int segments = WIRE_SEGMENTS);
+    void DrawWireCone(float x, float y, float z, float radius, float height, float r, float g, float b, int segments = WIRE_SEGMENTS);
+    void DrawWireCylinder(float x, float y, float z, float radius, float height, float r, float g, float b, int segments = WIRE_SEGMENTS);
+
+    // Any wire shape, center and per-axis scale of its unit mesh
+    void DrawWireShape(DebugWireShape shape, float x, float y, float z, float sx, float sy, float sz,
+                       float r, float g, float b);
+    void DrawFloor(float size, float y, float r, float g, float b);
+
+    const std::vector<Vertex>& GetLineVertices() const { return m_lineVertices; }
+    const std::vector<Vertex>& GetTriangleVertices() const { return m_triVertices; }
+    const std::vector<DebugShapeInstance>& GetShapeInstances(DebugWireShape shape) const {
+        return m_shapeInstances[static_cast<size_t>(shape)];
+    }
+
+    // Line list of a wire shape placed at (x, y, z) with scale (sx, sy, sz);
+    // the unit meshes are this at the origin and scale 1
+    static void AppendWireShape(std::vector<Vertex>& out, DebugWireShape shape, float x, float y, float z,
+                                float sx, float sy, float sz, float r, float g, float b, int segments);
+
+protected:
+    static constexpr size_t SHAPE_COUNT = static_cast<size_t>(DebugWireShape::Count);
+
+    std::vector<Vertex> m_lineVertices;
+    std::vector<Vertex> m_triVertices;   // Filled shapes
+    std::vector<DebugShapeInstance> m_shapeInstances[SHAPE_COUNT];
+};
+
+} // namespace Genesis
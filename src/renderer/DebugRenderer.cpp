@@ -1,6 +1,12 @@
 #include "DebugRenderer.h"
+#include "GLState.h"
+#include "GpuTimer.h"
+#include "core/Profiler.h"
+#include "renderer/shader/Shader.h"
+#include "renderer/shader/UniformHandle.h"
 #include <iostream>
 #include <cmath>
+#include <cstddef>
 
 namespace Genesis {
 
@@ -14,6 +20,7 @@ bool DebugRenderer::Initialize() {
     if (m_initialized) return true;
 
     CreateBuffers();
+    CreateShapeMeshes();
     m_initialized = true;
 
     std::cout << "[DebugRenderer] Initialized" << std::endl;
@@ -23,33 +30,36 @@ bool DebugRenderer::Initialize() {
 void DebugRenderer::Shutdown() {
     if (!m_initialized) return;
 
-    if (m_lineVAO) {
-        glDeleteVertexArrays(1, &m_lineVAO);
-        m_lineVAO = 0;
+    if (m_vao) {
+        glDeleteVertexArrays(1, &m_vao);
+        GLStateCache::Instance().OnVertexArrayDeleted(m_vao);
+        m_vao = 0;
     }
-    if (m_lineVBO) {
-        glDeleteBuffers(1, &m_lineVBO);
-        m_lineVBO = 0;
+    if (m_shapeVAO) {
+        glDeleteVertexArrays(1, &m_shapeVAO);
+        GLStateCache::Instance().OnVertexArrayDeleted(m_shapeVAO);
+        m_shapeVAO = 0;
     }
-    if (m_triVAO) {
-        glDeleteVertexArrays(1, &m_triVAO);
-        m_triVAO = 0;
-    }
-    if (m_triVBO) {
-        glDeleteBuffers(1, &m_triVBO);
-        m_triVBO = 0;
+    if (m_shapeVBO) {
+        glDeleteBuffers(1, &m_shapeVBO);
+        m_shapeVBO = 0;
     }
+    m_stream.Release();
+    m_streamVersion = 0;
 
     m_initialized = false;
 }
 
 void DebugRenderer::CreateBuffers() {
-    // Line VAO/VBO
-    glGenVertexArrays(1, &m_lineVAO);
-    glGenBuffers(1, &m_lineVBO);
+    glGenVertexArrays(1, &m_vao);
+    m_stream.Create(GL_ARRAY_BUFFER, STREAM_FRAME_BYTES);
+    SetupVertexFormat();
+}
 
-    glBindVertexArray(m_lineVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, m_lineVBO);
+void DebugRenderer::SetupVertexFormat() {
+    auto& gl = GLStateCache::Instance();
+    gl.BindVertexArray(m_vao);
+    glBindBuffer(GL_ARRAY_BUFFER, m_stream.GetId());
 
     // Position attribute (location 0)
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
@@ -59,297 +69,105 @@ void DebugRenderer::CreateBuffers() {
     glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)(3 * sizeof(float)));
     glEnableVertexAttribArray(1);
 
-    // Triangle VAO/VBO
-    glGenVertexArrays(1, &m_triVAO);
-    glGenBuffers(1, &m_triVBO);
+    gl.BindVertexArray(0);
+    m_streamVersion = m_stream.GetVersion();
+}
 
-    glBindVertexArray(m_triVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, m_triVBO);
+void DebugRenderer::CreateShapeMeshes() {
+    std::vector<Vertex> vertices;
+    for (size_t s = 0; s < SHAPE_COUNT; s++) {
+        m_shapeFirst[s] = static_cast<GLint>(vertices.size());
+        AppendWireShape(vertices, static_cast<DebugWireShape>(s), 0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f,
+                        1.0f, 1.0f, 1.0f, WIRE_SEGMENTS);
+        m_shapeCount[s] = static_cast<GLsizei>(vertices.size()) - m_shapeFirst[s];
+    }
 
-    // Position attribute (location 0)
+    auto& gl = GLStateCache::Instance();
+    glGenVertexArrays(1, &m_shapeVAO);
+    glGenBuffers(1, &m_shapeVBO);
+    gl.BindVertexArray(m_shapeVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, m_shapeVBO);
+    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), vertices.data(), GL_STATIC_DRAW);
+
+    // Unit position (location 0); color, center and scale come per instance
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
     glEnableVertexAttribArray(0);
+    for (GLuint location = 1; location <= 3; location++) {
+        glEnableVertexAttribArray(location);
+        glVertexAttribDivisor(location, 1);
+    }
 
-    // Color attribute (location 1)
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-
-    glBindVertexArray(0);
+    gl.BindVertexArray(0);
 }
 
 void DebugRenderer::BeginFrame() {
-    m_lineVertices.clear();
-    m_triVertices.clear();
+    Clear();
+    m_stream.BeginFrame();
 }
 
-void DebugRenderer::DrawLine(float x1, float y1, float z1, float x2, float y2, float z2,
-                              float r, float g, float b) {
-    m_lineVertices.emplace_back(x1, y1, z1, r, g, b);
-    m_lineVertices.emplace_back(x2, y2, z2, r, g, b);
-}
-
-void DebugRenderer::DrawGrid(float size, float spacing, float r, float g, float b) {
-    float halfSize = size / 2.0f;
-    int lines = static_cast<int>(size / spacing);
-
-    for (int i = -lines / 2; i <= lines / 2; i++) {
-        float pos = i * spacing;
+void DebugRenderer::DrawVertices(unsigned int mode, const std::vector<Vertex>& vertices) {
+    if (vertices.empty() || !m_initialized) return;
+    GENESIS_PROFILE_SCOPE("Debug Draw");
+    GENESIS_GPU_SCOPE("Debug Draw");
 
-        // Skip center lines (they'll be drawn as axes)
-        if (i == 0) continue;
+    size_t offset = m_stream.Write(vertices.data(), vertices.size() * sizeof(Vertex), sizeof(Vertex));
+    if (offset == StreamBuffer::INVALID_OFFSET) return;
 
-        // Lines parallel to X axis
-        DrawLine(-halfSize, 0, pos, halfSize, 0, pos, r, g, b);
-
-        // Lines parallel to Z axis
-        DrawLine(pos, 0, -halfSize, pos, 0, halfSize, r, g, b);
+    // The stream reallocated itself (a frame outgrew its region)
+    if (m_streamVersion != m_stream.GetVersion()) {
+        SetupVertexFormat();
     }
-}
-
-void DebugRenderer::DrawAxes(float length) {
-    // X axis - Red
-    DrawLine(0, 0, 0, length, 0, 0, 1.0f, 0.2f, 0.2f);
-    // Small arrow head for X
-    DrawLine(length, 0, 0, length - 0.2f, 0.1f, 0, 1.0f, 0.2f, 0.2f);
-    DrawLine(length, 0, 0, length - 0.2f, -0.1f, 0, 1.0f, 0.2f, 0.2f);
-
-    // Y axis - Green
-    DrawLine(0, 0, 0, 0, length, 0, 0.2f, 1.0f, 0.2f);
-    // Small arrow head for Y
-    DrawLine(0, length, 0, 0.1f, length - 0.2f, 0, 0.2f, 1.0f, 0.2f);
-    DrawLine(0, length, 0, -0.1f, length - 0.2f, 0, 0.2f, 1.0f, 0.2f);
-
-    // Z axis - Blue
-    DrawLine(0, 0, 0, 0, 0, length, 0.2f, 0.2f, 1.0f);
-    // Small arrow head for Z
-    DrawLine(0, 0, length, 0, 0.1f, length - 0.2f, 0.2f, 0.2f, 1.0f);
-    DrawLine(0, 0, length, 0, -0.1f, length - 0.2f, 0.2f, 0.2f, 1.0f);
-
-    // Negative axes (dimmer)
-    DrawLine(0, 0, 0, -length * 0.5f, 0, 0, 0.5f, 0.1f, 0.1f);  // -X
-    DrawLine(0, 0, 0, 0, -length * 0.5f, 0, 0.1f, 0.5f, 0.1f);  // -Y
-    DrawLine(0, 0, 0, 0, 0, -length * 0.5f, 0.1f, 0.1f, 0.5f);  // -Z
-}
 
-void DebugRenderer::DrawCube(float x, float y, float z, float size, float r, float g, float b) {
-    float hs = size / 2.0f;  // half size
-
-    // Front face
-    m_triVertices.emplace_back(x - hs, y - hs, z + hs, r, g, b);
-    m_triVertices.emplace_back(x + hs, y - hs, z + hs, r, g, b);
-    m_triVertices.emplace_back(x + hs, y + hs, z + hs, r, g, b);
-    m_triVertices.emplace_back(x - hs, y - hs, z + hs, r, g, b);
-    m_triVertices.emplace_back(x + hs, y + hs, z + hs, r, g, b);
-    m_triVertices.emplace_back(x - hs, y + hs, z + hs, r, g, b);
-
-    // Back face
-    m_triVertices.emplace_back(x + hs, y - hs, z - hs, r * 0.8f, g * 0.8f, b * 0.8f);
-    m_triVertices.emplace_back(x - hs, y - hs, z - hs, r * 0.8f, g * 0.8f, b * 0.8f);
-    m_triVertices.emplace_back(x - hs, y + hs, z - hs, r * 0.8f, g * 0.8f, b * 0.8f);
-    m_triVertices.emplace_back(x + hs, y - hs, z - hs, r * 0.8f, g * 0.8f, b * 0.8f);
-    m_triVertices.emplace_back(x - hs, y + hs, z - hs, r * 0.8f, g * 0.8f, b * 0.8f);
-    m_triVertices.emplace_back(x + hs, y + hs, z - hs, r * 0.8f, g * 0.8f, b * 0.8f);
-
-    // Top face
-    m_triVertices.emplace_back(x - hs, y + hs, z + hs, r * 1.0f, g * 1.0f, b * 1.0f);
-    m_triVertices.emplace_back(x + hs, y + hs, z + hs, r * 1.0f, g * 1.0f, b * 1.0f);
-    m_triVertices.emplace_back(x + hs, y + hs, z - hs, r * 1.0f, g * 1.0f, b * 1.0f);
-    m_triVertices.emplace_back(x - hs, y + hs, z + hs, r * 1.0f, g * 1.0f, b * 1.0f);
-    m_triVertices.emplace_back(x + hs, y + hs, z - hs, r * 1.0f, g * 1.0f, b * 1.0f);
-    m_triVertices.emplace_back(x - hs, y + hs, z - hs, r * 1.0f, g * 1.0f, b * 1.0f);
-
-    // Bottom face
-    m_triVertices.emplace_back(x - hs, y - hs, z - hs, r * 0.6f, g * 0.6f, b * 0.6f);
-    m_triVertices.emplace_back(x + hs, y - hs, z - hs, r * 0.6f, g * 0.6f, b * 0.6f);
-    m_triVertices.emplace_back(x + hs, y - hs, z + hs, r * 0.6f, g * 0.6f, b * 0.6f);
-    m_triVertices.emplace_back(x - hs, y - hs, z - hs, r * 0.6f, g * 0.6f, b * 0.6f);
-    m_triVertices.emplace_back(x + hs, y - hs, z + hs, r * 0.6f, g * 0.6f, b * 0.6f);
-    m_triVertices.emplace_back(x - hs, y - hs, z + hs, r * 0.6f, g * 0.6f, b * 0.6f);
-
-    // Right face
-    m_triVertices.emplace_back(x + hs, y - hs, z + hs, r * 0.9f, g * 0.9f, b * 0.9f);
-    m_triVertices.emplace_back(x + hs, y - hs, z - hs, r * 0.9f, g * 0.9f, b * 0.9f);
-    m_triVertices.emplace_back(x + hs, y + hs, z - hs, r * 0.9f, g * 0.9f, b * 0.9f);
-    m_triVertices.emplace_back(x + hs, y - hs, z + hs, r * 0.9f, g * 0.9f, b * 0.9f);
-    m_triVertices.emplace_back(x + hs, y + hs, z - hs, r * 0.9f, g * 0.9f, b * 0.9f);
-    m_triVertices.emplace_back(x + hs, y + hs, z + hs, r * 0.9f, g * 0.9f, b * 0.9f);
-
-    // Left face
-    m_triVertices.emplace_back(x - hs, y - hs, z - hs, r * 0.7f, g * 0.7f, b * 0.7f);
-    m_triVertices.emplace_back(x - hs, y - hs, z + hs, r * 0.7f, g * 0.7f, b * 0.7f);
-    m_triVertices.emplace_back(x - hs, y + hs, z + hs, r * 0.7f, g * 0.7f, b * 0.7f);
-    m_triVertices.emplace_back(x - hs, y - hs, z - hs, r * 0.7f, g * 0.7f, b * 0.7f);
-    m_triVertices.emplace_back(x - hs, y + hs, z + hs, r * 0.7f, g * 0.7f, b * 0.7f);
-    m_triVertices.emplace_back(x - hs, y + hs, z - hs, r * 0.7f, g * 0.7f, b * 0.7f);
+    GLStateCache::Instance().BindVertexArray(m_vao);
+    glDrawArrays(mode, static_cast<GLint>(offset / sizeof(Vertex)), static_cast<GLsizei>(vertices.size()));
 }
 
-void DebugRenderer::DrawWireCube(float x, float y, float z, float size, float r, float g, float b) {
-    DrawWireBox(x, y, z, size, size, size, r, g, b);
-}
-
-void DebugRenderer::DrawWireBox(float x, float y, float z, float width, float height, float depth, float r, float g, float b) {
-    float hw = width / 2.0f;
-    float hh = height / 2.0f;
-    float hd = depth / 2.0f;
-
-    // Bottom face edges
-    DrawLine(x - hw, y - hh, z - hd, x + hw, y - hh, z - hd, r, g, b);
-    DrawLine(x + hw, y - hh, z - hd, x + hw, y - hh, z + hd, r, g, b);
-    DrawLine(x + hw, y - hh, z + hd, x - hw, y - hh, z + hd, r, g, b);
-    DrawLine(x - hw, y - hh, z + hd, x - hw, y - hh, z - hd, r, g, b);
-
-    // Top face edges
-    DrawLine(x - hw, y + hh, z - hd, x + hw, y + hh, z - hd, r, g, b);
-    DrawLine(x + hw, y + hh, z - hd, x + hw, y + hh, z + hd, r, g, b);
-    DrawLine(x + hw, y + hh, z + hd, x - hw, y + hh, z + hd, r, g, b);
-    DrawLine(x - hw, y + hh, z + hd, x - hw, y + hh, z - hd, r, g, b);
-
-    // Vertical edges
-    DrawLine(x - hw, y - hh, z - hd, x - hw, y + hh, z - hd, r, g, b);
-    DrawLine(x + hw, y - hh, z - hd, x + hw, y + hh, z - hd, r, g, b);
-    DrawLine(x + hw, y - hh, z + hd, x + hw, y + hh, z + hd, r, g, b);
-    DrawLine(x - hw, y - hh, z + hd, x - hw, y + hh, z + hd, r, g, b);
+void DebugRenderer::RenderLines() {
+    DrawVertices(GL_LINES, m_lineVertices);
 }
 
-void DebugRenderer::DrawWireSphere(float x, float y, float z, float radius, float r, float g, float b, int segments) {
-    const float PI = 3.14159265358979323846f;
-
-    // Draw 3 circles (XY, XZ, YZ planes)
-    for (int i = 0; i < segments; ++i) {
-        float theta1 = 2.0f * PI * i / segments;
-        float theta2 = 2.0f * PI * (i + 1) / segments;
-
-        float c1 = std::cos(theta1);
-        float s1 = std::sin(theta1);
-        float c2 = std::cos(theta2);
-        float s2 = std::sin(theta2);
-
-        // XZ plane (horizontal circle)
-        DrawLine(x + c1 * radius, y, z + s1 * radius,
-                 x + c2 * radius, y, z + s2 * radius, r, g, b);
-
-        // XY plane (vertical circle facing Z)
-        DrawLine(x + c1 * radius, y + s1 * radius, z,
-                 x + c2 * radius, y + s2 * radius, z, r, g, b);
-
-        // YZ plane (vertical circle facing X)
-        DrawLine(x, y + c1 * radius, z + s1 * radius,
-                 x, y + c2 * radius, z + s2 * radius, r, g, b);
-    }
+void DebugRenderer::RenderTriangles() {
+    DrawVertices(GL_TRIANGLES, m_triVertices);
 }
 
-void DebugRenderer::DrawWireCone(float x, float y, float z, float radius, float height, float r, float g, float b, int segments) {
-    const float PI = 3.14159265358979323846f;
-    float halfHeight = height * 0.5f;
-
-    // Draw base circle
-    for (int i = 0; i < segments; ++i) {
-        float theta1 = 2.0f * PI * i / segments;
-        float theta2 = 2.0f * PI * (i + 1) / segments;
-
-        float x1 = x + std::cos(theta1) * radius;
-        float z1 = z + std::sin(theta1) * radius;
-        float x2 = x + std::cos(theta2) * radius;
-        float z2 = z + std::sin(theta2) * radius;
-
-        // Base circle
-        DrawLine(x1, y - halfHeight, z1, x2, y - halfHeight, z2, r, g, b);
+void DebugRenderer::RenderShapes(Shader& shader) {
+    if (!m_initialized) return;
 
-        // Lines from apex to base (every few segments)
-        if (i % 4 == 0) {
-            DrawLine(x, y + halfHeight, z, x1, y - halfHeight, z1, r, g, b);
-        }
+    bool any = false;
+    for (size_t s = 0; s < SHAPE_COUNT && !any; s++) {
+        any = !m_shapeInstances[s].empty();
     }
-}
-
-void DebugRenderer::DrawWireCylinder(float x, float y, float z, float radius, float height, float r, float g, float b, int segments) {
-    const float PI = 3.14159265358979323846f;
-    float halfHeight = height * 0.5f;
+    if (!any) return;
 
-    // Draw top and bottom circles, plus vertical lines
-    for (int i = 0; i < segments; ++i) {
-        float theta1 = 2.0f * PI * i / segments;
-        float theta2 = 2.0f * PI * (i + 1) / segments;
+    GENESIS_PROFILE_SCOPE("Debug Shapes");
+    GENESIS_GPU_SCOPE("Debug Shapes");
 
-        float c1 = std::cos(theta1);
-        float s1 = std::sin(theta1);
-        float c2 = std::cos(theta2);
-        float s2 = std::sin(theta2);
+    shader.SetInt(Uniforms::Instanced, 1);
+    GLStateCache::Instance().BindVertexArray(m_shapeVAO);
 
-        float x1 = x + c1 * radius;
-        float z1 = z + s1 * radius;
-        float x2 = x + c2 * radius;
-        float z2 = z + s2 * radius;
+    for (size_t s = 0; s < SHAPE_COUNT; s++) {
+        const auto& instances = m_shapeInstances[s];
+        if (instances.empty() || m_shapeCount[s] == 0) continue;
 
-        // Top circle
-        DrawLine(x1, y + halfHeight, z1, x2, y + halfHeight, z2, r, g, b);
+        size_t offset = m_stream.Write(instances.data(), instances.size() * sizeof(DebugShapeInstance),
+                                       sizeof(float));
+        if (offset == StreamBuffer::INVALID_OFFSET) continue;
 
-        // Bottom circle
-        DrawLine(x1, y - halfHeight, z1, x2, y - halfHeight, z2, r, g, b);
+        // Instance attributes at this draw's slice of the stream
+        const GLsizei stride = sizeof(DebugShapeInstance);
+        glBindBuffer(GL_ARRAY_BUFFER, m_stream.GetId());
+        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, stride, (void*)(offset + offsetof(DebugShapeInstance, r)));
+        glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, stride, (void*)(offset + offsetof(DebugShapeInstance, x)));
+        glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, stride, (void*)(offset + offsetof(DebugShapeInstance, sx)));
 
-        // Vertical lines (every few segments)
-        if (i % 4 == 0) {
-            DrawLine(x1, y - halfHeight, z1, x1, y + halfHeight, z1, r, g, b);
-        }
+        glDrawArraysInstanced(GL_LINES, m_shapeFirst[s], m_shapeCount[s], static_cast<GLsizei>(instances.size()));
     }
-}
-
-void DebugRenderer::DrawFloor(float size, float y, float r, float g, float b) {
-    float hs = size / 2.0f;
 
-    // Two triangles for the floor quad
-    m_triVertices.emplace_back(-hs, y, -hs, r, g, b);
-    m_triVertices.emplace_back( hs, y, -hs, r, g, b);
-    m_triVertices.emplace_back( hs, y,  hs, r, g, b);
-
-    m_triVertices.emplace_back(-hs, y, -hs, r, g, b);
-    m_triVertices.emplace_back( hs, y,  hs, r, g, b);
-    m_triVertices.emplace_back(-hs, y,  hs, r, g, b);
-}
-
-void DebugRenderer::UpdateLineBuffer() {
-    if (m_lineVertices.empty()) return;
-
-    glBindBuffer(GL_ARRAY_BUFFER, m_lineVBO);
-    glBufferData(GL_ARRAY_BUFFER,
-                 m_lineVertices.size() * sizeof(Vertex),
-                 m_lineVertices.data(),
-                 GL_DYNAMIC_DRAW);
-}
-
-void DebugRenderer::UpdateTriangleBuffer() {
-    if (m_triVertices.empty()) return;
-
-    glBindBuffer(GL_ARRAY_BUFFER, m_triVBO);
-    glBufferData(GL_ARRAY_BUFFER,
-                 m_triVertices.size() * sizeof(Vertex),
-                 m_triVertices.data(),
-                 GL_DYNAMIC_DRAW);
-}
-
-void DebugRenderer::RenderLines() {
-    if (m_lineVertices.empty()) return;
-
-    UpdateLineBuffer();
-
-    glBindVertexArray(m_lineVAO);
-    glDrawArrays(GL_LINES, 0, static_cast<GLsizei>(m_lineVertices.size()));
-    glBindVertexArray(0);
-}
-
-void DebugRenderer::RenderTriangles() {
-    if (m_triVertices.empty()) return;
-
-    UpdateTriangleBuffer();
-
-    glBindVertexArray(m_triVAO);
-    glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(m_triVertices.size()));
-    glBindVertexArray(0);
+    shader.SetInt(Uniforms::Instanced, 0);
 }
 
 void DebugRenderer::EndFrame() {
-    // Nothing special needed here for now
+    m_stream.EndFrame();
 }
 
 } // namespace Genesis
-
@@ -1,25 +1,25 @@
 #pragma once
 
+#include "DebugDrawList.h"
+#include "StreamBuffer.h"
 #include <vector>
 #include <glad/glad.h>
 
 namespace Genesis {
 
-// ============================================================================
-// Simple Vertex structure
-// ============================================================================
-struct Vertex {
-    float x, y, z;      // Position
-    float r, g, b;      // Color
-
-    Vertex(float px, float py, float pz, float cr = 1.0f, float cg = 1.0f, float cb = 1.0f)
-        : x(px), y(py), z(pz), r(cr), g(cg), b(cb) {}
-};
+class Shader;
 
 // ============================================================================
 // DebugRenderer - Renders debug primitives (grid, axes, cubes, etc.)
+//
+// Draw* calls (from DebugDrawList) collect into this frame's lists;
+// Append() adds a list recorded elsewhere, e.g. a simulation snapshot.
+//
+// Wire shapes are drawn from unit line meshes built once at Initialize():
+// each shape's instances (center, scale, color) are streamed and drawn
+// with one glDrawArraysInstanced, however many there are.
 // ============================================================================
-class DebugRenderer {
+class DebugRenderer : public DebugDrawList {
 public:
     DebugRenderer();
     ~DebugRenderer();
@@ -33,47 +33,44 @@ public:
     void Shutdown();
 
     // ========================================================================
-    // Immediate mode drawing (rebuilds buffers each frame)
+    // Immediate mode drawing (streams vertices each frame)
     // ========================================================================
 
     // Begin a new frame of debug drawing
     void BeginFrame();
 
-    // Add primitives
-    void DrawLine(float x1, float y1, float z1, float x2, float y2, float z2,
-                  float r, float g, float b);
-    void DrawGrid(float size, float spacing, float r = 0.3f, float g = 0.3f, float b = 0.3f);
-    void DrawAxes(float length);
-    void DrawCube(float x, float y, float z, float size, float r, float g, float b);
-    void DrawWireCube(float x, float y, float z, float size, float r, float g, float b);
-    void DrawWireBox(float x, float y, float z, float width, float height, float depth, float r, float g, float b);
-    void DrawWireSphere(float x, float y, float z, float radius, float r, float g, float b, int segments = 16);
-    void DrawWireCone(float x, float y, float z, float radius, float height, float r, float g, float b, int segments = 16);
-    void DrawWireCylinder(float x, float y, float z, float radius, float height, float r, float g, float b, int segments = 16);
-    void DrawFloor(float size, float y, float r, float g, float b);
-
     // Render all accumulated primitives
     void RenderLines();
     void RenderTriangles();
 
+    // Instanced wire shapes; the bound shader is debug.vert's, whose
+    // u_Instanced is set for the draws and cleared again
+    void RenderShapes(Shader& shader);
+
     // End frame
     void EndFrame();
 
 private:
     void CreateBuffers();
-    void UpdateLineBuffer();
-    void UpdateTriangleBuffer();
+    void SetupVertexFormat();
+    void DrawVertices(unsigned int mode, const std::vector<Vertex>& vertices);
+    void CreateShapeMeshes();
 
 private:
-    // OpenGL objects for lines
-    unsigned int m_lineVAO = 0;
-    unsigned int m_lineVBO = 0;
-    std::vector<Vertex> m_lineVertices;
-
-    // OpenGL objects for triangles (filled shapes)
-    unsigned int m_triVAO = 0;
-    unsigned int m_triVBO = 0;
-    std::vector<Vertex> m_triVertices;
+    // Lines and triangles share one vertex format, VAO and stream
+    static constexpr size_t STREAM_FRAME_BYTES = 512 * 1024;
+
+    unsigned int m_vao = 0;
+    StreamBuffer m_stream;
+    uint32_t m_streamVersion = 0;   // Stream version m_vao points at
+
+    // Unit wire meshes, one vertex range per DebugWireShape in m_shapeVBO;
+    // m_shapeVAO reads them per vertex and the streamed instances with
+    // divisor 1 (re-pointed at each draw's stream offset)
+    unsigned int m_shapeVAO = 0;
+    unsigned int m_shapeVBO = 0;
+    GLint m_shapeFirst[SHAPE_COUNT] = {};
+    GLsizei m_shapeCount[SHAPE_COUNT] = {};
 
     bool m_initialized = false;
 };
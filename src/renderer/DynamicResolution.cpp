@@ -0,0 +1,279 @@
+#include "DynamicResolution.h"
+#include "core/Logger.h"
+#include "core/Profiler.h"
+#include "renderer/GLState.h"
+#include <glad/glad.h>
+#include <algorithm>
+#include <cmath>
+
+namespace Genesis {
+
+// Fullscreen triangle from gl_VertexID, uv 0..1 over the window
+static const char* g_upscaleVertexShader = R"(
+#version 330 core
+out vec2 v_UV;
+
+void main() {
+    vec2 position = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+    v_UV = position;
+    gl_Position = vec4(position * 2.0 - 1.0, 0.0, 1.0);
+}
+)";
+
+static const char* g_upscaleFragmentShader = R"(
+#version 330 core
+in vec2 v_UV;
+out vec4 FragColor;
+
+uniform sampler2D u_Source;
+uniform vec2 u_UvScale;      // Rendered part of the target, in uv
+uniform vec2 u_TexelSize;    // One target texel, in uv
+uniform float u_Sharpness;
+
+vec3 Fetch(vec2 uv) {
+    // Half a texel inside the rendered part, so bilinear never reads past it
+    uv = clamp(uv, u_TexelSize * 0.5, u_UvScale - u_TexelSize * 0.5);
+    return texture(u_Source, uv).rgb;
+}
+
+void main() {
+    vec2 uv = v_UV * u_UvScale;
+    vec3 center = Fetch(uv);
+    if (u_Sharpness <= 0.0) {
+        FragColor = vec4(center, 1.0);
+        return;
+    }
+
+    vec3 north = Fetch(uv + vec2(0.0, u_TexelSize.y));
+    vec3 south = Fetch(uv - vec2(0.0, u_TexelSize.y));
+    vec3 east = Fetch(uv + vec2(u_TexelSize.x, 0.0));
+    vec3 west = Fetch(uv - vec2(u_TexelSize.x, 0.0));
+
+    // Unsharp mask against the neighbours, limited to their range
+    vec3 low = min(center, min(min(north, south), min(east, west)));
+    vec3 high = max(center, max(max(north, south), max(east, west)));
+    vec3 blurred = (north + south + east + west) * 0.25;
+    vec3 sharpened = center + (center - blurred) * (u_Sharpness * 2.0);
+    FragColor = vec4(clamp(sharpened, low, high), 1.0);
+}
+)";
+
+static constexpr UniformHandle Source("u_Source");
+static constexpr UniformHandle UvScale("u_UvScale");
+static constexpr UniformHandle TexelSize("u_TexelSize");
+static constexpr UniformHandle Sharpness("u_Sharpness");
+
+// Controller: smoothing of the displayed time, the band under the target
+// that counts as on budget, and how far each sample moves the scale
+// toward the one that would hit it (down fast, up slowly)
+static constexpr double TIME_SMOOTHING = 0.25;
+static constexpr double HEADROOM = 0.1;
+static constexpr float DOWN_RATE = 0.5f;
+static constexpr float UP_RATE = 0.1f;
+
+// ============================================================================
+// Frame
+// ============================================================================
+
+bool DynamicResolution::BeginScene(int width, int height) {
+    if (!m_config.enabled || width <= 0 || height <= 0) {
+        if (m_framebuffer != 0) {
+            ReleaseTarget();
+        }
+        m_scale = 1.0f;
+        m_gpuMs = 0.0;
+        return false;
+    }
+
+    float maxScale = std::clamp(m_config.maxScale, MIN_SCALE, 1.0f);
+    float minScale = std::clamp(m_config.minScale, MIN_SCALE, maxScale);
+    int targetWidth = std::max(1, static_cast<int>(std::ceil(width * maxScale)));
+    int targetHeight = std::max(1, static_cast<int>(std::ceil(height * maxScale)));
+    if (!EnsureShader() || !EnsureTarget(targetWidth, targetHeight)) {
+        // Don't retry every frame
+        m_config.enabled = false;
+        return false;
+    }
+
+    // The timers issued FRAME_LATENCY frames ago move the scale
+    m_frame++;
+    Collect();
+    m_scale = std::clamp(m_scale, minScale, maxScale);
+
+    m_windowWidth = width;
+    m_windowHeight = height;
+    m_renderWidth = std::clamp(static_cast<int>(width * m_scale + 0.5f), 1, m_targetWidth);
+    m_renderHeight = std::clamp(static_cast<int>(height * m_scale + 0.5f), 1, m_targetHeight);
+
+    TimerPair& timers = m_timers[m_frame % FRAME_LATENCY];
+    if (timers.begin == 0) {
+        glGenQueries(1, &timers.begin);
+        glGenQueries(1, &timers.end);
+    }
+    glQueryCounter(timers.begin, GL_TIMESTAMP);
+    timers.scale = m_scale;
+
+    glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+    glViewport(0, 0, m_renderWidth, m_renderHeight);
+    m_active = true;
+    return true;
+}
+
+void DynamicResolution::EndScene() {
+    if (!m_active) return;
+    m_active = false;
+    GENESIS_PROFILE_SCOPE("Upscale");
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glViewport(0, 0, m_windowWidth, m_windowHeight);
+
+    // Every pixel is written: no clear, depth or blending
+    auto& gl = GLStateCache::Instance();
+    gl.SetDepthTest(false);
+    gl.SetBlend(false);
+    gl.SetCulling(false);
+
+    m_upscale.Bind();
+    gl.BindTexture(0, GL_TEXTURE_2D, m_color);
+    m_upscale.SetSampler(Source, 0);
+    m_upscale.SetVec2(UvScale, Vec2(static_cast<float>(m_renderWidth) / m_targetWidth,
+                                    static_cast<float>(m_renderHeight) / m_targetHeight));
+    m_upscale.SetVec2(TexelSize, Vec2(1.0f / m_targetWidth, 1.0f / m_targetHeight));
+    m_upscale.SetFloat(Sharpness, std::clamp(m_config.sharpness, 0.0f, 1.0f));
+
+    gl.BindVertexArray(m_vao);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+    gl.ApplyDefaults();
+
+    TimerPair& timers = m_timers[m_frame % FRAME_LATENCY];
+    glQueryCounter(timers.end, GL_TIMESTAMP);
+    timers.pending = true;
+}
+
+void DynamicResolution::Collect() {
+    TimerPair& timers = m_timers[m_frame % FRAME_LATENCY];
+    if (!timers.pending) return;
+    timers.pending = false;
+
+    GLint available = 0;
+    glGetQueryObjectiv(timers.end, GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available) {
+        return;
+    }
+
+    GLuint64 begin = 0, end = 0;
+    glGetQueryObjectui64v(timers.begin, GL_QUERY_RESULT, &begin);
+    glGetQueryObjectui64v(timers.end, GL_QUERY_RESULT, &end);
+    if (end > begin) {
+        Adjust(static_cast<double>(end - begin) / 1.0e6, timers.scale);
+    }
+}
+
+void DynamicResolution::Adjust(double milliseconds, float sampleScale) {
+    // Smoothed for display only: it mixes frames drawn at different scales
+    m_gpuMs = m_gpuMs > 0.0 ? m_gpuMs + (milliseconds - m_gpuMs) * TIME_SMOOTHING : milliseconds;
+
+    double target = std::max(m_config.targetMs, 1.0);
+    double budget = target * (1.0 - HEADROOM);
+    float ideal = sampleScale * static_cast<float>(std::sqrt(budget / std::max(milliseconds, 0.01)));
+    if (milliseconds > target) {
+        m_scale += (ideal - m_scale) * DOWN_RATE;
+    } else if (milliseconds < budget) {
+        m_scale += (ideal - m_scale) * UP_RATE;
+    }
+}
+
+// ============================================================================
+// Resources
+// ============================================================================
+
+bool DynamicResolution::EnsureShader() {
+    if (m_upscale.IsValid()) return true;
+
+    if (!m_upscale.LoadFromSource(g_upscaleVertexShader, g_upscaleFragmentShader, "upscale")) {
+        LOG_ERROR("DynamicResolution", "Failed to build the upscale shader");
+        return false;
+    }
+    if (m_vao == 0) {
+        glGenVertexArrays(1, &m_vao);
+    }
+    return true;
+}
+
+bool DynamicResolution::EnsureTarget(int width, int height) {
+    if (m_framebuffer != 0 && width == m_targetWidth && height == m_targetHeight) {
+        return true;
+    }
+    ReleaseTarget();
+
+    auto& gl = GLStateCache::Instance();
+    glGenTextures(1, &m_color);
+    gl.BindTexture(0, GL_TEXTURE_2D, m_color);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    glGenRenderbuffers(1, &m_depth);
+    glBindRenderbuffer(GL_RENDERBUFFER, m_depth);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    glGenFramebuffers(1, &m_framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_color, 0);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, m_depth);
+    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    if (status != GL_FRAMEBUFFER_COMPLETE) {
+        LOG_ERROR("DynamicResolution", "Render target " + std::to_string(width) + "x" +
+                  std::to_string(height) + " is incomplete");
+        ReleaseTarget();
+        return false;
+    }
+
+    m_targetWidth = width;
+    m_targetHeight = height;
+    LOG_INFO("DynamicResolution", "Render target " + std::to_string(width) + "x" + std::to_string(height));
+    return true;
+}
+
+void DynamicResolution::ReleaseTarget() {
+    if (m_framebuffer != 0) {
+        glDeleteFramebuffers(1, &m_framebuffer);
+        m_framebuffer = 0;
+    }
+    if (m_color != 0) {
+        GLStateCache::Instance().OnTextureDeleted(m_color);
+        glDeleteTextures(1, &m_color);
+        m_color = 0;
+    }
+    if (m_depth != 0) {
+        glDeleteRenderbuffers(1, &m_depth);
+        m_depth = 0;
+    }
+    m_targetWidth = 0;
+    m_targetHeight = 0;
+}
+
+void DynamicResolution::Shutdown() {
+    ReleaseTarget();
+    m_upscale = Shader();
+    if (m_vao != 0) {
+        GLStateCache::Instance().OnVertexArrayDeleted(m_vao);
+        glDeleteVertexArrays(1, &m_vao);
+        m_vao = 0;
+    }
+    for (TimerPair& timers : m_timers) {
+        if (timers.begin != 0) {
+            glDeleteQueries(1, &timers.begin);
+            glDeleteQueries(1, &timers.end);
+        }
+        timers = TimerPair();
+    }
+    m_active = false;
+}
+
+} // namespace Genesis
@@ -0,0 +1,113 @@
+#pragma once
+
+#include "renderer/shader/Shader.h"
+#include <cstdint>
+
+namespace Genesis {
+
+struct DynamicResolutionConfig {
+    bool enabled = false;           // r_dynres
+    double targetMs = 16.0;         // GPU time per frame the scale aims for (r_dynres_target)
+    float minScale = 0.5f;          // Of the window's width and height (r_dynres_min)
+    float maxScale = 1.0f;          // r_dynres_max, at most 1
+    float sharpness = 0.25f;        // Upscale sharpening, 0 = plain bilinear (r_dynres_sharpen)
+};
+
+// ============================================================================
+// DynamicResolution - 3D scene at a render scale that follows GPU time
+//
+// While enabled, BeginScene() binds an offscreen color + depth target and
+// sets the viewport to scale x the window; EndScene() upscales that to the
+// backbuffer, so the GUI drawn afterwards stays at native resolution.
+//
+// The target is allocated once at maxScale of the window and the scene is
+// drawn into its lower-left corner, so changing the scale never
+// reallocates. GL_TIMESTAMP queries bracket scene and upscale (they don't
+// clash with GpuTimers' GL_TIME_ELAPSED scopes, and work without the
+// profiler); results are read FRAME_LATENCY frames later and skipped if
+// the GPU isn't done. Pixel cost goes with the scale squared, so each
+// sample steers toward its own scale * sqrt(budget / its time): quickly
+// when over the target, slowly when under it by more than the headroom.
+// Samples still in flight from before a change then point at the same
+// scale instead of cutting again.
+//
+// The upscale is a sharpened bilinear: the bilinear sample plus its
+// difference to four neighbours a source texel away, clamped to their
+// range (contrast adaptive, so edges don't ring).
+//
+// The timestamps measure from the scene's first command to the upscale's
+// last, so a CPU-bound frame (the GPU waiting on submission) also reads
+// as slow; disable it where the CPU is the limit.
+//
+// Main thread / GL context only.
+// ============================================================================
+class DynamicResolution {
+public:
+    static DynamicResolution& Instance() {
+        static DynamicResolution instance;
+        return instance;
+    }
+
+    static constexpr uint32_t FRAME_LATENCY = 3;
+    static constexpr float MIN_SCALE = 0.25f;
+
+    DynamicResolutionConfig& GetConfig() { return m_config; }
+
+    // Offscreen target for a window of width x height (false: render to
+    // the backbuffer as usual, because disabled or the target failed)
+    bool BeginScene(int width, int height);
+
+    // Upscale to the backbuffer and restore the window viewport
+    void EndScene();
+
+    // Delete the target, shader and queries (before the GL context goes away)
+    void Shutdown();
+
+    float GetScale() const { return m_scale; }
+    int GetRenderWidth() const { return m_renderWidth; }
+    int GetRenderHeight() const { return m_renderHeight; }
+    double GetGpuMilliseconds() const { return m_gpuMs; }   // Smoothed, 0 until measured
+    bool IsActive() const { return m_active; }
+
+private:
+    DynamicResolution() = default;
+
+    bool EnsureTarget(int width, int height);
+    void ReleaseTarget();
+    bool EnsureShader();
+    void Collect();
+    void Adjust(double milliseconds, float sampleScale);
+
+    struct TimerPair {
+        uint32_t begin = 0;
+        uint32_t end = 0;
+        float scale = 1.0f;         // m_scale the frame was drawn at
+        bool pending = false;
+    };
+
+private:
+    DynamicResolutionConfig m_config;
+
+    // Target at maxScale of the window
+    uint32_t m_framebuffer = 0;
+    uint32_t m_color = 0;
+    uint32_t m_depth = 0;
+    int m_targetWidth = 0;
+    int m_targetHeight = 0;
+
+    Shader m_upscale;
+    uint32_t m_vao = 0;             // Empty: the fullscreen triangle comes from gl_VertexID
+
+    TimerPair m_timers[FRAME_LATENCY];
+    uint32_t m_frame = 0;
+
+    float m_scale = 1.0f;
+    double m_gpuMs = 0.0;
+    int m_windowWidth = 0;
+    int m_windowHeight = 0;
+    int m_renderWidth = 0;
+    int m_renderHeight = 0;
+    bool m_active = false;          // Between BeginScene and EndScene
+};
+
+} // namespace Genesis
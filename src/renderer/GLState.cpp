@@ -0,0 +1,181 @@
+#include "GLState.h"
+#include <glad/glad.h>
+
+namespace Genesis {
+
+// ============================================================================
+// Cache Control
+// ============================================================================
+
+void GLStateCache::Invalidate() {
+    m_program = UNKNOWN;
+    m_vao = UNKNOWN;
+    m_activeUnit = UNKNOWN;
+    for (auto& binding : m_textures) {
+        binding = { UNKNOWN, UNKNOWN };
+    }
+
+    m_blend = -1;
+    m_culling = -1;
+    m_depthTest = -1;
+    m_depthWrite = -1;
+    m_scissorTest = -1;
+    m_blendSrc = UNKNOWN;
+    m_blendDst = UNKNOWN;
+    m_cullFace = UNKNOWN;
+    m_depthFunc = UNKNOWN;
+}
+
+void GLStateCache::ApplyDefaults() {
+    SetBlend(false);
+    SetCulling(true);
+    SetCullFace(GL_BACK);
+    SetDepthTest(true);
+    SetDepthWrite(true);
+    SetScissorTest(false);
+}
+
+bool GLStateCache::Changed(uint32_t& cached, uint32_t value) {
+    if (cached == value) {
+        m_stats.skipped++;
+        return false;
+    }
+    cached = value;
+    m_stats.issued++;
+    return true;
+}
+
+bool GLStateCache::SetCap(int8_t& cached, uint32_t cap, bool enabled) {
+    int8_t value = enabled ? 1 : 0;
+    if (cached == value) {
+        m_stats.skipped++;
+        return false;
+    }
+    cached = value;
+    m_stats.issued++;
+
+    if (enabled) {
+        glEnable(cap);
+    } else {
+        glDisable(cap);
+    }
+    return true;
+}
+
+// ============================================================================
+// Bindings
+// ============================================================================
+
+void GLStateCache::UseProgram(uint32_t program) {
+    if (Changed(m_program, program)) {
+        glUseProgram(program);
+    }
+}
+
+void GLStateCache::BindVertexArray(uint32_t vao) {
+    if (Changed(m_vao, vao)) {
+        glBindVertexArray(vao);
+    }
+}
+
+void GLStateCache::BindTexture(uint32_t unit, uint32_t target, uint32_t texture) {
+    if (unit >= MAX_TEXTURE_UNITS) {
+        // Outside the cached range: forward without tracking
+        glActiveTexture(GL_TEXTURE0 + unit);
+        glBindTexture(target, texture);
+        m_activeUnit = unit;
+        m_stats.issued += 2;
+        return;
+    }
+
+    TextureBinding& binding = m_textures[unit];
+    if (binding.target == target && binding.texture == texture) {
+        m_stats.skipped++;
+        return;
+    }
+
+    if (Changed(m_activeUnit, unit)) {
+        glActiveTexture(GL_TEXTURE0 + unit);
+    }
+
+    glBindTexture(target, texture);
+    binding = { target, texture };
+    m_stats.issued++;
+}
+
+void GLStateCache::OnProgramDeleted(uint32_t program) {
+    // A deleted program stays current until replaced, so force the next bind
+    if (m_program == program) {
+        m_program = UNKNOWN;
+    }
+}
+
+void GLStateCache::OnVertexArrayDeleted(uint32_t vao) {
+    if (m_vao == vao) {
+        m_vao = 0;
+    }
+}
+
+void GLStateCache::OnTextureDeleted(uint32_t texture) {
+    for (auto& binding : m_textures) {
+        if (binding.texture == texture) {
+            binding.texture = 0;
+        }
+    }
+}
+
+// ============================================================================
+// Fixed-Function State
+// ============================================================================
+
+void GLStateCache::SetBlend(bool enabled) {
+    SetCap(m_blend, GL_BLEND, enabled);
+}
+
+void GLStateCache::SetBlendFunc(uint32_t srcFactor, uint32_t dstFactor) {
+    if (m_blendSrc == srcFactor && m_blendDst == dstFactor) {
+        m_stats.skipped++;
+        return;
+    }
+    m_blendSrc = srcFactor;
+    m_blendDst = dstFactor;
+    m_stats.issued++;
+    glBlendFunc(srcFactor, dstFactor);
+}
+
+void GLStateCache::SetCulling(bool enabled) {
+    SetCap(m_culling, GL_CULL_FACE, enabled);
+}
+
+void GLStateCache::SetCullFace(uint32_t face) {
+    if (Changed(m_cullFace, face)) {
+        glCullFace(face);
+    }
+}
+
+void GLStateCache::SetDepthTest(bool enabled) {
+    SetCap(m_depthTest, GL_DEPTH_TEST, enabled);
+}
+
+void GLStateCache::SetDepthWrite(bool enabled) {
+    int8_t value = enabled ? 1 : 0;
+    if (m_depthWrite == value) {
+        m_stats.skipped++;
+        return;
+    }
+    m_depthWrite = value;
+    m_stats.issued++;
+    glDepthMask(enabled ? GL_TRUE : GL_FALSE);
+}
+
+void GLStateCache::SetDepthFunc(uint32_t func) {
+    if (Changed(m_depthFunc, func)) {
+        glDepthFunc(func);
+    }
+}
+
+void GLStateCache::SetScissorTest(bool enabled) {
+    SetCap(m_scissorTest, GL_SCISSOR_TEST, enabled);
+}
+
+} // namespace Genesis
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Genesis {
+
+// ============================================================================
+// GL State Stats - How many state calls reached the driver
+// ============================================================================
+struct GLStateStats {
+    uint32_t issued = 0;    // Calls forwarded to GL
+    uint32_t skipped = 0;   // Calls dropped because the state already matched
+};
+
+// ============================================================================
+// GL State Cache - Shadow copy of the GL state the engine touches
+//
+// Every subsystem sets program/VAO/texture bindings and fixed-function state
+// through here, so only real changes reach the driver. Values start unknown
+// (the first call always goes through); call Invalidate() after code outside
+// the engine has touched GL behind the cache's back.
+//
+// Enum arguments are raw GLenum values, so this header doesn't need glad.
+//
+// Usage:
+//   auto& gl = GLStateCache::Instance();
+//   gl.SetBlend(true);
+//   gl.SetBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+//   gl.BindVertexArray(vao);
+// ============================================================================
+class GLStateCache {
+public:
+    static GLStateCache& Instance() {
+        static GLStateCache instance;
+        return instance;
+    }
+
+    static constexpr uint32_t MAX_TEXTURE_UNITS = 16;
+
+    // Forget all cached values (next call of each kind is always issued)
+    void Invalidate();
+
+    // Engine default 3D state: depth test/write on, back-face culling, no blend
+    void ApplyDefaults();
+
+    // ========================================================================
+    // Bindings
+    // ========================================================================
+
+    void UseProgram(uint32_t program);
+    void BindVertexArray(uint32_t vao);
+    void BindTexture(uint32_t unit, uint32_t target, uint32_t texture);
+
+    // GL resets bindings of deleted objects to 0; keep the cache in sync
+    void OnProgramDeleted(uint32_t program);
+    void OnVertexArrayDeleted(uint32_t vao);
+    void OnTextureDeleted(uint32_t texture);
+
+    // ========================================================================
+    // Fixed-Function State
+    // ========================================================================
+
+    void SetBlend(bool enabled);
+    void SetBlendFunc(uint32_t srcFactor, uint32_t dstFactor);
+    void SetCulling(bool enabled);
+    void SetCullFace(uint32_t face);
+    void SetDepthTest(bool enabled);
+    void SetDepthWrite(bool enabled);
+    void SetDepthFunc(uint32_t func);
+    void SetScissorTest(bool enabled);
+
+    // ========================================================================
+    // Statistics
+    // ========================================================================
+
+    const GLStateStats& GetStats() const { return m_stats; }
+
+    // Totals of the last completed frame (captured by ResetStats)
+    const GLStateStats& GetLastFrameStats() const { return m_lastFrameStats; }
+
+    // Call once per frame
+    void ResetStats() {
+        m_lastFrameStats = m_stats;
+        m_stats = GLStateStats();
+    }
+
+private:
+    GLStateCache() { Invalidate(); }
+
+    static constexpr uint32_t UNKNOWN = 0xFFFFFFFFu;
+
+    // Tri-state flag: -1 unknown, 0 off, 1 on
+    bool SetCap(int8_t& cached, uint32_t cap, bool enabled);
+
+    // Returns true (and counts an issued call) if value differs from cached
+    bool Changed(uint32_t& cached, uint32_t value);
+
+    struct TextureBinding {
+        uint32_t target;
+        uint32_t texture;
+    };
+
+    uint32_t m_program;
+    uint32_t m_vao;
+    uint32_t m_activeUnit;
+    TextureBinding m_textures[MAX_TEXTURE_UNITS];
+
+    int8_t m_blend;
+    int8_t m_culling;
+    int8_t m_depthTest;
+    int8_t m_depthWrite;
+    int8_t m_scissorTest;
+    uint32_t m_blendSrc;
+    uint32_t m_blendDst;
+    uint32_t m_cullFace;
+    uint32_t m_depthFunc;
+
+    GLStateStats m_stats;
+    GLStateStats m_lastFrameStats;
+};
+
+} // namespace Genesis
@@ -0,0 +1,124 @@
+#include "GpuTimer.h"
+
+#if defined(GENESIS_PROFILER_ENABLED)
+
+#include <glad/glad.h>
+#include <cstring>
+
+namespace Genesis {
+
+void GpuTimers::BeginFrame() {
+    // A scope left open across frames would make the next Begin fail
+    if (m_active) {
+        glEndQuery(GL_TIME_ELAPSED);
+        m_active = false;
+    }
+    m_nesting = 0;
+
+    m_frame++;
+    FrameSet& set = m_sets[m_frame % FRAME_LATENCY];
+
+    // Issued FRAME_LATENCY frames ago; nothing to read the first time round
+    if (set.used > 0) {
+        Collect(set);
+    }
+    set.used = 0;
+}
+
+void GpuTimers::Collect(FrameSet& set) {
+    m_results.clear();
+
+    for (uint32_t i = 0; i < set.used; i++) {
+        const Query& query = set.queries[i];
+
+        GLint available = 0;
+        glGetQueryObjectiv(query.id, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) {
+            m_skipped++;
+            continue;
+        }
+
+        GLuint64 elapsedNs = 0;
+        glGetQueryObjectui64v(query.id, GL_QUERY_RESULT, &elapsedNs);
+        double ms = static_cast<double>(elapsedNs) / 1.0e6;
+
+        bool merged = false;
+        for (auto& result : m_results) {
+            if (result.name == query.name || std::strcmp(result.name, query.name) == 0) {
+                result.milliseconds += ms;
+                merged = true;
+                break;
+            }
+        }
+        if (!merged) {
+            m_results.push_back(GpuTimerResult{query.name, ms});
+        }
+    }
+}
+
+void GpuTimers::Begin(const char* name) {
+    if (m_active) {
+        m_nesting++;
+        return;
+    }
+
+    FrameSet& set = m_sets[m_frame % FRAME_LATENCY];
+    if (set.used == set.queries.size()) {
+        Query query;
+        glGenQueries(1, &query.id);
+        set.queries.push_back(query);
+    }
+
+    Query& query = set.queries[set.used++];
+    query.name = name;
+    glBeginQuery(GL_TIME_ELAPSED, query.id);
+    m_active = true;
+}
+
+void GpuTimers::End() {
+    if (m_nesting > 0) {
+        m_nesting--;
+        return;
+    }
+    if (!m_active) return;
+
+    glEndQuery(GL_TIME_ELAPSED);
+    m_active = false;
+}
+
+void GpuTimers::Shutdown() {
+    if (m_active) {
+        glEndQuery(GL_TIME_ELAPSED);
+        m_active = false;
+    }
+
+    for (auto& set : m_sets) {
+        for (auto& query : set.queries) {
+            glDeleteQueries(1, &query.id);
+        }
+        set.queries.clear();
+        set.used = 0;
+    }
+    m_results.clear();
+}
+
+const GpuTimerResult* GpuTimers::FindResult(const char* name) const {
+    for (const auto& result : m_results) {
+        if (result.name == name || std::strcmp(result.name, name) == 0) {
+            return &result;
+        }
+    }
+    return nullptr;
+}
+
+double GpuTimers::GetTotalMilliseconds() const {
+    double total = 0.0;
+    for (const auto& result : m_results) {
+        total += result.milliseconds;
+    }
+    return total;
+}
+
+} // namespace Genesis
+
+#endif // GENESIS_PROFILER_ENABLED
@@ -0,0 +1,108 @@
+#pragma once
+
+// ============================================================================
+// GpuTimers - Per-pass GPU time from GL_TIME_ELAPSED queries
+//
+// GENESIS_GPU_SCOPE("Name") brackets the GL commands of a pass with a timer
+// query. Queries are kept in FRAME_LATENCY sets; BeginFrame() reads back the
+// set issued FRAME_LATENCY frames ago, by which time the GPU has normally
+// finished it. A result that is still not available is skipped rather than
+// waited for, so reading never stalls the pipeline.
+//
+// GL_TIME_ELAPSED queries can't nest: a scope opened inside another is
+// ignored (the outer one already covers it). Scopes with the same name in
+// one frame are summed. Zone names must be string literals; using the CPU
+// profiler's zone name lets DebugOverlay print both side by side.
+//
+// Compiled out together with the CPU profiler (GENESIS_PROFILER_ENABLED).
+// Main thread / GL context only.
+// ============================================================================
+
+#include "core/Profiler.h"
+
+#if defined(GENESIS_PROFILER_ENABLED)
+
+#include <cstdint>
+#include <vector>
+
+namespace Genesis {
+
+struct GpuTimerResult {
+    const char* name = nullptr;
+    double milliseconds = 0.0;
+};
+
+class GpuTimers {
+public:
+    static GpuTimers& Instance() {
+        static GpuTimers instance;
+        return instance;
+    }
+
+    static constexpr uint32_t FRAME_LATENCY = 3;
+
+    // Collect the oldest set and start recording a new one (once per frame)
+    void BeginFrame();
+
+    void Begin(const char* name);
+    void End();
+
+    // Delete all queries (before the GL context goes away)
+    void Shutdown();
+
+    // Passes of the newest frame with complete results, in issue order
+    const std::vector<GpuTimerResult>& GetResults() const { return m_results; }
+    const GpuTimerResult* FindResult(const char* name) const;
+    double GetTotalMilliseconds() const;
+
+    // Results that weren't ready after FRAME_LATENCY frames
+    uint32_t GetSkippedResults() const { return m_skipped; }
+
+private:
+    GpuTimers() = default;
+
+    struct Query {
+        const char* name = nullptr;
+        uint32_t id = 0;
+    };
+
+    struct FrameSet {
+        std::vector<Query> queries;   // Pooled; [0, used) issued this frame
+        uint32_t used = 0;
+    };
+
+    void Collect(FrameSet& set);
+
+private:
+    FrameSet m_sets[FRAME_LATENCY];
+    uint32_t m_frame = 0;
+    bool m_active = false;          // A query is open
+    uint32_t m_nesting = 0;         // Ignored nested scopes
+
+    std::vector<GpuTimerResult> m_results;
+    uint32_t m_skipped = 0;
+};
+
+// ============================================================================
+// GpuTimerScope - RAII query; use through GENESIS_GPU_SCOPE
+// ============================================================================
+class GpuTimerScope {
+public:
+    explicit GpuTimerScope(const char* name) { GpuTimers::Instance().Begin(name); }
+    ~GpuTimerScope() { GpuTimers::Instance().End(); }
+
+    GpuTimerScope(const GpuTimerScope&) = delete;
+    GpuTimerScope& operator=(const GpuTimerScope&) = delete;
+};
+
+} // namespace Genesis
+
+#define GENESIS_GPU_SCOPE(name) ::Genesis::GpuTimerScope GENESIS_PROFILE_CONCAT(gpuScope_, __LINE__)(name)
+#define GENESIS_GPU_FRAME() ::Genesis::GpuTimers::Instance().BeginFrame()
+
+#else
+
+#define GENESIS_GPU_SCOPE(name) ((void)0)
+#define GENESIS_GPU_FRAME() ((void)0)
+
+#endif
@@ -1,9 +1,11 @@
 #include "Renderer.h"
 #include "camera/Camera.h"
 #include "renderer/shader/Shader.h"
+#include "renderer/shader/UniformBuffer.h"
 #include "renderer/mesh/Mesh.h"
 #include "core/Logger.h"
 #include <algorithm>
+#include <cstring>
 
 namespace Genesis {
 
@@ -32,6 +34,7 @@ void Renderer::BeginFrame(const FPSCamera& camera) {
     m_projectionMatrix = camera.GetProjectionMatrix();
     m_viewProjMatrix = m_projectionMatrix * m_viewMatrix;
     m_cameraPosition = camera.GetPosition();
+    UpdateFrameUniforms();
 
     // Clear render queue
     m_renderQueue.clear();
@@ -53,8 +56,8 @@ void Renderer::EndFrame() {
     if (!m_renderQueue.empty()) {
         SortCommands();
 
-        for (const auto& cmd : m_renderQueue) {
-            ExecuteCommand(cmd);
+        for (const SortEntry& entry : m_sortEntries) {
+            ExecuteCommand(m_renderQueue[entry.index]);
         }
 
         m_renderQueue.clear();
@@ -76,10 +79,12 @@ void Renderer::EndFrame() {
 
 void Renderer::SetDirectionalLight(const DirectionalLight& light) {
     m_directionalLight = light;
+    UpdateFrameUniforms();
 }
 
 void Renderer::SetAmbientLight(const AmbientLight& light) {
     m_ambientLight = light;
+    UpdateFrameUniforms();
 }
 
 // ============================================================================
@@ -123,7 +128,12 @@ void Renderer::Submit(const RenderCommand& command) {
         LOG_WARNING("Renderer", "Submit called outside of BeginFrame/EndFrame");
         return;
     }
+    if (!command.mesh || !command.material) {
+        return;
+    }
+
     m_renderQueue.push_back(command);
+    m_renderQueue.back().sortKey = BuildSortKey(*command.material, command.transform);
 }
 
 void Renderer::Submit(const MeshPtr& mesh, const MaterialPtr& material, const Mat4& transform) {
@@ -150,6 +160,9 @@ bool Renderer::BindMaterial(Material& material, const Mat4& modelMatrix) {
         return false;
     }
 
+    // Send the frame block if camera/lighting changed (no-op otherwise)
+    FrameUniforms::Instance().Upload();
+
     // Check if we need to switch shaders
     Shader* shaderPtr = shader.get();
     if (m_currentShader != shaderPtr) {
@@ -174,30 +187,41 @@ bool Renderer::BindMaterial(Material& material, const Mat4& modelMatrix) {
 }
 
 void Renderer::UploadGlobalUniforms(Shader& shader, const Mat4& modelMatrix) {
-    // Transform matrices - only set if shader has them
-    if (shader.HasUniform("u_Model"))
-        shader.SetMat4("u_Model", modelMatrix);
-    if (shader.HasUniform("u_View"))
-        shader.SetMat4("u_View", m_viewMatrix);
-    if (shader.HasUniform("u_Proj"))
-        shader.SetMat4("u_Proj", m_projectionMatrix);
-    if (shader.HasUniform("u_ViewProj"))
-        shader.SetMat4("u_ViewProj", m_viewProjMatrix);
+    // Per-object state (handle setters skip uniforms the shader lacks)
+    shader.SetMat4(Uniforms::Model, modelMatrix);
+
+    // Per-object u_Model (shared shaders may have been left in instanced mode)
+    shader.SetInt(Uniforms::Instanced, 0);
+    shader.SetInt(Uniforms::ReceiveShadows, m_receiveShadows ? 1 : 0);
+
+    // Camera and lighting come from the FrameData block
+    if (shader.UsesFrameUniforms()) {
+        return;
+    }
+
+    // Legacy path for shaders without the block
+    shader.SetMat4(Uniforms::View, m_viewMatrix);
+    shader.SetMat4(Uniforms::Proj, m_projectionMatrix);
+    shader.SetMat4(Uniforms::ViewProj, m_viewProjMatrix);
 
     // Camera
-    if (shader.HasUniform("u_CameraPos"))
-        shader.SetVec3("u_CameraPos", m_cameraPosition);
+    shader.SetVec3(Uniforms::CameraPos, m_cameraPosition);
 
     // Directional light
     Vec3 lightDir = glm::normalize(m_directionalLight.direction);
-    if (shader.HasUniform("u_LightDir"))
-        shader.SetVec3("u_LightDir", lightDir);
-    if (shader.HasUniform("u_LightColor"))
-        shader.SetVec3("u_LightColor", m_directionalLight.color * m_directionalLight.intensity);
+    shader.SetVec3(Uniforms::LightDir, lightDir);
+    shader.SetVec3(Uniforms::LightColor, m_directionalLight.color * m_directionalLight.intensity);
 
     // Ambient light
-    if (shader.HasUniform("u_AmbientColor"))
-        shader.SetVec3("u_AmbientColor", m_ambientLight.color * m_ambientLight.intensity);
+    shader.SetVec3(Uniforms::AmbientColor, m_ambientLight.color * m_ambientLight.intensity);
+}
+
+void Renderer::UpdateFrameUniforms() {
+    auto& frame = FrameUniforms::Instance();
+    frame.SetCamera(m_viewMatrix, m_projectionMatrix, m_cameraPosition);
+    frame.SetLighting(m_directionalLight.direction,
+                      m_directionalLight.color * m_directionalLight.intensity,
+                      m_ambientLight.color * m_ambientLight.intensity);
 }
 
 // ============================================================================
@@ -218,34 +242,78 @@ void Renderer::ExecuteCommand(const RenderCommand& cmd) {
     if (!cmd.mesh || !cmd.material) {
         return;
     }
+    m_receiveShadows = cmd.receiveShadows;
     Draw(*cmd.mesh, *cmd.material, cmd.transform);
+    m_receiveShadows = true;
+}
+
+uint64_t Renderer::BuildSortKey(const Material& material, const Mat4& transform) const {
+    // Bit layout (high to low):
+    //   [63..48] render queue  (16)
+    //   opaque:      [47..36] shader (12) [35..20] material (16) [19..0] depth (20)
+    //   transparent: [47..28] ~depth (20) [27..16] shader (12) [15..0] material (16)
+    // Ids are truncated; a collision only costs a redundant state change.
+    const uint64_t queue = static_cast<uint64_t>(material.GetRenderQueue()) & 0xFFFF;
+    const Shader* shader = material.GetShader().get();
+    const uint64_t shaderId = (shader ? shader->GetProgramId() : 0) & 0xFFF;
+    const uint64_t materialId = material.GetSortId() & 0xFFFF;
+
+    // View-space depth of the object origin. For non-negative floats the IEEE
+    // bit pattern is monotonic, so its top 20 bits (exponent + 11 mantissa
+    // bits) are a logarithmic depth bucket: finer close to the camera.
+    float depth = -(m_viewMatrix * Vec4(Vec3(transform[3]), 1.0f)).z;
+    depth = std::max(depth, 0.0f);
+    uint32_t depthBits;
+    std::memcpy(&depthBits, &depth, sizeof(depthBits));
+    uint64_t depthBucket = (depthBits >> 11) & 0xFFFFF;
+
+    if (material.GetRenderQueue() == RenderQueue::Transparent) {
+        // Back-to-front first: blending order matters more than state changes
+        depthBucket = 0xFFFFF - depthBucket;
+        return (queue << 48) | (depthBucket << 28) | (shaderId << 16) | materialId;
+    }
+
+    // Group by state, then front-to-back within a material for early-Z
+    return (queue << 48) | (shaderId << 36) | (materialId << 20) | depthBucket;
 }
 
 void Renderer::SortCommands() {
-    // Sort by:
-    // 1. Render queue (background -> geometry -> transparent -> overlay)
-    // 2. Shader (minimize shader switches)
-    // 3. Material (minimize uniform uploads)
-
-    std::sort(m_renderQueue.begin(), m_renderQueue.end(),
-        [](const RenderCommand& a, const RenderCommand& b) {
-            // First by render queue
-            int queueA = static_cast<int>(a.material->GetRenderQueue());
-            int queueB = static_cast<int>(b.material->GetRenderQueue());
-            if (queueA != queueB) {
-                return queueA < queueB;
-            }
-
-            // Then by shader pointer (same shader grouped together)
-            Shader* shaderA = a.material->GetShader().get();
-            Shader* shaderB = b.material->GetShader().get();
-            if (shaderA != shaderB) {
-                return shaderA < shaderB;
-            }
-
-            // Then by material pointer
-            return a.material.get() < b.material.get();
-        });
+    const size_t count = m_renderQueue.size();
+    m_sortEntries.resize(count);
+    m_sortScratch.resize(count);
+
+    uint64_t allBits = 0, anyBits = ~uint64_t(0);
+    for (size_t i = 0; i < count; i++) {
+        uint64_t key = m_renderQueue[i].sortKey;
+        m_sortEntries[i] = { key, static_cast<uint32_t>(i) };
+        allBits |= key;
+        anyBits &= key;
+    }
+
+    // LSD radix sort, 8 bits per pass. Stable, so equal keys keep submission
+    // order. Passes where every key has the same byte are skipped, which is
+    // most of them for a typical frame (few queues, few shaders).
+    const uint64_t varying = allBits ^ anyBits;
+    for (uint32_t shift = 0; shift < 64; shift += 8) {
+        if (((varying >> shift) & 0xFF) == 0) continue;
+
+        uint32_t offsets[256] = {};
+        for (const SortEntry& entry : m_sortEntries) {
+            offsets[(entry.key >> shift) & 0xFF]++;
+        }
+
+        uint32_t total = 0;
+        for (uint32_t& offset : offsets) {
+            uint32_t n = offset;
+            offset = total;
+            total += n;
+        }
+
+        for (const SortEntry& entry : m_sortEntries) {
+            m_sortScratch[offsets[(entry.key >> shift) & 0xFF]++] = entry;
+        }
+        m_sortEntries.swap(m_sortScratch);
+    }
 }
 
 } // namespace Genesis
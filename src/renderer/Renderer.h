@@ -35,6 +35,9 @@ struct RenderCommand {
     MaterialPtr material;
     Mat4 transform = Mat4(1.0f);
 
+    // Filled in by Renderer::Submit, see Renderer::BuildSortKey
+    uint64_t sortKey = 0;
+
     // Optional per-draw overrides
     bool castShadows = true;
     bool receiveShadows = true;
@@ -149,9 +152,16 @@ private:
     // Execute a single render command
     void ExecuteCommand(const RenderCommand& cmd);
 
-    // Sort render commands by queue and material
+    // Sort render commands by their precomputed keys (radix sort)
     void SortCommands();
 
+    // 64-bit key: queue | shader | material | depth for opaque queues,
+    // queue | inverted depth | shader | material for RenderQueue::Transparent
+    uint64_t BuildSortKey(const Material& material, const Mat4& transform) const;
+
+    // Push camera/lighting into the shared FrameData block
+    void UpdateFrameUniforms();
+
 private:
     // Global state
     Mat4 m_viewMatrix = Mat4(1.0f);
@@ -166,10 +176,19 @@ private:
     // Current state (for batching)
     Shader* m_currentShader = nullptr;
     Material* m_currentMaterial = nullptr;
+    bool m_receiveShadows = true;   // RenderCommand::receiveShadows of the draw
 
     // Render queue
     std::vector<RenderCommand> m_renderQueue;
 
+    // Sort scratch (kept between frames to avoid reallocating)
+    struct SortEntry {
+        uint64_t key;
+        uint32_t index;
+    };
+    std::vector<SortEntry> m_sortEntries;
+    std::vector<SortEntry> m_sortScratch;
+
     // Statistics
     uint32_t m_drawCalls = 0;
     uint32_t m_shaderSwitches = 0;
@@ -0,0 +1,167 @@
+#include "StreamBuffer.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+namespace Genesis {
+
+StreamBuffer::~StreamBuffer() {
+    Release();
+}
+
+bool StreamBuffer::Create(uint32_t target, size_t frameBytes) {
+    Release();
+    m_target = target;
+    return Allocate(frameBytes);
+}
+
+bool StreamBuffer::Allocate(size_t frameBytes) {
+    size_t totalBytes = frameBytes * FRAME_COUNT;
+
+    glGenBuffers(1, &m_buffer);
+    if (m_buffer == 0) {
+        std::cerr << "[StreamBuffer] Failed to create buffer" << std::endl;
+        return false;
+    }
+    glBindBuffer(m_target, m_buffer);
+
+    const GLbitfield persistentFlags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    bool hasBufferStorage = (GLAD_GL_VERSION_4_4 || GLAD_GL_ARB_buffer_storage) && glBufferStorage;
+
+    if (hasBufferStorage) {
+        glBufferStorage(m_target, totalBytes, nullptr, persistentFlags);
+        m_mapped = static_cast<uint8_t*>(glMapBufferRange(m_target, 0, totalBytes, persistentFlags));
+
+        if (!m_mapped) {
+            // Immutable storage can't be respecified: start over with a mutable buffer
+            std::cerr << "[StreamBuffer] Persistent mapping failed, using unsynchronized maps" << std::endl;
+            glDeleteBuffers(1, &m_buffer);
+            glGenBuffers(1, &m_buffer);
+            glBindBuffer(m_target, m_buffer);
+            hasBufferStorage = false;
+        }
+    }
+
+    if (!hasBufferStorage) {
+        glBufferData(m_target, totalBytes, nullptr, GL_STREAM_DRAW);
+    }
+    glBindBuffer(m_target, 0);
+
+    m_frameSize = frameBytes;
+    m_frame = 0;
+    m_cursor = 0;
+    m_version++;
+    return true;
+}
+
+void StreamBuffer::Release() {
+    for (uint32_t i = 0; i < FRAME_COUNT; i++) {
+        if (m_fences[i]) {
+            glDeleteSync(m_fences[i]);
+            m_fences[i] = nullptr;
+        }
+    }
+
+    if (m_buffer != 0) {
+        if (m_mapped) {
+            glBindBuffer(m_target, m_buffer);
+            glUnmapBuffer(m_target);
+            glBindBuffer(m_target, 0);
+            m_mapped = nullptr;
+        }
+        glDeleteBuffers(1, &m_buffer);
+        m_buffer = 0;
+    }
+
+    m_frameSize = 0;
+    m_cursor = 0;
+}
+
+void StreamBuffer::WaitFence(uint32_t frame) {
+    GLsync fence = m_fences[frame];
+    if (!fence) return;
+
+    GLenum result = glClientWaitSync(fence, 0, 0);
+    if (result == GL_TIMEOUT_EXPIRED) {
+        m_stalls++;
+        do {
+            result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);  // 1 ms
+        } while (result == GL_TIMEOUT_EXPIRED);
+    }
+
+    glDeleteSync(fence);
+    m_fences[frame] = nullptr;
+}
+
+void StreamBuffer::BeginFrame() {
+    if (m_buffer == 0) return;
+
+    m_frame = (m_frame + 1) % FRAME_COUNT;
+    m_cursor = 0;
+    WaitFence(m_frame);
+}
+
+void StreamBuffer::EndFrame() {
+    if (m_buffer == 0 || m_cursor == 0) return;
+
+    if (m_fences[m_frame]) {
+        glDeleteSync(m_fences[m_frame]);
+    }
+    m_fences[m_frame] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+void StreamBuffer::Grow(size_t minFrameBytes) {
+    size_t newSize = std::max(m_frameSize * 2, minFrameBytes);
+    std::cout << "[StreamBuffer] Growing frame region " << m_frameSize
+              << " -> " << newSize << " bytes" << std::endl;
+
+    // Everything in flight (including draws from this frame) must finish
+    // before the old storage goes away
+    for (uint32_t i = 0; i < FRAME_COUNT; i++) {
+        WaitFence(i);
+    }
+    if (m_cursor > 0) {
+        glFinish();
+    }
+
+    uint32_t target = m_target;
+    uint32_t frame = m_frame;
+    Release();
+    m_target = target;
+    Allocate(newSize);
+    m_frame = frame;
+}
+
+size_t StreamBuffer::Write(const void* data, size_t bytes, size_t alignment) {
+    if (m_buffer == 0) return INVALID_OFFSET;
+    alignment = std::max<size_t>(alignment, 1);
+
+    size_t regionStart = static_cast<size_t>(m_frame) * m_frameSize;
+    size_t offset = (regionStart + m_cursor + alignment - 1) / alignment * alignment;
+
+    if (offset + bytes > regionStart + m_frameSize) {
+        Grow(bytes + alignment);
+        if (m_buffer == 0) return INVALID_OFFSET;
+
+        regionStart = static_cast<size_t>(m_frame) * m_frameSize;
+        offset = (regionStart + alignment - 1) / alignment * alignment;
+    }
+
+    if (m_mapped) {
+        std::memcpy(m_mapped + offset, data, bytes);
+    } else {
+        // The fences guarantee the GPU is done with this range
+        glBindBuffer(m_target, m_buffer);
+        void* dst = glMapBufferRange(m_target, offset, bytes,
+                                     GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+        if (dst) {
+            std::memcpy(dst, data, bytes);
+            glUnmapBuffer(m_target);
+        }
+    }
+
+    m_cursor = offset + bytes - regionStart;
+    return offset;
+}
+
+} // namespace Genesis
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <glad/glad.h>
+
+namespace Genesis {
+
+// ============================================================================
+// StreamBuffer - Ring buffer for per-frame vertex data
+//
+// One GL buffer split into FRAME_COUNT regions. Each frame writes into the
+// next region while the GPU may still read the previous ones; EndFrame()
+// fences the region and BeginFrame() only waits on that fence when the ring
+// wraps around to it, which normally has long since signaled.
+//
+// With ARB_buffer_storage (core in 4.4) the buffer is persistently and
+// coherently mapped, so Write() is a plain memcpy into GPU-visible memory.
+// On plain 3.3 contexts each Write() maps its range unsynchronized instead;
+// the fences make that safe in the same way. Either way the storage is
+// allocated once and never respecified per frame.
+//
+// A frame that outgrows its region waits for the GPU and reallocates the
+// ring at twice the size. Vertex array bindings must then be re-pointed:
+// compare GetVersion() to the version the VAO was set up with.
+//
+// Usage:
+//   stream.BeginFrame();
+//   size_t offset = stream.Write(verts.data(), bytes, sizeof(Vertex));
+//   glDrawArrays(GL_LINES, offset / sizeof(Vertex), count);
+//   stream.EndFrame();
+// ============================================================================
+class StreamBuffer {
+public:
+    static constexpr uint32_t FRAME_COUNT = 3;
+    static constexpr size_t INVALID_OFFSET = static_cast<size_t>(-1);
+
+    StreamBuffer() = default;
+    ~StreamBuffer();
+
+    // Non-copyable
+    StreamBuffer(const StreamBuffer&) = delete;
+    StreamBuffer& operator=(const StreamBuffer&) = delete;
+
+    // Allocate FRAME_COUNT regions of frameBytes each
+    bool Create(uint32_t target, size_t frameBytes);
+    void Release();
+
+    // Move to the next region (waits if the GPU still reads it)
+    void BeginFrame();
+
+    // Fence everything written since BeginFrame()
+    void EndFrame();
+
+    // Copy data into the current region. Returns its byte offset in the
+    // buffer, a multiple of alignment (need not be a power of two, so a
+    // vertex stride works), or INVALID_OFFSET if the buffer is not created.
+    size_t Write(const void* data, size_t bytes, size_t alignment = 16);
+
+    bool IsValid() const { return m_buffer != 0; }
+    bool IsPersistent() const { return m_mapped != nullptr; }
+    uint32_t GetId() const { return m_buffer; }
+    uint32_t GetVersion() const { return m_version; }
+    size_t GetFrameSize() const { return m_frameSize; }
+
+    // Bytes written in the current frame / times BeginFrame had to block
+    size_t GetFrameUsed() const { return m_cursor; }
+    uint32_t GetStallCount() const { return m_stalls; }
+
+private:
+    bool Allocate(size_t frameBytes);
+    void Grow(size_t minFrameBytes);
+    void WaitFence(uint32_t frame);
+
+private:
+    uint32_t m_target = GL_ARRAY_BUFFER;
+    uint32_t m_buffer = 0;
+    uint8_t* m_mapped = nullptr;        // Persistent mapping, or nullptr
+    size_t m_frameSize = 0;
+
+    GLsync m_fences[FRAME_COUNT] = {};
+    uint32_t m_frame = 0;
+    size_t m_cursor = 0;                // Offset within the current region
+
+    uint32_t m_version = 0;
+    uint32_t m_stalls = 0;
+};
+
+} // namespace Genesis
@@ -1,11 +1,17 @@
 #include "Material.h"
+#include "renderer/GLState.h"
+#include "renderer/texture/Texture.h"
+#include "core/Hash.h"
 #include <glad/glad.h>
 #include <iostream>
 #include <algorithm>
+#include <cmath>
+#include <cstring>
 
 namespace Genesis {
 
 int Material::s_instanceCounter = 0;
+std::atomic<uint32_t> Material::s_nextSortId{1};
 
 // ============================================================================
 // Constructors
@@ -30,6 +36,46 @@ Material::Material(const std::string& name, std::shared_ptr<Shader> shader)
 
 void Material::SetShader(std::shared_ptr<Shader> shader) {
     m_shader = std::move(shader);
+    MarkDirty();
+    ResolveVariant();
+}
+
+std::shared_ptr<Shader> Material::GetShader() const {
+    // Until the variant links it draws with the flat fallback program, so
+    // keep using the base shader rather than flashing gray
+    if (m_variant && m_variant->IsValid() && !m_variant->IsUsingFallback()) {
+        return m_variant;
+    }
+    return m_shader;
+}
+
+// ============================================================================
+// Shader Keywords
+// ============================================================================
+
+void Material::SetKeyword(const std::string& name, bool enabled) {
+    ShaderKeywords bit = ShaderLibrary::Instance().GetKeyword(name);
+    ShaderKeywords keywords = enabled ? (m_keywords | bit) : (m_keywords & ~bit);
+    if (keywords == m_keywords) return;
+
+    m_keywords = keywords;
+    MarkDirty();
+    ResolveVariant();
+}
+
+bool Material::IsKeywordEnabled(const std::string& name) const {
+    return (m_keywords & ShaderLibrary::Instance().GetKeyword(name)) != 0;
+}
+
+void Material::ResolveVariant() {
+    if (!m_shader || m_keywords == 0) {
+        m_variant.reset();
+        return;
+    }
+    m_variant = ShaderLibrary::Instance().GetVariant(m_shader, m_keywords);
+    if (m_variant == m_shader) {
+        m_variant.reset();
+    }
 }
 
 // ============================================================================
@@ -38,30 +84,37 @@ void Material::SetShader(std::shared_ptr<Shader> shader) {
 
 void Material::SetInt(const std::string& name, int value) {
     m_properties[name] = MaterialProperty(name, value);
+    MarkDirty();
 }
 
 void Material::SetFloat(const std::string& name, float value) {
     m_properties[name] = MaterialProperty(name, value);
+    MarkDirty();
 }
 
 void Material::SetVec2(const std::string& name, const Vec2& value) {
     m_properties[name] = MaterialProperty(name, value);
+    MarkDirty();
 }
 
 void Material::SetVec3(const std::string& name, const Vec3& value) {
     m_properties[name] = MaterialProperty(name, value);
+    MarkDirty();
 }
 
 void Material::SetVec4(const std::string& name, const Vec4& value) {
     m_properties[name] = MaterialProperty(name, value);
+    MarkDirty();
 }
 
 void Material::SetMat3(const std::string& name, const Mat3& value) {
     m_properties[name] = MaterialProperty(name, value);
+    MarkDirty();
 }
 
 void Material::SetMat4(const std::string& name, const Mat4& value) {
     m_properties[name] = MaterialProperty(name, value);
+    MarkDirty();
 }
 
 void Material::SetTexture(const std::string& name, std::shared_ptr<Texture2D> texture, int unit) {
@@ -70,10 +123,12 @@ void Material::SetTexture(const std::string& name, std::shared_ptr<Texture2D> te
     slot.unit = unit;
     slot.uniformName = name;
     m_properties[name] = MaterialProperty(name, slot);
+    MarkDirty();
 }
 
 void Material::SetTextureSlot(const std::string& name, const TextureSlot& slot) {
     m_properties[name] = MaterialProperty(name, slot);
+    MarkDirty();
 }
 
 // ============================================================================
@@ -153,14 +208,15 @@ bool Material::HasTag(const std::string& tag) const {
 // ============================================================================
 
 void Material::Bind() const {
-    if (!m_shader || !m_shader->IsValid()) {
+    auto shader = GetShader();
+    if (!shader || !shader->IsValid()) {
         std::cerr << "[Material] Cannot bind material '" << m_name
                   << "': no valid shader" << std::endl;
         return;
     }
 
     // Bind shader
-    m_shader->Bind();
+    shader->Bind();
 
     // Apply render state
     ApplyRenderState();
@@ -170,128 +226,230 @@ void Material::Bind() const {
 }
 
 void Material::Unbind() const {
-    if (m_shader) {
-        m_shader->Unbind();
+    if (auto shader = GetShader()) {
+        shader->Unbind();
     }
 
     // Reset render state to defaults
-    glDisable(GL_BLEND);
-    glEnable(GL_CULL_FACE);
-    glCullFace(GL_BACK);
-    glDepthMask(GL_TRUE);
-    glEnable(GL_DEPTH_TEST);
+    GLStateCache::Instance().ApplyDefaults();
 }
 
 void Material::ApplyRenderState() const {
+    auto& gl = GLStateCache::Instance();
+
     // Blend mode
     switch (m_blendMode) {
         case BlendMode::Opaque:
-            glDisable(GL_BLEND);
+            gl.SetBlend(false);
             break;
         case BlendMode::Cutout:
-            glDisable(GL_BLEND);
+            gl.SetBlend(false);
             // Alpha cutoff is handled in shader via u_AlphaCutoff
             break;
         case BlendMode::Transparent:
-            glEnable(GL_BLEND);
-            glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+            gl.SetBlend(true);
+            gl.SetBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
             break;
         case BlendMode::Additive:
-            glEnable(GL_BLEND);
-            glBlendFunc(GL_SRC_ALPHA, GL_ONE);
+            gl.SetBlend(true);
+            gl.SetBlendFunc(GL_SRC_ALPHA, GL_ONE);
             break;
         case BlendMode::Multiply:
-            glEnable(GL_BLEND);
-            glBlendFunc(GL_DST_COLOR, GL_ZERO);
+            gl.SetBlend(true);
+            gl.SetBlendFunc(GL_DST_COLOR, GL_ZERO);
             break;
     }
 
     // Cull mode
     switch (m_cullMode) {
         case CullMode::Off:
-            glDisable(GL_CULL_FACE);
+            gl.SetCulling(false);
             break;
         case CullMode::Back:
-            glEnable(GL_CULL_FACE);
-            glCullFace(GL_BACK);
+            gl.SetCulling(true);
+            gl.SetCullFace(GL_BACK);
             break;
         case CullMode::Front:
-            glEnable(GL_CULL_FACE);
-            glCullFace(GL_FRONT);
+            gl.SetCulling(true);
+            gl.SetCullFace(GL_FRONT);
             break;
     }
 
-    // Depth write
-    glDepthMask(m_depthWrite ? GL_TRUE : GL_FALSE);
+    // Depth write / test
+    gl.SetDepthWrite(m_depthWrite);
+    gl.SetDepthTest(m_depthTest);
+}
 
-    // Depth test
-    if (m_depthTest) {
-        glEnable(GL_DEPTH_TEST);
-    } else {
-        glDisable(GL_DEPTH_TEST);
+void Material::UploadProperties() const {
+    auto shader = GetShader();
+    if (!shader) return;
+
+    const UniformBlockLayout* block = shader->GetMaterialBlock();
+    if (!block) {
+        for (const auto& [name, prop] : m_properties) {
+            UploadPropertyValue(*shader, prop);
+        }
+        return;
+    }
+
+    // Recompile after a property change or when the shader was swapped/relinked
+    // (including switching from the base shader to a variant)
+    if (m_blockDirty || m_blockShader != shader.get() ||
+        m_blockShaderVersion != shader->GetLinkVersion()) {
+        CompileBlock(*shader, *block);
+    }
+
+    m_blockBuffer.BindRange(UniformBinding::Material, 0, block->size);
+
+    for (const MaterialProperty* prop : m_looseProperties) {
+        UploadPropertyValue(*shader, *prop);
     }
 }
 
-void Material::UploadProperties() const {
-    if (!m_shader) return;
+void Material::CompileBlock(const Shader& shader, const UniformBlockLayout& layout) const {
+    m_blockData.assign(layout.size, 0);
+    m_looseProperties.clear();
+    WriteBlock(layout, m_blockData.data(), &m_looseProperties);
 
+    if (m_blockBuffer.GetSize() != layout.size) {
+        m_blockBuffer.Create(layout.size);
+    }
+    m_blockBuffer.Update(m_blockData.data(), m_blockData.size());
+
+    m_blockShader = &shader;
+    m_blockShaderVersion = shader.GetLinkVersion();
+    m_blockDirty = false;
+}
+
+void Material::PackBlockData(const UniformBlockLayout& layout, uint8_t* dst) const {
+    WriteBlock(layout, dst, nullptr);
+}
+
+void Material::WriteBlock(const UniformBlockLayout& layout, uint8_t* blockData,
+                          std::vector<const MaterialProperty*>* loose) const {
     for (const auto& [name, prop] : m_properties) {
-        UploadProperty(name);
+        const UniformBlockMember* member = layout.Find(prop.handle);
+        if (!member) {
+            if (loose) loose->push_back(&prop);
+            continue;
+        }
+
+        uint8_t* dst = blockData + member->offset;
+
+        // The block member's type decides how many components are written,
+        // e.g. a Vec4 color feeding a vec3 member drops its alpha
+        auto writeFloats = [&](const float* src, size_t count) {
+            size_t width = 0;
+            switch (member->type) {
+                case UniformType::Float: width = 1; break;
+                case UniformType::Vec2:  width = 2; break;
+                case UniformType::Vec3:  width = 3; break;
+                case UniformType::Vec4:  width = 4; break;
+                default: return;
+            }
+            std::memcpy(dst, src, std::min(width, count) * sizeof(float));
+        };
+        auto writeColumns = [&](const float* src, size_t columns, size_t rows) {
+            for (size_t c = 0; c < columns; c++) {
+                std::memcpy(dst + c * member->matrixStride, src + c * rows, rows * sizeof(float));
+            }
+        };
+
+        std::visit([&](auto&& arg) {
+            using T = std::decay_t<decltype(arg)>;
+
+            if constexpr (std::is_same_v<T, int>) {
+                if (member->type == UniformType::Int) {
+                    std::memcpy(dst, &arg, sizeof(int));
+                } else {
+                    float f = static_cast<float>(arg);
+                    writeFloats(&f, 1);
+                }
+            }
+            else if constexpr (std::is_same_v<T, float>) {
+                writeFloats(&arg, 1);
+            }
+            else if constexpr (std::is_same_v<T, Vec2> || std::is_same_v<T, Vec3> ||
+                               std::is_same_v<T, Vec4>) {
+                writeFloats(&arg[0], T::length());
+            }
+            else if constexpr (std::is_same_v<T, Mat3>) {
+                if (member->type == UniformType::Mat3) writeColumns(&arg[0][0], 3, 3);
+            }
+            else if constexpr (std::is_same_v<T, Mat4>) {
+                if (member->type == UniformType::Mat4) writeColumns(&arg[0][0], 4, 4);
+            }
+        }, prop.value);
     }
 }
 
 void Material::UploadProperty(const std::string& name) const {
-    if (!m_shader) return;
+    auto shader = GetShader();
+    if (!shader) return;
 
     auto it = m_properties.find(name);
     if (it == m_properties.end()) return;
 
-    const MaterialProperty& prop = it->second;
+    UploadPropertyValue(*shader, it->second);
+}
 
-    std::visit([this, &name](auto&& arg) {
+void Material::UploadPropertyValue(Shader& shader, const MaterialProperty& prop) const {
+    std::visit([&shader, &prop](auto&& arg) {
         using T = std::decay_t<decltype(arg)>;
 
         if constexpr (std::is_same_v<T, std::monostate>) {
             // Do nothing
         }
         else if constexpr (std::is_same_v<T, int>) {
-            m_shader->SetInt(name, arg);
+            shader.SetInt(prop.handle, arg);
         }
         else if constexpr (std::is_same_v<T, float>) {
-            m_shader->SetFloat(name, arg);
+            shader.SetFloat(prop.handle, arg);
         }
         else if constexpr (std::is_same_v<T, Vec2>) {
-            m_shader->SetVec2(name, arg);
+            shader.SetVec2(prop.handle, arg);
         }
         else if constexpr (std::is_same_v<T, Vec3>) {
-            m_shader->SetVec3(name, arg);
+            shader.SetVec3(prop.handle, arg);
         }
         else if constexpr (std::is_same_v<T, Vec4>) {
-            m_shader->SetVec4(name, arg);
+            shader.SetVec4(prop.handle, arg);
         }
         else if constexpr (std::is_same_v<T, Mat3>) {
-            m_shader->SetMat3(name, arg);
+            shader.SetMat3(prop.handle, arg);
         }
         else if constexpr (std::is_same_v<T, Mat4>) {
-            m_shader->SetMat4(name, arg);
+            shader.SetMat4(prop.handle, arg);
         }
         else if constexpr (std::is_same_v<T, TextureSlot>) {
-            // Bind texture to its unit
-            // Note: Texture2D binding would go here when texture system is implemented
-            // For now, just set the sampler uniform to the correct unit
-            m_shader->SetSampler(name, arg.unit);
+            // Bind texture to its unit (the handle changes as it streams)
+            if (arg.texture && arg.texture->IsValid()) {
+                GLStateCache::Instance().BindTexture(static_cast<uint32_t>(arg.unit), GL_TEXTURE_2D,
+                                                     arg.texture->GetHandle());
+            }
+            shader.SetSampler(prop.handle, arg.unit);
 
             // If we have tiling/offset, upload those too
             // Convention: u_TextureName_ST for scale/tiling and offset
             if (arg.tiling != Vec2(1.0f, 1.0f) || arg.offset != Vec2(0.0f, 0.0f)) {
-                std::string stName = name + "_ST";
-                m_shader->SetVec4(stName, Vec4(arg.tiling.x, arg.tiling.y,
-                                                arg.offset.x, arg.offset.y));
+                shader.SetVec4(prop.tilingHandle, Vec4(arg.tiling.x, arg.tiling.y,
+                                                          arg.offset.x, arg.offset.y));
             }
         }
     }, prop.value);
 }
 
+void Material::RequestTextureScreenSize(float screenFraction) const {
+    for (const auto& [name, prop] : m_properties) {
+        if (prop.type != MaterialPropertyType::Texture2D) continue;
+        const TextureSlot& slot = std::get<TextureSlot>(prop.value);
+        if (!slot.texture) continue;
+
+        float repeats = std::max(1.0f, std::max(std::abs(slot.tiling.x), std::abs(slot.tiling.y)));
+        slot.texture->RequestScreenSize(screenFraction / repeats);
+    }
+}
+
 // ============================================================================
 // Cloning and Instancing
 // ============================================================================
@@ -301,6 +459,8 @@ std::shared_ptr<Material> Material::Clone(const std::string& newName) const {
     auto clone = std::make_shared<Material>(cloneName);
 
     clone->m_shader = m_shader;
+    clone->m_variant = m_variant;
+    clone->m_keywords = m_keywords;
     clone->m_properties = m_properties;
     clone->m_renderQueue = m_renderQueue;
     clone->m_blendMode = m_blendMode;
@@ -321,6 +481,77 @@ std::shared_ptr<Material> Material::CreateInstance(const std::string& instanceNa
     return Clone(instName);
 }
 
+// ============================================================================
+// Content
+// ============================================================================
+
+static uint64_t HashPropertyValue(uint64_t hash, const MaterialPropertyValue& value) {
+    return std::visit([hash](auto&& arg) -> uint64_t {
+        using T = std::decay_t<decltype(arg)>;
+        if constexpr (std::is_same_v<T, std::monostate>) {
+            return hash;
+        } else if constexpr (std::is_same_v<T, TextureSlot>) {
+            uint64_t h = HashValue(hash, arg.texture.get());
+            h = HashValue(h, arg.unit);
+            h = HashString(h, arg.uniformName);
+            h = HashValue(h, arg.tiling);
+            return HashValue(h, arg.offset);
+        } else {
+            return HashValue(hash, arg);
+        }
+    }, value);
+}
+
+static bool SamePropertyValue(const MaterialPropertyValue& a, const MaterialPropertyValue& b) {
+    if (a.index() != b.index()) return false;
+    return std::visit([&b](auto&& arg) -> bool {
+        using T = std::decay_t<decltype(arg)>;
+        const T& other = std::get<T>(b);
+        if constexpr (std::is_same_v<T, std::monostate>) {
+            return true;
+        } else if constexpr (std::is_same_v<T, TextureSlot>) {
+            return arg.texture == other.texture && arg.unit == other.unit &&
+                   arg.uniformName == other.uniformName && arg.tiling == other.tiling &&
+                   arg.offset == other.offset;
+        } else {
+            return arg == other;
+        }
+    }, a);
+}
+
+uint64_t Material::ComputeContentHash() const {
+    uint64_t hash = HashValue(FNV_OFFSET, m_shader.get());
+    hash = HashValue(hash, m_keywords);
+    hash = HashValue(hash, m_renderQueue);
+    hash = HashValue(hash, m_blendMode);
+    hash = HashValue(hash, m_cullMode);
+    hash = HashValue(hash, m_depthWrite);
+    hash = HashValue(hash, m_depthTest);
+
+    // The map's order isn't stable, so properties are summed
+    uint64_t properties = 0;
+    for (const auto& [name, prop] : m_properties) {
+        properties += HashPropertyValue(HashString(FNV_OFFSET, name), prop.value);
+    }
+    return HashValue(hash, properties);
+}
+
+bool Material::HasSameContent(const Material& other) const {
+    if (m_shader != other.m_shader || m_keywords != other.m_keywords ||
+        m_renderQueue != other.m_renderQueue || m_blendMode != other.m_blendMode ||
+        m_cullMode != other.m_cullMode || m_depthWrite != other.m_depthWrite ||
+        m_depthTest != other.m_depthTest || m_properties.size() != other.m_properties.size()) {
+        return false;
+    }
+    for (const auto& [name, prop] : m_properties) {
+        auto it = other.m_properties.find(name);
+        if (it == other.m_properties.end() || !SamePropertyValue(prop.value, it->second.value)) {
+            return false;
+        }
+    }
+    return true;
+}
+
 // ============================================================================
 // Debug
 // ============================================================================
@@ -329,6 +560,9 @@ void Material::PrintDebugInfo() const {
     std::cout << "=== Material Debug Info ===" << std::endl;
     std::cout << "Name: " << m_name << std::endl;
     std::cout << "Shader: " << (m_shader ? m_shader->GetName() : "none") << std::endl;
+    if (m_keywords != 0) {
+        std::cout << "Keywords:\n" << ShaderLibrary::Instance().BuildDefines(m_keywords);
+    }
     std::cout << "Render Queue: " << static_cast<int>(m_renderQueue) << std::endl;
     std::cout << "Blend Mode: " << static_cast<int>(m_blendMode) << std::endl;
     std::cout << "Properties (" << m_properties.size() << "):" << std::endl;
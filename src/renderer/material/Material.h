@@ -2,16 +2,25 @@
 
 #include "MaterialProperty.h"
 #include "renderer/shader/Shader.h"
+#include "renderer/shader/UniformBuffer.h"
+#include "core/MemoryTracker.h"
 #include <string>
 #include <unordered_map>
 #include <memory>
 #include <vector>
+#include <atomic>
 
 namespace Genesis {
 
 // Forward declarations
 class Texture2D;
 
+// Property storage, charged to MemoryTag::Materials
+using MaterialPropertyMap = std::unordered_map<std::string, MaterialProperty, std::hash<std::string>,
+                                               std::equal_to<std::string>,
+                                               TaggedAllocator<std::pair<const std::string, MaterialProperty>,
+                                                               MemoryTag::Materials>>;
+
 // ============================================================================
 // Render Queue - Controls rendering order
 // ============================================================================
@@ -53,6 +62,16 @@ enum class CullMode {
 // - Shader defines the "type" of surface (LitOpaque, Unlit, etc.)
 // - Material defines the "instance" (red metal, blue plastic, etc.)
 // - One shader, many materials, zero duplicated logic
+//
+// If the shader declares a std140 "MaterialData" block, properties that live
+// in it are packed into a per-material uniform buffer. The buffer is only
+// rewritten when a property changes, so binding an unchanged material is a
+// single glBindBufferRange. Properties outside the block (samplers, or every
+// property on shaders without the block) still go through glUniform*.
+//
+// Keywords select a compiled variant of the shader (see ShaderLibrary::
+// GetVariant) instead of branching on a uniform. GetShader() returns the
+// variant once it has linked and the base shader until then.
 // ============================================================================
 class Material {
 public:
@@ -72,8 +91,20 @@ public:
     // ========================================================================
 
     void SetShader(std::shared_ptr<Shader> shader);
-    std::shared_ptr<Shader> GetShader() const { return m_shader; }
-    bool HasShader() const { return m_shader != nullptr && m_shader->IsValid(); }
+
+    // Shader to draw with: the keyword variant if it is ready, else the base
+    std::shared_ptr<Shader> GetShader() const;
+    const std::shared_ptr<Shader>& GetBaseShader() const { return m_shader; }
+    bool HasShader() const { auto shader = GetShader(); return shader && shader->IsValid(); }
+
+    // ========================================================================
+    // Shader Keywords
+    // ========================================================================
+
+    // Enable/disable "#define <name> 1" for this material's shader
+    void SetKeyword(const std::string& name, bool enabled = true);
+    bool IsKeywordEnabled(const std::string& name) const;
+    ShaderKeywords GetKeywords() const { return m_keywords; }
 
     // ========================================================================
     // Property Setters - Set uniform values by name
@@ -116,7 +147,7 @@ public:
     const TextureSlot* GetTextureSlot(const std::string& name) const;
 
     // Get all properties (for serialization/debugging)
-    const std::unordered_map<std::string, MaterialProperty>& GetProperties() const { return m_properties; }
+    const MaterialPropertyMap& GetProperties() const { return m_properties; }
 
     // ========================================================================
     // Render State
@@ -157,6 +188,17 @@ public:
     // Upload a specific property
     void UploadProperty(const std::string& name) const;
 
+    // Tell the streamed textures how large a surface using this material
+    // appears (fraction of the screen height); tiling shrinks each repeat
+    void RequestTextureScreenSize(float screenFraction) const;
+
+    // Write the properties that live in a MaterialData layout at their
+    // member offsets in dst (for a table layout, one entry; see MaterialTable)
+    void PackBlockData(const UniformBlockLayout& layout, uint8_t* dst) const;
+
+    // Bumped by every property or keyword change
+    uint32_t GetVersion() const { return m_version; }
+
     // ========================================================================
     // Metadata
     // ========================================================================
@@ -164,6 +206,9 @@ public:
     const std::string& GetName() const { return m_name; }
     void SetName(const std::string& name) { m_name = name; }
 
+    // Small unique id used in render sort keys
+    uint32_t GetSortId() const { return m_sortId; }
+
     // Tagging for material organization
     void AddTag(const std::string& tag) { m_tags.push_back(tag); }
     bool HasTag(const std::string& tag) const;
@@ -177,20 +222,51 @@ public:
     std::shared_ptr<Material> Clone(const std::string& newName = "") const;
 
     // Create an instance that shares the shader but has its own properties
+    // (MaterialLibrary::Intern it once configured to share an identical one)
     std::shared_ptr<Material> CreateInstance(const std::string& instanceName = "") const;
 
+    // ========================================================================
+    // Content (MaterialLibrary::Intern)
+    //
+    // Base shader, keywords, render state and property values; name, tags
+    // and sort id are not part of it.
+    // ========================================================================
+
+    uint64_t ComputeContentHash() const;
+    bool HasSameContent(const Material& other) const;
+
     // ========================================================================
     // Debug
     // ========================================================================
 
     void PrintDebugInfo() const;
 
+private:
+    void MarkDirty() { m_blockDirty = true; m_version++; }
+
+    // Pack block properties into m_blockData and upload them to m_blockBuffer
+    void CompileBlock(const Shader& shader, const UniformBlockLayout& layout) const;
+
+    // Properties that have a member in layout go to blockData; the rest are
+    // collected in loose (if given)
+    void WriteBlock(const UniformBlockLayout& layout, uint8_t* blockData,
+                    std::vector<const MaterialProperty*>* loose) const;
+
+    // Upload one property through its pre-hashed uniform handle
+
+    void UploadPropertyValue(Shader& shader, const MaterialProperty& prop) const;
+
+    // Look up the variant for m_shader + m_keywords
+    void ResolveVariant();
+
 private:
     std::string m_name;
     std::shared_ptr<Shader> m_shader;
+    std::shared_ptr<Shader> m_variant;   // m_shader compiled with m_keywords
+    ShaderKeywords m_keywords = 0;
 
     // Material properties (uniform values)
-    std::unordered_map<std::string, MaterialProperty> m_properties;
+    MaterialPropertyMap m_properties;
 
     // Render state
     RenderQueue m_renderQueue = RenderQueue::Geometry;
@@ -202,8 +278,20 @@ private:
     // Tags for organization
     std::vector<std::string> m_tags;
 
+    // Compiled MaterialData block (rebuilt lazily on bind)
+    mutable std::vector<uint8_t> m_blockData;
+    mutable std::vector<const MaterialProperty*> m_looseProperties;
+    mutable UniformBuffer m_blockBuffer;
+    mutable const Shader* m_blockShader = nullptr;
+    mutable uint32_t m_blockShaderVersion = 0;
+    mutable bool m_blockDirty = true;
+    uint32_t m_version = 0;
+
+    uint32_t m_sortId = s_nextSortId.fetch_add(1, std::memory_order_relaxed);
+
     // Instance counter for auto-naming
     static int s_instanceCounter;
+    static std::atomic<uint32_t> s_nextSortId;
 };
 
 // ============================================================================
@@ -36,15 +36,25 @@ MaterialPtr MaterialLibrary::Create(const std::string& name, const std::string&
 }
 
 MaterialPtr MaterialLibrary::Create(const std::string& name, std::shared_ptr<Shader> shader) {
+    MaterialPtr material;
+    bool existed = false;
+    {
+        // Check and insert under one lock so concurrent creators agree
+        std::unique_lock<std::shared_mutex> lock(m_mutex);
+        auto [it, inserted] = m_materials.try_emplace(name);
+        if (inserted) {
+            it->second = std::make_shared<Material>(name, shader);
+        }
+        material = it->second;
+        existed = !inserted;
+    }
+
     // Check if material already exists
-    if (Exists(name)) {
+    if (existed) {
         LOG_WARNING("MaterialLibrary", "Material '" + name + "' already exists, returning existing");
-        return Get(name);
+        return material;
     }
 
-    auto material = std::make_shared<Material>(name, shader);
-    m_materials[name] = material;
-
     LOG_INFO("MaterialLibrary", "Created material '" + name + "'");
     return material;
 }
@@ -62,35 +72,12 @@ MaterialPtr MaterialLibrary::CreateFromTemplate(const std::string& name, const s
         return nullptr;
     }
 
-    // Apply template settings
-    material->SetRenderQueue(tmpl->renderQueue);
-    material->SetBlendMode(tmpl->blendMode);
-    material->SetCullMode(tmpl->cullMode);
-
-    // Apply default properties
-    for (const auto& [propName, propValue] : tmpl->defaultProperties) {
-        std::visit([&material, &propName](auto&& arg) {
-            using T = std::decay_t<decltype(arg)>;
-            if constexpr (std::is_same_v<T, int>) {
-                material->SetInt(propName, arg);
-            } else if constexpr (std::is_same_v<T, float>) {
-                material->SetFloat(propName, arg);
-            } else if constexpr (std::is_same_v<T, Vec2>) {
-                material->SetVec2(propName, arg);
-            } else if constexpr (std::is_same_v<T, Vec3>) {
-                material->SetVec3(propName, arg);
-            } else if constexpr (std::is_same_v<T, Vec4>) {
-                material->SetVec4(propName, arg);
-            } else if constexpr (std::is_same_v<T, TextureSlot>) {
-                material->SetTextureSlot(propName, arg);
-            }
-        }, propValue);
-    }
-
+    ApplyTemplate(*material, *tmpl);
     return material;
 }
 
 MaterialPtr MaterialLibrary::Get(const std::string& name) const {
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
     auto it = m_materials.find(name);
     if (it != m_materials.end()) {
         return it->second;
@@ -99,23 +86,32 @@ MaterialPtr MaterialLibrary::Get(const std::string& name) const {
 }
 
 bool MaterialLibrary::Exists(const std::string& name) const {
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
     return m_materials.find(name) != m_materials.end();
 }
 
 void MaterialLibrary::Remove(const std::string& name) {
-    auto it = m_materials.find(name);
-    if (it != m_materials.end()) {
-        m_materials.erase(it);
+    size_t removed = 0;
+    {
+        std::unique_lock<std::shared_mutex> lock(m_mutex);
+        removed = m_materials.erase(name);
+    }
+    if (removed > 0) {
         LOG_INFO("MaterialLibrary", "Removed material '" + name + "'");
     }
 }
 
 void MaterialLibrary::Clear() {
-    m_materials.clear();
+    {
+        std::unique_lock<std::shared_mutex> lock(m_mutex);
+        m_materials.clear();
+        m_interned.clear();
+    }
     LOG_INFO("MaterialLibrary", "Cleared all materials");
 }
 
 std::vector<std::string> MaterialLibrary::GetMaterialNames() const {
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
     std::vector<std::string> names;
     names.reserve(m_materials.size());
     for (const auto& [name, mat] : m_materials) {
@@ -125,6 +121,7 @@ std::vector<std::string> MaterialLibrary::GetMaterialNames() const {
 }
 
 std::vector<MaterialPtr> MaterialLibrary::GetMaterialsByTag(const std::string& tag) const {
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
     std::vector<MaterialPtr> result;
     for (const auto& [name, mat] : m_materials) {
         if (mat->HasTag(tag)) {
@@ -135,6 +132,7 @@ std::vector<MaterialPtr> MaterialLibrary::GetMaterialsByTag(const std::string& t
 }
 
 std::vector<MaterialPtr> MaterialLibrary::GetMaterialsByShader(const std::string& shaderName) const {
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
     std::vector<MaterialPtr> result;
     for (const auto& [name, mat] : m_materials) {
         auto shader = mat->GetShader();
@@ -145,6 +143,60 @@ std::vector<MaterialPtr> MaterialLibrary::GetMaterialsByShader(const std::string
     return result;
 }
 
+// ============================================================================
+// Interning
+// ============================================================================
+
+MaterialPtr MaterialLibrary::Intern(const std::string& name, const MaterialPtr& material) {
+    if (!material) return nullptr;
+
+    uint64_t hash = material->ComputeContentHash();
+    MaterialPtr shared;
+    bool existed = false;
+    {
+        std::unique_lock<std::shared_mutex> lock(m_mutex);
+        auto [named, inserted] = m_materials.try_emplace(name);
+        if (!inserted) {
+            shared = named->second;
+            existed = true;
+        } else {
+            // Entries of materials that are gone or changed since drop out
+            auto [first, last] = m_interned.equal_range(hash);
+            for (auto it = first; it != last && !shared;) {
+                MaterialPtr candidate = it->second.material.lock();
+                if (!candidate || candidate->GetVersion() != it->second.version) {
+                    it = m_interned.erase(it);
+                } else if (candidate == material || candidate->HasSameContent(*material)) {
+                    shared = std::move(candidate);
+                } else {
+                    ++it;
+                }
+            }
+            if (shared && shared != material) {
+                m_internHits++;
+            } else if (!shared) {
+                m_interned.emplace(hash, InternEntry{material, material->GetVersion()});
+                shared = material;
+            }
+            named->second = shared;
+        }
+    }
+
+    if (existed) {
+        LOG_WARNING("MaterialLibrary", "Material '" + name + "' already exists, returning existing");
+    } else if (shared != material) {
+        LOG_DEBUG("MaterialLibrary", "Material '" + name + "' shares '" + shared->GetName() + "'");
+    } else {
+        LOG_INFO("MaterialLibrary", "Created material '" + name + "'");
+    }
+    return shared;
+}
+
+size_t MaterialLibrary::GetInternHits() const {
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+    return m_internHits;
+}
+
 // ============================================================================
 // Template Management
 // ============================================================================
@@ -219,11 +271,57 @@ void MaterialLibrary::RegisterBuiltInTemplates() {
 // Quick Creation Helpers
 // ============================================================================
 
+MaterialPtr MaterialLibrary::BuildFromTemplate(const std::string& name, const std::string& templateName) const {
+    const MaterialTemplate* tmpl = GetTemplate(templateName);
+    if (!tmpl) {
+        LOG_ERROR("MaterialLibrary", "Template '" + templateName + "' not found");
+        return nullptr;
+    }
+
+    auto shader = ShaderLibrary::Instance().Get(tmpl->shaderName);
+    if (!shader) {
+        LOG_ERROR("MaterialLibrary", "Shader '" + tmpl->shaderName + "' not found for material '" + name + "'");
+        return nullptr;
+    }
+
+    auto material = std::make_shared<Material>(name, shader);
+    ApplyTemplate(*material, *tmpl);
+    return material;
+}
+
+void MaterialLibrary::ApplyTemplate(Material& material, const MaterialTemplate& tmpl) {
+    // Apply template settings
+    material.SetRenderQueue(tmpl.renderQueue);
+    material.SetBlendMode(tmpl.blendMode);
+    material.SetCullMode(tmpl.cullMode);
+
+    // Apply default properties
+    for (const auto& [propName, propValue] : tmpl.defaultProperties) {
+        std::visit([&material, &propName](auto&& arg) {
+            using T = std::decay_t<decltype(arg)>;
+            if constexpr (std::is_same_v<T, int>) {
+                material.SetInt(propName, arg);
+            } else if constexpr (std::is_same_v<T, float>) {
+                material.SetFloat(propName, arg);
+            } else if constexpr (std::is_same_v<T, Vec2>) {
+                material.SetVec2(propName, arg);
+            } else if constexpr (std::is_same_v<T, Vec3>) {
+                material.SetVec3(propName, arg);
+            } else if constexpr (std::is_same_v<T, Vec4>) {
+                material.SetVec4(propName, arg);
+            } else if constexpr (std::is_same_v<T, TextureSlot>) {
+                material.SetTextureSlot(propName, arg);
+            }
+        }, propValue);
+    }
+}
+
 MaterialPtr MaterialLibrary::CreateSolidColor(const std::string& name, const Vec3& color) {
     auto material = CreateFromTemplate(name, "LitOpaque");
-    if (material) {
-        material->SetColor(color);
+    if (!material) {
+        return nullptr;
     }
+    material->SetColor(color);
     return material;
 }
 
@@ -233,32 +331,44 @@ MaterialPtr MaterialLibrary::CreateSolidColor(const std::string& name, float r,
 
 MaterialPtr MaterialLibrary::CreateUnlit(const std::string& name, const Vec3& color) {
     auto material = CreateFromTemplate(name, "Unlit");
-    if (material) {
-        material->SetColor(color);
+    if (!material) {
+        return nullptr;
     }
+    material->SetColor(color);
     return material;
 }
 
 MaterialPtr MaterialLibrary::CreateTransparent(const std::string& name, const Vec4& color) {
     auto material = CreateFromTemplate(name, "Transparent");
-    if (material) {
-        material->SetColor(color);
-        material->SetDepthWrite(false);  // Common for transparent objects
+    if (!material) {
+        return nullptr;
     }
+    material->SetColor(color);
+    material->SetDepthWrite(false);  // Common for transparent objects
     return material;
 }
 
 MaterialPtr MaterialLibrary::CreateEmissive(const std::string& name, const Vec3& color,
                                              const Vec3& emission, float intensity) {
     auto material = CreateFromTemplate(name, "LitOpaque");
-    if (material) {
-        material->SetColor(color);
-        material->SetEmission(emission);
-        material->SetEmissionIntensity(intensity);
+    if (!material) {
+        return nullptr;
     }
+    material->SetColor(color);
+    material->SetEmission(emission);
+    material->SetEmissionIntensity(intensity);
     return material;
 }
 
+MaterialPtr MaterialLibrary::InternSolidColor(const std::string& name, const Vec3& color) {
+    auto material = BuildFromTemplate(name, "LitOpaque");
+    if (!material) {
+        return nullptr;
+    }
+    material->SetColor(color);
+    return Intern(name, material);
+}
+
 // ============================================================================
 // Batch Operations
 // ============================================================================
@@ -268,7 +378,13 @@ void MaterialLibrary::ReloadShaders() {
 }
 
 void MaterialLibrary::ForEach(const std::function<void(const std::string&, MaterialPtr)>& callback) const {
-    for (const auto& [name, mat] : m_materials) {
+    // Iterate a snapshot so the callback may create or remove materials
+    std::vector<std::pair<std::string, MaterialPtr>> snapshot;
+    {
+        std::shared_lock<std::shared_mutex> lock(m_mutex);
+        snapshot.assign(m_materials.begin(), m_materials.end());
+    }
+    for (const auto& [name, mat] : snapshot) {
         callback(name, mat);
     }
 }
@@ -278,8 +394,10 @@ void MaterialLibrary::ForEach(const std::function<void(const std::string&, Mater
 // ============================================================================
 
 void MaterialLibrary::PrintDebugInfo() const {
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
     std::cout << "=== MaterialLibrary Debug Info ===" << std::endl;
-    std::cout << "Materials: " << m_materials.size() << std::endl;
+    std::cout << "Materials: " << m_materials.size() << " (" << m_internHits << " names share an interned one)"
+              << std::endl;
 
     for (const auto& [name, mat] : m_materials) {
         std::cout << "  - " << name;
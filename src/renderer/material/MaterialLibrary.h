@@ -6,6 +6,8 @@
 #include <memory>
 #include <vector>
 #include <functional>
+#include <mutex>
+#include <shared_mutex>
 
 namespace Genesis {
 
@@ -26,6 +28,10 @@ struct MaterialTemplate {
 //
 // Follows the Source engine pattern where materials are loaded from files
 // or created programmatically, cached by name, and can be looked up quickly.
+//
+// The material table is guarded by a reader/writer lock, so Get()/Exists()
+// may be called from worker threads (e.g. parallel map builds). Configuring
+// a material after creation is not synchronized; do that on one thread.
 // ============================================================================
 class MaterialLibrary {
 public:
@@ -66,6 +72,26 @@ public:
     // Get materials by shader
     std::vector<MaterialPtr> GetMaterialsByShader(const std::string& shaderName) const;
 
+    // ========================================================================
+    // Interning
+    //
+    // Materials with the same content (Material::HasSameContent) draw alike,
+    // and one shared instance keeps them in one render batch. Intern()
+    // registers material under name, unless an identical one is already
+    // interned: then name becomes another name for that one, which is
+    // returned. InternSolidColor() interns; Create(), CreateFromTemplate()
+    // and the quick creation helpers always make a material of their own.
+    //
+    // Changing an interned material changes it for every name resolving to
+    // it. One changed since it was interned no longer matches its entry and
+    // is passed over by later calls.
+    // ========================================================================
+
+    MaterialPtr Intern(const std::string& name, const MaterialPtr& material);
+
+    // Intern() calls that resolved to an existing material
+    size_t GetInternHits() const;
+
     // ========================================================================
     // Template Management
     // ========================================================================
@@ -100,6 +126,11 @@ public:
     MaterialPtr CreateEmissive(const std::string& name, const Vec3& color,
                                 const Vec3& emission, float intensity = 1.0f);
 
+    // Solid color material through Intern(): the result may be shared with
+    // other names, so it must not be modified (use CreateSolidColor() for
+    // one to customize)
+    MaterialPtr InternSolidColor(const std::string& name, const Vec3& color);
+
     // ========================================================================
     // Batch Operations
     // ========================================================================
@@ -133,8 +164,20 @@ private:
     MaterialLibrary(const MaterialLibrary&) = delete;
     MaterialLibrary& operator=(const MaterialLibrary&) = delete;
 
+    // An unregistered material set up from a template (for Intern)
+    MaterialPtr BuildFromTemplate(const std::string& name, const std::string& templateName) const;
+    static void ApplyTemplate(Material& material, const MaterialTemplate& tmpl);
+
+    struct InternEntry {
+        std::weak_ptr<Material> material;
+        uint32_t version = 0;           // Material::GetVersion() when interned
+    };
+
 private:
     std::unordered_map<std::string, MaterialPtr> m_materials;
+    std::unordered_multimap<uint64_t, InternEntry> m_interned;   // By content hash
+    size_t m_internHits = 0;
+    mutable std::shared_mutex m_mutex;
     std::unordered_map<std::string, MaterialTemplate> m_templates;
     std::string m_basePath = "assets/materials/";
 };
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "math/Math.h"
+#include "renderer/shader/UniformHandle.h"
 #include <string>
 #include <variant>
 #include <unordered_map>
@@ -62,24 +63,29 @@ struct MaterialProperty {
     MaterialPropertyType type = MaterialPropertyType::None;
     MaterialPropertyValue value;
 
+    // Hashed name, so binding doesn't hash strings
+    UniformHandle handle;
+    UniformHandle tilingHandle;  // name + "_ST" (textures only)
+
     // Constructors for convenience
     MaterialProperty() = default;
     MaterialProperty(const std::string& n, int v)
-        : name(n), type(MaterialPropertyType::Int), value(v) {}
+        : name(n), type(MaterialPropertyType::Int), value(v), handle(n) {}
     MaterialProperty(const std::string& n, float v)
-        : name(n), type(MaterialPropertyType::Float), value(v) {}
+        : name(n), type(MaterialPropertyType::Float), value(v), handle(n) {}
     MaterialProperty(const std::string& n, const Vec2& v)
-        : name(n), type(MaterialPropertyType::Vec2), value(v) {}
+        : name(n), type(MaterialPropertyType::Vec2), value(v), handle(n) {}
     MaterialProperty(const std::string& n, const Vec3& v)
-        : name(n), type(MaterialPropertyType::Vec3), value(v) {}
+        : name(n), type(MaterialPropertyType::Vec3), value(v), handle(n) {}
     MaterialProperty(const std::string& n, const Vec4& v)
-        : name(n), type(MaterialPropertyType::Vec4), value(v) {}
+        : name(n), type(MaterialPropertyType::Vec4), value(v), handle(n) {}
     MaterialProperty(const std::string& n, const Mat3& v)
-        : name(n), type(MaterialPropertyType::Mat3), value(v) {}
+        : name(n), type(MaterialPropertyType::Mat3), value(v), handle(n) {}
     MaterialProperty(const std::string& n, const Mat4& v)
-        : name(n), type(MaterialPropertyType::Mat4), value(v) {}
+        : name(n), type(MaterialPropertyType::Mat4), value(v), handle(n) {}
     MaterialProperty(const std::string& n, const TextureSlot& v)
-        : name(n), type(MaterialPropertyType::Texture2D), value(v) {}
+        : name(n), type(MaterialPropertyType::Texture2D), value(v)
+        , handle(n), tilingHandle(n + "_ST") {}
 };
 
 // ============================================================================
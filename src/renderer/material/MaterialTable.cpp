@@ -0,0 +1,304 @@
+#include "MaterialTable.h"
+#include "renderer/GLState.h"
+#include "renderer/texture/Texture.h"
+#include "renderer/texture/TextureStreamer.h"
+#include <glad/glad.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+namespace Genesis {
+
+bool MaterialTable::IsBindlessSupported() {
+    return GLAD_GL_ARB_bindless_texture != 0;
+}
+
+MaterialTable::MaterialTable(bool bindless)
+    : m_bindless(bindless && IsBindlessSupported()) {
+}
+
+// ============================================================================
+// Slots
+// ============================================================================
+
+bool MaterialTable::Accepts(const Material& material) const {
+    if (!material.GetBaseShader()) return false;
+
+    if (!m_entries.empty()) {
+        const Material& first = *m_entries[0].material;
+        if (m_entries.size() >= MAX_MATERIALS ||
+            material.GetBaseShader() != first.GetBaseShader() ||
+            material.GetKeywords() != first.GetKeywords() ||
+            material.GetRenderQueue() != first.GetRenderQueue() ||
+            material.GetBlendMode() != first.GetBlendMode() ||
+            material.GetCullMode() != first.GetCullMode() ||
+            material.GetDepthWrite() != first.GetDepthWrite() ||
+            material.GetDepthTest() != first.GetDepthTest()) {
+            return false;
+        }
+    }
+    if (m_bindless) return true;
+
+    for (const auto& [name, prop] : material.GetProperties()) {
+        if (prop.type != MaterialPropertyType::Texture2D) continue;
+        const TextureSlot& slot = std::get<TextureSlot>(prop.value);
+        if (!slot.texture) continue;
+        if (slot.texture->IsArray()) return false;
+
+        const TextureArray* array = FindArray(name);
+        if (array && !FitsArray(*array, *slot.texture)) return false;
+    }
+    return true;
+}
+
+uint32_t MaterialTable::Add(MaterialPtr material) {
+    uint32_t slot = static_cast<uint32_t>(m_entries.size());
+    if (!m_bindless) {
+        AddToArrays(*material);
+    }
+
+    Entry entry;
+    entry.material = std::move(material);
+    m_entries.push_back(std::move(entry));
+    return slot;
+}
+
+// ============================================================================
+// Texture Arrays
+// ============================================================================
+
+MaterialTable::TextureArray* MaterialTable::FindArray(const std::string& name) {
+    for (auto& array : m_arrays) {
+        if (array.name == name) return &array;
+    }
+    return nullptr;
+}
+
+const MaterialTable::TextureArray* MaterialTable::FindArray(const std::string& name) const {
+    for (const auto& array : m_arrays) {
+        if (array.name == name) return &array;
+    }
+    return nullptr;
+}
+
+bool MaterialTable::FitsArray(const TextureArray& array, const Texture2D& texture) const {
+    if (texture.GetFormat() != array.format || texture.GetWidth() != array.width ||
+        texture.GetHeight() != array.height || texture.GetLevelCount() != array.levels) {
+        return false;
+    }
+    return array.paths.size() < MAX_MATERIALS ||
+           std::find(array.paths.begin(), array.paths.end(), texture.GetPath()) != array.paths.end();
+}
+
+bool MaterialTable::AddToArrays(const Material& material) {
+    bool fits = true;
+    for (const auto& [name, prop] : material.GetProperties()) {
+        if (prop.type != MaterialPropertyType::Texture2D) continue;
+        const TextureSlot& slot = std::get<TextureSlot>(prop.value);
+        if (!slot.texture || slot.texture->IsArray()) continue;
+        const Texture2D& texture = *slot.texture;
+
+        TextureArray* array = FindArray(name);
+        if (!array) {
+            m_arrays.emplace_back();
+            array = &m_arrays.back();
+            array->name = name;
+            array->sampler = UniformHandle(name + "_Array");
+            array->unit = slot.unit;
+            array->format = texture.GetFormat();
+            array->width = texture.GetWidth();
+            array->height = texture.GetHeight();
+            array->levels = texture.GetLevelCount();
+        }
+        if (!FitsArray(*array, texture)) {
+            std::cerr << "[MaterialTable] " << material.GetName() << ": " << texture.GetPath()
+                      << " doesn't match the other " << name << " layers" << std::endl;
+            fits = false;
+            continue;
+        }
+        if (std::find(array->paths.begin(), array->paths.end(), texture.GetPath()) == array->paths.end()) {
+            array->paths.push_back(texture.GetPath());
+            array->dirty = true;
+        }
+    }
+    return fits;
+}
+
+// ============================================================================
+// Packing
+// ============================================================================
+
+void MaterialTable::MarkDirty(size_t begin, size_t end) {
+    if (m_dirtyEnd <= m_dirtyBegin) {
+        m_dirtyBegin = begin;
+        m_dirtyEnd = end;
+        return;
+    }
+    m_dirtyBegin = std::min(m_dirtyBegin, begin);
+    m_dirtyEnd = std::max(m_dirtyEnd, end);
+}
+
+void MaterialTable::PackEntry(uint32_t slot, const UniformBlockLayout& layout) {
+    Entry& entry = m_entries[slot];
+    const Material& material = *entry.material;
+
+    size_t base = layout.entryOffset + static_cast<size_t>(slot) * layout.entryStride;
+    uint8_t* dst = m_data.data() + base;
+    std::memset(dst, 0, layout.entryStride);
+    material.PackBlockData(layout, dst);
+
+    // Texture references are rebuilt from the current properties
+    m_handles.erase(std::remove_if(m_handles.begin(), m_handles.end(),
+                                   [slot](const HandleRef& ref) { return ref.slot == slot; }),
+                    m_handles.end());
+    if (!m_bindless) {
+        AddToArrays(material);   // A new texture needs a layer
+    }
+
+    for (const auto& [name, prop] : material.GetProperties()) {
+        if (prop.type != MaterialPropertyType::Texture2D) continue;
+        const TextureSlot& textureSlot = std::get<TextureSlot>(prop.value);
+        if (!textureSlot.texture) continue;
+
+        if (m_bindless) {
+            // Written by the handle refresh in Bind()
+            const UniformBlockMember* member = layout.Find(UniformHandle(name + "_Handle"));
+            if (!member) continue;
+            HandleRef ref;
+            ref.slot = slot;
+            ref.offset = static_cast<uint32_t>(base + member->offset);
+            ref.texture = textureSlot.texture;
+            m_handles.push_back(std::move(ref));
+            continue;
+        }
+
+        const UniformBlockMember* member = layout.Find(UniformHandle(name + "_Layer"));
+        const TextureArray* array = FindArray(name);
+        if (!member || !array) continue;
+        auto it = std::find(array->paths.begin(), array->paths.end(), textureSlot.texture->GetPath());
+        if (it == array->paths.end()) continue;   // Didn't fit: layer 0
+
+        int layer = static_cast<int>(it - array->paths.begin());
+        if (member->type == UniformType::Float) {
+            float value = static_cast<float>(layer);
+            std::memcpy(dst + member->offset, &value, sizeof(float));
+        } else {
+            std::memcpy(dst + member->offset, &layer, sizeof(int));
+        }
+    }
+
+    entry.version = material.GetVersion();
+    entry.packed = true;
+    MarkDirty(base, base + layout.entryStride);
+}
+
+// ============================================================================
+// Binding
+// ============================================================================
+
+bool MaterialTable::Bind() {
+    if (m_entries.empty()) return false;
+
+    if (!m_variant) {
+        const Material& first = *m_entries[0].material;
+        auto& library = ShaderLibrary::Instance();
+        ShaderKeywords keywords = first.GetKeywords() | library.GetKeyword("MATERIAL_TABLE");
+        if (m_bindless) {
+            keywords |= library.GetKeyword("BINDLESS_TEXTURES");
+        }
+        m_variant = library.GetVariant(first.GetBaseShader(), keywords);
+    }
+    if (!m_variant || !m_variant->IsValid() || m_variant->IsUsingFallback()) {
+        return false;
+    }
+
+    const UniformBlockLayout* layout = m_variant->GetMaterialBlock();
+    if (!layout || !layout->IsTable() || layout->GetEntryCount() < m_entries.size()) {
+        if (!m_warned) {
+            std::cerr << "[MaterialTable] " << m_variant->GetName() << ": MATERIAL_TABLE variant has no "
+                      << Shader::MATERIAL_TABLE_ARRAY << "[] table for " << m_entries.size() << " materials"
+                      << std::endl;
+            m_warned = true;
+        }
+        return false;
+    }
+
+    // First bind or a relink: every offset may have moved
+    if (m_layoutShader != m_variant.get() || m_layoutVersion != m_variant->GetLinkVersion()) {
+        m_data.assign(layout->size, 0);
+        if (m_buffer.GetSize() != layout->size) {
+            m_buffer.Create(layout->size);
+        }
+        for (Entry& entry : m_entries) entry.packed = false;
+        m_handles.clear();
+        m_layoutShader = m_variant.get();
+        m_layoutVersion = m_variant->GetLinkVersion();
+        MarkDirty(0, m_data.size());
+    }
+
+    for (uint32_t slot = 0; slot < m_entries.size(); slot++) {
+        const Entry& entry = m_entries[slot];
+        if (!entry.packed || entry.version != entry.material->GetVersion()) {
+            PackEntry(slot, *layout);
+        }
+    }
+
+    for (TextureArray& array : m_arrays) {
+        if (array.dirty) {
+            // The old layer set is dropped, not left resident in the streamer
+            auto& streamer = TextureStreamer::Instance();
+            streamer.Unload(array.texture);
+            array.texture = streamer.LoadArray(array.paths);
+            array.dirty = false;
+        }
+    }
+
+    // A streamed texture's handle changes with its storage
+    for (HandleRef& ref : m_handles) {
+        uint64_t handle = ref.texture->GetBindlessHandle();
+        if (handle != ref.handle) {
+            ref.handle = handle;
+            std::memcpy(m_data.data() + ref.offset, &handle, sizeof(handle));
+            MarkDirty(ref.offset, ref.offset + sizeof(handle));
+        }
+    }
+
+    if (m_dirtyEnd > m_dirtyBegin) {
+        m_buffer.Update(m_data.data() + m_dirtyBegin, m_dirtyEnd - m_dirtyBegin, m_dirtyBegin);
+        m_dirtyBegin = m_dirtyEnd = 0;
+    }
+
+    m_variant->Bind();
+    m_entries[0].material->ApplyRenderState();
+    m_buffer.BindRange(UniformBinding::Material, 0, layout->size);
+
+    auto& gl = GLStateCache::Instance();
+    for (const TextureArray& array : m_arrays) {
+        if (array.texture && array.texture->IsValid()) {
+            gl.BindTexture(static_cast<uint32_t>(array.unit), GL_TEXTURE_2D_ARRAY, array.texture->GetHandle());
+        }
+        m_variant->SetSampler(array.sampler, array.unit);
+    }
+    return true;
+}
+
+void MaterialTable::RequestTextureScreenSize(uint32_t slot, float screenFraction) const {
+    const Material& material = *m_entries[slot].material;
+    if (m_bindless) {
+        material.RequestTextureScreenSize(screenFraction);
+        return;
+    }
+
+    for (const auto& [name, prop] : material.GetProperties()) {
+        if (prop.type != MaterialPropertyType::Texture2D) continue;
+        const TextureSlot& textureSlot = std::get<TextureSlot>(prop.value);
+        const TextureArray* array = FindArray(name);
+        if (!array || !array->texture) continue;
+
+        float repeats = std::max(1.0f, std::max(std::abs(textureSlot.tiling.x), std::abs(textureSlot.tiling.y)));
+        array->texture->RequestScreenSize(screenFraction / repeats);
+    }
+}
+
+} // namespace Genesis
@@ -0,0 +1,134 @@
+#pragma once
+
+#include "Material.h"
+#include "renderer/shader/UniformBuffer.h"
+#include "renderer/texture/TextureFile.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Genesis {
+
+// ============================================================================
+// MaterialTable - Many materials of one shader behind a single bind
+//
+// Materials that share a base shader, keywords and render state get one
+// slot each. The shader's MATERIAL_TABLE variant declares MaterialData as
+// an array of entries and reads the entry of the vertex's material slot
+// (Mesh::SetMaterialSlots), so one (multi-)draw covers all of them:
+//
+//   struct MaterialEntry { vec3 u_Color; ... };
+//   layout (std140) uniform MaterialData {
+//       MaterialEntry u_Materials[MATERIAL_TABLE_SIZE];   // = MAX_MATERIALS
+//   };
+//
+// Each entry is packed like a material's own block and repacked when that
+// material changes. Texture properties can't be bound per material, so
+// their entry holds a reference instead:
+//   - Bindless (ARB_bindless_texture, BINDLESS_TEXTURES keyword): uvec2
+//     "<name>_Handle" is the streamed texture's resident handle, refreshed
+//     when the streamer reallocates it. GLSL wants the handle dynamically
+//     uniform, so a draw must not span two materials' ranges.
+//   - Texture arrays otherwise: each property's textures become one
+//     streamed GL_TEXTURE_2D_ARRAY (TextureStreamer::LoadArray) bound to
+//     sampler2DArray "<name>_Array" at the property's unit, and int/float
+//     "<name>_Layer" picks the layer. They must share format, size and mip
+//     count; Accepts() turns away a material whose textures don't.
+// ============================================================================
+class MaterialTable {
+public:
+    // MATERIAL_TABLE_SIZE in the shaders
+    static constexpr uint32_t MAX_MATERIALS = 256;
+
+    static bool IsBindlessSupported();
+
+    explicit MaterialTable(bool bindless);
+
+    // Non-copyable (owns a uniform buffer)
+    MaterialTable(const MaterialTable&) = delete;
+    MaterialTable& operator=(const MaterialTable&) = delete;
+
+    // True if the material can take a slot: same shader, keywords and
+    // render state as the first one, room left, and (texture arrays)
+    // textures that fit the arrays
+    bool Accepts(const Material& material) const;
+
+    // Give the material a slot (call Accepts first)
+    uint32_t Add(MaterialPtr material);
+
+    // Bind the variant, render state, table and texture arrays, repacking
+    // what changed. The first call starts compiling the variant in the
+    // background; false until it has linked, or if the shader has no table
+    // block (draw the materials one by one then).
+    bool Bind();
+
+    // The variant Bind() bound
+    Shader* GetShader() const { return m_variant.get(); }
+
+    // Streaming request for the textures of one slot (see
+    // Material::RequestTextureScreenSize); with arrays the whole array
+    void RequestTextureScreenSize(uint32_t slot, float screenFraction) const;
+
+    bool IsBindless() const { return m_bindless; }
+    size_t GetMaterialCount() const { return m_entries.size(); }
+    const MaterialPtr& GetMaterial(uint32_t slot) const { return m_entries[slot].material; }
+
+private:
+    struct Entry {
+        MaterialPtr material;
+        uint32_t version = 0;
+        bool packed = false;
+    };
+
+    // One texture property packed into a GL_TEXTURE_2D_ARRAY
+    struct TextureArray {
+        std::string name;
+        UniformHandle sampler;          // "<name>_Array"
+        int unit = 0;
+        TextureFormat format = TextureFormat::Unknown;
+        uint32_t width = 0;
+        uint32_t height = 0;
+        uint32_t levels = 0;
+        std::vector<std::string> paths; // Layer order
+        std::shared_ptr<Texture2D> texture;
+        bool dirty = true;              // paths changed since LoadArray
+    };
+
+    // A bindless handle in m_data, rewritten when the texture's changes
+    struct HandleRef {
+        uint32_t slot = 0;
+        uint32_t offset = 0;            // In m_data
+        std::shared_ptr<Texture2D> texture;
+        uint64_t handle = 0;
+    };
+
+    TextureArray* FindArray(const std::string& name);
+    const TextureArray* FindArray(const std::string& name) const;
+    bool FitsArray(const TextureArray& array, const Texture2D& texture) const;
+
+    // Register the material's textures with the arrays; false if one doesn't fit
+    bool AddToArrays(const Material& material);
+
+    void PackEntry(uint32_t slot, const UniformBlockLayout& layout);
+    void MarkDirty(size_t begin, size_t end);
+
+    bool m_bindless = false;
+    std::vector<Entry> m_entries;
+    std::vector<TextureArray> m_arrays;
+    std::vector<HandleRef> m_handles;
+
+    std::shared_ptr<Shader> m_variant;
+    const Shader* m_layoutShader = nullptr;
+    uint32_t m_layoutVersion = 0;
+    bool m_warned = false;
+
+    // CPU copy of the table; [m_dirtyBegin, m_dirtyEnd) still to upload
+    std::vector<uint8_t> m_data;
+    size_t m_dirtyBegin = 0;
+    size_t m_dirtyEnd = 0;
+    UniformBuffer m_buffer;
+};
+
+using MaterialTablePtr = std::shared_ptr<MaterialTable>;
+
+} // namespace Genesis
@@ -1,11 +1,19 @@
 #include "Mesh.h"
+#include "renderer/GLState.h"
+#include "core/Hash.h"
 #include <glad/glad.h>
+#include <atomic>
 #include <cstring>
 #include <limits>
 #include <iostream>
 
 namespace Genesis {
 
+// Upload() drops the CPU copies (SetReleaseCPUData), except inside a
+// KeepCPUDataScope on the uploading thread
+static std::atomic<bool> g_releaseCPUData{false};
+static thread_local int g_keepCPUDataScopes = 0;
+
 // ============================================================================
 // Constructor / Destructor
 // ============================================================================
@@ -28,18 +36,30 @@ Mesh::Mesh(Mesh&& other) noexcept
     , m_drawMode(other.m_drawMode)
     , m_vertexData(std::move(other.m_vertexData))
     , m_indexData(std::move(other.m_indexData))
+    , m_materialSlots(std::move(other.m_materialSlots))
+    , m_lightmapUVs(std::move(other.m_lightmapUVs))
     , m_vertexCount(other.m_vertexCount)
     , m_indexCount(other.m_indexCount)
     , m_indexType(other.m_indexType)
     , m_vao(other.m_vao)
     , m_vbo(other.m_vbo)
     , m_ebo(other.m_ebo)
+    , m_slotVBO(other.m_slotVBO)
+    , m_lightmapVBO(other.m_lightmapVBO)
+    , m_vertexBytes(other.m_vertexBytes)
+    , m_gpuBytes(other.m_gpuBytes)
+    , m_keepCPUData(other.m_keepCPUData)
     , m_boundsMin(other.m_boundsMin)
     , m_boundsMax(other.m_boundsMax)
+    , m_lods(std::move(other.m_lods))
 {
     other.m_vao = 0;
     other.m_vbo = 0;
     other.m_ebo = 0;
+    other.m_slotVBO = 0;
+    other.m_lightmapVBO = 0;
+    other.m_vertexBytes = 0;
+    other.m_gpuBytes = 0;
     other.m_vertexCount = 0;
     other.m_indexCount = 0;
 }
@@ -53,18 +73,30 @@ Mesh& Mesh::operator=(Mesh&& other) noexcept {
         m_drawMode = other.m_drawMode;
         m_vertexData = std::move(other.m_vertexData);
         m_indexData = std::move(other.m_indexData);
+        m_materialSlots = std::move(other.m_materialSlots);
+        m_lightmapUVs = std::move(other.m_lightmapUVs);
         m_vertexCount = other.m_vertexCount;
         m_indexCount = other.m_indexCount;
         m_indexType = other.m_indexType;
         m_vao = other.m_vao;
         m_vbo = other.m_vbo;
         m_ebo = other.m_ebo;
+        m_slotVBO = other.m_slotVBO;
+        m_lightmapVBO = other.m_lightmapVBO;
+        m_vertexBytes = other.m_vertexBytes;
+        m_gpuBytes = other.m_gpuBytes;
+        m_keepCPUData = other.m_keepCPUData;
         m_boundsMin = other.m_boundsMin;
         m_boundsMax = other.m_boundsMax;
+        m_lods = std::move(other.m_lods);
 
         other.m_vao = 0;
         other.m_vbo = 0;
         other.m_ebo = 0;
+        other.m_slotVBO = 0;
+        other.m_lightmapVBO = 0;
+        other.m_vertexBytes = 0;
+        other.m_gpuBytes = 0;
         other.m_vertexCount = 0;
         other.m_indexCount = 0;
     }
@@ -117,30 +149,63 @@ bool Mesh::Upload() {
     // Release any existing resources
     Release();
 
+    auto& gl = GLStateCache::Instance();
+
     // Create VAO
     glGenVertexArrays(1, &m_vao);
-    glBindVertexArray(m_vao);
+    gl.BindVertexArray(m_vao);
 
     // Create VBO
     glGenBuffers(1, &m_vbo);
     glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
     glBufferData(GL_ARRAY_BUFFER, m_vertexData.size(), m_vertexData.data(), GL_STATIC_DRAW);
+    m_vertexBytes = m_vertexData.size();
+    m_gpuBytes = m_vertexBytes;
 
     // Setup vertex attributes
     SetupVertexAttributes();
 
+    if (!m_materialSlots.empty()) {
+        if (m_materialSlots.size() != m_vertexCount) {
+            std::cerr << "[Mesh] '" << m_name << "': material slot count doesn't match the vertex count" << std::endl;
+        }
+        glGenBuffers(1, &m_slotVBO);
+        glBindBuffer(GL_ARRAY_BUFFER, m_slotVBO);
+        glBufferData(GL_ARRAY_BUFFER, m_materialSlots.size() * sizeof(uint16_t), m_materialSlots.data(), GL_STATIC_DRAW);
+        m_gpuBytes += m_materialSlots.size() * sizeof(uint16_t);
+        glEnableVertexAttribArray(MATERIAL_SLOT_ATTRIB_LOCATION);
+        glVertexAttribIPointer(MATERIAL_SLOT_ATTRIB_LOCATION, 1, GL_UNSIGNED_SHORT, sizeof(uint16_t), nullptr);
+    }
+
+    if (!m_lightmapUVs.empty()) {
+        if (m_lightmapUVs.size() != m_vertexCount) {
+            std::cerr << "[Mesh] '" << m_name << "': lightmap UV count doesn't match the vertex count" << std::endl;
+        }
+        glGenBuffers(1, &m_lightmapVBO);
+        glBindBuffer(GL_ARRAY_BUFFER, m_lightmapVBO);
+        glBufferData(GL_ARRAY_BUFFER, m_lightmapUVs.size() * sizeof(Vec3), m_lightmapUVs.data(), GL_STATIC_DRAW);
+        m_gpuBytes += m_lightmapUVs.size() * sizeof(Vec3);
+        glEnableVertexAttribArray(LIGHTMAP_UV_ATTRIB_LOCATION);
+        glVertexAttribPointer(LIGHTMAP_UV_ATTRIB_LOCATION, 3, GL_FLOAT, GL_FALSE, sizeof(Vec3), nullptr);
+    }
+
     // Create EBO if we have indices
     if (!m_indexData.empty()) {
         glGenBuffers(1, &m_ebo);
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ebo);
         glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_indexData.size(), m_indexData.data(), GL_STATIC_DRAW);
+        m_gpuBytes += m_indexData.size();
     }
 
     // Unbind
-    glBindVertexArray(0);
+    gl.BindVertexArray(0);
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     // Note: Don't unbind EBO while VAO is bound, it's part of VAO state
 
+    MemoryTracker::Instance().AddGpu(MemoryTag::Meshes, m_gpuBytes);
+    if (g_releaseCPUData.load(std::memory_order_relaxed) && !m_keepCPUData && g_keepCPUDataScopes == 0) {
+        ReleaseCPUData();
+    }
     return true;
 }
 
@@ -150,11 +215,16 @@ bool Mesh::UpdateVertexData(const void* data, size_t sizeBytes) {
         return false;
     }
 
-    // Update CPU-side data
-    if (sizeBytes != m_vertexData.size()) {
-        m_vertexData.resize(sizeBytes);
+    // Update CPU-side data (unless released; the buffer can't grow then)
+    if (HasCPUData()) {
+        if (sizeBytes != m_vertexData.size()) {
+            m_vertexData.resize(sizeBytes);
+        }
+        std::memcpy(m_vertexData.data(), data, sizeBytes);
+    } else if (sizeBytes > m_vertexBytes) {
+        std::cerr << "[Mesh] Cannot grow vertex data of '" << m_name << "' without a CPU copy" << std::endl;
+        return false;
     }
-    std::memcpy(m_vertexData.data(), data, sizeBytes);
 
     // Update GPU buffer
     glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
@@ -164,20 +234,41 @@ bool Mesh::UpdateVertexData(const void* data, size_t sizeBytes) {
     return true;
 }
 
+bool Mesh::UpdateVertexRange(size_t byteOffset, const void* data, size_t sizeBytes) {
+    if (m_vbo == 0 || byteOffset + sizeBytes > m_vertexBytes) {
+        std::cerr << "[Mesh] Cannot update vertex range of '" << m_name << "'" << std::endl;
+        return false;
+    }
+
+    if (HasCPUData()) {
+        std::memcpy(m_vertexData.data() + byteOffset, data, sizeBytes);
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+    glBufferSubData(GL_ARRAY_BUFFER, byteOffset, sizeBytes, data);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    return true;
+}
+
 bool Mesh::UpdateIndexData(const std::vector<uint16_t>& indices) {
     if (m_ebo == 0) {
         std::cerr << "[Mesh] Cannot update index data: no EBO" << std::endl;
         return false;
     }
 
-    m_indexData.resize(indices.size() * sizeof(uint16_t));
-    std::memcpy(m_indexData.data(), indices.data(), m_indexData.size());
+    if (HasCPUData()) {
+        m_indexData.resize(indices.size() * sizeof(uint16_t));
+        std::memcpy(m_indexData.data(), indices.data(), m_indexData.size());
+    }
     m_indexCount = static_cast<uint32_t>(indices.size());
     m_indexType = IndexType::UInt16;
 
+    // The EBO binding is VAO state, so go through our own VAO rather than
+    // disturbing whichever one the cache left bound
+    GLStateCache::Instance().BindVertexArray(m_vao);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ebo);
-    glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, m_indexData.size(), m_indexData.data());
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, indices.size() * sizeof(uint16_t), indices.data());
 
     return true;
 }
@@ -188,14 +279,18 @@ bool Mesh::UpdateIndexData(const std::vector<uint32_t>& indices) {
         return false;
     }
 
-    m_indexData.resize(indices.size() * sizeof(uint32_t));
-    std::memcpy(m_indexData.data(), indices.data(), m_indexData.size());
+    if (HasCPUData()) {
+        m_indexData.resize(indices.size() * sizeof(uint32_t));
+        std::memcpy(m_indexData.data(), indices.data(), m_indexData.size());
+    }
     m_indexCount = static_cast<uint32_t>(indices.size());
     m_indexType = IndexType::UInt32;
 
+    // The EBO binding is VAO state, so go through our own VAO rather than
+    // disturbing whichever one the cache left bound
+    GLStateCache::Instance().BindVertexArray(m_vao);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ebo);
-    glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, m_indexData.size(), m_indexData.data());
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, indices.size() * sizeof(uint32_t), indices.data());
 
     return true;
 }
@@ -203,6 +298,7 @@ bool Mesh::UpdateIndexData(const std::vector<uint32_t>& indices) {
 void Mesh::Release() {
     if (m_vao != 0) {
         glDeleteVertexArrays(1, &m_vao);
+        GLStateCache::Instance().OnVertexArrayDeleted(m_vao);
         m_vao = 0;
     }
     if (m_vbo != 0) {
@@ -213,6 +309,86 @@ void Mesh::Release() {
         glDeleteBuffers(1, &m_ebo);
         m_ebo = 0;
     }
+    if (m_slotVBO != 0) {
+        glDeleteBuffers(1, &m_slotVBO);
+        m_slotVBO = 0;
+    }
+    if (m_lightmapVBO != 0) {
+        glDeleteBuffers(1, &m_lightmapVBO);
+        m_lightmapVBO = 0;
+    }
+    MemoryTracker::Instance().RemoveGpu(MemoryTag::Meshes, m_gpuBytes);
+    m_gpuBytes = 0;
+    m_vertexBytes = 0;
+}
+
+// ============================================================================
+// CPU Copies
+// ============================================================================
+
+void Mesh::SetReleaseCPUData(bool enabled) {
+    g_releaseCPUData.store(enabled, std::memory_order_relaxed);
+}
+
+bool Mesh::IsReleasingCPUData() {
+    return g_releaseCPUData.load(std::memory_order_relaxed);
+}
+
+void Mesh::ReleaseCPUData() {
+    MeshData().swap(m_vertexData);
+    MeshData().swap(m_indexData);
+    std::vector<uint16_t>().swap(m_materialSlots);
+    std::vector<Vec3>().swap(m_lightmapUVs);
+}
+
+Mesh::KeepCPUDataScope::KeepCPUDataScope() {
+    g_keepCPUDataScopes++;
+}
+
+Mesh::KeepCPUDataScope::~KeepCPUDataScope() {
+    g_keepCPUDataScopes--;
+}
+
+// ============================================================================
+// Content
+// ============================================================================
+
+uint64_t Mesh::ComputeContentHash() const {
+    uint64_t hash = FNV_OFFSET;
+    hash = HashValue(hash, m_layout.GetStride());
+    for (const VertexAttribute& attribute : m_layout.GetAttributes()) {
+        hash = HashValue(hash, attribute.type);
+        hash = HashValue(hash, attribute.offset);
+        hash = HashValue(hash, attribute.normalized);
+    }
+    hash = HashValue(hash, m_drawMode);
+    hash = HashValue(hash, m_indexType);
+    hash = HashBytes(hash, m_vertexData.data(), m_vertexData.size());
+    hash = HashBytes(hash, m_indexData.data(), m_indexData.size());
+    hash = HashBytes(hash, m_materialSlots.data(), m_materialSlots.size() * sizeof(uint16_t));
+    return HashBytes(hash, m_lightmapUVs.data(), m_lightmapUVs.size() * sizeof(Vec3));
+}
+
+bool Mesh::HasSameContent(const Mesh& other) const {
+    if (!HasCPUData() || !other.HasCPUData() || HasLODs() || other.HasLODs()) return false;
+
+    const auto& attributes = m_layout.GetAttributes();
+    const auto& otherAttributes = other.m_layout.GetAttributes();
+    if (m_layout.GetStride() != other.m_layout.GetStride() || attributes.size() != otherAttributes.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < attributes.size(); i++) {
+        if (attributes[i].type != otherAttributes[i].type || attributes[i].offset != otherAttributes[i].offset ||
+            attributes[i].normalized != otherAttributes[i].normalized) {
+            return false;
+        }
+    }
+
+    return m_drawMode == other.m_drawMode && m_indexType == other.m_indexType &&
+           m_vertexCount == other.m_vertexCount && m_indexCount == other.m_indexCount &&
+           m_boundsMin == other.m_boundsMin && m_boundsMax == other.m_boundsMax &&
+           m_vertexData == other.m_vertexData && m_indexData == other.m_indexData &&
+           m_materialSlots == other.m_materialSlots && m_lightmapUVs == other.m_lightmapUVs;
 }
 
 // ============================================================================
@@ -221,12 +397,12 @@ void Mesh::Release() {
 
 void Mesh::Bind() const {
     if (m_vao != 0) {
-        glBindVertexArray(m_vao);
+        GLStateCache::Instance().BindVertexArray(m_vao);
     }
 }
 
 void Mesh::Unbind() const {
-    glBindVertexArray(0);
+    GLStateCache::Instance().BindVertexArray(0);
 }
 
 void Mesh::Draw() const {
@@ -235,21 +411,42 @@ void Mesh::Draw() const {
         return;
     }
 
-    glBindVertexArray(m_vao);
+    GLStateCache::Instance().BindVertexArray(m_vao);
 
     if (HasIndices()) {
         glDrawElements(GetGLDrawMode(), m_indexCount, GetGLIndexType(), nullptr);
     } else {
         glDrawArrays(GetGLDrawMode(), 0, m_vertexCount);
     }
-
-    glBindVertexArray(0);
 }
 
 void Mesh::DrawInstanced(uint32_t instanceCount) const {
     if (m_vao == 0) return;
 
-    glBindVertexArray(m_vao);
+    GLStateCache::Instance().BindVertexArray(m_vao);
+
+    if (HasIndices()) {
+        glDrawElementsInstanced(GetGLDrawMode(), m_indexCount, GetGLIndexType(), nullptr, instanceCount);
+    } else {
+        glDrawArraysInstanced(GetGLDrawMode(), 0, m_vertexCount, instanceCount);
+    }
+}
+
+void Mesh::DrawInstanced(uint32_t instanceCount, uint32_t instanceBuffer, size_t byteOffset) const {
+    if (m_vao == 0 || instanceCount == 0) return;
+
+    GLStateCache::Instance().BindVertexArray(m_vao);
+
+    // Point the instance attributes at this draw's slice of the buffer.
+    // A mat4 attribute takes four consecutive vec4 locations.
+    glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+    for (GLuint col = 0; col < 4; ++col) {
+        GLuint location = INSTANCE_ATTRIB_LOCATION + col;
+        glEnableVertexAttribArray(location);
+        glVertexAttribPointer(location, 4, GL_FLOAT, GL_FALSE, sizeof(Mat4),
+            reinterpret_cast<void*>(byteOffset + col * sizeof(Vec4)));
+        glVertexAttribDivisor(location, 1);
+    }
 
     if (HasIndices()) {
         glDrawElementsInstanced(GetGLDrawMode(), m_indexCount, GetGLIndexType(), nullptr, instanceCount);
@@ -257,13 +454,16 @@ void Mesh::DrawInstanced(uint32_t instanceCount) const {
         glDrawArraysInstanced(GetGLDrawMode(), 0, m_vertexCount, instanceCount);
     }
 
-    glBindVertexArray(0);
+    // Leave the VAO as a plain mesh again for non-instanced draws
+    for (GLuint col = 0; col < 4; ++col) {
+        glDisableVertexAttribArray(INSTANCE_ATTRIB_LOCATION + col);
+    }
 }
 
 void Mesh::DrawRange(uint32_t startIndex, uint32_t count) const {
     if (m_vao == 0) return;
 
-    glBindVertexArray(m_vao);
+    GLStateCache::Instance().BindVertexArray(m_vao);
 
     if (HasIndices()) {
         size_t offset = startIndex * (m_indexType == IndexType::UInt16 ? 2 : 4);
@@ -271,8 +471,43 @@ void Mesh::DrawRange(uint32_t startIndex, uint32_t count) const {
     } else {
         glDrawArrays(GetGLDrawMode(), startIndex, count);
     }
+}
+
+void Mesh::DrawRanges(const uint32_t* startIndices, const uint32_t* counts, uint32_t rangeCount) const {
+    if (m_vao == 0 || rangeCount == 0) return;
+
+    GLStateCache::Instance().BindVertexArray(m_vao);
 
-    glBindVertexArray(0);
+    // GL wants GLsizei counts and byte offsets; reused across calls
+    // (render thread only)
+    static std::vector<GLsizei> glCounts;
+    static std::vector<const void*> glOffsets;
+    static std::vector<GLint> glFirsts;
+    glCounts.assign(counts, counts + rangeCount);
+
+    if (HasIndices()) {
+        size_t indexSize = m_indexType == IndexType::UInt16 ? 2 : 4;
+        glOffsets.resize(rangeCount);
+        for (uint32_t i = 0; i < rangeCount; i++) {
+            glOffsets[i] = reinterpret_cast<const void*>(static_cast<uintptr_t>(startIndices[i] * indexSize));
+        }
+        glMultiDrawElements(GetGLDrawMode(), glCounts.data(), GetGLIndexType(), glOffsets.data(),
+                            static_cast<GLsizei>(rangeCount));
+    } else {
+        glFirsts.assign(startIndices, startIndices + rangeCount);
+        glMultiDrawArrays(GetGLDrawMode(), glFirsts.data(), glCounts.data(), static_cast<GLsizei>(rangeCount));
+    }
+}
+
+void Mesh::DrawIndirect(uint32_t indirectBuffer, size_t byteOffset, uint32_t drawCount) const {
+    if (m_vao == 0 || drawCount == 0 || !HasIndices()) return;
+
+    GLStateCache::Instance().BindVertexArray(m_vao);
+
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBuffer);
+    glMultiDrawElementsIndirect(GetGLDrawMode(), GetGLIndexType(), reinterpret_cast<const void*>(byteOffset),
+                                static_cast<GLsizei>(drawCount), 0);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
 }
 
 // ============================================================================
@@ -304,6 +539,23 @@ void Mesh::CalculateBoundingBox() {
     }
 }
 
+// ============================================================================
+// Level of Detail
+// ============================================================================
+
+void Mesh::AddLOD(MeshPtr mesh, float maxScreenSize) {
+    if (!mesh || mesh.get() == this) return;
+    m_lods.push_back({std::move(mesh), maxScreenSize});
+}
+
+uint32_t Mesh::SelectLOD(float screenSize) const {
+    uint32_t level = 0;
+    while (level < m_lods.size() && screenSize < m_lods[level].maxScreenSize) {
+        level++;
+    }
+    return level;
+}
+
 // ============================================================================
 // Private Helpers
 // ============================================================================
@@ -335,7 +587,7 @@ void Mesh::SetupVertexAttributes() {
                 static_cast<GLuint>(i),
                 attrib.GetComponentCount(),
                 attrib.GetGLType(),
-                attrib.normalized || attrib.type == VertexAttribType::UByte4Norm ? GL_TRUE : GL_FALSE,
+                attrib.IsNormalized() ? GL_TRUE : GL_FALSE,
                 stride,
                 reinterpret_cast<void*>(static_cast<uintptr_t>(attrib.offset))
             );
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "VertexLayout.h"
+#include "core/MemoryTracker.h"
 #include "math/Math.h"
 #include <vector>
 #include <memory>
@@ -33,12 +34,21 @@ enum class IndexType {
     UInt32      // 32-bit indices (up to 4 billion vertices)
 };
 
+class Mesh;
+using MeshPtr = std::shared_ptr<Mesh>;
+
+// CPU-side vertex/index bytes, charged to MemoryTag::Meshes
+using MeshData = TaggedVector<uint8_t, MemoryTag::Meshes>;
+
 // ============================================================================
 // Mesh - Engine-grade mesh abstraction
 //
 // Owns vertex data, index data, and GPU resources (VAO/VBO/EBO).
 // Provides a simple interface for the game to use meshes without
 // touching OpenGL directly.
+//
+// The CPU copies stay after Upload() unless SetReleaseCPUData(true) is in
+// effect (see there). GPU buffer bytes are charged to MemoryTag::Meshes.
 // ============================================================================
 class Mesh {
 public:
@@ -77,6 +87,19 @@ public:
     // Set draw mode
     void SetDrawMode(DrawMode mode) { m_drawMode = mode; }
 
+    // Per-vertex material slot (one per vertex, uploaded by Upload() as a
+    // uint attribute at MATERIAL_SLOT_ATTRIB_LOCATION); lets one draw cover
+    // several materials of a MaterialTable. Empty = no slot stream.
+    void SetMaterialSlots(std::vector<uint16_t> slots) { m_materialSlots = std::move(slots); }
+    bool HasMaterialSlots() const { return !m_materialSlots.empty(); }
+
+    // Per-vertex lightmap coordinate (u, v, layer + 1), uploaded by Upload()
+    // at LIGHTMAP_UV_ATTRIB_LOCATION. z = 0 marks a vertex without a chart;
+    // meshes without the stream read (0, 0, 0) too. See MapLightmap.
+    void SetLightmapUVs(std::vector<Vec3> uvs) { m_lightmapUVs = std::move(uvs); }
+    bool HasLightmapUVs() const { return !m_lightmapUVs.empty(); }
+    const std::vector<Vec3>& GetLightmapUVs() const { return m_lightmapUVs; }
+
     // ========================================================================
     // GPU Upload
     // ========================================================================
@@ -92,6 +115,9 @@ public:
         return UpdateVertexData(vertices.data(), vertices.size() * sizeof(T));
     }
 
+    // Overwrite part of the vertex data in place (must fit the current size)
+    bool UpdateVertexRange(size_t byteOffset, const void* data, size_t sizeBytes);
+
     // Re-upload index data
     bool UpdateIndexData(const std::vector<uint16_t>& indices);
     bool UpdateIndexData(const std::vector<uint32_t>& indices);
@@ -99,6 +125,49 @@ public:
     // Release GPU resources
     void Release();
 
+    // ========================================================================
+    // CPU Copies
+    //
+    // With SetReleaseCPUData(true), Upload() frees the vertex, index,
+    // material slot and lightmap UV copies once they are on the GPU, unless
+    // the mesh was marked SetKeepCPUData(true) or was uploaded inside a
+    // KeepCPUDataScope. A mesh without copies still draws and updates
+    // (UpdateVertexRange and friends write the GPU buffer only), but can't
+    // be merged, rasterized as an occluder, lightmapped or re-uploaded.
+    // ========================================================================
+
+    static void SetReleaseCPUData(bool enabled);
+    static bool IsReleasingCPUData();
+
+    void SetKeepCPUData(bool keep) { m_keepCPUData = keep; }
+    bool GetKeepCPUData() const { return m_keepCPUData; }
+
+    // Free the copies now, whatever the policy
+    void ReleaseCPUData();
+    bool HasCPUData() const { return !m_vertexData.empty(); }
+
+    // Meshes uploaded on this thread while one is alive keep their copies
+    // (shared shapes that others are built and merged from)
+    class KeepCPUDataScope {
+    public:
+        KeepCPUDataScope();
+        ~KeepCPUDataScope();
+        KeepCPUDataScope(const KeepCPUDataScope&) = delete;
+        KeepCPUDataScope& operator=(const KeepCPUDataScope&) = delete;
+    };
+
+    // Bytes of the GL buffers (0 before Upload)
+    size_t GetGpuBytes() const { return m_gpuBytes; }
+
+    // Hash of what Upload() sends: layout, draw mode, vertex and index
+    // bytes, material slots and lightmap UVs (MeshLibrary::Intern). Needs
+    // the CPU copies; LODs are not part of it
+    uint64_t ComputeContentHash() const;
+
+    // Same layout, draw mode, data and bounds, both with CPU copies and
+    // without LODs
+    bool HasSameContent(const Mesh& other) const;
+
     // ========================================================================
     // Drawing
     // ========================================================================
@@ -115,9 +184,30 @@ public:
     // Draw with instance count
     void DrawInstanced(uint32_t instanceCount) const;
 
+    // Draw with per-instance model matrices read from instanceBuffer at
+    // byteOffset (mat4 at INSTANCE_ATTRIB_LOCATION..+3, divisor 1)
+    void DrawInstanced(uint32_t instanceCount, uint32_t instanceBuffer, size_t byteOffset) const;
+
+    // First attribute location used for the per-instance mat4. Kept above
+    // every VertexLayout preset so it never collides with mesh attributes.
+    static constexpr uint32_t INSTANCE_ATTRIB_LOCATION = 8;
+
+    // Location of the material slot stream (after the instance mat4)
+    static constexpr uint32_t MATERIAL_SLOT_ATTRIB_LOCATION = 12;
+
+    // Location of the lightmap coordinate stream
+    static constexpr uint32_t LIGHTMAP_UV_ATTRIB_LOCATION = 13;
+
     // Draw a subset
     void DrawRange(uint32_t startIndex, uint32_t count) const;
 
+    // Draw several subsets in one call (glMultiDrawElements / glMultiDrawArrays)
+    void DrawRanges(const uint32_t* startIndices, const uint32_t* counts, uint32_t rangeCount) const;
+
+    // drawCount DrawElementsIndirectCommands read from indirectBuffer at
+    // byteOffset (glMultiDrawElementsIndirect, GL 4.3; indexed meshes only)
+    void DrawIndirect(uint32_t indirectBuffer, size_t byteOffset, uint32_t drawCount) const;
+
     // ========================================================================
     // Getters
     // ========================================================================
@@ -131,8 +221,9 @@ public:
     bool IsUploaded() const { return m_vao != 0; }
     bool HasIndices() const { return m_indexType != IndexType::None && m_indexCount > 0; }
 
-    // Get raw vertex data (CPU side)
-    const std::vector<uint8_t>& GetVertexData() const { return m_vertexData; }
+    // Get raw vertex/index data (CPU side; empty once released)
+    const MeshData& GetVertexData() const { return m_vertexData; }
+    const MeshData& GetIndexData() const { return m_indexData; }
 
     // OpenGL handles (for advanced usage)
     uint32_t GetVAO() const { return m_vao; }
@@ -151,6 +242,25 @@ public:
     Vec3 GetBoundsCenter() const { return (m_boundsMin + m_boundsMax) * 0.5f; }
     Vec3 GetBoundsExtents() const { return (m_boundsMax - m_boundsMin) * 0.5f; }
 
+    // ========================================================================
+    // Level of Detail
+    //
+    // Level 0 is this mesh. Each added level is a coarser mesh drawn once
+    // the object's projected size falls below maxScreenSize (bounding sphere
+    // diameter as a fraction of the screen height). Add levels coarsest
+    // last, with decreasing thresholds.
+    // ========================================================================
+
+    void AddLOD(MeshPtr mesh, float maxScreenSize);
+    void ClearLODs() { m_lods.clear(); }
+
+    bool HasLODs() const { return !m_lods.empty(); }
+    uint32_t GetLODCount() const { return static_cast<uint32_t>(m_lods.size()) + 1; }
+
+    // Level for a projected size (0 when no coarser level applies)
+    uint32_t SelectLOD(float screenSize) const;
+    const Mesh& GetLOD(uint32_t level) const { return level == 0 ? *this : *m_lods[level - 1].mesh; }
+
 private:
     void SetupVertexAttributes();
     GLenum GetGLDrawMode() const;
@@ -162,8 +272,10 @@ private:
     DrawMode m_drawMode = DrawMode::Triangles;
 
     // CPU-side data
-    std::vector<uint8_t> m_vertexData;
-    std::vector<uint8_t> m_indexData;  // Can be uint16 or uint32
+    MeshData m_vertexData;
+    MeshData m_indexData;  // Can be uint16 or uint32
+    std::vector<uint16_t> m_materialSlots;
+    std::vector<Vec3> m_lightmapUVs;
     uint32_t m_vertexCount = 0;
     uint32_t m_indexCount = 0;
     IndexType m_indexType = IndexType::None;
@@ -172,16 +284,22 @@ private:
     uint32_t m_vao = 0;
     uint32_t m_vbo = 0;
     uint32_t m_ebo = 0;
+    uint32_t m_slotVBO = 0;
+    uint32_t m_lightmapVBO = 0;
+    size_t m_vertexBytes = 0;           // Size of m_vbo, for range updates without a CPU copy
+    size_t m_gpuBytes = 0;
+    bool m_keepCPUData = false;
 
     // Bounding volume
     Vec3 m_boundsMin = Vec3(0.0f);
     Vec3 m_boundsMax = Vec3(0.0f);
-};
 
-// ============================================================================
-// Shared Mesh Pointer
-// ============================================================================
-using MeshPtr = std::shared_ptr<Mesh>;
+    struct LODLevel {
+        MeshPtr mesh;
+        float maxScreenSize = 0.0f;
+    };
+    std::vector<LODLevel> m_lods;
+};
 
 } // namespace Genesis
 
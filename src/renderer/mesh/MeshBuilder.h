@@ -2,6 +2,8 @@
 
 #include "Mesh.h"
 #include "VertexLayout.h"
+#include "VertexCompression.h"
+#include "MeshOptimizer.h"
 #include "math/Math.h"
 #include <vector>
 #include <memory>
@@ -142,34 +144,82 @@ public:
         return *this;
     }
 
+    // Quantize attributes on build (VertexCompressionFlags). Shaders need no
+    // changes: the vertex fetch expands the packed formats.
+    MeshBuilder& SetCompression(uint32_t flags) {
+        m_compression = flags;
+        return *this;
+    }
+
+    // Reorder triangles and vertices on build (see MeshOptimizer). Changes
+    // index order only, not the triangles drawn; triangle lists only.
+    MeshBuilder& SetOptimize(bool optimize) {
+        m_optimize = optimize;
+        return *this;
+    }
+
     // Get current vertex count (useful for indexing)
     uint32_t GetVertexCount() const { return static_cast<uint32_t>(m_vertices.size()); }
 
     // Build and upload the mesh
     MeshPtr Build() {
-        auto mesh = std::make_shared<Mesh>(m_name);
-        mesh->SetLayout(VertexType::GetLayout());
-        mesh->SetVertexData(m_vertices);
-
-        if (!m_indices.empty()) {
-            mesh->SetIndexData(m_indices);
-        }
-
-        mesh->SetDrawMode(m_drawMode);
-        mesh->CalculateBoundingBox();
+        MeshPtr mesh = BuildNoUpload();
         mesh->Upload();
-
         return mesh;
     }
 
     // Build without uploading (for manual control)
     MeshPtr BuildNoUpload() {
         auto mesh = std::make_shared<Mesh>(m_name);
-        mesh->SetLayout(VertexType::GetLayout());
-        mesh->SetVertexData(m_vertices);
 
-        if (!m_indices.empty()) {
-            mesh->SetIndexData(m_indices);
+        // Optimize copies so the builder can keep appending afterwards
+        const std::vector<VertexType>* vertices = &m_vertices;
+        const std::vector<uint32_t>* indices = &m_indices;
+        std::vector<VertexType> optimizedVertices;
+        std::vector<uint32_t> optimizedIndices;
+        if (m_optimize && m_drawMode == DrawMode::Triangles && !m_indices.empty()) {
+            uint32_t vertexCount = static_cast<uint32_t>(m_vertices.size());
+            optimizedIndices = m_indices;
+            MeshOptimizer::OptimizeVertexCache(optimizedIndices, vertexCount);
+
+            std::vector<Vec3> positions;
+            positions.reserve(m_vertices.size());
+            for (const VertexType& vertex : m_vertices) {
+                positions.push_back(vertex.position);
+            }
+            MeshOptimizer::OptimizeOverdraw(optimizedIndices, positions);
+
+            std::vector<uint32_t> remap = MeshOptimizer::OptimizeVertexFetch(optimizedIndices, vertexCount);
+            optimizedVertices.resize(m_vertices.size());
+            for (uint32_t v = 0; v < vertexCount; v++) {
+                optimizedVertices[remap[v]] = m_vertices[v];
+            }
+
+            vertices = &optimizedVertices;
+            indices = &optimizedIndices;
+        }
+
+        VertexLayout packedLayout;
+        std::vector<uint8_t> packedData;
+        if (m_compression != VERTEX_COMPRESS_NONE &&
+            VertexCompression::Compress(VertexType::GetLayout(), reinterpret_cast<const uint8_t*>(vertices->data()),
+                                        static_cast<uint32_t>(vertices->size()), m_compression,
+                                        packedLayout, packedData)) {
+            mesh->SetLayout(packedLayout);
+            mesh->SetVertexData(packedData.data(), packedData.size(), vertices->size());
+        } else {
+            mesh->SetLayout(VertexType::GetLayout());
+            mesh->SetVertexData(*vertices);
+        }
+
+        if (!indices->empty()) {
+            // Half the index bandwidth whenever every vertex is addressable
+            if (vertices->size() <= 65536) {
+                std::vector<uint16_t> shortIndices(indices->begin(), indices->end());
+                mesh->SetIndexData(shortIndices);
+            } else {
+                mesh->SetIndexData(*indices);
+            }
         }
 
         mesh->SetDrawMode(m_drawMode);
@@ -189,6 +239,8 @@ private:
     std::vector<VertexType> m_vertices;
     std::vector<uint32_t> m_indices;
     DrawMode m_drawMode = DrawMode::Triangles;
+    uint32_t m_compression = VERTEX_COMPRESS_NONE;
+    bool m_optimize = false;
 };
 
 // ============================================================================
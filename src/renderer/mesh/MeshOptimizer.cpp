@@ -0,0 +1,278 @@
+#include "MeshOptimizer.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Genesis {
+
+namespace {
+
+constexpr uint32_t INVALID_TRIANGLE = 0xFFFFFFFFu;
+
+// Forsyth, "Linear-Speed Vertex Cache Optimisation" (2006)
+constexpr float CACHE_DECAY_POWER = 1.5f;
+constexpr float LAST_TRI_SCORE = 0.75f;
+constexpr float VALENCE_BOOST_SCALE = 2.0f;
+constexpr float VALENCE_BOOST_POWER = 0.5f;
+
+float VertexScore(int32_t cachePosition, uint32_t activeTriangles) {
+    if (activeTriangles == 0) {
+        return -1.0f;   // No triangle needs it any more
+    }
+
+    float score = 0.0f;
+    if (cachePosition >= 0) {
+        if (cachePosition < 3) {
+            // Used by the last triangle: fixed score so the next one doesn't
+            // just reuse the same edge
+            score = LAST_TRI_SCORE;
+        } else {
+            const float scaler = 1.0f / static_cast<float>(MeshOptimizer::CACHE_SIZE - 3);
+            score = std::pow(1.0f - static_cast<float>(cachePosition - 3) * scaler, CACHE_DECAY_POWER);
+        }
+    }
+
+    // Finish off vertices with few triangles left, so they leave the cache
+    score += VALENCE_BOOST_SCALE * std::pow(static_cast<float>(activeTriangles), -VALENCE_BOOST_POWER);
+    return score;
+}
+
+} // namespace
+
+// ============================================================================
+// Vertex Cache
+// ============================================================================
+
+void MeshOptimizer::OptimizeVertexCache(std::vector<uint32_t>& indices, uint32_t vertexCount) {
+    const uint32_t triCount = static_cast<uint32_t>(indices.size() / 3);
+    if (triCount < 2 || vertexCount == 0) return;
+
+    // Vertex -> triangles; the first active[v] entries of each list are the
+    // triangles not emitted yet
+    std::vector<uint32_t> active(vertexCount, 0);
+    for (uint32_t i = 0; i < triCount * 3; i++) {
+        active[indices[i]]++;
+    }
+    std::vector<uint32_t> offsets(vertexCount + 1, 0);
+    for (uint32_t v = 0; v < vertexCount; v++) {
+        offsets[v + 1] = offsets[v] + active[v];
+    }
+    std::vector<uint32_t> adjacency(triCount * 3);
+    {
+        std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+        for (uint32_t i = 0; i < triCount * 3; i++) {
+            adjacency[fill[indices[i]]++] = i / 3;
+        }
+    }
+
+    std::vector<int32_t> cachePosition(vertexCount, -1);
+    std::vector<float> vertexScore(vertexCount);
+    for (uint32_t v = 0; v < vertexCount; v++) {
+        vertexScore[v] = VertexScore(-1, active[v]);
+    }
+
+    std::vector<float> triScore(triCount);
+    std::vector<uint8_t> emitted(triCount, 0);
+    uint32_t best = 0;
+    for (uint32_t t = 0; t < triCount; t++) {
+        triScore[t] = vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]] +
+                      vertexScore[indices[t * 3 + 2]];
+        if (triScore[t] > triScore[best]) best = t;
+    }
+
+    std::vector<uint32_t> cache, nextCache;
+    cache.reserve(CACHE_SIZE + 3);
+    nextCache.reserve(CACHE_SIZE + 3);
+
+    std::vector<uint32_t> output;
+    output.reserve(triCount * 3);
+    uint32_t deadEndCursor = 0;
+
+    for (uint32_t n = 0; n < triCount; n++) {
+        if (best == INVALID_TRIANGLE) {
+            // Nothing in the cache has work left: restart at the next
+            // unemitted triangle in input order
+            while (emitted[deadEndCursor]) deadEndCursor++;
+            best = deadEndCursor;
+        }
+
+        const uint32_t* tri = &indices[best * 3];
+        output.insert(output.end(), tri, tri + 3);
+        emitted[best] = 1;
+
+        // Drop the triangle from its vertices' active lists
+        for (int k = 0; k < 3; k++) {
+            uint32_t v = tri[k];
+            uint32_t* list = &adjacency[offsets[v]];
+            for (uint32_t a = 0; a < active[v]; a++) {
+                if (list[a] == best) {
+                    std::swap(list[a], list[active[v] - 1]);
+                    break;
+                }
+            }
+            active[v]--;
+        }
+
+        // LRU update: the triangle's vertices move to the front
+        nextCache.assign(tri, tri + 3);
+        for (uint32_t v : cache) {
+            if (v != tri[0] && v != tri[1] && v != tri[2]) {
+                nextCache.push_back(v);
+            }
+        }
+
+        for (size_t i = 0; i < nextCache.size(); i++) {
+            uint32_t v = nextCache[i];
+            cachePosition[v] = i < CACHE_SIZE ? static_cast<int32_t>(i) : -1;
+            vertexScore[v] = VertexScore(cachePosition[v], active[v]);
+        }
+
+        // Rescore the triangles those vertices still feed; the best of
+        // them goes next
+        best = INVALID_TRIANGLE;
+        float bestScore = -1.0f;
+        for (uint32_t v : nextCache) {
+            const uint32_t* list = &adjacency[offsets[v]];
+            for (uint32_t a = 0; a < active[v]; a++) {
+                uint32_t t = list[a];
+                triScore[t] = vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]] +
+                              vertexScore[indices[t * 3 + 2]];
+                if (triScore[t] > bestScore) {
+                    bestScore = triScore[t];
+                    best = t;
+                }
+            }
+        }
+
+        if (nextCache.size() > CACHE_SIZE) {
+            nextCache.resize(CACHE_SIZE);
+        }
+        cache.swap(nextCache);
+    }
+
+    indices.swap(output);
+}
+
+// ============================================================================
+// Overdraw
+// ============================================================================
+
+void MeshOptimizer::OptimizeOverdraw(std::vector<uint32_t>& indices, const std::vector<Vec3>& positions,
+                                     uint32_t cacheSize) {
+    const uint32_t triCount = static_cast<uint32_t>(indices.size() / 3);
+    const uint32_t vertexCount = static_cast<uint32_t>(positions.size());
+    if (triCount < 2 || vertexCount == 0) return;
+
+    // Cluster boundaries: a triangle that misses on all three vertices
+    // starts from a cold cache anyway, so reordering there costs no reuse
+    struct Cluster {
+        uint32_t firstTri = 0;
+        uint32_t triCount = 0;
+        float sortKey = 0.0f;
+    };
+    std::vector<Cluster> clusters;
+
+    std::vector<uint32_t> cacheTime(vertexCount, 0);
+    uint32_t time = cacheSize + 1;
+    for (uint32_t t = 0; t < triCount; t++) {
+        int misses = 0;
+        for (int k = 0; k < 3; k++) {
+            uint32_t v = indices[t * 3 + k];
+            if (time - cacheTime[v] > cacheSize) {
+                cacheTime[v] = time++;
+                misses++;
+            }
+        }
+        if (t == 0 || misses == 3) {
+            clusters.push_back({t, 0, 0.0f});
+        }
+        clusters.back().triCount++;
+    }
+    if (clusters.size() < 2) return;
+
+    // Area-weighted centroid and normal, for the mesh and each cluster
+    auto accumulate = [&](uint32_t firstTri, uint32_t count, Vec3& centroid, Vec3& normal) {
+        centroid = Vec3(0.0f);
+        normal = Vec3(0.0f);
+        float area = 0.0f;
+        for (uint32_t t = firstTri; t < firstTri + count; t++) {
+            const Vec3& a = positions[indices[t * 3]];
+            const Vec3& b = positions[indices[t * 3 + 1]];
+            const Vec3& c = positions[indices[t * 3 + 2]];
+            Vec3 cross = glm::cross(b - a, c - a);
+            float triArea = glm::length(cross);
+            centroid += (a + b + c) * (triArea / 3.0f);
+            normal += cross;
+            area += triArea;
+        }
+        if (area > 0.0f) centroid /= area;
+    };
+
+    Vec3 meshCentroid, meshNormal;
+    accumulate(0, triCount, meshCentroid, meshNormal);
+
+    // Clusters facing away from the center draw first: they are the ones
+    // most likely to occlude the rest from any viewpoint
+    for (Cluster& cluster : clusters) {
+        Vec3 centroid, normal;
+        accumulate(cluster.firstTri, cluster.triCount, centroid, normal);
+        float length = glm::length(normal);
+        cluster.sortKey = length > 0.0f ? glm::dot(centroid - meshCentroid, normal / length) : 0.0f;
+    }
+
+    std::stable_sort(clusters.begin(), clusters.end(),
+        [](const Cluster& a, const Cluster& b) { return a.sortKey > b.sortKey; });
+
+    std::vector<uint32_t> output;
+    output.reserve(indices.size());
+    for (const Cluster& cluster : clusters) {
+        auto first = indices.begin() + cluster.firstTri * 3;
+        output.insert(output.end(), first, first + cluster.triCount * 3);
+    }
+    // Keep any trailing partial triangle
+    output.insert(output.end(), indices.begin() + triCount * 3, indices.end());
+    indices.swap(output);
+}
+
+// ============================================================================
+// Vertex Fetch
+// ============================================================================
+
+std::vector<uint32_t> MeshOptimizer::OptimizeVertexFetch(std::vector<uint32_t>& indices, uint32_t vertexCount) {
+    const uint32_t unassigned = 0xFFFFFFFFu;
+    std::vector<uint32_t> remap(vertexCount, unassigned);
+    uint32_t next = 0;
+
+    for (uint32_t& index : indices) {
+        if (remap[index] == unassigned) {
+            remap[index] = next++;
+        }
+        index = remap[index];
+    }
+    for (uint32_t& slot : remap) {
+        if (slot == unassigned) slot = next++;
+    }
+    return remap;
+}
+
+// ============================================================================
+// Statistics
+// ============================================================================
+
+float MeshOptimizer::ComputeACMR(const std::vector<uint32_t>& indices, uint32_t vertexCount, uint32_t cacheSize) {
+    const uint32_t triCount = static_cast<uint32_t>(indices.size() / 3);
+    if (triCount == 0) return 0.0f;
+
+    std::vector<uint32_t> cacheTime(vertexCount, 0);
+    uint32_t time = cacheSize + 1;
+    uint32_t misses = 0;
+    for (uint32_t i = 0; i < triCount * 3; i++) {
+        uint32_t v = indices[i];
+        if (time - cacheTime[v] > cacheSize) {
+            cacheTime[v] = time++;
+            misses++;
+        }
+    }
+    return static_cast<float>(misses) / static_cast<float>(triCount);
+}
+
+} // namespace Genesis
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "math/Math.h"
+#include <vector>
+#include <cstdint>
+
+namespace Genesis {
+
+// ============================================================================
+// MeshOptimizer - Index/vertex reordering for faster rasterization
+//
+// Triangle lists only. The usual order is:
+//   1. OptimizeVertexCache  - Forsyth's linear-speed reordering so the
+//                             post-transform cache re-uses shaded vertices
+//   2. OptimizeOverdraw     - Tipsify-style: keeps the cache order inside
+//                             clusters, sorts clusters so outward-facing
+//                             ones draw first and occlude the rest
+//   3. OptimizeVertexFetch  - renumbers vertices in first-use order so the
+//                             vertex fetch streams through memory
+// MeshBuilder::SetOptimize runs all three.
+// ============================================================================
+class MeshOptimizer {
+public:
+    // LRU cache size the Forsyth scoring models
+    static constexpr uint32_t CACHE_SIZE = 32;
+
+    static void OptimizeVertexCache(std::vector<uint32_t>& indices, uint32_t vertexCount);
+
+    // positions[i] is vertex i. cacheSize is the FIFO cache used to find
+    // cluster boundaries (a triangle missing on all three vertices).
+    static void OptimizeOverdraw(std::vector<uint32_t>& indices, const std::vector<Vec3>& positions,
+                                 uint32_t cacheSize = 16);
+
+    // Rewrites the indices and returns remap[oldVertex] = newVertex.
+    // Unreferenced vertices are moved to the end.
+    static std::vector<uint32_t> OptimizeVertexFetch(std::vector<uint32_t>& indices, uint32_t vertexCount);
+
+    // Average cache misses per triangle for a FIFO cache (0.5 is about ideal
+    // for regular grids, 3 is no reuse)
+    static float ComputeACMR(const std::vector<uint32_t>& indices, uint32_t vertexCount, uint32_t cacheSize = 16);
+};
+
+} // namespace Genesis
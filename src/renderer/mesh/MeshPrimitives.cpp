@@ -21,6 +21,7 @@ MeshPtr MeshPrimitives::CreateBox(float width, float height, float depth, const
     float d = depth * 0.5f;
 
     MeshBuilder<VertexPNT> builder(name);
+    builder.SetCompression(VERTEX_COMPRESS_DEFAULT);
 
     // Front face (+Z)
     uint32_t base = builder.GetVertexCount();
@@ -84,6 +85,7 @@ MeshPtr MeshPrimitives::CreatePlane(float width, float depth, const std::string&
 MeshPtr MeshPrimitives::CreatePlane(float width, float depth, uint32_t subdivX, uint32_t subdivZ,
                                     const std::string& name) {
     MeshBuilder<VertexPNT> builder(name);
+    builder.SetCompression(VERTEX_COMPRESS_DEFAULT).SetOptimize(true);
 
     float halfW = width * 0.5f;
     float halfD = depth * 0.5f;
@@ -131,6 +133,7 @@ MeshPtr MeshPrimitives::CreateSphere(const std::string& name) {
 MeshPtr MeshPrimitives::CreateSphere(float radius, uint32_t rings, uint32_t sectors,
                                      const std::string& name) {
     MeshBuilder<VertexPNT> builder(name);
+    builder.SetCompression(VERTEX_COMPRESS_DEFAULT).SetOptimize(true);
 
     const float PI = 3.14159265358979323846f;
 
@@ -180,6 +183,7 @@ MeshPtr MeshPrimitives::CreateSphere(float radius, uint32_t rings, uint32_t sect
 MeshPtr MeshPrimitives::CreateCylinder(float radius, float height, uint32_t segments,
                                        const std::string& name) {
     MeshBuilder<VertexPNT> builder(name);
+    builder.SetCompression(VERTEX_COMPRESS_DEFAULT).SetOptimize(true);
 
     const float PI = 3.14159265358979323846f;
     float halfHeight = height * 0.5f;
@@ -266,6 +270,7 @@ MeshPtr MeshPrimitives::CreateCylinder(float radius, float height, uint32_t segm
 MeshPtr MeshPrimitives::CreateCone(float radius, float height, uint32_t segments,
                                    const std::string& name) {
     MeshBuilder<VertexPNT> builder(name);
+    builder.SetCompression(VERTEX_COMPRESS_DEFAULT).SetOptimize(true);
 
     const float PI = 3.14159265358979323846f;
     float halfHeight = height * 0.5f;
@@ -342,6 +347,7 @@ MeshPtr MeshPrimitives::CreateTorus(float outerRadius, float innerRadius,
                                     uint32_t rings, uint32_t sides,
                                     const std::string& name) {
     MeshBuilder<VertexPNT> builder(name);
+    builder.SetCompression(VERTEX_COMPRESS_DEFAULT).SetOptimize(true);
 
     const float PI = 3.14159265358979323846f;
     float tubeRadius = (outerRadius - innerRadius) * 0.5f;
@@ -0,0 +1,191 @@
+#include "VertexCompression.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace Genesis {
+
+// ============================================================================
+// Scalar Encodings
+// ============================================================================
+
+uint16_t VertexCompression::FloatToHalf(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+
+    uint32_t sign = (bits >> 16) & 0x8000u;
+    int32_t exponent = static_cast<int32_t>((bits >> 23) & 0xFFu) - 127 + 15;
+    uint32_t mantissa = bits & 0x7FFFFFu;
+
+    if (((bits >> 23) & 0xFFu) == 0xFFu) {
+        // Inf / NaN (keep NaN quiet)
+        return static_cast<uint16_t>(sign | 0x7C00u | (mantissa ? 0x200u : 0u));
+    }
+    if (exponent >= 31) {
+        return static_cast<uint16_t>(sign | 0x7C00u);   // Overflow -> inf
+    }
+    if (exponent <= 0) {
+        // Subnormal half (or zero)
+        if (exponent < -10) return static_cast<uint16_t>(sign);
+        mantissa |= 0x800000u;
+        uint32_t shift = static_cast<uint32_t>(14 - exponent);
+        uint32_t half = mantissa >> shift;
+        uint32_t rest = mantissa & ((1u << shift) - 1);
+        uint32_t halfway = 1u << (shift - 1);
+        if (rest > halfway || (rest == halfway && (half & 1u))) half++;
+        return static_cast<uint16_t>(sign | half);
+    }
+
+    uint32_t half = sign | (static_cast<uint32_t>(exponent) << 10) | (mantissa >> 13);
+    uint32_t rest = mantissa & 0x1FFFu;
+    if (rest > 0x1000u || (rest == 0x1000u && (half & 1u))) {
+        half++;   // May carry into the exponent, which is still correct
+    }
+    return static_cast<uint16_t>(half);
+}
+
+float VertexCompression::HalfToFloat(uint16_t value) {
+    uint32_t sign = static_cast<uint32_t>(value & 0x8000u) << 16;
+    uint32_t exponent = (value >> 10) & 0x1Fu;
+    uint32_t mantissa = value & 0x3FFu;
+
+    uint32_t bits;
+    if (exponent == 0) {
+        if (mantissa == 0) {
+            bits = sign;
+        } else {
+            // Normalize the subnormal
+            exponent = 127 - 15 + 1;
+            while ((mantissa & 0x400u) == 0) {
+                mantissa <<= 1;
+                exponent--;
+            }
+            bits = sign | (exponent << 23) | ((mantissa & 0x3FFu) << 13);
+        }
+    } else if (exponent == 31) {
+        bits = sign | 0x7F800000u | (mantissa << 13);
+    } else {
+        bits = sign | ((exponent + 127 - 15) << 23) | (mantissa << 13);
+    }
+
+    float result;
+    std::memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+uint32_t VertexCompression::PackNormal(const Vec3& normal) {
+    auto pack = [](float v) {
+        int32_t q = static_cast<int32_t>(std::round(std::clamp(v, -1.0f, 1.0f) * 511.0f));
+        return static_cast<uint32_t>(q) & 0x3FFu;
+    };
+    return pack(normal.x) | (pack(normal.y) << 10) | (pack(normal.z) << 20);
+}
+
+Vec3 VertexCompression::UnpackNormal(uint32_t packed) {
+    auto unpack = [packed](int shift) {
+        // Sign-extend the 10-bit field
+        int32_t q = static_cast<int32_t>(packed << (22 - shift)) >> 22;
+        return std::max(static_cast<float>(q) / 511.0f, -1.0f);
+    };
+    return Vec3(unpack(0), unpack(10), unpack(20));
+}
+
+// ============================================================================
+// Layout Conversion
+// ============================================================================
+
+bool VertexCompression::Compress(const VertexLayout& layout, const uint8_t* data, uint32_t vertexCount,
+                                 uint32_t flags, VertexLayout& outLayout, std::vector<uint8_t>& outData) {
+    const auto& attributes = layout.GetAttributes();
+    uint32_t stride = layout.GetStride();
+
+    // Choose the output type of each attribute
+    std::vector<VertexAttribType> types;
+    types.reserve(attributes.size());
+    bool changed = false;
+
+    for (const VertexAttribute& attrib : attributes) {
+        VertexAttribType type = attrib.type;
+
+        bool isDirection = attrib.name == "normal" || attrib.name == "tangent" || attrib.name == "bitangent";
+        if ((flags & VERTEX_COMPRESS_NORMALS) && isDirection && type == VertexAttribType::Float3) {
+            type = VertexAttribType::Int2_10_10_10_Rev;
+        } else if ((flags & VERTEX_COMPRESS_TEXCOORDS) && attrib.name == "texCoord" &&
+                   type == VertexAttribType::Float2) {
+            // Unit range keeps 16-bit fixed point; tiled UVs need halfs
+            bool unitRange = true;
+            for (uint32_t v = 0; v < vertexCount && unitRange; v++) {
+                float uv[2];
+                std::memcpy(uv, data + v * stride + attrib.offset, sizeof(uv));
+                unitRange = uv[0] >= 0.0f && uv[0] <= 1.0f && uv[1] >= 0.0f && uv[1] <= 1.0f;
+            }
+            type = unitRange ? VertexAttribType::UShort2Norm : VertexAttribType::Half2;
+        } else if ((flags & VERTEX_COMPRESS_COLORS) && attrib.name == "color" &&
+                   type == VertexAttribType::Float4) {
+            type = VertexAttribType::Half4;
+        }
+
+        changed |= type != attrib.type;
+        types.push_back(type);
+    }
+
+    if (!changed) {
+        return false;
+    }
+
+    VertexLayout packed;
+    for (size_t i = 0; i < attributes.size(); i++) {
+        packed.Add(attributes[i].name, types[i], attributes[i].normalized);
+    }
+
+    uint32_t packedStride = packed.GetStride();
+    outData.assign(static_cast<size_t>(vertexCount) * packedStride, 0);
+
+    for (uint32_t v = 0; v < vertexCount; v++) {
+        const uint8_t* src = data + static_cast<size_t>(v) * stride;
+        uint8_t* dst = outData.data() + static_cast<size_t>(v) * packedStride;
+
+        for (size_t i = 0; i < attributes.size(); i++) {
+            const VertexAttribute& in = attributes[i];
+            const VertexAttribute& out = packed.GetAttributes()[i];
+            const uint8_t* s = src + in.offset;
+            uint8_t* d = dst + out.offset;
+
+            float values[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+            switch (out.type) {
+                case VertexAttribType::Int2_10_10_10_Rev: {
+                    std::memcpy(values, s, 3 * sizeof(float));
+                    uint32_t word = PackNormal(Vec3(values[0], values[1], values[2]));
+                    std::memcpy(d, &word, sizeof(word));
+                    break;
+                }
+                case VertexAttribType::UShort2Norm: {
+                    std::memcpy(values, s, 2 * sizeof(float));
+                    uint16_t q[2] = {
+                        static_cast<uint16_t>(std::round(values[0] * 65535.0f)),
+                        static_cast<uint16_t>(std::round(values[1] * 65535.0f))
+                    };
+                    std::memcpy(d, q, sizeof(q));
+                    break;
+                }
+                case VertexAttribType::Half2:
+                case VertexAttribType::Half4: {
+                    uint32_t count = out.GetComponentCount();
+                    std::memcpy(values, s, count * sizeof(float));
+                    uint16_t h[4];
+                    for (uint32_t c = 0; c < count; c++) h[c] = FloatToHalf(values[c]);
+                    std::memcpy(d, h, count * sizeof(uint16_t));
+                    break;
+                }
+                default:
+                    std::memcpy(d, s, in.GetSize());
+                    break;
+            }
+        }
+    }
+
+    outLayout = packed;
+    return true;
+}
+
+} // namespace Genesis
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "VertexLayout.h"
+#include "math/Math.h"
+#include <vector>
+#include <cstdint>
+
+namespace Genesis {
+
+// ============================================================================
+// Vertex Compression Flags - Which attributes to quantize
+// ============================================================================
+enum VertexCompressionFlags : uint32_t {
+    VERTEX_COMPRESS_NONE      = 0,
+    VERTEX_COMPRESS_NORMALS   = 1 << 0,  // normal/tangent/bitangent Float3 -> Int2_10_10_10_Rev
+    VERTEX_COMPRESS_TEXCOORDS = 1 << 1,  // texCoord Float2 -> UShort2Norm, or Half2 outside [0,1]
+    VERTEX_COMPRESS_COLORS    = 1 << 2,  // color Float4 -> Half4
+
+    VERTEX_COMPRESS_DEFAULT = VERTEX_COMPRESS_NORMALS | VERTEX_COMPRESS_TEXCOORDS | VERTEX_COMPRESS_COLORS
+};
+
+// ============================================================================
+// VertexCompression - Re-encode vertex data into smaller attribute formats
+//
+// Attributes are recognized by their VertexLayout names ("normal",
+// "texCoord", ...). Positions stay 32-bit floats: world brushes span
+// hundreds of units, where half floats would visibly crack seams.
+// A Position3D/Normal/TexCoord vertex shrinks from 32 to 20 bytes, one
+// with a tangent from 44 to 24.
+// ============================================================================
+class VertexCompression {
+public:
+    // Rewrite 'data' (vertexCount vertices in 'layout') into 'outLayout' /
+    // 'outData'. Returns false when no attribute matched the flags, in which
+    // case the outputs are untouched.
+    static bool Compress(const VertexLayout& layout, const uint8_t* data, uint32_t vertexCount,
+                         uint32_t flags, VertexLayout& outLayout, std::vector<uint8_t>& outData);
+
+    // IEEE 754 binary16, round to nearest even
+    static uint16_t FloatToHalf(float value);
+    static float HalfToFloat(uint16_t value);
+
+    // GL_INT_2_10_10_10_REV, signed normalized xyz (w = 0)
+    static uint32_t PackNormal(const Vec3& normal);
+    static Vec3 UnpackNormal(uint32_t packed);
+};
+
+} // namespace Genesis
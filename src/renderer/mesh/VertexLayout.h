@@ -19,7 +19,14 @@ enum class VertexAttribType {
     Int2,
     Int3,
     Int4,
-    UByte4Norm  // 4 unsigned bytes normalized to 0-1 (for colors)
+    UByte4Norm,         // 4 unsigned bytes normalized to 0-1 (for colors)
+
+    // Compressed formats (see VertexCompression). The vertex fetch expands
+    // them to floats, so shaders keep declaring vec2/vec3/vec4 inputs.
+    Half2,              // 2 half floats
+    Half4,              // 4 half floats
+    Int2_10_10_10_Rev,  // xyz 10-bit signed normalized + 2-bit w (normals, tangents)
+    UShort2Norm         // 2 unsigned shorts normalized to 0-1 (texture coordinates)
 };
 
 // ============================================================================
@@ -46,6 +53,10 @@ struct VertexAttribute {
             case VertexAttribType::Int3:       return 3;
             case VertexAttribType::Int4:       return 4;
             case VertexAttribType::UByte4Norm: return 4;
+            case VertexAttribType::Half2:      return 2;
+            case VertexAttribType::Half4:      return 4;
+            case VertexAttribType::Int2_10_10_10_Rev: return 4;
+            case VertexAttribType::UShort2Norm: return 2;
         }
         return 0;
     }
@@ -62,10 +73,20 @@ struct VertexAttribute {
             case VertexAttribType::Int3:       return 12;
             case VertexAttribType::Int4:       return 16;
             case VertexAttribType::UByte4Norm: return 4;
+            case VertexAttribType::Half2:      return 4;
+            case VertexAttribType::Half4:      return 8;
+            case VertexAttribType::Int2_10_10_10_Rev: return 4;
+            case VertexAttribType::UShort2Norm: return 4;
         }
         return 0;
     }
 
+    // Integer data the vertex fetch maps to [0,1] / [-1,1]
+    bool IsNormalized() const {
+        return normalized || type == VertexAttribType::UByte4Norm ||
+               type == VertexAttribType::Int2_10_10_10_Rev || type == VertexAttribType::UShort2Norm;
+    }
+
     // Get OpenGL type
     GLenum GetGLType() const {
         switch (type) {
@@ -81,6 +102,13 @@ struct VertexAttribute {
                 return GL_INT;
             case VertexAttribType::UByte4Norm:
                 return GL_UNSIGNED_BYTE;
+            case VertexAttribType::Half2:
+            case VertexAttribType::Half4:
+                return GL_HALF_FLOAT;
+            case VertexAttribType::Int2_10_10_10_Rev:
+                return GL_INT_2_10_10_10_REV;
+            case VertexAttribType::UShort2Norm:
+                return GL_UNSIGNED_SHORT;
         }
         return GL_FLOAT;
     }
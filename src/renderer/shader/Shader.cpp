@@ -1,9 +1,25 @@
 #include "Shader.h"
+#include "UniformBuffer.h"
+#include "ShaderCache.h"
+#include "renderer/GLState.h"
+#include "core/Profiler.h"
+#include "core/FileWatcher.h"
+#include "core/StartupProfile.h"
 #include <glad/glad.h>
 #include <glm/gtc/type_ptr.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <fstream>
 #include <sstream>
+#include <utility>
+
+// KHR_parallel_shader_compile (same value as the ARB enum); glad here was
+// generated without it
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
 
 namespace Genesis {
 
@@ -22,11 +38,22 @@ Shader::Shader(Shader&& other) noexcept
     , m_name(std::move(other.m_name))
     , m_vertexPath(std::move(other.m_vertexPath))
     , m_fragmentPath(std::move(other.m_fragmentPath))
+    , m_defines(std::move(other.m_defines))
     , m_vertexModTime(other.m_vertexModTime)
     , m_fragmentModTime(other.m_fragmentModTime)
     , m_uniformCache(std::move(other.m_uniformCache))
+    , m_handleTable(std::move(other.m_handleTable))
+    , m_handleMask(other.m_handleMask)
+    , m_usesFrameUniforms(other.m_usesFrameUniforms)
+    , m_materialBlock(std::move(other.m_materialBlock))
+    , m_linkVersion(other.m_linkVersion)
+    , m_usingFallback(other.m_usingFallback)
+    , m_build(other.m_build)
 {
     other.m_programId = 0;
+    other.m_handleMask = 0;
+    other.m_usingFallback = false;
+    other.m_build = PendingBuild();
 }
 
 Shader& Shader::operator=(Shader&& other) noexcept {
@@ -36,114 +63,138 @@ Shader& Shader::operator=(Shader&& other) noexcept {
         m_name = std::move(other.m_name);
         m_vertexPath = std::move(other.m_vertexPath);
         m_fragmentPath = std::move(other.m_fragmentPath);
+        m_defines = std::move(other.m_defines);
         m_vertexModTime = other.m_vertexModTime;
         m_fragmentModTime = other.m_fragmentModTime;
         m_uniformCache = std::move(other.m_uniformCache);
+        m_handleTable = std::move(other.m_handleTable);
+        m_handleMask = other.m_handleMask;
+        m_usesFrameUniforms = other.m_usesFrameUniforms;
+        m_materialBlock = std::move(other.m_materialBlock);
+        m_linkVersion = other.m_linkVersion;
+        m_usingFallback = other.m_usingFallback;
+        m_build = other.m_build;
         other.m_programId = 0;
+        other.m_handleMask = 0;
+        other.m_usingFallback = false;
+        other.m_build = PendingBuild();
     }
     return *this;
 }
 
-bool Shader::LoadFromFiles(const std::string& vertexPath, const std::string& fragmentPath) {
-    // Store paths for hot reloading
-    m_vertexPath = vertexPath;
-    m_fragmentPath = fragmentPath;
-
-    // Extract name from path
-    std::filesystem::path vp(vertexPath);
-    m_name = vp.stem().string();
+bool Shader::LoadFromFiles(const std::string& vertexPath, const std::string& fragmentPath,
+                           const std::string& defines) {
+    m_defines = defines;
+    std::string vertexSource, fragmentSource;
+    if (!ReadSources(vertexPath, fragmentPath, vertexSource, fragmentSource)) {
+        return false;
+    }
+    return LoadFromSource(vertexSource, fragmentSource, m_name, defines);
+}
 
-    // Read shader sources
-    std::string vertexSource = ReadFile(vertexPath);
-    std::string fragmentSource = ReadFile(fragmentPath);
+bool Shader::LoadFromSource(const std::string& vertexSource, const std::string& fragmentSource,
+                             const std::string& debugName, const std::string& defines) {
+    if (m_name.empty()) {
+        m_name = debugName;
+    }
+    m_defines = defines;
 
-    if (vertexSource.empty()) {
-        std::cerr << "[Shader] Failed to read vertex shader: " << vertexPath << std::endl;
+    // The current program (if any) stays until the new one has linked
+    if (!SubmitBuild(vertexSource, fragmentSource)) {
         return false;
     }
-    if (fragmentSource.empty()) {
-        std::cerr << "[Shader] Failed to read fragment shader: " << fragmentPath << std::endl;
+    return UpdateBuild(true) != ShaderBuildStatus::Failed;
+}
+
+bool Shader::BeginLoadFromFiles(const std::string& vertexPath, const std::string& fragmentPath,
+                                const std::string& defines) {
+    m_defines = defines;
+    std::string vertexSource, fragmentSource;
+    if (!ReadSources(vertexPath, fragmentPath, vertexSource, fragmentSource)) {
         return false;
     }
-
-    // Store modification times
-    m_vertexModTime = GetFileModTime(vertexPath);
-    m_fragmentModTime = GetFileModTime(fragmentPath);
-
-    return LoadFromSource(vertexSource, fragmentSource, m_name);
+    return BeginLoadFromSource(vertexSource, fragmentSource, m_name, defines);
 }
 
-bool Shader::LoadFromSource(const std::string& vertexSource, const std::string& fragmentSource,
-                             const std::string& debugName) {
-    // Cleanup any existing program
-    Cleanup();
-
+bool Shader::BeginLoadFromSource(const std::string& vertexSource, const std::string& fragmentSource,
+                                  const std::string& debugName, const std::string& defines) {
     if (m_name.empty()) {
         m_name = debugName;
     }
+    m_defines = defines;
 
-    // Compile shaders
-    unsigned int vertexShader = CompileShader(GL_VERTEX_SHADER, vertexSource);
-    if (vertexShader == 0) {
+    if (!SubmitBuild(vertexSource, fragmentSource)) {
         return false;
     }
 
-    unsigned int fragmentShader = CompileShader(GL_FRAGMENT_SHADER, fragmentSource);
-    if (fragmentShader == 0) {
-        glDeleteShader(vertexShader);
-        return false;
+    // Nothing to draw with yet: stand in with the library's fallback
+    if (m_programId == 0 && IsBuildPending()) {
+        UseFallback();
     }
+    return true;
+}
 
-    // Link program
-    if (!LinkProgram(vertexShader, fragmentShader)) {
-        glDeleteShader(vertexShader);
-        glDeleteShader(fragmentShader);
+bool Shader::Reload() {
+    if (m_vertexPath.empty() || m_fragmentPath.empty()) {
+        std::cerr << "[Shader] Cannot reload shader '" << m_name << "': no file paths stored" << std::endl;
         return false;
     }
 
-    // Shaders are linked, can delete them
-    glDeleteShader(vertexShader);
-    glDeleteShader(fragmentShader);
-
-    // Cache uniform locations
-    CacheUniforms();
+    std::cout << "[Shader] Reloading shader '" << m_name << "'..." << std::endl;
 
-    std::cout << "[Shader] Loaded shader '" << m_name << "' (ID: " << m_programId
-              << ", Uniforms: " << m_uniformCache.size() << ")" << std::endl;
+    // A failed build leaves the old program in place
+    if (!LoadFromFiles(m_vertexPath, m_fragmentPath, m_defines)) {
+        std::cerr << "[Shader] Failed to reload shader '" << m_name << "', keeping old version" << std::endl;
+        return false;
+    }
 
+    std::cout << "[Shader] Successfully reloaded shader '" << m_name << "'" << std::endl;
     return true;
 }
 
-bool Shader::Reload() {
+bool Shader::BeginReload() {
     if (m_vertexPath.empty() || m_fragmentPath.empty()) {
         std::cerr << "[Shader] Cannot reload shader '" << m_name << "': no file paths stored" << std::endl;
         return false;
     }
 
-    std::cout << "[Shader] Reloading shader '" << m_name << "'..." << std::endl;
+    std::cout << "[Shader] Reloading shader '" << m_name << "' in the background..." << std::endl;
+    return BeginLoadFromFiles(m_vertexPath, m_fragmentPath, m_defines);
+}
 
-    // Store old program ID in case reload fails
-    unsigned int oldProgram = m_programId;
-    auto oldCache = m_uniformCache;
-    m_programId = 0;
-    m_uniformCache.clear();
+ShaderBuildStatus Shader::UpdateBuild(bool wait) {
+    if (m_build.program == 0) return ShaderBuildStatus::None;
 
-    // Try to reload
-    if (!LoadFromFiles(m_vertexPath, m_fragmentPath)) {
-        // Restore old program
-        m_programId = oldProgram;
-        m_uniformCache = oldCache;
-        std::cerr << "[Shader] Failed to reload shader '" << m_name << "', keeping old version" << std::endl;
-        return false;
+    // Querying compile/link status blocks until the driver is done, so ask
+    // for completion first where the driver can tell us
+    if (!wait && ShaderLibrary::Instance().HasParallelCompile()) {
+        int complete = GL_FALSE;
+        glGetProgramiv(m_build.program, GL_COMPLETION_STATUS_KHR, &complete);
+        if (!complete) return ShaderBuildStatus::Pending;
     }
 
-    // Delete old program (new one was created successfully)
-    if (oldProgram != 0) {
-        glDeleteProgram(oldProgram);
+    PendingBuild build = m_build;
+    m_build = PendingBuild();
+
+    bool vertexOk = CheckCompileStatus(build.vertexShader, GL_VERTEX_SHADER);
+    bool fragmentOk = CheckCompileStatus(build.fragmentShader, GL_FRAGMENT_SHADER);
+    bool linked = vertexOk && fragmentOk && CheckLinkStatus(build.program);
+
+    // Flagged for deletion; freed with the program
+    glDeleteShader(build.vertexShader);
+    glDeleteShader(build.fragmentShader);
+
+    if (!linked) {
+        glDeleteProgram(build.program);
+        return ShaderBuildStatus::Failed;
     }
 
-    std::cout << "[Shader] Successfully reloaded shader '" << m_name << "'" << std::endl;
-    return true;
+    ShaderCache::Instance().StoreProgram(build.cacheKey, build.program);
+    ActivateProgram(build.program);
+
+    std::cout << "[Shader] Loaded shader '" << m_name << "' (ID: " << m_programId
+              << ", Uniforms: " << m_uniformCache.size() << ")" << std::endl;
+    return ShaderBuildStatus::Ready;
 }
 
 bool Shader::NeedsReload() const {
@@ -163,12 +214,12 @@ bool Shader::NeedsReload() const {
 
 void Shader::Bind() const {
     if (m_programId != 0) {
-        glUseProgram(m_programId);
+        GLStateCache::Instance().UseProgram(m_programId);
     }
 }
 
 void Shader::Unbind() const {
-    glUseProgram(0);
+    GLStateCache::Instance().UseProgram(0);
 }
 
 // ============================================================================
@@ -249,6 +300,59 @@ void Shader::SetSampler(const std::string& name, int textureUnit) {
     SetInt(name, textureUnit);
 }
 
+void Shader::SetInt(UniformHandle handle, int value) {
+    int location = GetUniformLocation(handle);
+    if (location != -1) {
+        glUniform1i(location, value);
+    }
+}
+
+void Shader::SetFloat(UniformHandle handle, float value) {
+    int location = GetUniformLocation(handle);
+    if (location != -1) {
+        glUniform1f(location, value);
+    }
+}
+
+void Shader::SetVec2(UniformHandle handle, const Vec2& value) {
+    int location = GetUniformLocation(handle);
+    if (location != -1) {
+        glUniform2fv(location, 1, glm::value_ptr(value));
+    }
+}
+
+void Shader::SetVec3(UniformHandle handle, const Vec3& value) {
+    int location = GetUniformLocation(handle);
+    if (location != -1) {
+        glUniform3fv(location, 1, glm::value_ptr(value));
+    }
+}
+
+void Shader::SetVec4(UniformHandle handle, const Vec4& value) {
+    int location = GetUniformLocation(handle);
+    if (location != -1) {
+        glUniform4fv(location, 1, glm::value_ptr(value));
+    }
+}
+
+void Shader::SetMat3(UniformHandle handle, const Mat3& value, bool transpose) {
+    int location = GetUniformLocation(handle);
+    if (location != -1) {
+        glUniformMatrix3fv(location, 1, transpose ? GL_TRUE : GL_FALSE, glm::value_ptr(value));
+    }
+}
+
+void Shader::SetMat4(UniformHandle handle, const Mat4& value, bool transpose) {
+    int location = GetUniformLocation(handle);
+    if (location != -1) {
+        glUniformMatrix4fv(location, 1, transpose ? GL_TRUE : GL_FALSE, glm::value_ptr(value));
+    }
+}
+
+void Shader::SetSampler(UniformHandle handle, int textureUnit) {
+    SetInt(handle, textureUnit);
+}
+
 // ============================================================================
 // Introspection
 // ============================================================================
@@ -296,6 +400,9 @@ void Shader::PrintDebugInfo() const {
     std::cout << "Program ID: " << m_programId << std::endl;
     std::cout << "Vertex Path: " << m_vertexPath << std::endl;
     std::cout << "Fragment Path: " << m_fragmentPath << std::endl;
+    if (!m_defines.empty()) {
+        std::cout << "Defines:\n" << m_defines;
+    }
     std::cout << "Uniforms (" << m_uniformCache.size() << "):" << std::endl;
     for (const auto& [name, info] : m_uniformCache) {
         std::cout << "  - " << name << " (location: " << info.location << ")" << std::endl;
@@ -307,13 +414,109 @@ void Shader::PrintDebugInfo() const {
 // Private Helpers
 // ============================================================================
 
-unsigned int Shader::CompileShader(unsigned int type, const std::string& source) {
-    unsigned int shader = glCreateShader(type);
-    const char* src = source.c_str();
-    glShaderSource(shader, 1, &src, nullptr);
-    glCompileShader(shader);
+bool Shader::ReadSources(const std::string& vertexPath, const std::string& fragmentPath,
+                         std::string& vertexSource, std::string& fragmentSource) {
+    // Store paths for hot reloading
+    m_vertexPath = vertexPath;
+    m_fragmentPath = fragmentPath;
+
+    // Extract name from path
+    std::filesystem::path vp(vertexPath);
+    m_name = vp.stem().string();
+
+    // Read shader sources
+    vertexSource = ReadFile(vertexPath);
+    fragmentSource = ReadFile(fragmentPath);
 
-    // Check compilation status
+    if (vertexSource.empty()) {
+        std::cerr << "[Shader] Failed to read vertex shader: " << vertexPath << std::endl;
+        return false;
+    }
+    if (fragmentSource.empty()) {
+        std::cerr << "[Shader] Failed to read fragment shader: " << fragmentPath << std::endl;
+        return false;
+    }
+
+    // Store modification times
+    m_vertexModTime = GetFileModTime(vertexPath);
+    m_fragmentModTime = GetFileModTime(fragmentPath);
+    return true;
+}
+
+bool Shader::SubmitBuild(const std::string& vertexSource, const std::string& fragmentSource) {
+    CancelBuild();
+
+    // A cached binary skips compiling and linking entirely
+    auto& cache = ShaderCache::Instance();
+    uint64_t cacheKey = cache.ComputeKey(vertexSource, fragmentSource, m_defines);
+    if (unsigned int cached = cache.LoadProgram(cacheKey, m_name)) {
+        ActivateProgram(cached);
+        std::cout << "[Shader] Loaded shader '" << m_name << "' from cache (ID: " << m_programId
+                  << ", Uniforms: " << m_uniformCache.size() << ")" << std::endl;
+        return true;
+    }
+
+    // Queue compile and link without asking for status: with
+    // KHR_parallel_shader_compile the driver works on it in the background
+    PendingBuild build;
+    build.cacheKey = cacheKey;
+
+    std::string vertexText = InjectDefines(vertexSource, m_defines);
+    std::string fragmentText = InjectDefines(fragmentSource, m_defines);
+
+    const char* vertexSrc = vertexText.c_str();
+    build.vertexShader = glCreateShader(GL_VERTEX_SHADER);
+    glShaderSource(build.vertexShader, 1, &vertexSrc, nullptr);
+    glCompileShader(build.vertexShader);
+
+    const char* fragmentSrc = fragmentText.c_str();
+    build.fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
+    glShaderSource(build.fragmentShader, 1, &fragmentSrc, nullptr);
+    glCompileShader(build.fragmentShader);
+
+    build.program = glCreateProgram();
+    glAttachShader(build.program, build.vertexShader);
+    glAttachShader(build.program, build.fragmentShader);
+    cache.PrepareProgram(build.program);
+    glLinkProgram(build.program);
+
+    m_build = build;
+    return true;
+}
+
+std::string Shader::InjectDefines(const std::string& source, const std::string& defines) {
+    if (defines.empty()) return source;
+
+    // #version must stay the first directive
+    size_t insertAt = 0;
+    size_t versionPos = source.find("#version");
+    if (versionPos != std::string::npos) {
+        size_t lineEnd = source.find('\n', versionPos);
+        insertAt = lineEnd == std::string::npos ? source.size() : lineEnd + 1;
+    }
+    size_t nextLine = static_cast<size_t>(std::count(source.begin(), source.begin() + insertAt, '\n')) + 1;
+
+    std::string result;
+    result.reserve(source.size() + defines.size() + 16);
+    result.append(source, 0, insertAt);
+    if (insertAt > 0 && source[insertAt - 1] != '\n') result += '\n';
+    result += defines;
+    if (defines.back() != '\n') result += '\n';
+    result += "#line " + std::to_string(nextLine) + "\n";
+    result.append(source, insertAt, std::string::npos);
+    return result;
+}
+
+void Shader::CancelBuild() {
+    if (m_build.program == 0) return;
+
+    glDeleteShader(m_build.vertexShader);
+    glDeleteShader(m_build.fragmentShader);
+    glDeleteProgram(m_build.program);
+    m_build = PendingBuild();
+}
+
+bool Shader::CheckCompileStatus(unsigned int shader, unsigned int type) {
     int success;
     glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
     if (!success) {
@@ -323,37 +526,50 @@ unsigned int Shader::CompileShader(unsigned int type, const std::string& source)
         std::string shaderType = (type == GL_VERTEX_SHADER) ? "VERTEX" : "FRAGMENT";
         std::cerr << "[Shader] " << shaderType << " shader compilation failed in '"
                   << m_name << "':\n" << infoLog << std::endl;
-
-        glDeleteShader(shader);
-        return 0;
+        return false;
     }
-
-    return shader;
+    return true;
 }
 
-bool Shader::LinkProgram(unsigned int vertexShader, unsigned int fragmentShader) {
-    m_programId = glCreateProgram();
-    glAttachShader(m_programId, vertexShader);
-    glAttachShader(m_programId, fragmentShader);
-    glLinkProgram(m_programId);
-
-    // Check linking status
+bool Shader::CheckLinkStatus(unsigned int program) {
     int success;
-    glGetProgramiv(m_programId, GL_LINK_STATUS, &success);
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
     if (!success) {
         char infoLog[1024];
-        glGetProgramInfoLog(m_programId, sizeof(infoLog), nullptr, infoLog);
+        glGetProgramInfoLog(program, sizeof(infoLog), nullptr, infoLog);
         std::cerr << "[Shader] Program linking failed for '" << m_name << "':\n"
                   << infoLog << std::endl;
-
-        glDeleteProgram(m_programId);
-        m_programId = 0;
         return false;
     }
-
     return true;
 }
 
+void Shader::ActivateProgram(unsigned int program) {
+    unsigned int oldProgram = m_usingFallback ? 0 : m_programId;
+
+    m_programId = program;
+    m_usingFallback = false;
+    CacheUniforms();
+    BindUniformBlocks();
+
+    // Delete old program (new one is in place)
+    if (oldProgram != 0) {
+        glDeleteProgram(oldProgram);
+        GLStateCache::Instance().OnProgramDeleted(oldProgram);
+    }
+}
+
+void Shader::UseFallback() {
+    unsigned int fallback = ShaderLibrary::Instance().GetFallbackProgram();
+    if (fallback == 0) return;
+
+    // Shared with every other pending shader; never deleted by this one
+    m_programId = fallback;
+    m_usingFallback = true;
+    CacheUniforms();
+    BindUniformBlocks();
+}
+
 void Shader::CacheUniforms() {
     m_uniformCache.clear();
 
@@ -407,17 +623,186 @@ void Shader::CacheUniforms() {
 
         m_uniformCache[info.name] = info;
     }
+
+    BuildHandleTable();
+}
+
+void Shader::BindUniformBlocks() {
+    m_usesFrameUniforms = false;
+    m_materialBlock = UniformBlockLayout();
+    if (m_programId == 0) return;
+
+    m_linkVersion++;
+
+    // GLSL 330 can't declare block bindings, so assign fixed points by name
+    unsigned int frameBlock = glGetUniformBlockIndex(m_programId, FrameUniforms::BLOCK_NAME);
+    if (frameBlock != GL_INVALID_INDEX) {
+        glUniformBlockBinding(m_programId, frameBlock, UniformBinding::Frame);
+        m_usesFrameUniforms = true;
+    }
+
+    unsigned int shadowBlock = glGetUniformBlockIndex(m_programId, ShadowUniformData::BLOCK_NAME);
+    if (shadowBlock != GL_INVALID_INDEX) {
+        glUniformBlockBinding(m_programId, shadowBlock, UniformBinding::Shadow);
+    }
+
+    unsigned int lightBlock = glGetUniformBlockIndex(m_programId, LightUniformData::BLOCK_NAME);
+    if (lightBlock != GL_INVALID_INDEX) {
+        glUniformBlockBinding(m_programId, lightBlock, UniformBinding::Lights);
+    }
+
+    // Their samplers' units are fixed too; those are uniform values, so the
+    // program has to be current to set them
+    const std::pair<UniformHandle, int> engineSamplers[] = {
+        {Uniforms::ShadowMap, TextureUnit::ShadowMap},
+        {Uniforms::LightGrid, TextureUnit::LightGrid},
+        {Uniforms::LightIndices, TextureUnit::LightIndices},
+        {Uniforms::Lights, TextureUnit::Lights},
+        {Uniforms::Lightmap, TextureUnit::Lightmap},
+    };
+    for (const auto& [sampler, unit] : engineSamplers) {
+        int location = GetUniformLocation(sampler);
+        if (location != -1) {
+            GLStateCache::Instance().UseProgram(m_programId);
+            glUniform1i(location, unit);
+        }
+    }
+
+    unsigned int materialBlock = glGetUniformBlockIndex(m_programId, MATERIAL_BLOCK_NAME);
+    if (materialBlock == GL_INVALID_INDEX) return;
+
+    glUniformBlockBinding(m_programId, materialBlock, UniformBinding::Material);
+
+    int blockSize = 0;
+    glGetActiveUniformBlockiv(m_programId, materialBlock, GL_UNIFORM_BLOCK_DATA_SIZE, &blockSize);
+    m_materialBlock.name = MATERIAL_BLOCK_NAME;
+    m_materialBlock.size = static_cast<uint32_t>(blockSize);
+
+    // Record the std140 offsets of every member so materials can pack them.
+    // A table block reports every entry's members ("u_Materials[3].u_Color");
+    // entry 0 gives the layout and entry 1 the stride.
+    int uniformCount = 0;
+    glGetProgramiv(m_programId, GL_ACTIVE_UNIFORMS, &uniformCount);
+
+    const std::string tablePrefix = std::string(MATERIAL_TABLE_ARRAY) + "[";
+    std::unordered_map<std::string, uint32_t> secondEntry;
+    bool table = false;
+
+    char nameBuffer[256];
+    for (int i = 0; i < uniformCount; i++) {
+        GLuint index = static_cast<GLuint>(i);
+        int block = -1;
+        glGetActiveUniformsiv(m_programId, 1, &index, GL_UNIFORM_BLOCK_INDEX, &block);
+        if (block != static_cast<int>(materialBlock)) continue;
+
+        int offset = 0, arrayStride = 0, matrixStride = 0;
+        glGetActiveUniformsiv(m_programId, 1, &index, GL_UNIFORM_OFFSET, &offset);
+        glGetActiveUniformsiv(m_programId, 1, &index, GL_UNIFORM_ARRAY_STRIDE, &arrayStride);
+        glGetActiveUniformsiv(m_programId, 1, &index, GL_UNIFORM_MATRIX_STRIDE, &matrixStride);
+
+        int size;
+        unsigned int type;
+        glGetActiveUniform(m_programId, index, sizeof(nameBuffer), nullptr, &size, &type, nameBuffer);
+
+        std::string name = nameBuffer;
+        std::string field = name;
+        if (name.compare(0, tablePrefix.size(), tablePrefix) == 0) {
+            size_t close = name.find("].", tablePrefix.size());
+            if (close == std::string::npos) continue;
+            int entry = std::atoi(name.c_str() + tablePrefix.size());
+            field = name.substr(close + 2);
+            table = true;
+            if (entry == 1) secondEntry[field] = static_cast<uint32_t>(offset);
+            if (entry != 0) continue;
+        }
+
+        UniformBlockMember member;
+        member.name = field;
+        member.handle = UniformHandle(member.name);
+        member.offset = static_cast<uint32_t>(offset);
+        member.arrayStride = static_cast<uint32_t>(arrayStride);
+        member.matrixStride = static_cast<uint32_t>(matrixStride);
+
+        auto it = m_uniformCache.find(name);
+        member.type = it != m_uniformCache.end() ? it->second.type : UniformType::Unknown;
+
+        m_materialBlock.members.push_back(std::move(member));
+    }
+
+    if (table && !m_materialBlock.members.empty()) {
+        // The first struct member sits at the entry's start
+        uint32_t base = m_materialBlock.members[0].offset;
+        for (const auto& member : m_materialBlock.members) base = std::min(base, member.offset);
+
+        uint32_t stride = m_materialBlock.size - base;   // A one-entry table
+        for (const auto& member : m_materialBlock.members) {
+            auto next = secondEntry.find(member.name);
+            if (next != secondEntry.end()) {
+                stride = next->second - member.offset;
+                break;
+            }
+        }
+        for (auto& member : m_materialBlock.members) member.offset -= base;
+        m_materialBlock.entryOffset = base;
+        m_materialBlock.entryStride = stride;
+    }
+}
+
+void Shader::BuildHandleTable() {
+    m_handleTable.clear();
+    m_handleMask = 0;
+
+    size_t activeCount = 0;
+    for (const auto& [name, info] : m_uniformCache) {
+        if (info.location != -1) activeCount++;
+    }
+    if (activeCount == 0) return;
+
+    // Keep the load factor at or below 0.5 so probes stay short
+    size_t tableSize = 8;
+    while (tableSize < activeCount * 2) tableSize *= 2;
+    m_handleTable.resize(tableSize);
+    m_handleMask = static_cast<uint32_t>(tableSize - 1);
+
+    for (const auto& [name, info] : m_uniformCache) {
+        if (info.location == -1) continue;
+
+        uint32_t hash = UniformHandle::Hash(name);
+        uint32_t slot = hash & m_handleMask;
+        while (m_handleTable[slot].hash != 0) {
+            if (m_handleTable[slot].hash == hash) {
+                std::cerr << "[Shader] Warning: uniform handle collision on '" << name
+                          << "' in shader '" << m_name << "'" << std::endl;
+                break;
+            }
+            slot = (slot + 1) & m_handleMask;
+        }
+        if (m_handleTable[slot].hash == 0) {
+            m_handleTable[slot].hash = hash;
+            m_handleTable[slot].location = info.location;
+        }
+    }
 }
 
 void Shader::Cleanup() {
-    if (m_programId != 0) {
+    CancelBuild();
+    if (m_programId != 0 && !m_usingFallback) {
         glDeleteProgram(m_programId);
-        m_programId = 0;
+        GLStateCache::Instance().OnProgramDeleted(m_programId);
     }
+    m_programId = 0;
+    m_usingFallback = false;
     m_uniformCache.clear();
+    m_handleTable.clear();
+    m_handleMask = 0;
 }
 
 std::string Shader::ReadFile(const std::string& path) {
+    std::string prefetched;
+    if (ShaderLibrary::Instance().TakePrefetchedSource(path, prefetched)) {
+        return prefetched;
+    }
+
     std::ifstream file(path);
     if (!file.is_open()) {
         std::cerr << "[Shader] Failed to open file: " << path << std::endl;
@@ -467,6 +852,208 @@ std::shared_ptr<Shader> ShaderLibrary::Load(const std::string& name,
     return shader;
 }
 
+std::shared_ptr<Shader> ShaderLibrary::LoadAsync(const std::string& name,
+                                                   const std::string& vertexPath,
+                                                   const std::string& fragmentPath) {
+    auto it = m_shaders.find(name);
+    if (it != m_shaders.end()) {
+        return it->second;
+    }
+
+    auto shader = std::make_shared<Shader>();
+    if (!shader->BeginLoadFromFiles(m_basePath + vertexPath, m_basePath + fragmentPath)) {
+        std::cerr << "[ShaderLibrary] Failed to load shader '" << name << "'" << std::endl;
+        return nullptr;
+    }
+
+    m_shaders[name] = shader;
+    AddPending(shader);
+    return shader;
+}
+
+void ShaderLibrary::PrefetchSources() {
+    if (m_prefetching) return;
+    m_prefetching = true;
+
+    std::string basePath = m_basePath;
+    JobSystem::Instance().Submit([this, basePath] {
+        StartupProfile::Scope scope("Shader sources");
+        std::error_code ec;
+        std::unordered_map<std::string, std::string> sources;
+        for (const auto& entry : std::filesystem::directory_iterator(basePath, ec)) {
+            if (!entry.is_regular_file(ec)) continue;
+
+            std::ifstream file(entry.path(), std::ios::binary);
+            if (!file.is_open()) continue;
+            std::stringstream buffer;
+            buffer << file.rdbuf();
+            sources[basePath + entry.path().filename().string()] = buffer.str();
+        }
+        if (ec) {
+            std::cerr << "[ShaderLibrary] Failed to prefetch shaders in: " << basePath << std::endl;
+        }
+
+        std::lock_guard<std::mutex> lock(m_prefetchMutex);
+        m_prefetched = std::move(sources);
+    }, &m_prefetchDone);
+}
+
+bool ShaderLibrary::TakePrefetchedSource(const std::string& path, std::string& out) {
+    if (!m_prefetching) return false;
+    if (!m_prefetchDone.IsDone()) {
+        JobSystem::Instance().Wait(m_prefetchDone);
+    }
+
+    std::lock_guard<std::mutex> lock(m_prefetchMutex);
+    auto it = m_prefetched.find(path);
+    if (it == m_prefetched.end()) return false;
+    out = std::move(it->second);
+    m_prefetched.erase(it);
+    return true;
+}
+
+void ShaderLibrary::ReleasePrefetchedSources() {
+    if (!m_prefetching) return;
+    JobSystem::Instance().Wait(m_prefetchDone);
+
+    std::lock_guard<std::mutex> lock(m_prefetchMutex);
+    m_prefetched.clear();
+    m_prefetching = false;
+}
+
+void ShaderLibrary::AddPending(const std::shared_ptr<Shader>& shader) {
+    if (!shader->IsBuildPending()) return;   // Cache hit: already swapped in
+    if (std::find(m_pending.begin(), m_pending.end(), shader) == m_pending.end()) {
+        m_pending.push_back(shader);
+    }
+}
+
+void ShaderLibrary::UpdatePendingShaders() {
+    if (m_pending.empty()) return;
+    GENESIS_PROFILE_SCOPE("Shader Builds");
+
+    m_pending.erase(std::remove_if(m_pending.begin(), m_pending.end(),
+        [](const std::shared_ptr<Shader>& shader) {
+            return shader->UpdateBuild() != ShaderBuildStatus::Pending;
+        }), m_pending.end());
+}
+
+void ShaderLibrary::FinishPendingShaders() {
+    for (auto& shader : m_pending) {
+        shader->UpdateBuild(true);
+    }
+    m_pending.clear();
+}
+
+ShaderKeywords ShaderLibrary::GetKeyword(const std::string& name) {
+    for (size_t i = 0; i < m_keywords.size(); i++) {
+        if (m_keywords[i] == name) return 1u << i;
+    }
+    if (m_keywords.size() == MAX_KEYWORDS) {
+        std::cerr << "[ShaderLibrary] Too many shader keywords, ignoring '" << name << "'" << std::endl;
+        return 0;
+    }
+    m_keywords.push_back(name);
+    return 1u << (m_keywords.size() - 1);
+}
+
+std::string ShaderLibrary::BuildDefines(ShaderKeywords keywords) const {
+    std::string defines;
+    for (size_t i = 0; i < m_keywords.size(); i++) {
+        if (keywords & (1u << i)) {
+            defines += "#define " + m_keywords[i] + " 1\n";
+        }
+    }
+    return defines;
+}
+
+std::shared_ptr<Shader> ShaderLibrary::GetVariant(const std::shared_ptr<Shader>& base, ShaderKeywords keywords) {
+    if (!base || keywords == 0 || base->GetVertexPath().empty() || base->GetFragmentPath().empty()) {
+        return base;
+    }
+
+    auto& variants = m_variants[base->GetVertexPath() + "|" + base->GetFragmentPath()];
+    auto it = variants.find(keywords);
+    if (it != variants.end()) {
+        return it->second ? it->second : base;
+    }
+
+    auto variant = std::make_shared<Shader>();
+    if (!variant->BeginLoadFromFiles(base->GetVertexPath(), base->GetFragmentPath(), BuildDefines(keywords))) {
+        variants.emplace(keywords, nullptr);   // Don't retry every frame
+        return base;
+    }
+    AddPending(variant);
+    variants.emplace(keywords, variant);
+    return variant;
+}
+
+size_t ShaderLibrary::GetVariantCount() const {
+    size_t count = 0;
+    for (const auto& [files, variants] : m_variants) {
+        count += variants.size();
+    }
+    return count;
+}
+
+unsigned int ShaderLibrary::GetFallbackProgram() {
+    if (!m_fallback) {
+        // Same inputs and FrameData block as mesh.vert
+        static const char* vertexSource = R"(#version 330 core
+layout (location = 0) in vec3 aPos;
+layout (location = 8) in mat4 aInstanceModel;
+layout (std140) uniform FrameData {
+    mat4 u_View;
+    mat4 u_Proj;
+    mat4 u_ViewProj;
+    vec4 u_CameraPos;
+    vec4 u_LightDir;
+    vec4 u_LightColor;
+    vec4 u_AmbientColor;
+    vec4 u_Time;
+};
+uniform mat4 u_Model;
+uniform int u_Instanced;
+invariant gl_Position;
+void main() {
+    mat4 model = u_Instanced != 0 ? aInstanceModel : u_Model;
+    vec4 worldPos = model * vec4(aPos, 1.0);
+    gl_Position = u_Proj * u_View * worldPos;
+}
+)";
+        static const char* fragmentSource = R"(#version 330 core
+out vec4 FragColor;
+void main() {
+    FragColor = vec4(0.5, 0.5, 0.5, 1.0);
+}
+)";
+        m_fallback = std::make_unique<Shader>();
+        if (!m_fallback->LoadFromSource(vertexSource, fragmentSource, "fallback")) {
+            std::cerr << "[ShaderLibrary] Failed to build fallback shader" << std::endl;
+        }
+    }
+    return m_fallback->GetProgramId();
+}
+
+bool ShaderLibrary::HasParallelCompile() {
+    if (m_parallelCompile < 0) {
+        m_parallelCompile = 0;
+        GLint count = 0;
+        glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+        for (GLint i = 0; i < count; i++) {
+            const char* name = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i));
+            if (name && (std::strcmp(name, "GL_KHR_parallel_shader_compile") == 0 ||
+                         std::strcmp(name, "GL_ARB_parallel_shader_compile") == 0)) {
+                m_parallelCompile = 1;
+                break;
+            }
+        }
+        std::cout << "[ShaderLibrary] Parallel shader compile: "
+                  << (m_parallelCompile ? "available" : "not available") << std::endl;
+    }
+    return m_parallelCompile == 1;
+}
+
 std::shared_ptr<Shader> ShaderLibrary::Get(const std::string& name) const {
     auto it = m_shaders.find(name);
     if (it != m_shaders.end()) {
@@ -486,26 +1073,43 @@ void ShaderLibrary::Remove(const std::string& name) {
 }
 
 void ShaderLibrary::Clear() {
+    m_pending.clear();
     m_shaders.clear();
+    m_variants.clear();
+    m_fallback.reset();
 }
 
 void ShaderLibrary::CheckForReloads() {
     if (!m_hotReloadEnabled) return;
+    GENESIS_PROFILE_SCOPE("Shader Reload Check");
 
-    for (auto& [name, shader] : m_shaders) {
-        if (shader && shader->NeedsReload()) {
-            shader->Reload();
+    ForEachShader([this](const std::shared_ptr<Shader>& shader) {
+        if (shader->NeedsReload() && shader->BeginReload()) {
+            AddPending(shader);
         }
-    }
+    });
+}
+
+void ShaderLibrary::OnFilesChanged(const std::vector<std::string>& paths) {
+    if (!m_hotReloadEnabled || paths.empty()) return;
+    GENESIS_PROFILE_SCOPE("Shader Reload");
+
+    auto changed = [&paths](const std::string& shaderPath) {
+        std::string normalized = FileWatcher::NormalizePath(shaderPath);
+        return std::find(paths.begin(), paths.end(), normalized) != paths.end();
+    };
+
+    ForEachShader([&](const std::shared_ptr<Shader>& shader) {
+        if ((changed(shader->GetVertexPath()) || changed(shader->GetFragmentPath())) &&
+            shader->BeginReload()) {
+            AddPending(shader);
+        }
+    });
 }
 
 void ShaderLibrary::ReloadAll() {
     std::cout << "[ShaderLibrary] Reloading all shaders..." << std::endl;
-    for (auto& [name, shader] : m_shaders) {
-        if (shader) {
-            shader->Reload();
-        }
-    }
+    ForEachShader([](const std::shared_ptr<Shader>& shader) { shader->Reload(); });
 }
 
 void ShaderLibrary::PrintDebugInfo() const {
@@ -519,6 +1123,7 @@ void ShaderLibrary::PrintDebugInfo() const {
                       << ", Valid: " << (shader->IsValid() ? "Yes" : "No") << ")" << std::endl;
         }
     }
+    std::cout << "Keywords: " << m_keywords.size() << ", Variants: " << GetVariantCount() << std::endl;
     std::cout << "============================" << std::endl;
 }
 
@@ -6,7 +6,10 @@
 #include <filesystem>
 #include <chrono>
 #include <vector>
+#include <mutex>
+#include "core/JobSystem.h"
 #include "math/Math.h"  // For Vec2, Vec3, Vec4, Mat3, Mat4
+#include "UniformHandle.h"
 
 namespace Genesis {
 
@@ -36,8 +39,59 @@ struct UniformInfo {
     int size = 1;  // Array size (1 for non-arrays)
 };
 
+// ============================================================================
+// Uniform Block Layout - Member offsets of a std140 block, as reported by GL
+// ============================================================================
+struct UniformBlockMember {
+    std::string name;
+    UniformHandle handle;
+    UniformType type = UniformType::Unknown;
+    uint32_t offset = 0;
+    uint32_t arrayStride = 0;
+    uint32_t matrixStride = 0;
+};
+
+struct UniformBlockLayout {
+    std::string name;
+    uint32_t size = 0;  // GL_UNIFORM_BLOCK_DATA_SIZE
+    std::vector<UniformBlockMember> members;
+
+    // Material table blocks (a MaterialData block holding an array of
+    // per-material structs, see MaterialTable): members are relative to one
+    // entry, entry i starts at entryOffset + i * entryStride
+    uint32_t entryOffset = 0;
+    uint32_t entryStride = 0;   // 0 = plain block
+
+    bool IsTable() const { return entryStride > 0; }
+    uint32_t GetEntryCount() const { return IsTable() ? (size - entryOffset) / entryStride : 1; }
+
+    const UniformBlockMember* Find(UniformHandle handle) const {
+        for (const auto& member : members) {
+            if (member.handle == handle) return &member;
+        }
+        return nullptr;
+    }
+};
+
+// Bitmask of shader keywords (ShaderLibrary::GetKeyword), one bit per define
+using ShaderKeywords = uint32_t;
+
+// Result of polling a background build (Shader::UpdateBuild)
+enum class ShaderBuildStatus {
+    None,       // Nothing being built
+    Pending,    // Driver still compiling/linking
+    Ready,      // New program swapped in
+    Failed      // Errors logged; previous (or fallback) program kept
+};
+
 // ============================================================================
 // Shader - Represents a compiled and linked GPU shader program
+//
+// LoadFrom*() compile and link before returning. BeginLoadFrom*() and
+// BeginReload() only submit the work: with KHR_parallel_shader_compile the
+// driver builds on its own threads and UpdateBuild() swaps the program in
+// once it has linked. Until then the shader keeps drawing with its previous
+// program, or with ShaderLibrary's fallback if it has none yet.
 // ============================================================================
 class Shader {
 public:
@@ -54,16 +108,32 @@ public:
     // Loading
     // ========================================================================
 
-    // Load shader from vertex and fragment file paths
-    bool LoadFromFiles(const std::string& vertexPath, const std::string& fragmentPath);
+    // Load shader from vertex and fragment file paths. 'defines' ("#define
+    // NAME 1" lines) is inserted after the #version line of both stages and
+    // kept for reloads.
+    bool LoadFromFiles(const std::string& vertexPath, const std::string& fragmentPath,
+                       const std::string& defines = "");
 
     // Load shader from source strings
     bool LoadFromSource(const std::string& vertexSource, const std::string& fragmentSource,
-                        const std::string& debugName = "inline");
+                        const std::string& debugName = "inline", const std::string& defines = "");
 
     // Reload shader from files (for hot reloading)
     bool Reload();
 
+    // Non-blocking variants; poll UpdateBuild() until it stops returning
+    // Pending (ShaderLibrary does this every frame for its shaders)
+    bool BeginLoadFromFiles(const std::string& vertexPath, const std::string& fragmentPath,
+                            const std::string& defines = "");
+    bool BeginLoadFromSource(const std::string& vertexSource, const std::string& fragmentSource,
+                             const std::string& debugName = "inline", const std::string& defines = "");
+    bool BeginReload();
+
+    // Finish the background build if the driver is done (or wait for it)
+    ShaderBuildStatus UpdateBuild(bool wait = false);
+    bool IsBuildPending() const { return m_build.program != 0; }
+    bool IsUsingFallback() const { return m_usingFallback; }
+
     // Check if files have been modified since last load
     bool NeedsReload() const;
 
@@ -91,6 +161,19 @@ public:
     void SetMat4(const std::string& name, const Mat4& value, bool transpose = false);
     void SetSampler(const std::string& name, int textureUnit);
 
+    // ========================================================================
+    // Handle-Based Uniform Setters (no string work, silent if not present)
+    // ========================================================================
+
+    void SetInt(UniformHandle handle, int value);
+    void SetFloat(UniformHandle handle, float value);
+    void SetVec2(UniformHandle handle, const Vec2& value);
+    void SetVec3(UniformHandle handle, const Vec3& value);
+    void SetVec4(UniformHandle handle, const Vec4& value);
+    void SetMat3(UniformHandle handle, const Mat3& value, bool transpose = false);
+    void SetMat4(UniformHandle handle, const Mat4& value, bool transpose = false);
+    void SetSampler(UniformHandle handle, int textureUnit);
+
     // ========================================================================
     // Introspection
     // ========================================================================
@@ -99,6 +182,11 @@ public:
     const std::string& GetName() const { return m_name; }
     const std::string& GetVertexPath() const { return m_vertexPath; }
     const std::string& GetFragmentPath() const { return m_fragmentPath; }
+    const std::string& GetDefines() const { return m_defines; }
+
+    // Insert 'defines' after the #version line, with a #line directive so
+    // compiler errors keep the original line numbers
+    static std::string InjectDefines(const std::string& source, const std::string& defines);
 
     // Get all cached uniforms
     const std::unordered_map<std::string, UniformInfo>& GetUniforms() const { return m_uniformCache; }
@@ -109,14 +197,48 @@ public:
     // Get uniform location (cached)
     int GetUniformLocation(const std::string& name) const;
 
+    // Handle lookups: open-addressed table built at CacheUniforms time.
+    // Returns -1 if the shader has no active uniform with that name.
+    int GetUniformLocation(UniformHandle handle) const {
+        if (m_handleTable.empty() || !handle.IsValid()) return -1;
+        for (uint32_t slot = handle.hash & m_handleMask;; slot = (slot + 1) & m_handleMask) {
+            const HandleSlot& entry = m_handleTable[slot];
+            if (entry.hash == handle.hash) return entry.location;
+            if (entry.hash == 0) return -1;
+        }
+    }
+    bool HasUniform(UniformHandle handle) const { return GetUniformLocation(handle) != -1; }
+
+    static constexpr const char* MATERIAL_BLOCK_NAME = "MaterialData";
+    static constexpr const char* MATERIAL_TABLE_ARRAY = "u_Materials";   // MaterialData as a table
+
+    // True if the program declares the per-frame FrameData uniform block
+    bool UsesFrameUniforms() const { return m_usesFrameUniforms; }
+
+    // Layout of the MaterialData block, or nullptr if the program has none
+    const UniformBlockLayout* GetMaterialBlock() const {
+        return m_materialBlock.size > 0 ? &m_materialBlock : nullptr;
+    }
+
+    // Bumped on every successful link, so cached layouts can detect reloads
+    uint32_t GetLinkVersion() const { return m_linkVersion; }
+
     // Print shader info for debugging
     void PrintDebugInfo() const;
 
 private:
     // Compilation helpers
-    unsigned int CompileShader(unsigned int type, const std::string& source);
-    bool LinkProgram(unsigned int vertexShader, unsigned int fragmentShader);
+    bool ReadSources(const std::string& vertexPath, const std::string& fragmentPath,
+                     std::string& vertexSource, std::string& fragmentSource);
+    bool SubmitBuild(const std::string& vertexSource, const std::string& fragmentSource);
+    void CancelBuild();
+    bool CheckCompileStatus(unsigned int shader, unsigned int type);
+    bool CheckLinkStatus(unsigned int program);
+    void ActivateProgram(unsigned int program);
+    void UseFallback();
     void CacheUniforms();
+    void BuildHandleTable();
+    void BindUniformBlocks();
     void Cleanup();
 
     // File helpers
@@ -130,15 +252,45 @@ private:
     // File paths (for hot reloading)
     std::string m_vertexPath;
     std::string m_fragmentPath;
+    std::string m_defines;
     std::filesystem::file_time_type m_vertexModTime;
     std::filesystem::file_time_type m_fragmentModTime;
 
     // Uniform cache: name -> info
     mutable std::unordered_map<std::string, UniformInfo> m_uniformCache;
+
+    // Handle table: name hash -> location (power-of-two size, at most half full)
+    struct HandleSlot {
+        uint32_t hash = 0;
+        int location = -1;
+    };
+    std::vector<HandleSlot> m_handleTable;
+    uint32_t m_handleMask = 0;
+
+    // Uniform blocks
+    bool m_usesFrameUniforms = false;
+    UniformBlockLayout m_materialBlock;
+    uint32_t m_linkVersion = 0;
+
+    // Background build; the objects are only queried once it has finished
+    struct PendingBuild {
+        unsigned int program = 0;
+        unsigned int vertexShader = 0;
+        unsigned int fragmentShader = 0;
+        uint64_t cacheKey = 0;
+    };
+    bool m_usingFallback = false;   // m_programId is ShaderLibrary's fallback
+    PendingBuild m_build;
 };
 
 // ============================================================================
 // ShaderLibrary - Manages shader loading and caching
+//
+// Variants: a keyword is a preprocessor define ("UNLIT", "USE_TEXTURE", ...)
+// registered once and given a bit. GetVariant() returns the base shader's
+// files compiled with "#define <KEYWORD> 1" for every bit in the mask; each
+// combination is built in the background the first time it is asked for
+// and after that is a map lookup. Variants hot reload with their base files.
 // ============================================================================
 class ShaderLibrary {
 public:
@@ -156,6 +308,41 @@ public:
                                    const std::string& vertexPath,
                                    const std::string& fragmentPath);
 
+    // Submit a shader for background compilation and return it at once; it
+    // draws with the fallback program until UpdatePendingShaders() swaps it
+    // in. nullptr only if the files can't be read.
+    std::shared_ptr<Shader> LoadAsync(const std::string& name,
+                                      const std::string& vertexPath,
+                                      const std::string& fragmentPath);
+
+    // Swap in every shader whose background build has finished (main
+    // thread, once per frame)
+    void UpdatePendingShaders();
+
+    // Block until every background build has finished
+    void FinishPendingShaders();
+
+    size_t GetPendingCount() const { return m_pending.size(); }
+
+    // ========================================================================
+    // Variants
+    // ========================================================================
+
+    static constexpr uint32_t MAX_KEYWORDS = 32;
+
+    // Bit for a keyword, registering it on first use (0 once all 32 are taken)
+    ShaderKeywords GetKeyword(const std::string& name);
+
+    // "#define NAME 1" lines for a mask, in bit order
+    std::string BuildDefines(ShaderKeywords keywords) const;
+
+    // 'base' compiled with the given keywords. Returns 'base' for an empty
+    // mask or a shader without files. The result draws with the fallback
+    // until its build finishes (see Shader::IsUsingFallback).
+    std::shared_ptr<Shader> GetVariant(const std::shared_ptr<Shader>& base, ShaderKeywords keywords);
+
+    size_t GetVariantCount() const;
+
     // Get a previously loaded shader
     std::shared_ptr<Shader> Get(const std::string& name) const;
 
@@ -175,6 +362,10 @@ public:
     // Check all shaders for changes and reload if needed
     void CheckForReloads();
 
+    // Reload only the shaders using one of these files (paths as reported
+    // by FileWatcher)
+    void OnFilesChanged(const std::vector<std::string>& paths);
+
     // Force reload all shaders
     void ReloadAll();
 
@@ -193,9 +384,27 @@ public:
     void SetShaderBasePath(const std::string& path) { m_basePath = path; }
     const std::string& GetShaderBasePath() const { return m_basePath; }
 
+    // Read every file in the base path on a job (startup, while the window
+    // and GL context are created); the first read of each then comes from
+    // memory instead of disk
+    void PrefetchSources();
+
+    // Source prefetched for path (waits for the prefetch if still running).
+    // Handed out once: later reads, hot reloads included, go to disk.
+    bool TakePrefetchedSource(const std::string& path, std::string& out);
+
+    // Drop what startup didn't read, so files edited later aren't served stale
+    void ReleasePrefetchedSources();
+
     // Print all loaded shaders
     void PrintDebugInfo() const;
 
+    // Flat-shaded stand-in for shaders still compiling (built on first use)
+    unsigned int GetFallbackProgram();
+
+    // Driver exposes KHR/ARB_parallel_shader_compile
+    bool HasParallelCompile();
+
 private:
     ShaderLibrary() = default;
     ~ShaderLibrary() = default;
@@ -203,11 +412,39 @@ private:
     ShaderLibrary& operator=(const ShaderLibrary&) = delete;
 
 private:
+    void AddPending(const std::shared_ptr<Shader>& shader);
+
+    // Base shaders and variants alike
+    template<typename Fn>
+    void ForEachShader(Fn&& fn) {
+        for (auto& [name, shader] : m_shaders) {
+            if (shader) fn(shader);
+        }
+        for (auto& [files, variants] : m_variants) {
+            for (auto& [keywords, shader] : variants) {
+                if (shader) fn(shader);
+            }
+        }
+    }
+
     std::unordered_map<std::string, std::shared_ptr<Shader>> m_shaders;
+    std::vector<std::shared_ptr<Shader>> m_pending;   // Background builds
+
+    // Variants by "<vertex path>|<fragment path>", then keyword mask
+    std::unordered_map<std::string, std::unordered_map<ShaderKeywords, std::shared_ptr<Shader>>> m_variants;
+    std::vector<std::string> m_keywords;               // Index = bit
+    std::unique_ptr<Shader> m_fallback;
+    int m_parallelCompile = -1;                        // -1 = not queried yet
     std::string m_basePath = "assets/shaders/";
     bool m_hotReloadEnabled = true;
     float m_hotReloadInterval = 1.0f;  // Check every second
     float m_timeSinceLastCheck = 0.0f;
+
+    // PrefetchSources(): file contents by full path
+    std::unordered_map<std::string, std::string> m_prefetched;
+    std::mutex m_prefetchMutex;
+    JobCounter m_prefetchDone;
+    bool m_prefetching = false;
 };
 
 } // namespace Genesis
@@ -0,0 +1,173 @@
+#include "ShaderCache.h"
+#include "core/Hash.h"
+#include "core/Profiler.h"
+#include <glad/glad.h>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+namespace Genesis {
+
+namespace {
+    std::string GLString(GLenum name) {
+        const GLubyte* value = glGetString(name);
+        return value ? reinterpret_cast<const char*>(value) : "";
+    }
+}
+
+bool ShaderCache::IsSupported() {
+    if (m_supported < 0) {
+        GLint formats = 0;
+        if (GLAD_GL_VERSION_4_1 || GLAD_GL_ARB_get_program_binary) {
+            glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+        }
+        m_supported = formats > 0 ? 1 : 0;
+
+        uint64_t hash = FNV_OFFSET;
+        hash = HashString(hash, GLString(GL_VENDOR));
+        hash = HashString(hash, GLString(GL_RENDERER));
+        hash = HashString(hash, GLString(GL_VERSION));
+        m_driverHash = hash;
+
+        if (!m_supported) {
+            std::cout << "[ShaderCache] Program binaries not supported by this driver, caching disabled" << std::endl;
+        }
+    }
+    return m_supported == 1;
+}
+
+uint64_t ShaderCache::ComputeKey(const std::string& vertexSource, const std::string& fragmentSource,
+                                 const std::string& defines) {
+    if (!m_enabled || !IsSupported()) return 0;
+
+    uint64_t hash = HashBytes(m_driverHash, &VERSION, sizeof(VERSION));
+    hash = HashString(hash, vertexSource);
+    hash = HashString(hash, fragmentSource);
+    hash = HashString(hash, defines);
+    return hash != 0 ? hash : 1;
+}
+
+std::string ShaderCache::GetPath(uint64_t key) const {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(key));
+    return m_directory + name;
+}
+
+unsigned int ShaderCache::LoadProgram(uint64_t key, const std::string& debugName) {
+    if (key == 0) return 0;
+    GENESIS_PROFILE_SCOPE("Shader Cache Load");
+
+    std::string path = GetPath(key);
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        m_misses++;
+        return 0;
+    }
+
+    std::error_code sizeError;
+    uintmax_t fileSize = std::filesystem::file_size(path, sizeError);
+
+    Header header{};
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    std::vector<char> binary;
+    // A length the file can't hold means a corrupt header: never allocate it
+    bool lengthOk = !sizeError && fileSize >= sizeof(Header) && header.length > 0 &&
+                    header.length <= fileSize - sizeof(Header);
+    if (file && header.magic == MAGIC && header.version == VERSION && header.key == key && lengthOk) {
+        binary.resize(header.length);
+        file.read(binary.data(), static_cast<std::streamsize>(binary.size()));
+    }
+    bool readOk = !binary.empty() && file.gcount() == static_cast<std::streamsize>(binary.size());
+    file.close();
+
+    GLuint program = 0;
+    if (readOk) {
+        program = glCreateProgram();
+        glProgramBinary(program, header.format, binary.data(), static_cast<GLsizei>(binary.size()));
+
+        GLint linked = GL_FALSE;
+        glGetProgramiv(program, GL_LINK_STATUS, &linked);
+        if (!linked) {
+            glDeleteProgram(program);
+            program = 0;
+        }
+    }
+
+    if (program == 0) {
+        // Truncated, stale or rejected by the driver: recompile and rewrite
+        std::cout << "[ShaderCache] Discarding invalid cached binary for '" << debugName << "'" << std::endl;
+        std::error_code ec;
+        std::filesystem::remove(path, ec);
+        m_misses++;
+        return 0;
+    }
+
+    m_hits++;
+    return program;
+}
+
+void ShaderCache::PrepareProgram(unsigned int program) {
+    if (m_enabled && IsSupported()) {
+        glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+}
+
+bool ShaderCache::StoreProgram(uint64_t key, unsigned int program) {
+    if (key == 0 || program == 0) return false;
+    GENESIS_PROFILE_SCOPE("Shader Cache Store");
+
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) return false;
+
+    std::vector<char> binary(static_cast<size_t>(length));
+    GLenum format = 0;
+    GLsizei written = 0;
+    glGetProgramBinary(program, length, &written, &format, binary.data());
+    if (written <= 0) return false;
+
+    std::error_code ec;
+    std::filesystem::create_directories(m_directory, ec);
+
+    // Write to a temporary and rename, so a crash never leaves a torn file
+    std::string path = GetPath(key);
+    std::string tempPath = path + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            std::cerr << "[ShaderCache] Failed to write " << tempPath << std::endl;
+            return false;
+        }
+
+        Header header{};
+        header.magic = MAGIC;
+        header.version = VERSION;
+        header.key = key;
+        header.format = format;
+        header.length = static_cast<uint32_t>(written);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(binary.data(), written);
+        if (!file) return false;
+    }
+
+    std::filesystem::rename(tempPath, path, ec);
+    if (ec) {
+        std::filesystem::remove(tempPath, ec);
+        return false;
+    }
+    return true;
+}
+
+void ShaderCache::Clear() {
+    std::error_code ec;
+    for (std::filesystem::directory_iterator it(m_directory, ec), end; !ec && it != end; it.increment(ec)) {
+        if (it->path().extension() == ".bin") {
+            std::filesystem::remove(it->path(), ec);
+        }
+    }
+    std::cout << "[ShaderCache] Cleared " << m_directory << std::endl;
+}
+
+} // namespace Genesis
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace Genesis {
+
+// ============================================================================
+// ShaderCache - On-disk cache of linked program binaries
+//
+// Shader::LoadFromSource asks the cache before compiling: the key is a hash
+// of the GL vendor/renderer/version strings, both stages' source and the
+// preprocessor defines, so a driver update or any edit misses and the
+// program is compiled and stored again. Binaries the driver rejects are
+// deleted and recompiled.
+//
+// Needs GL 4.1 or ARB_get_program_binary and at least one binary format;
+// otherwise every call is a miss and nothing is written.
+//
+// File layout: Header followed by the driver's binary blob, one file per key
+// named <key in hex>.bin in the cache directory.
+// ============================================================================
+class ShaderCache {
+public:
+    static ShaderCache& Instance() {
+        static ShaderCache instance;
+        return instance;
+    }
+
+    void SetEnabled(bool enabled) { m_enabled = enabled; }
+    bool IsEnabled() const { return m_enabled; }
+
+    void SetDirectory(const std::string& directory) { m_directory = directory; }
+    const std::string& GetDirectory() const { return m_directory; }
+
+    // Driver support (queried once a GL context is current)
+    bool IsSupported();
+
+    // 0 when the cache is disabled or unsupported
+    uint64_t ComputeKey(const std::string& vertexSource, const std::string& fragmentSource,
+                        const std::string& defines = "");
+
+    // Linked program from the cache, or 0 on a miss
+    unsigned int LoadProgram(uint64_t key, const std::string& debugName);
+
+    // Call before glLinkProgram so the driver keeps the binary retrievable
+    void PrepareProgram(unsigned int program);
+
+    // Save a freshly linked program
+    bool StoreProgram(uint64_t key, unsigned int program);
+
+    // Delete every cached binary
+    void Clear();
+
+    uint32_t GetHits() const { return m_hits; }
+    uint32_t GetMisses() const { return m_misses; }
+
+private:
+    ShaderCache() = default;
+    ShaderCache(const ShaderCache&) = delete;
+    ShaderCache& operator=(const ShaderCache&) = delete;
+
+    std::string GetPath(uint64_t key) const;
+
+    struct Header {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t key;
+        uint32_t format;       // GLenum from glGetProgramBinary
+        uint32_t length;       // Bytes of binary after the header
+    };
+
+    static constexpr uint32_t MAGIC = 0x42505347;   // "GSPB"
+    static constexpr uint32_t VERSION = 1;
+
+private:
+    bool m_enabled = true;
+    std::string m_directory = "shader_cache/";
+
+    int m_supported = -1;        // -1 = not queried yet
+    uint64_t m_driverHash = 0;
+
+    uint32_t m_hits = 0;
+    uint32_t m_misses = 0;
+};
+
+} // namespace Genesis
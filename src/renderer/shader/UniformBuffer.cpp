@@ -0,0 +1,119 @@
+#include "UniformBuffer.h"
+#include <glad/glad.h>
+#include <iostream>
+
+namespace Genesis {
+
+// ============================================================================
+// Uniform Buffer Implementation
+// ============================================================================
+
+UniformBuffer::~UniformBuffer() {
+    Release();
+}
+
+UniformBuffer::UniformBuffer(UniformBuffer&& other) noexcept
+    : m_ubo(other.m_ubo)
+    , m_size(other.m_size)
+{
+    other.m_ubo = 0;
+    other.m_size = 0;
+}
+
+UniformBuffer& UniformBuffer::operator=(UniformBuffer&& other) noexcept {
+    if (this != &other) {
+        Release();
+        m_ubo = other.m_ubo;
+        m_size = other.m_size;
+        other.m_ubo = 0;
+        other.m_size = 0;
+    }
+    return *this;
+}
+
+bool UniformBuffer::Create(size_t sizeBytes) {
+    Release();
+
+    glGenBuffers(1, &m_ubo);
+    if (m_ubo == 0) {
+        std::cerr << "[UniformBuffer] Failed to create buffer" << std::endl;
+        return false;
+    }
+
+    glBindBuffer(GL_UNIFORM_BUFFER, m_ubo);
+    glBufferData(GL_UNIFORM_BUFFER, sizeBytes, nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+    m_size = sizeBytes;
+    return true;
+}
+
+void UniformBuffer::Release() {
+    if (m_ubo != 0) {
+        glDeleteBuffers(1, &m_ubo);
+        m_ubo = 0;
+    }
+    m_size = 0;
+}
+
+void UniformBuffer::Update(const void* data, size_t sizeBytes, size_t offset) {
+    if (m_ubo == 0 || offset + sizeBytes > m_size) return;
+
+    glBindBuffer(GL_UNIFORM_BUFFER, m_ubo);
+    glBufferSubData(GL_UNIFORM_BUFFER, offset, sizeBytes, data);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+void UniformBuffer::BindBase(uint32_t binding) const {
+    if (m_ubo == 0) return;
+    glBindBufferBase(GL_UNIFORM_BUFFER, binding, m_ubo);
+}
+
+void UniformBuffer::BindRange(uint32_t binding, size_t offset, size_t sizeBytes) const {
+    if (m_ubo == 0) return;
+    glBindBufferRange(GL_UNIFORM_BUFFER, binding, m_ubo, offset, sizeBytes);
+}
+
+// ============================================================================
+// Frame Uniforms Implementation
+// ============================================================================
+
+void FrameUniforms::SetCamera(const Mat4& view, const Mat4& proj, const Vec3& cameraPos) {
+    Assign(m_data.view, view);
+    Assign(m_data.proj, proj);
+    Assign(m_data.viewProj, proj * view);
+    Assign(m_data.cameraPos, Vec4(cameraPos, 1.0f));
+}
+
+void FrameUniforms::SetLighting(const Vec3& lightDir, const Vec3& lightColor, const Vec3& ambientColor) {
+    Assign(m_data.lightDir, Vec4(glm::normalize(lightDir), 0.0f));
+    Assign(m_data.lightColor, Vec4(lightColor, 1.0f));
+    Assign(m_data.ambientColor, Vec4(ambientColor, 1.0f));
+}
+
+void FrameUniforms::SetTime(float seconds) {
+    Assign(m_data.time, Vec4(seconds, 0.0f, 0.0f, 0.0f));
+}
+
+void FrameUniforms::Upload() {
+    if (!m_buffer.IsValid()) {
+        if (!m_buffer.Create(sizeof(FrameUniformData))) return;
+
+        // Nothing else uses this binding point, so binding once is enough
+        m_buffer.BindBase(UniformBinding::Frame);
+        m_dirty = true;
+    }
+
+    if (m_dirty) {
+        m_buffer.Update(&m_data, sizeof(FrameUniformData));
+        m_dirty = false;
+        m_uploads++;
+    }
+}
+
+void FrameUniforms::Shutdown() {
+    m_buffer.Release();
+    m_dirty = true;
+}
+
+} // namespace Genesis
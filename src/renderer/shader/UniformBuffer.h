@@ -0,0 +1,175 @@
+#pragma once
+
+#include "math/Math.h"
+#include <cstdint>
+#include <cstddef>
+
+namespace Genesis {
+
+// ============================================================================
+// Uniform Block Binding Points - Fixed for the whole engine
+//
+// GLSL 330 has no layout(binding = N), so Shader assigns these by block name
+// right after linking.
+// ============================================================================
+namespace UniformBinding {
+    constexpr uint32_t Frame = 0;
+    constexpr uint32_t Material = 1;
+    constexpr uint32_t Shadow = 2;
+    constexpr uint32_t Lights = 3;
+}
+
+// Texture units of engine-wide samplers, assigned by Shader after linking
+namespace TextureUnit {
+    constexpr int Lightmap = 11;      // sampler2DArray u_Lightmap
+    constexpr int LightGrid = 12;     // usamplerBuffer u_LightGrid
+    constexpr int LightIndices = 13;  // usamplerBuffer u_LightIndices
+    constexpr int Lights = 14;        // samplerBuffer u_Lights
+    constexpr int ShadowMap = 15;     // sampler2DArrayShadow u_ShadowMap
+}
+
+// ============================================================================
+// Uniform Buffer - Owns a GL uniform buffer object
+// ============================================================================
+class UniformBuffer {
+public:
+    UniformBuffer() = default;
+    ~UniformBuffer();
+
+    // Non-copyable, movable
+    UniformBuffer(const UniformBuffer&) = delete;
+    UniformBuffer& operator=(const UniformBuffer&) = delete;
+    UniformBuffer(UniformBuffer&& other) noexcept;
+    UniformBuffer& operator=(UniformBuffer&& other) noexcept;
+
+    // Allocate sizeBytes of storage (contents undefined until Update)
+    bool Create(size_t sizeBytes);
+    void Release();
+
+    // Upload a range of the buffer
+    void Update(const void* data, size_t sizeBytes, size_t offset = 0);
+
+    // Attach the whole buffer or a range of it to a binding point
+    void BindBase(uint32_t binding) const;
+    void BindRange(uint32_t binding, size_t offset, size_t sizeBytes) const;
+
+    bool IsValid() const { return m_ubo != 0; }
+    uint32_t GetId() const { return m_ubo; }
+    size_t GetSize() const { return m_size; }
+
+private:
+    uint32_t m_ubo = 0;
+    size_t m_size = 0;
+};
+
+// ============================================================================
+// Frame Uniform Data - std140 layout of the FrameData block
+//
+// Must match the block declared in assets/shaders:
+//   layout (std140) uniform FrameData {
+//       mat4 u_View; mat4 u_Proj; mat4 u_ViewProj;
+//       vec4 u_CameraPos; vec4 u_LightDir; vec4 u_LightColor;
+//       vec4 u_AmbientColor; vec4 u_Time;
+//   };
+// ============================================================================
+struct FrameUniformData {
+    Mat4 view = Mat4(1.0f);
+    Mat4 proj = Mat4(1.0f);
+    Mat4 viewProj = Mat4(1.0f);
+    Vec4 cameraPos = Vec4(0.0f);     // xyz = camera position
+    Vec4 lightDir = Vec4(0.0f);      // xyz = normalized direction towards the light
+    Vec4 lightColor = Vec4(0.0f);    // rgb = color * intensity
+    Vec4 ambientColor = Vec4(0.0f);  // rgb = color * intensity
+    Vec4 time = Vec4(0.0f);          // x = seconds since startup
+};
+static_assert(sizeof(FrameUniformData) == 3 * 64 + 5 * 16, "FrameUniformData must match std140 layout");
+
+// ============================================================================
+// Shadow Uniform Data - std140 layout of the ShadowData block
+//
+// Written by CascadedShadowMap (renderer/world/CascadedShadows.h):
+//   layout (std140) uniform ShadowData {
+//       mat4 u_ShadowMatrices[4];
+//       vec4 u_CascadeSplits; vec4 u_CascadeTexel; vec4 u_ShadowParams;
+//   };
+// ============================================================================
+struct ShadowUniformData {
+    static constexpr const char* BLOCK_NAME = "ShadowData";
+    static constexpr uint32_t MAX_CASCADES = 4;
+
+    Mat4 matrices[MAX_CASCADES] = {Mat4(1.0f), Mat4(1.0f), Mat4(1.0f), Mat4(1.0f)};  // World -> shadow map uv/depth
+    Vec4 cascadeSplits = Vec4(0.0f); // View depth each cascade ends at
+    Vec4 cascadeTexel = Vec4(0.0f);  // World size of one texel per cascade
+    Vec4 params = Vec4(0.0f);        // x = cascade count (0 = off), y = 1 / resolution, z = normal offset in texels
+};
+static_assert(sizeof(ShadowUniformData) == 4 * 64 + 3 * 16, "ShadowUniformData must match std140 layout");
+
+// ============================================================================
+// Light Uniform Data - std140 layout of the LightData block
+//
+// Written by ClusteredLighting (renderer/world/ClusteredLighting.h):
+//   layout (std140) uniform LightData { vec4 u_ClusterParams; };
+// ============================================================================
+struct LightUniformData {
+    static constexpr const char* BLOCK_NAME = "LightData";
+
+    Vec4 params = Vec4(0.0f);        // x = slice scale, y = slice bias, z = light count (0 = off)
+};
+static_assert(sizeof(LightUniformData) == 16, "LightUniformData must match std140 layout");
+
+// ============================================================================
+// Frame Uniforms - Per-frame camera/lighting/time block shared by all shaders
+//
+// Setters only mark the block dirty when a value changes; Upload() sends it
+// once and keeps it bound at UniformBinding::Frame, so shader switches no
+// longer re-upload view/projection/lighting.
+//
+// Usage:
+//   auto& frame = FrameUniforms::Instance();
+//   frame.SetCamera(view, proj, cameraPos);
+//   frame.SetLighting(lightDir, lightColor, ambientColor);
+//   frame.Upload();
+// ============================================================================
+class FrameUniforms {
+public:
+    static FrameUniforms& Instance() {
+        static FrameUniforms instance;
+        return instance;
+    }
+
+    static constexpr const char* BLOCK_NAME = "FrameData";
+
+    void SetCamera(const Mat4& view, const Mat4& proj, const Vec3& cameraPos);
+
+    // Colors are final (already multiplied by intensity)
+    void SetLighting(const Vec3& lightDir, const Vec3& lightColor, const Vec3& ambientColor);
+
+    void SetTime(float seconds);
+
+    // Upload if anything changed (creates and binds the buffer on first use)
+    void Upload();
+
+    // Release the GL buffer (call before the context is destroyed)
+    void Shutdown();
+
+    const FrameUniformData& GetData() const { return m_data; }
+    uint32_t GetUploadCount() const { return m_uploads; }
+
+private:
+    FrameUniforms() = default;
+
+    template<typename T>
+    void Assign(T& field, const T& value) {
+        if (field != value) {
+            field = value;
+            m_dirty = true;
+        }
+    }
+
+    FrameUniformData m_data;
+    UniformBuffer m_buffer;
+    bool m_dirty = true;
+    uint32_t m_uploads = 0;
+};
+
+} // namespace Genesis
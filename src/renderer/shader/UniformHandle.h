@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+namespace Genesis {
+
+// ============================================================================
+// Uniform Handle - Hashed uniform name for string-free lookups
+//
+// The hash is computed once (at compile time for the constants below), and
+// Shader resolves it through a small table built in CacheUniforms(). Handles
+// name a uniform, not a location, so they survive shader hot reloads.
+//
+// Usage:
+//   shader.SetMat4(Uniforms::Model, transform);
+//
+//   static constexpr UniformHandle u_Tint("u_Tint");
+//   shader.SetVec3(u_Tint, tint);
+// ============================================================================
+struct UniformHandle {
+    uint32_t hash = 0;
+
+    constexpr UniformHandle() = default;
+    constexpr explicit UniformHandle(std::string_view name) : hash(Hash(name)) {}
+
+    constexpr bool IsValid() const { return hash != 0; }
+
+    constexpr bool operator==(const UniformHandle& other) const { return hash == other.hash; }
+    constexpr bool operator!=(const UniformHandle& other) const { return hash != other.hash; }
+
+    // FNV-1a. 0 is reserved for "no handle".
+    static constexpr uint32_t Hash(std::string_view name) {
+        uint32_t h = 2166136261u;
+        for (char c : name) {
+            h ^= static_cast<uint8_t>(c);
+            h *= 16777619u;
+        }
+        return h != 0 ? h : 1u;
+    }
+};
+
+// ============================================================================
+// Engine Uniforms - Names shared by the engine shaders
+// ============================================================================
+namespace Uniforms {
+    inline constexpr UniformHandle Model("u_Model");
+    inline constexpr UniformHandle View("u_View");
+    inline constexpr UniformHandle Proj("u_Proj");
+    inline constexpr UniformHandle ViewProj("u_ViewProj");
+    inline constexpr UniformHandle CameraPos("u_CameraPos");
+    inline constexpr UniformHandle LightDir("u_LightDir");
+    inline constexpr UniformHandle LightColor("u_LightColor");
+    inline constexpr UniformHandle AmbientColor("u_AmbientColor");
+    inline constexpr UniformHandle Instanced("u_Instanced");
+    inline constexpr UniformHandle Color("u_Color");
+    inline constexpr UniformHandle ShadowMap("u_ShadowMap");
+    inline constexpr UniformHandle ReceiveShadows("u_ReceiveShadows");
+    inline constexpr UniformHandle LightGrid("u_LightGrid");
+    inline constexpr UniformHandle LightIndices("u_LightIndices");
+    inline constexpr UniformHandle Lights("u_Lights");
+    inline constexpr UniformHandle Lightmap("u_Lightmap");
+}
+
+} // namespace Genesis
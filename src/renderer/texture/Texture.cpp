@@ -0,0 +1,40 @@
+#include "Texture.h"
+#include "renderer/GLState.h"
+#include "core/MemoryTracker.h"
+#include <glad/glad.h>
+
+namespace Genesis {
+
+Texture2D::~Texture2D() {
+    Release();
+}
+
+uint32_t Texture2D::GetTarget() const {
+    return IsArray() ? GL_TEXTURE_2D_ARRAY : GL_TEXTURE_2D;
+}
+
+uint64_t Texture2D::GetBindlessHandle() {
+    if (m_bindlessHandle == 0 && m_handle != 0 && GLAD_GL_ARB_bindless_texture) {
+        // The texture's sampling state is frozen from here on, which is fine:
+        // the streamer sets it once per storage
+        m_bindlessHandle = glGetTextureHandleARB(m_handle);
+        glMakeTextureHandleResidentARB(m_bindlessHandle);
+    }
+    return m_bindlessHandle;
+}
+
+void Texture2D::Release() {
+    if (m_bindlessHandle != 0) {
+        glMakeTextureHandleNonResidentARB(m_bindlessHandle);
+        m_bindlessHandle = 0;
+    }
+    if (m_handle != 0) {
+        glDeleteTextures(1, &m_handle);
+        GLStateCache::Instance().OnTextureDeleted(m_handle);
+        m_handle = 0;
+    }
+    MemoryTracker::Instance().RemoveGpu(MemoryTag::Textures, m_residentBytes);
+    m_residentBytes = 0;
+}
+
+} // namespace Genesis
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "TextureFile.h"
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Genesis {
+
+// ============================================================================
+// Texture2D - A streamed, mipmapped 2D texture
+//
+// Created by TextureStreamer::Load(). Only the levels from GetResidentMip()
+// down are in VRAM; the GL texture is reallocated whenever the streamer
+// moves that edge, so GetHandle() may change between frames (bind it when
+// drawing, don't cache it). The mip tail (levels of at most
+// TextureStreamer::TAIL_SIZE texels) is always resident.
+//
+// Renderers report how large the texture appears with RequestScreenSize();
+// the streamer turns the largest request of the frame into a wanted mip.
+//
+// TextureStreamer::LoadArray() creates a GL_TEXTURE_2D_ARRAY instead, one
+// layer per file; it streams as a whole (GetTarget() says which to bind).
+// ============================================================================
+class Texture2D {
+public:
+    Texture2D() = default;
+    ~Texture2D();
+
+    // Non-copyable (owns a GL texture)
+    Texture2D(const Texture2D&) = delete;
+    Texture2D& operator=(const Texture2D&) = delete;
+
+    uint32_t GetHandle() const { return m_handle; }
+    bool IsValid() const { return m_handle != 0; }
+
+    // GL_TEXTURE_2D, or GL_TEXTURE_2D_ARRAY for a layered texture (raw GLenum)
+    uint32_t GetTarget() const;
+    bool IsArray() const { return !m_layers.empty(); }
+    uint32_t GetLayerCount() const { return IsArray() ? static_cast<uint32_t>(m_layers.size()) : 1; }
+
+    // Resident ARB_bindless_texture handle of the current storage, created
+    // on first use; 0 without the extension. Changes with GetHandle().
+    uint64_t GetBindlessHandle();
+
+    // File path (for an array, the cache key: its layer paths joined by '|')
+    const std::string& GetPath() const { return m_path; }
+    TextureFormat GetFormat() const { return m_info.format; }
+    uint32_t GetWidth() const { return m_info.width; }
+    uint32_t GetHeight() const { return m_info.height; }
+    uint32_t GetLevelCount() const { return m_info.levelCount; }
+
+    // Streaming state
+    uint32_t GetResidentMip() const { return m_residentMip; }
+    uint32_t GetTailMip() const { return m_tailMip; }
+    uint64_t GetResidentBytes() const { return m_residentBytes; }
+
+    // On-screen size of one repeat of the texture this frame, as a fraction
+    // of the screen height (main thread; the largest call wins)
+    void RequestScreenSize(float screenFraction) {
+        m_requestedSize = std::max(m_requestedSize, screenFraction);
+    }
+
+private:
+    friend class TextureStreamer;
+
+    void Release();
+
+    struct Layer {
+        std::string path;
+        TextureFile::Info info;   // Same format, size and levels as m_info
+    };
+
+    std::string m_path;
+    TextureFile::Info m_info;
+    std::vector<Layer> m_layers;    // Empty for a plain 2D texture
+    uint32_t m_handle = 0;
+    uint64_t m_bindlessHandle = 0;
+    uint32_t m_residentMip = 0;
+    uint32_t m_tailMip = 0;
+    uint64_t m_residentBytes = 0;
+
+    // Streamer bookkeeping
+    float m_requestedSize = 0.0f;   // This frame's largest request
+    float m_wantedPixels = 0.0f;    // Held while it stays unseen
+    uint64_t m_lastSeenFrame = 0;
+    uint32_t m_wantedMip = 0;
+    uint32_t m_targetMip = 0;       // Wanted mip after the budget
+    uint32_t m_loadCount = 0;       // Load()/LoadArray() results not yet Unload()ed
+    bool m_loading = false;
+};
+
+} // namespace Genesis
@@ -0,0 +1,320 @@
+#include "TextureFile.h"
+#include <glad/glad.h>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+namespace Genesis {
+
+namespace {
+
+constexpr TextureFormatInfo FORMAT_INFOS[] = {
+    {"unknown",   0,                                        0,  0},
+    {"RGBA8",     GL_RGBA8,                                 0,  4},
+    {"RGBA8 sRGB", GL_SRGB8_ALPHA8,                         0,  4},
+    {"BC1",       GL_COMPRESSED_RGBA_S3TC_DXT1_EXT,         8,  0},
+    {"BC1 sRGB",  GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT,   8,  0},
+    {"BC2",       GL_COMPRESSED_RGBA_S3TC_DXT3_EXT,         16, 0},
+    {"BC2 sRGB",  GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT,   16, 0},
+    {"BC3",       GL_COMPRESSED_RGBA_S3TC_DXT5_EXT,         16, 0},
+    {"BC3 sRGB",  GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT,   16, 0},
+    {"BC4",       GL_COMPRESSED_RED_RGTC1,                  8,  0},
+    {"BC4 snorm", GL_COMPRESSED_SIGNED_RED_RGTC1,           8,  0},
+    {"BC5",       GL_COMPRESSED_RG_RGTC2,                   16, 0},
+    {"BC5 snorm", GL_COMPRESSED_SIGNED_RG_RGTC2,            16, 0},
+    {"BC6H",      GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT,    16, 0},
+    {"BC6H sf16", GL_COMPRESSED_RGB_BPTC_SIGNED_FLOAT,      16, 0},
+    {"BC7",       GL_COMPRESSED_RGBA_BPTC_UNORM,            16, 0},
+    {"BC7 sRGB",  GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM,      16, 0},
+};
+static_assert(sizeof(FORMAT_INFOS) / sizeof(FORMAT_INFOS[0]) == static_cast<size_t>(TextureFormat::BC7_SRGB) + 1,
+              "FORMAT_INFOS must match TextureFormat");
+
+uint32_t ReadU32(const uint8_t* p) {
+    uint32_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+uint64_t ReadU64(const uint8_t* p) {
+    uint64_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+constexpr uint32_t FourCC(char a, char b, char c, char d) {
+    return uint32_t(uint8_t(a)) | (uint32_t(uint8_t(b)) << 8) | (uint32_t(uint8_t(c)) << 16) | (uint32_t(uint8_t(d)) << 24);
+}
+
+// ============================================================================
+// DDS
+// ============================================================================
+constexpr size_t DDS_HEADER_SIZE = 4 + 124;
+constexpr size_t DDS_DX10_SIZE = 20;
+constexpr uint32_t DDSD_MIPMAPCOUNT = 0x20000;
+constexpr uint32_t DDPF_FOURCC = 0x4;
+constexpr uint32_t DDPF_RGB = 0x40;
+constexpr uint32_t DDSCAPS2_CUBEMAP = 0x200;
+constexpr uint32_t DDSCAPS2_VOLUME = 0x200000;
+
+TextureFormat FromDXGI(uint32_t dxgi) {
+    switch (dxgi) {
+        case 27: case 28: return TextureFormat::RGBA8;
+        case 29: return TextureFormat::RGBA8_SRGB;
+        case 70: case 71: return TextureFormat::BC1;
+        case 72: return TextureFormat::BC1_SRGB;
+        case 73: case 74: return TextureFormat::BC2;
+        case 75: return TextureFormat::BC2_SRGB;
+        case 76: case 77: return TextureFormat::BC3;
+        case 78: return TextureFormat::BC3_SRGB;
+        case 79: case 80: return TextureFormat::BC4;
+        case 81: return TextureFormat::BC4_SNORM;
+        case 82: case 83: return TextureFormat::BC5;
+        case 84: return TextureFormat::BC5_SNORM;
+        case 94: case 95: return TextureFormat::BC6H_UF16;
+        case 96: return TextureFormat::BC6H_SF16;
+        case 97: case 98: return TextureFormat::BC7;
+        case 99: return TextureFormat::BC7_SRGB;
+        default: return TextureFormat::Unknown;
+    }
+}
+
+TextureFormat FromFourCC(uint32_t fourCC) {
+    switch (fourCC) {
+        case FourCC('D', 'X', 'T', '1'): return TextureFormat::BC1;
+        case FourCC('D', 'X', 'T', '2'):
+        case FourCC('D', 'X', 'T', '3'): return TextureFormat::BC2;
+        case FourCC('D', 'X', 'T', '4'):
+        case FourCC('D', 'X', 'T', '5'): return TextureFormat::BC3;
+        case FourCC('A', 'T', 'I', '1'):
+        case FourCC('B', 'C', '4', 'U'): return TextureFormat::BC4;
+        case FourCC('B', 'C', '4', 'S'): return TextureFormat::BC4_SNORM;
+        case FourCC('A', 'T', 'I', '2'):
+        case FourCC('B', 'C', '5', 'U'): return TextureFormat::BC5;
+        case FourCC('B', 'C', '5', 'S'): return TextureFormat::BC5_SNORM;
+        default: return TextureFormat::Unknown;
+    }
+}
+
+bool ParseDDS(const uint8_t* data, size_t size, TextureFile::Info& info, std::string& error) {
+    if (size < DDS_HEADER_SIZE || ReadU32(data + 4) != 124) {
+        error = "truncated DDS header";
+        return false;
+    }
+    const uint8_t* header = data + 4;
+    uint32_t flags = ReadU32(header + 4);
+    info.height = ReadU32(header + 8);
+    info.width = ReadU32(header + 12);
+    uint32_t depth = ReadU32(header + 20);
+    info.levelCount = (flags & DDSD_MIPMAPCOUNT) ? std::max(1u, ReadU32(header + 24)) : 1;
+    uint32_t pfFlags = ReadU32(header + 76);
+    uint32_t fourCC = ReadU32(header + 80);
+    uint32_t caps2 = ReadU32(header + 108);
+
+    if ((caps2 & (DDSCAPS2_CUBEMAP | DDSCAPS2_VOLUME)) || depth > 1) {
+        error = "cube maps and volume textures are not supported";
+        return false;
+    }
+
+    size_t dataOffset = DDS_HEADER_SIZE;
+    if ((pfFlags & DDPF_FOURCC) && fourCC == FourCC('D', 'X', '1', '0')) {
+        if (size < DDS_HEADER_SIZE + DDS_DX10_SIZE) {
+            error = "truncated DDS DX10 header";
+            return false;
+        }
+        const uint8_t* dx10 = data + DDS_HEADER_SIZE;
+        uint32_t dimension = ReadU32(dx10 + 4);
+        uint32_t miscFlags = ReadU32(dx10 + 8);
+        uint32_t arraySize = ReadU32(dx10 + 12);
+        if (dimension != 3 || (miscFlags & 0x4) || arraySize > 1) {
+            error = "only single 2D DDS textures are supported";
+            return false;
+        }
+        info.format = FromDXGI(ReadU32(dx10));
+        dataOffset += DDS_DX10_SIZE;
+    } else if (pfFlags & DDPF_FOURCC) {
+        info.format = FromFourCC(fourCC);
+    } else if ((pfFlags & DDPF_RGB) && ReadU32(header + 84) == 32 &&
+               ReadU32(header + 88) == 0x000000FF && ReadU32(header + 92) == 0x0000FF00 &&
+               ReadU32(header + 96) == 0x00FF0000) {
+        info.format = TextureFormat::RGBA8;
+    }
+    if (info.format == TextureFormat::Unknown) {
+        error = "unsupported DDS pixel format";
+        return false;
+    }
+
+    // Levels follow the header back to back, largest first
+    uint64_t offset = dataOffset;
+    for (uint32_t level = 0; level < info.levelCount && level < TextureFile::MAX_LEVELS; level++) {
+        TextureFile::Level& entry = info.levels[level];
+        entry.width = std::max(1u, info.width >> level);
+        entry.height = std::max(1u, info.height >> level);
+        entry.offset = offset;
+        entry.size = TextureFile::GetLevelSize(info.format, entry.width, entry.height);
+        offset += entry.size;
+    }
+    return true;
+}
+
+// ============================================================================
+// KTX2
+// ============================================================================
+constexpr uint8_t KTX2_IDENTIFIER[12] = {0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n'};
+constexpr size_t KTX2_HEADER_SIZE = 80;
+constexpr size_t KTX2_LEVEL_ENTRY_SIZE = 24;
+
+TextureFormat FromVkFormat(uint32_t vkFormat) {
+    switch (vkFormat) {
+        case 37: return TextureFormat::RGBA8;
+        case 43: return TextureFormat::RGBA8_SRGB;
+        case 131: case 133: return TextureFormat::BC1;
+        case 132: case 134: return TextureFormat::BC1_SRGB;
+        case 135: return TextureFormat::BC2;
+        case 136: return TextureFormat::BC2_SRGB;
+        case 137: return TextureFormat::BC3;
+        case 138: return TextureFormat::BC3_SRGB;
+        case 139: return TextureFormat::BC4;
+        case 140: return TextureFormat::BC4_SNORM;
+        case 141: return TextureFormat::BC5;
+        case 142: return TextureFormat::BC5_SNORM;
+        case 143: return TextureFormat::BC6H_UF16;
+        case 144: return TextureFormat::BC6H_SF16;
+        case 145: return TextureFormat::BC7;
+        case 146: return TextureFormat::BC7_SRGB;
+        default: return TextureFormat::Unknown;
+    }
+}
+
+bool ParseKTX2(const uint8_t* data, size_t size, TextureFile::Info& info, std::string& error) {
+    if (size < KTX2_HEADER_SIZE) {
+        error = "truncated KTX2 header";
+        return false;
+    }
+    uint32_t vkFormat = ReadU32(data + 12);
+    info.width = ReadU32(data + 20);
+    info.height = ReadU32(data + 24);
+    uint32_t depth = ReadU32(data + 28);
+    uint32_t layers = ReadU32(data + 32);
+    uint32_t faces = ReadU32(data + 36);
+    info.levelCount = std::max(1u, ReadU32(data + 40));
+    uint32_t supercompression = ReadU32(data + 44);
+
+    if (supercompression != 0) {
+        error = "supercompressed KTX2 (Basis/zstd) is not supported";
+        return false;
+    }
+    if (depth > 1 || layers > 1 || faces != 1 || info.height == 0) {
+        error = "only single 2D KTX2 textures are supported";
+        return false;
+    }
+    info.format = FromVkFormat(vkFormat);
+    if (info.format == TextureFormat::Unknown) {
+        error = "unsupported KTX2 vkFormat " + std::to_string(vkFormat);
+        return false;
+    }
+
+    // The level index is always base level first (the data itself is
+    // stored smallest first)
+    uint32_t count = std::min(info.levelCount, TextureFile::MAX_LEVELS);
+    if (size < KTX2_HEADER_SIZE + count * KTX2_LEVEL_ENTRY_SIZE) {
+        error = "truncated KTX2 level index";
+        return false;
+    }
+    for (uint32_t level = 0; level < count; level++) {
+        const uint8_t* entry = data + KTX2_HEADER_SIZE + level * KTX2_LEVEL_ENTRY_SIZE;
+        TextureFile::Level& out = info.levels[level];
+        out.width = std::max(1u, info.width >> level);
+        out.height = std::max(1u, info.height >> level);
+        out.offset = ReadU64(entry);
+        out.size = ReadU64(entry + 8);
+        if (out.size != TextureFile::GetLevelSize(info.format, out.width, out.height)) {
+            error = "KTX2 level " + std::to_string(level) + " has an unexpected size";
+            return false;
+        }
+    }
+    return true;
+}
+
+} // anonymous namespace
+
+namespace TextureFile {
+
+const TextureFormatInfo& GetFormatInfo(TextureFormat format) {
+    return FORMAT_INFOS[static_cast<size_t>(format)];
+}
+
+uint64_t GetLevelSize(TextureFormat format, uint32_t width, uint32_t height) {
+    const TextureFormatInfo& info = GetFormatInfo(format);
+    if (info.blockBytes == 0) {
+        return uint64_t(width) * height * info.pixelBytes;
+    }
+    uint64_t blocksX = (std::max(1u, width) + 3) / 4;
+    uint64_t blocksY = (std::max(1u, height) + 3) / 4;
+    return blocksX * blocksY * info.blockBytes;
+}
+
+bool ReadInfo(const std::string& path, Info& info, std::string& error) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) {
+        error = "cannot open file";
+        return false;
+    }
+    uint64_t fileSize = static_cast<uint64_t>(file.tellg());
+    file.seekg(0);
+
+    // Both headers (and a KTX2 level index of MAX_LEVELS) fit in here
+    uint8_t header[512] = {};
+    size_t headerSize = static_cast<size_t>(std::min<uint64_t>(fileSize, sizeof(header)));
+    if (!file.read(reinterpret_cast<char*>(header), headerSize)) {
+        error = "cannot read header";
+        return false;
+    }
+
+    info = Info();
+    bool parsed;
+    if (headerSize >= 4 && ReadU32(header) == FourCC('D', 'D', 'S', ' ')) {
+        parsed = ParseDDS(header, headerSize, info, error);
+    } else if (headerSize >= sizeof(KTX2_IDENTIFIER) && std::memcmp(header, KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER)) == 0) {
+        parsed = ParseKTX2(header, headerSize, info, error);
+    } else {
+        error = "not a DDS or KTX2 file";
+        return false;
+    }
+    if (!parsed) return false;
+
+    if (info.width == 0 || info.height == 0) {
+        error = "empty image";
+        return false;
+    }
+    info.levelCount = std::min(info.levelCount, MAX_LEVELS);
+    for (uint32_t level = 0; level < info.levelCount; level++) {
+        // Offset and size come from the file: compared apart so they can't wrap
+        const auto& range = info.levels[level];
+        if (range.offset > fileSize || range.size > fileSize - range.offset) {
+            error = "level " + std::to_string(level) + " runs past the end of the file";
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ReadLevels(const std::string& path, const Info& info, uint32_t first,
+                uint8_t* dst, const size_t* dstOffsets) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return false;
+
+    for (uint32_t level = first; level < info.levelCount; level++) {
+        const Level& entry = info.levels[level];
+        file.seekg(static_cast<std::streamoff>(entry.offset));
+        if (!file.read(reinterpret_cast<char*>(dst + dstOffsets[level - first]),
+                       static_cast<std::streamsize>(entry.size))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace TextureFile
+
+} // namespace Genesis
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace Genesis {
+
+// ============================================================================
+// Texture Formats - What the streamer can upload as is (no transcoding)
+// ============================================================================
+enum class TextureFormat : uint8_t {
+    Unknown,
+    RGBA8, RGBA8_SRGB,
+    BC1, BC1_SRGB,              // RGB (1-bit alpha variants map here too)
+    BC2, BC2_SRGB,
+    BC3, BC3_SRGB,
+    BC4, BC4_SNORM,
+    BC5, BC5_SNORM,
+    BC6H_UF16, BC6H_SF16,
+    BC7, BC7_SRGB
+};
+
+struct TextureFormatInfo {
+    const char* name;
+    uint32_t glInternalFormat;  // Raw GLenum
+    uint32_t blockBytes;        // Per 4x4 block; 0 = uncompressed
+    uint32_t pixelBytes;        // Uncompressed only
+};
+
+// ============================================================================
+// TextureFile - DDS and KTX2 headers and mip level reads
+//
+// ReadInfo() reads just the header and records where every mip level's data
+// lives in the file; ReadLevels() later reads a range of levels with plain
+// file I/O (safe on a worker thread). Only single 2D images are accepted:
+// no cube maps, arrays or volume textures, and KTX2 files must not be
+// supercompressed (Basis/zstd would need a transcoder).
+// ============================================================================
+namespace TextureFile {
+
+    static constexpr uint32_t MAX_LEVELS = 16;
+
+    struct Level {
+        uint64_t offset = 0;    // In the file
+        uint64_t size = 0;
+        uint32_t width = 0;
+        uint32_t height = 0;
+    };
+
+    struct Info {
+        TextureFormat format = TextureFormat::Unknown;
+        uint32_t width = 0;
+        uint32_t height = 0;
+        uint32_t levelCount = 0;
+        Level levels[MAX_LEVELS];   // 0 = full size
+    };
+
+    const TextureFormatInfo& GetFormatInfo(TextureFormat format);
+
+    // Bytes of one level (block formats round up to whole 4x4 blocks)
+    uint64_t GetLevelSize(TextureFormat format, uint32_t width, uint32_t height);
+
+    // Parse a DDS or KTX2 header (detected by magic). On failure error says why.
+    bool ReadInfo(const std::string& path, Info& info, std::string& error);
+
+    // Read levels [first, info.levelCount) into dst, level i at
+    // dst + dstOffsets[i - first]
+    bool ReadLevels(const std::string& path, const Info& info, uint32_t first,
+                    uint8_t* dst, const size_t* dstOffsets);
+
+} // namespace TextureFile
+
+} // namespace Genesis
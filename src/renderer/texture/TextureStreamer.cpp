@@ -0,0 +1,485 @@
+#include "TextureStreamer.h"
+#include "renderer/GLState.h"
+#include "core/Profiler.h"
+#include "core/MemoryTracker.h"
+#include <glad/glad.h>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace Genesis {
+
+namespace {
+
+constexpr size_t MIN_PIXEL_BUFFER_SIZE = 1 << 20;
+constexpr float MAX_ANISOTROPY = 8.0f;
+
+size_t AlignLevel(size_t bytes) {
+    return (bytes + 15) & ~size_t(15);
+}
+
+} // anonymous namespace
+
+// ============================================================================
+// Loading
+// ============================================================================
+
+bool TextureStreamer::IsFormatSupported(TextureFormat format) {
+    switch (format) {
+        case TextureFormat::RGBA8:
+        case TextureFormat::RGBA8_SRGB:
+        case TextureFormat::BC4:
+        case TextureFormat::BC4_SNORM:
+        case TextureFormat::BC5:
+        case TextureFormat::BC5_SNORM:
+            return true;
+        case TextureFormat::BC1:
+        case TextureFormat::BC2:
+        case TextureFormat::BC3:
+            return GLAD_GL_EXT_texture_compression_s3tc != 0;
+        case TextureFormat::BC1_SRGB:
+        case TextureFormat::BC2_SRGB:
+        case TextureFormat::BC3_SRGB:
+            return GLAD_GL_EXT_texture_compression_s3tc && GLAD_GL_EXT_texture_sRGB;
+        case TextureFormat::BC6H_UF16:
+        case TextureFormat::BC6H_SF16:
+        case TextureFormat::BC7:
+        case TextureFormat::BC7_SRGB:
+            return GLAD_GL_VERSION_4_2 || GLAD_GL_ARB_texture_compression_bptc;
+        default:
+            return false;
+    }
+}
+
+static bool ReadSupportedInfo(const std::string& path, TextureFile::Info& info) {
+    std::string error;
+    if (!TextureFile::ReadInfo(path, info, error)) {
+        std::cerr << "[TextureStreamer] " << path << ": " << error << std::endl;
+        return false;
+    }
+    if (!TextureStreamer::IsFormatSupported(info.format)) {
+        std::cerr << "[TextureStreamer] " << path << ": "
+                  << TextureFile::GetFormatInfo(info.format).name << " is not supported by this context" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+std::shared_ptr<Texture2D> TextureStreamer::Load(const std::string& path) {
+    auto it = m_cache.find(path);
+    if (it != m_cache.end()) {
+        it->second->m_loadCount++;
+        return it->second;
+    }
+
+    auto texture = std::make_shared<Texture2D>();
+    if (!ReadSupportedInfo(path, texture->m_info)) {
+        return nullptr;
+    }
+    texture->m_path = path;
+    return AddTexture(texture) ? texture : nullptr;
+}
+
+std::shared_ptr<Texture2D> TextureStreamer::LoadArray(const std::vector<std::string>& paths) {
+    if (paths.empty()) return nullptr;
+
+    std::string key;
+    for (const std::string& path : paths) {
+        if (!key.empty()) key += '|';
+        key += path;
+    }
+    auto it = m_cache.find(key);
+    if (it != m_cache.end()) {
+        it->second->m_loadCount++;
+        return it->second;
+    }
+
+    auto texture = std::make_shared<Texture2D>();
+    texture->m_layers.resize(paths.size());
+    for (size_t i = 0; i < paths.size(); i++) {
+        Texture2D::Layer& layer = texture->m_layers[i];
+        layer.path = paths[i];
+        if (!ReadSupportedInfo(layer.path, layer.info)) {
+            return nullptr;
+        }
+
+        // Layers share one storage: the same format, size and mip chain
+        const TextureFile::Info& first = texture->m_layers[0].info;
+        if (layer.info.format != first.format || layer.info.width != first.width ||
+            layer.info.height != first.height || layer.info.levelCount != first.levelCount) {
+            std::cerr << "[TextureStreamer] " << layer.path << ": does not match " << paths[0]
+                      << " (texture array layers need equal format, size and mip count)" << std::endl;
+            return nullptr;
+        }
+    }
+    texture->m_info = texture->m_layers[0].info;
+    texture->m_path = key;
+    return AddTexture(texture) ? texture : nullptr;
+}
+
+void TextureStreamer::Unload(std::shared_ptr<Texture2D>& texture) {
+    std::shared_ptr<Texture2D> dropped = std::move(texture);
+    if (!dropped || dropped->m_loadCount == 0) return;
+
+    // Counted explicitly: use_count() also sees the streamer's own holders
+    // (cache, m_textures, reads in flight)
+    if (--dropped->m_loadCount > 0) return;
+
+    // Already gone if Shutdown() ran in between
+    auto it = std::find(m_textures.begin(), m_textures.end(), dropped);
+    if (it == m_textures.end()) return;
+
+    // The read may still be writing into its mapped PBO: let every read
+    // land (the others lose this round and are requested again)
+    if (dropped->m_loading) {
+        FinishRequests(true);
+    }
+    m_textures.erase(std::find(m_textures.begin(), m_textures.end(), dropped));
+    m_cache.erase(dropped->m_path);
+    dropped->Release();
+}
+
+bool TextureStreamer::AddTexture(const std::shared_ptr<Texture2D>& texture) {
+    const TextureFile::Info& info = texture->m_info;
+    const std::string& path = texture->m_path;
+
+    // The tail starts at the first level that fits TAIL_SIZE (a texture
+    // without such a level is never streamed)
+    uint32_t tail = info.levelCount - 1;
+    for (uint32_t level = 0; level < info.levelCount; level++) {
+        if (std::max(info.levels[level].width, info.levels[level].height) <= TAIL_SIZE) {
+            tail = level;
+            break;
+        }
+    }
+    texture->m_tailMip = tail;
+
+    // A few KB (per layer): read and upload it right here
+    size_t offsets[TextureFile::MAX_LEVELS];
+    std::vector<uint8_t> data(GetLevelOffsets(*texture, tail, offsets));
+    if (!ReadLevels(*texture, tail, data.data(), offsets)) {
+        std::cerr << "[TextureStreamer] " << path << ": cannot read mip tail" << std::endl;
+        return false;
+    }
+    Upload(*texture, tail, reinterpret_cast<uintptr_t>(data.data()), offsets);
+    texture->m_wantedMip = tail;
+    texture->m_targetMip = tail;
+    texture->m_loadCount = 1;       // The caller's result
+
+    m_cache.emplace(path, texture);
+    m_textures.push_back(texture);
+    return true;
+}
+
+size_t TextureStreamer::GetLevelOffsets(const Texture2D& texture, uint32_t firstLevel, size_t* offsets) {
+    // An array level holds every layer's image back to back
+    size_t total = 0;
+    for (uint32_t level = firstLevel; level < texture.m_info.levelCount; level++) {
+        offsets[level - firstLevel] = total;
+        total += AlignLevel(static_cast<size_t>(texture.m_info.levels[level].size) * texture.GetLayerCount());
+    }
+    return total;
+}
+
+bool TextureStreamer::ReadLevels(const Texture2D& texture, uint32_t firstLevel, uint8_t* dst, const size_t* offsets) {
+    if (!texture.IsArray()) {
+        return TextureFile::ReadLevels(texture.m_path, texture.m_info, firstLevel, dst, offsets);
+    }
+
+    size_t layerOffsets[TextureFile::MAX_LEVELS];
+    for (size_t layer = 0; layer < texture.m_layers.size(); layer++) {
+        for (uint32_t level = firstLevel; level < texture.m_info.levelCount; level++) {
+            layerOffsets[level - firstLevel] = offsets[level - firstLevel] +
+                layer * static_cast<size_t>(texture.m_info.levels[level].size);
+        }
+        const Texture2D::Layer& source = texture.m_layers[layer];
+        if (!TextureFile::ReadLevels(source.path, source.info, firstLevel, dst, layerOffsets)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// ============================================================================
+// Upload
+// ============================================================================
+
+uint64_t TextureStreamer::GetBytesFrom(const Texture2D& texture, uint32_t firstLevel) {
+    uint64_t bytes = 0;
+    for (uint32_t level = firstLevel; level < texture.m_info.levelCount; level++) {
+        bytes += texture.m_info.levels[level].size;
+    }
+    return bytes * texture.GetLayerCount();
+}
+
+void TextureStreamer::Upload(Texture2D& texture, uint32_t firstLevel, uintptr_t source, const size_t* offsets) {
+    const TextureFile::Info& info = texture.m_info;
+    const TextureFormatInfo& format = TextureFile::GetFormatInfo(info.format);
+
+    GLenum target = texture.GetTarget();
+    GLsizei layers = static_cast<GLsizei>(texture.GetLayerCount());
+
+    GLuint handle = 0;
+    glGenTextures(1, &handle);
+    GLStateCache::Instance().BindTexture(0, target, handle);
+
+    for (uint32_t level = firstLevel; level < info.levelCount; level++) {
+        const TextureFile::Level& entry = info.levels[level];
+        const void* data = reinterpret_cast<const void*>(source + offsets[level - firstLevel]);
+        GLint glLevel = static_cast<GLint>(level - firstLevel);
+        GLsizei size = static_cast<GLsizei>(entry.size) * layers;
+        if (!texture.IsArray() && format.blockBytes != 0) {
+            glCompressedTexImage2D(target, glLevel, format.glInternalFormat, entry.width, entry.height, 0, size, data);
+        } else if (!texture.IsArray()) {
+            glTexImage2D(target, glLevel, format.glInternalFormat, entry.width, entry.height, 0,
+                         GL_RGBA, GL_UNSIGNED_BYTE, data);
+        } else if (format.blockBytes != 0) {
+            glCompressedTexImage3D(target, glLevel, format.glInternalFormat, entry.width, entry.height, layers, 0,
+                                   size, data);
+        } else {
+            glTexImage3D(target, glLevel, format.glInternalFormat, entry.width, entry.height, layers, 0,
+                         GL_RGBA, GL_UNSIGNED_BYTE, data);
+        }
+    }
+
+    GLint maxLevel = static_cast<GLint>(info.levelCount - 1 - firstLevel);
+    glTexParameteri(target, GL_TEXTURE_BASE_LEVEL, 0);
+    glTexParameteri(target, GL_TEXTURE_MAX_LEVEL, maxLevel);
+    glTexParameteri(target, GL_TEXTURE_MIN_FILTER, maxLevel > 0 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+    glTexParameteri(target, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(target, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(target, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    if (GLAD_GL_EXT_texture_filter_anisotropic) {
+        glTexParameterf(target, GL_TEXTURE_MAX_ANISOTROPY_EXT, MAX_ANISOTROPY);
+    }
+
+    // Swap in the new storage; the old one is freed once the GPU is done
+    texture.Release();
+    texture.m_handle = handle;
+    texture.m_residentMip = firstLevel;
+    texture.m_residentBytes = GetBytesFrom(texture, firstLevel);
+    MemoryTracker::Instance().AddGpu(MemoryTag::Textures, texture.m_residentBytes);
+}
+
+uint32_t TextureStreamer::AcquirePixelBuffer(size_t bytes) {
+    // Smallest idle buffer that fits, else grow an idle one, else a new one
+    uint32_t best = UINT32_MAX;
+    uint32_t idle = UINT32_MAX;
+    for (uint32_t i = 0; i < m_pixelBuffers.size(); i++) {
+        const PixelBuffer& pb = m_pixelBuffers[i];
+        if (pb.busy) continue;
+        idle = i;
+        if (pb.capacity >= bytes && (best == UINT32_MAX || pb.capacity < m_pixelBuffers[best].capacity)) {
+            best = i;
+        }
+    }
+    if (best == UINT32_MAX) {
+        best = idle;
+        if (best == UINT32_MAX) {
+            best = static_cast<uint32_t>(m_pixelBuffers.size());
+            m_pixelBuffers.emplace_back();
+            glGenBuffers(1, &m_pixelBuffers[best].buffer);
+        }
+        m_pixelBuffers[best].capacity = std::max(bytes, MIN_PIXEL_BUFFER_SIZE);
+    }
+    m_pixelBuffers[best].busy = true;
+    return best;
+}
+
+// ============================================================================
+// Requests
+// ============================================================================
+
+bool TextureStreamer::StartRequest(const std::shared_ptr<Texture2D>& texture, uint32_t firstLevel) {
+    auto request = std::make_unique<Request>();
+    request->texture = texture;
+    request->firstLevel = firstLevel;
+
+    size_t total = GetLevelOffsets(*texture, firstLevel, request->levelOffsets);
+
+    request->pixelBuffer = AcquirePixelBuffer(total);
+    PixelBuffer& pb = m_pixelBuffers[request->pixelBuffer];
+
+    // Orphan first: the last upload from this buffer may still be in flight
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pb.buffer);
+    glBufferData(GL_PIXEL_UNPACK_BUFFER, static_cast<GLsizeiptr>(pb.capacity), nullptr, GL_STREAM_DRAW);
+    request->mapped = static_cast<uint8_t*>(glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, static_cast<GLsizeiptr>(total),
+                                                             GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT));
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    if (!request->mapped) {
+        pb.busy = false;
+        return false;
+    }
+
+    // The mapping stays valid while the buffer isn't used by GL, so the
+    // worker can fill it directly from the file
+    Request* raw = request.get();
+    texture->m_loading = true;
+    auto& jobs = JobSystem::Instance();
+    auto read = [raw] {
+        raw->failed = !ReadLevels(*raw->texture, raw->firstLevel, raw->mapped, raw->levelOffsets);
+    };
+    if (jobs.GetWorkerCount() > 0) {
+        jobs.Submit(read, &raw->done);
+    } else {
+        read();   // No workers would only run it inside a Wait()
+    }
+
+    m_requests.push_back(std::move(request));
+    return true;
+}
+
+void TextureStreamer::FinishRequests(bool wait) {
+    for (size_t i = 0; i < m_requests.size();) {
+        Request& request = *m_requests[i];
+        if (!request.done.IsDone()) {
+            if (!wait) {
+                i++;
+                continue;
+            }
+            JobSystem::Instance().Wait(request.done);
+        }
+
+        Texture2D& texture = *request.texture;
+        PixelBuffer& pb = m_pixelBuffers[request.pixelBuffer];
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pb.buffer);
+        bool intact = glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER) == GL_TRUE;   // False if the mapping was lost
+        if (request.failed) {
+            // Stop streaming it: pin it at what is resident
+            std::cerr << "[TextureStreamer] " << texture.m_path << ": read failed" << std::endl;
+            texture.m_tailMip = texture.m_residentMip;
+        } else if (intact && !wait) {
+            Upload(texture, request.firstLevel, 0, request.levelOffsets);
+            m_stats.uploadedBytes += texture.m_residentBytes;
+        }
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+        pb.busy = false;
+        texture.m_loading = false;
+        m_requests[i] = std::move(m_requests.back());
+        m_requests.pop_back();
+    }
+}
+
+// ============================================================================
+// Update
+// ============================================================================
+
+void TextureStreamer::UpdateWantedMips(uint32_t screenHeight) {
+    uint64_t holdFrames = static_cast<uint64_t>(std::max(0, m_config.holdFrames));
+    for (const auto& pointer : m_textures) {
+        Texture2D& texture = *pointer;
+        if (texture.m_requestedSize > 0.0f) {
+            texture.m_wantedPixels = texture.m_requestedSize * static_cast<float>(screenHeight);
+            texture.m_lastSeenFrame = m_frame;
+            texture.m_requestedSize = 0.0f;
+        } else if (m_frame - texture.m_lastSeenFrame > holdFrames) {
+            texture.m_wantedPixels = 0.0f;
+        }
+
+        // One texel per pixel: mip log2(texels / pixels)
+        uint32_t wanted = texture.m_tailMip;
+        if (texture.m_wantedPixels > 0.0f) {
+            float texels = static_cast<float>(std::max(texture.m_info.width, texture.m_info.height));
+            float ratio = texels / texture.m_wantedPixels;
+            uint32_t mip = ratio > 1.0f ? static_cast<uint32_t>(std::log2(ratio)) : 0;
+            wanted = std::min(mip, texture.m_tailMip);
+        }
+        texture.m_wantedMip = wanted;
+    }
+}
+
+void TextureStreamer::ApplyBudget() {
+    uint64_t budget = static_cast<uint64_t>(std::max(0, m_config.budgetMB)) << 20;
+
+    // Lowest uniform bias that fits; the mip tails alone may not, which is
+    // as far as it goes
+    uint32_t bias = 0;
+    for (; bias < TextureFile::MAX_LEVELS; bias++) {
+        uint64_t total = 0;
+        for (const auto& texture : m_textures) {
+            total += GetBytesFrom(*texture, std::min(texture->m_wantedMip + bias, texture->m_tailMip));
+        }
+        if (bias == 0) m_stats.wantedBytes = total;
+        if (total <= budget) break;
+    }
+    m_stats.budgetBias = bias;
+
+    for (const auto& texture : m_textures) {
+        texture->m_targetMip = std::min(texture->m_wantedMip + bias, texture->m_tailMip);
+    }
+}
+
+void TextureStreamer::StartRequests() {
+    m_candidates.clear();
+    for (const auto& texture : m_textures) {
+        if (!texture->m_loading && texture->m_targetMip != texture->m_residentMip) {
+            m_candidates.push_back(texture.get());
+        }
+    }
+    if (m_candidates.empty()) return;
+
+    // Drops first (they free memory), then the largest detail deficits
+    std::sort(m_candidates.begin(), m_candidates.end(), [](const Texture2D* a, const Texture2D* b) {
+        bool dropA = a->m_targetMip > a->m_residentMip;
+        bool dropB = b->m_targetMip > b->m_residentMip;
+        if (dropA != dropB) return dropA;
+        int deficitA = static_cast<int>(a->m_residentMip) - static_cast<int>(a->m_targetMip);
+        int deficitB = static_cast<int>(b->m_residentMip) - static_cast<int>(b->m_targetMip);
+        if (deficitA != deficitB) return deficitA > deficitB;
+        return a->m_wantedPixels > b->m_wantedPixels;
+    });
+
+    uint64_t uploadBudget = static_cast<uint64_t>(std::max(1, m_config.uploadMBPerFrame)) << 20;
+    uint64_t started = 0;
+    for (Texture2D* candidate : m_candidates) {
+        if (m_requests.size() >= static_cast<size_t>(std::max(1, m_config.maxInFlight))) break;
+
+        // Always at least one, however large
+        uint64_t bytes = GetBytesFrom(*candidate, candidate->m_targetMip);
+        if (started > 0 && started + bytes > uploadBudget) continue;
+
+        const std::shared_ptr<Texture2D>& texture = m_cache.at(candidate->m_path);
+        if (StartRequest(texture, candidate->m_targetMip)) {
+            started += bytes;
+        }
+    }
+}
+
+void TextureStreamer::Update(uint32_t screenHeight) {
+    m_frame++;
+    m_stats.uploadedBytes = 0;
+    if (m_textures.empty()) return;
+    GENESIS_PROFILE_SCOPE("Texture Streaming");
+
+    FinishRequests(false);
+    UpdateWantedMips(screenHeight);
+    ApplyBudget();
+    StartRequests();
+
+    m_stats.textures = static_cast<uint32_t>(m_textures.size());
+    m_stats.inFlight = static_cast<uint32_t>(m_requests.size());
+    m_stats.residentBytes = 0;
+    for (const auto& texture : m_textures) {
+        m_stats.residentBytes += texture->m_residentBytes;
+    }
+}
+
+void TextureStreamer::Shutdown() {
+    FinishRequests(true);
+
+    for (PixelBuffer& pb : m_pixelBuffers) {
+        glDeleteBuffers(1, &pb.buffer);
+    }
+    m_pixelBuffers.clear();
+
+    // Materials may still hold the textures; they just lose their storage
+    for (const auto& texture : m_textures) {
+        texture->Release();
+    }
+    m_textures.clear();
+    m_cache.clear();
+    m_stats = TextureStreamerStats();
+}
+
+} // namespace Genesis
@@ -0,0 +1,156 @@
+#pragma once
+
+#include "Texture.h"
+#include "core/JobSystem.h"
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Genesis {
+
+struct TextureStreamerConfig {
+    int budgetMB = 256;             // VRAM for all streamed textures (r_texture_budget_mb)
+    int uploadMBPerFrame = 16;      // New requests per frame, by size (r_texture_upload_mb)
+    int maxInFlight = 4;            // Concurrent disk reads
+    int holdFrames = 120;           // Keep detail this long after the last request
+};
+
+struct TextureStreamerStats {
+    uint32_t textures = 0;
+    uint32_t inFlight = 0;
+    uint32_t budgetBias = 0;        // Mips every texture gave up to fit the budget
+    uint64_t residentBytes = 0;
+    uint64_t wantedBytes = 0;       // Before the budget
+    uint64_t uploadedBytes = 0;     // This frame
+};
+
+// ============================================================================
+// TextureStreamer - Mip residency for DDS/KTX2 textures under a VRAM budget
+//
+// Load() reads the file header and uploads only the mip tail, so loading
+// is cheap and no texture ever needs to be fully resident. Once per frame
+// Update():
+//   1. finishes reads that completed: the PBO is unmapped and the texture
+//      reallocated from it (levels [target, count));
+//   2. turns each texture's largest RequestScreenSize() into a wanted mip
+//      (one texel per pixel), holding it for holdFrames once unseen;
+//   3. finds the smallest mip bias applied to every texture that brings
+//      the wanted set under the budget;
+//   4. starts reads for textures whose resident mip differs from the
+//      target, drops first (they free memory), then the largest detail
+//      deficits, limited by maxInFlight and uploadMBPerFrame.
+//
+// Arrays (LoadArray) stream the same way; each level's upload carries all
+// of its layers.
+//
+// A read maps a pixel unpack buffer on the main thread and fills it from
+// the file on a JobSystem worker; only the upload itself touches GL. GL
+// 3.3 has no sparse or partially allocated textures, so a residency change
+// is a new texture object rather than an edit of the old one.
+//
+// Compressed formats need their extensions: BC1-3 EXT_texture_compression_
+// s3tc (sRGB also EXT_texture_sRGB), BC6H/BC7 ARB_texture_compression_bptc
+// or GL 4.2; BC4/BC5 (RGTC) are core.
+// ============================================================================
+class TextureStreamer {
+public:
+    static TextureStreamer& Instance() {
+        static TextureStreamer instance;
+        return instance;
+    }
+
+    // Edge length the always-resident mip tail starts at
+    static constexpr uint32_t TAIL_SIZE = 64;
+
+    // Cached by path; nullptr if the file can't be read or the format isn't
+    // supported by the context
+    std::shared_ptr<Texture2D> Load(const std::string& path);
+
+    // A GL_TEXTURE_2D_ARRAY with one layer per file, streamed as one
+    // texture (its largest request decides the mip of every layer). The
+    // files must share format, size and mip count. Cached by the path list;
+    // independent of Load() of the same files.
+    std::shared_ptr<Texture2D> LoadArray(const std::vector<std::string>& paths);
+
+    // Drop the caller's reference to a texture from Load()/LoadArray(); once
+    // every result of those calls is unloaded the texture leaves the cache
+    // and frees its storage (a pointer kept past that sees no storage)
+    void Unload(std::shared_ptr<Texture2D>& texture);
+
+    static bool IsFormatSupported(TextureFormat format);
+
+    // Main thread, once per frame before rendering
+    void Update(uint32_t screenHeight);
+
+    // Wait for reads in flight and release every texture's GL storage and
+    // the PBOs (call before the GL context and the JobSystem go away)
+    void Shutdown();
+
+    bool IsStreaming() const { return !m_textures.empty(); }
+
+    TextureStreamerConfig& GetConfig() { return m_config; }
+    const TextureStreamerStats& GetStats() const { return m_stats; }
+
+private:
+    TextureStreamer() = default;
+
+    struct PixelBuffer {
+        uint32_t buffer = 0;
+        size_t capacity = 0;
+        bool busy = false;
+    };
+
+    // One read in flight: levels [firstLevel, count) of texture, into a
+    // mapped PBO at levelOffsets
+    struct Request {
+        std::shared_ptr<Texture2D> texture;
+        uint32_t firstLevel = 0;
+        uint32_t pixelBuffer = 0;   // Index into m_pixelBuffers
+        uint8_t* mapped = nullptr;
+        size_t levelOffsets[TextureFile::MAX_LEVELS] = {};
+        bool failed = false;        // Written by the worker
+        JobCounter done;
+    };
+
+    static uint64_t GetBytesFrom(const Texture2D& texture, uint32_t firstLevel);
+
+    // Upload the mip tail and start tracking the texture
+    bool AddTexture(const std::shared_ptr<Texture2D>& texture);
+
+    // Staging layout of levels [firstLevel, count): offsets per level,
+    // returns the total size
+    static size_t GetLevelOffsets(const Texture2D& texture, uint32_t firstLevel, size_t* offsets);
+
+    // Read levels [firstLevel, count) of every layer (any thread)
+    static bool ReadLevels(const Texture2D& texture, uint32_t firstLevel, uint8_t* dst, const size_t* offsets);
+
+    void UpdateWantedMips(uint32_t screenHeight);
+    void ApplyBudget();
+    void StartRequests();
+    bool StartRequest(const std::shared_ptr<Texture2D>& texture, uint32_t firstLevel);
+    void FinishRequests(bool wait);
+
+    // (Re)allocate texture's GL storage from levels [firstLevel, count);
+    // level i data at source + offsets[i - firstLevel] (a PBO offset when
+    // one is bound to GL_PIXEL_UNPACK_BUFFER)
+    void Upload(Texture2D& texture, uint32_t firstLevel, uintptr_t source, const size_t* offsets);
+
+    uint32_t AcquirePixelBuffer(size_t bytes);
+
+private:
+    TextureStreamerConfig m_config;
+    TextureStreamerStats m_stats;
+
+    std::unordered_map<std::string, std::shared_ptr<Texture2D>> m_cache;
+    std::vector<std::shared_ptr<Texture2D>> m_textures;
+    std::vector<std::unique_ptr<Request>> m_requests;
+    std::vector<PixelBuffer> m_pixelBuffers;
+
+    // Per-Update scratch
+    std::vector<Texture2D*> m_candidates;
+
+    uint64_t m_frame = 0;
+};
+
+} // namespace Genesis
@@ -0,0 +1,366 @@
+#include "CascadedShadows.h"
+#include "camera/Camera.h"
+#include "core/Logger.h"
+#include "core/MemoryTracker.h"
+#include "renderer/GLState.h"
+#include <glad/glad.h>
+#include <algorithm>
+#include <cmath>
+
+namespace Genesis {
+
+static const char* g_casterVertexShader = R"(
+#version 330 core
+layout (location = 0) in vec3 aPos;
+layout (location = 8) in mat4 aInstanceModel;
+
+uniform mat4 u_LightViewProj;
+uniform mat4 u_Model;
+uniform int u_Instanced;
+
+void main() {
+    mat4 model = u_Instanced != 0 ? aInstanceModel : u_Model;
+    gl_Position = u_LightViewProj * (model * vec4(aPos, 1.0));
+}
+)";
+
+// Depth only: no color attachment, nothing to write
+static const char* g_casterFragmentShader = R"(
+#version 330 core
+void main() {
+}
+)";
+
+static constexpr UniformHandle LightViewProj("u_LightViewProj");
+
+// Clip space (GL's depth mapping of z) to shadow map uv and depth
+static const Mat4 g_clipToTexture =
+    glm::scale(glm::translate(Mat4(1.0f), Vec3(0.5f)), Vec3(0.5f));
+
+// Cascade radii are rounded up to this, so float noise in the fit doesn't
+// change the texel size
+static constexpr float RADIUS_STEP = 1.0f / 16.0f;
+
+// ============================================================================
+// Resources
+// ============================================================================
+
+bool CascadedShadowMap::Initialize() {
+    if (IsInitialized()) return true;
+
+    if (!m_casterShader.IsValid() &&
+        !m_casterShader.LoadFromSource(g_casterVertexShader, g_casterFragmentShader, "shadow_caster")) {
+        LOG_ERROR("Shadows", "Failed to build the shadow caster shader");
+        return false;
+    }
+
+    if (!CreateTargets(std::clamp(m_config.resolution, 256, 8192))) {
+        return false;
+    }
+
+    LOG_INFO("Shadows", "Cascaded shadow map: " + std::to_string(m_resolution) + "^2 x " +
+             std::to_string(std::clamp(m_config.cascades, 1, static_cast<int>(MAX_CASCADES))) + " cascades");
+    return true;
+}
+
+void CascadedShadowMap::Shutdown() {
+    ReleaseTargets();
+    m_casterShader = Shader();
+    m_buffer.Release();
+    m_cascadeCount = 0;
+    m_data.params.x = 0.0f;
+    m_dataDirty = true;
+    InvalidateAll();
+}
+
+bool CascadedShadowMap::CreateTargets(int resolution) {
+    ReleaseTargets();
+
+    // Every layer is allocated, so changing the cascade count is free
+    auto& gl = GLStateCache::Instance();
+    glGenTextures(1, &m_texture);
+    gl.BindTexture(TEXTURE_UNIT, GL_TEXTURE_2D_ARRAY, m_texture);
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_DEPTH_COMPONENT24, resolution, resolution, MAX_CASCADES, 0,
+                 GL_DEPTH_COMPONENT, GL_UNSIGNED_INT, nullptr);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+    const float border[4] = {1.0f, 1.0f, 1.0f, 1.0f};   // Outside the map = lit
+    glTexParameterfv(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_BORDER_COLOR, border);
+
+    // Hardware compare: bilinear filtering then gives 2x2 PCF per tap
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+
+    GLint previous = 0;
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previous);
+    glGenFramebuffers(1, &m_framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+    glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, m_texture, 0, 0);
+    glDrawBuffer(GL_NONE);
+    glReadBuffer(GL_NONE);
+    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    glBindFramebuffer(GL_FRAMEBUFFER, static_cast<GLuint>(previous));
+
+    if (status != GL_FRAMEBUFFER_COMPLETE) {
+        LOG_ERROR("Shadows", "Shadow framebuffer incomplete (status " + std::to_string(status) + ")");
+        ReleaseTargets();
+        return false;
+    }
+
+    m_resolution = resolution;
+    MemoryTracker::Instance().AddGpu(MemoryTag::Textures, GetTextureBytes());
+    m_dataDirty = true;
+    InvalidateAll();
+    return true;
+}
+
+void CascadedShadowMap::ReleaseTargets() {
+    if (m_framebuffer != 0) {
+        glDeleteFramebuffers(1, &m_framebuffer);
+        m_framebuffer = 0;
+    }
+    if (m_texture != 0) {
+        GLStateCache::Instance().OnTextureDeleted(m_texture);
+        glDeleteTextures(1, &m_texture);
+        m_texture = 0;
+        MemoryTracker::Instance().RemoveGpu(MemoryTag::Textures, GetTextureBytes());
+    }
+    m_resolution = 0;
+}
+
+// ============================================================================
+// Cascades
+// ============================================================================
+
+void CascadedShadowMap::Invalidate(const AABB& bounds) {
+    if (m_allDirty) return;
+    if (m_dirtyBounds.size() >= MAX_DIRTY_BOUNDS) {
+        InvalidateAll();
+        return;
+    }
+    m_dirtyBounds.push_back(bounds);
+}
+
+void CascadedShadowMap::InvalidateAll() {
+    m_allDirty = true;
+    m_dirtyBounds.clear();
+}
+
+bool CascadedShadowMap::ConfigChanged() const {
+    const ShadowConfig& a = m_config;
+    const ShadowConfig& b = m_appliedConfig;
+    return a.cascades != b.cascades || a.distance != b.distance || a.splitLambda != b.splitLambda ||
+           a.cacheMargin != b.cacheMargin || a.slopeBias != b.slopeBias || a.constantBias != b.constantBias;
+}
+
+uint32_t CascadedShadowMap::Update(const FPSCamera& camera, const Vec3& lightDir) {
+    m_pending = 0;
+    m_cascadesRendered = 0;
+    if (!IsInitialized()) return 0;
+
+    int resolution = std::clamp(m_config.resolution, 256, 8192);
+    if (resolution != m_resolution && !CreateTargets(resolution)) {
+        Shutdown();
+        return 0;
+    }
+    if (ConfigChanged()) {
+        InvalidateAll();
+        m_appliedConfig = m_config;
+    }
+
+    // A new sun turns every layer
+    Vec3 dir = Math::Length(lightDir) > Math::EPSILON ? Math::Normalize(lightDir) : Vec3(0.0f, 1.0f, 0.0f);
+    if (Math::Dot(dir, m_lightDir) < 0.99999f) {
+        m_lightDir = dir;
+        Vec3 up = std::abs(dir.y) > 0.99f ? Vec3(0.0f, 0.0f, 1.0f) : Vec3(0.0f, 1.0f, 0.0f);
+        m_lightView = Math::LookAt(Vec3(0.0f), -dir, up);
+        InvalidateAll();
+    }
+
+    FitCascades(camera);
+
+    for (uint32_t c = 0; c < m_cascadeCount; c++) {
+        Cascade& cascade = m_cascades[c];
+        bool keep = cascade.valid && !m_allDirty;
+
+        // The slice's sphere must still lie inside the rendered box
+        if (keep) {
+            Vec3 offset = glm::abs(cascade.center - cascade.cachedCenter);
+            float reach = std::max(offset.x, std::max(offset.y, offset.z)) + cascade.radius;
+            keep = reach <= cascade.cachedRadius;
+        }
+        for (size_t i = 0; keep && i < m_dirtyBounds.size(); i++) {
+            keep = !cascade.casterFrustum.Intersects(m_dirtyBounds[i]);
+        }
+        if (keep) continue;
+
+        RenderLayout(cascade);
+        cascade.valid = false;   // Until BeginCascade draws it
+        m_pending |= 1u << c;
+
+        m_data.matrices[c] = g_clipToTexture * cascade.viewProj;
+        m_data.cascadeTexel[c] = 2.0f * cascade.cachedRadius / static_cast<float>(m_resolution);
+        m_dataDirty = true;
+    }
+    m_dirtyBounds.clear();
+    m_allDirty = false;
+
+    Vec4 splits(0.0f);
+    for (uint32_t c = 0; c < m_cascadeCount; c++) {
+        splits[c] = m_cascades[c].splitFar;
+    }
+    Vec4 params(static_cast<float>(m_cascadeCount), 1.0f / static_cast<float>(m_resolution),
+                m_config.normalOffset, 0.0f);
+    if (splits != m_data.cascadeSplits || params != m_data.params) {
+        m_data.cascadeSplits = splits;
+        m_data.params = params;
+        m_dataDirty = true;
+    }
+    return m_pending;
+}
+
+void CascadedShadowMap::FitCascades(const FPSCamera& camera) {
+    m_cascadeCount = static_cast<uint32_t>(std::clamp(m_config.cascades, 1, static_cast<int>(MAX_CASCADES)));
+
+    float nearPlane = std::max(camera.GetNearPlane(), 0.01f);
+    float farPlane = std::max(std::min(m_config.distance, camera.GetFarPlane()), nearPlane * 2.0f);
+    float lambda = std::clamp(m_config.splitLambda, 0.0f, 1.0f);
+    float tanY = std::tan(Math::Radians(camera.GetFOV()) * 0.5f);
+    float tanX = tanY * camera.GetAspectRatio();
+
+    const Vec3& eye = camera.GetPosition();
+    const Vec3& forward = camera.GetForward();
+    const Vec3& right = camera.GetRight();
+    const Vec3& up = camera.GetUp();
+
+    float splitNear = nearPlane;
+    for (uint32_t c = 0; c < m_cascadeCount; c++) {
+        float t = static_cast<float>(c + 1) / static_cast<float>(m_cascadeCount);
+        float logSplit = nearPlane * std::pow(farPlane / nearPlane, t);
+        float evenSplit = nearPlane + (farPlane - nearPlane) * t;
+        float splitFar = lambda * logSplit + (1.0f - lambda) * evenSplit;
+
+        // Bounding sphere of the slice's corners: its size doesn't depend
+        // on where the camera looks
+        Vec3 corners[8];
+        int k = 0;
+        for (float depth : {splitNear, splitFar}) {
+            for (float sx : {-1.0f, 1.0f}) {
+                for (float sy : {-1.0f, 1.0f}) {
+                    corners[k++] = eye + forward * depth + right * (sx * depth * tanX) + up * (sy * depth * tanY);
+                }
+            }
+        }
+        Vec3 center(0.0f);
+        for (const Vec3& corner : corners) center += corner;
+        center /= 8.0f;
+        float radius = 0.0f;
+        for (const Vec3& corner : corners) radius = std::max(radius, Math::Length(corner - center));
+
+        Cascade& cascade = m_cascades[c];
+        cascade.center = Vec3(m_lightView * Vec4(center, 1.0f));
+        cascade.radius = std::ceil(radius / RADIUS_STEP) * RADIUS_STEP;
+        cascade.splitFar = splitFar;
+        splitNear = splitFar;
+    }
+}
+
+void CascadedShadowMap::RenderLayout(Cascade& cascade) {
+    float margin = std::max(m_config.cacheMargin, 0.0f);
+    float radius = std::ceil(cascade.radius * (1.0f + margin) / RADIUS_STEP) * RADIUS_STEP;
+
+    // Whole texels only, so static edges land on the same texels as the
+    // box follows the camera
+    float texel = 2.0f * radius / static_cast<float>(m_resolution);
+    Vec3 center = cascade.center;
+    center.x = std::floor(center.x / texel) * texel;
+    center.y = std::floor(center.y / texel) * texel;
+
+    // The light view looks along -z: near/far are distances down it
+    Mat4 proj = Math::Ortho(center.x - radius, center.x + radius, center.y - radius, center.y + radius,
+                            -(center.z + radius), -(center.z - radius));
+    cascade.cachedCenter = center;
+    cascade.cachedRadius = radius;
+    cascade.viewProj = proj * m_lightView;
+
+    // Casters between the light and the box still shadow it
+    cascade.casterFrustum = Frustum::FromMatrix(cascade.viewProj);
+    cascade.casterFrustum.planes[Frustum::Near] = Vec4(0.0f, 0.0f, 0.0f, 1.0f);
+}
+
+// ============================================================================
+// Caster Pass
+// ============================================================================
+
+void CascadedShadowMap::BeginPass() {
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &m_savedFramebuffer);
+    glGetIntegerv(GL_VIEWPORT, m_savedViewport);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+    glViewport(0, 0, m_resolution, m_resolution);
+
+    // Two-sided: brushes are often single planes
+    auto& gl = GLStateCache::Instance();
+    gl.SetBlend(false);
+    gl.SetCulling(false);
+    gl.SetDepthTest(true);
+    gl.SetDepthWrite(true);
+
+    glEnable(GL_DEPTH_CLAMP);
+    glEnable(GL_POLYGON_OFFSET_FILL);
+    glPolygonOffset(m_config.slopeBias, m_config.constantBias);
+
+    m_casterShader.Bind();
+}
+
+void CascadedShadowMap::BeginCascade(uint32_t cascade) {
+    glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, m_texture, 0, static_cast<GLint>(cascade));
+    glClear(GL_DEPTH_BUFFER_BIT);
+
+    m_casterShader.SetMat4(LightViewProj, m_cascades[cascade].viewProj);
+    m_cascades[cascade].valid = true;
+    m_cascadesRendered++;
+    m_totalRendered++;
+}
+
+void CascadedShadowMap::EndPass() {
+    glDisable(GL_POLYGON_OFFSET_FILL);
+    glDisable(GL_DEPTH_CLAMP);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, static_cast<GLuint>(m_savedFramebuffer));
+    glViewport(m_savedViewport[0], m_savedViewport[1], m_savedViewport[2], m_savedViewport[3]);
+    GLStateCache::Instance().ApplyDefaults();
+    m_pending = 0;
+}
+
+// ============================================================================
+// Receivers
+// ============================================================================
+
+void CascadedShadowMap::BindReceivers() {
+    if (!m_buffer.IsValid()) {
+        if (!m_buffer.Create(sizeof(ShadowUniformData))) return;
+
+        // Binding 2 is this buffer's alone (per frame only Material is
+        // rebound), and Update() never touches the indexed binding
+        m_buffer.BindBase(UniformBinding::Shadow);
+        m_dataDirty = true;
+    }
+
+    if (!IsInitialized() && m_data.params.x != 0.0f) {
+        m_data.params.x = 0.0f;
+        m_dataDirty = true;
+    }
+    if (m_dataDirty) {
+        m_buffer.Update(&m_data, sizeof(ShadowUniformData));
+        m_dataDirty = false;
+    }
+
+    if (IsInitialized()) {
+        GLStateCache::Instance().BindTexture(TEXTURE_UNIT, GL_TEXTURE_2D_ARRAY, m_texture);
+    }
+}
+
+} // namespace Genesis
@@ -0,0 +1,153 @@
+#pragma once
+
+#include "math/Math.h"
+#include "math/Frustum.h"
+#include "renderer/shader/Shader.h"
+#include "renderer/shader/UniformBuffer.h"
+#include <cstdint>
+#include <vector>
+
+namespace Genesis {
+
+class FPSCamera;
+
+struct ShadowConfig {
+    int cascades = 4;               // 1..MAX_CASCADES (r_shadow_cascades)
+    int resolution = 2048;          // Texels per cascade edge (r_shadow_resolution)
+    float distance = 120.0f;        // View depth shadows reach (r_shadow_distance)
+    float splitLambda = 0.8f;       // 0 = even splits, 1 = logarithmic
+    float cacheMargin = 0.25f;      // Extra radius rendered so a cascade outlives camera motion
+    float normalOffset = 1.5f;      // Receiver offset along its normal, in texels
+    float slopeBias = 2.0f;         // glPolygonOffset of the caster pass
+    float constantBias = 4.0f;
+};
+
+// ============================================================================
+// CascadedShadowMap - Directional light shadows in a depth texture array
+//
+// The view range [near, distance] is split into cascades (a blend of even
+// and logarithmic splits); each cascade is an orthographic light view of
+// its slice's bounding sphere, one layer of a GL_TEXTURE_2D_ARRAY of depth.
+// The sphere doesn't change size as the camera turns, and its center is
+// snapped to whole texels, so the shadow edges don't shimmer.
+//
+// Static casters are cached: a layer is rendered with cacheMargin of extra
+// radius and kept until
+//   - the camera's slice leaves the rendered area,
+//   - the light direction or the config changes, or
+//   - Invalidate() reports changed caster bounds inside its volume.
+// Update() returns the layers to re-render; the owner draws its casters
+// for each between BeginPass() and EndPass(). Casters in front of a
+// cascade's near plane are flattened onto it (GL_DEPTH_CLAMP), so culling
+// ignores the near plane (GetCasterFrustum).
+//
+// Receivers read the ShadowData block (UniformBinding::Shadow) and sample
+// sampler2DArrayShadow u_ShadowMap at TEXTURE_UNIT; BindReceivers() keeps
+// both current and writes zero cascades while the map is off.
+// ============================================================================
+class CascadedShadowMap {
+public:
+    static constexpr uint32_t MAX_CASCADES = ShadowUniformData::MAX_CASCADES;
+    static constexpr int TEXTURE_UNIT = TextureUnit::ShadowMap;
+
+    CascadedShadowMap() = default;
+    ~CascadedShadowMap() = default;   // GL objects are released by Shutdown()
+
+    CascadedShadowMap(const CascadedShadowMap&) = delete;
+    CascadedShadowMap& operator=(const CascadedShadowMap&) = delete;
+
+    // Depth array, framebuffer and caster shader (needs a current context)
+    bool Initialize();
+    void Shutdown();
+    bool IsInitialized() const { return m_texture != 0; }
+
+    // Fit the cascades to the camera; bit c set = layer c must be redrawn.
+    // lightDir points towards the light.
+    uint32_t Update(const FPSCamera& camera, const Vec3& lightDir);
+
+    // Caster pass: bind the framebuffer and the depth-only state, then per
+    // layer BeginCascade() and draw with GetCasterShader() (u_Model and
+    // u_Instanced, like mesh.vert); EndPass() restores the framebuffer,
+    // viewport and default state
+    void BeginPass();
+    void BeginCascade(uint32_t cascade);
+    void EndPass();
+
+    Shader& GetCasterShader() { return m_casterShader; }
+
+    // Casters of a layer: its light volume, open towards the light
+    const Frustum& GetCasterFrustum(uint32_t cascade) const { return m_cascades[cascade].casterFrustum; }
+    uint32_t GetCascadeCount() const { return m_cascadeCount; }
+
+    // Caster geometry inside these world bounds changed (call with the old
+    // and the new bounds of a moved caster)
+    void Invalidate(const AABB& bounds);
+    void InvalidateAll();
+
+    // Upload the block if it changed, and bind it and the depth array
+    void BindReceivers();
+
+    ShadowConfig& GetConfig() { return m_config; }
+    const ShadowConfig& GetConfig() const { return m_config; }
+
+    // Layers drawn by the last Update()/EndPass(), and in total
+    uint32_t GetCascadesRendered() const { return m_cascadesRendered; }
+    uint64_t GetTotalCascadesRendered() const { return m_totalRendered; }
+
+private:
+    struct Cascade {
+        // Fit of this frame (light space): slice sphere
+        Vec3 center = Vec3(0.0f);
+        float radius = 0.0f;
+        float splitFar = 0.0f;
+
+        // What the layer holds
+        Vec3 cachedCenter = Vec3(0.0f);   // Snapped, light space
+        float cachedRadius = 0.0f;        // With the margin
+        Mat4 viewProj = Mat4(1.0f);
+        Frustum casterFrustum;
+        bool valid = false;
+    };
+
+    bool CreateTargets(int resolution);
+    void ReleaseTargets();
+    size_t GetTextureBytes() const {     // 24-bit depth is stored in 4 bytes
+        return static_cast<size_t>(m_resolution) * m_resolution * MAX_CASCADES * 4;
+    }
+    bool ConfigChanged() const;
+    void FitCascades(const FPSCamera& camera);
+    void RenderLayout(Cascade& cascade);   // Place the layer around this frame's fit
+
+private:
+    ShadowConfig m_config;
+    ShadowConfig m_appliedConfig;         // m_config as of the cached layers
+    Cascade m_cascades[MAX_CASCADES];
+    uint32_t m_cascadeCount = 0;
+    uint32_t m_pending = 0;               // Update() result, drawn by the pass
+
+    Vec3 m_lightDir = Vec3(0.0f);
+    Mat4 m_lightView = Mat4(1.0f);        // Rotation only; cascades are boxes in it
+
+    // Changed caster bounds since the last Update()
+    std::vector<AABB> m_dirtyBounds;
+    bool m_allDirty = true;
+    static constexpr size_t MAX_DIRTY_BOUNDS = 64;
+
+    uint32_t m_texture = 0;               // GL_TEXTURE_2D_ARRAY, GL_DEPTH_COMPONENT24
+    uint32_t m_framebuffer = 0;
+    int m_resolution = 0;
+    Shader m_casterShader;
+
+    // Restored by EndPass()
+    int m_savedFramebuffer = 0;
+    int m_savedViewport[4] = {};
+
+    ShadowUniformData m_data;
+    UniformBuffer m_buffer;
+    bool m_dataDirty = true;
+
+    uint32_t m_cascadesRendered = 0;
+    uint64_t m_totalRendered = 0;
+};
+
+} // namespace Genesis
@@ -0,0 +1,333 @@
+#include "ClusteredLighting.h"
+#include "camera/Camera.h"
+#include "core/Logger.h"
+#include "renderer/GLState.h"
+#include <glad/glad.h>
+#include <algorithm>
+#include <cmath>
+
+namespace Genesis {
+
+namespace {
+
+// Bounding sphere of what a light reaches: its range sphere, or for a spot
+// the sphere sector of its cone
+void GetBoundingSphere(const LocalLight& light, Vec3& center, float& radius) {
+    center = light.position;
+    radius = light.range;
+    if (light.type != LocalLightType::Spot || light.outerAngle >= 90.0f) return;
+
+    Vec3 dir = glm::normalize(light.direction);
+    float angle = glm::radians(std::max(light.outerAngle, 0.0f));
+    if (angle <= glm::radians(45.0f)) {
+        // Narrow: the sphere through the apex and the rim of the cap
+        radius = light.range / (2.0f * std::cos(angle));
+        center = light.position + dir * radius;
+    } else {
+        // Wide: the sphere around the rim circle
+        center = light.position + dir * (light.range * std::cos(angle));
+        radius = light.range * std::sin(angle);
+    }
+}
+
+// Tile index of an NDC coordinate
+int ToTile(float ndc, uint32_t tiles) {
+    int tile = static_cast<int>(std::floor((ndc * 0.5f + 0.5f) * static_cast<float>(tiles)));
+    return std::clamp(tile, 0, static_cast<int>(tiles) - 1);
+}
+
+} // anonymous namespace
+
+void ClusteredLighting::Shutdown() {
+    Release(m_lightBuffer);
+    Release(m_gridBuffer);
+    Release(m_indexBuffer);
+    m_block.Release();
+    m_lightUpload = true;
+    m_gridUpload = true;
+    m_dataDirty = true;
+}
+
+// ============================================================================
+// Lights
+// ============================================================================
+
+void ClusteredLighting::SetLights(std::vector<LocalLight> lights) {
+    if (lights.size() > MAX_LIGHTS) {
+        LOG_WARNING("Lights", std::to_string(lights.size()) + " local lights, only the first " +
+                    std::to_string(MAX_LIGHTS) + " are used");
+        lights.resize(MAX_LIGHTS);
+    }
+    m_lights = std::move(lights);
+    m_lightsDirty = true;
+    m_gridDirty = true;
+}
+
+uint32_t ClusteredLighting::AddLight(const LocalLight& light) {
+    if (m_lights.size() >= MAX_LIGHTS) {
+        LOG_WARNING("Lights", "Local light limit reached, light dropped");
+        return MAX_LIGHTS;
+    }
+    m_lights.push_back(light);
+    m_lightsDirty = true;
+    m_gridDirty = true;
+    return static_cast<uint32_t>(m_lights.size() - 1);
+}
+
+void ClusteredLighting::UpdateLight(uint32_t index, const LocalLight& light) {
+    if (index >= m_lights.size()) return;
+    m_lights[index] = light;
+    m_lightsDirty = true;
+    m_gridDirty = true;
+}
+
+void ClusteredLighting::ClearLights() {
+    m_lights.clear();
+    m_lightsDirty = true;
+    m_gridDirty = true;
+}
+
+void ClusteredLighting::PackLights() {
+    m_packed.resize(m_lights.size() * 3);
+    for (size_t i = 0; i < m_lights.size(); i++) {
+        const LocalLight& light = m_lights[i];
+
+        // Spot falloff = saturate(cos * scale + offset); points get 1
+        float scale = 0.0f;
+        float offset = 1.0f;
+        Vec3 dir = Vec3(0.0f, -1.0f, 0.0f);
+        if (light.type == LocalLightType::Spot) {
+            float cosOuter = std::cos(glm::radians(light.outerAngle));
+            float cosInner = std::cos(glm::radians(std::min(light.innerAngle, light.outerAngle)));
+            scale = 1.0f / std::max(cosInner - cosOuter, 1e-3f);
+            offset = -cosOuter * scale;
+            dir = glm::normalize(light.direction);
+        }
+
+        m_packed[i * 3 + 0] = Vec4(light.position, std::max(light.range, 0.0f));
+        m_packed[i * 3 + 1] = Vec4(light.color * light.intensity, scale);
+        m_packed[i * 3 + 2] = Vec4(dir, offset);
+    }
+    m_lightsDirty = false;
+    m_lightUpload = true;
+}
+
+// ============================================================================
+// Binning
+// ============================================================================
+
+uint32_t ClusteredLighting::GetSlice(float depth) const {
+    float slice = std::floor(std::log(std::max(depth, 1e-4f)) * m_sliceScale + m_sliceBias);
+    return static_cast<uint32_t>(std::clamp(slice, 0.0f, static_cast<float>(SLICES - 1)));
+}
+
+void ClusteredLighting::Update(const FPSCamera& camera) {
+    m_stats.rebuilt = false;
+    m_stats.lights = static_cast<uint32_t>(m_lights.size());
+
+    bool enabled = m_config.enabled && !m_lights.empty();
+    Mat4 view = camera.GetViewMatrix();
+    Mat4 proj = camera.GetProjectionMatrix();
+    float nearPlane = camera.GetNearPlane();
+    float distance = std::max(m_config.distance, nearPlane * 2.0f);
+
+    if (!m_gridDirty && enabled == m_binnedEnabled && distance == m_binnedDistance &&
+        view == m_binnedView && proj == m_binnedProj) {
+        return;
+    }
+    m_binnedView = view;
+    m_binnedProj = proj;
+    m_binnedDistance = distance;
+    m_binnedEnabled = enabled;
+    m_gridDirty = false;
+
+    uint32_t lightCount = 0;
+    if (enabled) {
+        if (m_lightsDirty) {
+            PackLights();
+        }
+        BinLights(view, proj, nearPlane, distance);
+        lightCount = static_cast<uint32_t>(m_lights.size());
+        m_stats.rebuilt = true;
+    } else {
+        m_stats.visibleLights = 0;
+        m_stats.indices = 0;
+        m_stats.maxPerCluster = 0;
+    }
+
+    Vec4 params(m_sliceScale, m_sliceBias, static_cast<float>(lightCount), 0.0f);
+    if (params != m_data.params) {
+        m_data.params = params;
+        m_dataDirty = true;
+    }
+}
+
+void ClusteredLighting::BinLights(const Mat4& view, const Mat4& proj, float nearPlane, float farPlane) {
+    // Slice s covers view depth [near * (far/near)^(s/S), near * (far/near)^((s+1)/S))
+    float logRatio = std::log(farPlane / nearPlane);
+    m_sliceScale = static_cast<float>(SLICES) / logRatio;
+    m_sliceBias = -static_cast<float>(SLICES) * std::log(nearPlane) / logRatio;
+    for (uint32_t s = 0; s <= SLICES; s++) {
+        m_sliceDepth[s] = nearPlane * std::exp(logRatio * static_cast<float>(s) / static_cast<float>(SLICES));
+    }
+
+    // View space x / depth to NDC x (the offsets are 0 unless the frustum
+    // is asymmetric)
+    float scaleX = proj[0][0], offsetX = proj[2][0];
+    float scaleY = proj[1][1], offsetY = proj[2][1];
+
+    m_spans.clear();
+    m_grid.assign(CLUSTER_COUNT * 2, 0);
+    uint32_t visible = 0;
+
+    for (size_t i = 0; i < m_lights.size(); i++) {
+        Vec3 worldCenter;
+        float radius = 0.0f;
+        GetBoundingSphere(m_lights[i], worldCenter, radius);
+        if (radius <= 0.0f) continue;
+
+        Vec3 center = Vec3(view * Vec4(worldCenter, 1.0f));
+        float depth = -center.z;
+        if (depth + radius <= nearPlane) continue;   // Behind the camera
+
+        uint32_t firstSlice = GetSlice(std::max(depth - radius, nearPlane));
+        uint32_t lastSlice = GetSlice(depth + radius);
+        bool binned = false;
+
+        for (uint32_t s = firstSlice; s <= lastSlice; s++) {
+            // The part of the sphere's view-space box inside this slice; the
+            // last slice is open-ended
+            float nearDepth = std::max(m_sliceDepth[s], depth - radius);
+            float farDepth = s == SLICES - 1 ? depth + radius : std::min(m_sliceDepth[s + 1], depth + radius);
+            if (farDepth < nearDepth) continue;
+
+            // x / depth is smallest at the near end for a negative x, at the
+            // far end for a positive one (and the reverse for the maximum)
+            float minX = center.x - radius, maxX = center.x + radius;
+            float minY = center.y - radius, maxY = center.y + radius;
+            float ndcMinX = minX / (minX < 0.0f ? nearDepth : farDepth) * scaleX - offsetX;
+            float ndcMaxX = maxX / (maxX > 0.0f ? nearDepth : farDepth) * scaleX - offsetX;
+            float ndcMinY = minY / (minY < 0.0f ? nearDepth : farDepth) * scaleY - offsetY;
+            float ndcMaxY = maxY / (maxY > 0.0f ? nearDepth : farDepth) * scaleY - offsetY;
+            if (ndcMaxX < -1.0f || ndcMinX > 1.0f || ndcMaxY < -1.0f || ndcMinY > 1.0f) continue;
+
+            SliceSpan span;
+            span.light = static_cast<uint16_t>(i);
+            span.slice = static_cast<uint8_t>(s);
+            span.x0 = static_cast<uint8_t>(ToTile(ndcMinX, TILES_X));
+            span.x1 = static_cast<uint8_t>(ToTile(ndcMaxX, TILES_X));
+            span.y0 = static_cast<uint8_t>(ToTile(ndcMinY, TILES_Y));
+            span.y1 = static_cast<uint8_t>(ToTile(ndcMaxY, TILES_Y));
+            m_spans.push_back(span);
+            binned = true;
+
+            for (uint32_t y = span.y0; y <= span.y1; y++) {
+                for (uint32_t x = span.x0; x <= span.x1; x++) {
+                    m_grid[((s * TILES_Y + y) * TILES_X + x) * 2 + 1]++;
+                }
+            }
+        }
+        if (binned) visible++;
+    }
+
+    // Counts to offsets, then fill (spans are in light order, so each
+    // cluster's list is too)
+    uint32_t total = 0;
+    uint32_t maxCount = 0;
+    for (uint32_t c = 0; c < CLUSTER_COUNT; c++) {
+        uint32_t count = m_grid[c * 2 + 1];
+        m_grid[c * 2] = total;
+        m_grid[c * 2 + 1] = 0;
+        total += count;
+        maxCount = std::max(maxCount, count);
+    }
+
+    m_indices.resize(std::max<uint32_t>(total, 1));
+    for (const SliceSpan& span : m_spans) {
+        for (uint32_t y = span.y0; y <= span.y1; y++) {
+            for (uint32_t x = span.x0; x <= span.x1; x++) {
+                uint32_t cluster = (span.slice * TILES_Y + y) * TILES_X + x;
+                m_indices[m_grid[cluster * 2] + m_grid[cluster * 2 + 1]++] = span.light;
+            }
+        }
+    }
+
+    m_stats.visibleLights = visible;
+    m_stats.indices = total;
+    m_stats.maxPerCluster = maxCount;
+    m_gridUpload = true;
+}
+
+// ============================================================================
+// GPU
+// ============================================================================
+
+void ClusteredLighting::Upload(TextureBuffer& target, int unit, uint32_t format, const void* data, size_t bytes) {
+    bool created = target.buffer == 0;
+    if (created) {
+        glGenBuffers(1, &target.buffer);
+        glGenTextures(1, &target.texture);
+    }
+    if (bytes > target.capacity) {
+        target.capacity = std::max(bytes, target.capacity * 2);
+    }
+
+    // Orphan the previous storage so the driver doesn't stall on it
+    glBindBuffer(GL_TEXTURE_BUFFER, target.buffer);
+    glBufferData(GL_TEXTURE_BUFFER, target.capacity, nullptr, GL_DYNAMIC_DRAW);
+    glBufferSubData(GL_TEXTURE_BUFFER, 0, bytes, data);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+    // The texture follows the buffer object through reallocations
+    if (created) {
+        GLStateCache::Instance().BindTexture(static_cast<uint32_t>(unit), GL_TEXTURE_BUFFER, target.texture);
+        glTexBuffer(GL_TEXTURE_BUFFER, format, target.buffer);
+    }
+}
+
+void ClusteredLighting::Release(TextureBuffer& target) {
+    if (target.texture != 0) {
+        GLStateCache::Instance().OnTextureDeleted(target.texture);
+        glDeleteTextures(1, &target.texture);
+        target.texture = 0;
+    }
+    if (target.buffer != 0) {
+        glDeleteBuffers(1, &target.buffer);
+        target.buffer = 0;
+    }
+    target.capacity = 0;
+}
+
+void ClusteredLighting::Bind() {
+    if (!m_block.IsValid()) {
+        if (!m_block.Create(sizeof(LightUniformData))) return;
+
+        // UniformBinding::Lights (3) isn't shared: materials rebind only
+        // Material (1), the grid and light list go through texture units
+        m_block.BindBase(UniformBinding::Lights);
+        m_dataDirty = true;
+    }
+    if (m_dataDirty) {
+        m_block.Update(&m_data, sizeof(LightUniformData));
+        m_dataDirty = false;
+    }
+    if (m_data.params.z == 0.0f) return;
+
+    if (m_lightUpload) {
+        Upload(m_lightBuffer, TextureUnit::Lights, GL_RGBA32F, m_packed.data(), m_packed.size() * sizeof(Vec4));
+        m_lightUpload = false;
+    }
+    if (m_gridUpload) {
+        Upload(m_gridBuffer, TextureUnit::LightGrid, GL_RG32UI, m_grid.data(), m_grid.size() * sizeof(uint32_t));
+        Upload(m_indexBuffer, TextureUnit::LightIndices, GL_R16UI, m_indices.data(),
+               m_indices.size() * sizeof(uint16_t));
+        m_gridUpload = false;
+    }
+
+    auto& gl = GLStateCache::Instance();
+    gl.BindTexture(TextureUnit::Lights, GL_TEXTURE_BUFFER, m_lightBuffer.texture);
+    gl.BindTexture(TextureUnit::LightGrid, GL_TEXTURE_BUFFER, m_gridBuffer.texture);
+    gl.BindTexture(TextureUnit::LightIndices, GL_TEXTURE_BUFFER, m_indexBuffer.texture);
+}
+
+} // namespace Genesis
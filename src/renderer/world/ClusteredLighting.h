@@ -0,0 +1,158 @@
+#pragma once
+
+#include "math/Math.h"
+#include "renderer/shader/UniformBuffer.h"
+#include <cstdint>
+#include <vector>
+
+namespace Genesis {
+
+class FPSCamera;
+
+enum class LocalLightType : uint8_t {
+    Point,
+    Spot
+};
+
+// A point or spot light of the world (map "light" / "light_spot" entities)
+struct LocalLight {
+    LocalLightType type = LocalLightType::Point;
+    Vec3 position = Vec3(0.0f);
+    Vec3 color = Vec3(1.0f);
+    float intensity = 1.0f;
+    float range = 10.0f;                      // Reaches zero here
+    Vec3 direction = Vec3(0.0f, -1.0f, 0.0f); // Spot: where it shines
+    float innerAngle = 30.0f;                 // Spot: full brightness inside (half angle, degrees)
+    float outerAngle = 45.0f;                 // Spot: dark outside (half angle, degrees)
+};
+
+struct ClusterConfig {
+    bool enabled = true;            // r_lights
+    float distance = 200.0f;        // View depth the last slice starts beyond (r_light_distance)
+};
+
+struct ClusterStats {
+    uint32_t lights = 0;
+    uint32_t visibleLights = 0;     // In at least one cluster
+    uint32_t indices = 0;           // Light references over all clusters
+    uint32_t maxPerCluster = 0;
+    bool rebuilt = false;           // This frame's grid was binned (not reused)
+};
+
+// ============================================================================
+// ClusteredLighting - Point/spot lights binned into a froxel grid
+//
+// The view frustum is divided into CLUSTER_TILES_X x CLUSTER_TILES_Y
+// screen tiles and CLUSTER_SLICES depth slices (exponential in view depth
+// from the near plane to distance, the last one open-ended). Update() bins
+// every light's bounding sphere into the clusters it overlaps, per slice
+// within the tile range its view-space box covers, and produces
+//   - a grid of (first index, count) per cluster,
+//   - one light index list the grid points into, and
+//   - the lights themselves, in world space.
+// Fragments find their cluster from clip space and loop over that
+// cluster's list only, so the per-pixel cost tracks the lights that reach
+// the pixel rather than the lights in the map.
+//
+// GL 3.3 has no compute shaders or storage buffers, so binning runs on the
+// CPU and the three arrays are buffer textures (texelFetch in mesh.frag).
+// The grid is only rebuilt when the camera or the lights change.
+//
+// Receivers read the LightData block (UniformBinding::Lights) and the
+// TextureUnit::LightGrid / LightIndices / Lights buffer textures; Bind()
+// keeps them current and writes zero lights while disabled.
+// ============================================================================
+class ClusteredLighting {
+public:
+    // CLUSTER_* in the shaders
+    static constexpr uint32_t TILES_X = 16;
+    static constexpr uint32_t TILES_Y = 9;
+    static constexpr uint32_t SLICES = 24;
+    static constexpr uint32_t CLUSTER_COUNT = TILES_X * TILES_Y * SLICES;
+
+    // Light indices are 16 bits in the shaders
+    static constexpr uint32_t MAX_LIGHTS = 65535;
+
+    ClusteredLighting() = default;
+    ~ClusteredLighting() = default;   // GL objects are released by Shutdown()
+
+    ClusteredLighting(const ClusteredLighting&) = delete;
+    ClusteredLighting& operator=(const ClusteredLighting&) = delete;
+
+    void Shutdown();
+
+    // Lights beyond MAX_LIGHTS are dropped
+    void SetLights(std::vector<LocalLight> lights);
+    uint32_t AddLight(const LocalLight& light);   // Index for UpdateLight
+    void UpdateLight(uint32_t index, const LocalLight& light);
+    void ClearLights();
+    const std::vector<LocalLight>& GetLights() const { return m_lights; }
+
+    // Bin the lights for the camera (skipped when nothing changed)
+    void Update(const FPSCamera& camera);
+
+    // Upload what changed, and bind the block and the buffer textures
+    void Bind();
+
+    ClusterConfig& GetConfig() { return m_config; }
+    const ClusterStats& GetStats() const { return m_stats; }
+
+private:
+    // One GL buffer and the buffer texture over it
+    struct TextureBuffer {
+        uint32_t buffer = 0;
+        uint32_t texture = 0;
+        size_t capacity = 0;        // Bytes
+    };
+
+    void PackLights();
+    void BinLights(const Mat4& view, const Mat4& proj, float nearPlane, float farPlane);
+    uint32_t GetSlice(float depth) const;
+
+    static void Upload(TextureBuffer& target, int unit, uint32_t format, const void* data, size_t bytes);
+    static void Release(TextureBuffer& target);
+
+private:
+    ClusterConfig m_config;
+    ClusterStats m_stats;
+
+    std::vector<LocalLight> m_lights;
+    bool m_lightsDirty = true;      // m_packed is stale
+    bool m_gridDirty = true;        // Rebin even if the camera didn't move
+
+    // Camera the grid was binned for
+    Mat4 m_binnedView = Mat4(0.0f);
+    Mat4 m_binnedProj = Mat4(0.0f);
+    float m_binnedDistance = 0.0f;
+    bool m_binnedEnabled = false;
+
+    // Exponential slicing: slice = log(depth) * scale + bias
+    float m_sliceScale = 0.0f;
+    float m_sliceBias = 0.0f;
+    float m_sliceDepth[SLICES + 1] = {};
+
+    // CPU copies; three RGBA32F texels per light
+    std::vector<Vec4> m_packed;
+    std::vector<uint32_t> m_grid;           // (first, count) per cluster
+    std::vector<uint16_t> m_indices;
+
+    // Binning scratch: per visible light and slice, its tile rectangle
+    struct SliceSpan {
+        uint16_t light;
+        uint8_t slice;
+        uint8_t x0, x1, y0, y1;
+    };
+    std::vector<SliceSpan> m_spans;
+
+    TextureBuffer m_lightBuffer;    // GL_RGBA32F
+    TextureBuffer m_gridBuffer;     // GL_RG32UI
+    TextureBuffer m_indexBuffer;    // GL_R16UI
+    bool m_lightUpload = true;
+    bool m_gridUpload = true;
+
+    LightUniformData m_data;
+    UniformBuffer m_block;
+    bool m_dataDirty = true;
+};
+
+} // namespace Genesis
@@ -0,0 +1,146 @@
+#include "DepthPrepass.h"
+#include "core/Logger.h"
+#include "renderer/GLState.h"
+#include "renderer/material/Material.h"
+#include <glad/glad.h>
+
+namespace Genesis {
+
+// Same inputs, FrameData block and gl_Position as mesh.vert
+static const char* g_prepassVertexShader = R"(
+#version 330 core
+layout (location = 0) in vec3 aPos;
+layout (location = 8) in mat4 aInstanceModel;
+
+layout (std140) uniform FrameData {
+    mat4 u_View;
+    mat4 u_Proj;
+    mat4 u_ViewProj;
+    vec4 u_CameraPos;
+    vec4 u_LightDir;
+    vec4 u_LightColor;
+    vec4 u_AmbientColor;
+    vec4 u_Time;
+};
+
+uniform mat4 u_Model;
+uniform int u_Instanced;
+
+invariant gl_Position;
+
+void main() {
+    mat4 model = u_Instanced != 0 ? aInstanceModel : u_Model;
+    vec4 worldPos = model * vec4(aPos, 1.0);
+    gl_Position = u_Proj * u_View * worldPos;
+}
+)";
+
+// Depth only: color writes are masked off
+static const char* g_prepassFragmentShader = R"(
+#version 330 core
+void main() {
+}
+)";
+
+bool DepthPrepass::Initialize() {
+    if (IsInitialized()) return true;
+
+    if (!m_shader.LoadFromSource(g_prepassVertexShader, g_prepassFragmentShader, "depth_prepass")) {
+        LOG_ERROR("DepthPrepass", "Failed to build the depth prepass shader");
+        return false;
+    }
+    return true;
+}
+
+void DepthPrepass::Shutdown() {
+    m_shader = Shader();
+}
+
+bool DepthPrepass::CanPrepass(const Material& material) {
+    return material.GetBlendMode() == BlendMode::Opaque && material.GetDepthWrite() && material.GetDepthTest() &&
+           static_cast<int>(material.GetRenderQueue()) < static_cast<int>(RenderQueue::AlphaTest);
+}
+
+void DepthPrepass::BeginPass() {
+    auto& gl = GLStateCache::Instance();
+    gl.SetBlend(false);
+    gl.SetDepthTest(true);
+    gl.SetDepthWrite(true);
+    gl.SetDepthFunc(GL_LESS);
+    glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+
+    m_shader.Bind();
+}
+
+void DepthPrepass::EndPass() {
+    glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+    m_shader.Unbind();
+}
+
+// ============================================================================
+// Overdraw
+// ============================================================================
+
+void DepthPrepass::SetMeasureOverdraw(bool enabled) {
+    if (enabled == m_measure) return;
+    m_measure = enabled;
+    if (enabled) return;
+
+    if (m_active) {
+        glEndQuery(GL_SAMPLES_PASSED);
+        m_active = false;
+    }
+    for (Measurement& measurement : m_measurements) {
+        if (measurement.query != 0) {
+            glDeleteQueries(1, &measurement.query);
+        }
+        measurement = Measurement();
+    }
+    m_overdraw = 0.0f;
+    m_samples = 0;
+}
+
+void DepthPrepass::BeginMeasure() {
+    if (!m_measure || m_active) return;
+
+    // The slot issued FRAME_LATENCY frames ago is read before it's reused
+    m_frame++;
+    Collect();
+
+    Measurement& measurement = m_measurements[m_frame % FRAME_LATENCY];
+    if (measurement.query == 0) {
+        glGenQueries(1, &measurement.query);
+    }
+    GLint viewport[4] = {};
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    measurement.pixels = static_cast<uint64_t>(viewport[2]) * static_cast<uint64_t>(viewport[3]);
+    measurement.pending = true;
+
+    glBeginQuery(GL_SAMPLES_PASSED, measurement.query);
+    m_active = true;
+}
+
+void DepthPrepass::EndMeasure() {
+    if (!m_active) return;
+    glEndQuery(GL_SAMPLES_PASSED);
+    m_active = false;
+}
+
+void DepthPrepass::Collect() {
+    Measurement& measurement = m_measurements[m_frame % FRAME_LATENCY];
+    if (!measurement.pending) return;
+    measurement.pending = false;
+
+    GLint available = 0;
+    glGetQueryObjectiv(measurement.query, GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available || measurement.pixels == 0) {
+        return;
+    }
+
+    GLuint64 samples = 0;
+    glGetQueryObjectui64v(measurement.query, GL_QUERY_RESULT, &samples);
+    m_samples = samples;
+    m_overdraw = static_cast<float>(static_cast<double>(samples) / static_cast<double>(measurement.pixels));
+}
+
+} // namespace Genesis
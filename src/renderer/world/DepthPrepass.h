@@ -0,0 +1,91 @@
+#pragma once
+
+#include "renderer/shader/Shader.h"
+#include <cstdint>
+
+namespace Genesis {
+
+class Material;
+
+// ============================================================================
+// DepthPrepass - Depth-only pass ahead of the opaque color pass
+//
+// Opaque geometry is first drawn with a position-only shader and color
+// writes off; the color pass then tests GL_EQUAL, so each pixel runs the
+// full material shader once, for the surface that ends up visible. Both
+// passes must produce bit-identical depths: gl_Position is declared
+// invariant here and in the world vertex shaders, and all of them compute
+// it as u_Proj * u_View * (model * position).
+//
+// Only materials CanPrepass() accepts take part. Cutout materials would
+// need their alpha test in the depth pass and blended ones don't write
+// depth, so those are drawn by the color pass as before (GL_LEQUAL).
+//
+// Overdraw: with measuring on, a GL_SAMPLES_PASSED query around the color
+// pass counts the fragments that were shaded; divided by the viewport's
+// pixels that is the overdraw factor (1.0 = every pixel shaded once, less
+// where nothing covers the screen). Results are read FRAME_LATENCY frames
+// later, like GpuTimers, and skipped rather than waited for.
+//
+// Main thread / GL context only.
+// ============================================================================
+class DepthPrepass {
+public:
+    static constexpr uint32_t FRAME_LATENCY = 3;
+
+    DepthPrepass() = default;
+    ~DepthPrepass() = default;   // GL objects are released by Shutdown()
+
+    DepthPrepass(const DepthPrepass&) = delete;
+    DepthPrepass& operator=(const DepthPrepass&) = delete;
+
+    // Builds the shader (needs a current context). Measuring is separate:
+    // SetMeasureOverdraw(false) releases the queries
+    bool Initialize();
+    void Shutdown();
+    bool IsInitialized() const { return m_shader.IsValid(); }
+
+    // Opaque, writes and tests depth, and queued before the alpha test
+    static bool CanPrepass(const Material& material);
+
+    // Color writes off, depth writes on, GL_LESS. Draw with GetShader()
+    // (u_Model / u_Instanced as mesh.vert), applying each material's
+    // render state for its cull mode
+    void BeginPass();
+    Shader& GetShader() { return m_shader; }
+
+    // Color writes back on; the caller picks the color pass depth func
+    void EndPass();
+
+    // Overdraw of the color pass between BeginMeasure and EndMeasure
+    void SetMeasureOverdraw(bool enabled);
+    bool IsMeasuringOverdraw() const { return m_measure; }
+    void BeginMeasure();
+    void EndMeasure();
+
+    // Newest available result (0 until one is)
+    float GetOverdraw() const { return m_overdraw; }
+    uint64_t GetSamplesShaded() const { return m_samples; }
+
+private:
+    void Collect();
+
+    struct Measurement {
+        uint32_t query = 0;
+        uint64_t pixels = 0;
+        bool pending = false;
+    };
+
+private:
+    Shader m_shader;
+
+    Measurement m_measurements[FRAME_LATENCY];
+    uint32_t m_frame = 0;
+    bool m_measure = false;
+    bool m_active = false;          // A query is open
+
+    float m_overdraw = 0.0f;
+    uint64_t m_samples = 0;
+};
+
+} // namespace Genesis
@@ -0,0 +1,175 @@
+#include "GpuCulling.h"
+#include "core/Logger.h"
+#include "core/Profiler.h"
+#include "renderer/GLState.h"
+#include <glad/glad.h>
+
+namespace Genesis {
+
+static const char* g_cullComputeShader = R"(
+#version 430 core
+layout (local_size_x = 64) in;
+
+struct CullObject {
+    vec4 boundsMin;   // w = 1 if the object may be drawn
+    vec4 boundsMax;
+};
+
+struct DrawCommand {
+    uint count;
+    uint instanceCount;
+    uint firstIndex;
+    int baseVertex;
+    uint baseInstance;
+};
+
+layout (std430, binding = 0) readonly buffer Objects {
+    CullObject objects[];
+};
+
+layout (std430, binding = 1) writeonly buffer Commands {
+    DrawCommand commands[];
+};
+
+uniform vec4 u_Planes[6];   // Inward normals, see math/Frustum.h
+uniform uint u_ObjectCount;
+uniform uint u_FrustumCulling;
+
+void main() {
+    uint i = gl_GlobalInvocationID.x;
+    if (i >= u_ObjectCount) return;
+
+    CullObject object = objects[i];
+    bool visible = object.boundsMin.w > 0.5;
+
+    if (visible && u_FrustumCulling != 0u) {
+        vec3 center = (object.boundsMin.xyz + object.boundsMax.xyz) * 0.5;
+        vec3 extents = (object.boundsMax.xyz - object.boundsMin.xyz) * 0.5;
+        for (int p = 0; p < 6; p++) {
+            vec4 plane = u_Planes[p];
+            if (dot(plane.xyz, center) + dot(abs(plane.xyz), extents) + plane.w < 0.0) {
+                visible = false;
+                break;
+            }
+        }
+    }
+
+    commands[i].instanceCount = visible ? 1u : 0u;
+}
+)";
+
+static constexpr uint32_t CULL_GROUP_SIZE = 64;
+
+bool GpuCullPass::IsSupported() {
+    return GLAD_GL_VERSION_4_3 != 0;
+}
+
+bool GpuCullPass::Initialize() {
+    if (m_program != 0) return true;
+    if (!IsSupported()) {
+        LOG_WARNING("GpuCull", "OpenGL 4.3 not available, GPU culling disabled");
+        return false;
+    }
+
+    GLuint shader = glCreateShader(GL_COMPUTE_SHADER);
+    glShaderSource(shader, 1, &g_cullComputeShader, nullptr);
+    glCompileShader(shader);
+
+    GLint success = 0;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+    if (!success) {
+        char infoLog[1024];
+        glGetShaderInfoLog(shader, sizeof(infoLog), nullptr, infoLog);
+        LOG_ERROR("GpuCull", std::string("Cull shader compilation failed: ") + infoLog);
+        glDeleteShader(shader);
+        return false;
+    }
+
+    m_program = glCreateProgram();
+    glAttachShader(m_program, shader);
+    glLinkProgram(m_program);
+    glDeleteShader(shader);
+
+    glGetProgramiv(m_program, GL_LINK_STATUS, &success);
+    if (!success) {
+        char infoLog[1024];
+        glGetProgramInfoLog(m_program, sizeof(infoLog), nullptr, infoLog);
+        LOG_ERROR("GpuCull", std::string("Cull shader linking failed: ") + infoLog);
+        glDeleteProgram(m_program);
+        m_program = 0;
+        return false;
+    }
+
+    m_planesLocation = glGetUniformLocation(m_program, "u_Planes");
+    m_countLocation = glGetUniformLocation(m_program, "u_ObjectCount");
+    m_cullLocation = glGetUniformLocation(m_program, "u_FrustumCulling");
+
+    glGenBuffers(1, &m_objectBuffer);
+    glGenBuffers(1, &m_commandBuffer);
+
+    LOG_INFO("GpuCull", "GPU culling initialized");
+    return true;
+}
+
+void GpuCullPass::Shutdown() {
+    if (m_program != 0) {
+        glDeleteProgram(m_program);
+        GLStateCache::Instance().OnProgramDeleted(m_program);
+        m_program = 0;
+    }
+    if (m_objectBuffer != 0) {
+        glDeleteBuffers(1, &m_objectBuffer);
+        m_objectBuffer = 0;
+    }
+    if (m_commandBuffer != 0) {
+        glDeleteBuffers(1, &m_commandBuffer);
+        m_commandBuffer = 0;
+    }
+    m_objectCount = 0;
+}
+
+void GpuCullPass::SetObjects(const std::vector<GpuCullObject>& objects,
+                             const std::vector<DrawElementsIndirectCommand>& commands) {
+    if (m_program == 0 || objects.size() != commands.size()) return;
+
+    m_objectCount = static_cast<uint32_t>(objects.size());
+    if (m_objectCount == 0) return;
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_objectBuffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, objects.size() * sizeof(GpuCullObject),
+                 objects.data(), GL_DYNAMIC_DRAW);
+
+    // Written by the cull shader every frame, read as draw parameters
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_commandBuffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, commands.size() * sizeof(DrawElementsIndirectCommand),
+                 commands.data(), GL_DYNAMIC_COPY);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+void GpuCullPass::UpdateObject(uint32_t index, const GpuCullObject& object) {
+    if (m_program == 0 || index >= m_objectCount) return;
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_objectBuffer);
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, index * sizeof(GpuCullObject), sizeof(GpuCullObject), &object);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+void GpuCullPass::Dispatch(const Frustum& frustum, bool frustumCulling) {
+    if (m_program == 0 || m_objectCount == 0) return;
+    GENESIS_PROFILE_SCOPE("GPU Cull Dispatch");
+
+    GLStateCache::Instance().UseProgram(m_program);
+    glUniform4fv(m_planesLocation, Frustum::Count, &frustum.planes[0][0]);
+    glUniform1ui(m_countLocation, m_objectCount);
+    glUniform1ui(m_cullLocation, frustumCulling ? 1u : 0u);
+
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, m_objectBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, m_commandBuffer);
+
+    glDispatchCompute((m_objectCount + CULL_GROUP_SIZE - 1) / CULL_GROUP_SIZE, 1, 1);
+
+    // Make the instance counts visible to the indirect draws
+    glMemoryBarrier(GL_COMMAND_BARRIER_BIT);
+}
+
+} // namespace Genesis
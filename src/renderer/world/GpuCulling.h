@@ -0,0 +1,82 @@
+#pragma once
+
+#include "math/Math.h"
+#include "math/Frustum.h"
+#include <cstdint>
+#include <vector>
+
+namespace Genesis {
+
+// ============================================================================
+// Indirect draw command - layout fixed by glMultiDrawElementsIndirect
+// ============================================================================
+struct DrawElementsIndirectCommand {
+    uint32_t count = 0;           // Index count
+    uint32_t instanceCount = 0;   // Written by the cull shader (0 or 1)
+    uint32_t firstIndex = 0;
+    int32_t baseVertex = 0;
+    uint32_t baseInstance = 0;
+};
+
+static_assert(sizeof(DrawElementsIndirectCommand) == 20, "Indirect command layout");
+
+// ============================================================================
+// GPU cull object - std430 element, world AABB plus a visibility flag
+// ============================================================================
+struct GpuCullObject {
+    Vec4 boundsMin = Vec4(0.0f);   // w = 1 if the object may be drawn
+    Vec4 boundsMax = Vec4(0.0f);
+};
+
+// ============================================================================
+// GpuCullPass - Compute-shader frustum culling into an indirect buffer
+//
+// Object i owns command i. The CPU writes the objects and the command
+// templates once (and again only when they change); each frame Dispatch()
+// runs one thread per object that sets instanceCount to 0 or 1, so the CPU
+// cost does not grow with the object count. Callers then draw contiguous
+// command ranges with Mesh::DrawIndirect.
+//
+// Needs OpenGL 4.3 (compute shaders, SSBOs, multi-draw indirect).
+// ============================================================================
+class GpuCullPass {
+public:
+    GpuCullPass() = default;
+    ~GpuCullPass() = default;   // GL objects are released by Shutdown()
+
+    GpuCullPass(const GpuCullPass&) = delete;
+    GpuCullPass& operator=(const GpuCullPass&) = delete;
+
+    // True if the current context can run the pass
+    static bool IsSupported();
+
+    bool Initialize();
+    void Shutdown();
+    bool IsInitialized() const { return m_program != 0; }
+
+    // Replace all objects and their commands (same length)
+    void SetObjects(const std::vector<GpuCullObject>& objects,
+                    const std::vector<DrawElementsIndirectCommand>& commands);
+
+    // Patch one object's bounds/visibility in place
+    void UpdateObject(uint32_t index, const GpuCullObject& object);
+
+    // Write instance counts for this frame. Without culling only the
+    // visibility flags are applied.
+    void Dispatch(const Frustum& frustum, bool frustumCulling);
+
+    uint32_t GetCommandBuffer() const { return m_commandBuffer; }
+    uint32_t GetObjectCount() const { return m_objectCount; }
+
+private:
+    uint32_t m_program = 0;
+    uint32_t m_objectBuffer = 0;    // GpuCullObject[], binding 0
+    uint32_t m_commandBuffer = 0;   // DrawElementsIndirectCommand[], binding 1
+    uint32_t m_objectCount = 0;
+
+    int m_planesLocation = -1;
+    int m_countLocation = -1;
+    int m_cullLocation = -1;
+};
+
+} // namespace Genesis
@@ -0,0 +1,231 @@
+#include "OcclusionCulling.h"
+#include "renderer/mesh/Mesh.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace Genesis {
+
+OcclusionBuffer::OcclusionBuffer() {
+    uint32_t width = WIDTH, height = HEIGHT;
+    while (true) {
+        Level level;
+        level.width = width;
+        level.height = height;
+        level.depth.assign(static_cast<size_t>(width) * height, 0.0f);
+        m_levels.push_back(std::move(level));
+        if (width == 1 && height == 1) break;
+        width = std::max(width / 2, 1u);
+        height = std::max(height / 2, 1u);
+    }
+}
+
+void OcclusionBuffer::Begin(const Mat4& viewProj) {
+    m_viewProj = viewProj;
+    std::fill(m_levels[0].depth.begin(), m_levels[0].depth.end(), 0.0f);
+    m_trianglesRasterized = 0;
+}
+
+// ============================================================================
+// Rasterization
+// ============================================================================
+
+bool OcclusionBuffer::RasterizeMesh(const Mesh& mesh, const Mat4& model) {
+    const auto& attributes = mesh.GetLayout().GetAttributes();
+    const MeshData& vertexData = mesh.GetVertexData();
+    if (mesh.GetDrawMode() != DrawMode::Triangles || attributes.empty() ||
+        attributes[0].type != VertexAttribType::Float3 || vertexData.empty()) {
+        return false;
+    }
+
+    uint32_t stride = mesh.GetLayout().GetStride();
+    uint32_t vertexCount = mesh.GetVertexCount();
+    Mat4 transform = m_viewProj * model;
+
+    m_clipVertices.resize(vertexCount);
+    for (uint32_t v = 0; v < vertexCount; v++) {
+        float position[3];
+        std::memcpy(position, vertexData.data() + static_cast<size_t>(v) * stride + attributes[0].offset,
+                    sizeof(position));
+        m_clipVertices[v] = transform * Vec4(position[0], position[1], position[2], 1.0f);
+    }
+
+    const uint8_t* indexData = mesh.GetIndexData().data();
+    if (mesh.HasIndices()) {
+        uint32_t indexCount = mesh.GetIndexCount();
+        for (uint32_t i = 0; i + 2 < indexCount; i += 3) {
+            uint32_t tri[3];
+            for (int k = 0; k < 3; k++) {
+                if (mesh.GetIndexType() == IndexType::UInt16) {
+                    uint16_t index;
+                    std::memcpy(&index, indexData + (i + k) * sizeof(uint16_t), sizeof(index));
+                    tri[k] = index;
+                } else {
+                    std::memcpy(&tri[k], indexData + (i + k) * sizeof(uint32_t), sizeof(uint32_t));
+                }
+            }
+            if (tri[0] >= vertexCount || tri[1] >= vertexCount || tri[2] >= vertexCount) continue;
+            RasterizeTriangle(m_clipVertices[tri[0]], m_clipVertices[tri[1]], m_clipVertices[tri[2]]);
+        }
+    } else {
+        for (uint32_t v = 0; v + 2 < vertexCount; v += 3) {
+            RasterizeTriangle(m_clipVertices[v], m_clipVertices[v + 1], m_clipVertices[v + 2]);
+        }
+    }
+    return true;
+}
+
+void OcclusionBuffer::RasterizeTriangle(const Vec4& a, const Vec4& b, const Vec4& c) {
+    // Clip against the near plane (z >= -w), giving up to four vertices
+    const Vec4 input[3] = {a, b, c};
+    Vec4 polygon[4];
+    int count = 0;
+    for (int i = 0; i < 3; i++) {
+        const Vec4& current = input[i];
+        const Vec4& next = input[(i + 1) % 3];
+        float dCurrent = current.z + current.w;
+        float dNext = next.z + next.w;
+
+        if (dCurrent >= 0.0f) {
+            polygon[count++] = current;
+        }
+        if ((dCurrent >= 0.0f) != (dNext >= 0.0f)) {
+            float t = dCurrent / (dCurrent - dNext);
+            polygon[count++] = current + (next - current) * t;
+        }
+    }
+    if (count < 3) return;
+
+    Vec3 screen[4];
+    for (int i = 0; i < count; i++) {
+        float w = std::max(polygon[i].w, 1e-6f);
+        float invW = 1.0f / w;
+        screen[i] = Vec3((polygon[i].x * invW * 0.5f + 0.5f) * static_cast<float>(WIDTH),
+                         (polygon[i].y * invW * 0.5f + 0.5f) * static_cast<float>(HEIGHT),
+                         invW);
+    }
+
+    RasterizeScreen(screen[0], screen[1], screen[2]);
+    if (count == 4) {
+        RasterizeScreen(screen[0], screen[2], screen[3]);
+    }
+    m_trianglesRasterized++;
+}
+
+void OcclusionBuffer::RasterizeScreen(const Vec3& a, const Vec3& b, const Vec3& c) {
+    float area = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+    if (std::fabs(area) < 1e-8f) return;
+
+    // Rasterize both windings: occluders are opaque from either side
+    const Vec3& v0 = a;
+    const Vec3& v1 = area > 0.0f ? b : c;
+    const Vec3& v2 = area > 0.0f ? c : b;
+    float invArea = 1.0f / std::fabs(area);
+
+    int minX = std::max(static_cast<int>(std::floor(std::min({v0.x, v1.x, v2.x}))), 0);
+    int minY = std::max(static_cast<int>(std::floor(std::min({v0.y, v1.y, v2.y}))), 0);
+    int maxX = std::min(static_cast<int>(std::ceil(std::max({v0.x, v1.x, v2.x}))), static_cast<int>(WIDTH) - 1);
+    int maxY = std::min(static_cast<int>(std::ceil(std::max({v0.y, v1.y, v2.y}))), static_cast<int>(HEIGHT) - 1);
+    if (minX > maxX || minY > maxY) return;
+
+    auto edge = [](const Vec3& p, const Vec3& q, float x, float y) {
+        return (q.x - p.x) * (y - p.y) - (q.y - p.y) * (x - p.x);
+    };
+
+    std::vector<float>& depth = m_levels[0].depth;
+    for (int y = minY; y <= maxY; y++) {
+        float py = static_cast<float>(y) + 0.5f;
+        float* row = depth.data() + static_cast<size_t>(y) * WIDTH;
+        for (int x = minX; x <= maxX; x++) {
+            float px = static_cast<float>(x) + 0.5f;
+            float w0 = edge(v1, v2, px, py);
+            float w1 = edge(v2, v0, px, py);
+            float w2 = edge(v0, v1, px, py);
+            if (w0 < 0.0f || w1 < 0.0f || w2 < 0.0f) continue;
+
+            float z = (w0 * v0.z + w1 * v1.z + w2 * v2.z) * invArea;
+            row[x] = std::max(row[x], z);
+        }
+    }
+}
+
+// ============================================================================
+// Hierarchy
+// ============================================================================
+
+void OcclusionBuffer::BuildHierarchy() {
+    for (size_t l = 1; l < m_levels.size(); l++) {
+        const Level& src = m_levels[l - 1];
+        Level& dst = m_levels[l];
+        for (uint32_t y = 0; y < dst.height; y++) {
+            uint32_t y0 = std::min(y * 2, src.height - 1);
+            uint32_t y1 = std::min(y * 2 + 1, src.height - 1);
+            for (uint32_t x = 0; x < dst.width; x++) {
+                uint32_t x0 = std::min(x * 2, src.width - 1);
+                uint32_t x1 = std::min(x * 2 + 1, src.width - 1);
+                dst.depth[y * dst.width + x] = std::min(
+                    std::min(src.depth[y0 * src.width + x0], src.depth[y0 * src.width + x1]),
+                    std::min(src.depth[y1 * src.width + x0], src.depth[y1 * src.width + x1]));
+            }
+        }
+    }
+}
+
+// ============================================================================
+// Queries
+// ============================================================================
+
+bool OcclusionBuffer::IsOccluded(const AABB& bounds) const {
+    float minX = static_cast<float>(WIDTH), minY = static_cast<float>(HEIGHT);
+    float maxX = 0.0f, maxY = 0.0f;
+    float nearest = 0.0f;   // Largest 1/w of the corners
+
+    for (int i = 0; i < 8; i++) {
+        Vec3 corner((i & 1) ? bounds.max.x : bounds.min.x,
+                    (i & 2) ? bounds.max.y : bounds.min.y,
+                    (i & 4) ? bounds.max.z : bounds.min.z);
+        Vec4 clip = m_viewProj * Vec4(corner, 1.0f);
+
+        // Crosses the near plane: the camera may be inside or right at it
+        if (clip.z < -clip.w || clip.w <= 1e-6f) {
+            return false;
+        }
+
+        float invW = 1.0f / clip.w;
+        float sx = (clip.x * invW * 0.5f + 0.5f) * static_cast<float>(WIDTH);
+        float sy = (clip.y * invW * 0.5f + 0.5f) * static_cast<float>(HEIGHT);
+        minX = std::min(minX, sx);
+        minY = std::min(minY, sy);
+        maxX = std::max(maxX, sx);
+        maxY = std::max(maxY, sy);
+        nearest = std::max(nearest, invW);
+    }
+
+    // Off screen is the frustum test's business
+    if (maxX < 0.0f || maxY < 0.0f || minX >= static_cast<float>(WIDTH) || minY >= static_cast<float>(HEIGHT)) {
+        return false;
+    }
+
+    uint32_t x0 = static_cast<uint32_t>(std::clamp(minX, 0.0f, static_cast<float>(WIDTH - 1)));
+    uint32_t y0 = static_cast<uint32_t>(std::clamp(minY, 0.0f, static_cast<float>(HEIGHT - 1)));
+    uint32_t x1 = static_cast<uint32_t>(std::clamp(maxX, 0.0f, static_cast<float>(WIDTH - 1)));
+    uint32_t y1 = static_cast<uint32_t>(std::clamp(maxY, 0.0f, static_cast<float>(HEIGHT - 1)));
+
+    // Coarsest level where the rect spans at most 2x2 texels
+    uint32_t level = 0;
+    while (level + 1 < m_levels.size() && ((x1 >> level) - (x0 >> level) > 1 || (y1 >> level) - (y0 >> level) > 1)) {
+        level++;
+    }
+
+    const Level& hiz = m_levels[level];
+    for (uint32_t y = y0 >> level; y <= (y1 >> level); y++) {
+        for (uint32_t x = x0 >> level; x <= (x1 >> level); x++) {
+            if (nearest >= hiz.depth[y * hiz.width + x]) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+} // namespace Genesis
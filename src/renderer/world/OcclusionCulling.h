@@ -0,0 +1,66 @@
+#pragma once
+
+#include "math/Math.h"
+#include <cstdint>
+#include <vector>
+
+namespace Genesis {
+
+class Mesh;
+
+// ============================================================================
+// OcclusionBuffer - Software-rasterized depth with a Hi-Z pyramid
+//
+// Per frame: Begin() with the camera, rasterize the large occluders into a
+// low-resolution depth buffer, BuildHierarchy(), then IsOccluded() for each
+// candidate box. Depth is stored as 1/w (linear in screen space, larger is
+// nearer, cleared to 0 = infinitely far); each pyramid level keeps the
+// farthest depth of its 2x2 texels, so a box is hidden when its nearest
+// point is behind the farthest occluder texel under its screen rect.
+//
+// Runs on the CPU, so it works on the 3.3 context and its results are
+// available to every draw path in the same frame. Coverage is sampled at
+// texel centers: a gap narrower than a texel can be closed.
+// ============================================================================
+class OcclusionBuffer {
+public:
+    static constexpr uint32_t WIDTH = 256;
+    static constexpr uint32_t HEIGHT = 128;
+
+    OcclusionBuffer();
+
+    // Clear the depth and set the camera (projection * view)
+    void Begin(const Mat4& viewProj);
+
+    // Rasterize a mesh's triangles from its CPU-side data (Float3 position
+    // first). Returns false if the mesh can't be used as an occluder.
+    bool RasterizeMesh(const Mesh& mesh, const Mat4& model);
+
+    // Build the min-depth pyramid (after the last occluder)
+    void BuildHierarchy();
+
+    // True if the world box lies entirely behind rasterized occluders
+    bool IsOccluded(const AABB& bounds) const;
+
+    uint32_t GetTrianglesRasterized() const { return m_trianglesRasterized; }
+
+private:
+    void RasterizeTriangle(const Vec4& a, const Vec4& b, const Vec4& c);   // Clip space
+    void RasterizeScreen(const Vec3& a, const Vec3& b, const Vec3& c);     // x, y in pixels, z = 1/w
+
+private:
+    Mat4 m_viewProj = Mat4(1.0f);
+
+    // Level 0 is WIDTH x HEIGHT; each next level halves both
+    struct Level {
+        uint32_t width = 0;
+        uint32_t height = 0;
+        std::vector<float> depth;
+    };
+    std::vector<Level> m_levels;
+
+    std::vector<Vec4> m_clipVertices;   // Scratch for RasterizeMesh
+    uint32_t m_trianglesRasterized = 0;
+};
+
+} // namespace Genesis
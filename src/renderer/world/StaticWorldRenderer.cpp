@@ -1,48 +1,182 @@
 #include "StaticWorldRenderer.h"
 #include "camera/Camera.h"
 #include "renderer/shader/Shader.h"
+#include "renderer/shader/UniformBuffer.h"
 #include "core/Logger.h"
+#include "core/MemoryTracker.h"
+#include "core/Profiler.h"
+#include "renderer/GLState.h"
+#include "renderer/GpuTimer.h"
+#include "renderer/mesh/VertexCompression.h"
+#include "renderer/texture/TextureStreamer.h"
+#include "physics/PhysicsWorld.h"
+#include <glad/glad.h>
 #include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
 #include <iostream>
 
 namespace Genesis {
 
+namespace {
+
+bool SameLayout(const VertexLayout& a, const VertexLayout& b) {
+    if (a.GetStride() != b.GetStride() || a.GetAttributeCount() != b.GetAttributeCount()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.GetAttributeCount(); i++) {
+        const VertexAttribute& x = a.GetAttributes()[i];
+        const VertexAttribute& y = b.GetAttributes()[i];
+        if (x.type != y.type || x.offset != y.offset || x.normalized != y.normalized) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Upload transforms to a per-frame instance buffer, creating or growing it
+void StreamTransforms(const std::vector<Mat4>& transforms, uint32_t& vbo, size_t& capacity) {
+    if (transforms.empty()) {
+        return;
+    }
+
+    if (vbo == 0) {
+        glGenBuffers(1, &vbo);
+    }
+
+    size_t bytes = transforms.size() * sizeof(Mat4);
+    if (bytes > capacity) {
+        capacity = std::max(bytes, capacity * 2);
+    }
+
+    // Orphan the previous frame's storage so the driver doesn't stall on it
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBufferData(GL_ARRAY_BUFFER, capacity, nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, transforms.data());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+// Copy a mesh's vertices to dst in world space: positions by the full
+// transform, normals by the inverse transpose, tangents by the upper 3x3
+// (packed 10:10:10 directions are unpacked and repacked). Other attributes
+// are copied unchanged.
+void BakeVertices(const Mesh& mesh, const Mat4& transform, uint8_t* dst) {
+    const VertexLayout& layout = mesh.GetLayout();
+    const MeshData& src = mesh.GetVertexData();
+    std::memcpy(dst, src.data(), src.size());
+
+    Mat3 linear(transform);
+    Mat3 normalMatrix = glm::transpose(glm::inverse(linear));
+    uint32_t stride = layout.GetStride();
+    uint32_t count = mesh.GetVertexCount();
+
+    for (const VertexAttribute& attrib : layout.GetAttributes()) {
+        bool packed = attrib.type == VertexAttribType::Int2_10_10_10_Rev;
+        if (attrib.type != VertexAttribType::Float3 && !packed) continue;
+
+        bool isPosition = attrib.name == "position" && !packed;
+        bool isNormal = attrib.name == "normal";
+        bool isTangent = attrib.name == "tangent" || attrib.name == "bitangent";
+        if (!isPosition && !isNormal && !isTangent) continue;
+
+        for (uint32_t v = 0; v < count; v++) {
+            uint8_t* p = dst + v * stride + attrib.offset;
+
+            Vec3 value;
+            if (packed) {
+                uint32_t word;
+                std::memcpy(&word, p, sizeof(word));
+                value = VertexCompression::UnpackNormal(word);
+            } else {
+                std::memcpy(&value, p, sizeof(Vec3));
+            }
+
+            if (isPosition) {
+                value = Vec3(transform * Vec4(value, 1.0f));
+            } else {
+                value = (isNormal ? normalMatrix : linear) * value;
+                float length = glm::length(value);
+                if (length > Math::EPSILON) value /= length;
+            }
+
+            if (packed) {
+                uint32_t word = VertexCompression::PackNormal(value);
+                std::memcpy(p, &word, sizeof(word));
+            } else {
+                std::memcpy(p, &value, sizeof(Vec3));
+            }
+        }
+    }
+}
+
+} // namespace
+
 // ============================================================================
 // StaticObject Implementation
 // ============================================================================
 
-void StaticObject::UpdateWorldBounds() {
+void StaticObject::ComputeWorldBounds(const Mesh* mesh, const Mat4& transform, Vec3& outMin, Vec3& outMax) {
     if (!mesh) {
-        worldBoundsMin = Vec3(0.0f);
-        worldBoundsMax = Vec3(0.0f);
+        outMin = Vec3(0.0f);
+        outMax = Vec3(0.0f);
         return;
     }
 
-    // Get local bounds from mesh
-    Vec3 localMin = mesh->GetBoundsMin();
-    Vec3 localMax = mesh->GetBoundsMax();
-
-    // Transform all 8 corners and find new AABB
-    Vec3 corners[8] = {
-        Vec3(localMin.x, localMin.y, localMin.z),
-        Vec3(localMax.x, localMin.y, localMin.z),
-        Vec3(localMin.x, localMax.y, localMin.z),
-        Vec3(localMax.x, localMax.y, localMin.z),
-        Vec3(localMin.x, localMin.y, localMax.z),
-        Vec3(localMax.x, localMin.y, localMax.z),
-        Vec3(localMin.x, localMax.y, localMax.z),
-        Vec3(localMax.x, localMax.y, localMax.z)
-    };
+    AABB bounds = Math::TransformAABB(transform, mesh->GetBoundsMin(), mesh->GetBoundsMax());
+    outMin = bounds.min;
+    outMax = bounds.max;
+}
+
+void StaticObject::UpdateWorldBounds() {
+    ComputeWorldBounds(mesh.get(), transform, worldBoundsMin, worldBoundsMax);
+}
+
+// ============================================================================
+// Resource Tables
+// ============================================================================
 
-    worldBoundsMin = Vec3(std::numeric_limits<float>::max());
-    worldBoundsMax = Vec3(std::numeric_limits<float>::lowest());
+template<typename T>
+uint32_t StaticWorldRenderer::ResourceTable<T>::Acquire(const std::shared_ptr<T>& item) {
+    if (!item) return INVALID_INDEX;
+
+    auto it = ids.find(item.get());
+    if (it != ids.end()) {
+        refs[it->second]++;
+        return it->second;
+    }
 
-    for (const auto& corner : corners) {
-        Vec4 transformed = transform * Vec4(corner, 1.0f);
-        Vec3 worldCorner(transformed.x, transformed.y, transformed.z);
-        worldBoundsMin = glm::min(worldBoundsMin, worldCorner);
-        worldBoundsMax = glm::max(worldBoundsMax, worldCorner);
+    uint32_t id;
+    if (!freeIds.empty()) {
+        id = freeIds.back();
+        freeIds.pop_back();
+        items[id] = item;
+        refs[id] = 1;
+    } else {
+        id = static_cast<uint32_t>(items.size());
+        items.push_back(item);
+        refs.push_back(1);
     }
+    ids[item.get()] = id;
+    return id;
+}
+
+template<typename T>
+bool StaticWorldRenderer::ResourceTable<T>::Release(uint32_t id) {
+    if (id == INVALID_INDEX || --refs[id] > 0) return false;
+
+    ids.erase(items[id].get());
+    items[id] = nullptr;
+    freeIds.push_back(id);
+    return true;
+}
+
+template<typename T>
+void StaticWorldRenderer::ResourceTable<T>::Clear() {
+    items.clear();
+    refs.clear();
+    freeIds.clear();
+    ids.clear();
 }
 
 // ============================================================================
@@ -50,7 +184,12 @@ void StaticObject::UpdateWorldBounds() {
 // ============================================================================
 
 StaticWorldRenderer::StaticWorldRenderer() {
-    m_objects.reserve(1000);  // Pre-allocate for typical scene
+    // Pre-allocate for typical scene
+    m_hot.reserve(1000);
+    m_info.reserve(1000);
+    m_batchRefs.reserve(1000);
+    m_handles.Reserve(1000);
+    m_cullBounds.Reserve(1000);
     m_batches.reserve(50);    // Typical number of unique materials
 }
 
@@ -68,18 +207,90 @@ ColliderPtr StaticWorldRenderer::CreateBoxColliderFromTransform(const Mat4& tran
     return std::make_shared<BoxCollider>(scale * 0.5f);
 }
 
+// ============================================================================
+// Hot/Cold Storage
+// ============================================================================
+
+void StaticWorldRenderer::StoreObject(uint32_t index, const StaticObject& obj) {
+    StaticObjectHot& hot = m_hot[index];
+    hot.transform = obj.transform;
+    hot.mesh = m_meshes.Acquire(obj.mesh);
+    hot.material = m_materials.Acquire(obj.material);
+    hot.layer = obj.layer;
+    hot.type = obj.type;
+    hot.flags = 0;
+    if (obj.visible) hot.flags |= STATIC_OBJECT_VISIBLE;
+    if (obj.castShadow) hot.flags |= STATIC_OBJECT_CAST_SHADOW;
+    if (obj.receiveShadow) hot.flags |= STATIC_OBJECT_RECEIVE_SHADOW;
+
+    StaticObjectInfo& info = m_info[index];
+    info.name = obj.name;
+    info.collider = obj.collider;
+
+    UpdateDerived(index);
+}
+
+void StaticWorldRenderer::UpdateDerived(uint32_t index) {
+    StaticObjectHot& hot = m_hot[index];
+    StaticObjectInfo& info = m_info[index];
+    UpdateRenderBounds(index);
+
+    // The collider itself lives in the PhysicsWorld; re-register it at the
+    // new transform (the freed index is reused)
+    auto& physics = PhysicsWorld::Instance();
+    physics.RemoveCollider(info.physics);
+    info.physics = ColliderHandle();
+    if (info.collider) {
+        StaticObjectHandle handle = m_handles.GetHandle(index);
+        uint64_t userData = (static_cast<uint64_t>(handle.generation) << 32) | handle.index;
+        info.physics = physics.AddCollider(*info.collider, hot.transform, userData);
+    }
+}
+
+void StaticWorldRenderer::UpdateRenderBounds(uint32_t index) {
+    StaticObjectHot& hot = m_hot[index];
+    Vec3 boundsMin, boundsMax;
+    const Mesh* mesh = hot.mesh != INVALID_INDEX ? m_meshes.Get(hot.mesh).get() : nullptr;
+    StaticObject::ComputeWorldBounds(mesh, hot.transform, boundsMin, boundsMax);
+    m_cullBounds.Set(index, boundsMin, boundsMax);
+    hot.area = FindObjectArea(index);
+}
+
+void StaticWorldRenderer::ReleaseResources(uint32_t meshId, uint32_t materialId) {
+    m_meshes.Release(meshId);
+
+    // A recycled material id must not inherit the old material's batch
+    if (m_materials.Release(materialId) && materialId < m_materialBatch.size()) {
+        m_materialBatch[materialId] = INVALID_INDEX;
+    }
+}
+
 // ============================================================================
 // Object Management
 // ============================================================================
 
-size_t StaticWorldRenderer::Add(const StaticObject& obj) {
-    m_objects.push_back(obj);
-    m_objects.back().UpdateWorldBounds();
-    m_batchesDirty = true;
-    return m_objects.size() - 1;
+StaticObjectHandle StaticWorldRenderer::Add(const StaticObject& obj) {
+    StaticObjectHandle handle = m_handles.Insert();
+    uint32_t index = static_cast<uint32_t>(m_hot.size());
+
+    m_hot.emplace_back();
+    m_info.emplace_back();
+    m_batchRefs.emplace_back();
+    m_cullBounds.Push(Vec3(0.0f), Vec3(0.0f));
+    StoreObject(index, obj);
+    InvalidateShadows(index);
+
+    if (!m_batchesDirty) {
+        InsertIntoBatch(index);
+    }
+    m_mergeDirty = true;
+
+    // A recycled slot already has BVH leaves; a new one needs a rebuild
+    UpdateSpatialBounds(handle.index);
+    return handle;
 }
 
-size_t StaticWorldRenderer::Add(MeshPtr mesh, MaterialPtr material, const Mat4& transform) {
+StaticObjectHandle StaticWorldRenderer::Add(MeshPtr mesh, MaterialPtr material, const Mat4& transform) {
     StaticObject obj;
     obj.mesh = std::move(mesh);
     obj.material = std::move(material);
@@ -89,7 +300,7 @@ size_t StaticWorldRenderer::Add(MeshPtr mesh, MaterialPtr material, const Mat4&
     return Add(obj);
 }
 
-size_t StaticWorldRenderer::Add(MeshPtr mesh, MaterialPtr material, ColliderPtr collider, const Mat4& transform) {
+StaticObjectHandle StaticWorldRenderer::Add(MeshPtr mesh, MaterialPtr material, ColliderPtr collider, const Mat4& transform) {
     StaticObject obj;
     obj.mesh = std::move(mesh);
     obj.material = std::move(material);
@@ -99,40 +310,40 @@ size_t StaticWorldRenderer::Add(MeshPtr mesh, MaterialPtr material, ColliderPtr
     return Add(obj);
 }
 
-size_t StaticWorldRenderer::AddFloor(MeshPtr mesh, MaterialPtr material, const Mat4& transform) {
+StaticObjectHandle StaticWorldRenderer::AddFloor(MeshPtr mesh, MaterialPtr material, const Mat4& transform) {
     StaticObject obj;
     obj.mesh = std::move(mesh);
     obj.material = std::move(material);
     obj.transform = transform;
     obj.type = StaticObjectType::Floor;
-    obj.name = "Floor_" + std::to_string(m_objects.size());
+    obj.name = "Floor_" + std::to_string(m_hot.size());
     obj.collider = CreateBoxColliderFromTransform(transform);  // Auto-generate collider
     return Add(obj);
 }
 
-size_t StaticWorldRenderer::AddCeiling(MeshPtr mesh, MaterialPtr material, const Mat4& transform) {
+StaticObjectHandle StaticWorldRenderer::AddCeiling(MeshPtr mesh, MaterialPtr material, const Mat4& transform) {
     StaticObject obj;
     obj.mesh = std::move(mesh);
     obj.material = std::move(material);
     obj.transform = transform;
     obj.type = StaticObjectType::Ceiling;
-    obj.name = "Ceiling_" + std::to_string(m_objects.size());
+    obj.name = "Ceiling_" + std::to_string(m_hot.size());
     obj.collider = CreateBoxColliderFromTransform(transform);  // Auto-generate collider
     return Add(obj);
 }
 
-size_t StaticWorldRenderer::AddWall(MeshPtr mesh, MaterialPtr material, const Mat4& transform) {
+StaticObjectHandle StaticWorldRenderer::AddWall(MeshPtr mesh, MaterialPtr material, const Mat4& transform) {
     StaticObject obj;
     obj.mesh = std::move(mesh);
     obj.material = std::move(material);
     obj.transform = transform;
     obj.type = StaticObjectType::Wall;
-    obj.name = "Wall_" + std::to_string(m_objects.size());
+    obj.name = "Wall_" + std::to_string(m_hot.size());
     obj.collider = CreateBoxColliderFromTransform(transform);  // Auto-generate collider
     return Add(obj);
 }
 
-size_t StaticWorldRenderer::AddProp(const std::string& name, MeshPtr mesh, MaterialPtr material, const Mat4& transform) {
+StaticObjectHandle StaticWorldRenderer::AddProp(const std::string& name, MeshPtr mesh, MaterialPtr material, const Mat4& transform) {
     StaticObject obj;
     obj.mesh = std::move(mesh);
     obj.material = std::move(material);
@@ -143,7 +354,7 @@ size_t StaticWorldRenderer::AddProp(const std::string& name, MeshPtr mesh, Mater
     return Add(obj);
 }
 
-size_t StaticWorldRenderer::AddProp(const std::string& name, MeshPtr mesh, MaterialPtr material, ColliderPtr collider, const Mat4& transform) {
+StaticObjectHandle StaticWorldRenderer::AddProp(const std::string& name, MeshPtr mesh, MaterialPtr material, ColliderPtr collider, const Mat4& transform) {
     StaticObject obj;
     obj.mesh = std::move(mesh);
     obj.material = std::move(material);
@@ -154,7 +365,7 @@ size_t StaticWorldRenderer::AddProp(const std::string& name, MeshPtr mesh, Mater
     return Add(obj);
 }
 
-size_t StaticWorldRenderer::AddPropDecorative(const std::string& name, MeshPtr mesh, MaterialPtr material, const Mat4& transform) {
+StaticObjectHandle StaticWorldRenderer::AddPropDecorative(const std::string& name, MeshPtr mesh, MaterialPtr material, const Mat4& transform) {
     StaticObject obj;
     obj.mesh = std::move(mesh);
     obj.material = std::move(material);
@@ -165,85 +376,256 @@ size_t StaticWorldRenderer::AddPropDecorative(const std::string& name, MeshPtr m
     return Add(obj);
 }
 
-size_t StaticWorldRenderer::AddStructural(MeshPtr mesh, MaterialPtr material, const Mat4& transform) {
+StaticObjectHandle StaticWorldRenderer::AddStructural(MeshPtr mesh, MaterialPtr material, const Mat4& transform) {
     StaticObject obj;
     obj.mesh = std::move(mesh);
     obj.material = std::move(material);
     obj.transform = transform;
     obj.type = StaticObjectType::Structural;
-    obj.name = "Structural_" + std::to_string(m_objects.size());
+    obj.name = "Structural_" + std::to_string(m_hot.size());
     obj.collider = CreateBoxColliderFromTransform(transform);  // Auto-generate collider
     return Add(obj);
 }
 
 void StaticWorldRenderer::AddMany(const std::vector<StaticObject>& objects) {
-    m_objects.reserve(m_objects.size() + objects.size());
+    size_t count = m_hot.size() + objects.size();
+    m_hot.reserve(count);
+    m_info.reserve(count);
+    m_batchRefs.reserve(count);
+    m_handles.Reserve(count);
+    m_cullBounds.Reserve(count);
     for (const auto& obj : objects) {
         Add(obj);
     }
 }
 
-void StaticWorldRenderer::Remove(size_t index) {
-    if (index < m_objects.size()) {
-        m_objects.erase(m_objects.begin() + index);
-        m_batchesDirty = true;
+void StaticWorldRenderer::Remove(StaticObjectHandle handle) {
+    uint32_t index = m_handles.GetDenseIndex(handle);
+    if (index == SlotMap::INVALID_INDEX) return;
+
+    InvalidateShadows(index);
+    RemoveFromBatch(index);
+    ReleaseResources(m_hot[index].mesh, m_hot[index].material);
+    PhysicsWorld::Instance().RemoveCollider(m_info[index].physics);
+    m_handles.Remove(handle);
+
+    // Move the last object into the hole and repoint its batch entry
+    uint32_t last = static_cast<uint32_t>(m_hot.size() - 1);
+    if (index != last) {
+        m_hot[index] = m_hot[last];
+        m_info[index] = std::move(m_info[last]);
+        m_batchRefs[index] = m_batchRefs[last];
+
+        const BatchRef& ref = m_batchRefs[index];
+        if (!m_batchesDirty && ref.batch != INVALID_INDEX) {
+            m_batches[ref.batch].objects[ref.batchPos] = index;
+        }
+    }
+    m_hot.pop_back();
+    m_info.pop_back();
+    m_batchRefs.pop_back();
+    m_cullBounds.SwapRemove(index);
+    m_mergeDirty = true;
+
+    // The freed slot keeps its (now empty) BVH leaves until reused
+    UpdateSpatialBounds(handle.index);
+}
+
+void StaticWorldRenderer::Update(StaticObjectHandle handle, const StaticObject& obj) {
+    uint32_t index = m_handles.GetDenseIndex(handle);
+    if (index == SlotMap::INVALID_INDEX) return;
+
+    uint32_t oldMesh = m_hot[index].mesh;
+    uint32_t oldMaterial = m_hot[index].material;
+    const Mesh* currentMesh = oldMesh != INVALID_INDEX ? m_meshes.Get(oldMesh).get() : nullptr;
+    const Material* currentMaterial = oldMaterial != INVALID_INDEX ? m_materials.Get(oldMaterial).get() : nullptr;
+    bool rebatch = currentMaterial != obj.material.get() || currentMesh != obj.mesh.get();
+
+    if (rebatch) {
+        RemoveFromBatch(index);
     }
+
+    // Acquire the new resources before releasing the old ones, so an
+    // unchanged mesh/material keeps its id
+    InvalidateShadows(index);
+    StoreObject(index, obj);
+    InvalidateShadows(index);
+    ReleaseResources(oldMesh, oldMaterial);
+
+    if (rebatch && !m_batchesDirty) {
+        InsertIntoBatch(index);
+    }
+    m_mergeDirty = true;
+
+    UpdateSpatialBounds(handle.index);
 }
 
 void StaticWorldRenderer::Clear() {
-    m_objects.clear();
+    // Handles already stale after a PhysicsWorld::Clear() are ignored
+    auto& physics = PhysicsWorld::Instance();
+    for (const StaticObjectInfo& info : m_info) {
+        physics.RemoveCollider(info.physics);
+    }
+
+    m_hot.clear();
+    m_info.clear();
+    m_batchRefs.clear();
+    m_handles.Clear();
+    m_meshes.Clear();
+    m_materials.Clear();
     m_batches.clear();
+    m_materialBatch.clear();
+    m_cullBounds.Clear();
+    m_objectVisible.clear();
+    m_renderBVH.Clear();
+    m_renderBounds.clear();
+    m_instanceGroups.clear();
+    m_instanceTransforms.clear();
+    m_mergedGroups.clear();
+    m_materialTables.clear();
+    m_mergeRefs.clear();
+    m_mergedObjectCount = 0;
     m_batchesDirty = true;
+    m_mergeDirty = true;
+    m_bvhDirty = true;
+    m_shadows.InvalidateAll();
+    m_lights.ClearLights();
+    SetLightmap(nullptr);
     LOG_INFO("StaticWorldRenderer", "Cleared all static objects");
 }
 
-StaticObject* StaticWorldRenderer::Get(size_t index) {
-    if (index < m_objects.size()) {
-        return &m_objects[index];
+bool StaticWorldRenderer::Get(StaticObjectHandle handle, StaticObject& out) const {
+    uint32_t index = m_handles.GetDenseIndex(handle);
+    if (index == SlotMap::INVALID_INDEX) return false;
+
+    const StaticObjectHot& hot = m_hot[index];
+    const StaticObjectInfo& info = m_info[index];
+    out.mesh = hot.mesh != INVALID_INDEX ? m_meshes.Get(hot.mesh) : nullptr;
+    out.material = hot.material != INVALID_INDEX ? m_materials.Get(hot.material) : nullptr;
+    out.transform = hot.transform;
+    out.collider = info.collider;
+    out.name = info.name;
+    out.type = hot.type;
+    out.visible = hot.IsVisible();
+    out.castShadow = hot.CastsShadow();
+    out.receiveShadow = hot.ReceivesShadow();
+    out.layer = hot.layer;
+
+    AABB bounds = m_cullBounds.Get(index);
+    out.worldBoundsMin = bounds.min;
+    out.worldBoundsMax = bounds.max;
+    return true;
+}
+
+const StaticObjectHot* StaticWorldRenderer::GetHot(StaticObjectHandle handle) const {
+    uint32_t index = m_handles.GetDenseIndex(handle);
+    return index != SlotMap::INVALID_INDEX ? &m_hot[index] : nullptr;
+}
+
+const StaticObjectInfo* StaticWorldRenderer::GetInfo(StaticObjectHandle handle) const {
+    uint32_t index = m_handles.GetDenseIndex(handle);
+    return index != SlotMap::INVALID_INDEX ? &m_info[index] : nullptr;
+}
+
+const Mat4* StaticWorldRenderer::GetTransform(StaticObjectHandle handle) const {
+    const StaticObjectHot* hot = GetHot(handle);
+    return hot ? &hot->transform : nullptr;
+}
+
+void StaticWorldRenderer::SetTransform(StaticObjectHandle handle, const Mat4& transform) {
+    uint32_t index = m_handles.GetDenseIndex(handle);
+    if (index == SlotMap::INVALID_INDEX) return;
+
+    InvalidateShadows(index);
+    m_hot[index].transform = transform;
+    UpdateDerived(index);
+    FinishTransformChange(index, handle);
+}
+
+void StaticWorldRenderer::MoveObject(StaticObjectHandle handle, const Mat4& transform, float deltaTime) {
+    uint32_t index = m_handles.GetDenseIndex(handle);
+    if (index == SlotMap::INVALID_INDEX) return;
+
+    StaticObjectHot& hot = m_hot[index];
+    auto& physics = PhysicsWorld::Instance();
+    if (!physics.IsAlive(m_info[index].physics) || Mat3(transform) != Mat3(hot.transform)) {
+        // Rotated or scaled: the collider shape changes too
+        SetTransform(handle, transform);
+        return;
     }
-    return nullptr;
+
+    InvalidateShadows(index);
+    Vec3 delta = Vec3(transform[3]) - Vec3(hot.transform[3]);
+    hot.transform = transform;
+    UpdateRenderBounds(index);
+    physics.MoveCollider(m_info[index].physics, delta, deltaTime);
+    FinishTransformChange(index, handle);
 }
 
-const StaticObject* StaticWorldRenderer::Get(size_t index) const {
-    if (index < m_objects.size()) {
-        return &m_objects[index];
+void StaticWorldRenderer::FinishTransformChange(uint32_t index, StaticObjectHandle handle) {
+    InvalidateShadows(index);
+    if (IsMerged(index)) {
+        PatchMergedVertices(index);
+        if (m_gpuCull.IsInitialized() && !m_gpuObjectsDirty) {
+            const MergeRef& ref = m_mergeRefs[index];
+            m_gpuCull.UpdateObject(m_mergedGroups[ref.group].firstCommand + ref.range, BuildGpuObject(index));
+        }
     }
-    return nullptr;
+
+    // Same object set -> refit (once, on next use) instead of rebuilding
+    UpdateSpatialBounds(handle.index);
 }
 
 // ============================================================================
 // Visibility Control
 // ============================================================================
 
-void StaticWorldRenderer::SetVisible(size_t index, bool visible) {
-    if (index < m_objects.size()) {
-        m_objects[index].visible = visible;
+void StaticWorldRenderer::SetVisible(StaticObjectHandle handle, bool visible) {
+    uint32_t index = m_handles.GetDenseIndex(handle);
+    if (index == SlotMap::INVALID_INDEX) return;
+
+    if (m_hot[index].CastsShadow()) {
+        m_shadows.Invalidate(m_cullBounds.Get(index));
+    }
+    if (visible) {
+        m_hot[index].flags |= STATIC_OBJECT_VISIBLE;
+    } else {
+        m_hot[index].flags &= ~STATIC_OBJECT_VISIBLE;
     }
+    m_gpuObjectsDirty = true;
 }
 
 void StaticWorldRenderer::SetTypeVisible(StaticObjectType type, bool visible) {
-    for (auto& obj : m_objects) {
-        if (obj.type == type) {
-            obj.visible = visible;
+    for (auto& hot : m_hot) {
+        if (hot.type == type) {
+            hot.flags = visible ? (hot.flags | STATIC_OBJECT_VISIBLE) : (hot.flags & ~STATIC_OBJECT_VISIBLE);
         }
     }
+    m_gpuObjectsDirty = true;
+    m_shadows.InvalidateAll();
 }
 
 void StaticWorldRenderer::SetLayerVisible(uint32_t layer, bool visible) {
     m_layerVisibility[layer] = visible;
+    m_gpuObjectsDirty = true;
+    m_shadows.InvalidateAll();
 }
 
 void StaticWorldRenderer::ShowAll() {
-    for (auto& obj : m_objects) {
-        obj.visible = true;
+    for (auto& hot : m_hot) {
+        hot.flags |= STATIC_OBJECT_VISIBLE;
     }
     m_layerVisibility.clear();
+    m_gpuObjectsDirty = true;
+    m_shadows.InvalidateAll();
 }
 
 void StaticWorldRenderer::HideAll() {
-    for (auto& obj : m_objects) {
-        obj.visible = false;
+    for (auto& hot : m_hot) {
+        hot.flags &= ~STATIC_OBJECT_VISIBLE;
     }
+    m_gpuObjectsDirty = true;
+    m_shadows.InvalidateAll();
 }
 
 // ============================================================================
@@ -251,7 +633,10 @@ void StaticWorldRenderer::HideAll() {
 // ============================================================================
 
 void StaticWorldRenderer::Render(const FPSCamera& camera) {
-    if (m_objects.empty()) {
+    GENESIS_PROFILE_SCOPE("World Render");
+    GENESIS_GPU_SCOPE("World Render");
+
+    if (m_hot.empty()) {
         return;
     }
 
@@ -259,89 +644,168 @@ void StaticWorldRenderer::Render(const FPSCamera& camera) {
     if (m_batchesDirty && m_autoBatching) {
         BuildBatches();
     }
+    SortDirtyBatches();
+    if (m_mergeDirty && m_staticMerging) {
+        MergeStaticGeometry();
+    }
 
     // Reset statistics
     ResetStats();
 
-    Material* currentMaterial = nullptr;
-    Shader* currentShader = nullptr;
+    // Cascades whose cached casters went stale, before the camera pass
+    // binds its framebuffer state
+    RenderShadows(camera);
 
-    // Render using batches (grouped by material)
-    for (const auto& batch : m_batches) {
-        if (!batch.material || batch.objects.empty()) {
-            continue;
-        }
+    UploadFrameUniforms(camera);
+    m_shadows.BindReceivers();
+    m_lights.Update(camera);
+    m_lights.Bind();
+    if (m_lightmapTexture != 0) {
+        GLStateCache::Instance().BindTexture(TextureUnit::Lightmap, GL_TEXTURE_2D_ARRAY, m_lightmapTexture);
+    }
 
-        auto shader = batch.material->GetShader();
-        if (!shader || !shader->IsValid()) {
-            continue;
-        }
+    // Frustum test all objects up front (SIMD batch over SoA bounds). The
+    // GPU-driven path culls merged objects itself; only the rest need it,
+    // unless occlusion culling wants the frustum results for everything.
+    bool gpuDriven = m_gpuCull.IsInitialized() && !m_mergeDirty;
+    bool occlusion = m_occlusionCulling && m_frustumCulling;
+    bool frustumTested = m_frustumCulling && (occlusion || !(gpuDriven && m_mergedObjectCount == m_hot.size()));
+    if (frustumTested) {
+        CullObjects(camera);
+    }
+
+    // PVS first: it is a table lookup per object, and what it hides is
+    // neither rasterized as an occluder nor tested against the depth
+    uint32_t cameraArea = (m_pvsCulling && m_vis) ? m_vis->FindArea(camera.GetPosition()) : MapVis::NO_AREA;
+    m_hiddenActive = cameraArea != MapVis::NO_AREA || occlusion;
+    if (m_hiddenActive) {
+        m_objectHidden.assign(m_hot.size(), HIDDEN_NONE);
+    }
+    if (cameraArea != MapVis::NO_AREA) {
+        ApplyPVS(cameraArea);
+    }
+    if (occlusion) {
+        OcclusionCull(camera);
+    }
+
+    // Collect visible objects into draw groups and stream their transforms
+    SetupLODSelection(camera);
+    RequestTextureDetail(frustumTested);
+    BuildInstanceGroups();
+    if (m_frontToBack) {
+        SortFrontToBack(camera.GetPosition());
+    }
+    UploadInstanceData();
+    if (gpuDriven) {
+        DispatchGpuCull(camera);
+    }
 
-        // Bind material (includes shader)
-        batch.material->Bind();
-        m_materialSwitches++;
+    // Opaque depth first, so the color pass below shades each pixel once
+    m_prepassActive = m_prepass.IsInitialized();
+    if (m_prepassActive) {
+        RenderDepthPrepass(gpuDriven);
+    }
+    m_prepass.BeginMeasure();
 
-        // Upload global uniforms
-        UploadGlobalUniforms(*shader, camera);
+    // Merged static geometry first (opaque only, so order vs. the groups
+    // below doesn't matter), then everything that could not be merged
+    Material* currentMaterial = gpuDriven ? RenderMergedIndirect(camera) : RenderMerged(camera);
+    Shader* currentShader = nullptr;
+    const RenderBatch* currentBatch = nullptr;
+    bool receiveShadows = true;
 
-        currentMaterial = batch.material.get();
-        currentShader = shader.get();
+    // Render groups in batch order (grouped by material, then mesh)
+    for (const auto& group : m_instanceGroups) {
+        if (group.batch != currentBatch) {
+            currentBatch = group.batch;
 
-        // Render all objects in this batch
-        for (const StaticObject* obj : batch.objects) {
-            if (!obj->IsValid()) {
-                continue;
-            }
+            // Bind material (includes shader)
+            currentBatch->material->Bind();
+            m_materialSwitches++;
 
-            // Check layer visibility
-            auto layerIt = m_layerVisibility.find(obj->layer);
-            if (layerIt != m_layerVisibility.end() && !layerIt->second) {
-                m_objectsCulled++;
-                continue;
-            }
+            currentMaterial = currentBatch->material.get();
+            currentShader = currentMaterial->GetShader().get();
+            SetColorPassDepth(DepthPrepass::CanPrepass(*currentMaterial));
 
-            // TODO: Frustum culling here
-            // if (!IsInFrustum(obj->worldBoundsMin, obj->worldBoundsMax, camera)) {
-            //     m_objectsCulled++;
-            //     continue;
-            // }
+            // Upload global uniforms
+            UploadGlobalUniforms(*currentShader, camera);
+            receiveShadows = true;
+            if (group.instanced) {
+                currentShader->SetInt(Uniforms::Instanced, 1);
+            }
+        }
+        if (group.receiveShadows != receiveShadows) {
+            receiveShadows = group.receiveShadows;
+            currentShader->SetInt(Uniforms::ReceiveShadows, receiveShadows ? 1 : 0);
+        }
 
-            RenderObject(*obj, *currentShader);
+        if (group.instanced) {
+            RenderInstanced(group);
+        } else {
+            RenderObject(*group.mesh, m_hot[group.object].transform, *currentShader);
         }
     }
+    m_prepass.EndMeasure();
 
     // Unbind last material
     if (currentMaterial) {
         currentMaterial->Unbind();
     }
+    if (m_prepassActive) {
+        GLStateCache::Instance().SetDepthFunc(GL_LESS);
+        m_prepassActive = false;
+    }
 }
 
-void StaticWorldRenderer::RenderType(const FPSCamera& camera, StaticObjectType type) {
+// Storage-order draw of the visible objects that pass filter(hot),
+// switching material whenever it changes
+template<typename Filter>
+void StaticWorldRenderer::RenderFiltered(const FPSCamera& camera, Filter&& filter) {
     Material* currentMaterial = nullptr;
     Shader* currentShader = nullptr;
+    uint32_t currentMaterialId = INVALID_INDEX;
+    bool receiveShadows = true;
 
     ResetStats();
+    UploadFrameUniforms(camera);
+    m_shadows.BindReceivers();
+    m_lights.Update(camera);
+    m_lights.Bind();
+    if (m_lightmapTexture != 0) {
+        GLStateCache::Instance().BindTexture(TextureUnit::Lightmap, GL_TEXTURE_2D_ARRAY, m_lightmapTexture);
+    }
+    SetupLODSelection(camera);
 
-    for (const auto& obj : m_objects) {
-        if (!obj.IsValid() || obj.type != type) {
-            continue;
-        }
-
-        auto shader = obj.material->GetShader();
-        if (!shader || !shader->IsValid()) {
+    for (uint32_t index = 0; index < m_hot.size(); index++) {
+        const StaticObjectHot& hot = m_hot[index];
+        if (!hot.IsVisible() || hot.mesh == INVALID_INDEX || hot.material == INVALID_INDEX ||
+            !filter(hot)) {
             continue;
         }
 
         // Switch material if needed
-        if (currentMaterial != obj.material.get()) {
-            obj.material->Bind();
+        if (currentMaterialId != hot.material) {
+            const MaterialPtr& material = m_materials.Get(hot.material);
+            auto shader = material->GetShader();
+            if (!shader || !shader->IsValid()) {
+                continue;
+            }
+
+            material->Bind();
             UploadGlobalUniforms(*shader, camera);
-            currentMaterial = obj.material.get();
+            currentMaterialId = hot.material;
+            currentMaterial = material.get();
             currentShader = shader.get();
+            receiveShadows = true;
             m_materialSwitches++;
         }
+        if (hot.ReceivesShadow() != receiveShadows) {
+            receiveShadows = hot.ReceivesShadow();
+            currentShader->SetInt(Uniforms::ReceiveShadows, receiveShadows ? 1 : 0);
+        }
 
-        RenderObject(obj, *currentShader);
+        const Mesh& mesh = *m_meshes.Get(hot.mesh);
+        RenderObject(mesh.GetLOD(SelectLOD(index, mesh)), hot.transform, *currentShader);
     }
 
     if (currentMaterial) {
@@ -349,147 +813,1345 @@ void StaticWorldRenderer::RenderType(const FPSCamera& camera, StaticObjectType t
     }
 }
 
+void StaticWorldRenderer::RenderType(const FPSCamera& camera, StaticObjectType type) {
+    RenderFiltered(camera, [type](const StaticObjectHot& hot) { return hot.type == type; });
+}
+
 void StaticWorldRenderer::RenderLayer(const FPSCamera& camera, uint32_t layer) {
-    Material* currentMaterial = nullptr;
-    Shader* currentShader = nullptr;
+    RenderFiltered(camera, [layer](const StaticObjectHot& hot) { return hot.layer == layer; });
+}
 
-    ResetStats();
+void StaticWorldRenderer::RenderObject(const Mesh& mesh, const Mat4& transform, Shader& shader) {
+    // Set model transform
+    shader.SetMat4(Uniforms::Model, transform);
+
+    // Draw mesh
+    mesh.Draw();
+
+    RecordDraw(mesh, 1);
+}
+
+void StaticWorldRenderer::RenderInstanced(const InstanceGroup& group) {
+    group.mesh->DrawInstanced(group.count, m_instanceVBO, group.firstInstance * sizeof(Mat4));
+
+    RecordDraw(*group.mesh, group.count);
+}
 
-    for (const auto& obj : m_objects) {
-        if (!obj.IsValid() || obj.layer != layer) {
+bool StaticWorldRenderer::CollectMergedRanges(const MergedGroup& group, size_t begin, size_t end,
+                                              bool splitMaterials, bool countStats) {
+    m_mergeFirst.clear();
+    m_mergeCounts.clear();
+    uint32_t objects = 0, vertices = 0, indices = 0;
+    uint32_t lastMaterial = INVALID_INDEX;
+    for (size_t r = begin; r < end; r++) {
+        const MergedRange& range = group.ranges[r];
+        const StaticObjectHot& hot = m_hot[range.object];
+        if (!hot.IsVisible()) continue;
+        if (IsLayerHidden(hot.layer) || (m_frustumCulling && !m_objectVisible[range.object])) {
+            m_objectsCulled += countStats ? 1 : 0;
             continue;
         }
-
-        auto shader = obj.material->GetShader();
-        if (!shader || !shader->IsValid()) {
+        if (countStats ? SkipHidden(range.object) : IsHidden(range.object)) {
             continue;
         }
 
-        // Switch material if needed
-        if (currentMaterial != obj.material.get()) {
-            obj.material->Bind();
-            UploadGlobalUniforms(*shader, camera);
-            currentMaterial = obj.material.get();
-            currentShader = shader.get();
-            m_materialSwitches++;
+        bool touches = !m_mergeCounts.empty() && m_mergeFirst.back() + m_mergeCounts.back() == range.firstIndex;
+        if (touches && (!splitMaterials || hot.material == lastMaterial)) {
+            m_mergeCounts.back() += range.indexCount;
+        } else {
+            m_mergeFirst.push_back(range.firstIndex);
+            m_mergeCounts.push_back(range.indexCount);
         }
-
-        RenderObject(obj, *currentShader);
+        lastMaterial = hot.material;
+        objects++;
+        vertices += range.vertexCount;
+        indices += range.indexCount;
     }
-
-    if (currentMaterial) {
-        currentMaterial->Unbind();
+    if (m_mergeCounts.empty()) {
+        return false;
     }
+    if (!countStats) {
+        return true;
+    }
+
+    m_objectsRendered += objects;
+    m_verticesRendered += vertices;
+    m_trianglesRendered += indices / 3;
+    return true;
 }
 
-void StaticWorldRenderer::RenderObject(const StaticObject& obj, Shader& shader) {
-    // Set model transform
-    if (shader.HasUniform("u_Model")) {
-        shader.SetMat4("u_Model", obj.transform);
+size_t StaticWorldRenderer::GetMaterialRunEnd(const MergedGroup& group, size_t begin) const {
+    uint32_t material = m_hot[group.ranges[begin].object].material;
+    size_t end = begin + 1;
+    while (end < group.ranges.size() && m_hot[group.ranges[end].object].material == material) {
+        end++;
     }
+    return end;
+}
 
-    // Draw mesh
-    obj.mesh->Draw();
+Material* StaticWorldRenderer::RenderMerged(const FPSCamera& camera) {
+    if (m_mergeDirty) return nullptr;
 
-    // Update stats
-    m_drawCalls++;
-    m_objectsRendered++;
-    m_verticesRendered += obj.mesh->GetVertexCount();
-    if (obj.mesh->HasIndices()) {
-        m_trianglesRendered += obj.mesh->GetIndexCount() / 3;
-    } else {
-        m_trianglesRendered += obj.mesh->GetVertexCount() / 3;
+    Material* lastMaterial = nullptr;
+    for (const MergedGroup& group : m_mergedGroups) {
+        // A table group is one draw for all of its materials
+        if (group.table && group.table->Bind()) {
+            if (!CollectMergedRanges(group, 0, group.ranges.size(), group.table->IsBindless())) {
+                continue;
+            }
+            m_materialSwitches++;
+            lastMaterial = group.table->GetMaterial(0).get();
+            SetColorPassDepth(CanPrepass(group));
+
+            Shader& shader = *group.table->GetShader();
+            UploadGlobalUniforms(shader, camera);
+            shader.SetMat4(Uniforms::Model, Mat4(1.0f));
+
+            group.mesh->DrawRanges(m_mergeFirst.data(), m_mergeCounts.data(),
+                                   static_cast<uint32_t>(m_mergeCounts.size()));
+            m_drawCalls++;
+            continue;
+        }
+
+        // Otherwise per material (a table group whose variant isn't ready
+        // yet draws its material runs one by one)
+        for (size_t begin = 0, end = 0; begin < group.ranges.size(); begin = end) {
+            end = group.table ? GetMaterialRunEnd(group, begin) : group.ranges.size();
+            const MaterialPtr& material = group.table ? m_materials.Get(m_hot[group.ranges[begin].object].material)
+                                                      : group.material;
+            auto shader = material->GetShader();
+            if (!shader || !shader->IsValid()) {
+                continue;
+            }
+
+            // Visible ranges, merged where they touch in the buffer
+            if (!CollectMergedRanges(group, begin, end, false)) {
+                continue;
+            }
+
+            material->Bind();
+            m_materialSwitches++;
+            lastMaterial = material.get();
+            SetColorPassDepth(CanPrepass(group));
+
+            // Vertices are already in world space
+            UploadGlobalUniforms(*shader, camera);
+            shader->SetMat4(Uniforms::Model, Mat4(1.0f));
+
+            group.mesh->DrawRanges(m_mergeFirst.data(), m_mergeCounts.data(),
+                                   static_cast<uint32_t>(m_mergeCounts.size()));
+            m_drawCalls++;
+        }
     }
+    return lastMaterial;
 }
 
-void StaticWorldRenderer::UploadGlobalUniforms(Shader& shader, const FPSCamera& camera) {
-    // View/Projection matrices
-    if (shader.HasUniform("u_View")) {
-        shader.SetMat4("u_View", camera.GetViewMatrix());
-    }
-    if (shader.HasUniform("u_Proj")) {
-        shader.SetMat4("u_Proj", camera.GetProjectionMatrix());
-    }
-    if (shader.HasUniform("u_ViewProj")) {
-        shader.SetMat4("u_ViewProj", camera.GetProjectionMatrix() * camera.GetViewMatrix());
-    }
-    if (shader.HasUniform("u_CameraPos")) {
-        shader.SetVec3("u_CameraPos", camera.GetPosition());
+void StaticWorldRenderer::DispatchGpuCull(const FPSCamera& camera) {
+    if (m_gpuObjectsDirty) {
+        UploadGpuObjects();
+    } else {
+        UpdateGpuHidden();
     }
 
-    // Lighting
-    if (shader.HasUniform("u_LightDir")) {
-        shader.SetVec3("u_LightDir", glm::normalize(m_lightDirection));
-    }
-    if (shader.HasUniform("u_LightColor")) {
-        shader.SetVec3("u_LightColor", m_lightColor * m_lightIntensity);
-    }
-    if (shader.HasUniform("u_AmbientColor")) {
-        shader.SetVec3("u_AmbientColor", m_ambientColor * m_ambientIntensity);
+    Frustum frustum = Frustum::FromMatrix(camera.GetProjectionMatrix() * camera.GetViewMatrix());
+    m_gpuCull.Dispatch(frustum, m_frustumCulling);
+}
+
+// Draws the commands DispatchGpuCull() wrote
+Material* StaticWorldRenderer::RenderMergedIndirect(const FPSCamera& camera) {
+    // Per-object results stay on the GPU: stats count submitted objects
+    Material* lastMaterial = nullptr;
+    for (const MergedGroup& group : m_mergedGroups) {
+        // Every command is its own draw, so bindless handles stay uniform
+        if (group.table && group.table->Bind()) {
+            m_materialSwitches++;
+            lastMaterial = group.table->GetMaterial(0).get();
+            SetColorPassDepth(CanPrepass(group));
+
+            Shader& shader = *group.table->GetShader();
+            UploadGlobalUniforms(shader, camera);
+            shader.SetMat4(Uniforms::Model, Mat4(1.0f));
+
+            group.mesh->DrawIndirect(m_gpuCull.GetCommandBuffer(),
+                                     group.firstCommand * sizeof(DrawElementsIndirectCommand),
+                                     static_cast<uint32_t>(group.ranges.size()));
+            m_drawCalls++;
+        } else {
+            for (size_t begin = 0, end = 0; begin < group.ranges.size(); begin = end) {
+                end = group.table ? GetMaterialRunEnd(group, begin) : group.ranges.size();
+                const MaterialPtr& material = group.table ? m_materials.Get(m_hot[group.ranges[begin].object].material)
+                                                          : group.material;
+                auto shader = material->GetShader();
+                if (!shader || !shader->IsValid()) {
+                    continue;
+                }
+
+                material->Bind();
+                m_materialSwitches++;
+                lastMaterial = material.get();
+                SetColorPassDepth(CanPrepass(group));
+
+                UploadGlobalUniforms(*shader, camera);
+                shader->SetMat4(Uniforms::Model, Mat4(1.0f));
+
+                group.mesh->DrawIndirect(m_gpuCull.GetCommandBuffer(),
+                                         (group.firstCommand + begin) * sizeof(DrawElementsIndirectCommand),
+                                         static_cast<uint32_t>(end - begin));
+                m_drawCalls++;
+            }
+        }
+
+        m_objectsRendered += static_cast<uint32_t>(group.ranges.size());
+        m_verticesRendered += group.mesh->GetVertexCount();
+        m_trianglesRendered += group.mesh->GetIndexCount() / 3;
     }
+    return lastMaterial;
 }
 
 // ============================================================================
-// Batching
+// Depth Prepass
 // ============================================================================
 
-void StaticWorldRenderer::RebuildBatches() {
-    BuildBatches();
+void StaticWorldRenderer::SetDepthPrepass(bool enabled) {
+    if (!enabled) {
+        m_prepass.Shutdown();
+        return;
+    }
+    m_prepass.Initialize();
 }
 
-void StaticWorldRenderer::BuildBatches() {
-    m_batches.clear();
+bool StaticWorldRenderer::CanPrepass(const MergedGroup& group) const {
+    // The materials of a table share their render state
+    return m_prepassActive && group.material && DepthPrepass::CanPrepass(*group.material);
+}
 
-    // Group objects by material
-    std::unordered_map<Material*, size_t> materialToBatch;
+void StaticWorldRenderer::SetColorPassDepth(bool prepassed) {
+    if (!m_prepassActive) return;
+    GLStateCache::Instance().SetDepthFunc(prepassed ? GL_EQUAL : GL_LEQUAL);
+}
 
-    for (const auto& obj : m_objects) {
-        if (!obj.material) {
-            continue;
+// Depth-only draw of what the color pass shades with GL_EQUAL: the same
+// merged ranges (or GPU commands) and instance groups, with the same
+// transforms and cull modes
+void StaticWorldRenderer::RenderDepthPrepass(bool gpuDriven) {
+    GENESIS_PROFILE_SCOPE("World Depth Prepass");
+
+    m_prepass.BeginPass();
+    Shader& shader = m_prepass.GetShader();
+
+    // Merged geometry is already in world space
+    shader.SetInt(Uniforms::Instanced, 0);
+    shader.SetMat4(Uniforms::Model, Mat4(1.0f));
+    bool instanced = false;
+    if (!m_mergeDirty) {
+        for (const MergedGroup& group : m_mergedGroups) {
+            if (!CanPrepass(group)) continue;
+
+            if (gpuDriven) {
+                group.material->ApplyRenderState();
+                group.mesh->DrawIndirect(m_gpuCull.GetCommandBuffer(),
+                                         group.firstCommand * sizeof(DrawElementsIndirectCommand),
+                                         static_cast<uint32_t>(group.ranges.size()));
+            } else {
+                if (!CollectMergedRanges(group, 0, group.ranges.size(), false, false)) continue;
+                group.material->ApplyRenderState();
+                group.mesh->DrawRanges(m_mergeFirst.data(), m_mergeCounts.data(),
+                                       static_cast<uint32_t>(m_mergeCounts.size()));
+            }
+            m_prepassDrawCalls++;
         }
+    }
 
-        Material* matPtr = obj.material.get();
-        auto it = materialToBatch.find(matPtr);
+    const RenderBatch* currentBatch = nullptr;
+    bool prepassed = false;
+    for (const auto& group : m_instanceGroups) {
+        if (group.batch != currentBatch) {
+            currentBatch = group.batch;
+            prepassed = DepthPrepass::CanPrepass(*currentBatch->material);
+            if (prepassed) {
+                currentBatch->material->ApplyRenderState();
+            }
+        }
+        if (!prepassed) continue;
 
-        if (it == materialToBatch.end()) {
-            // Create new batch for this material
-            RenderBatch batch;
-            batch.material = obj.material;
-            batch.objects.push_back(&obj);
-            materialToBatch[matPtr] = m_batches.size();
-            m_batches.push_back(std::move(batch));
+        if (group.instanced != instanced) {
+            instanced = group.instanced;
+            shader.SetInt(Uniforms::Instanced, instanced ? 1 : 0);
+        }
+        if (group.instanced) {
+            group.mesh->DrawInstanced(group.count, m_instanceVBO, group.firstInstance * sizeof(Mat4));
         } else {
-            // Add to existing batch
-            m_batches[it->second].objects.push_back(&obj);
+            shader.SetMat4(Uniforms::Model, m_hot[group.object].transform);
+            group.mesh->Draw();
         }
+        m_prepassDrawCalls++;
     }
 
-    // Sort batches by render queue
-    std::sort(m_batches.begin(), m_batches.end(),
-        [](const RenderBatch& a, const RenderBatch& b) {
-            return static_cast<int>(a.material->GetRenderQueue())
-                 < static_cast<int>(b.material->GetRenderQueue());
-        });
+    m_prepass.EndPass();
+}
 
-    m_batchesDirty = false;
+void StaticWorldRenderer::SortFrontToBack(const Vec3& eye) {
+    // Groups follow the batches' render queue order: only the run of
+    // geometry queue groups is reordered (background and transparent keep
+    // their places around it)
+    auto queueOf = [this](size_t i) { return static_cast<int>(m_instanceGroups[i].batch->material->GetRenderQueue()); };
+    size_t begin = 0;
+    while (begin < m_instanceGroups.size() && queueOf(begin) < static_cast<int>(RenderQueue::Geometry)) {
+        begin++;
+    }
+    size_t end = begin;
+    while (end < m_instanceGroups.size() && queueOf(end) < static_cast<int>(RenderQueue::Transparent)) {
+        end++;
+    }
+    if (end - begin < 2) return;
 
-    LOG_INFO("StaticWorldRenderer", "Built " + std::to_string(m_batches.size()) +
-             " render batches for " + std::to_string(m_objects.size()) + " objects");
+    auto distanceTo = [&eye](const Mat4& transform) {
+        Vec3 offset = Vec3(transform[3]) - eye;
+        return glm::dot(offset, offset);
+    };
+    for (size_t i = begin; i < end; i++) {
+        InstanceGroup& group = m_instanceGroups[i];
+        if (!group.instanced) {
+            group.distance = distanceTo(m_hot[group.object].transform);
+            continue;
+        }
+        auto first = m_instanceTransforms.begin() + group.firstInstance;
+        std::sort(first, first + group.count, [&distanceTo](const Mat4& a, const Mat4& b) {
+            return distanceTo(a) < distanceTo(b);
+        });
+        group.distance = distanceTo(*first);
+    }
+    std::stable_sort(m_instanceGroups.begin() + begin, m_instanceGroups.begin() + end,
+                     [](const InstanceGroup& a, const InstanceGroup& b) { return a.distance < b.distance; });
 }
 
-// ============================================================================
-// Lighting
-// ============================================================================
+void StaticWorldRenderer::SetMaterialBatching(MaterialBatching mode) {
+    if (mode == m_materialBatching) return;
+    m_materialBatching = mode;
+    m_mergeDirty = true;
+}
 
-void StaticWorldRenderer::SetDirectionalLight(const Vec3& direction, const Vec3& color, float intensity) {
-    m_lightDirection = direction;
-    m_lightColor = color;
-    m_lightIntensity = intensity;
+void StaticWorldRenderer::SetGpuDriven(bool enabled) {
+    if (!enabled) {
+        m_gpuCull.Shutdown();
+        return;
+    }
+    if (m_gpuCull.Initialize()) {
+        m_gpuObjectsDirty = true;
+    }
 }
 
-void StaticWorldRenderer::SetAmbientLight(const Vec3& color, float intensity) {
-    m_ambientColor = color;
-    m_ambientIntensity = intensity;
+GpuCullObject StaticWorldRenderer::BuildGpuObject(uint32_t index) const {
+    const StaticObjectHot& hot = m_hot[index];
+    AABB bounds = m_cullBounds.Get(index);
+    bool drawable = hot.IsVisible() && !IsLayerHidden(hot.layer) && !IsHidden(index);
+
+    GpuCullObject object;
+    object.boundsMin = Vec4(bounds.min, drawable ? 1.0f : 0.0f);
+    object.boundsMax = Vec4(bounds.max, 0.0f);
+    return object;
+}
+
+void StaticWorldRenderer::UploadGpuObjects() {
+    std::vector<GpuCullObject> objects;
+    std::vector<DrawElementsIndirectCommand> commands;
+    objects.reserve(m_mergedObjectCount);
+    commands.reserve(m_mergedObjectCount);
+    m_gpuHidden.clear();
+    m_gpuHidden.reserve(m_mergedObjectCount);
+    m_gpuHiddenCount = 0;
+
+    for (const MergedGroup& group : m_mergedGroups) {
+        for (const MergedRange& range : group.ranges) {
+            objects.push_back(BuildGpuObject(range.object));
+            m_gpuHidden.push_back(IsHidden(range.object) ? 1 : 0);
+            m_gpuHiddenCount += m_gpuHidden.back();
+
+            DrawElementsIndirectCommand command;
+            command.count = range.indexCount;
+            command.firstIndex = range.firstIndex;
+            commands.push_back(command);
+        }
+    }
+
+    m_gpuCull.SetObjects(objects, commands);
+    m_gpuObjectsDirty = false;
+}
+
+void StaticWorldRenderer::UpdateGpuHidden() {
+    // Rewrite only the objects whose PVS/occlusion state changed since the
+    // last upload; between frames that is a small fraction of them
+    if (!m_hiddenActive && m_gpuHiddenCount == 0) return;
+
+    uint32_t command = 0;
+    for (const MergedGroup& group : m_mergedGroups) {
+        for (const MergedRange& range : group.ranges) {
+            uint8_t hidden = SkipHidden(range.object) ? 1 : 0;
+            if (command < m_gpuHidden.size() && m_gpuHidden[command] != hidden) {
+                m_gpuHidden[command] = hidden;
+                m_gpuHiddenCount += hidden ? 1 : -1;
+                m_gpuCull.UpdateObject(command, BuildGpuObject(range.object));
+            }
+            command++;
+        }
+    }
+}
+
+bool StaticWorldRenderer::IsLayerHidden(uint32_t layer) const {
+    if (m_layerVisibility.empty()) return false;
+    auto it = m_layerVisibility.find(layer);
+    return it != m_layerVisibility.end() && !it->second;
+}
+
+void StaticWorldRenderer::RecordDraw(const Mesh& mesh, uint32_t instanceCount) {
+    m_drawCalls++;
+    m_objectsRendered += instanceCount;
+    m_verticesRendered += mesh.GetVertexCount() * instanceCount;
+    if (mesh.HasIndices()) {
+        m_trianglesRendered += (mesh.GetIndexCount() / 3) * instanceCount;
+    } else {
+        m_trianglesRendered += (mesh.GetVertexCount() / 3) * instanceCount;
+    }
+}
+
+void StaticWorldRenderer::UploadFrameUniforms(const FPSCamera& camera) {
+    auto& frame = FrameUniforms::Instance();
+    frame.SetCamera(camera.GetViewMatrix(), camera.GetProjectionMatrix(), camera.GetPosition());
+    frame.SetLighting(m_lightDirection, m_lightColor * m_lightIntensity, m_ambientColor * m_ambientIntensity);
+    frame.Upload();
+}
+
+void StaticWorldRenderer::UploadGlobalUniforms(Shader& shader, const FPSCamera& camera) {
+    // Per-object u_Model by default; Render() enables instancing per batch
+    shader.SetInt(Uniforms::Instanced, 0);
+
+    // Shadowed unless a group opts out
+    shader.SetInt(Uniforms::ReceiveShadows, 1);
+
+    // Camera and lighting come from the FrameData block
+    if (shader.UsesFrameUniforms()) {
+        return;
+    }
+
+    // Legacy path for shaders without the block (handle setters skip
+    // uniforms the shader lacks)
+    shader.SetMat4(Uniforms::View, camera.GetViewMatrix());
+    shader.SetMat4(Uniforms::Proj, camera.GetProjectionMatrix());
+    if (shader.HasUniform(Uniforms::ViewProj)) {
+        shader.SetMat4(Uniforms::ViewProj, camera.GetProjectionMatrix() * camera.GetViewMatrix());
+    }
+    shader.SetVec3(Uniforms::CameraPos, camera.GetPosition());
+
+    shader.SetVec3(Uniforms::LightDir, glm::normalize(m_lightDirection));
+    shader.SetVec3(Uniforms::LightColor, m_lightColor * m_lightIntensity);
+    shader.SetVec3(Uniforms::AmbientColor, m_ambientColor * m_ambientIntensity);
+}
+
+// ============================================================================
+// Instancing
+// ============================================================================
+
+void StaticWorldRenderer::BuildInstanceGroups() {
+    m_instanceGroups.clear();
+    m_instanceTransforms.clear();
+
+    for (const auto& batch : m_batches) {
+        if (!batch.material || batch.objects.empty()) {
+            continue;
+        }
+
+        auto shader = batch.material->GetShader();
+        if (!shader || !shader->IsValid()) {
+            continue;
+        }
+
+        bool instanced = m_instancing && shader->HasUniform(Uniforms::Instanced);
+
+        for (uint32_t index : batch.objects) {
+            const StaticObjectHot& hot = m_hot[index];
+            if (!hot.IsVisible() || hot.mesh == INVALID_INDEX || IsMerged(index)) {
+                continue;
+            }
+
+            // Check layer visibility
+            if (IsLayerHidden(hot.layer)) {
+                m_objectsCulled++;
+                continue;
+            }
+
+            // Frustum culling (result computed by CullObjects)
+            if (m_frustumCulling && !m_objectVisible[index]) {
+                m_objectsCulled++;
+                continue;
+            }
+
+            if (SkipHidden(index)) {
+                continue;
+            }
+
+            const Mesh& mesh = *m_meshes.Get(hot.mesh);
+            uint32_t level = SelectLOD(index, mesh);
+
+            if (!instanced) {
+                InstanceGroup group;
+                group.batch = &batch;
+                group.mesh = &mesh.GetLOD(level);
+                group.object = index;
+                group.count = 1;
+                group.receiveShadows = hot.ReceivesShadow();
+                m_instanceGroups.push_back(group);
+                continue;
+            }
+
+            if (mesh.HasLODs()) {
+                if (m_lodRunMesh != hot.mesh) {
+                    FlushLODRun(batch);
+                    m_lodRunMesh = hot.mesh;
+                    if (m_lodRun.size() < mesh.GetLODCount()) {
+                        m_lodRun.resize(mesh.GetLODCount());
+                    }
+                }
+                m_lodRun[level].push_back(index);
+                continue;
+            }
+
+            // Objects are sorted by mesh within the batch, so a new group
+            // starts whenever the mesh (or the shadow opt-out) changes
+            if (m_instanceGroups.empty() || m_instanceGroups.back().batch != &batch ||
+                m_instanceGroups.back().mesh != &mesh ||
+                m_instanceGroups.back().receiveShadows != hot.ReceivesShadow()) {
+                InstanceGroup group;
+                group.batch = &batch;
+                group.mesh = &mesh;
+                group.object = index;
+                group.firstInstance = static_cast<uint32_t>(m_instanceTransforms.size());
+                group.instanced = true;
+                group.receiveShadows = hot.ReceivesShadow();
+                m_instanceGroups.push_back(group);
+            }
+
+            m_instanceTransforms.push_back(hot.transform);
+            m_instanceGroups.back().count++;
+        }
+
+        FlushLODRun(batch);
+    }
+}
+
+void StaticWorldRenderer::FlushLODRun(const RenderBatch& batch) {
+    if (m_lodRunMesh == INVALID_INDEX) return;
+
+    const Mesh& mesh = *m_meshes.Get(m_lodRunMesh);
+    for (uint32_t level = 0; level < m_lodRun.size(); level++) {
+        std::vector<uint32_t>& objects = m_lodRun[level];
+        if (objects.empty()) continue;
+
+        // One group per level, split where the shadow opt-out changes
+        for (size_t i = 0; i < objects.size(); i++) {
+            const StaticObjectHot& hot = m_hot[objects[i]];
+            if (i == 0 || m_instanceGroups.back().receiveShadows != hot.ReceivesShadow()) {
+                InstanceGroup group;
+                group.batch = &batch;
+                group.mesh = &mesh.GetLOD(level);
+                group.object = objects[i];
+                group.firstInstance = static_cast<uint32_t>(m_instanceTransforms.size());
+                group.instanced = true;
+                group.receiveShadows = hot.ReceivesShadow();
+                m_instanceGroups.push_back(group);
+            }
+            m_instanceTransforms.push_back(hot.transform);
+            m_instanceGroups.back().count++;
+        }
+        objects.clear();
+    }
+    m_lodRunMesh = INVALID_INDEX;
+}
+
+// ============================================================================
+// Level of Detail
+// ============================================================================
+
+void StaticWorldRenderer::SetupLODSelection(const FPSCamera& camera) {
+    m_lodEye = camera.GetPosition();
+    m_projScale = camera.GetProjectionMatrix()[1][1];
+    m_lodScale = m_projScale * m_lodBias;
+}
+
+float StaticWorldRenderer::ProjectedSize(uint32_t index, float scale) const {
+    // Bounding sphere of the world AABB; r * proj[1][1] / d is its
+    // diameter over the screen height (infinite with the eye inside)
+    AABB bounds = m_cullBounds.Get(index);
+    float radius = glm::length(bounds.max - bounds.min) * 0.5f;
+    float distance = glm::length((bounds.min + bounds.max) * 0.5f - m_lodEye);
+    if (distance <= radius) return std::numeric_limits<float>::infinity();
+
+    return radius * scale / distance;
+}
+
+uint32_t StaticWorldRenderer::SelectLOD(uint32_t index, const Mesh& mesh) const {
+    if (!mesh.HasLODs()) return 0;
+
+    float size = ProjectedSize(index, m_lodScale);
+    return std::isinf(size) ? 0 : mesh.SelectLOD(size);
+}
+
+void StaticWorldRenderer::RequestTextureDetail(bool frustumTested) {
+    if (!TextureStreamer::Instance().IsStreaming()) return;
+
+    for (const auto& batch : m_batches) {
+        if (!batch.material) continue;
+
+        // Merged objects too: their textures stream the same way. Objects
+        // drawn through a table ask it instead (with texture arrays it
+        // samples those, not the material's own textures).
+        float largest = 0.0f, largestInTable = 0.0f;
+        const MergedGroup* tableGroup = nullptr;
+        uint32_t tableSlot = 0;
+        for (uint32_t index : batch.objects) {
+            const StaticObjectHot& hot = m_hot[index];
+            if (!hot.IsVisible() || IsLayerHidden(hot.layer)) continue;
+            if (frustumTested && !m_objectVisible[index]) continue;
+
+            float size = ProjectedSize(index, m_projScale);
+            if (IsMerged(index) && m_mergedGroups[m_mergeRefs[index].group].table) {
+                const MergeRef& ref = m_mergeRefs[index];
+                tableGroup = &m_mergedGroups[ref.group];
+                tableSlot = tableGroup->ranges[ref.range].materialSlot;
+                largestInTable = std::max(largestInTable, size);
+            } else {
+                largest = std::max(largest, size);
+            }
+        }
+        if (largest > 0.0f) {
+            batch.material->RequestTextureScreenSize(largest);   // Infinite = full detail
+        }
+        if (largestInTable > 0.0f) {
+            tableGroup->table->RequestTextureScreenSize(tableSlot, largestInTable);
+        }
+    }
+}
+
+void StaticWorldRenderer::UploadInstanceData() {
+    StreamTransforms(m_instanceTransforms, m_instanceVBO, m_instanceCapacity);
+}
+
+// ============================================================================
+// Batching
+// ============================================================================
+
+void StaticWorldRenderer::RebuildBatches() {
+    BuildBatches();
+}
+
+void StaticWorldRenderer::BuildBatches() {
+    m_batches.clear();
+
+    RebuildBVH();
+
+    // Group objects by material id
+    std::vector<uint32_t> materialToBatch(m_materials.items.size(), INVALID_INDEX);
+    m_batchRefs.assign(m_hot.size(), BatchRef());
+
+    for (uint32_t i = 0; i < static_cast<uint32_t>(m_hot.size()); i++) {
+        uint32_t materialId = m_hot[i].material;
+        if (materialId == INVALID_INDEX) {
+            continue;
+        }
+
+        if (materialToBatch[materialId] == INVALID_INDEX) {
+            // Create new batch for this material
+            RenderBatch batch;
+            batch.material = m_materials.Get(materialId);
+            batch.objects.push_back(i);
+            materialToBatch[materialId] = static_cast<uint32_t>(m_batches.size());
+            m_batches.push_back(std::move(batch));
+        } else {
+            // Add to existing batch
+            m_batches[materialToBatch[materialId]].objects.push_back(i);
+        }
+    }
+
+    // Keep equal meshes adjacent so they form instance groups
+    for (auto& batch : m_batches) {
+        std::stable_sort(batch.objects.begin(), batch.objects.end(),
+            [this](uint32_t a, uint32_t b) {
+                return m_hot[a].mesh < m_hot[b].mesh;
+            });
+    }
+
+    // Sort batches by render queue
+    std::sort(m_batches.begin(), m_batches.end(),
+        [](const RenderBatch& a, const RenderBatch& b) {
+            return static_cast<int>(a.material->GetRenderQueue())
+                 < static_cast<int>(b.material->GetRenderQueue());
+        });
+
+    // Record where each object landed for O(1) incremental updates
+    m_materialBatch.assign(m_materials.items.size(), INVALID_INDEX);
+    for (uint32_t b = 0; b < static_cast<uint32_t>(m_batches.size()); b++) {
+        const auto& objects = m_batches[b].objects;
+        m_materialBatch[m_hot[objects.front()].material] = b;
+        for (uint32_t pos = 0; pos < static_cast<uint32_t>(objects.size()); pos++) {
+            m_batchRefs[objects[pos]].batch = b;
+            m_batchRefs[objects[pos]].batchPos = pos;
+        }
+    }
+
+    m_batchesDirty = false;
+
+    LOG_INFO("StaticWorldRenderer", "Built " + std::to_string(m_batches.size()) +
+             " render batches for " + std::to_string(m_hot.size()) + " objects");
+}
+
+void StaticWorldRenderer::InsertIntoBatch(uint32_t index) {
+    const StaticObjectHot& hot = m_hot[index];
+    BatchRef& ref = m_batchRefs[index];
+    if (hot.material == INVALID_INDEX) {
+        ref.batch = INVALID_INDEX;
+        return;
+    }
+
+    if (hot.material >= m_materialBatch.size() || m_materialBatch[hot.material] == INVALID_INDEX) {
+        // New material: its batch needs a place in render-queue order
+        m_batchesDirty = true;
+        return;
+    }
+
+    // Append; if that breaks mesh adjacency the batch is re-sorted once
+    // before the next draw (SortDirtyBatches)
+    uint32_t batchIndex = m_materialBatch[hot.material];
+    RenderBatch& batch = m_batches[batchIndex];
+    uint32_t pos = static_cast<uint32_t>(batch.objects.size());
+    if (pos > 0 && m_hot[batch.objects[pos - 1]].mesh != hot.mesh) {
+        batch.meshSorted = false;
+    }
+    batch.objects.push_back(index);
+
+    ref.batch = batchIndex;
+    ref.batchPos = pos;
+}
+
+void StaticWorldRenderer::SortDirtyBatches() {
+    for (uint32_t b = 0; b < static_cast<uint32_t>(m_batches.size()); b++) {
+        RenderBatch& batch = m_batches[b];
+        if (batch.meshSorted) continue;
+
+        std::stable_sort(batch.objects.begin(), batch.objects.end(),
+            [this](uint32_t a, uint32_t c) {
+                return m_hot[a].mesh < m_hot[c].mesh;
+            });
+        for (uint32_t pos = 0; pos < static_cast<uint32_t>(batch.objects.size()); pos++) {
+            m_batchRefs[batch.objects[pos]].batchPos = pos;
+        }
+        batch.meshSorted = true;
+    }
+}
+
+void StaticWorldRenderer::RemoveFromBatch(uint32_t index) {
+    BatchRef& ref = m_batchRefs[index];
+    if (m_batchesDirty || ref.batch == INVALID_INDEX) {
+        ref.batch = INVALID_INDEX;
+        return;
+    }
+
+    // Swap-and-pop
+    RenderBatch& batch = m_batches[ref.batch];
+    auto& objects = batch.objects;
+    uint32_t last = objects.back();
+    if (last != index) {
+        objects[ref.batchPos] = last;
+        m_batchRefs[last].batchPos = ref.batchPos;
+        batch.meshSorted = false;
+    }
+    objects.pop_back();
+
+    ref.batch = INVALID_INDEX;
+}
+
+// ============================================================================
+// Static Geometry Merging
+// ============================================================================
+
+bool StaticWorldRenderer::CanMerge(uint32_t index) const {
+    const StaticObjectHot& hot = m_hot[index];
+    if (hot.mesh == INVALID_INDEX || hot.material == INVALID_INDEX) return false;
+
+    const Mesh& mesh = *m_meshes.Get(hot.mesh);
+    const Material& material = *m_materials.Get(hot.material);
+
+    // Blended materials need back-to-front order per object
+    if (static_cast<int>(material.GetRenderQueue()) >= static_cast<int>(RenderQueue::Transparent)) {
+        return false;
+    }
+
+    // LOD chains switch per frame; baked vertices are fixed
+    if (mesh.HasLODs()) {
+        return false;
+    }
+
+    // Merged draws are shadowed throughout
+    if (!hot.ReceivesShadow()) {
+        return false;
+    }
+
+    const auto& attributes = mesh.GetLayout().GetAttributes();
+    return mesh.GetDrawMode() == DrawMode::Triangles && mesh.GetVertexCount() > 0 &&
+           !mesh.GetVertexData().empty() && !attributes.empty() &&
+           attributes[0].type == VertexAttribType::Float3;
+}
+
+void StaticWorldRenderer::MergeStaticGeometry() {
+    GENESIS_PROFILE_SCOPE("Merge Static Geometry");
+
+    m_mergedGroups.clear();
+    m_materialTables.clear();
+    m_mergeRefs.assign(m_hot.size(), MergeRef());
+
+    std::vector<uint32_t> order;
+    order.reserve(m_hot.size());
+    for (uint32_t i = 0; i < static_cast<uint32_t>(m_hot.size()); i++) {
+        if (CanMerge(i)) order.push_back(i);
+    }
+
+    std::unordered_map<uint32_t, TableSlot> tableSlots;   // By material index
+    if (m_materialBatching != MaterialBatching::Off) {
+        AssignMaterialTables(order, tableSlots);
+    }
+
+    // Groups are owned by a table or a single material
+    auto ownerOf = [&tableSlots](uint32_t material) -> uint64_t {
+        auto it = tableSlots.find(material);
+        return it != tableSlots.end() ? it->second.table : (uint64_t(1) << 32) | material;
+    };
+
+    // Render queue, then owner, material and mesh: groups come out in draw
+    // order, table groups hold runs of one material, and equal meshes sit
+    // together in the buffer
+    std::sort(order.begin(), order.end(), [this, &ownerOf](uint32_t a, uint32_t b) {
+        const StaticObjectHot& x = m_hot[a];
+        const StaticObjectHot& y = m_hot[b];
+        int qx = static_cast<int>(m_materials.Get(x.material)->GetRenderQueue());
+        int qy = static_cast<int>(m_materials.Get(y.material)->GetRenderQueue());
+        if (qx != qy) return qx < qy;
+        if (x.material != y.material) {
+            uint64_t ox = ownerOf(x.material), oy = ownerOf(y.material);
+            if (ox != oy) return ox < oy;
+            return x.material < y.material;
+        }
+        return x.mesh < y.mesh;
+    });
+
+    // CPU-side buffers, parallel to m_mergedGroups
+    struct Staging {
+        uint64_t owner = 0;
+        std::vector<uint8_t> vertices;
+        std::vector<uint32_t> indices;
+        std::vector<uint16_t> slots;    // Table groups: per vertex
+        std::vector<Vec3> lightmapUVs;  // Per vertex once any object has them
+        uint32_t vertexCount = 0;
+    };
+    std::vector<Staging> staging;
+    size_t ownerStart = 0;   // First group of the current owner
+
+    for (uint32_t index : order) {
+        const StaticObjectHot& hot = m_hot[index];
+        const Mesh& mesh = *m_meshes.Get(hot.mesh);
+
+        uint64_t owner = ownerOf(hot.material);
+        auto tableSlot = tableSlots.find(hot.material);
+        const bool inTable = tableSlot != tableSlots.end();
+        if (!staging.empty() && staging.back().owner != owner) {
+            ownerStart = staging.size();
+        }
+
+        // Objects of one owner are contiguous, so only its groups are searched
+        uint32_t groupIndex = INVALID_INDEX;
+        for (size_t g = ownerStart; g < staging.size(); g++) {
+            if (SameLayout(m_mergedGroups[g].mesh->GetLayout(), mesh.GetLayout())) {
+                groupIndex = static_cast<uint32_t>(g);
+                break;
+            }
+        }
+        if (groupIndex == INVALID_INDEX) {
+            groupIndex = static_cast<uint32_t>(m_mergedGroups.size());
+            MergedGroup group;
+            group.material = m_materials.Get(hot.material);
+            if (inTable) {
+                group.table = m_materialTables[tableSlot->second.table];
+                group.mesh = std::make_shared<Mesh>("Merged_Table" + std::to_string(tableSlot->second.table));
+            } else {
+                group.mesh = std::make_shared<Mesh>("Merged_" + group.material->GetName());
+            }
+            group.mesh->SetLayout(mesh.GetLayout());
+            m_mergedGroups.push_back(std::move(group));
+            staging.emplace_back();
+            staging.back().owner = owner;
+        }
+
+        MergedGroup& group = m_mergedGroups[groupIndex];
+        Staging& stage = staging[groupIndex];
+
+        MergedRange range;
+        range.object = index;
+        range.firstVertex = stage.vertexCount;
+        range.vertexCount = mesh.GetVertexCount();
+        range.firstIndex = static_cast<uint32_t>(stage.indices.size());
+        if (inTable) {
+            range.materialSlot = tableSlot->second.slot;
+            stage.slots.insert(stage.slots.end(), range.vertexCount, static_cast<uint16_t>(range.materialSlot));
+        }
+
+        size_t vertexOffset = stage.vertices.size();
+        stage.vertices.resize(vertexOffset + mesh.GetVertexData().size());
+        BakeVertices(mesh, hot.transform, stage.vertices.data() + vertexOffset);
+
+        // Objects without a lightmap get z = 0 (not lightmapped)
+        if (mesh.HasLightmapUVs() || !stage.lightmapUVs.empty()) {
+            stage.lightmapUVs.resize(range.firstVertex, Vec3(0.0f));
+            if (mesh.HasLightmapUVs()) {
+                const auto& uvs = mesh.GetLightmapUVs();
+                stage.lightmapUVs.insert(stage.lightmapUVs.end(), uvs.begin(), uvs.end());
+            }
+            stage.lightmapUVs.resize(range.firstVertex + range.vertexCount, Vec3(0.0f));
+        }
+
+        // Rebase the indices onto the shared buffer
+        const uint8_t* indexData = mesh.GetIndexData().data();
+        if (mesh.GetIndexType() == IndexType::UInt16 && mesh.HasIndices()) {
+            const uint16_t* src = reinterpret_cast<const uint16_t*>(indexData);
+            for (uint32_t i = 0; i < mesh.GetIndexCount(); i++) {
+                stage.indices.push_back(range.firstVertex + src[i]);
+            }
+        } else if (mesh.GetIndexType() == IndexType::UInt32 && mesh.HasIndices()) {
+            const uint32_t* src = reinterpret_cast<const uint32_t*>(indexData);
+            for (uint32_t i = 0; i < mesh.GetIndexCount(); i++) {
+                stage.indices.push_back(range.firstVertex + src[i]);
+            }
+        } else {
+            for (uint32_t i = 0; i < mesh.GetVertexCount(); i++) {
+                stage.indices.push_back(range.firstVertex + i);
+            }
+        }
+        range.indexCount = static_cast<uint32_t>(stage.indices.size()) - range.firstIndex;
+        stage.vertexCount += range.vertexCount;
+
+        m_mergeRefs[index].group = groupIndex;
+        m_mergeRefs[index].range = static_cast<uint32_t>(group.ranges.size());
+        group.ranges.push_back(range);
+    }
+
+    m_mergedObjectCount = 0;
+    for (size_t g = 0; g < m_mergedGroups.size(); g++) {
+        m_mergedGroups[g].firstCommand = m_mergedObjectCount;
+        m_mergedObjectCount += static_cast<uint32_t>(m_mergedGroups[g].ranges.size());
+
+        Mesh& mesh = *m_mergedGroups[g].mesh;
+        mesh.SetVertexData(staging[g].vertices.data(), staging[g].vertices.size(), staging[g].vertexCount);
+        mesh.SetIndexData(staging[g].indices);
+        mesh.SetMaterialSlots(std::move(staging[g].slots));
+        if (!staging[g].lightmapUVs.empty()) {
+            staging[g].lightmapUVs.resize(staging[g].vertexCount, Vec3(0.0f));
+            mesh.SetLightmapUVs(std::move(staging[g].lightmapUVs));
+        }
+        mesh.CalculateBoundingBox();
+        mesh.Upload();
+    }
+
+    m_mergeDirty = false;
+    m_gpuObjectsDirty = true;
+
+    LOG_INFO("StaticWorldRenderer", "Merged " + std::to_string(order.size()) + " of " +
+             std::to_string(m_hot.size()) + " objects into " + std::to_string(m_mergedGroups.size()) +
+             " static geometry groups (" + std::to_string(m_materialTables.size()) + " material tables)");
+}
+
+void StaticWorldRenderer::AssignMaterialTables(const std::vector<uint32_t>& objects,
+                                               std::unordered_map<uint32_t, TableSlot>& slots) {
+    bool bindless = m_materialBatching == MaterialBatching::Bindless;
+
+    // First table that takes the material, else a new one
+    for (uint32_t index : objects) {
+        uint32_t material = m_hot[index].material;
+        if (slots.count(material)) continue;
+
+        const MaterialPtr& ptr = m_materials.Get(material);
+        size_t table = 0;
+        while (table < m_materialTables.size() && !m_materialTables[table]->Accepts(*ptr)) {
+            table++;
+        }
+        if (table == m_materialTables.size()) {
+            auto created = std::make_shared<MaterialTable>(bindless);
+            if (!created->Accepts(*ptr)) continue;
+            m_materialTables.push_back(std::move(created));
+        }
+
+        TableSlot& slot = slots[material];
+        slot.table = static_cast<uint32_t>(table);
+        slot.slot = m_materialTables[table]->Add(ptr);
+    }
+
+    // A table of one material saves nothing
+    std::vector<uint32_t> remap(m_materialTables.size(), INVALID_INDEX);
+    size_t kept = 0;
+    for (size_t table = 0; table < m_materialTables.size(); table++) {
+        if (m_materialTables[table]->GetMaterialCount() < 2) continue;
+        remap[table] = static_cast<uint32_t>(kept);
+        m_materialTables[kept++] = std::move(m_materialTables[table]);
+    }
+    m_materialTables.resize(kept);
+
+    for (auto it = slots.begin(); it != slots.end();) {
+        it->second.table = remap[it->second.table];
+        it = it->second.table == INVALID_INDEX ? slots.erase(it) : std::next(it);
+    }
+}
+
+void StaticWorldRenderer::PatchMergedVertices(uint32_t index) {
+    const MergeRef& ref = m_mergeRefs[index];
+    MergedGroup& group = m_mergedGroups[ref.group];
+    const MergedRange& range = group.ranges[ref.range];
+    const Mesh& mesh = *m_meshes.Get(m_hot[index].mesh);
+
+    std::vector<uint8_t> vertices(mesh.GetVertexData().size());
+    BakeVertices(mesh, m_hot[index].transform, vertices.data());
+    group.mesh->UpdateVertexRange(static_cast<size_t>(range.firstVertex) * mesh.GetLayout().GetStride(),
+                                  vertices.data(), vertices.size());
+}
+
+// ============================================================================
+// Culling
+// ============================================================================
+
+void StaticWorldRenderer::CullObjects(const FPSCamera& camera) {
+    m_objectVisible.resize(m_hot.size());
+
+    Frustum frustum = Frustum::FromMatrix(camera.GetProjectionMatrix() * camera.GetViewMatrix());
+
+    if (m_hot.size() < BVH_CULL_THRESHOLD) {
+        frustum.TestAABBs(m_cullBounds, m_objectVisible.data());
+        return;
+    }
+
+    // Hierarchical: whole subtrees are accepted or rejected at once
+    EnsureBVH();
+    std::fill(m_objectVisible.begin(), m_objectVisible.end(), uint8_t(0));
+    m_renderBVH.QueryFrustum(frustum, [this, &frustum](uint32_t slot, bool fullyInside) {
+        uint32_t index = m_handles.GetDenseIndexOfSlot(slot);
+        if (index == SlotMap::INVALID_INDEX) return;
+        if (fullyInside || frustum.Intersects(m_renderBounds[slot])) {
+            m_objectVisible[index] = 1;
+        }
+    });
+}
+
+void StaticWorldRenderer::SetVisData(MapVisPtr vis) {
+    m_vis = (vis && !vis->IsEmpty()) ? std::move(vis) : nullptr;
+    for (uint32_t index = 0; index < m_hot.size(); index++) {
+        m_hot[index].area = FindObjectArea(index);
+    }
+}
+
+uint16_t StaticWorldRenderer::FindObjectArea(uint32_t index) const {
+    if (!m_vis) return STATIC_OBJECT_NO_AREA;
+    uint32_t area = m_vis->FindAreaForBounds(m_cullBounds.Get(index));
+    return area < STATIC_OBJECT_NO_AREA ? static_cast<uint16_t>(area) : STATIC_OBJECT_NO_AREA;
+}
+
+void StaticWorldRenderer::ApplyPVS(uint32_t cameraArea) {
+    GENESIS_PROFILE_SCOPE("PVS Cull");
+
+    for (uint32_t index = 0; index < m_hot.size(); index++) {
+        uint16_t area = m_hot[index].area;
+        if (area != STATIC_OBJECT_NO_AREA && !m_vis->IsVisible(cameraArea, area)) {
+            m_objectHidden[index] = HIDDEN_PVS;
+        }
+    }
+}
+
+bool StaticWorldRenderer::SkipHidden(uint32_t index) {
+    switch (GetHidden(index)) {
+        case HIDDEN_PVS: m_objectsPvsCulled++; return true;
+        case HIDDEN_OCCLUDED: m_objectsOccluded++; return true;
+        default: return false;
+    }
+}
+
+void StaticWorldRenderer::OcclusionCull(const FPSCamera& camera) {
+    GENESIS_PROFILE_SCOPE("Occlusion Cull");
+
+    m_occlusion.Begin(camera.GetProjectionMatrix() * camera.GetViewMatrix());
+
+    // Large walls and floors in view are the occluders
+    Vec3 eye = camera.GetPosition();
+    float projScale = camera.GetProjectionMatrix()[1][1];
+    uint32_t occluders = 0;
+    for (uint32_t index = 0; index < m_hot.size(); index++) {
+        const StaticObjectHot& hot = m_hot[index];
+        if ((hot.type != StaticObjectType::Wall && hot.type != StaticObjectType::Floor) ||
+            !m_objectVisible[index] || !hot.IsVisible() || hot.mesh == INVALID_INDEX ||
+            IsLayerHidden(hot.layer) || m_objectHidden[index] != HIDDEN_NONE) {
+            continue;
+        }
+
+        AABB bounds = m_cullBounds.Get(index);
+        float radius = glm::length(bounds.max - bounds.min) * 0.5f;
+        float distance = glm::length((bounds.min + bounds.max) * 0.5f - eye);
+        if (distance > radius && radius * projScale / distance < OCCLUDER_MIN_SCREEN_SIZE) {
+            continue;
+        }
+
+        if (m_occlusion.RasterizeMesh(*m_meshes.Get(hot.mesh), hot.transform)) {
+            occluders++;
+        }
+    }
+    m_occluderTriangles = m_occlusion.GetTrianglesRasterized();
+    if (occluders == 0) {
+        return;
+    }
+
+    m_occlusion.BuildHierarchy();
+    for (uint32_t index = 0; index < m_hot.size(); index++) {
+        if (m_objectVisible[index] && m_hot[index].IsVisible() && m_objectHidden[index] == HIDDEN_NONE &&
+            m_occlusion.IsOccluded(m_cullBounds.Get(index))) {
+            m_objectHidden[index] = HIDDEN_OCCLUDED;
+        }
+    }
+}
+
+// ============================================================================
+// Spatial Hierarchy
+// ============================================================================
+
+void StaticWorldRenderer::RebuildBVH() const {
+    m_renderBounds.assign(m_handles.GetSlotCount(), AABB(Vec3(0.0f), Vec3(0.0f)));
+    for (uint32_t i = 0; i < static_cast<uint32_t>(m_hot.size()); i++) {
+        m_renderBounds[m_handles.GetSlot(i)] = m_cullBounds.Get(i);
+    }
+
+    m_renderBVH.Build(m_renderBounds);
+    m_bvhDirty = false;
+    m_bvhNeedsRefit = false;
+}
+
+void StaticWorldRenderer::RefitBVH() const {
+    // Bounds were patched in place by UpdateSpatialBounds
+    m_renderBVH.Refit(m_renderBounds);
+    m_bvhNeedsRefit = false;
+}
+
+void StaticWorldRenderer::UpdateSpatialBounds(uint32_t slot) {
+    if (m_bvhDirty) return;
+
+    // New slot: leaf set changes
+    if (slot >= m_renderBounds.size()) {
+        m_bvhDirty = true;
+        return;
+    }
+
+    uint32_t index = m_handles.GetDenseIndexOfSlot(slot);
+    bool alive = index != SlotMap::INVALID_INDEX;
+    m_renderBounds[slot] = alive ? m_cullBounds.Get(index) : AABB(Vec3(0.0f), Vec3(0.0f));
+    m_bvhNeedsRefit = true;
+}
+
+// ============================================================================
+// Lighting
+// ============================================================================
+
+void StaticWorldRenderer::SetDirectionalLight(const Vec3& direction, const Vec3& color, float intensity) {
+    m_lightDirection = direction;
+    m_lightColor = color;
+    m_lightIntensity = intensity;
+}
+
+void StaticWorldRenderer::SetAmbientLight(const Vec3& color, float intensity) {
+    m_ambientColor = color;
+    m_ambientIntensity = intensity;
+}
+
+// ============================================================================
+// Shadows
+// ============================================================================
+
+void StaticWorldRenderer::SetShadows(bool enabled) {
+    if (!enabled) {
+        m_shadows.Shutdown();
+        if (m_shadowVBO != 0) {
+            glDeleteBuffers(1, &m_shadowVBO);
+            m_shadowVBO = 0;
+            m_shadowCapacity = 0;
+        }
+        return;
+    }
+    m_shadows.Initialize();
+}
+
+void StaticWorldRenderer::SetLightmap(const MapLightmapPtr& lightmap) {
+    if (m_lightmapTexture != 0) {
+        GLStateCache::Instance().OnTextureDeleted(m_lightmapTexture);
+        glDeleteTextures(1, &m_lightmapTexture);
+        m_lightmapTexture = 0;
+        MemoryTracker::Instance().RemoveGpu(MemoryTag::Textures, GetLightmapBytes());
+        m_lightmapSize = 0;
+        m_lightmapLayers = 0;
+    }
+    if (!lightmap || lightmap->IsEmpty()) return;
+
+    GLint maxSize = 0, maxLayers = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxSize);
+    glGetIntegerv(GL_MAX_ARRAY_TEXTURE_LAYERS, &maxLayers);
+    if (lightmap->size > static_cast<uint32_t>(maxSize) || lightmap->layerCount > static_cast<uint32_t>(maxLayers)) {
+        LOG_WARNING("StaticWorldRenderer", "Lightmap " + std::to_string(lightmap->size) + " x " +
+                    std::to_string(lightmap->layerCount) + " layer(s) exceeds the GL limits, not used");
+        return;
+    }
+
+    glGenTextures(1, &m_lightmapTexture);
+    GLStateCache::Instance().BindTexture(TextureUnit::Lightmap, GL_TEXTURE_2D_ARRAY, m_lightmapTexture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA16F, static_cast<GLsizei>(lightmap->size),
+                 static_cast<GLsizei>(lightmap->size), static_cast<GLsizei>(lightmap->layerCount), 0,
+                 GL_RGBA, GL_HALF_FLOAT, lightmap->texels.data());
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+    // Charts carry their own border, so plain bilinear filtering is seamless
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    m_lightmapSize = lightmap->size;
+    m_lightmapLayers = lightmap->layerCount;
+    MemoryTracker::Instance().AddGpu(MemoryTag::Textures, GetLightmapBytes());
+    LOG_INFO("StaticWorldRenderer", "Lightmap " + std::to_string(m_lightmapSize) + "x" +
+             std::to_string(m_lightmapSize) + " x " + std::to_string(m_lightmapLayers) + " layer(s), " +
+             std::to_string(lightmap->charts.size()) + " charts");
+}
+
+bool StaticWorldRenderer::IsShadowCaster(uint32_t index) const {
+    const StaticObjectHot& hot = m_hot[index];
+    if (!hot.IsVisible() || !hot.CastsShadow() || hot.mesh == INVALID_INDEX || IsLayerHidden(hot.layer)) {
+        return false;
+    }
+    DrawMode mode = m_meshes.Get(hot.mesh)->GetDrawMode();
+    return mode == DrawMode::Triangles || mode == DrawMode::TriangleStrip || mode == DrawMode::TriangleFan;
+}
+
+void StaticWorldRenderer::InvalidateShadows(uint32_t index) {
+    const StaticObjectHot& hot = m_hot[index];
+    if (hot.IsVisible() && hot.CastsShadow()) {
+        m_shadows.Invalidate(m_cullBounds.Get(index));
+    }
+}
+
+void StaticWorldRenderer::RenderShadows(const FPSCamera& camera) {
+    m_shadowDrawCalls = 0;
+    uint32_t cascades = m_shadows.Update(camera, m_lightDirection);
+    if (cascades == 0) {
+        return;
+    }
+
+    GENESIS_PROFILE_SCOPE("World Shadows");
+    GENESIS_GPU_SCOPE("World Shadows");
+
+    m_shadows.BeginPass();
+    Shader& shader = m_shadows.GetCasterShader();
+    for (uint32_t cascade = 0; cascade < m_shadows.GetCascadeCount(); cascade++) {
+        if ((cascades & (1u << cascade)) == 0) continue;
+
+        m_shadows.BeginCascade(cascade);
+        CollectShadowCasters(m_shadows.GetCasterFrustum(cascade));
+        DrawShadowCasters(shader);
+    }
+    m_shadows.EndPass();
+}
+
+void StaticWorldRenderer::CollectShadowCasters(const Frustum& frustum) {
+    m_shadowCasters.assign(m_hot.size(), 0);
+
+    // Same split as CullObjects: a flat sweep for small scenes
+    if (m_hot.size() < BVH_CULL_THRESHOLD) {
+        frustum.TestAABBs(m_cullBounds, m_shadowCasters.data());
+    } else {
+        EnsureBVH();
+        m_renderBVH.QueryFrustum(frustum, [this, &frustum](uint32_t slot, bool fullyInside) {
+            uint32_t index = m_handles.GetDenseIndexOfSlot(slot);
+            if (index == SlotMap::INVALID_INDEX) return;
+            if (fullyInside || frustum.Intersects(m_renderBounds[slot])) {
+                m_shadowCasters[index] = 1;
+            }
+        });
+    }
+
+    // Camera-independent: PVS and occlusion results don't apply, so the
+    // cached layers hold every caster
+    m_shadowObjects.clear();
+    for (uint32_t index = 0; index < m_hot.size(); index++) {
+        if (!m_shadowCasters[index]) continue;
+        if (!IsShadowCaster(index)) {
+            m_shadowCasters[index] = 0;
+        } else if (!IsMerged(index)) {
+            m_shadowObjects.push_back(index);
+        }
+    }
+}
+
+void StaticWorldRenderer::DrawShadowCasters(Shader& shader) {
+    // Merged geometry is already in world space: its caster ranges, merged
+    // where they touch, in one draw per group
+    shader.SetInt(Uniforms::Instanced, 0);
+    shader.SetMat4(Uniforms::Model, Mat4(1.0f));
+    if (!m_mergeDirty) {
+        for (const MergedGroup& group : m_mergedGroups) {
+            m_mergeFirst.clear();
+            m_mergeCounts.clear();
+            for (const MergedRange& range : group.ranges) {
+                if (!m_shadowCasters[range.object]) continue;
+                if (!m_mergeCounts.empty() && m_mergeFirst.back() + m_mergeCounts.back() == range.firstIndex) {
+                    m_mergeCounts.back() += range.indexCount;
+                } else {
+                    m_mergeFirst.push_back(range.firstIndex);
+                    m_mergeCounts.push_back(range.indexCount);
+                }
+            }
+            if (m_mergeCounts.empty()) continue;
+
+            group.mesh->DrawRanges(m_mergeFirst.data(), m_mergeCounts.data(),
+                                   static_cast<uint32_t>(m_mergeCounts.size()));
+            m_shadowDrawCalls++;
+        }
+    }
+    if (m_shadowObjects.empty()) {
+        return;
+    }
+
+    // Everything else instanced per mesh (the full mesh: a shadow doesn't
+    // follow the camera's LOD choice, or the cache would go stale)
+    std::sort(m_shadowObjects.begin(), m_shadowObjects.end(), [this](uint32_t a, uint32_t b) {
+        return m_hot[a].mesh < m_hot[b].mesh;
+    });
+    m_shadowGroups.clear();
+    m_shadowTransforms.clear();
+    for (uint32_t index : m_shadowObjects) {
+        const Mesh* mesh = m_meshes.Get(m_hot[index].mesh).get();
+        if (m_shadowGroups.empty() || m_shadowGroups.back().mesh != mesh) {
+            InstanceGroup group;
+            group.mesh = mesh;
+            group.object = index;
+            group.firstInstance = static_cast<uint32_t>(m_shadowTransforms.size());
+            group.instanced = true;
+            m_shadowGroups.push_back(group);
+        }
+        m_shadowTransforms.push_back(m_hot[index].transform);
+        m_shadowGroups.back().count++;
+    }
+    StreamTransforms(m_shadowTransforms, m_shadowVBO, m_shadowCapacity);
+
+    shader.SetInt(Uniforms::Instanced, 1);
+    for (const InstanceGroup& group : m_shadowGroups) {
+        group.mesh->DrawInstanced(group.count, m_shadowVBO, group.firstInstance * sizeof(Mat4));
+        m_shadowDrawCalls++;
+    }
 }
 
 // ============================================================================
@@ -498,11 +2160,15 @@ void StaticWorldRenderer::SetAmbientLight(const Vec3& color, float intensity) {
 
 void StaticWorldRenderer::ResetStats() {
     m_drawCalls = 0;
+    m_prepassDrawCalls = 0;
     m_materialSwitches = 0;
     m_trianglesRendered = 0;
     m_verticesRendered = 0;
     m_objectsRendered = 0;
     m_objectsCulled = 0;
+    m_objectsOccluded = 0;
+    m_objectsPvsCulled = 0;
+    m_occluderTriangles = 0;
 }
 
 // ============================================================================
@@ -511,15 +2177,28 @@ void StaticWorldRenderer::ResetStats() {
 
 void StaticWorldRenderer::PrintDebugInfo() const {
     std::cout << "=== StaticWorldRenderer Debug ===" << std::endl;
-    std::cout << "Total Objects: " << m_objects.size() << std::endl;
+    std::cout << "Total Objects: " << GetObjectCount() << " (" << m_handles.GetFreeCount() << " free slots)" << std::endl;
     std::cout << "Render Batches: " << m_batches.size() << std::endl;
+    std::cout << "Merged Groups: " << GetMergedGroupCount()
+              << (m_staticMerging ? "" : " (auto merge off)")
+              << (m_gpuCull.IsInitialized() ? ", GPU-driven" : "") << std::endl;
+    if (m_prepass.IsInitialized() || m_frontToBack) {
+        std::cout << "Overdraw: " << (m_prepass.IsInitialized() ? "depth prepass" : "")
+                  << (m_prepass.IsInitialized() && m_frontToBack ? ", " : "")
+                  << (m_frontToBack ? "front to back" : "") << std::endl;
+    }
+    if (m_materialBatching != MaterialBatching::Off) {
+        std::cout << "Material Tables: " << GetMaterialTableCount()
+                  << (m_materialBatching == MaterialBatching::Bindless && MaterialTable::IsBindlessSupported()
+                      ? " (bindless)" : " (texture arrays)") << std::endl;
+    }
 
     // Count by type
     int floors = 0, ceilings = 0, walls = 0, props = 0, propsDecorative = 0, structural = 0, generic = 0;
     int withCollision = 0, withoutCollision = 0;
 
-    for (const auto& obj : m_objects) {
-        switch (obj.type) {
+    for (size_t i = 0; i < m_hot.size(); i++) {
+        switch (m_hot[i].type) {
             case StaticObjectType::Floor: floors++; break;
             case StaticObjectType::Ceiling: ceilings++; break;
             case StaticObjectType::Wall: walls++; break;
@@ -530,7 +2209,7 @@ void StaticWorldRenderer::PrintDebugInfo() const {
             case StaticObjectType::Generic: generic++; break;
         }
 
-        if (obj.HasCollision()) {
+        if (m_info[i].HasCollision()) {
             withCollision++;
         } else {
             withoutCollision++;
@@ -554,6 +2233,22 @@ void StaticWorldRenderer::PrintDebugInfo() const {
     std::cout << "  Triangles: " << m_trianglesRendered << std::endl;
     std::cout << "  Objects Rendered: " << m_objectsRendered << std::endl;
     std::cout << "  Objects Culled: " << m_objectsCulled << std::endl;
+    std::cout << "  Objects Occluded: " << m_objectsOccluded << std::endl;
+    std::cout << "  Objects PVS Culled: " << m_objectsPvsCulled << std::endl;
+    if (m_shadows.IsInitialized()) {
+        std::cout << "  Shadow Cascades Redrawn: " << m_shadows.GetCascadesRendered() << " of "
+                  << m_shadows.GetCascadeCount() << " (" << m_shadows.GetTotalCascadesRendered()
+                  << " total), " << m_shadowDrawCalls << " draws" << std::endl;
+    }
+    if (m_lightmapTexture != 0) {
+        std::cout << "  Lightmap: " << m_lightmapSize << "x" << m_lightmapSize << " x "
+                  << m_lightmapLayers << " layer(s)" << std::endl;
+    }
+    const ClusterStats& lights = m_lights.GetStats();
+    if (lights.lights > 0) {
+        std::cout << "  Local Lights: " << lights.visibleLights << " of " << lights.lights << " in view, "
+                  << lights.indices << " cluster refs (max " << lights.maxPerCluster << ")" << std::endl;
+    }
     std::cout << "=================================" << std::endl;
 }
 
@@ -563,66 +2258,86 @@ void StaticWorldRenderer::PrintDebugInfo() const {
 
 size_t StaticWorldRenderer::GetCollisionObjectCount() const {
     size_t count = 0;
-    for (const auto& obj : m_objects) {
-        if (obj.HasCollision()) {
+    for (const auto& info : m_info) {
+        if (info.HasCollision()) {
             count++;
         }
     }
     return count;
 }
 
-std::vector<const StaticObject*> StaticWorldRenderer::GetCollisionObjects() const {
-    std::vector<const StaticObject*> result;
-    result.reserve(m_objects.size());
-
-    for (const auto& obj : m_objects) {
-        if (obj.HasCollision()) {
-            result.push_back(&obj);
+template<typename Fn>
+void StaticWorldRenderer::ForEachCollisionObject(Fn&& fn) const {
+    for (uint32_t i = 0; i < static_cast<uint32_t>(m_info.size()); i++) {
+        if (m_info[i].HasCollision()) {
+            fn(m_handles.GetHandle(i));
         }
     }
+}
 
+std::vector<StaticObjectHandle> StaticWorldRenderer::GetCollisionObjects() const {
+    std::vector<StaticObjectHandle> result;
+    result.reserve(m_info.size());
+    ForEachCollisionObject([&](StaticObjectHandle handle) { result.push_back(handle); });
     return result;
 }
 
-std::vector<AABB> StaticWorldRenderer::GetCollisionAABBs() const {
-    std::vector<AABB> result;
-    result.reserve(m_objects.size());
+std::span<const StaticObjectHandle> StaticWorldRenderer::GetCollisionObjects(FrameArena& arena) const {
+    // Allocate for the worst case, then hand the unused tail back
+    StaticObjectHandle* out = arena.AllocateArray<StaticObjectHandle>(m_info.size());
+    size_t count = 0;
+    ForEachCollisionObject([&](StaticObjectHandle handle) { out[count++] = handle; });
+    return arena.Shrink(out, count);
+}
 
-    for (const auto& obj : m_objects) {
-        if (obj.HasCollision()) {
-            result.push_back(obj.GetCollisionAABB());
-        }
-    }
+StaticObjectHandle StaticWorldRenderer::GetColliderOwner(ColliderHandle collider) const {
+    const auto& physics = PhysicsWorld::Instance();
+    if (!physics.IsAlive(collider)) return StaticObjectHandle();
 
-    return result;
-}
+    uint64_t userData = physics.GetUserData(collider.index);
+    StaticObjectHandle handle;
+    handle.index = static_cast<uint32_t>(userData);
+    handle.generation = static_cast<uint32_t>(userData >> 32);
 
-bool StaticWorldRenderer::PointInAnyCollider(const Vec3& point) const {
-    for (const auto& obj : m_objects) {
-        if (obj.HasCollision() && obj.collider->ContainsPoint(point, obj.transform)) {
-            return true;
-        }
+    const StaticObjectInfo* info = GetInfo(handle);
+    if (!info || info->physics != collider) {
+        return StaticObjectHandle();
     }
-    return false;
+    return handle;
 }
 
-std::vector<const StaticObject*> StaticWorldRenderer::QueryAABB(const AABB& aabb) const {
-    std::vector<const StaticObject*> result;
+StaticObjectHandle StaticWorldRenderer::Raycast(const Vec3& origin, const Vec3& direction,
+                                                float maxDistance, float* outDistance) const {
+    EnsureBVH();
 
-    for (const auto& obj : m_objects) {
-        if (!obj.HasCollision()) continue;
+    Vec3 invDir(
+        1.0f / (std::abs(direction.x) > Math::EPSILON ? direction.x : Math::EPSILON),
+        1.0f / (std::abs(direction.y) > Math::EPSILON ? direction.y : Math::EPSILON),
+        1.0f / (std::abs(direction.z) > Math::EPSILON ? direction.z : Math::EPSILON)
+    );
 
-        AABB objAABB = obj.GetCollisionAABB();
+    StaticObjectHandle closest;
+    float closestDist = maxDistance;
 
-        // Check AABB overlap
-        if (aabb.max.x >= objAABB.min.x && aabb.min.x <= objAABB.max.x &&
-            aabb.max.y >= objAABB.min.y && aabb.min.y <= objAABB.max.y &&
-            aabb.max.z >= objAABB.min.z && aabb.min.z <= objAABB.max.z) {
-            result.push_back(&obj);
+    m_renderBVH.Raycast(origin, direction, maxDistance, [&](uint32_t slot, float& maxDist) {
+        uint32_t index = m_handles.GetDenseIndexOfSlot(slot);
+        if (index == SlotMap::INVALID_INDEX) return;
+
+        const StaticObjectHot& hot = m_hot[index];
+        if (!hot.IsVisible() || hot.mesh == INVALID_INDEX || hot.material == INVALID_INDEX) return;
+
+        float t;
+        if (BVH::RayAABB(origin, invDir, m_renderBounds[slot], maxDist, t)) {
+            closest = m_handles.GetHandle(index);
+            closestDist = t;
+            maxDist = t;  // Prune anything farther
         }
-    }
+    });
 
-    return result;
+    if (closest.IsValid() && outDistance) {
+        *outDistance = closestDist;
+    }
+    return closest;
 }
 
 } // namespace Genesis
@@ -1,9 +1,23 @@
 #pragma once
 
 #include "math/Math.h"
+#include "math/Frustum.h"
+#include "math/BVH.h"
 #include "renderer/mesh/Mesh.h"
 #include "renderer/material/Material.h"
+#include "renderer/material/MaterialTable.h"
+#include "renderer/world/CascadedShadows.h"
+#include "renderer/world/ClusteredLighting.h"
+#include "renderer/world/DepthPrepass.h"
+#include "renderer/world/GpuCulling.h"
+#include "renderer/world/OcclusionCulling.h"
+#include "map/MapVis.h"
+#include "map/Lightmap.h"
 #include "physics/Collider.h"
+#include "physics/PhysicsWorld.h"
+#include "core/SlotMap.h"
+#include "core/FrameArena.h"
+#include <span>
 #include <vector>
 #include <memory>
 #include <string>
@@ -14,10 +28,13 @@ namespace Genesis {
 // Forward declarations
 class FPSCamera;
 
+// Stable reference to an object added to StaticWorldRenderer
+using StaticObjectHandle = SlotHandle;
+
 // ============================================================================
 // Static Object Types - For categorization and culling
 // ============================================================================
-enum class StaticObjectType {
+enum class StaticObjectType : uint8_t {
     Generic,        // Uncategorized static object
     Floor,          // Floor geometry
     Ceiling,        // Ceiling geometry
@@ -29,12 +46,16 @@ enum class StaticObjectType {
 };
 
 // ============================================================================
-// Static Object - Represents a single static world object
+// Static Object - Describes a single static world object
 //
 // DECOUPLED DESIGN (Source Engine style):
 // - mesh/material: Visual representation only
 // - collider: Optional collision shape (can be nullptr for decorative props)
 // - The collision shape can be DIFFERENT from the visual mesh
+//
+// This is the interchange form for Add/Update/Get. The renderer stores it
+// split into StaticObjectHot (what the render loops read) and
+// StaticObjectInfo (everything else).
 // ============================================================================
 struct StaticObject {
     // Visual (Render)
@@ -50,6 +71,7 @@ struct StaticObject {
     StaticObjectType type = StaticObjectType::Generic;
     bool visible = true;
     bool castShadow = true;
+    bool receiveShadow = true;
 
     // Bounding box in world space (for culling)
     Vec3 worldBoundsMin = Vec3(0.0f);
@@ -75,6 +97,9 @@ struct StaticObject {
     // Update world bounds from mesh bounds and transform
     void UpdateWorldBounds();
 
+    // World AABB of a mesh's local bounds under a transform (zero without a mesh)
+    static void ComputeWorldBounds(const Mesh* mesh, const Mat4& transform, Vec3& outMin, Vec3& outMax);
+
     // Check if object is valid for rendering
     bool IsValid() const { return mesh != nullptr && material != nullptr && visible; }
 
@@ -90,12 +115,117 @@ struct StaticObject {
     }
 };
 
+// ============================================================================
+// Static Object Hot Data - What culling and drawing touch, 80 bytes
+//
+// Mesh/material are ids into the renderer's resource tables, so the render
+// loops walk a contiguous array without chasing shared_ptrs. World bounds
+// live next to it in the SoA cull bounds.
+// ============================================================================
+enum StaticObjectFlags : uint8_t {
+    STATIC_OBJECT_VISIBLE        = 1 << 0,
+    STATIC_OBJECT_CAST_SHADOW    = 1 << 1,
+    STATIC_OBJECT_RECEIVE_SHADOW = 1 << 2
+};
+
+constexpr uint16_t STATIC_OBJECT_NO_AREA = 0xFFFF;
+
+struct StaticObjectHot {
+    Mat4 transform = Mat4(1.0f);
+    uint32_t mesh = 0xFFFFFFFFu;       // Mesh id (0xFFFFFFFF = none)
+    uint32_t material = 0xFFFFFFFFu;   // Material id (0xFFFFFFFF = none)
+    uint32_t layer = 0;
+    uint8_t flags = STATIC_OBJECT_VISIBLE;
+    StaticObjectType type = StaticObjectType::Generic;  // RenderType() filter
+    uint16_t area = STATIC_OBJECT_NO_AREA;              // Vis area (SetVisData)
+
+    bool IsVisible() const { return (flags & STATIC_OBJECT_VISIBLE) != 0; }
+    bool CastsShadow() const { return (flags & STATIC_OBJECT_CAST_SHADOW) != 0; }
+    bool ReceivesShadow() const { return (flags & STATIC_OBJECT_RECEIVE_SHADOW) != 0; }
+};
+
+static_assert(sizeof(StaticObjectHot) == 80, "StaticObjectHot should stay compact");
+
+// ============================================================================
+// Static Object Info - Cold metadata, only read by queries and tools
+// ============================================================================
+struct StaticObjectInfo {
+    std::string name;
+    ColliderPtr collider = nullptr;  // nullptr = no collision (decorative)
+
+    // The collider placed in the PhysicsWorld (re-added when the object is
+    // stored or moved); its user data is the packed StaticObjectHandle
+    ColliderHandle physics;
+
+    bool HasCollision() const { return collider != nullptr; }
+};
+
 // ============================================================================
 // Render Batch - Groups objects by material for efficient rendering
+//
+// Objects are sorted by mesh, so objects sharing a mesh are contiguous and
+// can be drawn as one instanced group. Entries are dense object indices;
+// the renderer patches them when a removal moves an object.
 // ============================================================================
 struct RenderBatch {
     MaterialPtr material;
-    std::vector<const StaticObject*> objects;
+    std::vector<uint32_t> objects;
+    bool meshSorted = true;   // Cleared by incremental add/remove
+};
+
+// ============================================================================
+// Instance Group - One draw call worth of visible objects
+//
+// Instanced groups read transforms [firstInstance, firstInstance + count)
+// from the instance buffer. Non-instanced groups draw 'object' alone.
+// ============================================================================
+struct InstanceGroup {
+    const RenderBatch* batch = nullptr;
+    const Mesh* mesh = nullptr;
+    uint32_t object = 0;                   // Dense index of the first object
+    uint32_t firstInstance = 0;
+    uint32_t count = 0;
+    bool instanced = false;
+    bool receiveShadows = true;   // Objects of a group agree on it
+    float distance = 0.0f;        // Nearest object origin to the camera, squared (front-to-back)
+};
+
+// ============================================================================
+// Merged Geometry - Static objects baked into one shared buffer
+//
+// One group per (material, vertex layout): the world-space vertices of all
+// its objects live in a single VAO/VBO/EBO with 32-bit indices, and each
+// object's index range is recorded so the visible ones are drawn with one
+// glMultiDrawElements (adjacent visible ranges are coalesced first).
+//
+// With material batching a group is per (MaterialTable, vertex layout)
+// instead: its ranges are sorted by material, every vertex carries its
+// material's table slot, and the whole group is still one draw.
+// ============================================================================
+struct MergedRange {
+    uint32_t object = 0;        // Dense object index
+    uint32_t firstIndex = 0;
+    uint32_t indexCount = 0;
+    uint32_t firstVertex = 0;
+    uint32_t vertexCount = 0;
+    uint32_t materialSlot = 0;  // In the group's table
+};
+
+struct MergedGroup {
+    MaterialPtr material;              // The first material of a table group
+    MaterialTablePtr table;            // Material batching, else nullptr
+    MeshPtr mesh;
+    std::vector<MergedRange> ranges;   // In buffer order
+    uint32_t firstCommand = 0;         // GPU-driven: command of ranges[0]
+};
+
+// ============================================================================
+// Material Batching - How merged geometry of different materials shares draws
+// ============================================================================
+enum class MaterialBatching {
+    Off,            // One merged group per material
+    TextureArrays,  // Material tables, textures packed into 2D arrays
+    Bindless        // Material tables, ARB_bindless_texture handles (else arrays)
 };
 
 // ============================================================================
@@ -110,7 +240,7 @@ struct RenderBatch {
 //   auto& world = StaticWorldRenderer::Instance();
 //
 //   // WITH collision (floors, walls, platforms)
-//   world.AddFloor(floorMesh, floorMaterial, floorTransform);  // Auto-generates box collider
+//   auto floor = world.AddFloor(floorMesh, floorMaterial, floorTransform);  // Auto-generates box collider
 //   world.AddWall(wallMesh, wallMaterial, wallTransform);      // Auto-generates box collider
 //
 //   // WITHOUT collision (decorative props)
@@ -123,8 +253,12 @@ struct RenderBatch {
 //   // In render loop:
 //   world.Render(camera);
 //
-//   // Get all collision shapes for physics:
-//   auto& colliders = world.GetCollisionObjects();
+//   // Colliders are placed in the PhysicsWorld, which answers the queries:
+//   PhysicsWorld::Instance().PointInAnyCollider(point);
+//
+// Add* returns a generational handle that stays valid until that object is
+// removed. Objects are stored densely (removal moves the last object into the
+// hole), so the render loops never skip dead entries.
 // ============================================================================
 class StaticWorldRenderer {
 public:
@@ -138,57 +272,74 @@ public:
     // ========================================================================
 
     // Add a generic static object
-    size_t Add(const StaticObject& obj);
-    size_t Add(MeshPtr mesh, MaterialPtr material, const Mat4& transform = Mat4(1.0f));
+    StaticObjectHandle Add(const StaticObject& obj);
+    StaticObjectHandle Add(MeshPtr mesh, MaterialPtr material, const Mat4& transform = Mat4(1.0f));
 
     // Add with explicit collider
-    size_t Add(MeshPtr mesh, MaterialPtr material, ColliderPtr collider, const Mat4& transform = Mat4(1.0f));
+    StaticObjectHandle Add(MeshPtr mesh, MaterialPtr material, ColliderPtr collider, const Mat4& transform = Mat4(1.0f));
 
     // Convenience methods - these AUTO-GENERATE box colliders from transform scale
-    size_t AddFloor(MeshPtr mesh, MaterialPtr material, const Mat4& transform = Mat4(1.0f));
-    size_t AddCeiling(MeshPtr mesh, MaterialPtr material, const Mat4& transform = Mat4(1.0f));
-    size_t AddWall(MeshPtr mesh, MaterialPtr material, const Mat4& transform = Mat4(1.0f));
-    size_t AddStructural(MeshPtr mesh, MaterialPtr material, const Mat4& transform = Mat4(1.0f));
+    StaticObjectHandle AddFloor(MeshPtr mesh, MaterialPtr material, const Mat4& transform = Mat4(1.0f));
+    StaticObjectHandle AddCeiling(MeshPtr mesh, MaterialPtr material, const Mat4& transform = Mat4(1.0f));
+    StaticObjectHandle AddWall(MeshPtr mesh, MaterialPtr material, const Mat4& transform = Mat4(1.0f));
+    StaticObjectHandle AddStructural(MeshPtr mesh, MaterialPtr material, const Mat4& transform = Mat4(1.0f));
 
     // ========================================================================
     // Prop Management - Decorative vs Physics props
     // ========================================================================
 
     // Prop WITH collision (auto-generates box collider)
-    size_t AddProp(const std::string& name, MeshPtr mesh, MaterialPtr material, const Mat4& transform = Mat4(1.0f));
+    StaticObjectHandle AddProp(const std::string& name, MeshPtr mesh, MaterialPtr material, const Mat4& transform = Mat4(1.0f));
 
     // Prop WITH custom collider
-    size_t AddProp(const std::string& name, MeshPtr mesh, MaterialPtr material, ColliderPtr collider, const Mat4& transform = Mat4(1.0f));
+    StaticObjectHandle AddProp(const std::string& name, MeshPtr mesh, MaterialPtr material, ColliderPtr collider, const Mat4& transform = Mat4(1.0f));
 
     // Prop WITHOUT collision (purely decorative - like Source's prop_static with no collision)
-    size_t AddPropDecorative(const std::string& name, MeshPtr mesh, MaterialPtr material, const Mat4& transform = Mat4(1.0f));
+    StaticObjectHandle AddPropDecorative(const std::string& name, MeshPtr mesh, MaterialPtr material, const Mat4& transform = Mat4(1.0f));
 
     // Bulk operations
     void AddMany(const std::vector<StaticObject>& objects);
 
-    // Remove object by index
-    void Remove(size_t index);
+    // Remove an object (O(1); render batches stay valid). Stale handles are ignored.
+    void Remove(StaticObjectHandle handle);
+
+    // Replace an object in place, keeping its handle (O(1))
+    void Update(StaticObjectHandle handle, const StaticObject& obj);
 
-    // Clear all objects
+    // False once the object has been removed (or the renderer cleared)
+    bool IsAlive(StaticObjectHandle handle) const { return m_handles.IsAlive(handle); }
+
+    // Clear all objects (outstanding handles become stale)
     void Clear();
 
-    // Get object by index
-    StaticObject* Get(size_t index);
-    const StaticObject* Get(size_t index) const;
+    // Reassemble an object's description (false if the handle is stale)
+    bool Get(StaticObjectHandle handle, StaticObject& out) const;
+
+    // Direct reads of the split storage (nullptr if the handle is stale)
+    const StaticObjectHot* GetHot(StaticObjectHandle handle) const;
+    const StaticObjectInfo* GetInfo(StaticObjectHandle handle) const;
+    const Mat4* GetTransform(StaticObjectHandle handle) const;
+
+    // Live objects are packed at [0, GetObjectCount()); order changes on removal
+    StaticObjectHandle GetHandle(size_t index) const { return m_handles.GetHandle(static_cast<uint32_t>(index)); }
 
-    // Get all objects
-    const std::vector<StaticObject>& GetObjects() const { return m_objects; }
-    std::vector<StaticObject>& GetObjects() { return m_objects; }
+    // Get live object count
+    size_t GetObjectCount() const { return m_hot.size(); }
 
-    // Get object count
-    size_t GetObjectCount() const { return m_objects.size(); }
+    // Move an existing object (O(1); the BVH is refit lazily on next use)
+    void SetTransform(StaticObjectHandle handle, const Mat4& transform);
+
+    // Per-tick move of a moving platform: when only the translation changed
+    // the collider is moved in the PhysicsWorld (keeping its handle and
+    // picking up a velocity) instead of being re-registered
+    void MoveObject(StaticObjectHandle handle, const Mat4& transform, float deltaTime);
 
     // ========================================================================
     // Visibility Control
     // ========================================================================
 
     // Set visibility of specific object
-    void SetVisible(size_t index, bool visible);
+    void SetVisible(StaticObjectHandle handle, bool visible);
 
     // Set visibility by type
     void SetTypeVisible(StaticObjectType type, bool visible);
@@ -224,6 +375,102 @@ public:
     void SetAutoBatching(bool enabled) { m_autoBatching = enabled; }
     bool IsAutoBatching() const { return m_autoBatching; }
 
+    // Enable/disable instanced drawing in Render(): one draw per unique
+    // (mesh, material) pair. Only used with shaders that declare u_Instanced.
+    void SetInstancing(bool enabled) { m_instancing = enabled; }
+    bool IsInstancing() const { return m_instancing; }
+
+    // ========================================================================
+    // Static Geometry Merging
+    // ========================================================================
+
+    // Bake opaque triangle meshes into one buffer per material (see
+    // MergedGroup). Render() then draws them with a handful of binds and
+    // leaves instancing to whatever could not be merged (transparent
+    // materials, non-triangle meshes, meshes without CPU-side vertices).
+    void MergeStaticGeometry();
+
+    // Re-merge automatically in Render() after objects are added, removed or
+    // replaced. SetTransform() patches the merged vertices in place.
+    void SetStaticMerging(bool enabled) { m_staticMerging = enabled; }
+    bool IsStaticMerging() const { return m_staticMerging; }
+
+    size_t GetMergedGroupCount() const { return m_mergeDirty ? 0 : m_mergedGroups.size(); }
+
+    // Merge opaque materials that share a shader, keywords and render state
+    // into one MaterialTable (see MergedGroup), so they draw together on
+    // both the CPU and the GPU-driven path. Texture arrays need equal
+    // texture formats and sizes per property; materials that don't fit
+    // get groups of their own. Takes effect at the next merge.
+    void SetMaterialBatching(MaterialBatching mode);
+    MaterialBatching GetMaterialBatching() const { return m_materialBatching; }
+    size_t GetMaterialTableCount() const { return m_mergeDirty ? 0 : m_materialTables.size(); }
+
+    // GPU-driven merged draws (OpenGL 4.3): merged objects' bounds live in
+    // an SSBO, a compute shader frustum culls them into an indirect command
+    // buffer, and each merged group is one glMultiDrawElementsIndirect, so
+    // the CPU cost no longer scales with the merged object count. Stays off
+    // (CPU culling) when the context lacks 4.3. Needs a current GL context;
+    // SetGpuDriven(false) releases the GPU resources.
+    void SetGpuDriven(bool enabled);
+    bool IsGpuDriven() const { return m_gpuCull.IsInitialized(); }
+
+    // ========================================================================
+    // Overdraw
+    // ========================================================================
+
+    // Depth prepass (see DepthPrepass): opaque merged groups and instance
+    // groups are drawn depth-only first, then shaded with GL_EQUAL so each
+    // pixel runs its material once. Costs a second geometry pass, so it
+    // pays off with expensive fragments (many lights) and heavy overdraw.
+    // Needs a current GL context; SetDepthPrepass(false) releases the shader.
+    void SetDepthPrepass(bool enabled);
+    bool IsDepthPrepass() const { return m_prepass.IsInitialized(); }
+
+    // Draw the opaque instance groups nearest first (by object origin, and
+    // the instances of a group likewise) instead of in batch order, so
+    // early depth rejects what they hide. Transparent groups keep their
+    // order, and merged groups their buffer order. Costs more material
+    // switches when batches interleave.
+    void SetFrontToBack(bool enabled) { m_frontToBack = enabled; }
+    bool IsFrontToBack() const { return m_frontToBack; }
+
+    // Fragments shaded by the color pass over the viewport's pixels,
+    // measured with an occlusion query (a few frames late, see DepthPrepass)
+    void SetOverdrawMeasure(bool enabled) { m_prepass.SetMeasureOverdraw(enabled); }
+    bool IsOverdrawMeasure() const { return m_prepass.IsMeasuringOverdraw(); }
+    float GetOverdraw() const { return m_prepass.GetOverdraw(); }
+
+    // ========================================================================
+    // Culling Control
+    // ========================================================================
+
+    // Enable/disable view frustum culling in Render()
+    void SetFrustumCulling(bool enabled) { m_frustumCulling = enabled; }
+    bool IsFrustumCulling() const { return m_frustumCulling; }
+
+    // Occlusion culling (needs frustum culling): walls and floors that pass
+    // the frustum test are rasterized into a CPU depth pyramid, and objects
+    // hidden behind them are skipped (GetObjectsOccluded). Merged objects
+    // on the GPU-driven path get the result through their cull flags.
+    void SetOcclusionCulling(bool enabled) { m_occlusionCulling = enabled; }
+    bool IsOcclusionCulling() const { return m_occlusionCulling; }
+
+    // PVS culling: with vis data set, objects inside an area the camera's
+    // area can't see are skipped before the frustum and occlusion results
+    // are used (GetObjectsPvsCulled). Objects spanning several areas, and
+    // cameras outside every area, are never PVS culled.
+    void SetVisData(MapVisPtr vis);
+    const MapVisPtr& GetVisData() const { return m_vis; }
+    void SetPVSCulling(bool enabled) { m_pvsCulling = enabled; }
+    bool IsPVSCulling() const { return m_pvsCulling; }
+
+    // Meshes with an LOD chain (Mesh::AddLOD) draw the level matching their
+    // projected size. They are never merged, so they can switch per frame.
+    // Bias scales the projected size: above 1 keeps detail longer.
+    void SetLODBias(float bias) { m_lodBias = bias; }
+    float GetLODBias() const { return m_lodBias; }
+
     // ========================================================================
     // Lighting (Global for all static objects)
     // ========================================================================
@@ -231,6 +478,30 @@ public:
     void SetDirectionalLight(const Vec3& direction, const Vec3& color, float intensity = 1.0f);
     void SetAmbientLight(const Vec3& color, float intensity = 1.0f);
 
+    // Cascaded shadow maps of the directional light (see CascadedShadowMap).
+    // Objects flagged castShadow are drawn into the cascades with a
+    // depth-only shader, culled per cascade through the BVH; the layers are
+    // cached and redrawn only when the light, the camera's slice or a
+    // caster inside them changes. Objects without receiveShadow are drawn
+    // unshadowed (and never merged with ones that are). Needs a current GL
+    // context; SetShadows(false) releases the GPU resources.
+    void SetShadows(bool enabled);
+    bool HasShadows() const { return m_shadows.IsInitialized(); }
+    CascadedShadowMap& GetShadows() { return m_shadows; }
+
+    // Point and spot lights, clustered per view (see ClusteredLighting).
+    // Cleared with the objects; their Shutdown() releases the GPU buffers.
+    ClusteredLighting& GetLights() { return m_lights; }
+    const ClusteredLighting& GetLights() const { return m_lights; }
+
+    // Baked sun visibility and indirect light (see MapLightmap), uploaded
+    // as a texture array at TextureUnit::Lightmap. Vertices with lightmap
+    // coordinates (Mesh::SetLightmapUVs) read it in place of the shadow
+    // cascades and the flat ambient; others are lit as before. nullptr (or
+    // Clear()) releases the texture.
+    void SetLightmap(const MapLightmapPtr& lightmap);
+    bool HasLightmap() const { return m_lightmapTexture != 0; }
+
     // ========================================================================
     // Statistics
     // ========================================================================
@@ -240,28 +511,38 @@ public:
     uint32_t GetTrianglesRendered() const { return m_trianglesRendered; }
     uint32_t GetVerticesRendered() const { return m_verticesRendered; }
     uint32_t GetObjectsRendered() const { return m_objectsRendered; }
-    uint32_t GetObjectsCulled() const { return m_objectsCulled; }
+    uint32_t GetObjectsCulled() const { return m_objectsCulled; }     // Frustum and layer
+    uint32_t GetObjectsOccluded() const { return m_objectsOccluded; }
+    uint32_t GetObjectsPvsCulled() const { return m_objectsPvsCulled; }
+    uint32_t GetOccluderTriangles() const { return m_occluderTriangles; }
+    uint32_t GetShadowDrawCalls() const { return m_shadowDrawCalls; }
+    uint32_t GetPrepassDrawCalls() const { return m_prepassDrawCalls; }
+    uint32_t GetShadowCascadesRendered() const { return m_shadows.GetCascadesRendered(); }
 
     void ResetStats();
 
     // ========================================================================
-    // Collision Queries - Get collision data for physics
+    // Collision - Colliders are stored in the PhysicsWorld, which answers
+    // the spatial queries (QueryAABB, PointInAnyCollider)
     // ========================================================================
 
     // Get number of objects with collision
     size_t GetCollisionObjectCount() const;
 
-    // Get all objects that have collision (for physics system)
-    std::vector<const StaticObject*> GetCollisionObjects() const;
+    // Get all objects that have collision
+    std::vector<StaticObjectHandle> GetCollisionObjects() const;
 
-    // Get all collision AABBs (for legacy WorldCollision integration)
-    std::vector<AABB> GetCollisionAABBs() const;
+    // Per-frame variant: results live in the arena (valid until its Reset)
+    std::span<const StaticObjectHandle> GetCollisionObjects(FrameArena& arena) const;
 
-    // Query: Does any collider contain this point?
-    bool PointInAnyCollider(const Vec3& point) const;
+    // Object owning a PhysicsWorld collider (invalid for other colliders or
+    // stale ones)
+    StaticObjectHandle GetColliderOwner(ColliderHandle collider) const;
 
-    // Query: Get all colliders overlapping an AABB
-    std::vector<const StaticObject*> QueryAABB(const AABB& aabb) const;
+    // Picking: closest visible object whose render bounds the ray hits
+    // (direction must be normalized). Returns an invalid handle on miss.
+    StaticObjectHandle Raycast(const Vec3& origin, const Vec3& direction, float maxDistance,
+                               float* outDistance = nullptr) const;
 
     // ========================================================================
     // Debug
@@ -276,24 +557,253 @@ private:
     StaticWorldRenderer& operator=(const StaticWorldRenderer&) = delete;
 
     // Internal rendering
-    void RenderObject(const StaticObject& obj, Shader& shader);
+    void RenderObject(const Mesh& mesh, const Mat4& transform, Shader& shader);
+    template<typename Filter>
+    void RenderFiltered(const FPSCamera& camera, Filter&& filter);
+    void RenderInstanced(const InstanceGroup& group);
+    Material* RenderMerged(const FPSCamera& camera);   // Returns the last bound material
+    Material* RenderMergedIndirect(const FPSCamera& camera);
+    void DispatchGpuCull(const FPSCamera& camera);
+
+    // Depth prepass of the opaque merged and instance groups
+    void RenderDepthPrepass(bool gpuDriven);
+    bool CanPrepass(const MergedGroup& group) const;
+    void SetColorPassDepth(bool prepassed);
+
+    // Front-to-back order of the opaque instance groups
+    void SortFrontToBack(const Vec3& eye);
+    bool IsLayerHidden(uint32_t layer) const;
+    void RecordDraw(const Mesh& mesh, uint32_t instanceCount);
     void UploadGlobalUniforms(Shader& shader, const FPSCamera& camera);
+    void UploadFrameUniforms(const FPSCamera& camera);
+
+    // Instancing
+    void BuildInstanceGroups();
+    void FlushLODRun(const RenderBatch& batch);
+    void UploadInstanceData();
 
-    // Batching
+    // Shadows: redraw the cascades Update() reports
+    void RenderShadows(const FPSCamera& camera);
+    void CollectShadowCasters(const Frustum& frustum);
+    void DrawShadowCasters(Shader& shader);
+    bool IsShadowCaster(uint32_t index) const;
+    void InvalidateShadows(uint32_t index);   // Its current bounds, if it casts
+
+    // LOD level of an object's mesh for this frame's camera
+    void SetupLODSelection(const FPSCamera& camera);
+    uint32_t SelectLOD(uint32_t index, const Mesh& mesh) const;
+
+    // Bounding sphere diameter over the screen height, times scale
+    float ProjectedSize(uint32_t index, float scale) const;
+
+    // Largest on-screen size per batch, to the material's streamed textures
+    void RequestTextureDetail(bool frustumTested);
+
+    // Batching (arguments are dense object indices)
     void BuildBatches();
+    void InsertIntoBatch(uint32_t index);
+    void RemoveFromBatch(uint32_t index);
+    void SortDirtyBatches();
+
+    // Merging
+    bool CanMerge(uint32_t index) const;
+    bool IsMerged(uint32_t index) const {
+        return !m_mergeDirty && index < m_mergeRefs.size() && m_mergeRefs[index].group != INVALID_INDEX;
+    }
+    void PatchMergedVertices(uint32_t index);
+
+    // Give each mergeable material a table slot (material batching)
+    struct TableSlot {
+        uint32_t table = INVALID_INDEX;
+        uint32_t slot = 0;
+    };
+    void AssignMaterialTables(const std::vector<uint32_t>& objects,
+                              std::unordered_map<uint32_t, TableSlot>& slots);
+
+    // Visible ranges of group.ranges[begin, end) into m_mergeFirst/Counts,
+    // coalesced where they touch (and, with splitMaterials, share a
+    // material); adds them to the stats unless countStats is false.
+    // False if none is visible.
+    bool CollectMergedRanges(const MergedGroup& group, size_t begin, size_t end, bool splitMaterials,
+                             bool countStats = true);
+
+    // End of the run of ranges sharing ranges[begin]'s material
+    size_t GetMaterialRunEnd(const MergedGroup& group, size_t begin) const;
+    void UploadGpuObjects();
+    GpuCullObject BuildGpuObject(uint32_t index) const;
+
+    // Culling
+    void CullObjects(const FPSCamera& camera);
+    void ApplyPVS(uint32_t cameraArea);
+    void OcclusionCull(const FPSCamera& camera);
+    uint8_t GetHidden(uint32_t index) const {
+        return m_hiddenActive && index < m_objectHidden.size() ? m_objectHidden[index] : HIDDEN_NONE;
+    }
+    bool IsHidden(uint32_t index) const { return GetHidden(index) != HIDDEN_NONE; }
+    bool SkipHidden(uint32_t index);   // IsHidden, counting it in the stats
+    void UpdateGpuHidden();
+    uint16_t FindObjectArea(uint32_t index) const;
+
+    // Query visitors shared by the vector and arena variants
+    template<typename Fn> void ForEachCollisionObject(Fn&& fn) const;
+
+    // Spatial hierarchy (rebuilt lazily after adds, refit after moves).
+    // BVH leaves are slot indices, which don't move on removal.
+    void RebuildBVH() const;
+    void RefitBVH() const;
+    void UpdateSpatialBounds(uint32_t slot);
+    void EnsureBVH() const {
+        if (m_bvhDirty) {
+            RebuildBVH();
+        } else if (m_bvhNeedsRefit) {
+            RefitBVH();
+        }
+    }
 
     // Helper: Create a box collider from transform (extracts scale)
     static ColliderPtr CreateBoxColliderFromTransform(const Mat4& transform);
 
+    // Split a description into the hot/cold arrays at a dense index
+    void StoreObject(uint32_t index, const StaticObject& obj);
+    void UpdateDerived(uint32_t index);
+    void UpdateRenderBounds(uint32_t index);
+    void FinishTransformChange(uint32_t index, StaticObjectHandle handle);
+    void ReleaseResources(uint32_t meshId, uint32_t materialId);
+
+    // Shared mesh/material tables: objects hold ids, entries are refcounted
+    // and recycled once no object uses them
+    template<typename T>
+    struct ResourceTable {
+        std::vector<std::shared_ptr<T>> items;
+        std::vector<uint32_t> refs;
+        std::vector<uint32_t> freeIds;
+        std::unordered_map<const T*, uint32_t> ids;
+
+        uint32_t Acquire(const std::shared_ptr<T>& item);
+        // Returns true when the id was freed
+        bool Release(uint32_t id);
+        const std::shared_ptr<T>& Get(uint32_t id) const { return items[id]; }
+        void Clear();
+    };
+
 private:
-    // All static objects
-    std::vector<StaticObject> m_objects;
+    static constexpr uint32_t INVALID_INDEX = 0xFFFFFFFFu;
+
+    // Where an object sits in m_batches, parallel to m_objects
+    struct BatchRef {
+        uint32_t batch = INVALID_INDEX;          // Index into m_batches
+        uint32_t batchPos = 0;                   // Position in that batch
+    };
+
+    // All static objects, dense; m_handles maps handles/slots to them.
+    // m_hot, m_info, m_batchRefs and m_cullBounds are parallel.
+    TaggedVector<StaticObjectHot, MemoryTag::World> m_hot;
+    TaggedVector<StaticObjectInfo, MemoryTag::World> m_info;
+    std::vector<BatchRef> m_batchRefs;
+    SlotMap m_handles;
+
+    ResourceTable<Mesh> m_meshes;
+    ResourceTable<Material> m_materials;
 
     // Render batches (grouped by material)
     std::vector<RenderBatch> m_batches;
+    std::vector<uint32_t> m_materialBatch;  // Material id -> batch
     bool m_batchesDirty = true;
     bool m_autoBatching = true;
 
+    // Instancing: visible transforms are streamed into one persistent VBO
+    // each frame; groups index into it
+    std::vector<InstanceGroup> m_instanceGroups;
+    std::vector<Mat4> m_instanceTransforms;
+    uint32_t m_instanceVBO = 0;
+    size_t m_instanceCapacity = 0;  // Bytes
+    bool m_instancing = true;
+
+    // LOD selection: camera position and proj[1][1] * bias for the frame.
+    // Instanced objects with LODs are bucketed by level per mesh run, so
+    // each level is one group.
+    Vec3 m_lodEye = Vec3(0.0f);
+    float m_lodScale = 1.0f;
+    float m_lodBias = 1.0f;
+    float m_projScale = 1.0f;       // proj[1][1], unbiased (texture streaming)
+    std::vector<std::vector<uint32_t>> m_lodRun;
+    uint32_t m_lodRunMesh = INVALID_INDEX;
+
+    // Merged static geometry. m_mergeRefs is by dense index and only
+    // meaningful while !m_mergeDirty (adds/removals move objects).
+    struct MergeRef {
+        uint32_t group = INVALID_INDEX;
+        uint32_t range = 0;
+    };
+    std::vector<MergedGroup> m_mergedGroups;
+    std::vector<MergeRef> m_mergeRefs;
+    std::vector<uint32_t> m_mergeFirst;    // Per-draw scratch for DrawRanges
+    std::vector<uint32_t> m_mergeCounts;
+    bool m_mergeDirty = true;
+    bool m_staticMerging = true;
+    MaterialBatching m_materialBatching = MaterialBatching::Off;
+    std::vector<MaterialTablePtr> m_materialTables;
+
+    // GPU-driven culling of the merged objects (command order = group order)
+    GpuCullPass m_gpuCull;
+    uint32_t m_mergedObjectCount = 0;
+    bool m_gpuObjectsDirty = true;   // Visibility or merge changed
+    std::vector<uint8_t> m_gpuHidden;   // Hidden flag last uploaded, by command
+    uint32_t m_gpuHiddenCount = 0;
+
+    // Frustum culling (SoA world bounds, by dense index)
+    AABBSoA m_cullBounds;
+    std::vector<uint8_t> m_objectVisible;
+    bool m_frustumCulling = true;
+
+    // PVS and occlusion culling (m_objectHidden by dense index, valid
+    // while m_hiddenActive, i.e. for the frame being rendered)
+    static constexpr uint8_t HIDDEN_NONE = 0;
+    static constexpr uint8_t HIDDEN_PVS = 1;
+    static constexpr uint8_t HIDDEN_OCCLUDED = 2;
+    MapVisPtr m_vis;
+    OcclusionBuffer m_occlusion;
+    std::vector<uint8_t> m_objectHidden;
+    bool m_pvsCulling = true;
+    bool m_occlusionCulling = true;
+    bool m_hiddenActive = false;
+
+    // Occluders smaller than this on screen (diameter / screen height)
+    // cost more to rasterize than they hide
+    static constexpr float OCCLUDER_MIN_SCREEN_SIZE = 0.1f;
+
+    // BVH over render bounds (culling, picking). Free slots keep empty
+    // bounds.
+    mutable BVH m_renderBVH;
+    mutable std::vector<AABB> m_renderBounds;          // By slot
+    mutable bool m_bvhDirty = true;
+    mutable bool m_bvhNeedsRefit = false;
+
+    // Below this object count a flat SIMD sweep beats tree traversal
+    static constexpr size_t BVH_CULL_THRESHOLD = 64;
+
+    // Shadows. m_shadowCasters is by dense index for the cascade being
+    // drawn; the unmerged casters are instanced from their own buffer.
+    CascadedShadowMap m_shadows;
+    ClusteredLighting m_lights;
+    DepthPrepass m_prepass;
+    bool m_prepassActive = false;       // This frame's opaque depth is already laid down
+    bool m_frontToBack = false;
+    uint32_t m_lightmapTexture = 0;   // GL_TEXTURE_2D_ARRAY, GL_RGBA16F
+    uint32_t m_lightmapSize = 0;
+    uint32_t m_lightmapLayers = 0;
+    size_t GetLightmapBytes() const {
+        return static_cast<size_t>(m_lightmapSize) * m_lightmapSize * m_lightmapLayers * 8;
+    }
+    std::vector<uint8_t> m_shadowCasters;
+    std::vector<uint32_t> m_shadowObjects;
+    std::vector<InstanceGroup> m_shadowGroups;
+    std::vector<Mat4> m_shadowTransforms;
+    uint32_t m_shadowVBO = 0;
+    size_t m_shadowCapacity = 0;  // Bytes
+    uint32_t m_shadowDrawCalls = 0;
+    uint32_t m_prepassDrawCalls = 0;
+
     // Lighting
     Vec3 m_lightDirection = Vec3(0.5f, 1.0f, 0.3f);
     Vec3 m_lightColor = Vec3(1.0f, 0.98f, 0.95f);
@@ -311,6 +821,9 @@ private:
     uint32_t m_verticesRendered = 0;
     uint32_t m_objectsRendered = 0;
     uint32_t m_objectsCulled = 0;
+    uint32_t m_objectsOccluded = 0;
+    uint32_t m_objectsPvsCulled = 0;
+    uint32_t m_occluderTriangles = 0;
 };
 
 } // namespace Genesis